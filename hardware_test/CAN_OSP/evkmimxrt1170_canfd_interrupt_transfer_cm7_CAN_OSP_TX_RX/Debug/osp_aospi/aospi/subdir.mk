@@ -5,14 +5,32 @@
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
 ../osp_aospi/aospi/aospi.c \
+../osp_aospi/aospi/aospi_flexcan.c \
+../osp_aospi/aospi/aospi_frame.c \
+../osp_aospi/aospi/aospi_loopback.c \
+../osp_aospi/aospi/aospi_lpspi.c \
+../osp_aospi/aospi/aospi_sim.c \
+../osp_aospi/aospi/aospi_socketcan.c \
 ../osp_aospi/aospi/slave_spi.c 
 
 C_DEPS += \
 ./osp_aospi/aospi/aospi.d \
+./osp_aospi/aospi/aospi_flexcan.d \
+./osp_aospi/aospi/aospi_frame.d \
+./osp_aospi/aospi/aospi_loopback.d \
+./osp_aospi/aospi/aospi_lpspi.d \
+./osp_aospi/aospi/aospi_sim.d \
+./osp_aospi/aospi/aospi_socketcan.d \
 ./osp_aospi/aospi/slave_spi.d 
 
 OBJS += \
 ./osp_aospi/aospi/aospi.o \
+./osp_aospi/aospi/aospi_flexcan.o \
+./osp_aospi/aospi/aospi_frame.o \
+./osp_aospi/aospi/aospi_loopback.o \
+./osp_aospi/aospi/aospi_lpspi.o \
+./osp_aospi/aospi/aospi_sim.o \
+./osp_aospi/aospi/aospi_socketcan.o \
 ./osp_aospi/aospi/slave_spi.o 
 
 
@@ -28,7 +46,7 @@ osp_aospi/aospi/%.o: ../osp_aospi/aospi/%.c osp_aospi/aospi/subdir.mk
 clean: clean-osp_aospi-2f-aospi
 
 clean-osp_aospi-2f-aospi:
-	-$(RM) ./osp_aospi/aospi/aospi.d ./osp_aospi/aospi/aospi.o ./osp_aospi/aospi/slave_spi.d ./osp_aospi/aospi/slave_spi.o
+	-$(RM) ./osp_aospi/aospi/aospi.d ./osp_aospi/aospi/aospi.o ./osp_aospi/aospi/aospi_flexcan.d ./osp_aospi/aospi/aospi_flexcan.o ./osp_aospi/aospi/aospi_frame.d ./osp_aospi/aospi/aospi_frame.o ./osp_aospi/aospi/aospi_loopback.d ./osp_aospi/aospi/aospi_loopback.o ./osp_aospi/aospi/aospi_lpspi.d ./osp_aospi/aospi/aospi_lpspi.o ./osp_aospi/aospi/aospi_sim.d ./osp_aospi/aospi/aospi_sim.o ./osp_aospi/aospi/aospi_socketcan.d ./osp_aospi/aospi/aospi_socketcan.o ./osp_aospi/aospi/slave_spi.d ./osp_aospi/aospi/slave_spi.o
 
 .PHONY: clean-osp_aospi-2f-aospi
 
@@ -68,10 +68,9 @@ static aoresult_t aoapps_dither_anim_setdim(uint16_t dimlvl) {
   aomw_topo_rgb_t rgb= { dimlvl, dimlvl, dimlvl, "grey" };
   // Loop over all triplets to set dimlvl
   for( uint16_t tix=0; tix<aomw_topo_numtriplets(); tix++ ) {
-    aoresult_t result= aomw_topo_settriplet(tix, &rgb);
-    if( result!=aoresult_ok ) return result;
+    aomw_topo_fb_set(tix, &rgb);
   }
-  return aoresult_ok;
+  return aomw_topo_fb_flush(0);
 }
 
 
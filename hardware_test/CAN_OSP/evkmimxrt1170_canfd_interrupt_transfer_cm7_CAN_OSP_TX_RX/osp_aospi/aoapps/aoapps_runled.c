@@ -20,7 +20,7 @@
  *****************************************************************************/
 // #include <Arduino.h>       // PRINTF
 #include <aoresult.h>      // AORESULT_ASSERT, aoresult_t
-#include <aomw.h>          // aomw_topo_settriplet()
+#include <aomw.h>          // aomw_topo_fb_set()
 //#include <aoui32.h>        // aoui32_but_wentdown()
 #include <aoapps_mngr.h>   // aoapps_mngr_register
 #include <aoapps_runled.h> // own
@@ -78,7 +78,8 @@ static aoresult_t aoapps_runled_anim() {
   aoapps_runled_anim_ms = millis();
 
   // Update: set triplet tix to color cix
-  result= aomw_topo_settriplet(aoapps_runled_anim_tix, aoapps_runled_anim_rgbs[aoapps_runled_anim_colorix] );
+  aomw_topo_fb_set(aoapps_runled_anim_tix, aoapps_runled_anim_rgbs[aoapps_runled_anim_colorix] );
+  result= aomw_topo_fb_flush(0);
   if( result!=aoresult_ok ) return result;
 
   // Go to next triplet
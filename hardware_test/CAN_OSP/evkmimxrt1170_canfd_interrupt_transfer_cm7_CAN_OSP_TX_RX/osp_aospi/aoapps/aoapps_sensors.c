@@ -122,30 +122,37 @@ static aoresult_t aoapps_sensors_temp_measure() {
 }
 
 
-// Updates aoapps_sensors_angle_current with rotary sensor measurement (if sensor present)
-static aoresult_t aoapps_sensors_angle_measure() {
-  aoresult_t result;
-  if( aoapps_sensors_angle_present ) {
-    int angle;
-    result= aomw_as5600_angle_get(&angle); 
-    if( result!=aoresult_ok ) return result;
+// Updates the current temperature, angle and light level. The reads of the 
+// sensors present are one batch (aoosp_exec_i2cread8_many), so the I2C 
+// transactions on their bridges overlap.
+static aoresult_t aoapps_sensors_measure() {
+  aoosp_exec_i2cjob_t jobs[3];
+  uint8_t bufs[3][2];
+  int n=0, jtemp=-1, jangle=-1, jlight=-1;
+  if( aoapps_sensors_temp_present  ) { jtemp =n; aomw_as6212_temp_job(&jobs[n],bufs[n]); n++; }
+  if( aoapps_sensors_angle_present ) { jangle=n; aomw_as5600_angle_job(&jobs[n],bufs[n]); n++; }
+  if( aoapps_sensors_light_present ) { jlight=n; aomw_sfh5721_als_job(&jobs[n],bufs[n]); n++; }
+  aoosp_exec_i2cread8_many(jobs, n);
+
+  // Temperature (when the batch read failed, or there is no sensor, as before: with retries, or from the SAID)
+  if( jtemp>=0 && jobs[jtemp].result==aoresult_ok ) {
+    aoapps_sensors_temp_current= aomw_as6212_temp_conv(bufs[jtemp])/1000.0;
+  } else {
+    aoresult_t result= aoapps_sensors_temp_measure();
+    if( result!=aoresult_ok ) { PRINTF("sensors: error reading temperature sensor\n"); return result; }
+  }
+  // Knob angle
+  if( jangle>=0 ) {
+    if( jobs[jangle].result!=aoresult_ok ) { PRINTF("sensors: error reading rotation sensor\n"); return jobs[jangle].result; }
     // Do not want 0.0 as well as 360.0 in range, so divide by MAX+1
-    aoapps_sensors_angle_current = angle*360.0/(AOMW_AS5600_ANGLE_MAX+1);
+    aoapps_sensors_angle_current = aomw_as5600_angle_conv(bufs[jangle])*360.0/(AOMW_AS5600_ANGLE_MAX+1);
   }
-  return aoresult_ok;
-}
-
-
-// Updates aoapps_sensors_light_current with light measurement (if light sensor present)
-static aoresult_t aoapps_sensors_light_measure() {
-  aoresult_t result;
-  if( aoapps_sensors_light_present ) {
-    int als;
-    result= aomw_sfh5721_als_get(&als); 
-    if( result!=aoresult_ok ) return result;
+  // Light level
+  if( jlight>=0 ) {
+    if( jobs[jlight].result!=aoresult_ok ) { PRINTF("sensors: error reading light sensor\n"); return jobs[jlight].result; }
     // SFH5721 datasheet: lux=512*als/(DGAIN*AGAIN*2^IT)
     // We have DGAIN=1, AGAIN=4, IT=7(=25ms), so lux=als
-    aoapps_sensors_light_current = als;
+    aoapps_sensors_light_current = aomw_sfh5721_als_conv(bufs[jlight]);
   }
   return aoresult_ok;
 }
@@ -243,10 +250,9 @@ static aoresult_t aoapps_sensors_colortriplets_temp() {
   // render yellow bar
   for( int tix=0; tix<aomw_topo_numtriplets(); tix++ ) {
     aomw_topo_rgb_t col = tix<=midtix ? aomw_topo_blue : aomw_topo_red;
-    aoresult_t result= aomw_topo_settriplet( tix, &col ); 
-    if( result!=aoresult_ok ) return result;
+    aomw_topo_fb_set( tix, &col ); 
   }
-  return aoresult_ok;
+  return aomw_topo_fb_flush(0);
 }
 
 
@@ -257,13 +263,12 @@ static aoresult_t aoapps_sensors_colortriplets_light() {
   int green2 = max(0,min(4*(green1-2000),AOMW_TOPO_BRIGHTNESS_MAX)); 
   //PRINTF("%.2f %d %d\n",aoapps_sensors_light_current,green1,green2);
   // Compose the color
-  aomw_topo_rgb_t col = { 0x0000, uint16_t(green2), 0x0000, "autogreen" }; 
+  aomw_topo_rgb_t col = { 0x0000, (uint16_t)green2, 0x0000, "autogreen" }; 
   // Distribute over the whole chain
   for( int tix=0; tix<aomw_topo_numtriplets(); tix++ ) {
-    aoresult_t result= aomw_topo_settriplet( tix, &col ); 
-    if( result!=aoresult_ok ) return result;
+    aomw_topo_fb_set( tix, &col ); 
   }
-  return aoresult_ok;
+  return aomw_topo_fb_flush(0);
 }
 
 
@@ -279,10 +284,9 @@ static aoresult_t aoapps_sensors_colortriplets_angle() {
   const aomw_topo_rgb_t yellow = { 0x1FFF,0x1FFF,0x0000, "dimyellow" };
   for( int tix=0; tix<aomw_topo_numtriplets(); tix++ ) {
     aomw_topo_rgb_t col = tix<=stoptix ? yellow : aomw_topo_off;
-    aoresult_t result= aomw_topo_settriplet( tix, &col ); 
-    if( result!=aoresult_ok ) return result;
+    aomw_topo_fb_set( tix, &col ); 
   }
-  return aoresult_ok;
+  return aomw_topo_fb_flush(0);
 }
 
 
@@ -502,15 +506,9 @@ static aoresult_t aoapps_sensors_step() {
   // Bail out if to early
   if( millis()-aoapps_sensors_lastms < AOAPPS_SENSORS_ANIM_MS ) return aoresult_ok;
 
-  // Get temperature
-  result= aoapps_sensors_temp_measure();
-  if( result!=aoresult_ok ) { PRINTF("sensors: error reading temperature sensor\n"); return result; }
-  // Get knob angle
-  result= aoapps_sensors_angle_measure();
-  if( result!=aoresult_ok ) { PRINTF("sensors: error reading rotation sensor\n"); return result; }
-  // Get light level
-  result= aoapps_sensors_light_measure();
-  if( result!=aoresult_ok ) { PRINTF("sensors: error reading light sensor\n"); return result; }
+  // Get temperature, knob angle and light level
+  result= aoapps_sensors_measure();
+  if( result!=aoresult_ok ) return result;
   
   // Update display
   result= aoapps_sensors_display();
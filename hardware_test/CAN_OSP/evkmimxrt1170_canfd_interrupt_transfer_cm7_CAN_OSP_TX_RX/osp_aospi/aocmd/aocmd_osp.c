@@ -313,12 +313,70 @@ static void aocmd_osp_count_show() {
 }
 
 
+// Show telemetry per TID (only TIDs in use), and the result codes that occurred
+static void aocmd_osp_count_tid_show() {
+  PRINTF("tid name                tx   txbytes        rx   rxbytes       err        us\n");
+  for( int tid=0; tid<AOSPI_STAT_TIDS; tid++ ) {
+    const aospi_stat_tid_t * stat= aospi_stat_tid(tid);
+    if( stat->txcount==0 && stat->errcount==0 ) continue;
+    const char * name= "(other)";
+    if( tid!=AOSPI_STAT_TID_OTHER ) name= aocmd_osp_tidmap[tid].num>0 ? AOCMD_OSP_SWNAME(aocmd_osp_variant[aocmd_osp_tidmap[tid].vix].swname) : "unknown";
+    PRINTF("%02X  %-12s %9lu %9lu %9lu %9lu %9lu %9lu\n", tid, name, 
+      (unsigned long)stat->txcount, (unsigned long)stat->txbytes, (unsigned long)stat->rxcount, 
+      (unsigned long)stat->rxbytes, (unsigned long)stat->errcount, (unsigned long)stat->us );
+    PRINTF("    us");
+    for( int b=0; b<AOSPI_STAT_BUCKETS; b++ ) {
+      if( stat->hist[b]==0 ) continue;
+      if( b==AOSPI_STAT_BUCKETS-1 ) PRINTF(" >=%lu:%u", 1UL<<(b-1), stat->hist[b]);
+      else PRINTF(" <%lu:%u", 1UL<<b, stat->hist[b]);
+    }
+    PRINTF("\n");
+  }
+  PRINTF("results");
+  for( int r=0; r<aoresult_numresultcodes; r++ ) {
+    uint32_t count= aospi_stat_result((aoresult_t)r);
+    if( count!=0 ) PRINTF(" %s:%lu", aoresult_to_str((aoresult_t)r,0), (unsigned long)count);
+  }
+  PRINTF("\n");
+}
+
+
+// Print the telemetry in the binary format of aospi_stat_dump(), in hex
+static void aocmd_osp_count_dump() {
+  static uint8_t buf[1024];
+  int len;
+  aoresult_t result= aospi_stat_dump(buf,sizeof(buf),&len);
+  if( result!=aoresult_ok ) { PRINTF("ERROR: 'count dump' failed (%s)\n", aoresult_to_str(result,0) ); return; }
+  for( int i=0; i<len; i++ ) PRINTF("%02X%s", buf[i], i%32==31 || i==len-1 ? "\n" : " " );
+}
+
+
+// Show whether sequence tags are used
+static void aocmd_osp_rxtag_show() {
+  PRINTF("rxtag: %s\n", aospi_rxtag_isenabled() ? "enabled" : "disabled" );
+}
+
+
+// Show TX ring depth
+static void aocmd_osp_txring_show() {
+  PRINTF("txring: %d (max %d)\n", aospi_txring_getdepth(), AOSPI_TXRING_MAXDEPTH );
+}
+
+
+// Show selected chain
+static void aocmd_osp_chain_show() {
+  PRINTF("chain: %d (of %d)\n", aospi_chain_get(), aospi_chain_count() );
+}
+
+
 // shows log status
 static void aocmd_osp_log_show() {
   PRINTF("log: " );
   if( aoosp_loglevel_get()==aoosp_loglevel_none ) PRINTF("none");
+  if( aoosp_loglevel_get()==aoosp_loglevel_ring ) PRINTF("ring");
   if( aoosp_loglevel_get()==aoosp_loglevel_args ) PRINTF("args");
   if( aoosp_loglevel_get()==aoosp_loglevel_tele ) PRINTF("tele");
+  if( aoosp_logring_lost()>0 ) PRINTF(" (ring lost %lu records)", (unsigned long)aoosp_logring_lost() );
   PRINTF("\n");
 }
 
@@ -834,19 +892,56 @@ static void aocmd_osp_main( int argc, char * argv[] ) {
   } else if( aocmd_cint_isprefix("count",argv[1]) ) {
     if( argc==2 ) { aocmd_osp_count_show(); return; }
     if( argc!=3 ) { PRINTF("ERROR: 'count' has too many args\n"); return; }
+    if( aocmd_cint_isprefix("tid",argv[2]) ) { aocmd_osp_count_tid_show(); return; }
+    if( aocmd_cint_isprefix("dump",argv[2]) ) { aocmd_osp_count_dump(); return; }
     if( aocmd_cint_isprefix("reset",argv[2]) ) { /*nothing */ }
-    else { PRINTF("ERROR: 'count' expects 'reset', not '%s'\n", argv[2]); return; }
+    else { PRINTF("ERROR: 'count' expects 'reset', 'tid' or 'dump', not '%s'\n", argv[2]); return; }
     aospi_txcount_reset();
     aospi_rxcount_reset();
+    aospi_stat_reset();
     if( argv[0][0]!='@' ) aocmd_osp_count_show();
+  } else if( aocmd_cint_isprefix("txring",argv[1]) ) {
+    if( argc==2 ) { aocmd_osp_txring_show(); return; }
+    if( argc!=3 ) { PRINTF("ERROR: 'txring' has too many args\n"); return; }
+    int depth;
+    if( !aocmd_cint_parse_dec(argv[2],&depth) || aospi_txring_setdepth(depth)!=aoresult_ok ) { PRINTF("ERROR: 'txring' expects <depth> 1..%d, not '%s'\n", AOSPI_TXRING_MAXDEPTH, argv[2]); return; }
+    if( argv[0][0]!='@' ) aocmd_osp_txring_show();
+  } else if( aocmd_cint_isprefix("chain",argv[1]) ) {
+    if( argc==2 ) { aocmd_osp_chain_show(); return; }
+    if( argc!=3 ) { PRINTF("ERROR: 'chain' has too many args\n"); return; }
+    int chain;
+    if( !aocmd_cint_parse_dec(argv[2],&chain) || aospi_chain_set(chain)!=aoresult_ok ) { PRINTF("ERROR: 'chain' expects <chain> 0..%d, not '%s'\n", aospi_chain_count()-1, argv[2]); return; }
+    if( argv[0][0]!='@' ) aocmd_osp_chain_show();
+  } else if( aocmd_cint_isprefix("rxtag",argv[1]) ) {
+    if( argc==2 ) { aocmd_osp_rxtag_show(); return; }
+    if( argc!=3 ) { PRINTF("ERROR: 'rxtag' has too many args\n"); return; }
+    if( aocmd_cint_isprefix("enable",argv[2]) ) aospi_rxtag_enable(1);
+    else if( aocmd_cint_isprefix("disable",argv[2]) ) aospi_rxtag_enable(0);
+    else { PRINTF("ERROR: 'rxtag' expects 'enable' or 'disable', not '%s'\n",argv[2]); return; }
+    if( argv[0][0]!='@' ) aocmd_osp_rxtag_show();
+  } else if( aocmd_cint_isprefix("bench",argv[1]) ) {
+    int frames= 1000;
+    if( argc>3 ) { PRINTF("ERROR: 'bench' has too many args\n"); return; }
+    if( argc==3 && (!aocmd_cint_parse_dec(argv[2],&frames) || frames<1) ) { PRINTF("ERROR: 'bench' expects <frames>, not '%s'\n", argv[2]); return; }
+    uint32_t us;
+    aoresult_t result= aospi_bench(frames,&us);
+    if( result!=aoresult_ok ) { PRINTF("ERROR: 'bench' failed (%s)\n", aoresult_to_str(result,0) ); return; }
+    if( argv[0][0]!='@' ) PRINTF("bench: %d frames, txring %d, %lu us, %lu frames/s\n", frames, aospi_txring_getdepth(), (unsigned long)us, us ? (unsigned long)((uint64_t)frames*1000000/us) : 0UL );
   } else if( aocmd_cint_isprefix("log",argv[1]) ) {
     if( argc==2 ) { aocmd_osp_log_show(); return; }
     if( argc!=3 ) { PRINTF("ERROR: 'log' has too many args\n"); return; }
+    if( aocmd_cint_isprefix("drain",argv[2]) ) {
+      // The ring has one consumer: when the background task drains it, it already prints the records
+      if( aoosp_logring_background() ) { PRINTF("log: ring is drained by the background task\n"); return; }
+      while( aoosp_logring_drain(AOOSP_LOGRING_SIZE)>0 ) ; 
+      return; 
+    }
     aoosp_loglevel_t level;
     if( aocmd_cint_isprefix("none",argv[2]) ) level= aoosp_loglevel_none;
+    else if( aocmd_cint_isprefix("ring",argv[2]) ) level= aoosp_loglevel_ring;
     else if( aocmd_cint_isprefix("args",argv[2]) ) level= aoosp_loglevel_args;
     else if( aocmd_cint_isprefix("tele",argv[2]) ) level= aoosp_loglevel_tele;
-    else { PRINTF("ERROR: 'log' expects 'none', 'args', or 'tele', not '%s'\n", argv[2]); return; }
+    else { PRINTF("ERROR: 'log' expects 'none', 'ring', 'args', 'tele', or 'drain', not '%s'\n", argv[2]); return; }
     aoosp_loglevel_set(level);
     if( argv[0][0]!='@' ) aocmd_osp_log_show();
   } else if( aocmd_cint_isprefix("info",argv[1]) ) {
@@ -890,14 +985,36 @@ static const char aocmd_osp_longhelp[] =
   "- with optional argument sets it\n"
   "- this validates (checks consistency of) telegrams issued with 'send'/'tx'\n"
   "- enabled is slower, but invalid telegrams will be sent anyhow\n"
-  "SYNTAX: osp count [ reset ]\n"
+  "SYNTAX: osp count [ reset | tid | dump ]\n"
   "- without optional argument shows how many telegrams were sent and received\n"
-  "- with 'reset', resets counters to 0\n"
+  "- with 'reset', resets counters (including those per tid) to 0\n"
   "- this is a count of SPI transactions (including failed ones)\n"
-  "SYNTAX: osp log [ none | args | tele ]\n"
+  "- with 'tid', shows per telegram id: telegrams and bytes sent, responses and\n"
+  "  bytes received, errors, total time (us) and a histogram of times (<us:n)\n"
+  "  followed by the number of occurrences of each result code\n"
+  "- with 'dump', prints all counters in the binary format of aospi_stat_dump()\n"
+  "SYNTAX: osp txring [ <depth> ]\n"
+  "- without optional argument shows the number of CAN MBs used for sending\n"
+  "- with optional argument sets it (1 sends one frame at a time)\n"
+  "SYNTAX: osp chain [ <chain> ]\n"
+  "- without optional argument shows the chain telegrams go to\n"
+  "- with optional argument selects it (flexcan: 0 on CAN3, 1 on CAN2)\n"
+  "SYNTAX: osp rxtag [enable|disable]\n"
+  "- without optional argument shows whether requests carry a sequence tag\n"
+  "- with optional argument sets it; disable for a bridge without tag support\n"
+  "- with tags, several telegrams with response can be in flight\n"
+  "SYNTAX: osp bench [ <frames> ]\n"
+  "- sends <frames> (default 1000) 64 byte frames back-to-back, reports frames/s\n"
+  "- the CAN controller is in loop back, so nothing appears on the bus\n"
+  "SYNTAX: osp log [ none | ring | args | tele ]\n"
   "- without optional argument shows log status, with argument sets it\n"
   "- logs nothing, telegram name with args, or even raw telegram bytes\n"
+  "- 'ring' only records telegrams in a binary ring, without printing\n"
   "- this logs calls to the osp library, not the spi library used by 'osp'\n"
+  "SYNTAX: osp log drain\n"
+  "- prints (and empties) the log ring as '#osplog' lines\n"
+  "- not needed with FreeRTOS: a background task prints them\n"
+  "- decode a capture of those lines on a PC with tools/aoosp_logdec.c\n"
   "SYNTAX: osp hwtest (out|in) [enable|disable]\n"
   "- hardware test for the output enable lines of the OUT and IN ports\n"
   "- without optional argument shows the status of output enable lines\n"
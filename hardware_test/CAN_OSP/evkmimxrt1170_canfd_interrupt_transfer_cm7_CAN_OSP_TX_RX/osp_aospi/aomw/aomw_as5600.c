@@ -136,16 +136,47 @@ aoresult_t aomw_as5600_angle_get(int*angle) {
   aoresult_t result;
   uint8_t buf[2];
   
-  // Use processed angle AOMW_AS5600_2R0E_ANGLE 
-  // but conf() cleared offset so should be same as RAWANGLE
-  result= aoosp_exec_i2cread8(aomw_as5600_saidaddr,AOMW_AS5600_DADDR7_SAIDSENSE, AOMW_AS5600_2R0E_ANGLE,buf,2);
+  aoosp_exec_i2cjob_t job;
+  aomw_as5600_angle_job(&job, buf);
+  result= aoosp_exec_i2cread8_many(&job, 1);
   if( result!=aoresult_ok ) return result;
 
-  *angle= buf[0]*256 + buf[1];
+  *angle= aomw_as5600_angle_conv(buf);
   return aoresult_ok;
 }
 
 
+/*!
+    @brief  Prepares `job` to read the angle register of the AS5600 into 
+            `buf`, so that the read can be part of a batch for 
+            aoosp_exec_i2cread8_many() (eg with other sensors).
+    @param  job
+            The job to prepare.
+    @param  buf
+            The buffer for the job, 2 bytes; convert it with 
+            aomw_as5600_angle_conv() when the job succeeded.
+    @note   This routine assumes a rotary sensor is associated with this
+            library via `aomw_as5600_init()`.
+*/
+void aomw_as5600_angle_job(aoosp_exec_i2cjob_t * job, uint8_t * buf) {
+  // Use processed angle AOMW_AS5600_2R0E_ANGLE 
+  // but conf() cleared offset so should be same as RAWANGLE
+  *job= (aoosp_exec_i2cjob_t){ .addr=aomw_as5600_saidaddr, .daddr7=AOMW_AS5600_DADDR7_SAIDSENSE, .raddr=AOMW_AS5600_2R0E_ANGLE, .count=2, .buf=buf };
+}
+
+
+/*!
+    @brief  Converts the angle register, read by a aomw_as5600_angle_job(), 
+            to an angle.
+    @param  buf
+            The 2 bytes read by the job.
+    @return The raw 12 bit angle, 0..AOMW_AS5600_ANGLE_MAX.
+*/
+int aomw_as5600_angle_conv(const uint8_t * buf) {
+  return buf[0]*256 + buf[1];
+}
+
+
 /*!
     @brief  Reads and returns the magnet magnitude and agc.
             They are combined into a force level.
@@ -31,6 +31,7 @@
 #include "fsl_common.h"
 #include "fsl_debug_console.h"
 #include <aoresult.h>   // aoresult_t
+#include <aoosp.h>      // aoosp_exec_i2cjob_t
 
 
 // I2C address of the sensor
@@ -45,6 +46,10 @@
 
 // Reads and returns the angle measured by the AS5600 rotary sensor.
 aoresult_t aomw_as5600_angle_get(int*angle);
+// Prepares `job` to read the angle into `buf` (2 bytes), in a batch for aoosp_exec_i2cread8_many().
+void aomw_as5600_angle_job(aoosp_exec_i2cjob_t * job, uint8_t * buf);
+// Converts the bytes read by a aomw_as5600_angle_job() to an angle (0..AOMW_AS5600_ANGLE_MAX).
+int aomw_as5600_angle_conv(const uint8_t * buf);
 aoresult_t aomw_as5600_force_get(int*agc, int*mag);
 
 
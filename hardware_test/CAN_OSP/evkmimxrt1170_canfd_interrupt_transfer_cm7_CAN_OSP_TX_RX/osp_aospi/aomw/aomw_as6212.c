@@ -148,12 +148,44 @@ aoresult_t aomw_as6212_temp_get(int*millicelsius) {
   *millicelsius= -1;
   // Get TVAL register
   uint8_t buf[2];
-  result = aoosp_exec_i2cread8(aomw_as6212_saidaddr, AOMW_AS6212_DADDR7_SAIDSENSE, AOMW_AS6212_TVAL, buf, 2);
+  aoosp_exec_i2cjob_t job;
+  aomw_as6212_temp_job(&job, buf);
+  result = aoosp_exec_i2cread8_many(&job, 1);
   if( result!=aoresult_ok ) return result;
+  *millicelsius= aomw_as6212_temp_conv(buf);
+  return aoresult_ok;
+}
+
+
+/*!
+    @brief  Prepares `job` to read the temperature register of the AS6212 
+            into `buf`, so that the read can be part of a batch for 
+            aoosp_exec_i2cread8_many() (eg with other sensors).
+    @param  job
+            The job to prepare.
+    @param  buf
+            The buffer for the job, 2 bytes; convert it with 
+            aomw_as6212_temp_conv() when the job succeeded.
+    @note   This routine assumes a temperature sensor is associated with this
+            library via `aomw_as6212_init()`.
+*/
+void aomw_as6212_temp_job(aoosp_exec_i2cjob_t * job, uint8_t * buf) {
+  AORESULT_ASSERT(aomw_as6212_saidaddr!=0); // Forgot aomw_as6212_init()?
+  *job= (aoosp_exec_i2cjob_t){ .addr=aomw_as6212_saidaddr, .daddr7=AOMW_AS6212_DADDR7_SAIDSENSE, .raddr=AOMW_AS6212_TVAL, .count=2, .buf=buf };
+}
+
+
+/*!
+    @brief  Converts the TVAL register, read by a aomw_as6212_temp_job(), 
+            to a temperature.
+    @param  buf
+            The 2 bytes read by the job.
+    @return The temperature in milli Celsius.
+*/
+int aomw_as6212_temp_conv(const uint8_t * buf) {
   // Convert buffer (big endian) to milli Celsius
   uint16_t tval=buf[0]*256+buf[1];
-  *millicelsius= 1000*(int16_t)tval/AOMW_AS6212_TVAL_SCALE;
-  return aoresult_ok;
+  return 1000*(int16_t)tval/AOMW_AS6212_TVAL_SCALE;
 }
 
 
@@ -31,6 +31,7 @@
 #include "fsl_common.h"
 #include "fsl_debug_console.h"
 #include <aoresult.h>   // aoresult_t
+#include <aoosp.h>      // aoosp_exec_i2cjob_t
 
 
 // I2C address of the temperature sensor
@@ -43,6 +44,10 @@ aoresult_t aomw_as6212_convrate_set(int ms);
 aoresult_t aomw_as6212_convrate_get(int *ms);
 // Reads and returns the temperature measured by the AS6212 temperature sensor.
 aoresult_t aomw_as6212_temp_get(int*millicelsius);
+// Prepares `job` to read the temperature into `buf` (2 bytes), in a batch for aoosp_exec_i2cread8_many().
+void aomw_as6212_temp_job(aoosp_exec_i2cjob_t * job, uint8_t * buf);
+// Converts the bytes read by a aomw_as6212_temp_job() to milli Celsius.
+int aomw_as6212_temp_conv(const uint8_t * buf);
 
 
 // Tests if an AS6212 is connected to the I2C bus of OSP node (SAID) with address `addr`.
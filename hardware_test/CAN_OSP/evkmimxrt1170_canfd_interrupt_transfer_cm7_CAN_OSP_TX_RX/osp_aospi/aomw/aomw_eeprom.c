@@ -32,6 +32,8 @@
 
 // Maximum read size is dictated by telegrams size
 #define AOMW_EEPROM_MAXREADCHUNK 8
+// Number of read chunks in one batch (aoosp_exec_i2cread8_many)
+#define AOMW_EEPROM_READBATCH    8
 // The size of a page inside the EEPROM
 #define AOMW_EEPROM_PAGESIZE     8
 
@@ -84,17 +86,26 @@ aoresult_t aomw_eeprom_present(uint16_t addr, uint8_t daddr7 ) {
             or aomw_topo_build()) and I2C bridge of `addr` must be powered
             (eg with aoosp_exec_i2cpower()).
     @note   Typical values for `daddr7` are AOMW_EEPROM_DADDR7_XXX.
+    @note   The EEPROM is read in chunks of 8 bytes, up to 8 chunks per
+            aoosp_exec_i2cread8_many() batch (the chunks are on one bridge,
+            so they still run one after the other).
 */
 aoresult_t aomw_eeprom_read(uint16_t addr, uint8_t daddr7, uint8_t raddr, uint8_t *buf, int count ) {
   if( raddr+count>256 ) return aoresult_outofmem;
   aoresult_t result;
+  aoosp_exec_i2cjob_t jobs[AOMW_EEPROM_READBATCH];
   while( count>0 ) {
-    uint8_t chunk= count > AOMW_EEPROM_MAXREADCHUNK  ?  AOMW_EEPROM_MAXREADCHUNK  :  count;
-    result= aoosp_exec_i2cread8(addr, daddr7, raddr, buf, chunk);
+    // Collect a batch of chunks, each read straight into buf
+    int n= 0;
+    while( count>0 && n<AOMW_EEPROM_READBATCH ) {
+      uint8_t chunk= count > AOMW_EEPROM_MAXREADCHUNK  ?  AOMW_EEPROM_MAXREADCHUNK  :  count;
+      jobs[n++]= (aoosp_exec_i2cjob_t){ .addr=addr, .daddr7=daddr7, .raddr=raddr, .count=chunk, .buf=buf };
+      raddr+= chunk;
+      buf+= chunk;
+      count-= chunk;
+    }
+    result= aoosp_exec_i2cread8_many(jobs, n);
     if( result!=aoresult_ok ) return result;
-    raddr+= chunk;
-    buf+= chunk;
-    count-= chunk;
   }
   return aoresult_ok;
 }
@@ -181,19 +192,27 @@ aoresult_t aomw_eeprom_write(uint16_t addr, uint8_t daddr7, uint8_t raddr, const
 aoresult_t aomw_eeprom_compare(uint16_t addr, uint8_t daddr7, uint8_t raddr, const uint8_t *buf, int count ) {
   if( raddr+count>256 ) return aoresult_outofmem;
   aoresult_t result;
-  uint8_t tmp[8];
+  aoosp_exec_i2cjob_t jobs[AOMW_EEPROM_READBATCH];
+  uint8_t tmp[AOMW_EEPROM_READBATCH*AOMW_EEPROM_MAXREADCHUNK];
   while( count>0 ) {
-    uint8_t chunk= count > AOMW_EEPROM_MAXREADCHUNK  ?  AOMW_EEPROM_MAXREADCHUNK  :  count;
-    result= aoosp_exec_i2cread8(addr, daddr7, raddr, tmp, chunk);
+    // Read a batch of chunks into tmp
+    int n= 0;
+    int size= 0;
+    while( count>size && n<AOMW_EEPROM_READBATCH ) {
+      uint8_t chunk= count-size > AOMW_EEPROM_MAXREADCHUNK  ?  AOMW_EEPROM_MAXREADCHUNK  :  count-size;
+      jobs[n++]= (aoosp_exec_i2cjob_t){ .addr=addr, .daddr7=daddr7, .raddr=raddr+size, .count=chunk, .buf=tmp+size };
+      size+= chunk;
+    }
+    result= aoosp_exec_i2cread8_many(jobs, n);
     if( result!=aoresult_ok ) return result;
-    if( memcmp(tmp,buf,chunk)!=0 ) {
-      // PRINTF("EEPROM %02x: %s\n", raddr,aoosp_prt_bytes(tmp,chunk) );
-      // PRINTF("MCUROM %02x: %s\n", raddr,aoosp_prt_bytes(buf,chunk) );
+    if( memcmp(tmp,buf,size)!=0 ) {
+      // PRINTF("EEPROM %02x: %s\n", raddr,aoosp_prt_bytes(tmp,size) );
+      // PRINTF("MCUROM %02x: %s\n", raddr,aoosp_prt_bytes(buf,size) );
       return aoresult_comparefail;
     }
-    raddr+= chunk;
-    buf+= chunk;
-    count-= chunk;
+    raddr+= size;
+    buf+= size;
+    count-= size;
   }
   return aoresult_ok;
 }
@@ -19,7 +19,7 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
  *****************************************************************************/
 
-#include <aomw_topo.h>  // aomw_topo_settriplet
+#include <aomw_topo.h>  // aomw_topo_fb_set
 #include <aomw_flag.h>  // own
 
 
@@ -45,22 +45,18 @@ static aoresult_t aomw_flag_3bands(const aomw_topo_rgb_t*band1,const aomw_topo_r
   if( numpcb>=3 ) { num1+=nummcu1; num3+=nummcu3; }
 
   // generate all three bands
-  aoresult_t result;
   uint16_t tix=0;
   for( int i=0; i<num1; i++,tix++ ) {
-    result= aomw_topo_settriplet(tix, band1 );
-    if( result!=aoresult_ok ) return result;
+    aomw_topo_fb_set(tix, band1);
   }
   for( int i=0; i<num2; i++,tix++ ) {
-    result= aomw_topo_settriplet(tix, band2 );
-    if( result!=aoresult_ok ) return result;
+    aomw_topo_fb_set(tix, band2);
   }
   for( int i=0; i<num3; i++,tix++ ) {
-    result= aomw_topo_settriplet(tix, band3 );
-    if( result!=aoresult_ok ) return result;
+    aomw_topo_fb_set(tix, band3);
   }
 
-  return aoresult_ok;
+  return aomw_topo_fb_flush(0);
 }
 
 
@@ -155,30 +151,24 @@ aoresult_t aomw_flag_painter_europe() {
   num5+= numend;
 
   // generate three blue bands with two yellow stars
-  aoresult_t result;
   uint16_t tix=0;
   for( int i=0; i<num1; i++,tix++ ) {
-    result= aomw_topo_settriplet(tix, &aomw_topo_blue );
-    if( result!=aoresult_ok ) return result;
+    aomw_topo_fb_set(tix, &aomw_topo_blue);
   }
   for( int i=0; i<num2; i++,tix++ ) {
-    result= aomw_topo_settriplet(tix, &aomw_topo_yellow );
-    if( result!=aoresult_ok ) return result;
+    aomw_topo_fb_set(tix, &aomw_topo_yellow);
   }
   for( int i=0; i<num3; i++,tix++ ) {
-    result= aomw_topo_settriplet(tix, &aomw_topo_blue );
-    if( result!=aoresult_ok ) return result;
+    aomw_topo_fb_set(tix, &aomw_topo_blue);
   }
   for( int i=0; i<num4; i++,tix++ ) {
-    result= aomw_topo_settriplet(tix, &aomw_topo_yellow );
-    if( result!=aoresult_ok ) return result;
+    aomw_topo_fb_set(tix, &aomw_topo_yellow);
   }
   for( int i=0; i<num5; i++,tix++ ) {
-    result= aomw_topo_settriplet(tix, &aomw_topo_blue );
-    if( result!=aoresult_ok ) return result;
+    aomw_topo_fb_set(tix, &aomw_topo_blue);
   }
 
-  return aoresult_ok;
+  return aomw_topo_fb_flush(0);
 }
 
 
@@ -197,48 +187,41 @@ aoresult_t aomw_flag_painter_usa() {
   int numpairs  = nummain/2;
   int numcorner = numpairs/3; // the blue-white part
 
-  aoresult_t result;
   uint16_t tixnum=aomw_topo_numtriplets();
   uint16_t tix=0;
   // First blue
   int mcu=0;
   while( mcu<aomw_topo_node_numtriplets(1)+1 && tix<tixnum ) {
-    result= aomw_topo_settriplet(tix, &aomw_topo_blue );
-    if( result!=aoresult_ok ) return result;
+    aomw_topo_fb_set(tix, &aomw_topo_blue);
     tix++;
     mcu++;
   }
   // white/blue pairs
   int pairs=0;
   while( pairs<numcorner && tix<tixnum ) {
-    result= aomw_topo_settriplet(tix, &aomw_topo_white );
-    if( result!=aoresult_ok ) return result;
+    aomw_topo_fb_set(tix, &aomw_topo_white);
     tix++;
     if( tix<tixnum ) {
-      result= aomw_topo_settriplet(tix, &aomw_topo_blue );
-      if( result!=aoresult_ok ) return result;
+      aomw_topo_fb_set(tix, &aomw_topo_blue);
       tix++;
     }
     pairs++;
   }
   // first red
   if( tix<tixnum ) {
-    result= aomw_topo_settriplet(tix, &aomw_topo_red );
-    if( result!=aoresult_ok ) return result;
+    aomw_topo_fb_set(tix, &aomw_topo_red);
     tix++;
   }
   // white/red pairs
   while( tix<tixnum ) {
-    result= aomw_topo_settriplet(tix, &aomw_topo_white );
-    if( result!=aoresult_ok ) return result;
+    aomw_topo_fb_set(tix, &aomw_topo_white);
     tix++;
     if( tix<tixnum ) {
-      result= aomw_topo_settriplet(tix, &aomw_topo_red );
-      if( result!=aoresult_ok ) return result;
+      aomw_topo_fb_set(tix, &aomw_topo_red);
       tix++;
     }
   }
-  return aoresult_ok;
+  return aomw_topo_fb_flush(0);
 }
 
 
@@ -269,30 +252,24 @@ aoresult_t aomw_flag_painter_china() {
   num5+= numend;
 
   // generate three red bands with two yellow stars
-  aoresult_t result;
   uint16_t tix=0;
   for( int i=0; i<num1; i++,tix++ ) {
-    result= aomw_topo_settriplet(tix, &aomw_topo_red );
-    if( result!=aoresult_ok ) return result;
+    aomw_topo_fb_set(tix, &aomw_topo_red);
   }
   for( int i=0; i<num2; i++,tix++ ) {
-    result= aomw_topo_settriplet(tix, &aomw_topo_yellow );
-    if( result!=aoresult_ok ) return result;
+    aomw_topo_fb_set(tix, &aomw_topo_yellow);
   }
   for( int i=0; i<num3; i++,tix++ ) {
-    result= aomw_topo_settriplet(tix, &aomw_topo_red );
-    if( result!=aoresult_ok ) return result;
+    aomw_topo_fb_set(tix, &aomw_topo_red);
   }
   for( int i=0; i<num4; i++,tix++ ) {
-    result= aomw_topo_settriplet(tix, &aomw_topo_yellow );
-    if( result!=aoresult_ok ) return result;
+    aomw_topo_fb_set(tix, &aomw_topo_yellow);
   }
   for( int i=0; i<num5; i++,tix++ ) {
-    result= aomw_topo_settriplet(tix, &aomw_topo_red );
-    if( result!=aoresult_ok ) return result;
+    aomw_topo_fb_set(tix, &aomw_topo_red);
   }
 
-  return aoresult_ok;
+  return aomw_topo_fb_flush(0);
 }
 
 
@@ -210,14 +210,45 @@ aoresult_t aomw_sfh5721_als_get(int*als) {
   aoresult_t result;
   uint8_t buf[2];
   
-  result= aoosp_exec_i2cread8(aomw_sfh5721_saidaddr,AOMW_SFH5721_DADDR7_SAIDSENSE, AOMW_SFH5721_R10_DATA3ALS,buf,2);
+  aoosp_exec_i2cjob_t job;
+  aomw_sfh5721_als_job(&job, buf);
+  result= aoosp_exec_i2cread8_many(&job, 1);
   if( result!=aoresult_ok ) return result;
 
-  *als= buf[0] + 256*buf[1];
+  *als= aomw_sfh5721_als_conv(buf);
   return aoresult_ok;
 }
 
 
+/*!
+    @brief  Prepares `job` to read the ALS data registers of the SFH5721 
+            into `buf`, so that the read can be part of a batch for 
+            aoosp_exec_i2cread8_many() (eg with other sensors).
+    @param  job
+            The job to prepare.
+    @param  buf
+            The buffer for the job, 2 bytes; convert it with 
+            aomw_sfh5721_als_conv() when the job succeeded.
+    @note   This routine assumes a light sensor is associated with this
+            library via `aomw_sfh5721_init()`.
+*/
+void aomw_sfh5721_als_job(aoosp_exec_i2cjob_t * job, uint8_t * buf) {
+  *job= (aoosp_exec_i2cjob_t){ .addr=aomw_sfh5721_saidaddr, .daddr7=AOMW_SFH5721_DADDR7_SAIDSENSE, .raddr=AOMW_SFH5721_R10_DATA3ALS, .count=2, .buf=buf };
+}
+
+
+/*!
+    @brief  Converts the ALS data registers, read by a aomw_sfh5721_als_job(), 
+            to an ambient light level.
+    @param  buf
+            The 2 bytes read by the job.
+    @return The ALS level (see aomw_sfh5721_als_get for the unit).
+*/
+int aomw_sfh5721_als_conv(const uint8_t * buf) {
+  return buf[0] + 256*buf[1];
+}
+
+
 /*!
     @brief  Tests if an SFH5721 light sensor is connected to the I2C 
             bus of OSP node (SAID) with address `addr`.
@@ -31,6 +31,7 @@
 #include "fsl_common.h"
 #include "fsl_debug_console.h"
 #include <aoresult.h>   // aoresult_t
+#include <aoosp.h>      // aoosp_exec_i2cjob_t
 
 
 // I2C address of the light sensor
@@ -41,6 +42,10 @@
 
 // Reads and returns the ambient light level by the SFH5721 light sensor.
 aoresult_t aomw_sfh5721_als_get(int*als);
+// Prepares `job` to read the ambient light level into `buf` (2 bytes), in a batch for aoosp_exec_i2cread8_many().
+void aomw_sfh5721_als_job(aoosp_exec_i2cjob_t * job, uint8_t * buf);
+// Converts the bytes read by a aomw_sfh5721_als_job() to an ambient light level.
+int aomw_sfh5721_als_conv(const uint8_t * buf);
 
 
 // Tests if an SFH5721 is connected to the I2C bus of OSP node (SAID) with address `addr`.
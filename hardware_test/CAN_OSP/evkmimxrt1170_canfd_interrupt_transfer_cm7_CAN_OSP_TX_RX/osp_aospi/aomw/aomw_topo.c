@@ -19,8 +19,12 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
  *****************************************************************************/
 
+#include <aospi.h>      // aospi_txrx_us(), aospi_chain_set()
 #include <aoosp.h>      // aoosp_send_identify()
 #include <aocmd.h>      // aocmd_cint_register()
+#include "FreeRTOS.h"   // TickType_t
+#include "task.h"       // xTaskGetTickCount()
+#include <string.h>     // memcpy()
 #include <aomw_topo.h>  // own
 
 
@@ -69,45 +73,156 @@
 // current and going active. This makes all the nodes in the OSP chain ready 
 // for pwm telegrams. In other words, the functions aomw_topo_build...()
 // and aomw_topo_settriplet() form the core of this module.
+//
+// When the aospi backend drives several independent OSP chains (see
+// aospi_chain_set), eg the FlexCAN backend with one chain on CAN3 and one 
+// on CAN2, the build scans all chains, one after the other. The nodes are 
+// numbered across the chains: the nodes of chain 1 follow those of chain 0.
+// The same holds for the triplets and the I2C bridges: there is one triplet
+// index space for all chains. With a single chain, a node's number is its 
+// address. aomw_topo_node_chain() and aomw_topo_node_addr() give the chain 
+// and address of a node. Functions of this module that send telegrams to a 
+// node first select the chain of that node (with aospi_chain_set), and 
+// leave it selected. aomw_topo_settriplets() sets a range of triplets, 
+// sending to all chains in parallel.
+//
+// Updating a long chain telegram by telegram shows the new colors first on
+// the nodes close to the MCU. To prevent such tearing, SAID channels can be
+// put in sync mode (aomw_topo_sync_set): a new PWM setting is then pending
+// until a SYNC telegram. A frame, aomw_topo_frame_begin() up to 
+// aomw_topo_frame_commit(), sends all aomw_topo_settriplet(s) updates, and 
+// then one broadcast SYNC per chain, so that all SAID triplets change at 
+// once. RGBIs have no sync mode, they show a new setting immediately.
+
+
+// The topology map is a structure of arrays, carved by the build from one
+// static arena and sized to the discovered chains: the node arrays when all 
+// chains are RESET and INITed (the number of nodes is then known), the 
+// triplet and I2C bridge arrays (and the framebuffer) when all nodes are 
+// identified. The address, channel and chain of a triplet are packed in one 
+// 16 bit word (see AOMW_TOPO_LOC), as is the location of an I2C bridge.
+// The arena, and the RAM store of the cache, are sized for AOMW_TOPO_CAPNODES
+// nodes; a build with more nodes fails with aoresult_outofmem.
+
+
+// The most nodes a map can have, in all chains together. The default is a full
+// chain, as before the arena. A smaller value (eg -DAOMW_TOPO_CAPNODES=200) 
+// saves RAM, at the cost of larger chains failing the build.
+#ifndef AOMW_TOPO_CAPNODES
+#define AOMW_TOPO_CAPNODES       AOOSP_ADDR_UNICASTMAX
+#endif
+
+
+#define AOMW_TOPO_MAXCHAINS      AOSPI_CHAIN_MAXCOUNT
+#define AOMW_TOPO_I2CFIND_BATCH  8 // max number of I2C bridges probed at once by aomw_topo_i2cfind()
 
 
-// ESP32 has large RAM, go for max
-#define AOMW_TOPO_MAXNODES       AOOSP_ADDR_UNICASTMAX     
-#define AOMW_TOPO_MAXTRIPLETS    (3*AOOSP_ADDR_UNICASTMAX)
-#define AOMW_TOPO_MAXI2CBRIDGES  AOOSP_ADDR_UNICASTMAX     
+// Bytes in the arena per node, per triplet and per I2C bridge
+#define AOMW_TOPO_NODE_BYTES      ( sizeof(uint32_t) + 3*sizeof(uint16_t) + 2*sizeof(uint8_t) )
+#define AOMW_TOPO_TRIPLET_BYTES   ( sizeof(uint16_t) + sizeof(aoosp_pwmhdr_t) + 3*sizeof(uint16_t) )
+#define AOMW_TOPO_I2CBRIDGE_BYTES ( sizeof(uint16_t) )
 
 
-#define AOMW_TOPO_CHAN_NONE      0xFF // channel id used internally when there are no channels (i.e. for RGBI)
+// The arena fits AOMW_TOPO_CAPNODES nodes of any type (SAIDs with three triplets and an I2C bridge), plus alignment padding
+#define AOMW_TOPO_ARENA_SIZE     ( (AOMW_TOPO_CAPNODES+2)*AOMW_TOPO_NODE_BYTES + 3*AOMW_TOPO_CAPNODES*AOMW_TOPO_TRIPLET_BYTES \
+                                 + AOMW_TOPO_CAPNODES*AOMW_TOPO_I2CBRIDGE_BYTES + (3*AOMW_TOPO_CAPNODES+31)/32*4 + 16*4 )
 
 
-static int      aomw_topo_loop_;                                   // Chain has direction loop (1) or bidir (0)
-static uint16_t aomw_topo_last_;                                   // The address of the last node (response from INIT telegram)
+// Location of a triplet or I2C bridge packed in 16 bits: address (10 bits), channel (2 bits) and chain (4 bits)
+#define AOMW_TOPO_LOC(addr,chan,chain) ( (uint16_t)( (addr) | (chan)<<10 | (chain)<<12 ) )
+#define AOMW_TOPO_LOC_ADDR(loc)        ( (loc) & 0x3FF )
+#define AOMW_TOPO_LOC_CHAN(loc)        ( ((loc)>>10) & 0x3 )
+#define AOMW_TOPO_LOC_CHAIN(loc)       ( (loc)>>12 )
+#if AOOSP_ADDR_UNICASTMAX>0x3FF || AOSPI_CHAIN_MAXCOUNT>16
+  #error AOMW_TOPO_LOC can not pack the OSP addresses or chains
+#endif
 
-static uint16_t aomw_topo_numnodes_;                               // The number of nodes in the chain (at the end of scan must be equal to aomw_topo_last_)
-static uint32_t aomw_topo_node_id_[AOMW_TOPO_MAXNODES];            // The identity reported by the node
-static uint8_t  aomw_topo_node_numtriplets_[AOMW_TOPO_MAXNODES];   // Number of triplets in that node (RGBI: 1, SAID: 3 or 2)
-static uint16_t aomw_topo_node_triplet1_[AOMW_TOPO_MAXNODES];      // The triplet index of the first triplet of this node
+
+#define AOMW_TOPO_CHAN_NONE      3 // channel id used internally when there are no channels (i.e. for RGBI)
+
+
+// The info byte of a node: the skipped channels of a SAID (SKIPCHNx in OTP), if it is an I2C bridge, and its chain
+#define AOMW_TOPO_INFO_SKIPCHNS  AOOSP_OTPBITS_SKIPCHNS // Bits 0..2: channels without triplet (SAID)
+#define AOMW_TOPO_INFO_BRIDGE    0x08                   // Bit 3: channel 2 is an I2C bridge (SAID)
+#define AOMW_TOPO_INFO_CHAIN(info) ( (info)>>4 )        // Bits 4..7: the chain of the node
+
+
+static uint8_t  aomw_topo_arena_[AOMW_TOPO_ARENA_SIZE] __attribute__((aligned(4))); // Storage for the arrays below (those that are pointers)
+static uint32_t aomw_topo_arena_used_;                             // The number of bytes of aomw_topo_arena_ in use
+
+static int      aomw_topo_numchains_;                              // The number of chains scanned
+static int      aomw_topo_loop_[AOMW_TOPO_MAXCHAINS];              // Chain has direction loop (1) or bidir (0)
+static uint16_t aomw_topo_last_[AOMW_TOPO_MAXCHAINS];              // The address of the last node (response from INIT telegram)
+static uint16_t aomw_topo_chain_node0_[AOMW_TOPO_MAXCHAINS];       // The number of nodes in the chains before this one (node number = node0 + addr)
+static uint16_t aomw_topo_chain_triplet1_[AOMW_TOPO_MAXCHAINS];    // The index of the first triplet of the chain
+static uint16_t aomw_topo_chain_i2cbridge1_[AOMW_TOPO_MAXCHAINS];  // The index of the first I2C bridge of the chain
+
+static uint16_t aomw_topo_numnodes_;                               // The number of nodes in all chains (at the end of scan must be equal to the sum of aomw_topo_last_)
+static uint32_t * aomw_topo_node_id_;                              // The identity reported by the node
+static uint8_t  * aomw_topo_node_info_;                            // The OTP bits (AOMW_TOPO_INFO_SKIPCHNS and _BRIDGE) and chain of the node
+static uint16_t * aomw_topo_node_triplet1_;                        // The triplet index of the first triplet of this node (one extra, so that the next one ends it)
+static uint16_t * aomw_topo_node_us_;                              // The round trip time of the IDENTIFY telegram to this node
+static uint16_t * aomw_topo_node_groups_;                          // The groups (SETMULT mask) of the node, as set by the multicast planner
+static int        aomw_topo_node_groups_lost_;                     // A flush or frame failed, so aomw_topo_node_groups_ may not match the nodes (the next flush clears all groups)
+static uint8_t  * aomw_topo_node_covered_;                         // Scratch of the multicast planner: channels served or overwritten by a group telegram (see AOMW_TOPO_COVERED)
 
 static uint16_t aomw_topo_numtriplets_;                            // Number of triplets in the chain
-static uint16_t aomw_topo_triplet_addr_[AOMW_TOPO_MAXTRIPLETS];    // The address of the node this triplet belongs to
-static uint8_t  aomw_topo_triplet_chan_[AOMW_TOPO_MAXTRIPLETS];    // The channel of the node this triplet is connected to (AOMW_TOPO_CHAN_NONE for RGBI)
+static uint16_t * aomw_topo_triplet_loc_;                          // The address, channel (AOMW_TOPO_CHAN_NONE for RGBI) and chain of the node of this triplet, see AOMW_TOPO_LOC
+static aoosp_pwmhdr_t * aomw_topo_triplet_pwmhdr_;                 // Prebuilt SETPWM or SETPWMCHN header for this triplet (rebuilt on every scan)
+static uint16_t (* aomw_topo_fb_)[3];                              // The framebuffer: color (r,g,b) of every triplet, see aomw_topo_fb_set()
+static uint32_t * aomw_topo_fb_dirty_;                             // The framebuffer: bit set when the triplet color changed since the last flush
+static int      aomw_topo_fb_numdirty_;                            // The framebuffer: number of bits set in aomw_topo_fb_dirty_
 
 static uint16_t aomw_topo_numi2cbridges_;                          // Number of I2C bridges in the chain (SAIDs with OTP flag)
-static uint16_t aomw_topo_i2cbridge_addr_[AOMW_TOPO_MAXI2CBRIDGES];// The address of the node this i2c bridge belongs to
+static uint16_t * aomw_topo_i2cbridge_loc_;                        // The address and chain of the node of this i2c bridge, see AOMW_TOPO_LOC
+
+static int      aomw_topo_sync_;                                   // SAID channels are in sync mode (SYNCEN), see aomw_topo_sync_set()
+static int      aomw_topo_frame_;                                  // A frame is open, see aomw_topo_frame_begin()
+static int      aomw_topo_frame_chain_;                            // The chain selected at aomw_topo_frame_begin()
 
 
 // === data model observers =================================================
 
 
+/*!
+    @brief  Returns the number of OSP chains in the "topology map".
+    @return Number of scanned chains (1 or more).
+    @note   Only available after aomw_topo_build() - or start/step.
+    @note   The build scans the chains 0..aospi_chain_count()-1; a chain 
+            other than 0 that does not respond ends the scan.
+    @note   This is part of what is known as the OSP chain "topology map".
+*/
+int aomw_topo_numchains() {
+  return aomw_topo_numchains_;
+}
+
+
+/*!
+    @brief  Returns if OSP chain `chain` has direction Loop (or BiDir).
+    @param  chain
+            The chain, 0 <= chain < aomw_topo_numchains().
+    @return 1  if the OSP chain has direction Loop.
+            0  if the OSP chain has direction BiDir.
+    @note   Only available after aomw_topo_build() - or start/step.
+    @note   This is part of what is known as the OSP chain "topology map".
+*/
+int aomw_topo_chain_loop( int chain ) {
+  AORESULT_ASSERT( 0<=chain && chain<aomw_topo_numchains_ );
+  return aomw_topo_loop_[chain];
+}
+
+
 /*!
     @brief  Returns if the current OSP chain has direction Loop (or BiDir).
     @return 1  if the current OSP chain has direction Loop.
             0  if the current OSP chain has direction BiDir.
     @note   Only available after aomw_topo_build() - or start/step.
+    @note   With several chains, this is the direction of chain 0, 
+            see aomw_topo_chain_loop().
     @note   This is part of what is known as the OSP chain "topology map".
 */
 int aomw_topo_loop() {
-  return aomw_topo_loop_;
+  return aomw_topo_loop_[0];
 }
 
 
@@ -115,6 +230,7 @@ int aomw_topo_loop() {
     @brief  Returns the number of nodes in the scanned OSP chain.
     @return Number of OSP nodes in the scanned chain.
     @note   Only available after aomw_topo_build() - or start/step.
+    @note   With several chains, this is the number of nodes in all chains.
     @note   This is part of what is known as the OSP chain "topology map".
 */
 uint16_t aomw_topo_numnodes() {
@@ -122,6 +238,35 @@ uint16_t aomw_topo_numnodes() {
 }
 
 
+/*!
+    @brief  Returns the chain of node `node`.
+    @param  node
+            The node number (1-based, numbered across all chains).
+    @return The chain of the node, 0 <= chain < aomw_topo_numchains().
+    @note   Only available after aomw_topo_build() - or start/step.
+    @note   This is part of what is known as the OSP chain "topology map".
+*/
+int aomw_topo_node_chain( uint16_t node ) {
+  AORESULT_ASSERT( 1<=node && node<=aomw_topo_numnodes_ );
+  return AOMW_TOPO_INFO_CHAIN(aomw_topo_node_info_[node]);
+}
+
+
+/*!
+    @brief  Returns the OSP address of node `node` in its chain.
+    @param  node
+            The node number (1-based, numbered across all chains).
+    @return The OSP address of the node (see aomw_topo_node_chain()).
+    @note   Only available after aomw_topo_build() - or start/step.
+    @note   With a single chain, the address equals the node number.
+    @note   This is part of what is known as the OSP chain "topology map".
+*/
+uint16_t aomw_topo_node_addr( uint16_t node ) {
+  AORESULT_ASSERT( 1<=node && node<=aomw_topo_numnodes_ );
+  return node - aomw_topo_chain_node0_[AOMW_TOPO_INFO_CHAIN(aomw_topo_node_info_[node])];
+}
+
+
 /*!
     @brief  Returns the identity of OSP node at address `addr`.
     @param  addr
@@ -137,6 +282,26 @@ uint32_t aomw_topo_node_id( uint16_t addr ) {
 }
 
 
+/*!
+    @brief  Returns the round trip time of the IDENTIFY telegram to the OSP 
+            node at address `addr`, as measured during the scan.
+    @param  addr
+            The address of the OSP node.
+    @return The round trip time in us (see aospi_txrx_us()), saturated at 65535.
+    @note   Only available after aomw_topo_build() - or start/step.
+    @note   The builder identifies the nodes with pipelined requests; it 
+            times the first and the last node of each chain, the times of
+            the nodes in between are linearly interpolated.
+    @note   addr is 1-based, so 1 <= addr <= aomw_topo_numnodes().
+    @note   The time grows with the distance of the node to the MCU, so 
+            a sudden jump points to a slow link (or a slow node).
+*/
+uint16_t aomw_topo_node_us( uint16_t addr ) {
+  AORESULT_ASSERT( 1<=addr && addr<=aomw_topo_numnodes_ );
+  return aomw_topo_node_us_[addr]; // skip slot 0
+}
+
+
 /*!
     @brief  Returns the number of triplets (RGB modules) connected to 
             the OSP node at address `addr`.
@@ -150,7 +315,7 @@ uint32_t aomw_topo_node_id( uint16_t addr ) {
 */
 uint8_t aomw_topo_node_numtriplets( uint16_t addr ) {
   AORESULT_ASSERT( 1<=addr && addr<=aomw_topo_numnodes_ );
-  return aomw_topo_node_numtriplets_[addr]; // skip slot 0
+  return aomw_topo_node_triplet1_[addr+1] - aomw_topo_node_triplet1_[addr]; // skip slot 0
 }
 
 
@@ -188,7 +353,7 @@ uint16_t aomw_topo_numtriplets() {
     @brief  Returns the address of the OSP node that drives triplet `tix`.
     @param  tix
             The index of the triplet.
-    @return The OSP address of the triplet.
+    @return The OSP address of the triplet (in chain aomw_topo_triplet_chain()).
     @note   Only available after aomw_topo_build() - or start/step.
     @note   tix is 0-based, so , 0 <= tix < aomw_topo_numtriplets().
     @note   Since some OSP nodes (eg SAID) drive multiple RGB modules, 
@@ -201,7 +366,23 @@ uint16_t aomw_topo_numtriplets() {
 */
 uint16_t aomw_topo_triplet_addr( uint16_t tix ) {
   AORESULT_ASSERT( tix<aomw_topo_numtriplets_ );
-  return aomw_topo_triplet_addr_[tix];
+  return AOMW_TOPO_LOC_ADDR(aomw_topo_triplet_loc_[tix]);
+}
+
+
+/*!
+    @brief  Returns the chain of the OSP node that drives triplet `tix`.
+    @param  tix
+            The index of the triplet.
+    @return The chain, 0 <= chain < aomw_topo_numchains().
+    @note   Only available after aomw_topo_build() - or start/step.
+    @note   tix is 0-based, so , 0 <= tix < aomw_topo_numtriplets().
+    @note   The triplets of one chain have consecutive indices.
+    @note   This is part of what is known as the OSP chain "topology map".
+*/
+int aomw_topo_triplet_chain( uint16_t tix ) {
+  AORESULT_ASSERT( tix<aomw_topo_numtriplets_ );
+  return AOMW_TOPO_LOC_CHAIN(aomw_topo_triplet_loc_[tix]);
 }
 
 
@@ -221,7 +402,7 @@ uint16_t aomw_topo_triplet_addr( uint16_t tix ) {
 */
 int aomw_topo_triplet_onchan( uint16_t tix ) {
   AORESULT_ASSERT( tix<aomw_topo_numtriplets_ );
-  return aomw_topo_triplet_chan_[tix] != AOMW_TOPO_CHAN_NONE;
+  return AOMW_TOPO_LOC_CHAN(aomw_topo_triplet_loc_[tix]) != AOMW_TOPO_CHAN_NONE;
 }
 
 
@@ -243,8 +424,8 @@ int aomw_topo_triplet_onchan( uint16_t tix ) {
 */
 uint8_t aomw_topo_triplet_chan( uint16_t tix ) {
   AORESULT_ASSERT( tix<aomw_topo_numtriplets_ );
-  AORESULT_ASSERT( aomw_topo_triplet_chan_[tix] != AOMW_TOPO_CHAN_NONE );
-  return aomw_topo_triplet_chan_[tix];
+  AORESULT_ASSERT( AOMW_TOPO_LOC_CHAN(aomw_topo_triplet_loc_[tix]) != AOMW_TOPO_CHAN_NONE );
+  return AOMW_TOPO_LOC_CHAN(aomw_topo_triplet_loc_[tix]);
 }
 
 
@@ -265,14 +446,30 @@ uint16_t aomw_topo_numi2cbridges() {
             with index `iix`.
     @param  iix
             The index of the I2C bridge.
-    @return The OSP address of the I2C bridge.
+    @return The OSP address of the I2C bridge (in chain aomw_topo_i2cbridge_chain()).
     @note   Only available after aomw_topo_build() - or start/step.
     @note   iix is 0-based, so , 0 <= iix < aomw_topo_numi2cbridges().
     @note   This is part of what is known as the OSP chain "topology map".
 */
 uint16_t aomw_topo_i2cbridge_addr( uint16_t iix ) {
   AORESULT_ASSERT( iix<aomw_topo_numi2cbridges_ );
- return aomw_topo_i2cbridge_addr_[iix];
+  return AOMW_TOPO_LOC_ADDR(aomw_topo_i2cbridge_loc_[iix]);
+}
+
+
+/*!
+    @brief  Returns the chain of the OSP node that has I2C bridge 
+            with index `iix`.
+    @param  iix
+            The index of the I2C bridge.
+    @return The chain, 0 <= chain < aomw_topo_numchains().
+    @note   Only available after aomw_topo_build() - or start/step.
+    @note   iix is 0-based, so , 0 <= iix < aomw_topo_numi2cbridges().
+    @note   This is part of what is known as the OSP chain "topology map".
+*/
+int aomw_topo_i2cbridge_chain( uint16_t iix ) {
+  AORESULT_ASSERT( iix<aomw_topo_numi2cbridges_ );
+  return AOMW_TOPO_LOC_CHAIN(aomw_topo_i2cbridge_loc_[iix]);
 }
 
 
@@ -282,6 +479,8 @@ uint16_t aomw_topo_i2cbridge_addr( uint16_t iix ) {
 /*!
     @brief  Prints on Serial a summary of the "topology map".
     @note   Only available after aomw_topo_build() - or start/step.
+    @note   Ends with the memory footprint of the map: the part of the 
+            arena (sized for AOMW_TOPO_CAPNODES nodes) it uses.
 */
 void aomw_topo_dump_summary() {
   PRINTF("nodes(N) 1..%d, ", aomw_topo_numnodes_ );
@@ -291,6 +490,14 @@ void aomw_topo_dump_summary() {
   else
     PRINTF("i2cbridges(I) 0..%d, ", aomw_topo_numi2cbridges_-1 );
   PRINTF("dir %s\n", aomw_topo_loop()?"loop":"bidir");
+  for( int chain=0; chain<aomw_topo_numchains_ && aomw_topo_numchains_>1; chain++ ) {
+    uint16_t triplet2= chain+1<aomw_topo_numchains_ ? aomw_topo_chain_triplet1_[chain+1] : aomw_topo_numtriplets_;
+    PRINTF("chain %d: nodes(N) %d..%d, ", chain, aomw_topo_chain_node0_[chain]+1, aomw_topo_chain_node0_[chain]+aomw_topo_last_[chain] );
+    PRINTF("triplets(T) %d..%d, ", aomw_topo_chain_triplet1_[chain], triplet2-1 );
+    PRINTF("dir %s\n", aomw_topo_loop_[chain]?"loop":"bidir");
+  }
+  PRINTF("memory %lu of %lu bytes (%d per node, %d per triplet)\n", (unsigned long)aomw_topo_arena_used_, 
+    (unsigned long)sizeof aomw_topo_arena_, (int)AOMW_TOPO_NODE_BYTES, (int)AOMW_TOPO_TRIPLET_BYTES );
 }
 
 
@@ -302,10 +509,11 @@ void aomw_topo_dump_nodes() {
   uint16_t iix = 0;
   for( uint16_t addr=1; addr<=aomw_topo_numnodes_; addr++ ) {
     PRINTF("N%03X (%08lX)", addr,aomw_topo_node_id(addr) );
+    if( aomw_topo_numchains_>1 ) PRINTF(" @%d.%03X", aomw_topo_node_chain(addr), aomw_topo_node_addr(addr) );
     for( uint16_t tix=aomw_topo_node_triplet1(addr); tix<aomw_topo_node_triplet1(addr)+aomw_topo_node_numtriplets(addr); tix++ )
       PRINTF(" T%d",tix);
-    if( iix<aomw_topo_numi2cbridges_ && aomw_topo_i2cbridge_addr(iix)==addr ) { PRINTF(" I%d",iix); iix++; }
-    PRINTF("\n");
+    if( iix<aomw_topo_numi2cbridges_ && aomw_topo_i2cbridge_chain(iix)==aomw_topo_node_chain(addr) && aomw_topo_i2cbridge_addr(iix)==aomw_topo_node_addr(addr) ) { PRINTF(" I%d",iix); iix++; }
+    PRINTF(" (%u us)\n", aomw_topo_node_us(addr) );
   }
 }
 
@@ -316,7 +524,8 @@ void aomw_topo_dump_nodes() {
 */
 void aomw_topo_dump_triplets() {
   for( uint16_t tix=0; tix<aomw_topo_numtriplets_; tix++ ) {
-    uint16_t addr = aomw_topo_triplet_addr_[tix];
+    // Print the node number (equals the address for a single chain)
+    uint16_t addr = aomw_topo_chain_node0_[aomw_topo_triplet_chain(tix)] + aomw_topo_triplet_addr(tix);
     PRINTF("T%d N%03X", tix, addr );
     if( aomw_topo_triplet_onchan(tix) ) PRINTF(".C%d", aomw_topo_triplet_chan(tix) );
     PRINTF("\n");
@@ -330,7 +539,7 @@ void aomw_topo_dump_triplets() {
 */
 void aomw_topo_dump_i2cbridges() {
   for( uint16_t iix=0; iix<aomw_topo_numi2cbridges_; iix++ ) {
-    PRINTF("I%d N%03X\n", iix,aomw_topo_i2cbridge_addr(iix) );
+    PRINTF("I%d N%03X\n", iix,aomw_topo_chain_node0_[aomw_topo_i2cbridge_chain(iix)]+aomw_topo_i2cbridge_addr(iix) );
   }
 }
 
@@ -365,99 +574,271 @@ void aomw_topo_dump_power() {
 // === topo build helpers ===================================================
 
 
-// Run at the start of topo build, identifies the type of an OSP node.
-// Given the type (and some OTP bits like skipchns and i2cenable) 
-// records the triplets of the node.
-static aoresult_t aomw_topo_node_identify(uint16_t addr) {
-  // Get the id of the node
-  uint32_t id;
-  aoresult_t result = aoosp_send_identify( addr, &id );
-  if( result!=aoresult_ok ) return result;
-  // Record the node's id (if there is still space)
+static int      aomw_topo_build_numchains_;                        // The number of chains that responded to RESET/INIT
+static uint16_t aomw_topo_build_numrgbis_;                         // The number of RGBIs in the chain being configured
+static int      aomw_topo_build_skipchns_;                         // The SKIPCHNx bits of all SAIDs in the chain being configured, or-ed
+
+
+// Carves `size` bytes (4-byte aligned) from the arena; returns 0 if they do not fit.
+static void * aomw_topo_arena_alloc(uint32_t size) {
+  uint32_t offset= (aomw_topo_arena_used_+3) & ~3UL;
+  if( offset+size > sizeof aomw_topo_arena_ ) return 0;
+  aomw_topo_arena_used_= offset+size;
+  return &aomw_topo_arena_[offset];
+}
+
+
+// Run at the start of topo build, once all chains are INITed, empties the 
+// database and carves the node arrays for all their nodes from the arena.
+static aoresult_t aomw_topo_nodes_alloc() {
+  aomw_topo_numchains_ = 0;
+  aomw_topo_numnodes_ = 0;
+  aomw_topo_numtriplets_ = 0;
+  aomw_topo_numi2cbridges_ = 0;
+  aomw_topo_fb_numdirty_ = 0;
+  aomw_topo_arena_used_ = 0;
+  // Node numbers are 1-based (slot 0 is not used)
+  uint32_t n= 1 + aomw_topo_chain_node0_[aomw_topo_build_numchains_-1] + aomw_topo_last_[aomw_topo_build_numchains_-1];
+  if( n-1 > AOMW_TOPO_CAPNODES ) return aoresult_outofmem;
+  aomw_topo_node_id_       = aomw_topo_arena_alloc( n*sizeof(uint32_t) );
+  aomw_topo_node_triplet1_ = aomw_topo_arena_alloc( (n+1)*sizeof(uint16_t) );
+  aomw_topo_node_us_       = aomw_topo_arena_alloc( n*sizeof(uint16_t) );
+  aomw_topo_node_groups_   = aomw_topo_arena_alloc( n*sizeof(uint16_t) );
+  aomw_topo_node_info_     = aomw_topo_arena_alloc( n*sizeof(uint8_t) );
+  aomw_topo_node_covered_  = aomw_topo_arena_alloc( n*sizeof(uint8_t) );
+  if( !aomw_topo_node_id_ || !aomw_topo_node_triplet1_ || !aomw_topo_node_us_ || !aomw_topo_node_groups_ || !aomw_topo_node_info_ || !aomw_topo_node_covered_ ) {
+    aomw_topo_arena_used_ = 0;
+    return aoresult_outofmem;
+  }
+  memset(aomw_topo_node_groups_, 0, n*sizeof(uint16_t)); // RESET ended group membership
+  aomw_topo_node_groups_lost_= 0;
+  return aoresult_ok;
+}
+
+
+// Run at the start of topo build, records the OSP node at `addr` in `chain`
+// with identity `id`, and for a SAID the OTP bits skipchns and isbridge, 
+// from which aomw_topo_triplets_alloc() derives the triplets of the node.
+static aoresult_t aomw_topo_node_add(int chain, uint16_t addr, uint32_t id, int skipchns, int isbridge) {
+  // Record the node's id (the node arrays have space for all nodes of all chains)
   aomw_topo_numnodes_++; // 1-based, so pre-increment
-  AORESULT_ASSERT(addr==aomw_topo_numnodes_);
-  if( aomw_topo_numnodes_>=AOMW_TOPO_MAXNODES ) return aoresult_outofmem;
+  AORESULT_ASSERT(aomw_topo_chain_node0_[chain]+addr==aomw_topo_numnodes_);
   aomw_topo_node_id_[aomw_topo_numnodes_] = id;
-  aomw_topo_node_triplet1_[aomw_topo_numnodes_] = aomw_topo_numtriplets_;
-  
-  // Register the triplets of the node
-  if( AOOSP_IDENTIFY_IS_RGBI(id) ) { // RGBI: one triplet, always present, no channels.
-  
-    // Record the triplet's address and channel (if there is still space)
-    if( aomw_topo_numtriplets_>=AOMW_TOPO_MAXTRIPLETS ) return aoresult_outofmem;
-    aomw_topo_triplet_addr_[aomw_topo_numtriplets_] = addr;
-    aomw_topo_triplet_chan_[aomw_topo_numtriplets_] = AOMW_TOPO_CHAN_NONE;
-    aomw_topo_numtriplets_++;
-    aomw_topo_node_numtriplets_[aomw_topo_numnodes_] = 1;
-    
-  } else if( AOOSP_IDENTIFY_IS_SAID(id) ) { // SAID: three triplets, or less if alternate functions
-  
-    // todo: also inspect other config bits to skip channels (haptic, sync, star, clustering?)
-    int skipchns;
-    result = aoosp_exec_skipchns_get(addr, &skipchns);
-    if( result!=aoresult_ok ) return result;
-    int isbridge;
-    result = aoosp_exec_i2cenable_get(addr, &isbridge );
-    if( result!=aoresult_ok ) return result;
-    aomw_topo_node_numtriplets_[aomw_topo_numnodes_] = 0;
-    // Skip channel 0?
-    if( (skipchns&(1<<0)) == 0 ) {
-      // Record the channel 0 triplet's address and channel (if there is still space)
-      if( aomw_topo_numtriplets_>=AOMW_TOPO_MAXTRIPLETS ) return aoresult_outofmem;
-      aomw_topo_triplet_addr_[aomw_topo_numtriplets_] = addr;
-      aomw_topo_triplet_chan_[aomw_topo_numtriplets_] = 0;
-      aomw_topo_numtriplets_++;
-      aomw_topo_node_numtriplets_[aomw_topo_numnodes_]++;
-    }
-    // Skip channel 1?
-    if( (skipchns&(1<<1)) == 0 ) {
-      // Record the channel 1 triplet's address and channel (if there is still space)
-      if( aomw_topo_numtriplets_>=AOMW_TOPO_MAXTRIPLETS ) return aoresult_outofmem;
-      aomw_topo_triplet_addr_[aomw_topo_numtriplets_] = addr;
-      aomw_topo_triplet_chan_[aomw_topo_numtriplets_] = 1;
-      aomw_topo_numtriplets_++;
-      aomw_topo_node_numtriplets_[aomw_topo_numnodes_]++;
+  aomw_topo_node_us_[aomw_topo_numnodes_] = 0; // see aomw_topo_chain_us()
+  aomw_topo_node_info_[aomw_topo_numnodes_] = chain<<4;
+  if( AOOSP_IDENTIFY_IS_RGBI(id) ) return aoresult_ok; // RGBI: one triplet, always present, no channels.
+  if( !AOOSP_IDENTIFY_IS_SAID(id) ) return aoresult_sys_id; // Or ignore the node, instead of giving error?
+  // SAID: three triplets, or less if alternate functions
+  // todo: also inspect other config bits to skip channels (haptic, sync, star, clustering?)
+  skipchns &= AOMW_TOPO_INFO_SKIPCHNS;
+  if( isbridge ) skipchns = (skipchns & ~(1<<2)) | AOMW_TOPO_INFO_BRIDGE; // channel 2 is for I2C
+  aomw_topo_node_info_[aomw_topo_numnodes_] |= skipchns;
+  return aoresult_ok;
+}
+
+
+// Returns the channels of node `node` that drive a triplet (bit mask); an RGBI
+// has one triplet without channel: bit AOMW_TOPO_CHAN_NONE.
+static int aomw_topo_node_chans(uint16_t node) {
+  if( AOOSP_IDENTIFY_IS_RGBI(aomw_topo_node_id_[node]) ) return 1<<AOMW_TOPO_CHAN_NONE;
+  int chans= ~aomw_topo_node_info_[node] & AOMW_TOPO_INFO_SKIPCHNS;
+  if( aomw_topo_node_info_[node] & AOMW_TOPO_INFO_BRIDGE ) chans &= ~(1<<2);
+  return chans;
+}
+
+
+// Run at topo build, once all nodes of all chains are recorded, carves the 
+// triplet and I2C bridge arrays (and the framebuffer) from the arena, and 
+// registers the triplets and I2C bridges of all nodes.
+static aoresult_t aomw_topo_triplets_alloc() {
+  aoresult_t result;
+  // Count the triplets and I2C bridges
+  uint32_t numtriplets= 0;
+  uint32_t numi2cbridges= 0;
+  for( uint16_t node=1; node<=aomw_topo_numnodes_; node++ ) {
+    int chans= aomw_topo_node_chans(node);
+    for( int chan=0; chan<=AOMW_TOPO_CHAN_NONE; chan++ ) numtriplets+= (chans>>chan) & 1;
+    if( aomw_topo_node_info_[node] & AOMW_TOPO_INFO_BRIDGE ) numi2cbridges++;
+  }
+  if( numtriplets>0xFFFF ) return aoresult_outofmem;
+  aomw_topo_triplet_loc_    = aomw_topo_arena_alloc( numtriplets*sizeof(uint16_t) );
+  aomw_topo_triplet_pwmhdr_ = aomw_topo_arena_alloc( numtriplets*sizeof(aoosp_pwmhdr_t) );
+  aomw_topo_fb_             = aomw_topo_arena_alloc( numtriplets*sizeof(aomw_topo_fb_[0]) );
+  aomw_topo_fb_dirty_       = aomw_topo_arena_alloc( (numtriplets+31)/32*sizeof(uint32_t) );
+  aomw_topo_i2cbridge_loc_  = aomw_topo_arena_alloc( numi2cbridges*sizeof(uint16_t) );
+  if( !aomw_topo_triplet_loc_ || !aomw_topo_triplet_pwmhdr_ || !aomw_topo_fb_ || !aomw_topo_fb_dirty_ || !aomw_topo_i2cbridge_loc_ ) return aoresult_outofmem;
+  // RESET switched all triplets off: the framebuffer is off and clean
+  memset(aomw_topo_fb_, 0, numtriplets*sizeof(aomw_topo_fb_[0]));
+  memset(aomw_topo_fb_dirty_, 0, (numtriplets+31)/32*sizeof(uint32_t));
+  aomw_topo_fb_numdirty_ = 0;
+
+  // Register the triplets and I2C bridges of the nodes, chain by chain
+  for( int chain=0; chain<aomw_topo_build_numchains_; chain++ ) {
+    aomw_topo_chain_triplet1_[chain] = aomw_topo_numtriplets_;
+    aomw_topo_chain_i2cbridge1_[chain] = aomw_topo_numi2cbridges_;
+    for( uint16_t addr=1; addr<=aomw_topo_last_[chain]; addr++ ) {
+      uint16_t node= aomw_topo_chain_node0_[chain]+addr;
+      int      chans= aomw_topo_node_chans(node);
+      aomw_topo_node_triplet1_[node] = aomw_topo_numtriplets_;
+      for( int chan=0; chan<=AOMW_TOPO_CHAN_NONE; chan++ ) {
+        if( !(chans & (1<<chan)) ) continue;
+        uint16_t tix= aomw_topo_numtriplets_++;
+        aomw_topo_triplet_loc_[tix] = AOMW_TOPO_LOC(addr,chan,chain);
+        // Prebuild the PWM telegram header of the triplet (used by aomw_topo_settriplet)
+        if( chan==AOMW_TOPO_CHAN_NONE ) 
+          result= aoosp_pwmhdr_setpwm(&aomw_topo_triplet_pwmhdr_[tix], addr);
+        else
+          result= aoosp_pwmhdr_setpwmchn(&aomw_topo_triplet_pwmhdr_[tix], addr, chan);
+        if( result!=aoresult_ok ) return result;
+      }
+      if( aomw_topo_node_info_[node] & AOMW_TOPO_INFO_BRIDGE ) {
+        aomw_topo_i2cbridge_loc_[aomw_topo_numi2cbridges_++] = AOMW_TOPO_LOC(addr,2,chain);
+      }
     }
-    // Skip channel 2 or I2C?
-    if( (skipchns&(1<<2))==0 && !isbridge ) {
-      // Record the channel 2 triplet's address and channel (if there is still space)
-      if( aomw_topo_numtriplets_>=AOMW_TOPO_MAXTRIPLETS ) return aoresult_outofmem;
-      aomw_topo_triplet_addr_[aomw_topo_numtriplets_] = addr;
-      aomw_topo_triplet_chan_[aomw_topo_numtriplets_] = 2;
-      aomw_topo_numtriplets_++;
-      aomw_topo_node_numtriplets_[aomw_topo_numnodes_]++;
-    } else if( isbridge ) {
-      // Record the I2C bridge's address (if there is still space)
-      if( aomw_topo_numi2cbridges_>=AOMW_TOPO_MAXI2CBRIDGES ) return aoresult_outofmem;
-      aomw_topo_i2cbridge_addr_[aomw_topo_numi2cbridges_] = addr;
-      aomw_topo_numi2cbridges_ ++;
+  }
+  aomw_topo_node_triplet1_[aomw_topo_numnodes_+1] = aomw_topo_numtriplets_; // ends the triplets of the last node
+  aomw_topo_numchains_ = aomw_topo_build_numchains_;
+  return aoresult_ok;
+}
+
+
+// The index of the triplet following the last triplet of `chain`.
+static uint16_t aomw_topo_chain_triplet2(int chain) {
+  return chain+1<aomw_topo_numchains_ ? aomw_topo_chain_triplet1_[chain+1] : aomw_topo_numtriplets_;
+}
+
+
+// The index of the I2C bridge following the last I2C bridge of `chain`.
+static uint16_t aomw_topo_chain_i2cbridge2(int chain) {
+  return chain+1<aomw_topo_numchains_ ? aomw_topo_chain_i2cbridge1_[chain+1] : aomw_topo_numi2cbridges_;
+}
+
+
+// Run at topo build, before configuring `chain`: counts its RGBIs and or-s the SKIPCHNx bits of its SAIDs.
+static void aomw_topo_chain_census(int chain) {
+  aomw_topo_build_numrgbis_= 0;
+  aomw_topo_build_skipchns_= 0;
+  for( uint16_t addr=1; addr<=aomw_topo_last_[chain]; addr++ ) {
+    uint16_t node= aomw_topo_chain_node0_[chain]+addr;
+    if( AOOSP_IDENTIFY_IS_RGBI(aomw_topo_node_id_[node]) ) aomw_topo_build_numrgbis_++;
+    else aomw_topo_build_skipchns_|= aomw_topo_node_info_[node] & AOMW_TOPO_INFO_SKIPCHNS;
+  }
+}
+
+
+// Nodes identified per aomw_topo_build_step(); their requests are pipelined (see aoosp_send_identify_many)
+#define AOMW_TOPO_BUILD_BATCH 32
+
+
+static uint16_t aomw_topo_batch_addrs_[AOMW_TOPO_BUILD_BATCH];     // Scratch of aomw_topo_node_identify(): the addresses of the batch
+static uint32_t aomw_topo_batch_ids_[AOMW_TOPO_BUILD_BATCH];       // Scratch of aomw_topo_node_identify(): their identities
+static uint16_t aomw_topo_batch_saids_[AOMW_TOPO_BUILD_BATCH];     // Scratch of aomw_topo_node_identify(): the addresses of the SAIDs in the batch
+static uint8_t  aomw_topo_batch_bridgeen_[AOMW_TOPO_BUILD_BATCH];  // Scratch of aomw_topo_node_identify(): OTP byte with I2C_BRIDGE_EN, per SAID
+static uint8_t  aomw_topo_batch_skipchns_[AOMW_TOPO_BUILD_BATCH];  // Scratch of aomw_topo_node_identify(): OTP byte with SKIPCHNx, per SAID
+
+
+// Run at the start of topo build, identifies the `n` OSP nodes from `addr` 
+// on in `chain` (which is selected) and records them with aomw_topo_node_add().
+// The IDENTIFY telegrams, and next the READOTP telegrams of the SAIDs, are 
+// pipelined; the first error (if any) is returned.
+static aoresult_t aomw_topo_node_identify(int chain, uint16_t addr, int n) {
+  aoresult_t result;
+  AORESULT_ASSERT( 0<n && n<=AOMW_TOPO_BUILD_BATCH );
+  for( int i=0; i<n; i++ ) aomw_topo_batch_addrs_[i]= addr+i;
+  result= aoosp_send_identify_many(aomw_topo_batch_addrs_, n, aomw_topo_batch_ids_, 0);
+  if( result!=aoresult_ok ) return result;
+
+  // SAIDs have OTP bits that determine their triplets: I2C_BRIDGE_EN and SKIPCHNx
+  int numsaids= 0;
+  for( int i=0; i<n; i++ ) {
+    if( AOOSP_IDENTIFY_IS_SAID(aomw_topo_batch_ids_[i]) ) aomw_topo_batch_saids_[numsaids++]= aomw_topo_batch_addrs_[i];
+  }
+  result= aoosp_send_readotp_many(aomw_topo_batch_saids_, numsaids, AOOSP_OTPADDR_I2C_BRIDGE_EN, aomw_topo_batch_bridgeen_, 1, 0);
+  if( result!=aoresult_ok ) return result;
+  result= aoosp_send_readotp_many(aomw_topo_batch_saids_, numsaids, AOOSP_OTPADDR_SKIPCHNS, aomw_topo_batch_skipchns_, 1, 0);
+  if( result!=aoresult_ok ) return result;
+
+  // Record the nodes
+  int six= 0; // index in aomw_topo_batch_saids_
+  for( int i=0; i<n; i++ ) {
+    int skipchns= 0;
+    int isbridge= 0;
+    if( AOOSP_IDENTIFY_IS_SAID(aomw_topo_batch_ids_[i]) ) {
+      skipchns= aomw_topo_batch_skipchns_[six] & AOOSP_OTPBITS_SKIPCHNS;
+      isbridge= (aomw_topo_batch_bridgeen_[six] & AOOSP_OTPBITS_I2C_BRIDGE_EN) != 0;
+      six++;
     }
-  
-  } else { // Unknown id
-    
-    return aoresult_sys_id; // Or ignore the node, instead of giving error?
-  
+    result= aomw_topo_node_add(chain, aomw_topo_batch_addrs_[i], aomw_topo_batch_ids_[i], skipchns, isbridge);
+    if( result!=aoresult_ok ) return result;
   }
   return aoresult_ok;
 }
 
 
-static aoresult_t aomw_topo_node_enablecrc(uint16_t addr) {
+// Run after identifying all nodes of `chain` (which is selected), records the
+// IDENTIFY round trip times. The pipelined identification can not time the 
+// individual round trips, so only the first and the last node are timed; the 
+// nodes in between get the linear interpolation (the time grows per hop).
+static aoresult_t aomw_topo_chain_us(int chain) {
   aoresult_t result;
-  if( AOOSP_IDENTIFY_IS_RGBI(aomw_topo_node_id_[addr]) ) {
-    result= aoosp_send_setsetup(addr, AOOSP_SETUP_FLAGS_RGBI_DFLT | AOOSP_SETUP_FLAGS_CRCEN );
-  } else if( AOOSP_IDENTIFY_IS_SAID(aomw_topo_node_id_[addr]) ) {
-    result= aoosp_send_setsetup(addr, AOOSP_SETUP_FLAGS_SAID_DFLT | AOOSP_SETUP_FLAGS_CRCEN );
-  } else {
-    result= aoresult_sys_id; // Or shall we ignore the node, instead of giving error
+  uint32_t   id;
+  uint16_t   last= aomw_topo_last_[chain];
+  result= aoosp_send_identify(1, &id);
+  if( result!=aoresult_ok ) return result;
+  int32_t us1= aospi_txrx_us();
+  int32_t usn= us1;
+  if( last>1 ) {
+    result= aoosp_send_identify(last, &id);
+    if( result!=aoresult_ok ) return result;
+    usn= aospi_txrx_us();
   }
-  return result;
+  for( uint16_t addr=1; addr<=last; addr++ ) {
+    int32_t us= last>1 ? us1 + (usn-us1)*(addr-1)/(last-1) : us1;
+    if( us<0 ) us= 0;
+    aomw_topo_node_us_[aomw_topo_chain_node0_[chain]+addr] = us>0xFFFF ? 0xFFFF : us;
+  }
+  return aoresult_ok;
+}
+
+
+// The SETSETUP flags the builder gives node `node`: the default ones for its type plus CRC checking.
+static uint8_t aomw_topo_node_setupflags(uint16_t node) {
+  if( AOOSP_IDENTIFY_IS_RGBI(aomw_topo_node_id_[node]) ) return AOOSP_SETUP_FLAGS_RGBI_DFLT | AOOSP_SETUP_FLAGS_CRCEN;
+  return AOOSP_SETUP_FLAGS_SAID_DFLT | AOOSP_SETUP_FLAGS_CRCEN;
+}
+
+
+// The SETSETUP flags the builder broadcasts in `chain`: those of its majority type (RGBI or SAID).
+static uint8_t aomw_topo_chain_setupflags(int chain) {
+  if( 2*aomw_topo_build_numrgbis_ > aomw_topo_last_[chain] ) return AOOSP_SETUP_FLAGS_RGBI_DFLT | AOOSP_SETUP_FLAGS_CRCEN;
+  return AOOSP_SETUP_FLAGS_SAID_DFLT | AOOSP_SETUP_FLAGS_CRCEN;
+}
+
+
+// Enables CRC checking in node `node` (its chain is selected).
+static aoresult_t aomw_topo_node_enablecrc(uint16_t node) {
+  if( !AOOSP_IDENTIFY_IS_RGBI(aomw_topo_node_id_[node]) && !AOOSP_IDENTIFY_IS_SAID(aomw_topo_node_id_[node]) ) {
+    return aoresult_sys_id; // Or shall we ignore the node, instead of giving error
+  }
+  return aoosp_send_setsetup(aomw_topo_node_addr(node), aomw_topo_node_setupflags(node));
 }
 
 
+// Sets the current of channel `chn` of SAID `addr` (or all, when broadcast) 
+// to the base current, see aomw_topo_node_setcurrents().
+static aoresult_t aomw_topo_chn_setcurrent(uint16_t addr, int chn) {
+  uint8_t flags= AOOSP_CURCHN_FLAGS_DITHER;
+  if( aomw_topo_sync_ ) flags |= AOOSP_CURCHN_FLAGS_SYNCEN;
+  // Channel 0 is high power, so we select current level 2, channels 1 and 2 are low power, so level 3 (both 3x12mA)
+  int cur= chn==0 ? 2 : 3;
+  return aoosp_send_setcurchn(addr, chn, flags, cur, cur, cur);
+}
+
+
+// Powers the I2C pads of I2C bridge `iix` (its chain is selected).
 static aoresult_t aomw_topo_i2cbridge_power(int iix) {
   // Supply current to I2C pads (channel 2)
-  return aoosp_send_setcurchn( aomw_topo_i2cbridge_addr_[iix], /*chan*/2, AOOSP_CURCHN_FLAGS_DEFAULT,  4, 4, 4);
+  return aoosp_send_setcurchn( aomw_topo_i2cbridge_addr(iix), /*chan*/2, AOOSP_CURCHN_FLAGS_DEFAULT,  4, 4, 4);
 }
 
 
@@ -467,7 +848,7 @@ static aoresult_t aomw_topo_i2cbridge_power(int iix) {
             However SAIDs have some flags in the CURRENT register, like
             AOOSP_CURCHN_FLAGS_DITHER, that can be changed by this function.
     @param  addr
-            The address of the OSP node.
+            The number of the OSP node (its address, for a single chain).
     @param  flags
             Combination of AOOSP_CURCHN_FLAGS_xxx.
     @return aoresult_ok      if successful
@@ -475,9 +856,15 @@ static aoresult_t aomw_topo_i2cbridge_power(int iix) {
             other error code if there is a (communications) error
     @note   Only available after aomw_topo_build() - or start/step.
     @note   addr is 1-based, so 1 <= addr <= aomw_topo_numnodes().
+    @note   Selects the chain of the node (see aomw_topo_node_chain()).
+    @note   When sync mode is on (aomw_topo_sync_set), AOOSP_CURCHN_FLAGS_SYNCEN
+            is added to `flags`.
+    @note   The channels in use come from the topology map (the SKIPCHNS
+            OTP bits read at build), so the OTP is not read again.
 */
 aoresult_t aomw_topo_node_setcurrents(uint16_t addr, uint8_t flags) {
   aoresult_t result;
+  if( aomw_topo_sync_ ) flags |= AOOSP_CURCHN_FLAGS_SYNCEN;
   // To make all triplets have the same brightness, we select a "base current"
   // with which all channels of all nodes are driven. The base current topo
   // selected is 12 mA. This fits withing the capabilities of SAID channel 0,
@@ -490,30 +877,30 @@ aoresult_t aomw_topo_node_setcurrents(uint16_t addr, uint8_t flags) {
   //   chn1 1.5mA 3mA  6mA 12mA 24mA
   //   chn2 1.5mA 3mA  6mA 12mA 24mA
 
-  if(   AOOSP_IDENTIFY_IS_RGBI(aomw_topo_node_id_[addr]) ) return aoresult_ok;     // Skip RGBI's
-  if( ! AOOSP_IDENTIFY_IS_SAID(aomw_topo_node_id_[addr]) ) return aoresult_sys_id; // Or shall we ignore the node, instead of giving error
-
-  // Node addr is a SAID. Only set current for  channels that are used by triplets.
-  int skipchns;
-  result = aoosp_exec_skipchns_get(addr, &skipchns);
+  uint16_t node= addr; // from here on, addr is the OSP address in the chain of the node
+  if(   AOOSP_IDENTIFY_IS_RGBI(aomw_topo_node_id_[node]) ) return aoresult_ok;     // Skip RGBI's
+  if( ! AOOSP_IDENTIFY_IS_SAID(aomw_topo_node_id_[node]) ) return aoresult_sys_id; // Or shall we ignore the node, instead of giving error
+  result= aospi_chain_set(aomw_topo_node_chain(node));
   if( result!=aoresult_ok ) return result;
+  addr= aomw_topo_node_addr(node);
+
+  // Node addr is a SAID. Only set current for channels that are used by triplets.
+  // The SKIPCHNS bits (and the I2C bridge on channel 2) were read from OTP at build.
+  int chans= aomw_topo_node_chans(node);
   
-  if( (skipchns&(1<<0)) == 0 ) {
+  if( chans & (1<<0) ) {
     // Channel 0 is high power, so we select current level 2 (3x12mA)
     result= aoosp_send_setcurchn(addr, 0, flags, 2, 2, 2);
     if( result!=aoresult_ok) return result;
   } 
   
-  if( (skipchns&(1<<1)) == 0 ) {
+  if( chans & (1<<1) ) {
     // Channel 1 is low power, so we select current level 3 (3x12mA)
     result= aoosp_send_setcurchn(addr, 1, flags, 3, 3, 3);
     if( result!=aoresult_ok) return result;
   }
   
-  if( (skipchns&(1<<2)) == 0 ) {
-    // Is channel 2 in use for a triplet? If it is used for I2C bridge, bail out
-    if( aomw_topo_node_numtriplets_[addr]==2 ) return aoresult_ok;
-
+  if( chans & (1<<2) ) {
     // Channel 2 is low power, so we select current level 3 (3x12mA)
     result= aoosp_send_setcurchn(addr, 2, flags, 3, 3, 3);
     if( result!=aoresult_ok) return result;
@@ -523,141 +910,538 @@ aoresult_t aomw_topo_node_setcurrents(uint16_t addr, uint8_t flags) {
 }
 
 
-// === topo build top-level state machine ===================================
+// === topology cache =======================================================
 
 
+// The topology map is saved in a store (see aomw_topo_store_set), as an
+// image: a header, a record per chain, the identity of every node, and an 
+// OTP byte per node (SKIPCHNx and I2C bridge, from which the build derives
+// the triplets and I2C bridges). A build first resets and inits a 
+// chain; when its last address and direction match the image, and so does 
+// the signature over the identities of some sampled nodes, the nodes of the
+// chain are restored from the image instead of scanned.
 
-typedef enum aomw_topo_build_state_e {
-  AOMW_TOPO_BUILD_STATE_START,
-  AOMW_TOPO_BUILD_STATE_IDENTIFYING,
-  AOMW_TOPO_BUILD_STATE_CONFIGCLRERROR,
-  AOMW_TOPO_BUILD_STATE_CONFIGENABLECRC,
-  AOMW_TOPO_BUILD_STATE_CONFIGI2CPOWER,
-  AOMW_TOPO_BUILD_STATE_CONFIGSETCURRENT,
-  AOMW_TOPO_BUILD_STATE_CONFIGGOACTIVE,
-  AOMW_TOPO_BUILD_STATE_DONE,
-} aomw_topo_build_state_t;
 
+#define AOMW_TOPO_CACHE_MAGIC    0x4F504F54 // "TOPO" (little endian)
+#define AOMW_TOPO_CACHE_VERSION  1          // Increment when the image layout changes
+#define AOMW_TOPO_CACHE_SAMPLES  8          // Number of nodes per chain whose IDENTIFY is part of the signature
+#define AOMW_TOPO_CACHE_HASH0    0x811C9DC5 // Initial value of the (FNV-1a) hash
 
-static aomw_topo_build_state_t aomw_topo_build_state;    // current state
-static aoresult_t              aomw_topo_build_result;   // persistent storage of last result (when state==AOMW_TOPO_BUILD_STATE_DONE)
-static int                     aomw_topo_build_substate; // Some states iterate over all nodes or all I2C bridges, this is used to keep track of which
-#define ADDR                   aomw_topo_build_substate  // an alias to make more clear what is iterated over in a state
-#define BIX                    aomw_topo_build_substate  // an alias to make more clear what is iterated over in a state
 
+// The header of the image
+typedef struct aomw_topo_cache_hdr_s {
+  uint32_t magic;     // AOMW_TOPO_CACHE_MAGIC
+  uint16_t version;   // AOMW_TOPO_CACHE_VERSION
+  uint16_t numchains; // Number of chain records following the header
+  uint32_t size;      // Size of the image in bytes, including this header
+  uint32_t hash;      // Hash over the image following this header
+} aomw_topo_cache_hdr_t;
 
-/*!
-    @brief  This function is part of the topology builder.
-            Call this once, then follow up with aomw_topo_build_step().
-    @note   Building might be redone, as long as it begins with start().
-    @note   To build the topology map (fill the topo data model), several 
-            telegrams need to be send to the chain, to individual nodes or 
-            even to channels: reset, init, identify, readotp (for i2c bridge), 
-            clrerror, setsetup (enable crc), setcurrent, goactive.
-            If all those telegrams would be sent in one function, the runtime
-            of that function would be rather long (for long OSP chains). 
-            Therefore this API offers start/step/done, each sending 
-            approximately one telegram per call. If the long run-time is of 
-            no concern, call the convenience function aomw_topo_build().
-*/
-void aomw_topo_build_start() {
-  aomw_topo_build_state= AOMW_TOPO_BUILD_STATE_START;
-}
 
+// The record of a chain in the image
+typedef struct aomw_topo_cache_chain_s {
+  uint16_t last;      // The address of the last node (response from INIT telegram)
+  uint8_t  loop;      // Chain has direction loop (1) or bidir (0)
+  uint8_t  reserved;  // Pads to 32 bits
+  uint32_t sig;       // Signature of the chain, see aomw_topo_cache_sig()
+} aomw_topo_cache_chain_t;
 
-/*!
-    @brief  This function is part of the topology builder.
-            Call this until aomw_topo_build_done(), but after 
-            aomw_topo_build_start().
-    @return aoresult_ok      if successful
-            other error code if there is a (communications) error
-    @note   Send telegrams, approximately one per step() call.
-*/
-#define ON_ERROR_RETURN() do { if( result!=aoresult_ok ) { aomw_topo_build_result=result; aomw_topo_build_state=AOMW_TOPO_BUILD_STATE_DONE; return result; } } while(0)
-aoresult_t aomw_topo_build_step() {
-  aoresult_t result;
 
-  switch( aomw_topo_build_state ) {
+// Size of an image with `numchains` chains and `numnodes` nodes
+#define AOMW_TOPO_CACHE_SIZE(numchains,numnodes) ( sizeof(aomw_topo_cache_hdr_t) + (numchains)*sizeof(aomw_topo_cache_chain_t) + (numnodes)*(sizeof(uint32_t)+sizeof(uint8_t)) )
 
-    case AOMW_TOPO_BUILD_STATE_START:
-      // reset & init entire chain
-      result= aoosp_exec_resetinit(&aomw_topo_last_, &aomw_topo_loop_); ON_ERROR_RETURN();
-      // prep next state (clear database)
-      aomw_topo_numnodes_ = 0;
-      aomw_topo_numtriplets_ = 0;
-      aomw_topo_numi2cbridges_ = 0;
-      ADDR=1; // nodes to scan: 1<=ADDR<=aomw_topo_last_
-      aomw_topo_build_state= AOMW_TOPO_BUILD_STATE_IDENTIFYING;
-      return aoresult_ok;
 
-    case AOMW_TOPO_BUILD_STATE_IDENTIFYING:
-      // Scan node (get its id, get number of triplets)
-      if( ADDR<=aomw_topo_last_ ) { // nodes to scan: 1<=ADDR<=aomw_topo_last_
-        result= aomw_topo_node_identify(ADDR++); ON_ERROR_RETURN();
-        return aoresult_ok; // loop
-      }
-      AORESULT_ASSERT( aomw_topo_last_==aomw_topo_numnodes_);
-      // prep next state
-      aomw_topo_build_state= AOMW_TOPO_BUILD_STATE_CONFIGCLRERROR;
-      return aoresult_ok;
+static const aomw_topo_store_t * aomw_topo_store_= &aomw_topo_store_ram; // The store of the cache (0 if disabled)
+static int      aomw_topo_cache_numchains_;                        // The number of chains in the image in the store (0 if no valid image)
+static uint32_t aomw_topo_cache_numnodes_;                         // The number of nodes in the image in the store
+static int      aomw_topo_cache_hits_;                             // The number of chains restored from the image by the last build
 
-    case AOMW_TOPO_BUILD_STATE_CONFIGCLRERROR:
-      // Broadcast clear error (to clear the over voltage flag of all SAIDs), must have, otherwise SAID will not go ACTIVE
-      result= aoosp_send_clrerror(0); ON_ERROR_RETURN();
-      // prep next state
-      aomw_topo_build_state= AOMW_TOPO_BUILD_STATE_CONFIGENABLECRC;
-      ADDR=1; // nodes to enable CRC checking for: 1<=ADDR<=aomw_topo_last_
-      return aoresult_ok;
 
-    case AOMW_TOPO_BUILD_STATE_CONFIGENABLECRC:
-      // Enable CRC for all nodes (could be skipped)
-      if( ADDR <= aomw_topo_last_ ) { // nodes to enable CRC checking for: 1<=ADDR<=aomw_topo_last_
-        result= aomw_topo_node_enablecrc(ADDR++); ON_ERROR_RETURN();
-        return aoresult_ok; // loop
-      }
-      // prep next state
-      BIX=0; // I2C bridges to power: 0<=BIX<aomw_topo_numi2cbridges_
-      aomw_topo_build_state= AOMW_TOPO_BUILD_STATE_CONFIGI2CPOWER;
-      return aoresult_ok;
+// Adds the `size` bytes at `buf` to (FNV-1a) hash `hash`
+static uint32_t aomw_topo_cache_hash(uint32_t hash, const void * buf, uint32_t size) {
+  const uint8_t * p= buf;
+  while( size-- > 0 ) hash= (hash ^ *p++) * 0x01000193;
+  return hash;
+}
 
-    case AOMW_TOPO_BUILD_STATE_CONFIGI2CPOWER:
-      // Every I2C bridge needs its pads powered
-      if( BIX < aomw_topo_numi2cbridges_ ) { // I2C bridges to power: 0<=BIX<aomw_topo_numi2cbridges_
-        result= aomw_topo_i2cbridge_power(BIX++); ON_ERROR_RETURN();
-        return aoresult_ok; // loop
-      }
-      // prep next state
-      ADDR=1; // nodes to set PWM current: 1<=ADDR<=aomw_topo_last_
-      aomw_topo_build_state= AOMW_TOPO_BUILD_STATE_CONFIGSETCURRENT;
-      return aoresult_ok;
 
-    case AOMW_TOPO_BUILD_STATE_CONFIGSETCURRENT:
-      // Set the current level of the PWM drivers
-      if( ADDR <= aomw_topo_last_ ) { // nodes to set PWM current: 1<=ADDR<=aomw_topo_last_
-        result= aomw_topo_node_setcurrents(ADDR++,AOOSP_CURCHN_FLAGS_DITHER); ON_ERROR_RETURN();
-        return aoresult_ok; // loop
-      }
-      // prep next state
-      aomw_topo_build_state= AOMW_TOPO_BUILD_STATE_CONFIGGOACTIVE;
-      return aoresult_ok;
+// Fills `addrs` with the addresses of the nodes sampled for the signature of a chain ending at `last`; returns their count
+static int aomw_topo_cache_samples(uint16_t last, uint16_t * addrs) {
+  if( last<=AOMW_TOPO_CACHE_SAMPLES ) {
+    for( int i=0; i<last; i++ ) addrs[i]= i+1;
+    return last;
+  }
+  // First, last and evenly spread in between
+  for( int i=0; i<AOMW_TOPO_CACHE_SAMPLES; i++ ) addrs[i]= 1 + (uint32_t)i*(last-1)/(AOMW_TOPO_CACHE_SAMPLES-1);
+  return AOMW_TOPO_CACHE_SAMPLES;
+}
 
-    case AOMW_TOPO_BUILD_STATE_CONFIGGOACTIVE:
-      // Switch all nodes to active (LEDs on)
-      result= aoosp_send_goactive(0); ON_ERROR_RETURN();
-      // prep next state
-      aomw_topo_build_result= aoresult_ok;
-      aomw_topo_build_state= AOMW_TOPO_BUILD_STATE_DONE;
-      return aoresult_ok;
 
-    case AOMW_TOPO_BUILD_STATE_DONE:
-      return aomw_topo_build_result;
-  }
+// The signature of a chain: hash over its last address, its direction and the identities `ids[0..n-1]` of the sampled nodes
+static uint32_t aomw_topo_cache_sig(uint16_t last, int loop, const uint32_t * ids, int n) {
+  uint8_t  dir= loop;
+  uint32_t hash= aomw_topo_cache_hash(AOMW_TOPO_CACHE_HASH0, &last, sizeof last);
+  hash= aomw_topo_cache_hash(hash, &dir, sizeof dir);
+  return aomw_topo_cache_hash(hash, ids, n*sizeof(uint32_t));
+}
 
-  return aoresult_assert; // should never reach this
+
+// The OTP byte of node `node` in the image: the skipped channels of a SAID (SKIPCHNx) and AOMW_TOPO_INFO_BRIDGE
+static uint8_t aomw_topo_cache_otp(uint16_t node) {
+  return aomw_topo_node_info_[node] & (AOMW_TOPO_INFO_SKIPCHNS | AOMW_TOPO_INFO_BRIDGE);
 }
 
 
-/*!
+// Checks the image in the store (header, hash and chain records), and
+// records the number of chains and nodes in it (0 chains if not valid).
+static void aomw_topo_cache_check() {
+  aomw_topo_cache_hdr_t hdr;
+  aomw_topo_cache_chain_t rec;
+  aomw_topo_cache_numchains_= 0;
+  aomw_topo_cache_numnodes_= 0;
+  if( aomw_topo_store_==0 ) return;
+  if( aomw_topo_store_->read(0, &hdr, sizeof hdr)!=aoresult_ok ) return;
+  if( hdr.magic!=AOMW_TOPO_CACHE_MAGIC || hdr.version!=AOMW_TOPO_CACHE_VERSION ) return;
+  if( hdr.numchains<1 || hdr.numchains>AOMW_TOPO_MAXCHAINS || hdr.size<AOMW_TOPO_CACHE_SIZE(hdr.numchains,0) ) return;
+  // Hash the image in chunks
+  uint8_t  buf[64];
+  uint32_t hash= AOMW_TOPO_CACHE_HASH0;
+  for( uint32_t offset=sizeof hdr; offset<hdr.size; offset+=sizeof buf ) {
+    uint32_t size= hdr.size-offset < sizeof buf ? hdr.size-offset : sizeof buf;
+    if( aomw_topo_store_->read(offset, buf, size)!=aoresult_ok ) return;
+    hash= aomw_topo_cache_hash(hash, buf, size);
+  }
+  if( hash!=hdr.hash ) return;
+  // The chains must account for all nodes
+  uint32_t numnodes= 0;
+  for( int c=0; c<hdr.numchains; c++ ) {
+    if( aomw_topo_store_->read(sizeof hdr+c*sizeof rec, &rec, sizeof rec)!=aoresult_ok ) return;
+    numnodes+= rec.last;
+  }
+  if( hdr.size!=AOMW_TOPO_CACHE_SIZE(hdr.numchains,numnodes) ) return;
+  aomw_topo_cache_numchains_= hdr.numchains;
+  aomw_topo_cache_numnodes_= numnodes;
+}
+
+
+// Run at the start of topo build, after reset and init of `chain` (which is 
+// selected). If the chain matches its record in the image, its nodes are 
+// restored from the image and `*hit` is set, otherwise `*hit` is cleared.
+// Matching costs one pipelined batch of IDENTIFY telegrams.
+static aoresult_t aomw_topo_cache_restore(int chain, int * hit) {
+  aoresult_t result;
+  aomw_topo_cache_chain_t rec;
+  *hit= 0;
+  if( chain>=aomw_topo_cache_numchains_ ) return aoresult_ok;
+
+  // Find the record of the chain and its first node in the image
+  uint32_t node0= 0;
+  for( int c=0; c<=chain; c++ ) {
+    result= aomw_topo_store_->read(sizeof(aomw_topo_cache_hdr_t)+c*sizeof rec, &rec, sizeof rec);
+    if( result!=aoresult_ok ) return result;
+    if( c<chain ) node0+= rec.last;
+  }
+  if( rec.last!=aomw_topo_last_[chain] || rec.loop!=aomw_topo_loop_[chain] ) return aoresult_ok;
+
+  // Compare the signature with that of the sampled nodes
+  uint16_t addrs[AOMW_TOPO_CACHE_SAMPLES];
+  uint32_t ids[AOMW_TOPO_CACHE_SAMPLES];
+  int n= aomw_topo_cache_samples(rec.last, addrs);
+  result= aoosp_send_identify_many(addrs, n, ids, 0);
+  if( result!=aoresult_ok ) return result;
+  if( aomw_topo_cache_sig(rec.last, rec.loop, ids, n)!=rec.sig ) return aoresult_ok;
+
+  // Restore the nodes
+  uint32_t idoffset = AOMW_TOPO_CACHE_SIZE(aomw_topo_cache_numchains_,0);
+  uint32_t otpoffset= idoffset + aomw_topo_cache_numnodes_*sizeof(uint32_t);
+  for( uint16_t addr=1; addr<=rec.last; addr++ ) {
+    uint32_t id;
+    uint8_t  otp;
+    result= aomw_topo_store_->read(idoffset+(node0+addr-1)*sizeof id, &id, sizeof id);
+    if( result!=aoresult_ok ) return result;
+    result= aomw_topo_store_->read(otpoffset+(node0+addr-1)*sizeof otp, &otp, sizeof otp);
+    if( result!=aoresult_ok ) return result;
+    result= aomw_topo_node_add(chain, addr, id, otp & AOOSP_OTPBITS_SKIPCHNS, (otp & AOMW_TOPO_INFO_BRIDGE)!=0 );
+    if( result!=aoresult_ok ) return result;
+  }
+  *hit= 1;
+  return aoresult_ok;
+}
+
+
+// Run at the end of topo build, saves the topology map as image in the store.
+// The header is written last, so that an interrupted save leaves no valid image.
+static aoresult_t aomw_topo_cache_save() {
+  aoresult_t result;
+  aomw_topo_cache_hdr_t hdr;
+  uint32_t offset= sizeof hdr;
+  hdr.magic= AOMW_TOPO_CACHE_MAGIC;
+  hdr.version= AOMW_TOPO_CACHE_VERSION;
+  hdr.numchains= aomw_topo_numchains_;
+  hdr.size= AOMW_TOPO_CACHE_SIZE(aomw_topo_numchains_,aomw_topo_numnodes_);
+  hdr.hash= AOMW_TOPO_CACHE_HASH0;
+  result= aomw_topo_store_->erase(hdr.size);
+  if( result!=aoresult_ok ) return result;
+
+  // The chain records
+  for( int chain=0; chain<aomw_topo_numchains_; chain++ ) {
+    aomw_topo_cache_chain_t rec;
+    uint16_t addrs[AOMW_TOPO_CACHE_SAMPLES];
+    uint32_t ids[AOMW_TOPO_CACHE_SAMPLES];
+    int n= aomw_topo_cache_samples(aomw_topo_last_[chain], addrs);
+    for( int i=0; i<n; i++ ) ids[i]= aomw_topo_node_id_[aomw_topo_chain_node0_[chain]+addrs[i]];
+    rec.last= aomw_topo_last_[chain];
+    rec.loop= aomw_topo_loop_[chain];
+    rec.reserved= 0;
+    rec.sig= aomw_topo_cache_sig(rec.last, rec.loop, ids, n);
+    result= aomw_topo_store_->write(offset, &rec, sizeof rec);
+    if( result!=aoresult_ok ) return result;
+    hdr.hash= aomw_topo_cache_hash(hdr.hash, &rec, sizeof rec);
+    offset+= sizeof rec;
+  }
+
+  // The identities, then the OTP bytes, of all nodes
+  for( uint16_t node=1; node<=aomw_topo_numnodes_; node++ ) {
+    result= aomw_topo_store_->write(offset, &aomw_topo_node_id_[node], sizeof(uint32_t));
+    if( result!=aoresult_ok ) return result;
+    hdr.hash= aomw_topo_cache_hash(hdr.hash, &aomw_topo_node_id_[node], sizeof(uint32_t));
+    offset+= sizeof(uint32_t);
+  }
+  for( uint16_t node=1; node<=aomw_topo_numnodes_; node++ ) {
+    uint8_t otp= aomw_topo_cache_otp(node);
+    result= aomw_topo_store_->write(offset, &otp, sizeof otp);
+    if( result!=aoresult_ok ) return result;
+    hdr.hash= aomw_topo_cache_hash(hdr.hash, &otp, sizeof otp);
+    offset+= sizeof otp;
+  }
+  AORESULT_ASSERT( offset==hdr.size );
+
+  // Finally the header
+  result= aomw_topo_store_->write(0, &hdr, sizeof hdr);
+  if( result!=aoresult_ok ) return result;
+  aomw_topo_cache_numchains_= hdr.numchains;
+  aomw_topo_cache_numnodes_= aomw_topo_numnodes_;
+  return aoresult_ok;
+}
+
+
+/*!
+    @brief  Sets the store that keeps the topology cache.
+    @param  store
+            The store, eg &aomw_topo_store_ram, or 0 to disable the cache.
+    @note   By default the cache is kept in aomw_topo_store_ram; a store
+            in flash makes the cache survive a power cycle.
+    @note   Takes effect at the next aomw_topo_build().
+*/
+void aomw_topo_store_set( const aomw_topo_store_t * store ) {
+  aomw_topo_store_= store;
+  aomw_topo_cache_numchains_= 0;
+}
+
+
+/*!
+    @brief  Returns the store that keeps the topology cache.
+    @return The store, or 0 when the cache is disabled.
+*/
+const aomw_topo_store_t * aomw_topo_store_get() {
+  return aomw_topo_store_;
+}
+
+
+/*!
+    @brief  Invalidates the image in the topology cache, so that the next
+            aomw_topo_build() scans all chains.
+    @return aoresult_ok      if successful
+            other error code if the store fails
+*/
+aoresult_t aomw_topo_cache_clear() {
+  aomw_topo_cache_numchains_= 0;
+  if( aomw_topo_store_==0 ) return aoresult_ok;
+  return aomw_topo_store_->erase(sizeof(aomw_topo_cache_hdr_t));
+}
+
+
+/*!
+    @brief  Returns how many chains the last aomw_topo_build() restored 
+            from the topology cache (the other chains were scanned).
+    @return The number of chains restored from the cache.
+*/
+int aomw_topo_cache_hits() {
+  return aomw_topo_cache_hits_;
+}
+
+
+// The RAM store: the image is kept in a section that the startup code does not clear
+static uint8_t aomw_topo_store_ram_buf_[AOMW_TOPO_CACHE_SIZE(AOMW_TOPO_MAXCHAINS,AOMW_TOPO_CAPNODES)] __attribute__((section(".noinit")));
+
+
+// Reads `size` bytes at `offset` from the RAM store into `buf`
+static aoresult_t aomw_topo_store_ram_read( uint32_t offset, void * buf, uint32_t size ) {
+  if( offset+size > sizeof aomw_topo_store_ram_buf_ ) return aoresult_outofmem;
+  memcpy(buf, &aomw_topo_store_ram_buf_[offset], size);
+  return aoresult_ok;
+}
+
+
+// Erases the first `size` bytes of the RAM store (to 0xFF like flash)
+static aoresult_t aomw_topo_store_ram_erase( uint32_t size ) {
+  if( size > sizeof aomw_topo_store_ram_buf_ ) return aoresult_outofmem;
+  memset(aomw_topo_store_ram_buf_, 0xFF, size);
+  return aoresult_ok;
+}
+
+
+// Writes `size` bytes from `buf` at `offset` in the RAM store
+static aoresult_t aomw_topo_store_ram_write( uint32_t offset, const void * buf, uint32_t size ) {
+  if( offset+size > sizeof aomw_topo_store_ram_buf_ ) return aoresult_outofmem;
+  memcpy(&aomw_topo_store_ram_buf_[offset], buf, size);
+  return aoresult_ok;
+}
+
+
+// A store in RAM that survives a warm reset (not a power cycle).
+const aomw_topo_store_t aomw_topo_store_ram = {
+  "ram", aomw_topo_store_ram_read, aomw_topo_store_ram_erase, aomw_topo_store_ram_write
+};
+
+
+// === topo build top-level state machine ===================================
+
+
+
+typedef enum aomw_topo_build_state_e {
+  AOMW_TOPO_BUILD_STATE_START,
+  AOMW_TOPO_BUILD_STATE_CACHECHECK,
+  AOMW_TOPO_BUILD_STATE_IDENTIFYING,
+  AOMW_TOPO_BUILD_STATE_CONFIGCLRERROR,
+  AOMW_TOPO_BUILD_STATE_CONFIGENABLECRC,
+  AOMW_TOPO_BUILD_STATE_CONFIGSETCURRENT,
+  AOMW_TOPO_BUILD_STATE_CONFIGI2CPOWER,
+  AOMW_TOPO_BUILD_STATE_CONFIGGOACTIVE,
+  AOMW_TOPO_BUILD_STATE_CACHESAVE,
+  AOMW_TOPO_BUILD_STATE_DONE,
+} aomw_topo_build_state_t;
+
+
+static aomw_topo_build_state_t aomw_topo_build_state;    // current state
+static aoresult_t              aomw_topo_build_result;   // persistent storage of last result (when state==AOMW_TOPO_BUILD_STATE_DONE)
+static int                     aomw_topo_build_substate; // Some states iterate over all nodes or all I2C bridges, this is used to keep track of which
+static int                     aomw_topo_build_chain;    // The chain being built; chains are built one after the other
+#define ADDR                   aomw_topo_build_substate  // an alias to make more clear what is iterated over in a state
+#define BIX                    aomw_topo_build_substate  // an alias to make more clear what is iterated over in a state
+#define TIX                    aomw_topo_build_substate  // an alias to make more clear what is iterated over in a state
+#define CHN                    aomw_topo_build_substate  // an alias to make more clear what is iterated over in a state
+#define CHAIN                  aomw_topo_build_chain     // an alias, for symmetry with ADDR and BIX
+
+
+/*!
+    @brief  This function is part of the topology builder.
+            Call this once, then follow up with aomw_topo_build_step().
+    @note   Building might be redone, as long as it begins with start().
+    @note   To build the topology map (fill the topo data model), several 
+            telegrams need to be send to the chain, to individual nodes or 
+            even to channels: reset, init, identify, readotp (for i2c bridge), 
+            clrerror, setsetup (enable crc), setcurrent, goactive.
+            If all those telegrams would be sent in one function, the runtime
+            of that function would be rather long (for long OSP chains). 
+            Therefore this API offers start/step/done, each sending 
+            approximately one telegram per call. If the long run-time is of 
+            no concern, call the convenience function aomw_topo_build().
+    @note   To keep the number of telegrams low, a step identifies a batch 
+            of AOMW_TOPO_BUILD_BATCH nodes with pipelined IDENTIFY/READOTP 
+            requests. SETSETUP is broadcast, followed by a unicast to nodes
+            of the minority type. SETCURCHN is broadcast when the chain has 
+            only SAIDs with all channels in use (the I2C bridges get their 
+            channel 2 back after that), otherwise it is sent per SAID triplet.
+    @note   A chain that matches the topology cache (see aomw_topo_store_set)
+            is restored from the cache instead of identified node by node;
+            the build ends with saving the map in the cache (if changed).
+*/
+void aomw_topo_build_start() {
+  aomw_topo_build_state= AOMW_TOPO_BUILD_STATE_START;
+  aomw_topo_build_chain= 0;
+  aomw_topo_sync_= 0; // the RESET of the build ends sync mode
+}
+
+
+/*!
+    @brief  This function is part of the topology builder.
+            Call this until aomw_topo_build_done(), but after 
+            aomw_topo_build_start().
+    @return aoresult_ok      if successful
+            other error code if there is a (communications) error
+    @note   Send telegrams, approximately one (or one batch) per step() call.
+    @note   With several chains (see aospi_chain_count), all chains are 
+            first RESET and INITed, then identified, then configured (up to
+            GOACTIVE), each phase chain after chain. Chain 0 must respond; 
+            the first other chain that does not respond to RESET/INIT 
+            (aoresult_spi_noclock, eg no bridge connected) ends the scan. 
+            When done, chain 0 is selected.
+    @note   The map is carved from a static arena: the node arrays after 
+            INIT, the triplet arrays after identifying. A map with more than
+            AOMW_TOPO_CAPNODES nodes fails with aoresult_outofmem.
+*/
+#define ON_ERROR_RETURN() do { if( result!=aoresult_ok ) { aomw_topo_build_result=result; aomw_topo_build_state=AOMW_TOPO_BUILD_STATE_DONE; return result; } } while(0)
+aoresult_t aomw_topo_build_step() {
+  aoresult_t result;
+  int        hit;
+
+  switch( aomw_topo_build_state ) {
+
+    case AOMW_TOPO_BUILD_STATE_START:
+      // reset & init entire chain, one chain per step
+      result= aospi_chain_set(CHAIN); ON_ERROR_RETURN();
+      result= aoosp_exec_resetinit(&aomw_topo_last_[CHAIN], &aomw_topo_loop_[CHAIN]);
+      if( result==aoresult_spi_noclock && CHAIN>0 ) {
+        // No (other) chain connected: the chains found so far make the map
+        aomw_topo_build_numchains_= CHAIN;
+      } else {
+        ON_ERROR_RETURN();
+        aomw_topo_chain_node0_[CHAIN] = CHAIN==0 ? 0 : aomw_topo_chain_node0_[CHAIN-1]+aomw_topo_last_[CHAIN-1];
+        aomw_topo_build_numchains_= CHAIN+1;
+        if( CHAIN+1<aospi_chain_count() && CHAIN+1<AOMW_TOPO_MAXCHAINS ) {
+          CHAIN++;
+          return aoresult_ok; // loop
+        }
+      }
+      // prep next state (clear database, sized for the nodes of all chains)
+      result= aomw_topo_nodes_alloc(); ON_ERROR_RETURN();
+      aomw_topo_cache_hits_ = 0;
+      aomw_topo_cache_check();
+      CHAIN= 0;
+      result= aospi_chain_set(CHAIN); ON_ERROR_RETURN();
+      aomw_topo_build_state= AOMW_TOPO_BUILD_STATE_CACHECHECK;
+      return aoresult_ok;
+
+    case AOMW_TOPO_BUILD_STATE_CACHECHECK:
+      // Restore the chain from the cache if it matches
+      result= aomw_topo_cache_restore(CHAIN, &hit); ON_ERROR_RETURN();
+      if( hit ) aomw_topo_cache_hits_++;
+      // prep next state
+      ADDR= hit ? aomw_topo_last_[CHAIN]+1 : 1; // nodes to scan: 1<=ADDR<=aomw_topo_last_[CHAIN] (none after a hit)
+      aomw_topo_build_state= AOMW_TOPO_BUILD_STATE_IDENTIFYING;
+      return aoresult_ok;
+
+    case AOMW_TOPO_BUILD_STATE_IDENTIFYING:
+      // Scan a batch of nodes (get their ids, get number of triplets)
+      if( ADDR<=aomw_topo_last_[CHAIN] ) { // nodes to scan: 1<=ADDR<=aomw_topo_last_[CHAIN]
+        int n= aomw_topo_last_[CHAIN]-ADDR+1;
+        if( n>AOMW_TOPO_BUILD_BATCH ) n= AOMW_TOPO_BUILD_BATCH;
+        result= aomw_topo_node_identify(CHAIN, ADDR, n); ON_ERROR_RETURN();
+        ADDR+= n;
+        return aoresult_ok; // loop
+      }
+      AORESULT_ASSERT( aomw_topo_chain_node0_[CHAIN]+aomw_topo_last_[CHAIN]==aomw_topo_numnodes_);
+      result= aomw_topo_chain_us(CHAIN); ON_ERROR_RETURN();
+      // prep next state: next chain, if any, otherwise the triplets of all nodes
+      if( CHAIN+1<aomw_topo_build_numchains_ ) {
+        CHAIN++;
+        result= aospi_chain_set(CHAIN); ON_ERROR_RETURN();
+        aomw_topo_build_state= AOMW_TOPO_BUILD_STATE_CACHECHECK;
+        return aoresult_ok;
+      }
+      result= aomw_topo_triplets_alloc(); ON_ERROR_RETURN();
+      CHAIN= 0;
+      result= aospi_chain_set(CHAIN); ON_ERROR_RETURN();
+      aomw_topo_build_state= AOMW_TOPO_BUILD_STATE_CONFIGCLRERROR;
+      return aoresult_ok;
+
+    case AOMW_TOPO_BUILD_STATE_CONFIGCLRERROR:
+      // Broadcast clear error (to clear the over voltage flag of all SAIDs), must have, otherwise SAID will not go ACTIVE
+      result= aoosp_send_clrerror(0); ON_ERROR_RETURN();
+      aomw_topo_chain_census(CHAIN);
+      // prep next state
+      aomw_topo_build_state= AOMW_TOPO_BUILD_STATE_CONFIGENABLECRC;
+      ADDR=0; // broadcast, then nodes to enable CRC checking for: 1<=ADDR<=aomw_topo_last_[CHAIN]
+      return aoresult_ok;
+
+    case AOMW_TOPO_BUILD_STATE_CONFIGENABLECRC:
+      // Enable CRC for all nodes (could be skipped): broadcast the flags of the majority type
+      if( ADDR==0 ) {
+        result= aoosp_send_setsetup(AOOSP_ADDR_BROADCAST, aomw_topo_chain_setupflags(CHAIN)); ON_ERROR_RETURN();
+        ADDR++;
+        return aoresult_ok; // loop
+      }
+      // Then unicast to the nodes that need other flags
+      while( ADDR <= aomw_topo_last_[CHAIN] ) { // nodes to enable CRC checking for: 1<=ADDR<=aomw_topo_last_[CHAIN]
+        uint16_t node= aomw_topo_chain_node0_[CHAIN]+ADDR++;
+        if( aomw_topo_node_setupflags(node)==aomw_topo_chain_setupflags(CHAIN) ) continue; // got the broadcast
+        result= aomw_topo_node_enablecrc(node); ON_ERROR_RETURN();
+        return aoresult_ok; // loop
+      }
+      // prep next state
+      if( aomw_topo_build_numrgbis_==0 && aomw_topo_build_skipchns_==0 ) {
+        CHN= 0; // uniform chain, channels to broadcast the current for: 0<=CHN<3
+      } else {
+        TIX= aomw_topo_chain_triplet1_[CHAIN]; // triplets (of this chain) to set the current for: TIX<aomw_topo_chain_triplet2(CHAIN)
+      }
+      aomw_topo_build_state= AOMW_TOPO_BUILD_STATE_CONFIGSETCURRENT;
+      return aoresult_ok;
+
+    case AOMW_TOPO_BUILD_STATE_CONFIGSETCURRENT:
+      // Set the current level of the PWM drivers
+      if( aomw_topo_build_numrgbis_==0 && aomw_topo_build_skipchns_==0 ) {
+        // Only SAIDs, all channels in use: broadcast per channel (I2C bridges get channel 2 in the next state)
+        if( CHN < 3 ) { // channels to broadcast the current for: 0<=CHN<3
+          result= aomw_topo_chn_setcurrent(AOOSP_ADDR_BROADCAST, CHN++); ON_ERROR_RETURN();
+          return aoresult_ok; // loop
+        }
+      } else {
+        // Mixed chain: per SAID triplet (RGBIs have their current in the PWM setting)
+        while( TIX < aomw_topo_chain_triplet2(CHAIN) ) { // triplets (of this chain) to set the current for: TIX<aomw_topo_chain_triplet2(CHAIN)
+          if( !aomw_topo_triplet_onchan(TIX) ) { TIX++; continue; }
+          result= aomw_topo_chn_setcurrent(aomw_topo_triplet_addr(TIX), aomw_topo_triplet_chan(TIX)); ON_ERROR_RETURN();
+          TIX++;
+          return aoresult_ok; // loop
+        }
+      }
+      // prep next state
+      BIX=aomw_topo_chain_i2cbridge1_[CHAIN]; // I2C bridges (of this chain) to power: BIX<aomw_topo_chain_i2cbridge2(CHAIN)
+      aomw_topo_build_state= AOMW_TOPO_BUILD_STATE_CONFIGI2CPOWER;
+      return aoresult_ok;
+
+    case AOMW_TOPO_BUILD_STATE_CONFIGI2CPOWER:
+      // Every I2C bridge needs its pads powered
+      if( BIX < aomw_topo_chain_i2cbridge2(CHAIN) ) { // I2C bridges (of this chain) to power: BIX<aomw_topo_chain_i2cbridge2(CHAIN)
+        result= aomw_topo_i2cbridge_power(BIX++); ON_ERROR_RETURN();
+        return aoresult_ok; // loop
+      }
+      // prep next state
+      aomw_topo_build_state= AOMW_TOPO_BUILD_STATE_CONFIGGOACTIVE;
+      return aoresult_ok;
+
+    case AOMW_TOPO_BUILD_STATE_CONFIGGOACTIVE:
+      // Switch all nodes to active (LEDs on)
+      result= aoosp_send_goactive(0); ON_ERROR_RETURN();
+      // prep next state: next chain, if any
+      if( CHAIN+1<aomw_topo_numchains_ ) {
+        CHAIN++;
+        result= aospi_chain_set(CHAIN); ON_ERROR_RETURN();
+        aomw_topo_build_state= AOMW_TOPO_BUILD_STATE_CONFIGCLRERROR;
+        return aoresult_ok;
+      }
+      aospi_chain_set(0);
+      aomw_topo_build_state= AOMW_TOPO_BUILD_STATE_CACHESAVE;
+      return aoresult_ok;
+
+    case AOMW_TOPO_BUILD_STATE_CACHESAVE:
+      // Save the map in the cache, unless all chains were restored from it
+      if( aomw_topo_store_!=0 && (aomw_topo_cache_hits_<aomw_topo_numchains_ || aomw_topo_cache_numchains_!=aomw_topo_numchains_) ) {
+        result= aomw_topo_cache_save(); ON_ERROR_RETURN();
+      }
+      aomw_topo_build_result= aoresult_ok;
+      aomw_topo_build_state= AOMW_TOPO_BUILD_STATE_DONE;
+      return aoresult_ok;
+
+    case AOMW_TOPO_BUILD_STATE_DONE:
+      return aomw_topo_build_result;
+  }
+
+  return aoresult_assert; // should never reach this
+}
+
+
+/*!
     @brief  This function is part of the topology builder.
             Call this after aomw_topo_build_step(), to determine if
             another step() is needed.
@@ -695,6 +1479,64 @@ aoresult_t aomw_topo_build() {
 static int aomw_topo_dim = AOMW_TOPO_DIM_DEFAULT;
 
 
+// A topo color component (0..AOMW_TOPO_BRIGHTNESS_MAX) is mapped to a PWM 
+// value (also 15 bits) by a lookup table per channel (red, green, blue). A
+// table combines the curve (linear, or on request a perceptual curve: CIE
+// 1931 lightness, so that equal steps in topo brightness look equally
+// large, also at the low end), the global 
+// dim level and the white balance factor of the channel. A table has an 
+// entry every 1<<AOMW_TOPO_LUT_SHIFT topo brightness levels; the levels in
+// between are linearly interpolated. The tables are regenerated when the 
+// dim level, the white balance or the curve changes.
+
+
+#define AOMW_TOPO_LUT_SHIFT      7 // Number of low bits of a topo brightness level that are interpolated
+#define AOMW_TOPO_LUT_SIZE       ( ((AOMW_TOPO_BRIGHTNESS_MAX+1)>>AOMW_TOPO_LUT_SHIFT) + 1 ) // Entries per table
+
+
+static int      aomw_topo_gamma_ = 0;                              // Perceptual curve on (1) or linear (0, default), see aomw_topo_gamma_set()
+static int      aomw_topo_wb_[3] = { 1024, 1024, 1024 };           // White balance factor (0..1024) per channel, see aomw_topo_wb_set()
+static uint16_t aomw_topo_lut_[3][AOMW_TOPO_LUT_SIZE];             // Lookup table per channel: PWM value for every 1<<AOMW_TOPO_LUT_SHIFT brightness levels
+static int      aomw_topo_lut_valid_;                              // The lookup tables match the dim level, white balance and curve
+
+
+// Regenerates the lookup tables (from the dim level, white balance and curve).
+static void aomw_topo_lut_make() {
+  for( int i=0; i<AOMW_TOPO_LUT_SIZE; i++ ) {
+    float l= (float)(i<<AOMW_TOPO_LUT_SHIFT)/AOMW_TOPO_BRIGHTNESS_MAX; // lightness 0..1 (the entry past the end slightly above 1)
+    float y= l; // relative luminance 0..1
+    if( aomw_topo_gamma_ ) {
+      float c= (l+0.16f)/1.16f;
+      y= l<=0.08f ? l/9.033f : c*c*c;
+    }
+    for( int chn=0; chn<3; chn++ ) {
+      // Last entry may be BRIGHTNESS_MAX+1 (it is the level past the end); aomw_topo_lut() clamps
+      aomw_topo_lut_[chn][i]= (uint16_t)( y*(AOMW_TOPO_BRIGHTNESS_MAX+1)*aomw_topo_dim/1024*aomw_topo_wb_[chn]/1024 + 0.5f );
+    }
+  }
+  aomw_topo_lut_valid_= 1;
+}
+
+
+// Maps topo brightness `level` of channel `chn` (0=red, 1=green, 2=blue) to a PWM value, via the lookup table.
+static inline uint16_t aomw_topo_lut( int chn, uint16_t level ) {
+  if( level>AOMW_TOPO_BRIGHTNESS_MAX ) level= AOMW_TOPO_BRIGHTNESS_MAX;
+  const uint16_t * lut= &aomw_topo_lut_[chn][level>>AOMW_TOPO_LUT_SHIFT];
+  int frac= level & ((1<<AOMW_TOPO_LUT_SHIFT)-1);
+  int pwm= lut[0] + (((lut[1]-lut[0])*frac) >> AOMW_TOPO_LUT_SHIFT);
+  return pwm>AOMW_TOPO_BRIGHTNESS_MAX ? AOMW_TOPO_BRIGHTNESS_MAX : pwm;
+}
+
+
+// Maps topo color `rgb` to the PWM values `r`, `g` and `b` (curve, dim level and white balance applied).
+static void aomw_topo_rgb_pwm( const aomw_topo_rgb_t * rgb, uint16_t * r, uint16_t * g, uint16_t * b ) {
+  if( !aomw_topo_lut_valid_ ) aomw_topo_lut_make();
+  *r= aomw_topo_lut(0, rgb->r);
+  *g= aomw_topo_lut(1, rgb->g);
+  *b= aomw_topo_lut(2, rgb->b);
+}
+
+
 // We define some standard colors in the AOMW_TOPO_BRIGHTNESS_MAX range.
 extern const aomw_topo_rgb_t aomw_topo_red    = { 0x7FFF,0x0000,0x0000, "red" };
 extern const aomw_topo_rgb_t aomw_topo_yellow = { 0x7FFF,0x7FFF,0x0000, "yellow" };
@@ -706,6 +1548,32 @@ extern const aomw_topo_rgb_t aomw_topo_white  = { 0x7FFF,0x7FFF,0x7FFF, "white"
 extern const aomw_topo_rgb_t aomw_topo_off    = { 0x0000,0x0000,0x0000, "off" };
 
 
+// Sends the PWM telegram for triplet `tix` with color `rgb` (dimmed); selects the chain of the triplet.
+static aoresult_t aomw_topo_settriplet_pwm( uint16_t tix, const aomw_topo_rgb_t *rgb  ) {
+  // We dim brightness here to prevent under voltage (and apply the curve and white balance)
+  uint16_t r, g, b;
+  aomw_topo_rgb_pwm(rgb, &r, &g, &b);
+  // Select osp chain (node and channel are in the prebuilt telegram header)
+  aoresult_t result= aospi_chain_set(AOMW_TOPO_LOC_CHAIN(aomw_topo_triplet_loc_[tix]));
+  if( result!=aoresult_ok ) return result;
+  // This is a bit of a shortcut. When the triplet is "on a channel" we
+  // equate that to needing a setpwmchn telegram. In a context of only
+  // two kinds of nodes known at the moment (SAID and RGBI) that is enough.
+  if( aomw_topo_triplet_onchan(tix) ) {
+    // Triplet to configure is an external one driven by a SAID. The PWM 
+    // register contains a 15-bit PWM value followed by a 1 bit LSB-dithering
+    // control. Use the 15-bits of "topo brightness range" and no dithering (<<1).
+    result= aoosp_send_setpwmchn_hdr(&aomw_topo_triplet_pwmhdr_[tix], r << 1, g << 1, b << 1 );
+  } else {
+    // Triplet to configure is an RGBI. The PWM register contains a 1-bit drive 
+    // current (0=10mA=nightmode, 1=50mA=daymode) followed by a 15-bit PWM value. 
+    // Use drive current nightmode and the 15-bits of "topo brightness range".
+    result= aoosp_send_setpwm_hdr( &aomw_topo_triplet_pwmhdr_[tix], r, g, b, 0b000 );
+  }
+  return result;
+}
+
+
 /*!
     @brief  Sets the color for triplet `tix` to `rgb`.
     @param  tix
@@ -727,34 +1595,198 @@ extern const aomw_topo_rgb_t aomw_topo_off    = { 0x0000,0x0000,0x0000, "off" };
             range" as PWM value. RGBIs will be driven at night mode (10mA), 
             and also use the 15 bit "topo brightness range" as PWM value.
     @note   The `rgb` color is dimmed down using the global dim value, 
-            set by `aomw_topo_dim_set()`.
+            set by `aomw_topo_dim_set()`, mapped with a curve (linear by
+            default, perceptual after aomw_topo_gamma_set(1)) and white 
+            balanced (aomw_topo_wb_set). This is one table lookup per 
+            component.
+    @note   Selects the chain of the triplet (see aomw_topo_triplet_chain()).
+    @note   Uses the telegram header prebuilt for the triplet during the
+            topo build (see aoosp_pwmhdr_setpwm), so only the payload is
+            encoded and only the payload is added to the CRC.
+    @note   In sync mode (see aomw_topo_sync_set) a SAID triplet also gets 
+            a SYNC telegram, except in a frame (aomw_topo_frame_begin), 
+            where the new color stays pending until aomw_topo_frame_commit().
 */
 aoresult_t aomw_topo_settriplet( uint16_t tix, const aomw_topo_rgb_t *rgb  ) {
-  // We dim brightness here to prevent under voltage
-  uint16_t r = (rgb->r)*aomw_topo_dim/1024; 
-  uint16_t g = (rgb->g)*aomw_topo_dim/1024; 
-  uint16_t b = (rgb->b)*aomw_topo_dim/1024; 
-  // Select osp node and channel 
-  uint16_t addr = aomw_topo_triplet_addr(tix);
-  aoresult_t result;
-  // This is a bit of a shortcut. When the triplet is "on a channel" we
-  // equate that to needing a setpwmchn telegram. In a context of only
-  // two kinds of nodes known at the moment (SAID and RGBI) that is enough.
-  if( aomw_topo_triplet_onchan(tix) ) {
-    // Triplet to configure is an external one driven by a SAID. The PWM 
-    // register contains a 15-bit PWM value followed by a 1 bit LSB-dithering
-    // control. Use the 15-bits of "topo brightness range" and no dithering (<<1).
-    result= aoosp_send_setpwmchn(addr, aomw_topo_triplet_chan(tix), r << 1, g << 1, b << 1 );
-  } else {
-    // Triplet to configure is an RGBI. The PWM register contains a 1-bit drive 
-    // current (0=10mA=nightmode, 1=50mA=daymode) followed by a 15-bit PWM value. 
-    // Use drive current nightmode and the 15-bits of "topo brightness range".
-    result= aoosp_send_setpwm( addr, r, g, b, 0b000 );
+  aoresult_t result= aomw_topo_settriplet_pwm(tix, rgb);
+  if( result!=aoresult_ok ) return result;
+  if( aomw_topo_sync_ && !aomw_topo_frame_ && aomw_topo_triplet_onchan(tix) ) result= aoosp_send_sync(aomw_topo_triplet_addr(tix));
+  return result;
+}
+
+
+/*!
+    @brief  Sets the color of `count` triplets, starting at triplet `tix`,
+            to the colors in `rgbs`.
+    @param  tix
+            The index of the first triplet.
+    @param  count
+            The number of triplets.
+    @param  rgbs
+            An array of `count` topo colors; triplet tix+i gets rgbs[i].
+    @return aoresult_ok          if successful
+            aoresult_outargnull  if rgbs is NULL
+            other error code     if there is a (communications) error
+    @note   Only available after aomw_topo_build() - or start/step.
+    @note   tix+count <= aomw_topo_numtriplets().
+    @note   Same as calling aomw_topo_settriplet() for each triplet, but the 
+            telegrams are posted (see aospi_post_begin): they are packed in 
+            batched frames and not waited for one by one. The telegrams for 
+            the different chains are posted alternately, so with several 
+            chains, all links are sending at the same time; refreshing all 
+            triplets of two equally long chains takes about half the time.
+    @note   The chain selected before the call is selected again after it.
+    @note   In sync mode (see aomw_topo_sync_set) one broadcast SYNC per 
+            chain follows the PWM telegrams, except in a frame (see
+            aomw_topo_frame_begin), where the telegrams are posted in the 
+            frame and the new colors stay pending until the commit.
+*/
+aoresult_t aomw_topo_settriplets( uint16_t tix, uint16_t count, const aomw_topo_rgb_t * rgbs ) {
+  if( rgbs==0 ) return aoresult_outargnull;
+  AORESULT_ASSERT( tix+count<=aomw_topo_numtriplets_ );
+  // The triplets of a chain are consecutive: determine per chain the part of tix..tix+count-1 it has
+  uint16_t next[AOMW_TOPO_MAXCHAINS];
+  uint16_t end[AOMW_TOPO_MAXCHAINS];
+  for( int chain=0; chain<aomw_topo_numchains_; chain++ ) {
+    uint16_t first= aomw_topo_chain_triplet1_[chain];
+    uint16_t last = chain+1<aomw_topo_numchains_ ? aomw_topo_chain_triplet1_[chain+1] : aomw_topo_numtriplets_;
+    next[chain]= tix>first ? tix : first;
+    end[chain] = tix+count<last ? tix+count : last;
+  }
+  // Post the telegrams, one triplet per chain in turn
+  int        selected= aospi_chain_get();
+  aoresult_t result= aoresult_ok;
+  int        more= 1;
+  if( !aomw_topo_frame_ ) aospi_post_begin(); // in a frame, posting ends with aomw_topo_frame_commit()
+  while( more && result==aoresult_ok ) {
+    more= 0;
+    for( int chain=0; chain<aomw_topo_numchains_ && result==aoresult_ok; chain++ ) {
+      if( next[chain]>=end[chain] ) continue;
+      result= aomw_topo_settriplet_pwm(next[chain], &rgbs[next[chain]-tix]);
+      next[chain]++;
+      more= 1;
+    }
+  }
+  if( aomw_topo_frame_ ) {
+    aospi_chain_set(selected);
+    return result;
   }
+  // In sync mode, activate the new settings on all chains
+  for( int chain=0; chain<aomw_topo_numchains_ && result==aoresult_ok && aomw_topo_sync_; chain++ ) {
+    result= aospi_chain_set(chain);
+    if( result==aoresult_ok ) result= aoosp_send_sync(AOOSP_ADDR_BROADCAST);
+  }
+  aoresult_t result2= aospi_post_end();
+  aospi_chain_set(selected);
+  return result!=aoresult_ok ? result : result2;
+}
+
+
+/*!
+    @brief  Switches sync mode on or off for all SAID channels driving a
+            triplet. In sync mode a new PWM setting of a channel is pending 
+            until the node receives a SYNC telegram.
+    @param  enable
+            1 to switch sync mode on, 0 to switch it off.
+    @return aoresult_ok      if successful
+            other error code if there is a (communications) error
+    @note   Only available after aomw_topo_build() - or start/step.
+    @note   Sets AOOSP_CURCHN_FLAGS_SYNCEN in the current register of the
+            SAID channels (see aomw_topo_node_setcurrents), with the other
+            flags as set by the topo build (AOOSP_CURCHN_FLAGS_DITHER).
+    @note   aomw_topo_settriplet() and aomw_topo_settriplets() send a SYNC
+            in sync mode, so they keep working as before (but tearing free
+            for the nodes in one settriplets call). Use a frame (see 
+            aomw_topo_frame_begin) to change many triplets at once.
+    @note   RGBIs have no sync mode; they show a new setting immediately.
+    @note   A topo build ends sync mode.
+    @note   The chain selected before the call is selected again after it.
+*/
+aoresult_t aomw_topo_sync_set( int enable ) {
+  int        selected= aospi_chain_get();
+  aoresult_t result= aoresult_ok;
+  aomw_topo_sync_= enable!=0;
+  for( uint16_t node=1; node<=aomw_topo_numnodes_ && result==aoresult_ok; node++ ) {
+    result= aomw_topo_node_setcurrents(node, AOOSP_CURCHN_FLAGS_DITHER);
+  }
+  aospi_chain_set(selected);
   return result;
 }
 
 
+/*!
+    @brief  Returns if sync mode is on, see aomw_topo_sync_set().
+    @return 1 if sync mode is on, 0 otherwise.
+*/
+int aomw_topo_sync_get() {
+  return aomw_topo_sync_;
+}
+
+
+/*!
+    @brief  Opens a frame: the triplet colors set until 
+            aomw_topo_frame_commit() appear at the same time.
+    @return aoresult_ok      if successful
+            aoresult_assert  if a frame is already open
+            other error code if there is a (communications) error
+    @note   Only available after aomw_topo_build() - or start/step.
+    @note   Switches on sync mode (aomw_topo_sync_set) when it is off. 
+    @note   In a frame aomw_topo_settriplet() and aomw_topo_settriplets()
+            post their telegrams (see aospi_post_begin) and send no SYNC;
+            a SAID triplet keeps its old color until the commit.
+    @note   RGBIs have no sync mode; they change as soon as their PWM 
+            telegram arrives. 
+    @note   Do not send telegrams with a response (eg aoosp_send_readstat)
+            in a frame; they flush the posted telegrams of their chain, but
+            do not affect the SAID triplets, which still wait for the SYNC.
+*/
+aoresult_t aomw_topo_frame_begin() {
+  if( aomw_topo_frame_ ) return aoresult_assert;
+  if( !aomw_topo_sync_ ) {
+    aoresult_t result= aomw_topo_sync_set(1);
+    if( result!=aoresult_ok ) return result;
+  }
+  aomw_topo_frame_chain_= aospi_chain_get();
+  aomw_topo_frame_= 1;
+  aospi_post_begin();
+  return aoresult_ok;
+}
+
+
+/*!
+    @brief  Closes the frame opened by aomw_topo_frame_begin(): sends the 
+            remaining posted PWM telegrams, followed by one broadcast SYNC 
+            per chain, so that all SAID triplets change at the same time.
+    @return aoresult_ok      if successful
+            aoresult_assert  if no frame is open
+            other error code if there is a (communications) error, eg of a
+                             telegram posted in the frame
+    @note   The SYNC goes last on each chain, so a node never shows a mix 
+            of the old and new frame; with several chains, the chains 
+            change a few telegram times apart.
+    @note   The chain selected at aomw_topo_frame_begin() is selected again.
+    @note   On an error all triplets in the framebuffer are marked dirty 
+            (see aomw_topo_fb_flush).
+*/
+aoresult_t aomw_topo_frame_commit() {
+  if( !aomw_topo_frame_ ) return aoresult_assert;
+  aoresult_t result= aoresult_ok;
+  for( int chain=0; chain<aomw_topo_numchains_ && result==aoresult_ok; chain++ ) {
+    result= aospi_chain_set(chain);
+    if( result==aoresult_ok ) result= aoosp_send_sync(AOOSP_ADDR_BROADCAST);
+  }
+  aoresult_t result2= aospi_post_end();
+  aomw_topo_frame_= 0;
+  aospi_chain_set(aomw_topo_frame_chain_);
+  // Telegrams of the frame may be lost; the framebuffer (and the planner) no longer know what the triplets show
+  if( result!=aoresult_ok || result2!=aoresult_ok ) {
+    aomw_topo_node_groups_lost_= 1;
+    aomw_topo_fb_invalidate();
+  }
+  return result!=aoresult_ok ? result : result2;
+}
+
+
 /*!
     @brief  Sets the global dim-level for aomw_topo_settriplet().
     @param  dim
@@ -763,13 +1795,17 @@ aoresult_t aomw_topo_settriplet( uint16_t tix, const aomw_topo_rgb_t *rgb  ) {
     @note   This function clips to 0..1024.
     @note   Changing the dim level has no effect on the current brightness 
             of the triplets in the chain. Only new aomw_topo_settriplet() 
-            calls are effected.
+            calls are effected, and the next aomw_topo_fb_flush(): the 
+            framebuffer is marked dirty, so the flush resends all triplets.
+    @note   Regenerates the lookup tables that map topo brightness to PWM.
     @note   See also aomw_topo_dim_get().
 */
 void aomw_topo_dim_set( int dim ) {
   if( dim<0    ) dim=0;
   if( dim>1024 ) dim=1024;
   aomw_topo_dim = dim;
+  aomw_topo_lut_make();
+  if( aomw_topo_fb_dirty_ ) aomw_topo_fb_invalidate(); // the framebuffer holds colors, the PWM values change
 }
 
 
@@ -782,6 +1818,569 @@ int aomw_topo_dim_get() {
 }
 
 
+/*!
+    @brief  Selects the curve that maps topo brightness to PWM in 
+            aomw_topo_settriplet(): perceptual or linear.
+    @param  enable
+            1 for the perceptual curve (CIE 1931 lightness), 0 for linear.
+    @note   Can be called even if topo has not been built.
+    @note   The linear curve is the default, so the PWM values are those
+            of the releases before the curve existed. Applications opt in
+            to the perceptual curve: it spends more PWM levels on the low 
+            brightness levels, so dim gradients look smooth. The maximum 
+            brightness (AOMW_TOPO_BRIGHTNESS_MAX) is the same for both 
+            curves.
+    @note   Like aomw_topo_dim_set(), only new aomw_topo_settriplet() calls 
+            (and the next flush) are effected, and the lookup tables are 
+            regenerated.
+*/
+void aomw_topo_gamma_set( int enable ) {
+  aomw_topo_gamma_= enable!=0;
+  aomw_topo_lut_make();
+  if( aomw_topo_fb_dirty_ ) aomw_topo_fb_invalidate();
+}
+
+
+/*!
+    @brief  Returns if the perceptual curve is used.
+    @note   See aomw_topo_gamma_set().
+*/
+int aomw_topo_gamma_get() {
+  return aomw_topo_gamma_;
+}
+
+
+/*!
+    @brief  Sets the white balance: a factor per channel, with which the 
+            (dimmed) PWM value of that channel is scaled in 
+            aomw_topo_settriplet().
+    @param  r
+            The factor for red; "pro-kibi": 0 to 1024.
+    @param  g
+            The factor for green; "pro-kibi": 0 to 1024.
+    @param  b
+            The factor for blue; "pro-kibi": 0 to 1024.
+    @note   Can be called even if topo has not been built.
+    @note   This function clips to 0..1024; the default is 1024 for all.
+    @note   Like aomw_topo_dim_set(), only new aomw_topo_settriplet() calls 
+            (and the next flush) are effected, and the lookup tables are 
+            regenerated.
+*/
+void aomw_topo_wb_set( int r, int g, int b ) {
+  int wb[3]= { r, g, b };
+  for( int chn=0; chn<3; chn++ ) {
+    if( wb[chn]<0    ) wb[chn]=0;
+    if( wb[chn]>1024 ) wb[chn]=1024;
+    aomw_topo_wb_[chn]= wb[chn];
+  }
+  aomw_topo_lut_make();
+  if( aomw_topo_fb_dirty_ ) aomw_topo_fb_invalidate();
+}
+
+
+/*!
+    @brief  Gets the white balance factors.
+    @param  r
+            Output parameter for the factor for red (may be 0).
+    @param  g
+            Output parameter for the factor for green (may be 0).
+    @param  b
+            Output parameter for the factor for blue (may be 0).
+    @note   See aomw_topo_wb_set().
+*/
+void aomw_topo_wb_get( int * r, int * g, int * b ) {
+  if( r ) *r= aomw_topo_wb_[0];
+  if( g ) *g= aomw_topo_wb_[1];
+  if( b ) *b= aomw_topo_wb_[2];
+}
+
+
+// === framebuffer ==========================================================
+
+
+// Renderers that compute all triplets every step send one telegram per 
+// triplet, even for triplets that did not change. The framebuffer keeps 
+// the color of every triplet in memory: aomw_topo_fb_set() only records the
+// color (and marks the triplet dirty when the color changed), and 
+// aomw_topo_fb_flush() sends the dirty triplets only. The PWM telegrams are
+// posted (as in aomw_topo_settriplets), and in sync mode the SAID channels
+// of all nodes share one broadcast SYNC per chain, instead of one SYNC per
+// channel; OSP has no telegram that sets the PWM of several SAID channels.
+// Dirty triplets sharing a color get a group telegram (see the multicast 
+// planner below).
+
+
+// Marks triplet `tix` in the framebuffer as dirty
+static void aomw_topo_fb_mark( uint16_t tix ) {
+  if( aomw_topo_fb_dirty_[tix/32] & (1UL<<(tix%32)) ) return;
+  aomw_topo_fb_dirty_[tix/32] |= 1UL<<(tix%32);
+  aomw_topo_fb_numdirty_++;
+}
+
+
+// Returns if triplet `tix` in the framebuffer is dirty
+static int aomw_topo_fb_isdirty( uint16_t tix ) {
+  return (aomw_topo_fb_dirty_[tix/32] & (1UL<<(tix%32))) != 0;
+}
+
+
+// Marks all triplets in the framebuffer clean (their telegrams are sent)
+static void aomw_topo_fb_clean() {
+  memset(aomw_topo_fb_dirty_, 0, (aomw_topo_numtriplets_+31)/32*sizeof(uint32_t));
+  aomw_topo_fb_numdirty_= 0;
+}
+
+
+/*!
+    @brief  Sets the color of triplet `tix` in the framebuffer to `rgb`; 
+            no telegram is sent (see aomw_topo_fb_flush).
+    @param  tix
+            The index of the triplet.
+    @param  rgb
+            A topo color, each component (red, green, blue) has a brightness 
+            level from 0 to AOMW_TOPO_BRIGHTNESS_MAX (0x7FFF).
+    @note   Only available after aomw_topo_build() - or start/step.
+    @note   tix is 0-based, so , 0 <= tix < aomw_topo_numtriplets().
+    @note   The triplet is marked dirty only when `rgb` differs from the 
+            color in the framebuffer.
+*/
+void aomw_topo_fb_set( uint16_t tix, const aomw_topo_rgb_t * rgb ) {
+  AORESULT_ASSERT( tix<aomw_topo_numtriplets_ );
+  uint16_t * fb= aomw_topo_fb_[tix];
+  if( fb[0]==rgb->r && fb[1]==rgb->g && fb[2]==rgb->b ) return;
+  fb[0]= rgb->r;
+  fb[1]= rgb->g;
+  fb[2]= rgb->b;
+  aomw_topo_fb_mark(tix);
+}
+
+
+/*!
+    @brief  Returns in `rgb` the color of triplet `tix` in the framebuffer.
+    @param  tix
+            The index of the triplet.
+    @param  rgb
+            Output parameter for the color (its name is set to 0).
+    @note   Only available after aomw_topo_build() - or start/step.
+    @note   tix is 0-based, so , 0 <= tix < aomw_topo_numtriplets().
+*/
+void aomw_topo_fb_get( uint16_t tix, aomw_topo_rgb_t * rgb ) {
+  AORESULT_ASSERT( tix<aomw_topo_numtriplets_ );
+  rgb->r= aomw_topo_fb_[tix][0];
+  rgb->g= aomw_topo_fb_[tix][1];
+  rgb->b= aomw_topo_fb_[tix][2];
+  rgb->name= 0;
+}
+
+
+/*!
+    @brief  Marks all triplets in the framebuffer dirty, so that the next 
+            aomw_topo_fb_flush() sends all of them.
+    @note   Use this when the triplets were set without the framebuffer
+            (eg with aomw_topo_settriplet). aomw_topo_dim_set() (and 
+            aomw_topo_gamma_set, aomw_topo_wb_set) call it, because the dim
+            level (curve, white balance) is applied by the flush.
+*/
+void aomw_topo_fb_invalidate() {
+  for( uint16_t tix=0; tix<aomw_topo_numtriplets_; tix++ ) aomw_topo_fb_mark(tix);
+}
+
+
+// === multicast planner ====================================================
+
+
+// Many frames have large regions with one color (flags, bars, "all off").
+// aomw_topo_fb_flush() uses the 15 OSP groups to send one telegram per 
+// region instead of one per triplet; aomw_topo_setframe() sets all triplets 
+// this way.
+//
+// Each node is member of at most one group (SETMULT), and a group only has 
+// nodes of one kind: RGBIs, or SAIDs with three triplets (other SAIDs are 
+// never grouped). For every group the planner determines per channel the 
+// color most dirty members want. A group telegram also overwrites the clean
+// members with another color, and those need a unicast to restore them, so
+// a group telegram is only sent when it serves at least two dirty members 
+// more than it overwrites clean ones (with all triplets dirty: at least two
+// members). The members not served get a unicast telegram after it.
+//
+// Membership is updated incrementally: the nodes with dirty triplets that are 
+// not served by a group are clustered on their color(s); a cluster of at 
+// least AOMW_TOPO_GROUP_MINSIZE nodes takes over a group that served nobody 
+// this flush (preferring the group with the fewest members to remove). Moving
+// a node costs one SETMULT, so a static picture reaches a steady state where 
+// each frame only costs a few group telegrams, plus unicasts for the 
+// triplets that stand out.
+//
+// The planner keeps its own copy of the group memberships; they are reset 
+// by the topo build (RESET clears SETMULT). Do not send SETMULT yourself. 
+// When a flush fails, a SETMULT may not have reached its node, so the copy
+// is no longer trusted: the next flush first removes all nodes from all 
+// groups, with one broadcast SETMULT per chain.
+
+
+#define AOMW_TOPO_NUMGROUPS       15 // OSP group addresses AOOSP_ADDR_GROUP0..AOOSP_ADDR_GROUP14
+#define AOMW_TOPO_GROUP_MINSIZE   4  // A cluster of nodes with equal colors gets a group from this size on
+#define AOMW_TOPO_GROUP_HASHSIZE  64 // Number of distinct node colors (per chain and flush) the planner can cluster
+#define AOMW_TOPO_KIND_NONE       0  // Node is not grouped (eg SAID with I2C bridge)
+#define AOMW_TOPO_KIND_RGBI       1  // Node is an RGBI (one triplet, SETPWM)
+#define AOMW_TOPO_KIND_SAID       3  // Node is a SAID with three triplets (SETPWMCHN)
+#define AOMW_TOPO_COVERED(chn)    (0x01<<(chn)) // aomw_topo_node_covered_: channel chn gets its color from a group telegram
+#define AOMW_TOPO_COVERED_ALL     0x07          // aomw_topo_node_covered_: mask of the AOMW_TOPO_COVERED bits
+#define AOMW_TOPO_OVERWRITTEN(chn) (0x10<<(chn)) // aomw_topo_node_covered_: channel chn gets a group telegram with another color
+
+
+static int      aomw_topo_setframe_groupcasts_;                // Telegrams to a group in the last aomw_topo_fb_flush()
+static int      aomw_topo_setframe_unicasts_;                  // PWM telegrams to a node in the last aomw_topo_fb_flush()
+static int      aomw_topo_setframe_setmults_;                  // SETMULT telegrams in the last aomw_topo_fb_flush()
+
+
+// The plan for one group, for one flush
+typedef struct aomw_topo_groupplan_s {
+  int      members;  // number of nodes in the group
+  int      kind;     // AOMW_TOPO_KIND_xxx of the members
+  uint16_t tix[3];   // per channel: the triplet (of a member) with the color to send to the group
+  uint8_t  send;     // channels (bit mask) that get a group telegram
+} aomw_topo_groupplan_t;
+
+
+// Returns the kind of node `node` for the planner (AOMW_TOPO_KIND_xxx).
+static int aomw_topo_node_kind( uint16_t node ) {
+  if( AOOSP_IDENTIFY_IS_RGBI(aomw_topo_node_id_[node]) ) return AOMW_TOPO_KIND_RGBI;
+  if( AOOSP_IDENTIFY_IS_SAID(aomw_topo_node_id_[node]) && aomw_topo_node_numtriplets(node)==3 ) return AOMW_TOPO_KIND_SAID;
+  return AOMW_TOPO_KIND_NONE;
+}
+
+
+// Returns 1 iff triplets `tix1` and `tix2` have the same color in the framebuffer.
+static int aomw_topo_rgb_equal( uint16_t tix1, uint16_t tix2 ) {
+  return aomw_topo_fb_[tix1][0]==aomw_topo_fb_[tix2][0] && aomw_topo_fb_[tix1][1]==aomw_topo_fb_[tix2][1] && aomw_topo_fb_[tix1][2]==aomw_topo_fb_[tix2][2];
+}
+
+
+// Returns 1 iff nodes `node1` and `node2` are of the same kind and have the same colors in the framebuffer.
+static int aomw_topo_node_equal( uint16_t node1, uint16_t node2 ) {
+  int kind= aomw_topo_node_kind(node1);
+  if( kind==AOMW_TOPO_KIND_NONE || kind!=aomw_topo_node_kind(node2) ) return 0;
+  for( int chn=0; chn<kind; chn++ ) {
+    if( !aomw_topo_rgb_equal(aomw_topo_node_triplet1_[node1]+chn, aomw_topo_node_triplet1_[node2]+chn) ) return 0;
+  }
+  return 1;
+}
+
+
+// Returns 1 iff node `node` can be grouped, has a dirty triplet, and is not served by a group telegram.
+static int aomw_topo_node_unserved( uint16_t node ) {
+  int kind= aomw_topo_node_kind(node);
+  if( kind==AOMW_TOPO_KIND_NONE || (aomw_topo_node_covered_[node] & AOMW_TOPO_COVERED_ALL) ) return 0;
+  for( int chn=0; chn<kind; chn++ ) {
+    if( aomw_topo_fb_isdirty(aomw_topo_node_triplet1_[node]+chn) ) return 1;
+  }
+  return 0;
+}
+
+
+// Sends a SETMULT to `node` (its chain is selected) to make it member of `groups` only.
+static aoresult_t aomw_topo_node_setgroups( uint16_t node, uint16_t groups ) {
+  if( aomw_topo_node_groups_[node]==groups ) return aoresult_ok;
+  aoresult_t result= aoosp_send_setmult(aomw_topo_node_addr(node), groups);
+  if( result!=aoresult_ok ) return result;
+  aomw_topo_node_groups_[node]= groups;
+  aomw_topo_setframe_setmults_++;
+  return aoresult_ok;
+}
+
+
+// Plans group `g` of `chain` (nodes node0+1..node0+last): per channel the color most dirty members want.
+static void aomw_topo_group_plan( uint16_t node0, uint16_t last, int g, aomw_topo_groupplan_t * plan ) {
+  plan->members= 0;
+  plan->kind= AOMW_TOPO_KIND_NONE;
+  plan->send= 0;
+  for( uint16_t node=node0+1; node<=node0+last; node++ ) {
+    if( !(aomw_topo_node_groups_[node] & (1<<g)) ) continue;
+    plan->members++;
+    plan->kind= aomw_topo_node_kind(node);
+  }
+  for( int chn=0; chn<plan->kind; chn++ ) {
+    // Majority vote (Boyer-Moore) of the dirty members for the color of channel chn
+    uint16_t cand= 0;
+    int      votes= 0;
+    int      dirty= 0;
+    for( uint16_t node=node0+1; node<=node0+last; node++ ) {
+      if( !(aomw_topo_node_groups_[node] & (1<<g)) ) continue;
+      uint16_t tix= aomw_topo_node_triplet1_[node]+chn;
+      if( !aomw_topo_fb_isdirty(tix) ) continue;
+      dirty= 1;
+      if( votes==0 ) { cand= tix; votes= 1; }
+      else if( aomw_topo_rgb_equal(tix,cand) ) votes++;
+      else votes--;
+    }
+    if( !dirty ) continue;
+    // A group telegram pays off when it serves at least two dirty members more than it overwrites clean ones
+    int gain= 0;
+    for( uint16_t node=node0+1; node<=node0+last; node++ ) {
+      if( !(aomw_topo_node_groups_[node] & (1<<g)) ) continue;
+      uint16_t tix= aomw_topo_node_triplet1_[node]+chn;
+      if( aomw_topo_rgb_equal(tix,cand) ) gain+= aomw_topo_fb_isdirty(tix);
+      else gain-= !aomw_topo_fb_isdirty(tix);
+    }
+    if( gain<2 ) continue;
+    plan->tix[chn]= cand;
+    plan->send|= 1<<chn;
+    for( uint16_t node=node0+1; node<=node0+last; node++ ) {
+      if( !(aomw_topo_node_groups_[node] & (1<<g)) ) continue;
+      if( aomw_topo_rgb_equal(aomw_topo_node_triplet1_[node]+chn,cand) ) aomw_topo_node_covered_[node] |= AOMW_TOPO_COVERED(chn);
+      else aomw_topo_node_covered_[node] |= AOMW_TOPO_OVERWRITTEN(chn);
+    }
+  }
+}
+
+
+// Moves the unserved nodes of `chain`, that form large clusters of equal colors, into its unused groups.
+static aoresult_t aomw_topo_group_assign( uint16_t node0, uint16_t last, aomw_topo_groupplan_t * plans ) {
+  // Cluster the unserved nodes on their colors (a seed node and a count per cluster)
+  uint16_t seed[AOMW_TOPO_GROUP_HASHSIZE];
+  int      count[AOMW_TOPO_GROUP_HASHSIZE];
+  for( int h=0; h<AOMW_TOPO_GROUP_HASHSIZE; h++ ) count[h]= 0;
+  for( uint16_t node=node0+1; node<=node0+last; node++ ) {
+    if( !aomw_topo_node_unserved(node) ) continue;
+    const uint16_t * fb= aomw_topo_fb_[aomw_topo_node_triplet1_[node]];
+    int h= (fb[0]*7 + fb[1]*3 + fb[2]) % AOMW_TOPO_GROUP_HASHSIZE;
+    for( int probe=0; probe<AOMW_TOPO_GROUP_HASHSIZE; probe++, h=(h+1)%AOMW_TOPO_GROUP_HASHSIZE ) {
+      if( count[h]==0 ) { seed[h]= node; count[h]= 1; break; }
+      if( aomw_topo_node_equal(seed[h],node) ) { count[h]++; break; }
+    }
+  }
+  // Give the largest clusters an unused group
+  while( 1 ) {
+    int best= -1;
+    for( int h=0; h<AOMW_TOPO_GROUP_HASHSIZE; h++ ) {
+      if( count[h]>=AOMW_TOPO_GROUP_MINSIZE && (best<0 || count[h]>count[best]) ) best= h;
+    }
+    if( best<0 ) return aoresult_ok;
+    int g= -1;
+    for( int i=0; i<AOMW_TOPO_NUMGROUPS; i++ ) {
+      if( plans[i].send==0 && (g<0 || plans[i].members<plans[g].members) ) g= i;
+    }
+    if( g<0 ) return aoresult_ok;
+    // Remove the old members of g, add the cluster (its nodes leave groups that overwrite them)
+    for( uint16_t node=node0+1; node<=node0+last; node++ ) {
+      aoresult_t result= aoresult_ok;
+      if( aomw_topo_node_unserved(node) && aomw_topo_node_equal(seed[best],node) ) {
+        result= aomw_topo_node_setgroups(node, 1<<g);
+        aomw_topo_node_covered_[node]= 0;
+      } else if( aomw_topo_node_groups_[node] & (1<<g) ) {
+        result= aomw_topo_node_setgroups(node, 0);
+      }
+      if( result!=aoresult_ok ) return result;
+    }
+    aomw_topo_group_plan(node0, last, g, &plans[g]);
+    count[best]= 0;
+  }
+}
+
+
+// Plans the groups of `chain` (selected) for the dirty triplets, and sends the group telegrams; see aomw_topo_fb_flush().
+static aoresult_t aomw_topo_group_send( int chain ) {
+  uint16_t              node0= aomw_topo_chain_node0_[chain];
+  uint16_t              last = aomw_topo_last_[chain];
+  aomw_topo_groupplan_t plans[AOMW_TOPO_NUMGROUPS];
+  aoresult_t            result;
+  // Plan the groups, then move unserved nodes to unused groups
+  for( int g=0; g<AOMW_TOPO_NUMGROUPS; g++ ) aomw_topo_group_plan(node0, last, g, &plans[g]);
+  result= aomw_topo_group_assign(node0, last, plans);
+  if( result!=aoresult_ok ) return result;
+  // Group telegrams first, so that unicasts can override them
+  for( int g=0; g<AOMW_TOPO_NUMGROUPS; g++ ) {
+    for( int chn=0; chn<plans[g].kind; chn++ ) {
+      if( !(plans[g].send & (1<<chn)) ) continue;
+      aomw_topo_rgb_t rgb;
+      uint16_t r, gr, b;
+      aomw_topo_fb_get(plans[g].tix[chn], &rgb);
+      aomw_topo_rgb_pwm(&rgb, &r, &gr, &b);
+      if( plans[g].kind==AOMW_TOPO_KIND_RGBI ) result= aoosp_send_setpwm( AOOSP_ADDR_GROUP(g), r, gr, b, 0b000 );
+      else result= aoosp_send_setpwmchn( AOOSP_ADDR_GROUP(g), chn, r << 1, gr << 1, b << 1 );
+      if( result!=aoresult_ok ) return result;
+      aomw_topo_setframe_groupcasts_++;
+    }
+  }
+  return aoresult_ok;
+}
+
+
+// Returns 1 iff triplet `tix` needs a telegram of its own: it is dirty or overwritten by a group telegram, and no group telegram has its color.
+static int aomw_topo_group_unicast( uint16_t tix ) {
+  uint16_t loc    = aomw_topo_triplet_loc_[tix];
+  uint16_t node   = aomw_topo_chain_node0_[AOMW_TOPO_LOC_CHAIN(loc)] + AOMW_TOPO_LOC_ADDR(loc);
+  int      chn    = tix - aomw_topo_node_triplet1_[node];
+  uint8_t  covered= aomw_topo_node_covered_[node];
+  if( covered & AOMW_TOPO_COVERED(chn) ) return 0;
+  return aomw_topo_fb_isdirty(tix) || (covered & AOMW_TOPO_OVERWRITTEN(chn));
+}
+
+
+// === framebuffer flush ====================================================
+
+
+/*!
+    @brief  Sends the colors of the dirty triplets in the framebuffer to 
+            the OSP chain(s), and marks them clean.
+    @param  saved
+            Output parameter (may be 0): the number of telegrams saved, 
+            compared to calling aomw_topo_settriplet() for all triplets.
+    @return aoresult_ok      if successful
+            other error code if there is a (communications) error
+    @note   Only available after aomw_topo_build() - or start/step.
+    @note   On a chain with two or more dirty triplets, the multicast 
+            planner (see above) first sends group telegrams for the dirty
+            triplets sharing a color (and SETMULTs when the groups change).
+    @note   The other telegrams are sent as by aomw_topo_settriplets(): 
+            posted, with the chains alternating, and (in sync mode) one 
+            broadcast SYNC per chain with a dirty SAID triplet. In a frame 
+            (see aomw_topo_frame_begin), the commit sends the SYNCs.
+    @note   The global dim level (aomw_topo_dim_set) is applied.
+    @note   The posted telegrams are only checked by aospi_post_end(), so
+            the triplets are marked clean when all telegrams are sent; on 
+            an error all triplets are marked dirty (a group telegram may 
+            have reached other nodes than planned), and the next flush 
+            sends them again. In a frame the commit does the check: a 
+            failing aomw_topo_frame_commit() marks all triplets dirty.
+    @note   The number of group, unicast and SETMULT telegrams are 
+            available via aomw_topo_setframe_stats().
+    @note   The chain selected before the call is selected again after it.
+*/
+aoresult_t aomw_topo_fb_flush( int * saved ) {
+  // Naive costs: one telegram per triplet, plus one SYNC per SAID triplet in sync mode (outside a frame)
+  int naive= aomw_topo_numtriplets_;
+  if( aomw_topo_sync_ && !aomw_topo_frame_ ) {
+    for( uint16_t tix=0; tix<aomw_topo_numtriplets_; tix++ ) naive+= aomw_topo_triplet_onchan(tix);
+  }
+  int syncs= 0;
+  aomw_topo_setframe_groupcasts_= 0;
+  aomw_topo_setframe_unicasts_= 0;
+  aomw_topo_setframe_setmults_= 0;
+  if( saved ) *saved= naive;
+  if( aomw_topo_fb_numdirty_==0 ) return aoresult_ok;
+
+  // The triplets of a chain are consecutive: determine per chain its range, dirty triplets, and if it needs a SYNC
+  uint16_t next[AOMW_TOPO_MAXCHAINS];
+  uint16_t end[AOMW_TOPO_MAXCHAINS];
+  int      dirty[AOMW_TOPO_MAXCHAINS];
+  int      sync[AOMW_TOPO_MAXCHAINS];
+  for( int chain=0; chain<aomw_topo_numchains_; chain++ ) {
+    next[chain]= aomw_topo_chain_triplet1_[chain];
+    end[chain] = chain+1<aomw_topo_numchains_ ? aomw_topo_chain_triplet1_[chain+1] : aomw_topo_numtriplets_;
+    dirty[chain]= 0;
+    sync[chain]= 0;
+    for( uint16_t tix=next[chain]; tix<end[chain]; tix++ ) {
+      if( !aomw_topo_fb_isdirty(tix) ) continue;
+      dirty[chain]++;
+      sync[chain] |= aomw_topo_triplet_onchan(tix);
+    }
+  }
+  int        selected= aospi_chain_get();
+  aoresult_t result= aoresult_ok;
+  if( !aomw_topo_frame_ ) aospi_post_begin(); // in a frame, posting ends with aomw_topo_frame_commit()
+  // After a failure the group memberships are unknown: remove all nodes from all groups
+  if( aomw_topo_node_groups_lost_ ) {
+    for( int chain=0; chain<aomw_topo_numchains_ && result==aoresult_ok; chain++ ) {
+      result= aospi_chain_set(chain);
+      if( result==aoresult_ok ) result= aoosp_send_setmult(AOOSP_ADDR_BROADCAST, 0);
+      aomw_topo_setframe_setmults_++;
+    }
+    memset(aomw_topo_node_groups_, 0, (aomw_topo_numnodes_+1)*sizeof(uint16_t));
+    aomw_topo_node_groups_lost_= 0;
+  }
+  // Group telegrams, on the chains where at least two dirty triplets could share one
+  memset(aomw_topo_node_covered_, 0, (aomw_topo_numnodes_+1)*sizeof(uint8_t));
+  for( int chain=0; chain<aomw_topo_numchains_ && result==aoresult_ok; chain++ ) {
+    if( dirty[chain]<2 ) continue;
+    result= aospi_chain_set(chain);
+    if( result==aoresult_ok ) result= aomw_topo_group_send(chain);
+  }
+  // Post the unicast telegrams, one triplet per chain in turn
+  int more= 1;
+  while( more && result==aoresult_ok ) {
+    more= 0;
+    for( int chain=0; chain<aomw_topo_numchains_ && result==aoresult_ok; chain++ ) {
+      while( next[chain]<end[chain] && !aomw_topo_group_unicast(next[chain]) ) next[chain]++;
+      if( next[chain]>=end[chain] ) continue;
+      uint16_t tix= next[chain]++;
+      aomw_topo_rgb_t rgb;
+      aomw_topo_fb_get(tix, &rgb);
+      result= aomw_topo_settriplet_pwm(tix, &rgb);
+      if( result!=aoresult_ok ) break;
+      aomw_topo_setframe_unicasts_++;
+      more= 1;
+    }
+  }
+  // In sync mode, activate the new settings on the chains with changed SAID triplets
+  for( int chain=0; chain<aomw_topo_numchains_ && result==aoresult_ok && aomw_topo_sync_ && !aomw_topo_frame_; chain++ ) {
+    if( !sync[chain] ) continue;
+    result= aospi_chain_set(chain);
+    if( result==aoresult_ok ) result= aoosp_send_sync(AOOSP_ADDR_BROADCAST);
+    syncs++;
+  }
+  aoresult_t result2= aomw_topo_frame_ ? aoresult_ok : aospi_post_end();
+  aospi_chain_set(selected);
+  if( saved ) *saved= naive - aomw_topo_setframe_groupcasts_ - aomw_topo_setframe_unicasts_ - aomw_topo_setframe_setmults_ - syncs;
+  if( result!=aoresult_ok || result2!=aoresult_ok ) {
+    aomw_topo_node_groups_lost_= 1;
+    aomw_topo_fb_invalidate();
+    return result!=aoresult_ok ? result : result2;
+  }
+  aomw_topo_fb_clean();
+  return aoresult_ok;
+}
+
+
+/*!
+    @brief  Sets the color of all triplets, like aomw_topo_settriplets(0,
+            aomw_topo_numtriplets(),rgbs), but using OSP groups (multicast)
+            for triplets that share a color.
+    @param  rgbs
+            An array of aomw_topo_numtriplets() topo colors; triplet tix 
+            gets rgbs[tix].
+    @return aoresult_ok          if successful
+            aoresult_outargnull  if rgbs is NULL
+            other error code     if there is a (communications) error
+    @note   Only available after aomw_topo_build() - or start/step.
+    @note   The colors are stored in the framebuffer (aomw_topo_fb_set), 
+            all triplets are marked dirty, and the framebuffer is flushed;
+            see aomw_topo_fb_flush() for the telegrams. When the groups do 
+            not pay off, a frame costs the same telegrams as 
+            aomw_topo_settriplets(), plus the planning.
+    @note   The number of telegrams of the last call are available via
+            aomw_topo_setframe_stats().
+    @note   The chain selected before the call is selected again after it.
+*/
+aoresult_t aomw_topo_setframe( const aomw_topo_rgb_t * rgbs ) {
+  if( rgbs==0 ) return aoresult_outargnull;
+  for( uint16_t tix=0; tix<aomw_topo_numtriplets_; tix++ ) aomw_topo_fb_set(tix, &rgbs[tix]);
+  aomw_topo_fb_invalidate();
+  return aomw_topo_fb_flush(0);
+}
+
+
+/*!
+    @brief  Returns the number of telegrams sent by the last 
+            aomw_topo_fb_flush() (or aomw_topo_setframe).
+    @param  groupcasts
+            Output parameter returning the number of PWM telegrams to a group.
+    @param  unicasts
+            Output parameter returning the number of PWM telegrams to a node.
+    @param  setmults
+            Output parameter returning the number of SETMULT telegrams 
+            (group membership changes).
+    @note   Any output parameter may be NULL.
+    @note   SYNC telegrams (sync mode) are not counted.
+*/
+void aomw_topo_setframe_stats( int * groupcasts, int * unicasts, int * setmults ) {
+  if( groupcasts ) *groupcasts= aomw_topo_setframe_groupcasts_;
+  if( unicasts   ) *unicasts  = aomw_topo_setframe_unicasts_;
+  if( setmults   ) *setmults  = aomw_topo_setframe_setmults_;
+}
+
+
 // == I2C helpers ===========================================================
 
 
@@ -792,23 +2391,44 @@ int aomw_topo_dim_get() {
     @param  daddr7
             The 7bits I2C device address to be searched for.
     @param  addr
-            Out parameter for the OSP address of the SAID with the I2C device.
+            Out parameter for the OSP address of the SAID with the I2C device
+            (in its chain, which is left selected).
     @return aoresult_ok           if I2C device found (addr is defined)
             aoresult_dev_noi2cdev if I2C device is not found (addr undefined)
             other error code      if there is a (communications) error
     @note   Only available after aomw_topo_build() - or start/step.
-    @note   The search is from upstream (low addr) to downstream (high addr).
+    @note   The search is from upstream (low addr) to downstream (high addr),
+            and from chain 0 to the last chain.
+    @note   Leaves the chain of the found SAID selected (aospi_chain_set),
+            so that subsequent aoosp calls with `addr` reach it.
+    @note   The bridges of one chain are probed as a batch (up to 
+            AOMW_TOPO_I2CFIND_BATCH at a time), with aoosp_exec_i2cread8_many(),
+            so their I2C transactions overlap.
 */
 aoresult_t aomw_topo_i2cfind( int daddr7, uint16_t * addr ) {
-  *addr= 0xFFFF;
   if( addr==0 ) return aoresult_outargnull;
-  for( uint16_t iix=0; iix<aomw_topo_numi2cbridges_; iix++ ) {
-    uint16_t ad= aomw_topo_i2cbridge_addr_[iix];
-    uint8_t buf[8];
-    aoresult_t result = aoosp_exec_i2cread8(ad, daddr7, 0x00, buf, 1);
-    int i2cfail=  result==aoresult_dev_i2cnack || result==aoresult_dev_i2ctimeout;
-    if( result!=aoresult_ok && !i2cfail ) return result;
-    if( !i2cfail ) { *addr=ad; return aoresult_ok; }
+  *addr= 0xFFFF;
+  aoosp_exec_i2cjob_t jobs[AOMW_TOPO_I2CFIND_BATCH];
+  uint8_t bufs[AOMW_TOPO_I2CFIND_BATCH];
+  uint16_t iix=0;
+  while( iix<aomw_topo_numi2cbridges_ ) {
+    // Collect a batch of bridges on the same chain (bridges are stored in chain order)
+    uint8_t chain= aomw_topo_i2cbridge_chain(iix);
+    int n=0;
+    while( iix+n<aomw_topo_numi2cbridges_ && n<AOMW_TOPO_I2CFIND_BATCH && aomw_topo_i2cbridge_chain(iix+n)==chain ) {
+      jobs[n]= (aoosp_exec_i2cjob_t){ .addr=aomw_topo_i2cbridge_addr(iix+n), .daddr7=daddr7, .raddr=0x00, .count=1, .buf=&bufs[n] };
+      n++;
+    }
+    aoresult_t result = aospi_chain_set(chain);
+    if( result!=aoresult_ok ) return result;
+    aoosp_exec_i2cread8_many(jobs, n);
+    // First bridge (in order) that has the device wins
+    for( int i=0; i<n; i++ ) {
+      int i2cfail=  jobs[i].result==aoresult_dev_i2cnack || jobs[i].result==aoresult_dev_i2ctimeout;
+      if( jobs[i].result!=aoresult_ok && !i2cfail ) return jobs[i].result;
+      if( !i2cfail ) { *addr=jobs[i].addr; return aoresult_ok; }
+    }
+    iix+= n;
   }
   return aoresult_dev_noi2cdev;
 }
@@ -827,6 +2447,49 @@ static void aomw_topo_dim_show(  ) {
 }
 
 
+// Builds the topology map, reporting the number of telegrams and time per node
+static void aomw_topo_bench() {
+  #if AOSPI_SIM_ENABLED
+  int        sim= aospi_backend_get()==&aospi_backend_sim;
+  uint64_t   simus= sim ? aospi_sim_time_us() : 0;
+  #endif
+  aospi_txcount_reset();
+  TickType_t t0= xTaskGetTickCount();
+  aoresult_t result= aomw_topo_build();
+  uint32_t   ms= pdTICKS_TO_MS(xTaskGetTickCount()-t0);
+  int        tx= aospi_txcount_get();
+  if( result!=aoresult_ok ) { PRINTF("ERROR: 'bench' failed (%s)\n",aoresult_to_str(result,1) ); return; }
+  int        nodes= aomw_topo_numnodes_>0 ? aomw_topo_numnodes_ : 1;
+  PRINTF("bench: %d nodes, %d telegrams (%d.%02d per node), %lu ms (%lu us per node)\n", aomw_topo_numnodes_, 
+    tx, tx/nodes, tx*100/nodes%100, (unsigned long)ms, (unsigned long)ms*1000/nodes );
+  #if AOSPI_SIM_ENABLED
+  if( sim ) {
+    simus= aospi_sim_time_us()-simus;
+    PRINTF("bench: sim link time %lu ms (%lu us per node)\n", (unsigned long)(simus/1000), (unsigned long)(simus/nodes) );
+  }
+  #endif
+}
+
+
+// Shows the state of the topology cache
+static void aomw_topo_cache_show() {
+  if( aomw_topo_store_==0 ) { PRINTF("cache: off\n"); return; }
+  aomw_topo_cache_check();
+  PRINTF("cache: store %s, ", aomw_topo_store_->name);
+  if( aomw_topo_cache_numchains_==0 ) PRINTF("empty");
+  else PRINTF("%d chains %lu nodes (%lu bytes)", aomw_topo_cache_numchains_, (unsigned long)aomw_topo_cache_numnodes_, (unsigned long)AOMW_TOPO_CACHE_SIZE(aomw_topo_cache_numchains_,aomw_topo_cache_numnodes_) );
+  PRINTF(", last build restored %d of %d chains\n", aomw_topo_cache_hits_, aomw_topo_numchains_);
+}
+
+
+// Show the curve and white balance
+static void aomw_topo_wb_show(  ) {
+  int r, g, b;
+  aomw_topo_wb_get(&r, &g, &b);
+  PRINTF("gamma %s, wb %d %d %d (/1024)\n", aomw_topo_gamma_get() ? "on" : "off", r, g, b );
+}
+
+
 // The handler for the "topo" command
 static void aomw_topo_cmd( int argc, char * argv[] ) {
   if( argc>1 && aocmd_cint_isprefix("build",argv[1]) ) {
@@ -837,6 +2500,29 @@ static void aomw_topo_cmd( int argc, char * argv[] ) {
     return;
   }
 
+  if( argc>1 && aocmd_cint_isprefix("bench",argv[1]) ) {
+    if( argc!=2 ) { PRINTF("ERROR: 'bench' has too many args\n" ); return; }
+    aomw_topo_bench();
+    return;
+  }
+
+  if( argc>1 && aocmd_cint_isprefix("cache",argv[1]) ) {
+    if( argc==2 ) { aomw_topo_cache_show(); return; }
+    if( argc!=3 ) { PRINTF("ERROR: 'cache' has too many args\n" ); return; }
+    if( aocmd_cint_isprefix("clear",argv[2]) ) {
+      aoresult_t result= aomw_topo_cache_clear();
+      if( result!=aoresult_ok ) { PRINTF("ERROR: 'cache clear' failed (%s)\n",aoresult_to_str(result,1) ); return; }
+    } else if( aocmd_cint_isprefix("off",argv[2]) ) {
+      aomw_topo_store_set(0);
+    } else if( aocmd_cint_isprefix("ram",argv[2]) ) {
+      aomw_topo_store_set(&aomw_topo_store_ram);
+    } else { 
+      PRINTF("ERROR: 'cache' expects 'clear', 'off' or 'ram', not '%s'\n",argv[2] ); return; 
+    }
+    if( argv[0][0]!='@' ) aomw_topo_cache_show();
+    return;
+  }
+
   if( aomw_topo_numnodes()==0 ) PRINTF("WARNING: 'topo build' must be run first\n"); 
   
   if( argc==1 ) {
@@ -860,6 +2546,62 @@ static void aomw_topo_cmd( int argc, char * argv[] ) {
     aomw_topo_dim_set(level);
     if( argv[0][0]!='@' ) aomw_topo_dim_show();
     return;
+  } else if( aocmd_cint_isprefix("gamma",argv[1]) ) {
+    if( argc==2 ) { aomw_topo_wb_show(); return; }
+    if( argc!=3 ) { PRINTF("ERROR: 'gamma' expects [ on | off ]\n" ); return; }
+    if( aocmd_cint_isprefix("on",argv[2]) ) aomw_topo_gamma_set(1);
+    else if( aocmd_cint_isprefix("off",argv[2]) ) aomw_topo_gamma_set(0);
+    else { PRINTF("ERROR: 'gamma' expects 'on' or 'off', not '%s'\n",argv[2] ); return; }
+    if( argv[0][0]!='@' ) aomw_topo_wb_show();
+    return;
+  } else if( aocmd_cint_isprefix("wb",argv[1]) ) {
+    if( argc==2 ) { aomw_topo_wb_show(); return; }
+    if( argc!=5 ) { PRINTF("ERROR: 'wb' expects <red> <green> <blue>\n" ); return; }
+    int wb[3];
+    for( int chn=0; chn<3; chn++ ) {
+      bool ok= aocmd_cint_parse_dec(argv[2+chn],&wb[chn]) ;
+      if( !ok || wb[chn]<0 || wb[chn]>1024 ) { PRINTF("ERROR: 'wb' expects factors 0..1024, not '%s'\n",argv[2+chn] ); return; }
+    }
+    aomw_topo_wb_set(wb[0], wb[1], wb[2]);
+    if( argv[0][0]!='@' ) aomw_topo_wb_show();
+    return;
+  } else if( aocmd_cint_isprefix("sync",argv[1]) ) {
+    if( argc==2 ) { PRINTF("sync %s\n", aomw_topo_sync_get() ? "on" : "off" ); return; }
+    if( argc!=3 ) { PRINTF("ERROR: 'sync' expects [ on | off ]\n" ); return; }
+    int enable;
+    if( aocmd_cint_isprefix("on",argv[2]) ) enable=1;
+    else if( aocmd_cint_isprefix("off",argv[2]) ) enable=0;
+    else { PRINTF("ERROR: 'sync' expects 'on' or 'off', not '%s'\n",argv[2] ); return; }
+    aoresult_t result= aomw_topo_sync_set(enable);
+    if( result!=aoresult_ok ) { PRINTF("ERROR: 'sync' failed (%s)\n",aoresult_to_str(result,1) ); return; }
+    if( argv[0][0]!='@' ) PRINTF("sync %s\n", aomw_topo_sync_get() ? "on" : "off" );
+    return;
+  } else if( aocmd_cint_isprefix("fb",argv[1]) ) {
+    if( aomw_topo_numtriplets()==0 ) PRINTF("WARNING: forgot 'topo build'?\n" );
+    if( argc==2 ) {
+      int saved, groupcasts, unicasts, setmults;
+      aoresult_t result= aomw_topo_fb_flush(&saved);
+      if( result!=aoresult_ok ) { PRINTF("ERROR: 'fb' failed (%s)\n",aoresult_to_str(result,1) ); return; }
+      aomw_topo_setframe_stats(&groupcasts, &unicasts, &setmults);
+      if( argv[0][0]!='@' ) PRINTF("fb: %d group, %d unicast, %d setmult telegrams (%d saved)\n", groupcasts, unicasts, setmults, saved );
+      return;
+    }
+    if( argc!=7 ) { PRINTF("ERROR: 'fb' expects [ <tix1> <tix2> <red> <green> <blue> ]\n" ); return; }
+    int tix1, tix2;
+    bool ok= aocmd_cint_parse_dec(argv[2],&tix1) ;
+    if( !ok || tix1<0 || tix1>=aomw_topo_numtriplets() ) { PRINTF("ERROR: 'fb' expects <tix1> 0..%d, not '%s'\n", aomw_topo_numtriplets()-1, argv[2] ); return; }
+    ok= aocmd_cint_parse_dec(argv[3],&tix2) ;
+    if( !ok || tix2<tix1 || tix2>=aomw_topo_numtriplets() ) { PRINTF("ERROR: 'fb' expects <tix2> %d..%d, not '%s'\n", tix1, aomw_topo_numtriplets()-1, argv[3] ); return; }
+    aomw_topo_rgb_t rgb;
+    ok= aocmd_cint_parse_hex(argv[4],&rgb.r) ;
+    if( !ok || rgb.r > AOMW_TOPO_BRIGHTNESS_MAX ) { PRINTF("ERROR: 'fb' expects <red> 0..%04X, not '%s'\n", AOMW_TOPO_BRIGHTNESS_MAX, argv[4] ); return; }
+    ok= aocmd_cint_parse_hex(argv[5],&rgb.g) ;
+    if( !ok || rgb.g > AOMW_TOPO_BRIGHTNESS_MAX ) { PRINTF("ERROR: 'fb' expects <green> 0..%04X, not '%s'\n", AOMW_TOPO_BRIGHTNESS_MAX, argv[5] ); return; }
+    ok= aocmd_cint_parse_hex(argv[6],&rgb.b) ;
+    if( !ok || rgb.b > AOMW_TOPO_BRIGHTNESS_MAX ) { PRINTF("ERROR: 'fb' expects <blue> 0..%04X, not '%s'\n", AOMW_TOPO_BRIGHTNESS_MAX, argv[6] ); return; }
+    for( int tix=tix1; tix<=tix2; tix++ ) aomw_topo_fb_set(tix,&rgb);
+    if( argv[0][0]!='@' ) PRINTF("fb T%d..T%d: %04X %04X %04X\n",tix1,tix2,rgb.r, rgb.g, rgb.b);
+    return;
   } else if( aocmd_cint_isprefix("pwm",argv[1]) ) {
     if( argc<3 ) { PRINTF("ERROR: 'pwm' expects <tix>\n" ); return; }
     if( aomw_topo_numtriplets()==0 ) PRINTF("WARNING: forgot 'topo build'?\n" );
@@ -889,13 +2631,41 @@ static void aomw_topo_cmd( int argc, char * argv[] ) {
 static const char aomw_topo_cmd_longhelp[] = 
   "SYNTAX: topo build\n"
   "- this resets, inits and scans all nodes on the chain creating the map\n"
+  "- with several chains (eg CAN3 and CAN2) all are scanned, nodes and\n"
+  "  triplets are numbered across the chains\n"
+  "SYNTAX: topo cache [ clear | off | ram ]\n"
+  "- without argument, shows the topology cache; a build restores chains\n"
+  "  that match the cache, instead of scanning them\n"
+  "- 'clear' makes the next build scan, 'off' disables the cache, 'ram'\n"
+  "  keeps it in RAM (survives a warm reset)\n"
+  "SYNTAX: topo bench\n"
+  "- does a 'topo build' and reports telegrams and time per node\n"
+  "- with the sim backend (AOSPI_SIM_ENABLED builds) also the modelled link time\n"
   "SYNTAX: topo [enum]\n"
   "- without argument, enumerates nodes (the topology map)\n"
   "- with argument, also enumerates triplets and i2c bridges\n"
+  "- ends with the summary, including the memory the map uses\n"
   "SYNTAX: topo dim [ <level> ]\n"
   "- without argument, shows current global dim level\n"
   "- with argument sets global dim level (0..1024)\n"
   "- only affects newly controlled triplets\n"
+  "SYNTAX: topo gamma [ on | off ]\n"
+  "- without argument, shows the curve and white balance\n"
+  "- with argument selects the perceptual (on) or linear (off) curve from\n"
+  "  topo brightness to pwm; only affects newly controlled triplets\n"
+  "SYNTAX: topo wb [ <red> <green> <blue> ]\n"
+  "- without argument, shows the curve and white balance\n"
+  "- with arguments sets the white balance factors (0..1024, decimal)\n"
+  "- only affects newly controlled triplets\n"
+  "SYNTAX: topo sync [ on | off ]\n"
+  "- without argument, shows if sync mode is on\n"
+  "- with argument switches sync mode: SAID channels show new pwm settings\n"
+  "  only on a SYNC telegram (sent by 'topo pwm' and by frames)\n"
+  "SYNTAX: topo fb [ <tix1> <tix2> <red> <green> <blue> ]\n"
+  "- with arguments sets triplets <tix1>..<tix2> (decimal) in the framebuffer,\n"
+  "  no telegrams are sent; <red> <green> <blue> as for 'topo pwm'\n"
+  "- without arguments flushes the framebuffer (the changed triplets, with\n"
+  "  group telegrams for triplets sharing a color) and shows the telegrams\n"
   "SYNTAX: topo pwm <tix>  <red> <green> <blue>\n"
   "- sets the pwm settings of RGB triplet <tix> (decimal)\n"
   "- <red> <green> <blue> are each 15 bits hex (0000..7FFF)\n"
@@ -33,12 +33,22 @@
 #include <aoresult.h>   // aoresult_t
 
 
-// Returns if the current OSP chain has direction Loop (or BiDir).
+// Returns the number of scanned OSP chains (see aospi_chain_set); nodes, triplets and I2C bridges are numbered across the chains.
+int aomw_topo_numchains();
+// Returns if OSP chain `chain` has direction Loop (or BiDir); 0<=chain<aomw_topo_numchains().
+int aomw_topo_chain_loop( int chain );
+// Returns if the current OSP chain has direction Loop (or BiDir); with several chains, that of chain 0.
 int aomw_topo_loop();
-// Returns the number of nodes in the scanned chain.
+// Returns the number of nodes in the scanned chain (all chains).
 uint16_t aomw_topo_numnodes();
+// Returns the chain of node `node`; 1<=node<=aomw_topo_numnodes().
+int aomw_topo_node_chain( uint16_t node );
+// Returns the OSP address of node `node` in its chain (equals `node` for a single chain); 1<=node<=aomw_topo_numnodes().
+uint16_t aomw_topo_node_addr( uint16_t node );
 // Returns the identity of OSP node `addr`; 1<=addr<=aomw_topo_numnodes().
 uint32_t aomw_topo_node_id( uint16_t addr );
+// Returns the round trip time (us) of the IDENTIFY telegram to OSP node `addr` during the scan (interpolated between first and last node); 1<=addr<=aomw_topo_numnodes().
+uint16_t aomw_topo_node_us( uint16_t addr );
 // Returns the number of triplets (RGB modules) of OSP node `addr`; 1<=addr<= aomw_topo_numnodes().
 uint8_t aomw_topo_node_numtriplets( uint16_t addr );
 // Returns the index of the first triplet (RGB module) driven by OSP node `addr`; 1<=addr<=aomw_topo_numnodes().
@@ -47,6 +57,8 @@ uint16_t aomw_topo_node_triplet1( uint16_t addr );
 uint16_t aomw_topo_numtriplets();
 // Returns the address of the OSP node that drives triplet `tix`; 0<=tix<aomw_topo_numtriplets().
 uint16_t aomw_topo_triplet_addr( uint16_t tix );
+// Returns the chain of the OSP node that drives triplet `tix`; 0<=tix<aomw_topo_numtriplets().
+int aomw_topo_triplet_chain( uint16_t tix );
 // Returns 1 if triplet `tix` is driven by an OSP node with channels; 0<=tix<aomw_topo_numtriplets().
 int aomw_topo_triplet_onchan( uint16_t tix );
 // Returns the channel triplet `tix` is attached to in case the triplet is driven by an OSP node with channels, 0<=tix<aomw_topo_numtriplets(). Only defined when aomw_topo_triplet_onchan(tix).
@@ -55,6 +67,8 @@ uint8_t aomw_topo_triplet_chan( uint16_t tix );
 uint16_t aomw_topo_numi2cbridges();
 // Returns the address of the OSP node that has I2C bridge `bix`; 0<=bix<aomw_topo_numi2cbridges().
 uint16_t aomw_topo_i2cbridge_addr( uint16_t bix );
+// Returns the chain of the OSP node that has I2C bridge `bix`; 0<=bix<aomw_topo_numi2cbridges().
+int aomw_topo_i2cbridge_chain( uint16_t bix );
 
 
 // Prints on Serial a summary of the "topology map".
@@ -79,6 +93,25 @@ aoresult_t aomw_topo_build_step();
 int aomw_topo_build_done();
 
 
+// A store for the topology cache (a build restores unchanged chains from the cache, instead of scanning them).
+typedef struct aomw_topo_store_s {
+  const char * name;                                                       // Short name of the store (for printing)
+  aoresult_t (*read)( uint32_t offset, void * buf, uint32_t size );        // Reads `size` bytes at `offset` from the store into `buf`
+  aoresult_t (*erase)( uint32_t size );                                    // Erases the first `size` bytes of the store (before writing them)
+  aoresult_t (*write)( uint32_t offset, const void * buf, uint32_t size ); // Writes `size` bytes from `buf` at `offset` in the (erased) store
+} aomw_topo_store_t;
+// Store in RAM that survives a warm reset (default store of the topology cache)
+extern const aomw_topo_store_t aomw_topo_store_ram;
+// Sets the store of the topology cache (eg one in flash), or 0 to disable the cache.
+void aomw_topo_store_set( const aomw_topo_store_t * store );
+// Returns the store of the topology cache (0 when disabled).
+const aomw_topo_store_t * aomw_topo_store_get();
+// Invalidates the topology cache, so that the next build scans all chains.
+aoresult_t aomw_topo_cache_clear();
+// Returns the number of chains the last build restored from the topology cache.
+int aomw_topo_cache_hits();
+
+
 // The topo module uses colors of type aomw_topo_rgb_t, their value should 
 // be 0..AOMW_TOPO_BRIGHTNESS_MAX. This is the "topo brightness range"; 
 // the actual pwm setting depends on the physical device and their current 
@@ -97,8 +130,30 @@ extern const aomw_topo_rgb_t aomw_topo_white;
 extern const aomw_topo_rgb_t aomw_topo_off;
 // Sets the color for triplet `tix` to `rgb` - this hides RGBI vs SAID qua current and triplet count
 aoresult_t aomw_topo_settriplet( uint16_t tix, const aomw_topo_rgb_t*rgb ); 
+// Sets the colors for triplets `tix`..`tix+count-1` to `rgbs[0..count-1]` - telegrams to different chains go out in parallel
+aoresult_t aomw_topo_settriplets( uint16_t tix, uint16_t count, const aomw_topo_rgb_t * rgbs );
 // Sets the flags for node addr (if it is a SAID; r/g/b current settings as per topo standard)
 aoresult_t aomw_topo_node_setcurrents(uint16_t addr, uint8_t flags);
+// Switches sync mode on/off: SAID channels then show a new PWM setting only after a SYNC telegram
+aoresult_t aomw_topo_sync_set( int enable );
+// Returns if sync mode is on (see aomw_topo_sync_set)
+int aomw_topo_sync_get();
+// Opens a frame: until aomw_topo_frame_commit(), aomw_topo_settriplet(s) updates stay pending (SAID triplets)
+aoresult_t aomw_topo_frame_begin();
+// Closes the frame: sends the posted PWM telegrams and one broadcast SYNC per chain, so all SAID triplets change at once
+aoresult_t aomw_topo_frame_commit();
+// Sets the colors of all triplets to `rgbs[0..aomw_topo_numtriplets()-1]`, using group telegrams for nodes sharing a color
+aoresult_t aomw_topo_setframe( const aomw_topo_rgb_t * rgbs );
+// Returns the number of group, unicast and SETMULT telegrams of the last aomw_topo_fb_flush() or aomw_topo_setframe()
+void aomw_topo_setframe_stats( int * groupcasts, int * unicasts, int * setmults );
+// Sets the color of triplet `tix` in the framebuffer (no telegram; the triplet is marked dirty if the color changed)
+void aomw_topo_fb_set( uint16_t tix, const aomw_topo_rgb_t * rgb );
+// Gets the color of triplet `tix` from the framebuffer
+void aomw_topo_fb_get( uint16_t tix, aomw_topo_rgb_t * rgb );
+// Marks all triplets in the framebuffer dirty (eg after aomw_topo_settriplet or aomw_topo_dim_set)
+void aomw_topo_fb_invalidate();
+// Sends the dirty triplets of the framebuffer; `saved` (may be 0) gets the telegrams saved compared to setting all triplets
+aoresult_t aomw_topo_fb_flush( int * saved );
 
 
 // Default dim level in "prokibi": 100 is at 100/1024 or ~10% of max PWM. 
@@ -109,6 +164,14 @@ aoresult_t aomw_topo_node_setcurrents(uint16_t addr, uint8_t flags);
 void aomw_topo_dim_set( int dim );
 // Gets the global dim-level
 int aomw_topo_dim_get();
+// Selects the curve from topo brightness to PWM for aomw_topo_settriplet: perceptual (1) or linear (0, default)
+void aomw_topo_gamma_set( int enable );
+// Returns if the perceptual curve is selected
+int aomw_topo_gamma_get();
+// Sets the white balance factors (each 0..1024, default 1024) for aomw_topo_settriplet. Function clips to 0..1024.
+void aomw_topo_wb_set( int r, int g, int b );
+// Gets the white balance factors (output parameters may be 0)
+void aomw_topo_wb_get( int * r, int * g, int * b );
 
 
 // Searches the entire OSP chain for SAIDs with an I2C bridge, and on the associated I2C bus searches for an I2C device with address `daddr7`.
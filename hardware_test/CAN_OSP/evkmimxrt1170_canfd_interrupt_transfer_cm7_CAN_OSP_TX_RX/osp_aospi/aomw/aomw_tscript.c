@@ -19,7 +19,7 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
  *****************************************************************************/
 
-#include <aomw_topo.h>     // aomw_topo_settriplet
+#include <aomw_topo.h>     // aomw_topo_fb_set()
 #include <aomw_tscript.h>  // own
 
 
@@ -230,6 +230,14 @@ void aomw_tscript_install(const uint16_t *insts, uint16_t numtriplets) {
 // === play ==================================================================
 
 
+// Sets the triplets of the instruction under the cursor in the topo framebuffer
+static void aomw_tscript_paintinst() {
+  for( uint16_t tix=aomw_tscript_inst.tix0; tix<aomw_tscript_inst.tix1; tix++ ) {
+    aomw_topo_fb_set(tix, &aomw_tscript_inst.rgb );
+  }
+}
+
+
 /*!
     @brief  Plays the the instruction under the cursor.
     @return aoresult_assert       if atend() holds
@@ -240,8 +248,9 @@ void aomw_tscript_install(const uint16_t *insts, uint16_t numtriplets) {
             chain, and that all triplets in that region are set to the RGB 
             color levels from the instruction.
     @note   A script must have been installed with aomw_tscript_install().
-    @note   The play instruction uses aomw_topo_settriplet(), so the topo
-            map must have been build, eg with aomw_topo_build().
+    @note   The play instruction uses the topo framebuffer (aomw_topo_fb_set,
+            aomw_topo_fb_flush), so only triplets that change get a telegram;
+            the topo map must have been build, eg with aomw_topo_build().
     @note   This function does not move the cursor (use the iterator API).
     @note   This function should not be called when aomw_tscript_atend() holds.
 */
@@ -249,11 +258,8 @@ aoresult_t aomw_tscript_playinst() {
   if( aomw_tscript_atend() ) return aoresult_assert;
   // Using internal `aomw_tscript_inst` instead of public `aomw_tscript_get()`.
   // PRINTF("#%d 0o%06o : %d [%d,%d) %04x.%04x.%04x\n", aomw_tscript_cursor, aomw_tscript_insts[aomw_tscript_cursor], aomw_tscript_inst.withprev, aomw_tscript_inst.tix0, aomw_tscript_inst.tix1, aomw_tscript_inst.rgb.r, aomw_tscript_inst.rgb.g, aomw_tscript_inst.rgb.b );
-  for( uint16_t tix=aomw_tscript_inst.tix0; tix<aomw_tscript_inst.tix1; tix++ ) {
-    aoresult_t result= aomw_topo_settriplet(tix, &aomw_tscript_inst.rgb );
-    if( result!=aoresult_ok ) return result;
-  }
-  return aoresult_ok;
+  aomw_tscript_paintinst();
+  return aomw_topo_fb_flush(0);
 }
 
 
@@ -270,18 +276,20 @@ aoresult_t aomw_tscript_playinst() {
     @note   This function wraps when atend() holds, but it does this before
             playing the instruction, not after playing. This allows the caller
             to check atend().
+    @note   The instructions of the frame are painted in the topo framebuffer,
+            which is flushed once, at the end.
 */
 aoresult_t aomw_tscript_playframe() {
   if( aomw_tscript_atend() ) aomw_tscript_gotofirst();
   int n=1;
   do {
     if( n>8 ) return aoresult_outofmem; // can not have more then 8 with-previous, because there are only 8 segments
-    aoresult_t result= aomw_tscript_playinst();
-    if( result!=aoresult_ok ) return result;
+    if( aomw_tscript_atend() ) return aoresult_assert;
+    aomw_tscript_paintinst();
     aomw_tscript_gotonext();
     n++;
   } while( aomw_tscript_get()->withprev );
-  return aoresult_ok;
+  return aomw_topo_fb_flush(0);
 }
 
 
@@ -89,10 +89,11 @@ void aoosp_said_testpw_set( uint64_t pw ) {
 
 /*!
     @brief  Initializes the aoosp library.
-    @note   At this moment, the aoosp lib has no state (to initialize).
-            Present for future extensions that do need initialization.
+    @note   Installs the clock of the log ring, and in a FreeRTOS build 
+            starts the low priority task that drains it (see 
+            aoosp_logring_init).
 */
 void aoosp_init() {
-  // No init is needed, but already present for future extensions.
+  aoosp_logring_init();
   PRINTF("osp: init\n");
 }
@@ -23,6 +23,133 @@
 #include <aoosp_crc.h> // own API
 
 
+// The OSP CRC is a CRC-8 with polynomial 0x2F, initial value 0, no reflection
+// and no final xor. Since there is no final xor, the CRC of a prefix of a
+// telegram is also the state to continue with; aoosp_crc_update() exploits that.
+//
+// The classic implementation does one table lookup per byte, and each lookup
+// depends on the previous one. The slice-by-4 implementation below processes
+// four bytes per step: aoosp_crc_table[k][x] is the CRC of byte x followed by
+// k zero bytes. Since the CRC is linear, the CRC of four bytes b0 b1 b2 b3
+// (continuing from state crc) is the xor of four independent lookups
+//   table[3][crc^b0] ^ table[2][b1] ^ table[1][b2] ^ table[0][b3]
+// The tables cost 1 kB flash (was 256 bytes). Table [0] is the classic table.
+//
+// The compile time variant AOOSP_CRC_CONSTn() (see aoosp_crc.h) uses the same
+// linearity; these checks against known telegrams let the build fail if its
+// row constants are ever wrong.
+_Static_assert( AOOSP_CRC_CONST3(0xA0,0x00,0x00)==0x22, "AOOSP_CRC_CONST: RESET(000)" );
+_Static_assert( AOOSP_CRC_CONST3(0xA0,0x04,0x02)==0xA9, "AOOSP_CRC_CONST: INITBIDIR(001)" );
+_Static_assert( AOOSP_CRC_CONST11(0xA0,0x07,0xCF,0x00,0xFF,0x08,0x88,0x00,0x11,0x08,0x88)==0x94, "AOOSP_CRC_CONST: SETPWMCHN(001)" );
+
+
+static const uint8_t aoosp_crc_table[4][256] = {
+  { // one byte
+    0x00, 0x2F, 0x5E, 0x71, 0xBC, 0x93, 0xE2, 0xCD, 0x57, 0x78, 0x09, 0x26, 0xEB, 0xC4, 0xB5, 0x9A,
+    0xAE, 0x81, 0xF0, 0xDF, 0x12, 0x3D, 0x4C, 0x63, 0xF9, 0xD6, 0xA7, 0x88, 0x45, 0x6A, 0x1B, 0x34,
+    0x73, 0x5C, 0x2D, 0x02, 0xCF, 0xE0, 0x91, 0xBE, 0x24, 0x0B, 0x7A, 0x55, 0x98, 0xB7, 0xC6, 0xE9,
+    0xDD, 0xF2, 0x83, 0xAC, 0x61, 0x4E, 0x3F, 0x10, 0x8A, 0xA5, 0xD4, 0xFB, 0x36, 0x19, 0x68, 0x47,
+    0xE6, 0xC9, 0xB8, 0x97, 0x5A, 0x75, 0x04, 0x2B, 0xB1, 0x9E, 0xEF, 0xC0, 0x0D, 0x22, 0x53, 0x7C,
+    0x48, 0x67, 0x16, 0x39, 0xF4, 0xDB, 0xAA, 0x85, 0x1F, 0x30, 0x41, 0x6E, 0xA3, 0x8C, 0xFD, 0xD2,
+    0x95, 0xBA, 0xCB, 0xE4, 0x29, 0x06, 0x77, 0x58, 0xC2, 0xED, 0x9C, 0xB3, 0x7E, 0x51, 0x20, 0x0F,
+    0x3B, 0x14, 0x65, 0x4A, 0x87, 0xA8, 0xD9, 0xF6, 0x6C, 0x43, 0x32, 0x1D, 0xD0, 0xFF, 0x8E, 0xA1,
+    0xE3, 0xCC, 0xBD, 0x92, 0x5F, 0x70, 0x01, 0x2E, 0xB4, 0x9B, 0xEA, 0xC5, 0x08, 0x27, 0x56, 0x79,
+    0x4D, 0x62, 0x13, 0x3C, 0xF1, 0xDE, 0xAF, 0x80, 0x1A, 0x35, 0x44, 0x6B, 0xA6, 0x89, 0xF8, 0xD7,
+    0x90, 0xBF, 0xCE, 0xE1, 0x2C, 0x03, 0x72, 0x5D, 0xC7, 0xE8, 0x99, 0xB6, 0x7B, 0x54, 0x25, 0x0A,
+    0x3E, 0x11, 0x60, 0x4F, 0x82, 0xAD, 0xDC, 0xF3, 0x69, 0x46, 0x37, 0x18, 0xD5, 0xFA, 0x8B, 0xA4,
+    0x05, 0x2A, 0x5B, 0x74, 0xB9, 0x96, 0xE7, 0xC8, 0x52, 0x7D, 0x0C, 0x23, 0xEE, 0xC1, 0xB0, 0x9F,
+    0xAB, 0x84, 0xF5, 0xDA, 0x17, 0x38, 0x49, 0x66, 0xFC, 0xD3, 0xA2, 0x8D, 0x40, 0x6F, 0x1E, 0x31,
+    0x76, 0x59, 0x28, 0x07, 0xCA, 0xE5, 0x94, 0xBB, 0x21, 0x0E, 0x7F, 0x50, 0x9D, 0xB2, 0xC3, 0xEC,
+    0xD8, 0xF7, 0x86, 0xA9, 0x64, 0x4B, 0x3A, 0x15, 0x8F, 0xA0, 0xD1, 0xFE, 0x33, 0x1C, 0x6D, 0x42,
+  },
+  { // byte followed by 1 zero byte
+    0x00, 0xE9, 0xFD, 0x14, 0xD5, 0x3C, 0x28, 0xC1, 0x85, 0x6C, 0x78, 0x91, 0x50, 0xB9, 0xAD, 0x44,
+    0x25, 0xCC, 0xD8, 0x31, 0xF0, 0x19, 0x0D, 0xE4, 0xA0, 0x49, 0x5D, 0xB4, 0x75, 0x9C, 0x88, 0x61,
+    0x4A, 0xA3, 0xB7, 0x5E, 0x9F, 0x76, 0x62, 0x8B, 0xCF, 0x26, 0x32, 0xDB, 0x1A, 0xF3, 0xE7, 0x0E,
+    0x6F, 0x86, 0x92, 0x7B, 0xBA, 0x53, 0x47, 0xAE, 0xEA, 0x03, 0x17, 0xFE, 0x3F, 0xD6, 0xC2, 0x2B,
+    0x94, 0x7D, 0x69, 0x80, 0x41, 0xA8, 0xBC, 0x55, 0x11, 0xF8, 0xEC, 0x05, 0xC4, 0x2D, 0x39, 0xD0,
+    0xB1, 0x58, 0x4C, 0xA5, 0x64, 0x8D, 0x99, 0x70, 0x34, 0xDD, 0xC9, 0x20, 0xE1, 0x08, 0x1C, 0xF5,
+    0xDE, 0x37, 0x23, 0xCA, 0x0B, 0xE2, 0xF6, 0x1F, 0x5B, 0xB2, 0xA6, 0x4F, 0x8E, 0x67, 0x73, 0x9A,
+    0xFB, 0x12, 0x06, 0xEF, 0x2E, 0xC7, 0xD3, 0x3A, 0x7E, 0x97, 0x83, 0x6A, 0xAB, 0x42, 0x56, 0xBF,
+    0x07, 0xEE, 0xFA, 0x13, 0xD2, 0x3B, 0x2F, 0xC6, 0x82, 0x6B, 0x7F, 0x96, 0x57, 0xBE, 0xAA, 0x43,
+    0x22, 0xCB, 0xDF, 0x36, 0xF7, 0x1E, 0x0A, 0xE3, 0xA7, 0x4E, 0x5A, 0xB3, 0x72, 0x9B, 0x8F, 0x66,
+    0x4D, 0xA4, 0xB0, 0x59, 0x98, 0x71, 0x65, 0x8C, 0xC8, 0x21, 0x35, 0xDC, 0x1D, 0xF4, 0xE0, 0x09,
+    0x68, 0x81, 0x95, 0x7C, 0xBD, 0x54, 0x40, 0xA9, 0xED, 0x04, 0x10, 0xF9, 0x38, 0xD1, 0xC5, 0x2C,
+    0x93, 0x7A, 0x6E, 0x87, 0x46, 0xAF, 0xBB, 0x52, 0x16, 0xFF, 0xEB, 0x02, 0xC3, 0x2A, 0x3E, 0xD7,
+    0xB6, 0x5F, 0x4B, 0xA2, 0x63, 0x8A, 0x9E, 0x77, 0x33, 0xDA, 0xCE, 0x27, 0xE6, 0x0F, 0x1B, 0xF2,
+    0xD9, 0x30, 0x24, 0xCD, 0x0C, 0xE5, 0xF1, 0x18, 0x5C, 0xB5, 0xA1, 0x48, 0x89, 0x60, 0x74, 0x9D,
+    0xFC, 0x15, 0x01, 0xE8, 0x29, 0xC0, 0xD4, 0x3D, 0x79, 0x90, 0x84, 0x6D, 0xAC, 0x45, 0x51, 0xB8,
+  },
+  { // byte followed by 2 zero bytes
+    0x00, 0x0E, 0x1C, 0x12, 0x38, 0x36, 0x24, 0x2A, 0x70, 0x7E, 0x6C, 0x62, 0x48, 0x46, 0x54, 0x5A,
+    0xE0, 0xEE, 0xFC, 0xF2, 0xD8, 0xD6, 0xC4, 0xCA, 0x90, 0x9E, 0x8C, 0x82, 0xA8, 0xA6, 0xB4, 0xBA,
+    0xEF, 0xE1, 0xF3, 0xFD, 0xD7, 0xD9, 0xCB, 0xC5, 0x9F, 0x91, 0x83, 0x8D, 0xA7, 0xA9, 0xBB, 0xB5,
+    0x0F, 0x01, 0x13, 0x1D, 0x37, 0x39, 0x2B, 0x25, 0x7F, 0x71, 0x63, 0x6D, 0x47, 0x49, 0x5B, 0x55,
+    0xF1, 0xFF, 0xED, 0xE3, 0xC9, 0xC7, 0xD5, 0xDB, 0x81, 0x8F, 0x9D, 0x93, 0xB9, 0xB7, 0xA5, 0xAB,
+    0x11, 0x1F, 0x0D, 0x03, 0x29, 0x27, 0x35, 0x3B, 0x61, 0x6F, 0x7D, 0x73, 0x59, 0x57, 0x45, 0x4B,
+    0x1E, 0x10, 0x02, 0x0C, 0x26, 0x28, 0x3A, 0x34, 0x6E, 0x60, 0x72, 0x7C, 0x56, 0x58, 0x4A, 0x44,
+    0xFE, 0xF0, 0xE2, 0xEC, 0xC6, 0xC8, 0xDA, 0xD4, 0x8E, 0x80, 0x92, 0x9C, 0xB6, 0xB8, 0xAA, 0xA4,
+    0xCD, 0xC3, 0xD1, 0xDF, 0xF5, 0xFB, 0xE9, 0xE7, 0xBD, 0xB3, 0xA1, 0xAF, 0x85, 0x8B, 0x99, 0x97,
+    0x2D, 0x23, 0x31, 0x3F, 0x15, 0x1B, 0x09, 0x07, 0x5D, 0x53, 0x41, 0x4F, 0x65, 0x6B, 0x79, 0x77,
+    0x22, 0x2C, 0x3E, 0x30, 0x1A, 0x14, 0x06, 0x08, 0x52, 0x5C, 0x4E, 0x40, 0x6A, 0x64, 0x76, 0x78,
+    0xC2, 0xCC, 0xDE, 0xD0, 0xFA, 0xF4, 0xE6, 0xE8, 0xB2, 0xBC, 0xAE, 0xA0, 0x8A, 0x84, 0x96, 0x98,
+    0x3C, 0x32, 0x20, 0x2E, 0x04, 0x0A, 0x18, 0x16, 0x4C, 0x42, 0x50, 0x5E, 0x74, 0x7A, 0x68, 0x66,
+    0xDC, 0xD2, 0xC0, 0xCE, 0xE4, 0xEA, 0xF8, 0xF6, 0xAC, 0xA2, 0xB0, 0xBE, 0x94, 0x9A, 0x88, 0x86,
+    0xD3, 0xDD, 0xCF, 0xC1, 0xEB, 0xE5, 0xF7, 0xF9, 0xA3, 0xAD, 0xBF, 0xB1, 0x9B, 0x95, 0x87, 0x89,
+    0x33, 0x3D, 0x2F, 0x21, 0x0B, 0x05, 0x17, 0x19, 0x43, 0x4D, 0x5F, 0x51, 0x7B, 0x75, 0x67, 0x69,
+  },
+  { // byte followed by 3 zero bytes
+    0x00, 0xB5, 0x45, 0xF0, 0x8A, 0x3F, 0xCF, 0x7A, 0x3B, 0x8E, 0x7E, 0xCB, 0xB1, 0x04, 0xF4, 0x41,
+    0x76, 0xC3, 0x33, 0x86, 0xFC, 0x49, 0xB9, 0x0C, 0x4D, 0xF8, 0x08, 0xBD, 0xC7, 0x72, 0x82, 0x37,
+    0xEC, 0x59, 0xA9, 0x1C, 0x66, 0xD3, 0x23, 0x96, 0xD7, 0x62, 0x92, 0x27, 0x5D, 0xE8, 0x18, 0xAD,
+    0x9A, 0x2F, 0xDF, 0x6A, 0x10, 0xA5, 0x55, 0xE0, 0xA1, 0x14, 0xE4, 0x51, 0x2B, 0x9E, 0x6E, 0xDB,
+    0xF7, 0x42, 0xB2, 0x07, 0x7D, 0xC8, 0x38, 0x8D, 0xCC, 0x79, 0x89, 0x3C, 0x46, 0xF3, 0x03, 0xB6,
+    0x81, 0x34, 0xC4, 0x71, 0x0B, 0xBE, 0x4E, 0xFB, 0xBA, 0x0F, 0xFF, 0x4A, 0x30, 0x85, 0x75, 0xC0,
+    0x1B, 0xAE, 0x5E, 0xEB, 0x91, 0x24, 0xD4, 0x61, 0x20, 0x95, 0x65, 0xD0, 0xAA, 0x1F, 0xEF, 0x5A,
+    0x6D, 0xD8, 0x28, 0x9D, 0xE7, 0x52, 0xA2, 0x17, 0x56, 0xE3, 0x13, 0xA6, 0xDC, 0x69, 0x99, 0x2C,
+    0xC1, 0x74, 0x84, 0x31, 0x4B, 0xFE, 0x0E, 0xBB, 0xFA, 0x4F, 0xBF, 0x0A, 0x70, 0xC5, 0x35, 0x80,
+    0xB7, 0x02, 0xF2, 0x47, 0x3D, 0x88, 0x78, 0xCD, 0x8C, 0x39, 0xC9, 0x7C, 0x06, 0xB3, 0x43, 0xF6,
+    0x2D, 0x98, 0x68, 0xDD, 0xA7, 0x12, 0xE2, 0x57, 0x16, 0xA3, 0x53, 0xE6, 0x9C, 0x29, 0xD9, 0x6C,
+    0x5B, 0xEE, 0x1E, 0xAB, 0xD1, 0x64, 0x94, 0x21, 0x60, 0xD5, 0x25, 0x90, 0xEA, 0x5F, 0xAF, 0x1A,
+    0x36, 0x83, 0x73, 0xC6, 0xBC, 0x09, 0xF9, 0x4C, 0x0D, 0xB8, 0x48, 0xFD, 0x87, 0x32, 0xC2, 0x77,
+    0x40, 0xF5, 0x05, 0xB0, 0xCA, 0x7F, 0x8F, 0x3A, 0x7B, 0xCE, 0x3E, 0x8B, 0xF1, 0x44, 0xB4, 0x01,
+    0xDA, 0x6F, 0x9F, 0x2A, 0x50, 0xE5, 0x15, 0xA0, 0xE1, 0x54, 0xA4, 0x11, 0x6B, 0xDE, 0x2E, 0x9B,
+    0xAC, 0x19, 0xE9, 0x5C, 0x26, 0x93, 0x63, 0xD6, 0x97, 0x22, 0xD2, 0x67, 0x1D, 0xA8, 0x58, 0xED,
+  },
+};
+
+
+/*!
+    @brief  Continues an OSP CRC computation with more bytes.
+    @param  crc
+            The CRC state to continue from: 0 for the start of a
+            telegram, or the result of a previous call (or of aoosp_crc).
+    @param  buf
+            A pointer to a sequence of bytes.
+    @param  size
+            Number of bytes of buf to add to the CRC.
+    @return The OSP CRC of all bytes fed so far.
+    @note   aoosp_crc_update(aoosp_crc_update(0,buf,n),buf+n,size-n) equals
+            aoosp_crc(buf,size); this allows caching the CRC of a fixed
+            telegram prefix (e.g. a header) and only adding the payload.
+    @note   Implemented via slice-by-4 table lookup.
+*/
+uint8_t aoosp_crc_update(uint8_t crc, const uint8_t * buf, int size) {
+  // Four bytes per step; the four lookups are independent
+  while( size>=4 ) {
+    crc = aoosp_crc_table[3][crc^buf[0]] ^ aoosp_crc_table[2][buf[1]] ^ aoosp_crc_table[1][buf[2]] ^ aoosp_crc_table[0][buf[3]];
+    buf  += 4;
+    size -= 4;
+  }
+  // Remaining (0..3) bytes one at a time
+  while( size>0 ) {
+    crc = aoosp_crc_table[0][crc^*buf++];
+    size--;
+  }
+  return crc;
+}
+
+
 /*!
     @brief  Computes the OSP CRC for a sequence of bytes.
     @param  buf
@@ -30,32 +157,31 @@
     @param  size
             Number of bytes of buf to compute the CRC for.
     @return The OSP CRC.
-    @note   Implemented via table lookup.
+    @note   Implemented via slice-by-4 table lookup, see aoosp_crc_update().
 */
 uint8_t aoosp_crc(const uint8_t * buf, int size) {
-  static const uint8_t table[256] = { 
-    0x00, 0x2F, 0x5E, 0x71, 0xBC, 0x93, 0xE2, 0xCD, 0x57, 0x78, 0x09, 0x26, 0xEB, 0xC4, 0xB5, 0x9A, 
-    0xAE, 0x81, 0xF0, 0xDF, 0x12, 0x3D, 0x4C, 0x63, 0xF9, 0xD6, 0xA7, 0x88, 0x45, 0x6A, 0x1B, 0x34, 
-    0x73, 0x5C, 0x2D, 0x02, 0xCF, 0xE0, 0x91, 0xBE, 0x24, 0x0B, 0x7A, 0x55, 0x98, 0xB7, 0xC6, 0xE9,
-    0xDD, 0xF2, 0x83, 0xAC, 0x61, 0x4E, 0x3F, 0x10, 0x8A, 0xA5, 0xD4, 0xFB, 0x36, 0x19, 0x68, 0x47, 
-    0xE6, 0xC9, 0xB8, 0x97, 0x5A, 0x75, 0x04, 0x2B, 0xB1, 0x9E, 0xEF, 0xC0, 0x0D, 0x22, 0x53, 0x7C, 
-    0x48, 0x67, 0x16, 0x39, 0xF4, 0xDB, 0xAA, 0x85, 0x1F, 0x30, 0x41, 0x6E, 0xA3, 0x8C, 0xFD, 0xD2,
-    0x95, 0xBA, 0xCB, 0xE4, 0x29, 0x06, 0x77, 0x58, 0xC2, 0xED, 0x9C, 0xB3, 0x7E, 0x51, 0x20, 0x0F, 
-    0x3B, 0x14, 0x65, 0x4A, 0x87, 0xA8, 0xD9, 0xF6, 0x6C, 0x43, 0x32, 0x1D, 0xD0, 0xFF, 0x8E, 0xA1, 
-    0xE3, 0xCC, 0xBD, 0x92, 0x5F, 0x70, 0x01, 0x2E, 0xB4, 0x9B, 0xEA, 0xC5, 0x08, 0x27, 0x56, 0x79,
-    0x4D, 0x62, 0x13, 0x3C, 0xF1, 0xDE, 0xAF, 0x80, 0x1A, 0x35, 0x44, 0x6B, 0xA6, 0x89, 0xF8, 0xD7, 
-    0x90, 0xBF, 0xCE, 0xE1, 0x2C, 0x03, 0x72, 0x5D, 0xC7, 0xE8, 0x99, 0xB6, 0x7B, 0x54, 0x25, 0x0A, 
-    0x3E, 0x11, 0x60, 0x4F, 0x82, 0xAD, 0xDC, 0xF3, 0x69, 0x46, 0x37, 0x18, 0xD5, 0xFA, 0x8B, 0xA4,
-    0x05, 0x2A, 0x5B, 0x74, 0xB9, 0x96, 0xE7, 0xC8, 0x52, 0x7D, 0x0C, 0x23, 0xEE, 0xC1, 0xB0, 0x9F, 
-    0xAB, 0x84, 0xF5, 0xDA, 0x17, 0x38, 0x49, 0x66, 0xFC, 0xD3, 0xA2, 0x8D, 0x40, 0x6F, 0x1E, 0x31, 
-    0x76, 0x59, 0x28, 0x07, 0xCA, 0xE5, 0x94, 0xBB, 0x21, 0x0E, 0x7F, 0x50, 0x9D, 0xB2, 0xC3, 0xEC,
-    0xD8, 0xF7, 0x86, 0xA9, 0x64, 0x4B, 0x3A, 0x15, 0x8F, 0xA0, 0xD1, 0xFE, 0x33, 0x1C, 0x6D, 0x42, 
-  };
-  uint8_t crc = 0;
-  for( int i=0; i<size; i++ ) {
-    crc ^= *buf++;
-    crc = table[crc];
-  }
-  return crc;
+  return aoosp_crc_update(0,buf,size);
 }
 
+
+/*!
+    @brief  Verifies the CRC of a batch of (received) telegrams.
+    @param  teles
+            Array of `count` pointers to telegrams, each including its CRC byte.
+    @param  sizes
+            Array of `count` telegram sizes (in bytes, including the CRC byte).
+    @param  count
+            Number of telegrams in the batch.
+    @return The index of the first telegram whose CRC is wrong (or whose size
+            is less than 4), or `count` when all telegrams pass.
+    @note   A telegram passes when the CRC over all its bytes, including the
+            CRC byte, is 0. To find all failing telegrams, call again on the
+            remainder of the batch (starting after the returned index).
+    @note   The arguments mirror aospi_tx_batch().
+*/
+int aoosp_crc_check_batch(const uint8_t * const teles[], const int sizes[], int count) {
+  for( int i=0; i<count; i++ ) {
+    if( sizes[i]<4 || aoosp_crc_update(0,teles[i],sizes[i])!=0 ) return i;
+  }
+  return count;
+}
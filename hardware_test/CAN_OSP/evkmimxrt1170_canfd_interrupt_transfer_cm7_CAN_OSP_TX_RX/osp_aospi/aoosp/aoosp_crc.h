@@ -34,6 +34,49 @@
 
 // Returns OSP CRC of the size bytes in buf
 uint8_t aoosp_crc(const uint8_t * buf, int size); 
+// Returns OSP CRC after adding the size bytes in buf to CRC state crc (0 at the start of a telegram)
+uint8_t aoosp_crc_update(uint8_t crc, const uint8_t * buf, int size);
+// Returns the index of the first of count telegrams with a bad CRC, or count if all are ok
+int     aoosp_crc_check_batch(const uint8_t * const teles[], const int sizes[], int count);
+
+
+// Compile time CRC
+// ================
+// AOOSP_CRC_CONSTn(b0,..) is the OSP CRC of n constant bytes as an integer
+// constant expression, so the compiler computes it; it can be used in
+// initializers of const (flash) arrays and in _Static_assert. It is the
+// xor over the bytes of the CRC of that byte followed by zero bytes (the CRC
+// is linear), and per byte the xor over its set bits of AOOSP_CRC_ROWk:
+// the CRCs of 0x01, 0x02, .., 0x80 followed by k zero bytes.
+#define AOOSP_CRC_ROW0  0x2F, 0x5E, 0xBC, 0x57, 0xAE, 0x73, 0xE6, 0xE3
+#define AOOSP_CRC_ROW1  0xE9, 0xFD, 0xD5, 0x85, 0x25, 0x4A, 0x94, 0x07
+#define AOOSP_CRC_ROW2  0x0E, 0x1C, 0x38, 0x70, 0xE0, 0xEF, 0xF1, 0xCD
+#define AOOSP_CRC_ROW3  0xB5, 0x45, 0x8A, 0x3B, 0x76, 0xEC, 0xF7, 0xC1
+#define AOOSP_CRC_ROW4  0xAD, 0x75, 0xEA, 0xFB, 0xD9, 0x9D, 0x15, 0x2A
+#define AOOSP_CRC_ROW5  0x54, 0xA8, 0x7F, 0xFE, 0xD3, 0x89, 0x3D, 0x7A
+#define AOOSP_CRC_ROW6  0xF4, 0xC7, 0xA1, 0x6D, 0xDA, 0x9B, 0x19, 0x32
+#define AOOSP_CRC_ROW7  0x64, 0xC8, 0xBF, 0x51, 0xA2, 0x6B, 0xD6, 0x83
+#define AOOSP_CRC_ROW8  0x29, 0x52, 0xA4, 0x67, 0xCE, 0xB3, 0x49, 0x92
+#define AOOSP_CRC_ROW9  0x0B, 0x16, 0x2C, 0x58, 0xB0, 0x4F, 0x9E, 0x13
+#define AOOSP_CRC_ROW10 0x26, 0x4C, 0x98, 0x1F, 0x3E, 0x7C, 0xF8, 0xDF
+
+// CRC of byte b followed by k zero bytes, with `row` AOOSP_CRC_ROWk (expanded to 8 args by the extra level)
+#define AOOSP_CRC_TERM(b,row)                      AOOSP_CRC_TERM_(b,row)
+#define AOOSP_CRC_TERM_(b,c0,c1,c2,c3,c4,c5,c6,c7) ( ((b)&0x01?c0:0) ^ ((b)&0x02?c1:0) ^ ((b)&0x04?c2:0) ^ ((b)&0x08?c3:0) \
+                                                   ^ ((b)&0x10?c4:0) ^ ((b)&0x20?c5:0) ^ ((b)&0x40?c6:0) ^ ((b)&0x80?c7:0) )
+
+// OSP CRC of 1 to 11 constant bytes (a telegram without its CRC byte has 3 to 11 bytes)
+#define AOOSP_CRC_CONST1(b0)                                 ( AOOSP_CRC_TERM(b0,AOOSP_CRC_ROW0) )
+#define AOOSP_CRC_CONST2(b0,b1)                              ( AOOSP_CRC_TERM(b0,AOOSP_CRC_ROW1) ^ AOOSP_CRC_CONST1(b1) )
+#define AOOSP_CRC_CONST3(b0,b1,b2)                           ( AOOSP_CRC_TERM(b0,AOOSP_CRC_ROW2) ^ AOOSP_CRC_CONST2(b1,b2) )
+#define AOOSP_CRC_CONST4(b0,b1,b2,b3)                        ( AOOSP_CRC_TERM(b0,AOOSP_CRC_ROW3) ^ AOOSP_CRC_CONST3(b1,b2,b3) )
+#define AOOSP_CRC_CONST5(b0,b1,b2,b3,b4)                     ( AOOSP_CRC_TERM(b0,AOOSP_CRC_ROW4) ^ AOOSP_CRC_CONST4(b1,b2,b3,b4) )
+#define AOOSP_CRC_CONST6(b0,b1,b2,b3,b4,b5)                  ( AOOSP_CRC_TERM(b0,AOOSP_CRC_ROW5) ^ AOOSP_CRC_CONST5(b1,b2,b3,b4,b5) )
+#define AOOSP_CRC_CONST7(b0,b1,b2,b3,b4,b5,b6)               ( AOOSP_CRC_TERM(b0,AOOSP_CRC_ROW6) ^ AOOSP_CRC_CONST6(b1,b2,b3,b4,b5,b6) )
+#define AOOSP_CRC_CONST8(b0,b1,b2,b3,b4,b5,b6,b7)            ( AOOSP_CRC_TERM(b0,AOOSP_CRC_ROW7) ^ AOOSP_CRC_CONST7(b1,b2,b3,b4,b5,b6,b7) )
+#define AOOSP_CRC_CONST9(b0,b1,b2,b3,b4,b5,b6,b7,b8)         ( AOOSP_CRC_TERM(b0,AOOSP_CRC_ROW8) ^ AOOSP_CRC_CONST8(b1,b2,b3,b4,b5,b6,b7,b8) )
+#define AOOSP_CRC_CONST10(b0,b1,b2,b3,b4,b5,b6,b7,b8,b9)     ( AOOSP_CRC_TERM(b0,AOOSP_CRC_ROW9) ^ AOOSP_CRC_CONST9(b1,b2,b3,b4,b5,b6,b7,b8,b9) )
+#define AOOSP_CRC_CONST11(b0,b1,b2,b3,b4,b5,b6,b7,b8,b9,b10) ( AOOSP_CRC_TERM(b0,AOOSP_CRC_ROW10) ^ AOOSP_CRC_CONST10(b1,b2,b3,b4,b5,b6,b7,b8,b9,b10) )
 
 
 #endif
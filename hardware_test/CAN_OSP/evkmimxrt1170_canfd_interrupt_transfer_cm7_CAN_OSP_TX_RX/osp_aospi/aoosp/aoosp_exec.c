@@ -349,8 +349,8 @@ free_resources:
 aoresult_t aoosp_exec_i2cenable_get(uint16_t addr, int * enable) {
   if( enable==0 ) return aoresult_outargnull;
   // I2C_BRIDGE_EN
-  uint8_t otp_addr = 0x0D;
-  uint8_t otp_bits = 0x01;
+  uint8_t otp_addr = AOOSP_OTPADDR_I2C_BRIDGE_EN;
+  uint8_t otp_bits = AOOSP_OTPBITS_I2C_BRIDGE_EN;
   // Read current OTP row
   uint8_t buf[8];
   aoresult_t result = aoosp_send_readotp(addr,otp_addr,buf,8);
@@ -383,8 +383,8 @@ aoresult_t aoosp_exec_i2cenable_get(uint16_t addr, int * enable) {
 */
 aoresult_t aoosp_exec_i2cenable_set(uint16_t addr, int enable) {
   // I2C_BRIDGE_EN
-  uint8_t otp_addr = 0x0D;
-  uint8_t otp_bits = 0x01;
+  uint8_t otp_addr = AOOSP_OTPADDR_I2C_BRIDGE_EN;
+  uint8_t otp_bits = AOOSP_OTPBITS_I2C_BRIDGE_EN;
   // Compute masks
   uint8_t andmask  = ~otp_bits; 
   uint8_t ormask   = enable ? otp_bits : 0x00 ;
@@ -497,8 +497,8 @@ aoresult_t aoosp_exec_syncpinenable_set(uint16_t addr, int enable) {
 */
 aoresult_t aoosp_exec_skipchns_get(uint16_t addr, int * skipchns) {
   // SKIPCHNx
-  uint8_t otp_addr = 0x1E;
-  uint8_t otp_bits = 0x07;
+  uint8_t otp_addr = AOOSP_OTPADDR_SKIPCHNS;
+  uint8_t otp_bits = AOOSP_OTPBITS_SKIPCHNS;
   if( skipchns==0 ) return aoresult_outargnull;
   // Read current OTP row
   uint8_t buf[8];
@@ -533,9 +533,9 @@ aoresult_t aoosp_exec_skipchns_get(uint16_t addr, int * skipchns) {
 */
 aoresult_t aoosp_exec_skipchns_set(uint16_t addr, int skipchns) {
   AORESULT_ASSERT( (skipchns & ~0x07) == 0 );
-  // SYNC_PIN_EN
-  uint8_t otp_addr = 0x1E;
-  uint8_t otp_bits = 0x07;
+  // SKIPCHNx
+  uint8_t otp_addr = AOOSP_OTPADDR_SKIPCHNS;
+  uint8_t otp_bits = AOOSP_OTPBITS_SKIPCHNS;
   // Compute masks
   uint8_t andmask = ~otp_bits; 
   uint8_t ormask  = skipchns & otp_bits;
@@ -544,6 +544,13 @@ aoresult_t aoosp_exec_skipchns_set(uint16_t addr, int skipchns) {
 }
 
 
+// An I2C transaction is polled (READI2CCFG) until the bridge is no longer busy,
+// at most AOOSP_EXEC_I2C_TRIES times with AOOSP_EXEC_I2C_POLLUS in between, so
+// it times out after 10 ms (a 100kHz I2C transfer of 8 bytes takes about 1 ms).
+#define AOOSP_EXEC_I2C_TRIES  10   // max number of busy polls (with delay) per transaction
+#define AOOSP_EXEC_I2C_POLLUS 1000 // delay between busy polls
+
+
 /*!
     @brief  Writes `count` bytes from `buf`, into register `raddr` in I2C
             device `daddr7`, attached to OSP node `addr`.
@@ -566,14 +573,13 @@ aoresult_t aoosp_exec_i2cwrite8(uint16_t addr, uint8_t daddr7, uint8_t raddr, co
   if( result!=aoresult_ok ) return result;
   // Wait (with timeout) until I2C transaction is completed (not busy)
   uint8_t flags=AOOSP_I2CCFG_FLAGS_BUSY;
-  uint8_t tries=10; // 10x 1ms
+  uint8_t tries=AOOSP_EXEC_I2C_TRIES;
   while( (flags&AOOSP_I2CCFG_FLAGS_BUSY) && (tries>0) ) {
     uint8_t speed;
     result = aoosp_send_readi2ccfg(addr,&flags,&speed);
     if( result!=aoresult_ok ) return result;
     if( flags & AOOSP_I2CCFG_FLAGS_12BIT ) return aoresult_dev_i2cmode;
-//    delay(1);
-    SDK_DelayAtLeastUs(1000000, SDK_DEVICE_MAXIMUM_CPU_CLOCK_FREQUENCY);
+    if( flags & AOOSP_I2CCFG_FLAGS_BUSY ) SDK_DelayAtLeastUs(AOOSP_EXEC_I2C_POLLUS, SDK_DEVICE_MAXIMUM_CPU_CLOCK_FREQUENCY);
     tries--;
   }
   // Was transaction successful
@@ -606,14 +612,13 @@ aoresult_t aoosp_exec_i2cread8(uint16_t addr, uint8_t daddr7, uint8_t raddr, uin
   if( result!=aoresult_ok ) return result;
   // Wait (with timeout) until I2C transaction is completed (not busy)
   uint8_t flags=AOOSP_I2CCFG_FLAGS_BUSY;
-  uint8_t tries=10; // 10x 1ms
+  uint8_t tries=AOOSP_EXEC_I2C_TRIES;
   while( (flags&AOOSP_I2CCFG_FLAGS_BUSY) && (tries>0) ) {
     uint8_t speed;
     result = aoosp_send_readi2ccfg(addr,&flags,&speed);
     if( result!=aoresult_ok ) return result;
     if( flags & AOOSP_I2CCFG_FLAGS_12BIT ) return aoresult_dev_i2cmode;
-//    delay(1);
-    SDK_DelayAtLeastUs(1000000, SDK_DEVICE_MAXIMUM_CPU_CLOCK_FREQUENCY);
+    if( flags & AOOSP_I2CCFG_FLAGS_BUSY ) SDK_DelayAtLeastUs(AOOSP_EXEC_I2C_POLLUS, SDK_DEVICE_MAXIMUM_CPU_CLOCK_FREQUENCY);
     tries--;
   }
   // Was transaction successful
@@ -647,14 +652,13 @@ aoresult_t aoosp_exec_i2cwrite12(uint16_t addr, uint8_t daddr7, uint16_t raddr,
   if( result!=aoresult_ok ) return result;
   // Wait (with timeout) until I2C transaction is completed (not busy)
   uint8_t flags=AOOSP_I2CCFG_FLAGS_BUSY;
-  uint8_t tries=10; // 10x 1ms
+  uint8_t tries=AOOSP_EXEC_I2C_TRIES;
   while( (flags&AOOSP_I2CCFG_FLAGS_BUSY) && (tries>0) ) {
     uint8_t speed;
     result = aoosp_send_readi2ccfg(addr,&flags,&speed);
     if( result!=aoresult_ok ) return result;
     if( !( flags & AOOSP_I2CCFG_FLAGS_12BIT ) ) return aoresult_dev_i2cmode;
-//    delay(1);
-    SDK_DelayAtLeastUs(1000000, SDK_DEVICE_MAXIMUM_CPU_CLOCK_FREQUENCY);
+    if( flags & AOOSP_I2CCFG_FLAGS_BUSY ) SDK_DelayAtLeastUs(AOOSP_EXEC_I2C_POLLUS, SDK_DEVICE_MAXIMUM_CPU_CLOCK_FREQUENCY);
     tries--;
   }
   // Was transaction successful
@@ -687,14 +691,13 @@ aoresult_t aoosp_exec_i2cread12(uint16_t addr, uint8_t daddr7, uint16_t raddr, u
   if( result!=aoresult_ok ) return result;
   // Wait (with timeout) until I2C transaction is completed (not busy)
   uint8_t flags=AOOSP_I2CCFG_FLAGS_BUSY;
-  uint8_t tries=10; // 10x 1ms
+  uint8_t tries=AOOSP_EXEC_I2C_TRIES;
   while( (flags&AOOSP_I2CCFG_FLAGS_BUSY) && (tries>0) ) {
     uint8_t speed;
     result = aoosp_send_readi2ccfg(addr,&flags,&speed);
     if( result!=aoresult_ok ) return result;
     if( !( flags & AOOSP_I2CCFG_FLAGS_12BIT ) ) return aoresult_dev_i2cmode;
-//    delay(1);
-    SDK_DelayAtLeastUs(1000000, SDK_DEVICE_MAXIMUM_CPU_CLOCK_FREQUENCY);
+    if( flags & AOOSP_I2CCFG_FLAGS_BUSY ) SDK_DelayAtLeastUs(AOOSP_EXEC_I2C_POLLUS, SDK_DEVICE_MAXIMUM_CPU_CLOCK_FREQUENCY);
     tries--;
   }
   // Was transaction successful
@@ -706,3 +709,92 @@ aoresult_t aoosp_exec_i2cread12(uint16_t addr, uint8_t daddr7, uint16_t raddr, u
 }
 
 
+// States of an aoosp_exec_i2cjob_t in aoosp_exec_i2cread8_many()
+#define AOOSP_EXEC_I2CJOB_WAIT   0 // not yet issued (its bridge still runs an earlier job)
+#define AOOSP_EXEC_I2CJOB_BUSY   1 // I2CREAD sent, bridge is mastering the I2C transaction
+#define AOOSP_EXEC_I2CJOB_DONE   2 // result (and buf) final
+
+
+// Returns 1 iff one of the `n` jobs has an I2C transaction in progress on the bridge of SAID `addr`.
+static int aoosp_exec_i2cjob_bridgebusy(const aoosp_exec_i2cjob_t * jobs, int n, uint16_t addr) {
+  for( int i=0; i<n; i++ ) if( jobs[i].state==AOOSP_EXEC_I2CJOB_BUSY && jobs[i].addr==addr ) return 1;
+  return 0;
+}
+
+
+/*!
+    @brief  Performs a batch of I2C reads (8 bits register addresses), 
+            overlapping the I2C transactions on different bridges.
+    @param  jobs
+            Array of `n` jobs; for each job addr, daddr7, raddr, count and buf
+            must be set. On return, result (and buf when ok) is set.
+    @param  n
+            The number of jobs.
+    @return aoresult_ok if all jobs succeeded, otherwise the result of 
+            the first failing job (in job order).
+    @note   aoosp_exec_i2cread8() is strictly serial: I2CREAD, poll the 
+            bridge until it is no longer busy, READLAST. This function first
+            sends I2CREAD to every bridge, and then polls the bridges in 
+            turn, collecting (READLAST) from each one that is done. So the 
+            I2C transfer time of one bridge is hidden behind the OSP 
+            traffic to the others. When a bridge is done, its next job (if
+            any) is issued immediately.
+    @note   Jobs on the same bridge (addr) are executed one after the other,
+            in job order; jobs on different bridges may complete in any order.
+    @note   The delay between polls is only spent when a complete round over
+            the busy bridges made no progress; then every busy job uses up one
+            of its tries, and a job that runs out of tries fails with 
+            aoresult_dev_i2ctimeout (as aoosp_exec_i2cread8 does).
+    @note   All SAIDs must be on the selected chain (see aospi_chain_set()).
+*/
+aoresult_t aoosp_exec_i2cread8_many(aoosp_exec_i2cjob_t * jobs, int n) {
+  if( n>0 && jobs==0 ) return aoresult_outargnull;
+  for( int i=0; i<n; i++ ) {
+    jobs[i].state = AOOSP_EXEC_I2CJOB_WAIT;
+    jobs[i].tries = AOOSP_EXEC_I2C_TRIES;
+    jobs[i].result= aoresult_ok;
+  }
+  int pending = n;
+  while( pending>0 ) {
+    // Issue: start the first waiting job on every idle bridge
+    for( int i=0; i<n; i++ ) {
+      aoosp_exec_i2cjob_t * job = &jobs[i];
+      if( job->state!=AOOSP_EXEC_I2CJOB_WAIT || aoosp_exec_i2cjob_bridgebusy(jobs,n,job->addr) ) continue;
+      job->result = aoosp_send_i2cread8(job->addr,job->daddr7,job->raddr,job->count);
+      job->state = job->result==aoresult_ok ? AOOSP_EXEC_I2CJOB_BUSY : AOOSP_EXEC_I2CJOB_DONE;
+      if( job->state==AOOSP_EXEC_I2CJOB_DONE ) pending--;
+    }
+    // Collect: poll each busy bridge, get the bytes from the ones that are done
+    int progress = 0;
+    for( int i=0; i<n; i++ ) {
+      aoosp_exec_i2cjob_t * job = &jobs[i];
+      if( job->state!=AOOSP_EXEC_I2CJOB_BUSY ) continue;
+      uint8_t flags, speed;
+      job->result = aoosp_send_readi2ccfg(job->addr,&flags,&speed);
+      if( job->result==aoresult_ok ) {
+        if( flags & AOOSP_I2CCFG_FLAGS_12BIT ) job->result = aoresult_dev_i2cmode;
+        else if( flags & AOOSP_I2CCFG_FLAGS_BUSY ) continue; // still busy
+        else if( flags & AOOSP_I2CCFG_FLAGS_NACK ) job->result = aoresult_dev_i2cnack;
+        else job->result = aoosp_send_readlast(job->addr,job->buf,job->count);
+      }
+      job->state = AOOSP_EXEC_I2CJOB_DONE;
+      pending--;
+      progress = 1;
+    }
+    if( progress || pending==0 ) continue;
+    // No bridge finished this round: wait, and charge one try to each busy job
+    SDK_DelayAtLeastUs(AOOSP_EXEC_I2C_POLLUS, SDK_DEVICE_MAXIMUM_CPU_CLOCK_FREQUENCY);
+    for( int i=0; i<n; i++ ) {
+      aoosp_exec_i2cjob_t * job = &jobs[i];
+      if( job->state!=AOOSP_EXEC_I2CJOB_BUSY ) continue;
+      if( --job->tries>0 ) continue;
+      job->result = aoresult_dev_i2ctimeout;
+      job->state = AOOSP_EXEC_I2CJOB_DONE;
+      pending--;
+    }
+  }
+  for( int i=0; i<n; i++ ) if( jobs[i].result!=aoresult_ok ) return jobs[i].result;
+  return aoresult_ok;
+}
+
+
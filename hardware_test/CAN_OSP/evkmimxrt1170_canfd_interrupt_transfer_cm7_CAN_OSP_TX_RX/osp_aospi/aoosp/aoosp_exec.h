@@ -67,6 +67,22 @@ aoresult_t aoosp_exec_i2cwrite12(uint16_t addr, uint8_t daddr7, uint16_t raddr,
 aoresult_t aoosp_exec_i2cread12(uint16_t addr, uint8_t daddr7, uint16_t raddr, uint8_t *buf, uint8_t count);
 
 
+// One I2C read (8 bits register address) in a batch for aoosp_exec_i2cread8_many().
+typedef struct aoosp_exec_i2cjob_s {
+  uint16_t   addr;   // in:  OSP address of the SAID with the I2C bridge
+  uint8_t    daddr7; // in:  7 bits I2C device address
+  uint8_t    raddr;  // in:  8 bits register address
+  uint8_t    count;  // in:  number of bytes to read (1..8)
+  uint8_t *  buf;    // out: the bytes read (count entries)
+  aoresult_t result; // out: the result of this read
+  uint8_t    state;  // private: scheduling state
+  uint8_t    tries;  // private: busy polls left
+} aoosp_exec_i2cjob_t;
+
+// Performs a batch of I2C reads, overlapping the I2C transactions of different bridges.
+aoresult_t aoosp_exec_i2cread8_many(aoosp_exec_i2cjob_t * jobs, int n);
+
+
 // flags for aoosp_exec_otpdump determining what to print
 #define AOOSP_OTPDUMP_CUSTOMER_HEX        0x01
 #define AOOSP_OTPDUMP_CUSTOMER_FIELDSLIST 0x02
@@ -76,6 +92,12 @@ aoresult_t aoosp_exec_i2cread12(uint16_t addr, uint8_t daddr7, uint16_t raddr, u
 #define AOOSP_OTPADDR_CUSTOMER_MIN        0x0D
 #define AOOSP_OTPADDR_CUSTOMER_MAX        0x20
 
+// OTP (mirror) location of the bits that determine the triplets of a SAID
+#define AOOSP_OTPADDR_I2C_BRIDGE_EN       0x0D
+#define AOOSP_OTPBITS_I2C_BRIDGE_EN       0x01
+#define AOOSP_OTPADDR_SKIPCHNS            0x1E
+#define AOOSP_OTPBITS_SKIPCHNS            0x07
+
 
 #endif
 
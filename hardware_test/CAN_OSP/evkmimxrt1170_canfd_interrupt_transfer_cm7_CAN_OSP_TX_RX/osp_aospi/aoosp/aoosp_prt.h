@@ -26,10 +26,12 @@
 #include "stdint.h"
 #include "stdlib.h"
 #include "stdbool.h"
+#if !defined(__linux__) // host builds (e.g. tools/aoosp_logdec.c) have no MCU SDK
 #include "fsl_lpuart.h"
 #include "fsl_gpio.h"
 #include "fsl_common.h"
 #include "fsl_debug_console.h"
+#endif
 
 
 // Converts RGBi raw temperature to Celsius.
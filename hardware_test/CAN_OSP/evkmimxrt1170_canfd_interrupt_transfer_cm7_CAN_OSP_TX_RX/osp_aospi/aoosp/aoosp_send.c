@@ -19,10 +19,15 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
  *****************************************************************************/
 
-#include "aospi.h"      // aospi_tx, aospi_txrx
-#include <aoosp_crc.h>  // aoosp_crc
+#include "aospi.h"      // aospi_tx, aospi_txrx, aospi_stat_error
+#include <aoosp_crc.h>  // aoosp_crc, aoosp_crc_update
 #include <aoosp_prt.h>  // aoosp_prt_bytes() for logging
 #include <aoosp_send.h> // own API
+#include "fsl_common.h" // DWT, SystemCoreClock (log ring clock)
+#if defined(SDK_OS_FREE_RTOS)
+#include "FreeRTOS.h"   // the task that drains the log ring
+#include "task.h"
+#endif
 
 
 // Definition of a telegram
@@ -58,6 +63,15 @@ typedef struct aoosp_tele_s { uint8_t data[AOOSP_TELE_MAXSIZE]; uint8_t size; }
 //   initloop(0x001) 
 //     [tele A0 04 03 86] -> [resp A0 09 03 00 50 63] 
 //     last=0x02=2 temp=0x00=-86 stat=0x50=SLEEP:tV:clou (-126, SLEEP:oL:clou)
+//
+// Printing takes far longer than sending a telegram, so logging to Serial
+// distorts the timing of what is logged. The level aoosp_loglevel_ring
+// avoids that: aoosp_send_xxx() only copies the telegram, the response and
+// the step results as a fixed size binary record into a ring (see LOG RING).
+// A low priority task (started by aoosp_init in a FreeRTOS build) calls 
+// aoosp_logring_drain() to print the records as "#osplog" hex lines, and the 
+// host tool tools/aoosp_logdec.c turns a capture of those lines back into the
+// above human readable format. The records are time stamped in us.
 
 
 #ifndef AOOSP_LOG_ENABLED
@@ -78,6 +92,7 @@ static aoosp_loglevel_t aoosp_loglevel = aoosp_loglevel_none;
     @brief  Sets the amount of logging for the aoosp_send_xxx() functions.
     @param  level
             aoosp_loglevel_none - Nothing is logged (default)
+            aoosp_loglevel_ring - Binary records to the log ring (see aoosp_logring_drain)
             aoosp_loglevel_args - Logging of sent and received telegram arguments
             aoosp_loglevel_tele - Also logs raw (sent and received) telegram bytes
     @note   Logging means "print to Serial".
@@ -103,6 +118,521 @@ aoosp_loglevel_t aoosp_loglevel_get() {
 #endif // AOOSP_LOG_ENABLED
 
 
+// === CODEC ==============================================
+
+
+// Telegram codec
+// ==============
+// All telegrams share one format: a 3 byte header (preamble, address, payload
+// size indicator and telegram ID), a payload of 0 to 8 bytes, and a CRC byte.
+// What differs per telegram is captured in a descriptor (aoosp_desc_t): the
+// telegram ID, the allowed addressing modes, and the layout of the command
+// and of the response telegram. A layout (aoosp_layout_t) gives the payload
+// size, and where each argument lives in the telegram (aoosp_field_t).
+//
+// All descriptors live in one const table, aoosp_desc[], so they are in flash.
+// One generic encoder, aoosp_codec_encode(), and one generic decoder,
+// aoosp_codec_decode(), serve all telegrams. They work on arrays of uint32_t
+// arguments; the aoosp_con_xxx() and aoosp_des_xxx() functions only marshal
+// their typed arguments to/from such an array, and add the checks that are
+// more than "does the argument fit in its field" (e.g. chn being 0, 1 or 2).
+// A few telegrams carry byte buffers (I2C write, OTP, test password);
+// their con/des functions use the codec building blocks and copy the buffer.
+// A response is checked (size, header, CRC) in one pass by aoosp_codec_validate(),
+// which also returns the decoded header (aoosp_hdr_t); so layouts only describe
+// payload fields, and a header field like 'last' of INIT comes from the header.
+// The broadcast form of the telegrams without payload is precomputed at compile
+// time (aoosp_codec_bcast[], see AOOSP_TELE_CONST0), so those skip encoding and CRC.
+//
+// A field is a slice of an argument: 'width' bits, starting at bit 'lo' of
+// argument 'arg'. The field is stored in the telegram with its msb at bit
+// position 'pos', where position 0 is the msb of data[0]. The payload starts
+// at position 24; use AOOSP_FIELD() to specify a field by payload byte and bit.
+// Example: the 15 bit red PWM value of SETPWM is AOOSP_FIELD(0,0,15,0,6),
+// argument 0 bits 14..0, stored from payload byte 0 bit 6 onwards.
+
+
+// Addressing modes allowed for a telegram
+#define AOOSP_CAST_UNI   0x01 // unicast (or serialcast) addresses 001..3EF
+#define AOOSP_CAST_BROAD 0x02 // broadcast address 000
+#define AOOSP_CAST_MULTI 0x04 // multicast (group) addresses 3F0..3FE
+#define AOOSP_CAST_ALL   ( AOOSP_CAST_UNI | AOOSP_CAST_BROAD | AOOSP_CAST_MULTI )
+
+
+// A field: 'width' (1..16) bits from bit 'lo' of argument 'arg', msb at telegram bit position 'pos'
+typedef struct aoosp_field_s { uint8_t arg; uint8_t lo; uint8_t width; uint8_t pos; } aoosp_field_t;
+#define AOOSP_FIELD(arg,lo,width,byte,msb) { (arg), (lo), (width), 24+8*(byte)+7-(msb) } // field in payload 'byte', starting at bit 'msb'
+
+
+// The layout of a telegram: payload size and the fields in it
+#define AOOSP_LAYOUT_MAXFIELDS 6
+typedef struct aoosp_layout_s {
+  uint8_t       payloadsize;                    // size of the payload in bytes (0..8)
+  uint8_t       numfields;                      // number of used entries in fields[]
+  aoosp_field_t fields[AOOSP_LAYOUT_MAXFIELDS]; // the fields (arguments) of the telegram
+} aoosp_layout_t;
+
+
+// Layouts of the command and response telegrams (several are shared between telegrams)
+static const aoosp_layout_t aoosp_layout_empty    = { 0, 0 };
+static const aoosp_layout_t aoosp_layout_byte     = { 1, 1, { AOOSP_FIELD(0,0,8,0,7) } };
+static const aoosp_layout_t aoosp_layout_word     = { 2, 1, { AOOSP_FIELD(0,0,16,0,7) } };
+static const aoosp_layout_t aoosp_layout_twobytes = { 2, 2, { AOOSP_FIELD(0,0,8,0,7), AOOSP_FIELD(1,0,8,1,7) } };
+static const aoosp_layout_t aoosp_layout_init     = { 2, 2, { AOOSP_FIELD(1,0,8,0,7), AOOSP_FIELD(2,0,8,1,7) } }; // 'last' (arg 0) is the header address, see aoosp_hdr_t
+static const aoosp_layout_t aoosp_layout_id       = { 4, 2, { AOOSP_FIELD(0,16,16,0,7), AOOSP_FIELD(0,0,16,2,7) } };
+static const aoosp_layout_t aoosp_layout_tinfo    = { 2, 2, { AOOSP_FIELD(0,0,8,1,7), AOOSP_FIELD(1,0,8,0,7) } };
+static const aoosp_layout_t aoosp_layout_mult     = { 2, 1, { AOOSP_FIELD(0,0,15,0,6) } };
+static const aoosp_layout_t aoosp_layout_i2cread8 = { 3, 3, { AOOSP_FIELD(0,0,7,0,7), AOOSP_FIELD(1,0,8,1,7), AOOSP_FIELD(2,0,8,2,7) } };
+static const aoosp_layout_t aoosp_layout_i2cread12= { 3, 3, { AOOSP_FIELD(0,0,7,0,7), AOOSP_FIELD(1,0,12,1,7), AOOSP_FIELD(2,0,4,2,3) } };
+static const aoosp_layout_t aoosp_layout_i2cwrite8= { 2, 2, { AOOSP_FIELD(0,0,7,0,7), AOOSP_FIELD(1,0,8,1,7) } };  // followed by the bytes to write
+static const aoosp_layout_t aoosp_layout_i2cwrite12={ 3, 2, { AOOSP_FIELD(0,0,7,0,7), AOOSP_FIELD(1,0,12,1,3) } }; // followed by the bytes to write
+static const aoosp_layout_t aoosp_layout_buf8     = { 8, 0 }; // I2C read buffer or OTP row, copied by the caller
+static const aoosp_layout_t aoosp_layout_pwm      = { 6, 6, { AOOSP_FIELD(0,0,15,0,6), AOOSP_FIELD(1,0,15,2,6), AOOSP_FIELD(2,0,15,4,6),
+                                                              AOOSP_FIELD(3,2,1,0,7),  AOOSP_FIELD(3,1,1,2,7),  AOOSP_FIELD(3,0,1,4,7) } };
+static const aoosp_layout_t aoosp_layout_pwmchn   = { 6, 3, { AOOSP_FIELD(0,0,16,0,7), AOOSP_FIELD(1,0,16,2,7), AOOSP_FIELD(2,0,16,4,7) } };
+static const aoosp_layout_t aoosp_layout_setpwmchn= { 8, 5, { AOOSP_FIELD(0,0,8,0,7),  AOOSP_FIELD(1,0,8,1,7),
+                                                              AOOSP_FIELD(2,0,16,2,7), AOOSP_FIELD(3,0,16,4,7), AOOSP_FIELD(4,0,16,6,7) } };
+static const aoosp_layout_t aoosp_layout_curchn   = { 2, 4, { AOOSP_FIELD(0,0,4,0,7),  AOOSP_FIELD(1,0,4,0,3),  AOOSP_FIELD(2,0,4,1,7), AOOSP_FIELD(3,0,4,1,3) } };
+static const aoosp_layout_t aoosp_layout_setcurchn= { 3, 5, { AOOSP_FIELD(0,0,8,0,7),  AOOSP_FIELD(1,0,3,1,6),
+                                                              AOOSP_FIELD(2,0,4,1,3),  AOOSP_FIELD(3,0,4,2,7),  AOOSP_FIELD(4,0,4,2,3) } };
+static const aoosp_layout_t aoosp_layout_i2ccfg   = { 1, 2, { AOOSP_FIELD(0,0,4,0,7),  AOOSP_FIELD(1,0,4,0,3) } };
+static const aoosp_layout_t aoosp_layout_readotp  = { 1, 1, { AOOSP_FIELD(0,0,5,0,4) } };
+static const aoosp_layout_t aoosp_layout_setotp   = { 8, 1, { AOOSP_FIELD(0,0,5,7,4) } }; // preceded by the (reversed) OTP bytes
+static const aoosp_layout_t aoosp_layout_testpw   = { 6, 0 }; // password, copied by the caller
+
+
+// The descriptor of a telegram
+typedef struct aoosp_desc_s {
+  uint8_t                tid;  // telegram ID
+  uint8_t                cast; // allowed addressing modes (AOOSP_CAST_XXX)
+  const aoosp_layout_t * cmd;  // layout of the command telegram
+  const aoosp_layout_t * resp; // layout of the response telegram, 0 when there is no response
+} aoosp_desc_t;
+
+
+// Index in the descriptor table aoosp_desc[]
+// It is also stored in log records (aoosp_logrec_t.ix), so tools/aoosp_logdec.c has the same list: only append.
+typedef enum aoosp_ix_e {
+  AOOSP_IX_RESET,       AOOSP_IX_CLRERROR,    AOOSP_IX_INITBIDIR,   AOOSP_IX_INITLOOP,
+  AOOSP_IX_GOSLEEP,     AOOSP_IX_GOACTIVE,    AOOSP_IX_GODEEPSLEEP, AOOSP_IX_IDENTIFY,
+  AOOSP_IX_ASKTINFO,    AOOSP_IX_ASKTINFO_INIT,AOOSP_IX_READMULT,   AOOSP_IX_SETMULT,
+  AOOSP_IX_SYNC,        AOOSP_IX_IDLE,        AOOSP_IX_FOUNDRY,     AOOSP_IX_CUST,
+  AOOSP_IX_BURN,        AOOSP_IX_AREAD,       AOOSP_IX_LOAD,        AOOSP_IX_GLOAD,
+  AOOSP_IX_I2CREAD8,    AOOSP_IX_I2CREAD12,   AOOSP_IX_I2CWRITE8,   AOOSP_IX_I2CWRITE12,
+  AOOSP_IX_READLAST,    AOOSP_IX_GOACTIVE_SR, AOOSP_IX_READSTAT,    AOOSP_IX_READTEMPSTAT,
+  AOOSP_IX_READCOMST,   AOOSP_IX_READLEDST,   AOOSP_IX_READLEDSTCHN,AOOSP_IX_READTEMP,
+  AOOSP_IX_READSETUP,   AOOSP_IX_SETSETUP,    AOOSP_IX_READPWM,     AOOSP_IX_READPWMCHN,
+  AOOSP_IX_SETPWM,      AOOSP_IX_SETPWMCHN,   AOOSP_IX_READCURCHN,  AOOSP_IX_SETCURCHN,
+  AOOSP_IX_READADC,     AOOSP_IX_SETADC,      AOOSP_IX_READI2CCFG,  AOOSP_IX_SETI2CCFG,
+  AOOSP_IX_READOTP,     AOOSP_IX_SETOTP,      AOOSP_IX_SETTESTDATA, AOOSP_IX_READADCDAT,
+  AOOSP_IX_SETTESTPW,   AOOSP_IX_SETTESTPW_SR,
+} aoosp_ix_t;
+
+
+// The descriptor table. Telegrams with a response are unicast only (a broadcast or multicast gets no response).
+static const aoosp_desc_t aoosp_desc[] = {
+  [AOOSP_IX_RESET        ] = { 0x00, AOOSP_CAST_ALL, &aoosp_layout_empty    , 0                      },
+  [AOOSP_IX_CLRERROR     ] = { 0x01, AOOSP_CAST_ALL, &aoosp_layout_empty    , 0                      },
+  [AOOSP_IX_INITBIDIR    ] = { 0x02, AOOSP_CAST_UNI, &aoosp_layout_empty    , &aoosp_layout_init     }, // last, temp, stat
+  [AOOSP_IX_INITLOOP     ] = { 0x03, AOOSP_CAST_UNI, &aoosp_layout_empty    , &aoosp_layout_init     }, // last, temp, stat
+  [AOOSP_IX_GOSLEEP      ] = { 0x04, AOOSP_CAST_ALL, &aoosp_layout_empty    , 0                      },
+  [AOOSP_IX_GOACTIVE     ] = { 0x05, AOOSP_CAST_ALL, &aoosp_layout_empty    , 0                      },
+  [AOOSP_IX_GODEEPSLEEP  ] = { 0x06, AOOSP_CAST_ALL, &aoosp_layout_empty    , 0                      },
+  [AOOSP_IX_IDENTIFY     ] = { 0x07, AOOSP_CAST_UNI, &aoosp_layout_empty    , &aoosp_layout_id       }, // id
+  [AOOSP_IX_ASKTINFO     ] = { 0x0A, AOOSP_CAST_UNI, &aoosp_layout_empty    , &aoosp_layout_tinfo    }, // tmin, tmax
+  [AOOSP_IX_ASKTINFO_INIT] = { 0x0A, AOOSP_CAST_UNI, &aoosp_layout_tinfo    , &aoosp_layout_tinfo    }, // tmin, tmax
+  [AOOSP_IX_READMULT     ] = { 0x0C, AOOSP_CAST_UNI, &aoosp_layout_empty    , &aoosp_layout_word     }, // groups
+  [AOOSP_IX_SETMULT      ] = { 0x0D, AOOSP_CAST_ALL, &aoosp_layout_mult     , 0                      }, // groups
+  [AOOSP_IX_SYNC         ] = { 0x0F, AOOSP_CAST_ALL, &aoosp_layout_empty    , 0                      },
+  [AOOSP_IX_IDLE         ] = { 0x11, AOOSP_CAST_ALL, &aoosp_layout_empty    , 0                      },
+  [AOOSP_IX_FOUNDRY      ] = { 0x12, AOOSP_CAST_ALL, &aoosp_layout_empty    , 0                      },
+  [AOOSP_IX_CUST         ] = { 0x13, AOOSP_CAST_ALL, &aoosp_layout_empty    , 0                      },
+  [AOOSP_IX_BURN         ] = { 0x14, AOOSP_CAST_ALL, &aoosp_layout_empty    , 0                      },
+  [AOOSP_IX_AREAD        ] = { 0x15, AOOSP_CAST_ALL, &aoosp_layout_empty    , 0                      },
+  [AOOSP_IX_LOAD         ] = { 0x16, AOOSP_CAST_ALL, &aoosp_layout_empty    , 0                      },
+  [AOOSP_IX_GLOAD        ] = { 0x17, AOOSP_CAST_ALL, &aoosp_layout_empty    , 0                      },
+  [AOOSP_IX_I2CREAD8     ] = { 0x18, AOOSP_CAST_ALL, &aoosp_layout_i2cread8 , 0                      }, // daddr7, raddr, count
+  [AOOSP_IX_I2CREAD12    ] = { 0x18, AOOSP_CAST_ALL, &aoosp_layout_i2cread12, 0                      }, // daddr7, raddr, count
+  [AOOSP_IX_I2CWRITE8    ] = { 0x19, AOOSP_CAST_ALL, &aoosp_layout_i2cwrite8, 0                      }, // daddr7, raddr, buf
+  [AOOSP_IX_I2CWRITE12   ] = { 0x19, AOOSP_CAST_ALL, &aoosp_layout_i2cwrite12,0                      }, // daddr7, raddr, buf
+  [AOOSP_IX_READLAST     ] = { 0x1E, AOOSP_CAST_UNI, &aoosp_layout_empty    , &aoosp_layout_buf8     }, // buf
+  [AOOSP_IX_GOACTIVE_SR  ] = { 0x25, AOOSP_CAST_UNI, &aoosp_layout_empty    , &aoosp_layout_twobytes }, // temp, stat
+  [AOOSP_IX_READSTAT     ] = { 0x40, AOOSP_CAST_UNI, &aoosp_layout_empty    , &aoosp_layout_byte     }, // stat
+  [AOOSP_IX_READTEMPSTAT ] = { 0x42, AOOSP_CAST_UNI, &aoosp_layout_empty    , &aoosp_layout_twobytes }, // temp, stat
+  [AOOSP_IX_READCOMST    ] = { 0x44, AOOSP_CAST_UNI, &aoosp_layout_empty    , &aoosp_layout_byte     }, // com
+  [AOOSP_IX_READLEDST    ] = { 0x46, AOOSP_CAST_UNI, &aoosp_layout_empty    , &aoosp_layout_byte     }, // ledst
+  [AOOSP_IX_READLEDSTCHN ] = { 0x46, AOOSP_CAST_UNI, &aoosp_layout_byte     , &aoosp_layout_byte     }, // chn -> ledst
+  [AOOSP_IX_READTEMP     ] = { 0x48, AOOSP_CAST_UNI, &aoosp_layout_empty    , &aoosp_layout_byte     }, // temp
+  [AOOSP_IX_READSETUP    ] = { 0x4C, AOOSP_CAST_UNI, &aoosp_layout_empty    , &aoosp_layout_byte     }, // flags
+  [AOOSP_IX_SETSETUP     ] = { 0x4D, AOOSP_CAST_ALL, &aoosp_layout_byte     , 0                      }, // flags
+  [AOOSP_IX_READPWM      ] = { 0x4E, AOOSP_CAST_UNI, &aoosp_layout_empty    , &aoosp_layout_pwm      }, // red, green, blue, daytimes
+  [AOOSP_IX_READPWMCHN   ] = { 0x4E, AOOSP_CAST_UNI, &aoosp_layout_byte     , &aoosp_layout_pwmchn   }, // chn -> red, green, blue
+  [AOOSP_IX_SETPWM       ] = { 0x4F, AOOSP_CAST_ALL, &aoosp_layout_pwm      , 0                      }, // red, green, blue, daytimes
+  [AOOSP_IX_SETPWMCHN    ] = { 0x4F, AOOSP_CAST_ALL, &aoosp_layout_setpwmchn, 0                      }, // chn, dummy, red, green, blue
+  [AOOSP_IX_READCURCHN   ] = { 0x50, AOOSP_CAST_UNI, &aoosp_layout_byte     , &aoosp_layout_curchn   }, // chn -> flags, rcur, gcur, bcur
+  [AOOSP_IX_SETCURCHN    ] = { 0x51, AOOSP_CAST_ALL, &aoosp_layout_setcurchn, 0                      }, // chn, flags, rcur, gcur, bcur
+  [AOOSP_IX_READADC      ] = { 0x54, AOOSP_CAST_UNI, &aoosp_layout_empty    , &aoosp_layout_byte     }, // flags
+  [AOOSP_IX_SETADC       ] = { 0x55, AOOSP_CAST_ALL, &aoosp_layout_byte     , 0                      }, // flags
+  [AOOSP_IX_READI2CCFG   ] = { 0x56, AOOSP_CAST_UNI, &aoosp_layout_empty    , &aoosp_layout_i2ccfg   }, // flags, speed
+  [AOOSP_IX_SETI2CCFG    ] = { 0x57, AOOSP_CAST_ALL, &aoosp_layout_i2ccfg   , 0                      }, // flags, speed
+  [AOOSP_IX_READOTP      ] = { 0x58, AOOSP_CAST_UNI, &aoosp_layout_readotp  , &aoosp_layout_buf8     }, // otpaddr -> buf
+  [AOOSP_IX_SETOTP       ] = { 0x59, AOOSP_CAST_ALL, &aoosp_layout_setotp   , 0                      }, // otpaddr, buf
+  [AOOSP_IX_SETTESTDATA  ] = { 0x5B, AOOSP_CAST_ALL, &aoosp_layout_word     , 0                      }, // data
+  [AOOSP_IX_READADCDAT   ] = { 0x5C, AOOSP_CAST_UNI, &aoosp_layout_empty    , &aoosp_layout_word     }, // adcdat
+  [AOOSP_IX_SETTESTPW    ] = { 0x5F, AOOSP_CAST_ALL, &aoosp_layout_testpw   , 0                      }, // pw
+  [AOOSP_IX_SETTESTPW_SR ] = { 0x7F, AOOSP_CAST_UNI, &aoosp_layout_testpw   , &aoosp_layout_twobytes }, // pw -> temp, stat
+};
+
+
+// Returns 1 iff the addressing mode of `addr` is allowed for telegram `desc`
+static int aoosp_codec_castok(const aoosp_desc_t * desc, uint16_t addr) {
+  if( AOOSP_ADDR_ISUNICAST(addr)   ) return (desc->cast & AOOSP_CAST_UNI  ) != 0;
+  if( AOOSP_ADDR_ISBROADCAST(addr) ) return (desc->cast & AOOSP_CAST_BROAD) != 0;
+  if( OAOSP_ADDR_ISMULTICAST(addr) ) return (desc->cast & AOOSP_CAST_MULTI) != 0;
+  return 0;
+}
+
+
+// The payload-less telegrams as broadcast (boot and repair sequences), complete with CRC, in flash.
+// aoosp_codec_encode() copies these instead of encoding; zero entries have no precomputed telegram.
+#define AOOSP_CODEC_BCAST(tid) AOOSP_TELE_CONST0(AOOSP_ADDR_BROADCAST,tid)
+static const uint8_t aoosp_codec_bcast[AOOSP_IX_GLOAD+1][4] = {
+  [AOOSP_IX_RESET        ] = AOOSP_CODEC_BCAST(0x00),
+  [AOOSP_IX_CLRERROR     ] = AOOSP_CODEC_BCAST(0x01),
+  [AOOSP_IX_GOSLEEP      ] = AOOSP_CODEC_BCAST(0x04),
+  [AOOSP_IX_GOACTIVE     ] = AOOSP_CODEC_BCAST(0x05),
+  [AOOSP_IX_GODEEPSLEEP  ] = AOOSP_CODEC_BCAST(0x06),
+  [AOOSP_IX_SYNC         ] = AOOSP_CODEC_BCAST(0x0F),
+  [AOOSP_IX_IDLE         ] = AOOSP_CODEC_BCAST(0x11),
+  [AOOSP_IX_FOUNDRY      ] = AOOSP_CODEC_BCAST(0x12),
+  [AOOSP_IX_CUST         ] = AOOSP_CODEC_BCAST(0x13),
+  [AOOSP_IX_BURN         ] = AOOSP_CODEC_BCAST(0x14),
+  [AOOSP_IX_AREAD        ] = AOOSP_CODEC_BCAST(0x15),
+  [AOOSP_IX_LOAD         ] = AOOSP_CODEC_BCAST(0x16),
+  [AOOSP_IX_GLOAD        ] = AOOSP_CODEC_BCAST(0x17),
+};
+
+
+// Returns 1 iff none of the arguments `args` has bits outside the fields of `layout`
+static int aoosp_codec_argsok(const aoosp_layout_t * layout, const uint32_t * args) {
+  uint32_t masks[AOOSP_LAYOUT_MAXFIELDS] = {0};
+  int      numargs = 0;
+  for( int i=0; i<layout->numfields; i++ ) {
+    const aoosp_field_t * f = &layout->fields[i];
+    masks[f->arg] |= (uint32_t)BITS_MASK(f->width) << f->lo;
+    if( f->arg>=numargs ) numargs = f->arg+1;
+  }
+  for( int a=0; a<numargs; a++ ) if( args[a] & ~masks[a] ) return 0;
+  return 1;
+}
+
+
+// Sets size and header of `tele` (telegram `tid`, to `addr`, with `payloadsize` bytes) and clears the payload
+static void aoosp_codec_begin(aoosp_tele_t * tele, uint8_t tid, uint16_t addr, uint8_t payloadsize) {
+  tele->size    = payloadsize+4;
+  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
+  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
+  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
+  memset( &tele->data[3], 0, payloadsize );
+}
+
+
+// Stores the arguments `args` in the fields of `tele`, as specified by `layout` (fields must be zero)
+static void aoosp_codec_pack(aoosp_tele_t * tele, const aoosp_layout_t * layout, const uint32_t * args) {
+  for( int i=0; i<layout->numfields; i++ ) {
+    const aoosp_field_t * f = &layout->fields[i];
+    int      end = f->pos + f->width; // position of the bit after the lsb of the field
+    uint32_t val = BITS_SLICE(args[f->arg],f->lo,f->lo+f->width) << ((8-end%8)%8);
+    for( int b=(end-1)/8; b>=f->pos/8; b-- ) { tele->data[b] |= (uint8_t)val; val >>= 8; }
+  }
+}
+
+
+// Appends the CRC to `tele` (payload must be complete)
+static void aoosp_codec_end(aoosp_tele_t * tele) {
+  tele->data[tele->size-1] = aoosp_crc( tele->data , tele->size - 1 );
+}
+
+
+// Builds command telegram `ix` to `addr` with `args` in `tele`; sets `respsize` (if not NULL) to the size of the response telegram
+static aoresult_t aoosp_codec_encode(aoosp_tele_t * tele, aoosp_ix_t ix, uint16_t addr, const uint32_t * args, uint8_t * respsize) {
+  const aoosp_desc_t * desc = &aoosp_desc[ix];
+  // Check input parameters
+  if( tele==0                             ) return aoresult_outargnull;
+  if( !aoosp_codec_castok(desc,addr)      ) return aoresult_osp_addr;
+  if( !aoosp_codec_argsok(desc->cmd,args) ) return aoresult_osp_arg;
+  // Build telegram
+  if( addr==AOOSP_ADDR_BROADCAST && ix<=AOOSP_IX_GLOAD && aoosp_codec_bcast[ix][0]!=0 ) {
+    memcpy(tele->data, aoosp_codec_bcast[ix], 4);
+    tele->size = 4;
+    return aoresult_ok; // no response (broadcast)
+  }
+  aoosp_codec_begin(tele, desc->tid, addr, desc->cmd->payloadsize);
+  aoosp_codec_pack(tele, desc->cmd, args);
+  aoosp_codec_end(tele);
+  if( respsize && desc->resp ) *respsize = 4+desc->resp->payloadsize;
+  return aoresult_ok;
+}
+
+
+// The header of a response telegram, as decoded by aoosp_codec_validate()
+typedef struct aoosp_hdr_s {
+  uint16_t addr;        // address field (e.g. 'last' in INIT responses)
+  uint8_t  psi;         // payload size indicator
+  uint8_t  tid;         // telegram ID
+  uint8_t  payloadsize; // payload size in bytes
+} aoosp_hdr_t;
+
+
+// The header (data[0..2]) as one 24 bit word: preamble 23..20, address 19..10, PSI 9..7, TID 6..0.
+// For a response, all header bits except the address are known in advance.
+#define AOOSP_HDR_WORD(tele)     ( (uint32_t)(tele)->data[0]<<16 | (uint32_t)(tele)->data[1]<<8 | (tele)->data[2] )
+#define AOOSP_HDR_PREAMBLE       0xF00000
+#define AOOSP_HDR_PSI            0x000380
+#define AOOSP_HDR_TID            0x00007F
+
+
+// Checks that `tele` is a valid response (size, PSI, preamble, TID and CRC) to command telegram `ix`.
+// Fused: the header is compared as one word against the expected one, and the CRC is computed over the
+// whole telegram (CRC over data plus CRC byte is 0), so an accepted telegram costs one branch after the
+// size check. Only a rejected telegram is inspected further, to report the same error as a check per field
+// would (in order size, PSI, preamble, TID, CRC). When `hdr` is not NULL, it receives the decoded header.
+static aoresult_t aoosp_codec_validate(const aoosp_tele_t * tele, aoosp_ix_t ix, aoosp_hdr_t * hdr) {
+  const aoosp_desc_t * desc = &aoosp_desc[ix];
+  uint8_t  payloadsize = desc->resp->payloadsize;
+  if( tele->size!=4+payloadsize ) return aoresult_osp_size;
+  uint32_t word = AOOSP_HDR_WORD(tele);
+  uint32_t diff = word ^ ( 0xA00000 | (uint32_t)SIZE2PSI(payloadsize)<<7 | desc->tid );
+  uint8_t  crc  = aoosp_crc(tele->data,tele->size);
+  if( ( diff & (AOOSP_HDR_PREAMBLE|AOOSP_HDR_PSI|AOOSP_HDR_TID) ) | crc ) {
+    if( diff & AOOSP_HDR_PSI      ) return aoresult_osp_psi;
+    if( diff & AOOSP_HDR_PREAMBLE ) return aoresult_osp_preamble;
+    if( diff & AOOSP_HDR_TID      ) return aoresult_osp_tid;
+    return aoresult_osp_crc;
+  }
+  if( hdr ) {
+    hdr->addr        = BITS_SLICE(word,10,20);
+    hdr->psi         = BITS_SLICE(word,7,10);
+    hdr->tid         = BITS_SLICE(word,0,7);
+    hdr->payloadsize = payloadsize;
+  }
+  return aoresult_ok;
+}
+
+
+// Checks response `tele` to command telegram `ix` and extracts its payload fields into `res`, and (if not NULL) its header into `hdr`
+static aoresult_t aoosp_codec_decode(const aoosp_tele_t * tele, aoosp_ix_t ix, uint32_t * res, aoosp_hdr_t * hdr) {
+  const aoosp_layout_t * layout = aoosp_desc[ix].resp;
+  aoresult_t result = aoosp_codec_validate(tele,ix,hdr);
+  if( result!=aoresult_ok ) return result;
+  for( int i=0; i<layout->numfields; i++ ) res[layout->fields[i].arg] = 0;
+  for( int i=0; i<layout->numfields; i++ ) {
+    const aoosp_field_t * f = &layout->fields[i];
+    int      end = f->pos + f->width; // position of the bit after the lsb of the field
+    uint32_t val = 0;
+    for( int b=f->pos/8; b<=(end-1)/8; b++ ) val = val<<8 | tele->data[b];
+    res[f->arg] |= BITS_SLICE(val>>((8-end%8)%8),0,f->width) << f->lo;
+  }
+  return aoresult_ok;
+}
+
+
+// === LOG RING ===========================================
+
+
+// Log ring
+// ========
+// With log level aoosp_loglevel_ring, every aoosp_send_xxx() appends one
+// aoosp_logrec_t to a ring of AOOSP_LOGRING_SIZE records, instead of printing.
+// The ring has one producer (the task sending telegrams) and one consumer
+// (the task calling aoosp_logring_drain() or aoosp_logring_get()). It is
+// lock free: the producer only writes `head`, the consumer only writes `tail`,
+// and a memory barrier orders the record copy and the index update.
+// When the ring is full, the new record is dropped (and counted); the
+// sequence numbers of the records show where records went missing.
+//
+// aoosp_logring_drain() prints a record as one line, all fields hex:
+//   #osplog seq time addr ix con spi des tele resp
+//   #osplog 0002 00000000 001 03 00 00 00 A0040386 A0090300506D
+// An empty tele or resp is printed as "-".
+
+
+#if AOOSP_LOG_ENABLED
+
+static aoosp_logrec_t    aoosp_logring[AOOSP_LOGRING_SIZE];
+static volatile uint32_t aoosp_logring_head; // number of records ever put (only written by the producer)
+static volatile uint32_t aoosp_logring_tail; // number of records ever taken (only written by the consumer)
+static uint32_t          aoosp_logring_lostcount;
+static uint16_t          aoosp_logring_seq;
+static uint32_t       (* aoosp_logring_clock)(void);
+
+
+// The default clock of the log ring: us from the DWT cycle counter (enabled by aospi_init).
+// Only the producer calls it, so it can extend the 32 bit counter; a gap between two
+// records longer than one counter period (about 4s at 996MHz) is shortened by whole periods.
+static uint32_t aoosp_logring_clock_us(void) {
+  static uint32_t cycles0; // cycle count at the previous call
+  static uint32_t rest;    // cycles not yet counted as us
+  static uint32_t us;
+  uint32_t cycles  = DWT->CYCCNT;
+  uint32_t percycle= SystemCoreClock/1000000;
+  uint64_t delta   = (uint64_t)(uint32_t)(cycles-cycles0) + rest;
+  cycles0= cycles;
+  us  += (uint32_t)(delta/percycle);
+  rest = (uint32_t)(delta%percycle);
+  return us;
+}
+
+
+#if defined(SDK_OS_FREE_RTOS)
+static TaskHandle_t aoosp_logring_taskhandle;
+
+
+// The background task: prints the log ring, and sleeps while it is empty
+static void aoosp_logring_task(void * arg) {
+  (void)arg;
+  while( 1 ) {
+    if( aoosp_logring_drain(AOOSP_LOGRING_SIZE)==0 ) vTaskDelay(pdMS_TO_TICKS(AOOSP_LOGRING_TASK_MS));
+  }
+}
+#endif
+
+
+/*!
+    @brief  Prepares the log ring: installs the us clock for the time stamps,
+            and in a FreeRTOS build starts the task that drains the ring.
+    @note   Called by aoosp_init(); the task runs once the scheduler runs.
+    @note   The task has priority tskIDLE_PRIORITY+1, so it prints when no 
+            other task is busy; it is the only consumer of the ring (do not
+            mix it with 'osp log drain').
+    @note   Without FreeRTOS, call aoosp_logring_drain() from the main loop.
+*/
+void aoosp_logring_init() {
+  aoosp_logring_clock= aoosp_logring_clock_us;
+  #if defined(SDK_OS_FREE_RTOS)
+  if( aoosp_logring_taskhandle==0 && xTaskCreate(aoosp_logring_task, "osplog", AOOSP_LOGRING_TASK_STACK, 0, tskIDLE_PRIORITY+1, &aoosp_logring_taskhandle)!=pdPASS ) {
+    aoosp_logring_taskhandle= 0;
+    PRINTF("osp: no log ring task (out of memory)\n");
+  }
+  #endif
+}
+
+
+/*!
+    @brief  Returns if the background task drains the log ring.
+    @return 1 iff the task of aoosp_logring_init() exists and the scheduler 
+            runs; then no other code may take records from the ring.
+*/
+int aoosp_logring_background() {
+  #if defined(SDK_OS_FREE_RTOS)
+  return aoosp_logring_taskhandle!=0 && xTaskGetSchedulerState()==taskSCHEDULER_RUNNING;
+  #else
+  return 0;
+  #endif
+}
+
+
+/*!
+    @brief  Sets the clock that time stamps the records in the log ring.
+    @param  clock
+            Function returning the current time (unit is up to the caller,
+            e.g. a cycle counter or microseconds), or 0 for no time stamps.
+    @note   aoosp_logring_init() installs a us clock (DWT cycle counter).
+    @note   The clock is called for every telegram sent when the log level 
+            is aoosp_loglevel_ring, so it should be cheap.
+*/
+void aoosp_logring_clock_set(uint32_t (*clock)(void)) {
+  aoosp_logring_clock = clock;
+}
+
+
+// Appends a record for telegram `ix` sent to `addr` to the log ring (`tele` may be 0 when not sent, `resp` is 0 when there is no response)
+static void aoosp_logring_put(aoosp_ix_t ix, uint16_t addr, const aoosp_tele_t * tele, const aoosp_tele_t * resp, aoresult_t con_result, aoresult_t spi_result, aoresult_t des_result) {
+  uint16_t seq = aoosp_logring_seq++;
+  uint32_t head= aoosp_logring_head;
+  if( head - aoosp_logring_tail >= AOOSP_LOGRING_SIZE ) { aoosp_logring_lostcount++; return; }
+  aoosp_logrec_t * rec = &aoosp_logring[head & (AOOSP_LOGRING_SIZE-1)];
+  rec->time      = aoosp_logring_clock ? aoosp_logring_clock() : 0;
+  rec->seq       = seq;
+  rec->addr      = addr;
+  rec->ix        = ix;
+  rec->con_result= con_result;
+  rec->spi_result= spi_result;
+  rec->des_result= des_result;
+  rec->telesize  = con_result==aoresult_ok && tele!=0 ? tele->size : 0;
+  rec->respsize  = con_result==aoresult_ok && spi_result==aoresult_ok && resp!=0 ? resp->size : 0;
+  if( rec->telesize>0 ) memcpy( rec->tele, tele->data, rec->telesize );
+  if( rec->respsize>0 ) memcpy( rec->resp, resp->data, rec->respsize );
+  __sync_synchronize(); // record complete before it is published
+  aoosp_logring_head = head+1;
+}
+
+
+/*!
+    @brief  Takes the oldest record from the log ring.
+    @param  rec
+            Output parameter receiving the record.
+    @return 1 if a record was taken, 0 if the ring was empty.
+    @note   Records are only added with log level aoosp_loglevel_ring.
+    @note   May run concurrently with the (single) task sending telegrams,
+            but not with another consumer.
+*/
+int aoosp_logring_get(aoosp_logrec_t * rec) {
+  uint32_t tail= aoosp_logring_tail;
+  if( rec==0 || tail==aoosp_logring_head ) return 0;
+  __sync_synchronize(); // read the record after seeing it published
+  *rec = aoosp_logring[tail & (AOOSP_LOGRING_SIZE-1)];
+  __sync_synchronize(); // record copied before its slot is released
+  aoosp_logring_tail = tail+1;
+  return 1;
+}
+
+
+// Prints `size` bytes of `buf` in hex without separators, or "-" when size is 0
+static void aoosp_logring_prthex(const uint8_t * buf, int size) {
+  if( size==0 ) PRINTF(" -");
+  else PRINTF(" ");
+  for( int i=0; i<size; i++ ) PRINTF("%02X",buf[i]);
+}
+
+
+/*!
+    @brief  Prints records from the log ring, one "#osplog" line per record.
+    @param  max
+            Maximum number of records to print.
+    @return Number of records printed (0 when the ring is empty).
+    @note   Called by the task started in aoosp_logring_init() (FreeRTOS),
+            else from the main loop or with 'osp log drain'; the host tool
+            tools/aoosp_logdec.c decodes the printed lines into the human 
+            readable log format.
+    @note   See aoosp_logring_get() for concurrency.
+*/
+int aoosp_logring_drain(int max) {
+  aoosp_logrec_t rec;
+  int count = 0;
+  while( count<max && aoosp_logring_get(&rec) ) {
+    PRINTF("#osplog %04X %08lX %03X %02X %02X %02X %02X", rec.seq, (unsigned long)rec.time, rec.addr, rec.ix, rec.con_result, rec.spi_result, rec.des_result);
+    aoosp_logring_prthex(rec.tele,rec.telesize);
+    aoosp_logring_prthex(rec.resp,rec.respsize);
+    PRINTF("\n");
+    count++;
+  }
+  return count;
+}
+
+
+/*!
+    @brief  Returns the number of records that were lost because the log ring was full.
+    @return Number of lost records since startup.
+    @note   Drain more often, or increase AOOSP_LOGRING_SIZE, when this is not 0.
+*/
+uint32_t aoosp_logring_lost() {
+  return aoosp_logring_lostcount;
+}
+
+#endif // AOOSP_LOG_ENABLED
+
+
 // === TELEGRAMS ==========================================
 
 
@@ -113,10 +643,13 @@ aoosp_loglevel_t aoosp_loglevel_get() {
 //
 //
 // The first function constructs a telegram, eg converts (int) arguments to a byte array.
+// It hands its arguments to the generic encoder aoosp_codec_encode() (see CODEC),
+// and only adds checks that go beyond "argument fits in its field".
 //   static aoresult_t aoosp_con_xxx(aoosp_tele_t * tele, uint16_t addr, uintx_t arg0, uintx_t arg1, ... , uint8_t * respsize)
 //
 //   - aoosp_tele_t * tele   (OUT) caller allocated (content irrelevant), filled with preamble/addr/tid/args/aoosp_crc on exit
-//   - uint16_t addr         (IN)  is the address of the destination node (unicast), or 0 (broadcast), or a group address (3F0..2FE)
+//   - uint16_t addr         (IN)  is the address of the destination node (unicast), or 0 (broadcast), or a group address (3F0..3FE)
+//                                 telegrams with a response only allow unicast (see 'cast' in aoosp_desc[])
 //   - uintx_t arg0          (IN)  telegram xxx specific argument
 //   - uintx_t arg1          (IN)  telegram xxx specific argument
 //   - ...                   (IN)  ...
@@ -127,6 +660,7 @@ aoosp_loglevel_t aoosp_loglevel_get() {
 //
 //
 // The second function destructs a (response) telegram, e.g. converts a byte array to (int) result fields
+// It uses the generic decoder aoosp_codec_decode(), and copies the results to its output parameters.
 //   static aoresult_t aoosp_des_xxx(aoosp_tele_t * tele, uintx_t * res0, uintx_t * res1, ... )
 //   - aoosp_tele_t * tele   (IN)  caller allocated, checked for correct telegram id, size and CRC
 //
@@ -134,7 +668,7 @@ aoosp_loglevel_t aoosp_loglevel_get() {
 //   - uintx_t * res1        (OUT) set to response field (telegram xxx specific response)
 //   - ...                   (OUT) ...
 //
-//   - returns aoresult_ok if all ok, or aoresult_osp_preamble, aoresult_osp_tid, aoresult_osp_size, aoresult_osp_crc, or aoresult_outargnull.
+//   - returns aoresult_ok if all ok, or aoresult_osp_size, aoresult_osp_psi, aoresult_osp_preamble, aoresult_osp_tid, aoresult_osp_crc (see aoosp_codec_validate()), or aoresult_outargnull.
 //
 //
 // The third function is a helper.
@@ -170,6 +704,9 @@ aoosp_loglevel_t aoosp_loglevel_get() {
 //
 //   if(     result==aoresult_ok ) des_result = aoosp_des_xxx(...)
 //   if( des_result!=aoresult_ok ) result=des_result;
+//   if( des_result!=aoresult_ok ) aospi_stat_error(tele.data,tele.size,des_result);
+//
+// The last line counts rejected responses in the aospi telemetry.
 
 
 // ==========================================================================
@@ -177,25 +714,7 @@ aoosp_loglevel_t aoosp_loglevel_get() {
 
 
 static aoresult_t aoosp_con_reset(aoosp_tele_t * tele, uint16_t addr) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 0;
-  const uint8_t tid = 0x00; // RESET
-  //if( respsize ) *respsize = 4+0;
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_codec_encode(tele, AOOSP_IX_RESET, addr, 0, 0);
 }
 
 /*!
@@ -228,6 +747,7 @@ aoresult_t aoosp_send_reset(uint16_t addr) {
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_RESET, addr, &tele, 0, con_result, spi_result, aoresult_ok);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("reset(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -246,25 +766,7 @@ aoresult_t aoosp_send_reset(uint16_t addr) {
 
 
 static aoresult_t aoosp_con_clrerror(aoosp_tele_t * tele, uint16_t addr) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 0;
-  const uint8_t tid = 0x01; // CLRERROR
-  //if( respsize ) *respsize = 4+0;
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_codec_encode(tele, AOOSP_IX_CLRERROR, addr, 0, 0);
 }
 
 
@@ -293,6 +795,7 @@ aoresult_t aoosp_send_clrerror(uint16_t addr) {
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_CLRERROR, addr, &tele, 0, con_result, spi_result, aoresult_ok);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("clrerror(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -311,44 +814,17 @@ aoresult_t aoosp_send_clrerror(uint16_t addr) {
 
 
 static aoresult_t aoosp_con_initbidir(aoosp_tele_t * tele, uint16_t addr, uint8_t * respsize) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 0;
-  const uint8_t tid = 0x02; // INITBIDIR
-  if( respsize ) *respsize = 4+2; // temp, stat
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_codec_encode(tele, AOOSP_IX_INITBIDIR, addr, 0, respsize);
 }
 
 
 static aoresult_t aoosp_des_initbidir(aoosp_tele_t * tele, uint16_t * last, uint8_t * temp, uint8_t * stat) {
-  // Set constants
-  const uint8_t payloadsize = 2; // temp, stat
-  // Check telegram consistency
+  uint32_t    res[3];
+  aoosp_hdr_t hdr;
   if( tele==0 || last==0 || temp==0 || stat==0 ) return aoresult_outargnull;
-  if( tele->size!=4+payloadsize                ) return aoresult_osp_size;
-  if( TELEPSI(tele)!=SIZE2PSI(payloadsize)     ) return aoresult_osp_psi;
-  if( BITS_SLICE(tele->data[0],4,8)!=0xA       ) return aoresult_osp_preamble;
-  if( BITS_SLICE(tele->data[2],0,7)!=0x02      ) return aoresult_osp_tid;
-  if( aoosp_crc(tele->data,tele->size) != 0    ) return aoresult_osp_crc;
-
-  // Get fields
-  *last = BITS_SLICE(tele->data[0],0,4)<<6 | BITS_SLICE(tele->data[1],2,8);
-  *temp = tele->data[3];
-  *stat = tele->data[4];
-
+  aoresult_t result = aoosp_codec_decode(tele, AOOSP_IX_INITBIDIR, res, &hdr);
+  if( result!=aoresult_ok ) return result;
+  *last= hdr.addr; *temp= res[1]; *stat= res[2];
   return aoresult_ok;
 }
 
@@ -372,6 +848,9 @@ static aoresult_t aoosp_des_initbidir(aoosp_tele_t * tele, uint16_t * last, uint
             board, precede this call with a call to aospi_dirmux_set_bidir().
     @note   If there are branches, send INITBIDIR once for every branch,
             with the start address for that branch.
+    @note   Only unicast addresses are accepted; a broadcast or group
+            address gives aoresult_osp_addr (the response must come
+            from one node).
     @note   When logging enabled with aoosp_loglevel_set(), logs to Serial.
 */
 aoresult_t aoosp_send_initbidir(uint16_t addr, uint16_t * last, uint8_t * temp, uint8_t * stat) {
@@ -391,9 +870,11 @@ aoresult_t aoosp_send_initbidir(uint16_t addr, uint16_t * last, uint8_t * temp,
   if( spi_result!=aoresult_ok ) result= spi_result;
   if(     result==aoresult_ok ) des_result = aoosp_des_initbidir(&resp, last, temp, stat);
   if( des_result!=aoresult_ok ) result=des_result;
+  if( des_result!=aoresult_ok ) aospi_stat_error(tele.data,tele.size,des_result);
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_INITBIDIR, addr, &tele, &resp, con_result, spi_result, des_result);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("initbidir(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -417,44 +898,17 @@ aoresult_t aoosp_send_initbidir(uint16_t addr, uint16_t * last, uint8_t * temp,
 
 
 static aoresult_t aoosp_con_initloop(aoosp_tele_t * tele, uint16_t addr, uint8_t * respsize) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 0;
-  const uint8_t tid = 0x03; // INITLOOP
-  if( respsize ) *respsize = 4+2; // temp, stat
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_codec_encode(tele, AOOSP_IX_INITLOOP, addr, 0, respsize);
 }
 
 
 static aoresult_t aoosp_des_initloop(aoosp_tele_t * tele, uint16_t * last, uint8_t * temp, uint8_t * stat) {
-  // Set constants
-  const uint8_t payloadsize = 2; // temp, stat
-  // Check telegram consistency
+  uint32_t    res[3];
+  aoosp_hdr_t hdr;
   if( tele==0 || last==0 || temp==0 || stat==0 ) return aoresult_outargnull;
-  if( tele->size!=4+payloadsize                ) return aoresult_osp_size;
-  if( TELEPSI(tele)!=SIZE2PSI(payloadsize)     ) return aoresult_osp_psi;
-  if( BITS_SLICE(tele->data[0],4,8)!=0xA       ) return aoresult_osp_preamble;
-  if( BITS_SLICE(tele->data[2],0,7)!=0x03      ) return aoresult_osp_tid;
-  if( aoosp_crc(tele->data,tele->size) != 0    ) return aoresult_osp_crc;
-
-  // Get fields
-  *temp = tele->data[3];
-  *stat = tele->data[4];
-  *last = BITS_SLICE(tele->data[0],0,4)<<6 | BITS_SLICE(tele->data[1],2,8);
-
+  aoresult_t result = aoosp_codec_decode(tele, AOOSP_IX_INITLOOP, res, &hdr);
+  if( result!=aoresult_ok ) return result;
+  *last= hdr.addr; *temp= res[1]; *stat= res[2];
   return aoresult_ok;
 }
 
@@ -477,6 +931,9 @@ static aoresult_t aoosp_des_initloop(aoosp_tele_t * tele, uint16_t * last, uint8
     @note   Make sure the chain is wired as Loop; e.g. if you have the OSP32 
             board, precede this call with a call to aospi_dirmux_set_loop().
     @note   If there are branches, probably it is better to use INITBIDIR.
+    @note   Only unicast addresses are accepted; a broadcast or group
+            address gives aoresult_osp_addr (the response must come
+            from one node).
     @note   When logging enabled with aoosp_loglevel_set(), logs to Serial.
 */
 aoresult_t aoosp_send_initloop(uint16_t addr, uint16_t * last, uint8_t * temp, uint8_t * stat) {
@@ -496,9 +953,11 @@ aoresult_t aoosp_send_initloop(uint16_t addr, uint16_t * last, uint8_t * temp, u
   if( spi_result!=aoresult_ok ) result= spi_result;
   if(     result==aoresult_ok ) des_result = aoosp_des_initloop(&resp, last, temp, stat);
   if( des_result!=aoresult_ok ) result=des_result;
+  if( des_result!=aoresult_ok ) aospi_stat_error(tele.data,tele.size,des_result);
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_INITLOOP, addr, &tele, &resp, con_result, spi_result, des_result);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("initloop(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -522,25 +981,7 @@ aoresult_t aoosp_send_initloop(uint16_t addr, uint16_t * last, uint8_t * temp, u
 
 
 static aoresult_t aoosp_con_gosleep(aoosp_tele_t * tele, uint16_t addr) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 0;
-  const uint8_t tid = 0x04; // GOSLEEP
-  //if( respsize ) *respsize = 4+0;
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_codec_encode(tele, AOOSP_IX_GOSLEEP, addr, 0, 0);
 }
 
 
@@ -569,6 +1010,7 @@ aoresult_t aoosp_send_gosleep(uint16_t addr) {
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_GOSLEEP, addr, &tele, 0, con_result, spi_result, aoresult_ok);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("gosleep(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -587,25 +1029,7 @@ aoresult_t aoosp_send_gosleep(uint16_t addr) {
 
 
 static aoresult_t aoosp_con_goactive(aoosp_tele_t * tele, uint16_t addr) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 0;
-  const uint8_t tid = 0x05; // GOACTIVE
-  //if( respsize ) *respsize = 4+0;
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_codec_encode(tele, AOOSP_IX_GOACTIVE, addr, 0, 0);
 }
 
 
@@ -634,6 +1058,7 @@ aoresult_t aoosp_send_goactive(uint16_t addr) {
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_GOACTIVE, addr, &tele, 0, con_result, spi_result, aoresult_ok);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("goactive(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -652,25 +1077,7 @@ aoresult_t aoosp_send_goactive(uint16_t addr) {
 
 
 static aoresult_t aoosp_con_godeepsleep(aoosp_tele_t * tele, uint16_t addr) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 0;
-  const uint8_t tid = 0x06; // GODEEPSLEEP
-  //if( respsize ) *respsize = 4+0;
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_codec_encode(tele, AOOSP_IX_GODEEPSLEEP, addr, 0, 0);
 }
 
 
@@ -699,6 +1106,7 @@ aoresult_t aoosp_send_godeepsleep(uint16_t addr) {
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_GODEEPSLEEP, addr, &tele, 0, con_result, spi_result, aoresult_ok);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("godeepsleep(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -717,42 +1125,16 @@ aoresult_t aoosp_send_godeepsleep(uint16_t addr) {
 
 
 static aoresult_t aoosp_con_identify(aoosp_tele_t * tele, uint16_t addr, uint8_t * respsize) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 0;
-  const uint8_t tid = 0x07; // IDENTIFY
-  if( respsize ) *respsize = 4+4; // id
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_codec_encode(tele, AOOSP_IX_IDENTIFY, addr, 0, respsize);
 }
 
 
 static aoresult_t aoosp_des_identify(aoosp_tele_t * tele, uint32_t * id) {
-  // Set constants
-  const uint8_t payloadsize = 4; // id (4 bytes)
-  // Check telegram consistency
-  if( tele==0 || id==0                         ) return aoresult_outargnull;
-  if( tele->size!=4+payloadsize                ) return aoresult_osp_size;
-  if( TELEPSI(tele)!=SIZE2PSI(payloadsize)     ) return aoresult_osp_psi;
-  if( BITS_SLICE(tele->data[0],4,8)!=0xA       ) return aoresult_osp_preamble;
-  if( BITS_SLICE(tele->data[2],0,7)!=0x07      ) return aoresult_osp_tid;
-  if( aoosp_crc(tele->data,tele->size)!=0      ) return aoresult_osp_crc;
-
-  // Get fields
-  *id = (uint32_t)(tele->data[3])<<24 | (uint32_t)(tele->data[4])<<16 | (uint32_t)(tele->data[5])<<8 | (uint32_t)(tele->data[6]);
-
+  uint32_t res[1];
+  if( tele==0 || id==0 ) return aoresult_outargnull;
+  aoresult_t result = aoosp_codec_decode(tele, AOOSP_IX_IDENTIFY, res, 0);
+  if( result!=aoresult_ok ) return result;
+  *id= res[0];
   return aoresult_ok;
 }
 
@@ -769,6 +1151,9 @@ static aoresult_t aoosp_des_identify(aoosp_tele_t * tele, uint32_t * id) {
     @note   See  AOOSP_IDENTIFY_ID2XXX to get the components from the id.
     @note   There is a convenience macro to check for a specific part: e.g. 
             AOOSP_IDENTIFY_IS_SAID(id) indicates if the node is a SAID.
+    @note   Only unicast addresses are accepted; a broadcast or group
+            address gives aoresult_osp_addr (the response must come
+            from one node).
     @note   When logging enabled with aoosp_loglevel_set(), logs to Serial.
 */
 aoresult_t aoosp_send_identify(uint16_t addr, uint32_t * id) {
@@ -788,9 +1173,11 @@ aoresult_t aoosp_send_identify(uint16_t addr, uint32_t * id) {
   if( spi_result!=aoresult_ok ) result= spi_result;
   if(     result==aoresult_ok ) des_result = aoosp_des_identify(&resp, id);
   if( des_result!=aoresult_ok ) result=des_result;
+  if( des_result!=aoresult_ok ) aospi_stat_error(tele.data,tele.size,des_result);
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_IDENTIFY, addr, &tele, &resp, con_result, spi_result, des_result);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("identify(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -815,43 +1202,16 @@ aoresult_t aoosp_send_identify(uint16_t addr, uint32_t * id) {
 // ==========================================================================
 // Telegram 0A ASKTINFO
 static aoresult_t aoosp_con_asktinfo(aoosp_tele_t * tele, uint16_t addr, uint8_t * respsize) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 0;
-  const uint8_t tid = 0x0A; // ASKTINFO
-  if( respsize ) *respsize = 4+2; //  tmin, tmax
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_codec_encode(tele, AOOSP_IX_ASKTINFO, addr, 0, respsize);
 }
 
 
 static aoresult_t aoosp_des_asktinfo(aoosp_tele_t * tele, uint8_t * tmin, uint8_t * tmax) {
-  // Set constants
-  const uint8_t payloadsize = 2; // tmin, tmax
-  // Check telegram consistency
-  if( tele==0 || tmin==0 || tmax==0            ) return aoresult_outargnull;
-  if( tele->size!=4+payloadsize                ) return aoresult_osp_size;
-  if( TELEPSI(tele)!=SIZE2PSI(payloadsize)     ) return aoresult_osp_psi;
-  if( BITS_SLICE(tele->data[0],4,8)!=0xA       ) return aoresult_osp_preamble;
-  if( BITS_SLICE(tele->data[2],0,7)!=0x0A      ) return aoresult_osp_tid;
-  if( aoosp_crc(tele->data,tele->size)!=0      ) return aoresult_osp_crc;
-
-  // Get fields
-  *tmax= tele->data[3];
-  *tmin= tele->data[4];
-
+  uint32_t res[2];
+  if( tele==0 || tmin==0 || tmax==0 ) return aoresult_outargnull;
+  aoresult_t result = aoosp_codec_decode(tele, AOOSP_IX_ASKTINFO, res, 0);
+  if( result!=aoresult_ok ) return result;
+  *tmin= res[0]; *tmax= res[1];
   return aoresult_ok;
 }
 
@@ -870,6 +1230,9 @@ static aoresult_t aoosp_des_asktinfo(aoosp_tele_t * tele, uint8_t * tmin, uint8_
             chain (from node `addr` to last one).
     @return aoresult_ok if all ok, otherwise an error code.
             When returning aoresult_ok, the output parameters are set.
+    @note   Only unicast addresses are accepted; a broadcast or group
+            address gives aoresult_osp_addr (the response must come
+            from one node).
     @note   When logging enabled with aoosp_loglevel_set(), logs to Serial.
     @note   Generally, the telegram is sent to the first node (addr=001),
             but is possible to user a higher address.
@@ -896,9 +1259,11 @@ aoresult_t aoosp_send_asktinfo(uint16_t addr, uint8_t * tmin, uint8_t * tmax) {
   if( spi_result!=aoresult_ok ) result= spi_result;
   if(     result==aoresult_ok ) des_result = aoosp_des_asktinfo(&resp, tmin, tmax);
   if( des_result!=aoresult_ok ) result=des_result;
+  if( des_result!=aoresult_ok ) aospi_stat_error(tele.data,tele.size,des_result);
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_ASKTINFO, addr, &tele, &resp, con_result, spi_result, des_result);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("asktinfo(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -921,28 +1286,8 @@ aoresult_t aoosp_send_asktinfo(uint16_t addr, uint8_t * tmin, uint8_t * tmax) {
 
 
 static aoresult_t aoosp_con_asktinfo_init(aoosp_tele_t * tele, uint16_t addr, uint8_t tmin, uint8_t tmax, uint8_t * respsize) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 2; // initial tmin and tmax
-  const uint8_t tid = 0x0A; // ASKTINFO
-  if( respsize ) *respsize = 4+2; // tmin, tmax
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = tmax;
-  tele->data[4] = tmin;
-
-  tele->data[5] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  const uint32_t args[] = { tmin, tmax };
+  return aoosp_codec_encode(tele, AOOSP_IX_ASKTINFO_INIT, addr, args, respsize);
 }
 
 
@@ -963,6 +1308,9 @@ static aoresult_t aoosp_con_asktinfo_init(aoosp_tele_t * tele, uint16_t addr, ui
             When returning aoresult_ok, the output parameters are set.
     @note   This is the extended version of aoosp_send_asktinfo().
             See there for details.
+    @note   Only unicast addresses are accepted; a broadcast or group
+            address gives aoresult_osp_addr (the response must come
+            from one node).
 */
 aoresult_t aoosp_send_asktinfo_init(uint16_t addr, uint8_t * tmin, uint8_t * tmax) {
   // Telegram and result vars
@@ -981,9 +1329,11 @@ aoresult_t aoosp_send_asktinfo_init(uint16_t addr, uint8_t * tmin, uint8_t * tma
   if( spi_result!=aoresult_ok ) result= spi_result;
   if(     result==aoresult_ok ) des_result = aoosp_des_asktinfo(&resp, tmin, tmax);
   if( des_result!=aoresult_ok ) result=des_result;
+  if( des_result!=aoresult_ok ) aospi_stat_error(tele.data,tele.size,des_result);
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_ASKTINFO_INIT, addr, &tele, &resp, con_result, spi_result, des_result);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("asktinfo_ex(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -1010,42 +1360,16 @@ aoresult_t aoosp_send_asktinfo_init(uint16_t addr, uint8_t * tmin, uint8_t * tma
 
 
 static aoresult_t aoosp_con_readmult(aoosp_tele_t * tele, uint16_t addr, uint8_t * respsize) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 0;
-  const uint8_t tid = 0x0C; // READMULT
-  if( respsize ) *respsize = 4+2; // groups
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_codec_encode(tele, AOOSP_IX_READMULT, addr, 0, respsize);
 }
 
 
-static aoresult_t aoosp_des_readmult(aoosp_tele_t * tele, uint16_t *groups ) {
-  // Set constants
-  const uint8_t payloadsize = 2; // groups hi, groups lo 
-  // Check telegram consistency
-  if( tele==0 || groups==0                     ) return aoresult_outargnull;
-  if( tele->size!=4+payloadsize                ) return aoresult_osp_size;
-  if( TELEPSI(tele)!=SIZE2PSI(payloadsize)     ) return aoresult_osp_psi;
-  if( BITS_SLICE(tele->data[0],4,8)!=0xA       ) return aoresult_osp_preamble;
-  if( BITS_SLICE(tele->data[2],0,7)!=0x0C      ) return aoresult_osp_tid;
-  if( aoosp_crc(tele->data,tele->size)!=0      ) return aoresult_osp_crc;
-
-  // Get fields
-  *groups= (tele->data[3] << 8) | (tele->data[4] << 0);
-
+static aoresult_t aoosp_des_readmult(aoosp_tele_t * tele, uint16_t * groups) {
+  uint32_t res[1];
+  if( tele==0 || groups==0 ) return aoresult_outargnull;
+  aoresult_t result = aoosp_codec_decode(tele, AOOSP_IX_READMULT, res, 0);
+  if( result!=aoresult_ok ) return result;
+  *groups= res[0];
   return aoresult_ok;
 }
 
@@ -1061,6 +1385,9 @@ static aoresult_t aoosp_des_readmult(aoosp_tele_t * tele, uint16_t *groups ) {
             Output parameter returning the groups mask of the addressed node.
     @return aoresult_ok if all ok, otherwise an error code.
             When returning aoresult_ok, the output parameter is set.
+    @note   Only unicast addresses are accepted; a broadcast or group
+            address gives aoresult_osp_addr (the response must come
+            from one node).
     @note   When logging enabled with aoosp_loglevel_set(), logs to Serial.
 */
 aoresult_t aoosp_send_readmult(uint16_t addr, uint16_t *groups ) {
@@ -1080,9 +1407,11 @@ aoresult_t aoosp_send_readmult(uint16_t addr, uint16_t *groups ) {
   if( spi_result!=aoresult_ok ) result= spi_result;
   if(     result==aoresult_ok ) des_result = aoosp_des_readmult(&resp, groups);
   if( des_result!=aoresult_ok ) result=des_result;
+  if( des_result!=aoresult_ok ) aospi_stat_error(tele.data,tele.size,des_result);
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_READMULT, addr, &tele, &resp, con_result, spi_result, des_result);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("readmult(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -1104,30 +1433,9 @@ aoresult_t aoosp_send_readmult(uint16_t addr, uint16_t *groups ) {
 
 
 static aoresult_t aoosp_con_setmult(aoosp_tele_t * tele, uint16_t addr, uint16_t groups) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-  if( groups & ~0x7FFF        ) return aoresult_osp_arg;
-
-  // Set constants
-  const uint8_t payloadsize = 2; // groups hi, groups lo
-  const uint8_t tid = 0x0D; // SETMULT
-  //if( respsize ) *respsize = 4+0;
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = BITS_SLICE(groups,8,16);
-  tele->data[4] = BITS_SLICE(groups,0,8);
-
-  tele->data[5] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
-}
+  const uint32_t args[] = { groups };
+  return aoosp_codec_encode(tele, AOOSP_IX_SETMULT, addr, args, 0);
+}
 
 
 /*!
@@ -1156,6 +1464,7 @@ aoresult_t aoosp_send_setmult(uint16_t addr, uint16_t groups) {
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_SETMULT, addr, &tele, 0, con_result, spi_result, aoresult_ok);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("setmult(0x%03X,0x%02X)",addr,groups);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -1178,25 +1487,7 @@ aoresult_t aoosp_send_setmult(uint16_t addr, uint16_t groups) {
 
 
 static aoresult_t aoosp_con_sync(aoosp_tele_t * tele, uint16_t addr) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 0;
-  const uint8_t tid = 0x0F; // SYNC
-  //if( respsize ) *respsize = 4+0;
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_codec_encode(tele, AOOSP_IX_SYNC, addr, 0, 0);
 }
 
 
@@ -1224,6 +1515,7 @@ aoresult_t aoosp_send_sync(uint16_t addr) {
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_SYNC, addr, &tele, 0, con_result, spi_result, aoresult_ok);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("sync(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -1246,25 +1538,7 @@ aoresult_t aoosp_send_sync(uint16_t addr) {
 
 
 static aoresult_t aoosp_con_idle(aoosp_tele_t * tele, uint16_t addr) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 0;
-  const uint8_t tid = 0x11; // IDLE
-  //if( respsize ) *respsize = 4+0;
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_codec_encode(tele, AOOSP_IX_IDLE, addr, 0, 0);
 }
 
 
@@ -1299,6 +1573,7 @@ aoresult_t aoosp_send_idle(uint16_t addr) {
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_IDLE, addr, &tele, 0, con_result, spi_result, aoresult_ok);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("idle(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -1317,25 +1592,7 @@ aoresult_t aoosp_send_idle(uint16_t addr) {
 
 
 static aoresult_t aoosp_con_foundry(aoosp_tele_t * tele, uint16_t addr) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 0;
-  const uint8_t tid = 0x12; // FOUNDRY
-  //if( respsize ) *respsize = 4+0;
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_codec_encode(tele, AOOSP_IX_FOUNDRY, addr, 0, 0);
 }
 
 
@@ -1362,6 +1619,7 @@ aoresult_t aoosp_send_foundry(uint16_t addr) {
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_FOUNDRY, addr, &tele, 0, con_result, spi_result, aoresult_ok);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("foundry(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -1380,25 +1638,7 @@ aoresult_t aoosp_send_foundry(uint16_t addr) {
 
 
 static aoresult_t aoosp_con_cust(aoosp_tele_t * tele, uint16_t addr) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 0;
-  const uint8_t tid = 0x13; // CUST
-  //if( respsize ) *respsize = 4+0;
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_codec_encode(tele, AOOSP_IX_CUST, addr, 0, 0);
 }
 
 
@@ -1425,6 +1665,7 @@ aoresult_t aoosp_send_cust(uint16_t addr) {
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_CUST, addr, &tele, 0, con_result, spi_result, aoresult_ok);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("cust(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -1443,25 +1684,7 @@ aoresult_t aoosp_send_cust(uint16_t addr) {
 
 
 static aoresult_t aoosp_con_burn(aoosp_tele_t * tele, uint16_t addr) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 0;
-  const uint8_t tid = 0x14; // BURN
-  //if( respsize ) *respsize = 4+0;
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_codec_encode(tele, AOOSP_IX_BURN, addr, 0, 0);
 }
 
 
@@ -1504,6 +1727,7 @@ aoresult_t aoosp_send_burn(uint16_t addr) {
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_BURN, addr, &tele, 0, con_result, spi_result, aoresult_ok);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("burn(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -1522,25 +1746,7 @@ aoresult_t aoosp_send_burn(uint16_t addr) {
 
 
 static aoresult_t aoosp_con_aread(aoosp_tele_t * tele, uint16_t addr) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 0;
-  const uint8_t tid = 0x15; // AREAD
-  //if( respsize ) *respsize = 4+0;
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_codec_encode(tele, AOOSP_IX_AREAD, addr, 0, 0);
 }
 
 
@@ -1570,6 +1776,7 @@ aoresult_t aoosp_send_aread(uint16_t addr) {
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_AREAD, addr, &tele, 0, con_result, spi_result, aoresult_ok);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("aread(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -1588,25 +1795,7 @@ aoresult_t aoosp_send_aread(uint16_t addr) {
 
 
 static aoresult_t aoosp_con_load(aoosp_tele_t * tele, uint16_t addr) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 0;
-  const uint8_t tid = 0x16; // LOAD
-  //if( respsize ) *respsize = 4+0;
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_codec_encode(tele, AOOSP_IX_LOAD, addr, 0, 0);
 }
 
 
@@ -1645,6 +1834,7 @@ aoresult_t aoosp_send_load(uint16_t addr) {
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_LOAD, addr, &tele, 0, con_result, spi_result, aoresult_ok);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("load(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -1663,25 +1853,7 @@ aoresult_t aoosp_send_load(uint16_t addr) {
 
 
 static aoresult_t aoosp_con_gload(aoosp_tele_t * tele, uint16_t addr) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 0;
-  const uint8_t tid = 0x17; // GLOAD
-  //if( respsize ) *respsize = 4+0;
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_codec_encode(tele, AOOSP_IX_GLOAD, addr, 0, 0);
 }
 
 
@@ -1715,6 +1887,7 @@ aoresult_t aoosp_send_gload(uint16_t addr) {
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_GLOAD, addr, &tele, 0, con_result, spi_result, aoresult_ok);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("gload(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -1733,32 +1906,10 @@ aoresult_t aoosp_send_gload(uint16_t addr) {
 
 
 static aoresult_t aoosp_con_i2cread8(aoosp_tele_t * tele, uint16_t addr, uint8_t daddr7, uint8_t raddr, uint8_t count) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-  if( daddr7>127             ) return aoresult_osp_arg;
-//if( raddr>255              ) return aoresult_osp_arg;
-  if( count<1 || count>8     ) return aoresult_osp_arg;
-
-  // Set constants
-  const uint8_t payloadsize = 3; // daddr7, raddr, count
-  const uint8_t tid = 0x18; // I2CREAD
-  // if( respsize ) *respsize = 4+0; // nothing
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = daddr7 << 1; // 7 bits address needs shifting
-  tele->data[4] = raddr;
-  tele->data[5] = count;
-
-  tele->data[6] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  const uint32_t args[] = { daddr7, raddr, count };
+  aoresult_t result = aoosp_codec_encode(tele, AOOSP_IX_I2CREAD8, addr, args, 0);
+  if( result==aoresult_ok && (count<1 || count>8) ) result = aoresult_osp_arg; // I2C reads 1 to 8 bytes
+  return result;
 }
 
 
@@ -1802,6 +1953,7 @@ aoresult_t aoosp_send_i2cread8(uint16_t addr, uint8_t daddr7, uint8_t raddr, uin
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_I2CREAD8, addr, &tele, 0, con_result, spi_result, aoresult_ok);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("i2cread8(0x%03X,0x%02X,0x%02X,%d)",addr,daddr7,raddr,count );
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -1820,32 +1972,10 @@ aoresult_t aoosp_send_i2cread8(uint16_t addr, uint8_t daddr7, uint8_t raddr, uin
 
 
 static aoresult_t aoosp_con_i2cread12(aoosp_tele_t * tele, uint16_t addr, uint8_t daddr7, uint16_t raddr, uint8_t count) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-  if( daddr7>127             ) return aoresult_osp_arg;
-  if( raddr>4095             ) return aoresult_osp_arg;
-  if( count<1 || count>8     ) return aoresult_osp_arg;
-
-  // Set constants
-  const uint8_t payloadsize = 3; // daddr7, raddr hi, raddr lo | count
-  const uint8_t tid = 0x18; // I2CREAD
-  // if( respsize ) *respsize = 4+0; // nothing
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = daddr7 << 1; // 7 bits address needs shifting
-  tele->data[4] = BITS_SLICE(raddr,4,12);
-  tele->data[5] = BITS_SLICE(raddr,0,4)<<4 | count;
-
-  tele->data[6] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  const uint32_t args[] = { daddr7, raddr, count };
+  aoresult_t result = aoosp_codec_encode(tele, AOOSP_IX_I2CREAD12, addr, args, 0);
+  if( result==aoresult_ok && (count<1 || count>8) ) result = aoresult_osp_arg; // I2C reads 1 to 8 bytes
+  return result;
 }
 
 
@@ -1891,6 +2021,7 @@ aoresult_t aoosp_send_i2cread12(uint16_t addr, uint8_t daddr7, uint16_t raddr, u
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_I2CREAD12, addr, &tele, 0, con_result, spi_result, aoresult_ok);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("i2cread12(0x%03X,0x%03X,0x%02X,%d)",addr,daddr7,raddr,count );
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -1909,33 +2040,20 @@ aoresult_t aoosp_send_i2cread12(uint16_t addr, uint8_t daddr7, uint16_t raddr, u
 
 
 static aoresult_t aoosp_con_i2cwrite8(aoosp_tele_t * tele, uint16_t addr, uint8_t daddr7, uint8_t raddr, const uint8_t * buf, int count) {
+  const aoosp_desc_t * desc = &aoosp_desc[AOOSP_IX_I2CWRITE8];
+  const uint32_t       args[] = { daddr7, raddr };
   // Check input parameters
-  if( tele==0 || buf==0        ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr)   ) return aoresult_osp_addr;
-  if( daddr7>127               ) return aoresult_osp_arg;
-//if( raddr>255                ) return aoresult_osp_arg;
-  if( count<1                  ) return aoresult_osp_arg;     // SAID wants minimally one I2C byte
-  if( count+2>8                ) return aoresult_osp_argsize; // telegram payload cannot exceed 8 bytes (two bytes is for daddr/raddr)
-  if( count+2==5 || count+2==7 ) return aoresult_osp_argsize; // telegram payloads 5 and 7 are not supported in OSP
-
-  // Set constants
-  const uint8_t payloadsize = 2+count;  // daddr, raddr, buf (count)
-  const uint8_t tid = 0x19; // I2CWRITE
-  // if( respsize ) *respsize = 4+0; // nothing
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = daddr7 << 1; // 7 bits device address needs shifting
-  tele->data[4] = raddr;
-  for( int i=0; i<count; i++ ) tele->data[5+i] = buf[i];
-
-  tele->data[5+count] = aoosp_crc( tele->data , tele->size - 1 );
-
+  if( tele==0 || buf==0                   ) return aoresult_outargnull;
+  if( !aoosp_codec_castok(desc,addr)      ) return aoresult_osp_addr;
+  if( !aoosp_codec_argsok(desc->cmd,args) ) return aoresult_osp_arg;
+  if( count<1                             ) return aoresult_osp_arg;     // SAID wants minimally one I2C byte
+  if( count+2>8                           ) return aoresult_osp_argsize; // telegram payload cannot exceed 8 bytes (two bytes is for daddr/raddr)
+  if( count+2==5 || count+2==7            ) return aoresult_osp_argsize; // telegram payloads 5 and 7 are not supported in OSP
+  // Build telegram: daddr7 and raddr, followed by the bytes to write
+  aoosp_codec_begin(tele, desc->tid, addr, desc->cmd->payloadsize+count);
+  aoosp_codec_pack(tele, desc->cmd, args);
+  memcpy( &tele->data[3+desc->cmd->payloadsize], buf, count );
+  aoosp_codec_end(tele);
   return aoresult_ok;
 }
 
@@ -1980,6 +2098,7 @@ aoresult_t aoosp_send_i2cwrite8(uint16_t addr, uint8_t daddr7, uint8_t raddr, co
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_I2CWRITE8, addr, &tele, 0, con_result, spi_result, aoresult_ok);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("i2cwrite(0x%03X,0x%02X,0x%02X,0x[%s])",addr,daddr7,raddr,aoosp_prt_bytes(buf,count));
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -1998,34 +2117,20 @@ aoresult_t aoosp_send_i2cwrite8(uint16_t addr, uint8_t daddr7, uint8_t raddr, co
 
 
 static aoresult_t aoosp_con_i2cwrite12(aoosp_tele_t * tele, uint16_t addr, uint8_t daddr7, uint16_t raddr, const uint8_t * buf, int count) {
+  const aoosp_desc_t * desc = &aoosp_desc[AOOSP_IX_I2CWRITE12];
+  const uint32_t       args[] = { daddr7, raddr };
   // Check input parameters
-  if( tele==0 || buf==0        ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr)   ) return aoresult_osp_addr;
-  if( daddr7>127               ) return aoresult_osp_arg;
-  if( raddr>4095               ) return aoresult_osp_arg;
-  if( count<1                  ) return aoresult_osp_arg;     // SAID wants minimally one I2C byte
-  if( count+3>8                ) return aoresult_osp_argsize; // telegram payload cannot exceed 8 bytes (three bytes is for daddr/raddr)
-  if( count+3==5 || count+3==7 ) return aoresult_osp_argsize; // telegram payloads 5 and 7 are not supported in OSP
-
-  // Set constants
-  const uint8_t payloadsize = 3+count; // daddr, raddr hi, raddr lo, buf (count)
-  const uint8_t tid = 0x19; // I2CWRITE
-  // if( respsize ) *respsize = 4+0; // nothing
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = daddr7 << 1; // 7 bits device address needs shifting
-  tele->data[4] = 0b0000<<4 | BITS_SLICE(raddr,8,12); 
-  tele->data[5] = BITS_SLICE(raddr,0,8);
-  for( int i=0; i<count; i++ ) tele->data[6+i] = buf[i];
-
-  tele->data[6+count] = aoosp_crc( tele->data , tele->size - 1 );
-
+  if( tele==0 || buf==0                   ) return aoresult_outargnull;
+  if( !aoosp_codec_castok(desc,addr)      ) return aoresult_osp_addr;
+  if( !aoosp_codec_argsok(desc->cmd,args) ) return aoresult_osp_arg;
+  if( count<1                             ) return aoresult_osp_arg;     // SAID wants minimally one I2C byte
+  if( count+3>8                           ) return aoresult_osp_argsize; // telegram payload cannot exceed 8 bytes (three bytes is for daddr/raddr)
+  if( count+3==5 || count+3==7            ) return aoresult_osp_argsize; // telegram payloads 5 and 7 are not supported in OSP
+  // Build telegram: daddr7 and raddr, followed by the bytes to write
+  aoosp_codec_begin(tele, desc->tid, addr, desc->cmd->payloadsize+count);
+  aoosp_codec_pack(tele, desc->cmd, args);
+  memcpy( &tele->data[3+desc->cmd->payloadsize], buf, count );
+  aoosp_codec_end(tele);
   return aoresult_ok;
 }
 
@@ -2072,6 +2177,7 @@ aoresult_t aoosp_send_i2cwrite12(uint16_t addr, uint8_t daddr7, uint16_t raddr,
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_I2CWRITE12, addr, &tele, 0, con_result, spi_result, aoresult_ok);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("i2cwrite12(0x%03X,0x%02X,0x%03X,0x[%s])",addr,daddr7,raddr,aoosp_prt_bytes(buf,count));
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -2097,43 +2203,17 @@ aoresult_t aoosp_send_i2cwrite12(uint16_t addr, uint8_t daddr7, uint16_t raddr,
 
 
 static aoresult_t aoosp_con_readlast(aoosp_tele_t * tele, uint16_t addr, uint8_t * respsize) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 0;
-  const uint8_t tid = 0x1E; // READLAST
-  if( respsize ) *respsize = 4+8; // i2c read buffer
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_codec_encode(tele, AOOSP_IX_READLAST, addr, 0, respsize);
 }
 
 
 static aoresult_t aoosp_des_readlast(aoosp_tele_t * tele, uint8_t * buf, int size) {
-  // Set constants
-  const uint8_t payloadsize = 8; // buf (8 bytes)
-  // Check telegram consistency
-  if( tele==0 || buf==0                        ) return aoresult_outargnull;
-  if( tele->size!=4+payloadsize                ) return aoresult_osp_size;
-  if( TELEPSI(tele)!=SIZE2PSI(payloadsize)     ) return aoresult_osp_psi;
-  if( BITS_SLICE(tele->data[0],4,8)!=0xA       ) return aoresult_osp_preamble;
-  if( BITS_SLICE(tele->data[2],0,7)!=0x1E      ) return aoresult_osp_tid;
-  if( aoosp_crc(tele->data,tele->size)!=0      ) return aoresult_osp_crc;
-  if( size<1 || size>8                         ) return aoresult_osp_arg;
-
-  // Get fields
-  for( int i=0; i<size; i++ ) buf[i] = tele->data[11-size+i];
-
+  if( tele==0 || buf==0 ) return aoresult_outargnull;
+  aoresult_t result = aoosp_codec_validate(tele, AOOSP_IX_READLAST, 0);
+  if( result!=aoresult_ok ) return result;
+  if( size<1 || size>8    ) return aoresult_osp_arg;
+  // Get fields: the read bytes are at the end of the payload
+  memcpy( buf, &tele->data[11-size], size );
   return aoresult_ok;
 }
 
@@ -2150,6 +2230,9 @@ static aoresult_t aoosp_des_readlast(aoosp_tele_t * tele, uint8_t * buf, int siz
             (the buffer should have at least that size).
     @return aoresult_ok if all ok, otherwise an error code.
     @note   First send a I2CREAD to get bytes from an I2C device into the SAID.
+    @note   Only unicast addresses are accepted; a broadcast or group
+            address gives aoresult_osp_addr (the response must come
+            from one node).
     @note   When logging enabled with aoosp_loglevel_set(), logs to Serial.
     @note   The response telegram always has a size of 8 irrespective
             of how many bytes were read with I2CREAD. If less bytes were 
@@ -2175,9 +2258,11 @@ aoresult_t aoosp_send_readlast(uint16_t addr, uint8_t * buf, int size) {
   if( spi_result!=aoresult_ok ) result= spi_result;
   if(     result==aoresult_ok ) des_result = aoosp_des_readlast(&resp, buf, size);
   if( des_result!=aoresult_ok ) result=des_result;
+  if( des_result!=aoresult_ok ) aospi_stat_error(tele.data,tele.size,des_result);
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_READLAST, addr, &tele, &resp, con_result, spi_result, des_result);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("readlast(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -2208,43 +2293,17 @@ aoresult_t aoosp_send_readlast(uint16_t addr, uint8_t * buf, int size) {
 
 
 static aoresult_t aoosp_con_goactive_sr(aoosp_tele_t * tele, uint16_t addr, uint8_t * respsize) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 0;
-  const uint8_t tid = 0x25; // GOACTIVE_SR
-  if( respsize ) *respsize = 4+2; // temp,stat
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_codec_encode(tele, AOOSP_IX_GOACTIVE_SR, addr, 0, respsize);
 }
 
 
 static aoresult_t aoosp_des_goactive_sr(aoosp_tele_t * tele, uint8_t * temp, uint8_t * stat) {
-  // Set constants
-  const uint8_t payloadsize = 2; // temp, stat 
-  // Check telegram consistency
-  if( tele==0 || stat==0                       ) return aoresult_outargnull;
-  if( tele->size!=4+payloadsize                ) return aoresult_osp_size;
-  if( TELEPSI(tele)!=SIZE2PSI(payloadsize)     ) return aoresult_osp_psi;
-  if( BITS_SLICE(tele->data[0],4,8)!=0xA       ) return aoresult_osp_preamble;
-  if( BITS_SLICE(tele->data[2],0,7)!=0x25      ) return aoresult_osp_tid;
-  if( aoosp_crc(tele->data,tele->size)!=0      ) return aoresult_osp_crc;
-
-  // Get fields
-  *temp = tele->data[3];
-  *stat = tele->data[4];
-
+  uint32_t res[2];
+  if( tele==0 || stat==0 ) return aoresult_outargnull;
+  aoresult_t result = aoosp_codec_decode(tele, AOOSP_IX_GOACTIVE_SR, res, 0);
+  if( result!=aoresult_ok ) return result;
+  if( temp ) *temp= res[0];
+  *stat= res[1];
   return aoresult_ok;
 }
 
@@ -2261,6 +2320,9 @@ static aoresult_t aoosp_des_goactive_sr(aoosp_tele_t * tele, uint8_t * temp, uin
             Output parameter returning the (system) status of the addressed node.
     @return aoresult_ok if all ok, otherwise an error code.
             When returning aoresult_ok, the output parameters are set.
+    @note   Only unicast addresses are accepted; a broadcast or group
+            address gives aoresult_osp_addr (the response must come
+            from one node).
     @note   When logging enabled with aoosp_loglevel_set(), logs to Serial.
 */
 aoresult_t aoosp_send_goactive_sr(uint16_t addr, uint8_t * temp, uint8_t * stat) {
@@ -2280,9 +2342,11 @@ aoresult_t aoosp_send_goactive_sr(uint16_t addr, uint8_t * temp, uint8_t * stat)
   if( spi_result!=aoresult_ok ) result= spi_result;
   if(     result==aoresult_ok ) des_result = aoosp_des_goactive_sr(&resp, temp, stat);
   if( des_result!=aoresult_ok ) result=des_result;
+  if( des_result!=aoresult_ok ) aospi_stat_error(tele.data,tele.size,des_result);
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_GOACTIVE_SR, addr, &tele, &resp, con_result, spi_result, des_result);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("goactive_sr(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -2328,42 +2392,16 @@ aoresult_t aoosp_send_goactive_sr(uint16_t addr, uint8_t * temp, uint8_t * stat)
 
 
 static aoresult_t aoosp_con_readstat(aoosp_tele_t * tele, uint16_t addr, uint8_t * respsize) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 0;
-  const uint8_t tid = 0x40; // READSTAT
-  if( respsize ) *respsize = 4+1; //  stat
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_codec_encode(tele, AOOSP_IX_READSTAT, addr, 0, respsize);
 }
 
 
 static aoresult_t aoosp_des_readstat(aoosp_tele_t * tele, uint8_t * stat) {
-  // Set constants
-  const uint8_t payloadsize = 1; // stat
-  // Check telegram consistency
-  if( tele==0 || stat==0                       ) return aoresult_outargnull;
-  if( tele->size!=4+payloadsize                ) return aoresult_osp_size;
-  if( TELEPSI(tele)!=SIZE2PSI(payloadsize)     ) return aoresult_osp_psi;
-  if( BITS_SLICE(tele->data[0],4,8)!=0xA       ) return aoresult_osp_preamble;
-  if( BITS_SLICE(tele->data[2],0,7)!=0x40      ) return aoresult_osp_tid;
-  if( aoosp_crc(tele->data,tele->size)!=0      ) return aoresult_osp_crc;
-
-  // Get fields
-  *stat = tele->data[3];
-
+  uint32_t res[1];
+  if( tele==0 || stat==0 ) return aoresult_outargnull;
+  aoresult_t result = aoosp_codec_decode(tele, AOOSP_IX_READSTAT, res, 0);
+  if( result!=aoresult_ok ) return result;
+  *stat= res[0];
   return aoresult_ok;
 }
 
@@ -2377,6 +2415,9 @@ static aoresult_t aoosp_des_readstat(aoosp_tele_t * tele, uint8_t * stat) {
             Output parameter returning the (system) status of the addressed node.
     @return aoresult_ok if all ok, otherwise an error code.
             When returning aoresult_ok, the output parameter is set.
+    @note   Only unicast addresses are accepted; a broadcast or group
+            address gives aoresult_osp_addr (the response must come
+            from one node).
     @note   When logging enabled with aoosp_loglevel_set(), logs to Serial.
 */
 aoresult_t aoosp_send_readstat(uint16_t addr, uint8_t * stat) {
@@ -2396,9 +2437,11 @@ aoresult_t aoosp_send_readstat(uint16_t addr, uint8_t * stat) {
   if( spi_result!=aoresult_ok ) result= spi_result;
   if(     result==aoresult_ok ) des_result = aoosp_des_readstat(&resp, stat);
   if( des_result!=aoresult_ok ) result=des_result;
+  if( des_result!=aoresult_ok ) aospi_stat_error(tele.data,tele.size,des_result);
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_READSTAT, addr, &tele, &resp, con_result, spi_result, des_result);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("readstat(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -2425,43 +2468,16 @@ aoresult_t aoosp_send_readstat(uint16_t addr, uint8_t * stat) {
 
 
 static aoresult_t aoosp_con_readtempstat(aoosp_tele_t * tele, uint16_t addr, uint8_t * respsize) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 0;
-  const uint8_t tid = 0x42; // READTEMPSTAT
-  if( respsize ) *respsize = 4+2; // temp, stat
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_codec_encode(tele, AOOSP_IX_READTEMPSTAT, addr, 0, respsize);
 }
 
 
 static aoresult_t aoosp_des_readtempstat(aoosp_tele_t * tele, uint8_t * temp, uint8_t * stat) {
-  // Set constants
-  const uint8_t payloadsize = 2; // temp, stat
-  // Check telegram consistency
-  if( tele==0 || temp==0 || stat==0            ) return aoresult_outargnull;
-  if( tele->size!=4+payloadsize                ) return aoresult_osp_size;
-  if( TELEPSI(tele)!=SIZE2PSI(payloadsize)     ) return aoresult_osp_psi;
-  if( BITS_SLICE(tele->data[0],4,8)!=0xA       ) return aoresult_osp_preamble;
-  if( BITS_SLICE(tele->data[2],0,7)!=0x42      ) return aoresult_osp_tid;
-  if( aoosp_crc(tele->data,tele->size)!=0      ) return aoresult_osp_crc;
-
-  // Get fields
-  *temp = tele->data[3];
-  *stat = tele->data[4];
-
+  uint32_t res[2];
+  if( tele==0 || temp==0 || stat==0 ) return aoresult_outargnull;
+  aoresult_t result = aoosp_codec_decode(tele, AOOSP_IX_READTEMPSTAT, res, 0);
+  if( result!=aoresult_ok ) return result;
+  *temp= res[0]; *stat= res[1];
   return aoresult_ok;
 }
 
@@ -2480,6 +2496,9 @@ static aoresult_t aoosp_des_readtempstat(aoosp_tele_t * tele, uint8_t * temp, ui
             When returning aoresult_ok, the output parameters are set.
     @note   Converting raw temperature to Celsius depends on the node type.
             See e.g. `aoosp_prt_temp_rgbi()` or `aoosp_prt_temp_said()`.
+    @note   Only unicast addresses are accepted; a broadcast or group
+            address gives aoresult_osp_addr (the response must come
+            from one node).
     @note   When logging enabled with aoosp_loglevel_set(), logs to Serial.
 */
 aoresult_t aoosp_send_readtempstat(uint16_t addr, uint8_t * temp, uint8_t * stat) {
@@ -2499,9 +2518,11 @@ aoresult_t aoosp_send_readtempstat(uint16_t addr, uint8_t * temp, uint8_t * stat
   if( spi_result!=aoresult_ok ) result= spi_result;
   if(     result==aoresult_ok ) des_result = aoosp_des_readtempstat(&resp, temp, stat);
   if( des_result!=aoresult_ok ) result=des_result;
+  if( des_result!=aoresult_ok ) aospi_stat_error(tele.data,tele.size,des_result);
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_READTEMPSTAT, addr, &tele, &resp, con_result, spi_result, des_result);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("readtempstat(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -2528,42 +2549,16 @@ aoresult_t aoosp_send_readtempstat(uint16_t addr, uint8_t * temp, uint8_t * stat
 
 
 static aoresult_t aoosp_con_readcomst(aoosp_tele_t * tele, uint16_t addr, uint8_t * respsize) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 0;
-  const uint8_t tid = 0x44; // READCOMST
-  if( respsize ) *respsize = 4+1; // comst
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_codec_encode(tele, AOOSP_IX_READCOMST, addr, 0, respsize);
 }
 
 
 static aoresult_t aoosp_des_readcomst(aoosp_tele_t * tele, uint8_t * com) {
-  // Set constants
-  const uint8_t payloadsize = 1; // com
-  // Check telegram consistency
-  if( tele==0 || com==0                        ) return aoresult_outargnull;
-  if( tele->size!=4+payloadsize                ) return aoresult_osp_size;
-  if( TELEPSI(tele)!=SIZE2PSI(payloadsize)     ) return aoresult_osp_psi;
-  if( BITS_SLICE(tele->data[0],4,8)!=0xA       ) return aoresult_osp_preamble;
-  if( BITS_SLICE(tele->data[2],0,7)!=0x44      ) return aoresult_osp_tid;
-  if( aoosp_crc(tele->data,tele->size)!=0      ) return aoresult_osp_crc;
-
-  // Get fields
-  *com= tele->data[3];
-
+  uint32_t res[1];
+  if( tele==0 || com==0 ) return aoresult_outargnull;
+  aoresult_t result = aoosp_codec_decode(tele, AOOSP_IX_READCOMST, res, 0);
+  if( result!=aoresult_ok ) return result;
+  *com= res[0];
   return aoresult_ok;
 }
 
@@ -2579,6 +2574,9 @@ static aoresult_t aoosp_des_readcomst(aoosp_tele_t * tele, uint8_t * com) {
     @return aoresult_ok if all ok, otherwise an error code.
             When returning aoresult_ok, the output parameter is set.
     @note   Status fields depend on the node type.
+    @note   Only unicast addresses are accepted; a broadcast or group
+            address gives aoresult_osp_addr (the response must come
+            from one node).
     @note   When logging enabled with aoosp_loglevel_set(), logs to Serial.
 */
 aoresult_t aoosp_send_readcomst(uint16_t addr, uint8_t * com) {
@@ -2598,9 +2596,11 @@ aoresult_t aoosp_send_readcomst(uint16_t addr, uint8_t * com) {
   if( spi_result!=aoresult_ok ) result= spi_result;
   if(     result==aoresult_ok ) des_result = aoosp_des_readcomst(&resp, com);
   if( des_result!=aoresult_ok ) result=des_result;
+  if( des_result!=aoresult_ok ) aospi_stat_error(tele.data,tele.size,des_result);
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_READCOMST, addr, &tele, &resp, con_result, spi_result, des_result);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("readcomst(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -2627,42 +2627,16 @@ aoresult_t aoosp_send_readcomst(uint16_t addr, uint8_t * com) {
 
 
 static aoresult_t aoosp_con_readledst(aoosp_tele_t * tele, uint16_t addr, uint8_t * respsize) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 0;
-  const uint8_t tid = 0x46; // READLEDST
-  if( respsize ) *respsize = 4+1; // ledst
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_codec_encode(tele, AOOSP_IX_READLEDST, addr, 0, respsize);
 }
 
 
 static aoresult_t aoosp_des_readledst(aoosp_tele_t * tele, uint8_t * ledst) {
-  // Set constants
-  const uint8_t payloadsize = 1; // ledst
-  // Check telegram consistency
-  if( tele==0 || ledst==0                      ) return aoresult_outargnull;
-  if( tele->size!=4+payloadsize                ) return aoresult_osp_size;
-  if( TELEPSI(tele)!=SIZE2PSI(payloadsize)     ) return aoresult_osp_psi;
-  if( BITS_SLICE(tele->data[0],4,8)!=0xA       ) return aoresult_osp_preamble;
-  if( BITS_SLICE(tele->data[2],0,7)!=0x46      ) return aoresult_osp_tid;
-  if( aoosp_crc(tele->data,tele->size)!=0      ) return aoresult_osp_crc;
-
-  // Get fields
-  *ledst = tele->data[3];
-
+  uint32_t res[1];
+  if( tele==0 || ledst==0 ) return aoresult_outargnull;
+  aoresult_t result = aoosp_codec_decode(tele, AOOSP_IX_READLEDST, res, 0);
+  if( result!=aoresult_ok ) return result;
+  *ledst= res[0];
   return aoresult_ok;
 }
 
@@ -2686,6 +2660,9 @@ static aoresult_t aoosp_des_readledst(aoosp_tele_t * tele, uint8_t * ledst) {
     @note   Although this telegram ID (46) is the same as for READLEDSTCHN, the 
             payload is specific for single channel PWM devices like RGBi's. 
             For multi channel PWM devices, like SAID, use READLEDSTCHN.
+    @note   Only unicast addresses are accepted; a broadcast or group
+            address gives aoresult_osp_addr (the response must come
+            from one node).
     @note   When logging enabled with aoosp_loglevel_set(), logs to Serial.
 */
 aoresult_t aoosp_send_readledst(uint16_t addr, uint8_t * ledst) {
@@ -2705,9 +2682,11 @@ aoresult_t aoosp_send_readledst(uint16_t addr, uint8_t * ledst) {
   if( spi_result!=aoresult_ok ) result= spi_result;
   if(     result==aoresult_ok ) des_result = aoosp_des_readledst(&resp, ledst);
   if( des_result!=aoresult_ok ) result=des_result;
+  if( des_result!=aoresult_ok ) aospi_stat_error(tele.data,tele.size,des_result);
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_READLEDST, addr, &tele, &resp, con_result, spi_result, des_result);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("readledst(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -2729,45 +2708,19 @@ aoresult_t aoosp_send_readledst(uint16_t addr, uint8_t * ledst) {
 
 
 static aoresult_t aoosp_con_readledstchn(aoosp_tele_t * tele, uint16_t addr, uint8_t chn, uint8_t * respsize) {
-  // Check input parameters
-  if( tele==0                    ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr)     ) return aoresult_osp_addr;
-  if( chn!=0 && chn!=1 && chn!=2 ) return aoresult_osp_arg;
-
-  // Set constants
-  const uint8_t payloadsize = 1; // chn
-  const uint8_t tid = 0x46; // READLEDST
-  if( respsize ) *respsize = 4+1; // ledst
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = chn;
-
-  tele->data[4] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  const uint32_t args[] = { chn };
+  aoresult_t result = aoosp_codec_encode(tele, AOOSP_IX_READLEDSTCHN, addr, args, respsize);
+  if( result==aoresult_ok && chn>2 ) result = aoresult_osp_arg; // chn must be 0, 1 or 2
+  return result;
 }
 
 
 static aoresult_t aoosp_des_readledstchn(aoosp_tele_t * tele, uint8_t * ledst) {
-  // Set constants
-  const uint8_t payloadsize = 1; // ledst
-  // Check telegram consistency
-  if( tele==0 || ledst==0                      ) return aoresult_outargnull;
-  if( tele->size!=4+payloadsize                ) return aoresult_osp_size;
-  if( TELEPSI(tele)!=SIZE2PSI(payloadsize)     ) return aoresult_osp_psi;
-  if( BITS_SLICE(tele->data[0],4,8)!=0xA       ) return aoresult_osp_preamble;
-  if( BITS_SLICE(tele->data[2],0,7)!=0x46      ) return aoresult_osp_tid;
-  if( aoosp_crc(tele->data,tele->size)!=0      ) return aoresult_osp_crc;
-
-  // Get fields
-  *ledst = tele->data[3];
-
+  uint32_t res[1];
+  if( tele==0 || ledst==0 ) return aoresult_outargnull;
+  aoresult_t result = aoosp_codec_decode(tele, AOOSP_IX_READLEDSTCHN, res, 0);
+  if( result!=aoresult_ok ) return result;
+  *ledst= res[0];
   return aoresult_ok;
 }
 
@@ -2789,6 +2742,9 @@ static aoresult_t aoosp_des_readledstchn(aoosp_tele_t * tele, uint8_t * ledst) {
     @note   Although this telegram ID (46) is the same as for READLEDST, the 
             payload is specific for multi channel PWM devices, like SAID.
             For single channel PWM devices like RGBi's, use READLEDST.
+    @note   Only unicast addresses are accepted; a broadcast or group
+            address gives aoresult_osp_addr (the response must come
+            from one node).
     @note   When logging enabled with aoosp_loglevel_set(), logs to Serial.
 */
 aoresult_t aoosp_send_readledstchn(uint16_t addr, uint8_t chn, uint8_t * ledst) {
@@ -2808,9 +2764,11 @@ aoresult_t aoosp_send_readledstchn(uint16_t addr, uint8_t chn, uint8_t * ledst)
   if( spi_result!=aoresult_ok ) result= spi_result;
   if(     result==aoresult_ok ) des_result = aoosp_des_readledstchn(&resp, ledst);
   if( des_result!=aoresult_ok ) result=des_result;
+  if( des_result!=aoresult_ok ) aospi_stat_error(tele.data,tele.size,des_result);
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_READLEDSTCHN, addr, &tele, &resp, con_result, spi_result, des_result);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("readledstchn(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -2836,42 +2794,16 @@ aoresult_t aoosp_send_readledstchn(uint16_t addr, uint8_t chn, uint8_t * ledst)
 
 
 static aoresult_t aoosp_con_readtemp(aoosp_tele_t * tele, uint16_t addr, uint8_t * respsize) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 0;
-  const uint8_t tid = 0x48; // READTEMP
-  if( respsize ) *respsize = 4+1; // temp
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_codec_encode(tele, AOOSP_IX_READTEMP, addr, 0, respsize);
 }
 
 
 static aoresult_t aoosp_des_readtemp(aoosp_tele_t * tele, uint8_t * temp) {
-  // Set constants
-  const uint8_t payloadsize = 1; // temp
-  // Check telegram consistency
-  if( tele==0 || temp==0                       ) return aoresult_outargnull;
-  if( tele->size!=4+payloadsize                ) return aoresult_osp_size;
-  if( TELEPSI(tele)!=SIZE2PSI(payloadsize)     ) return aoresult_osp_psi;
-  if( BITS_SLICE(tele->data[0],4,8)!=0xA       ) return aoresult_osp_preamble;
-  if( BITS_SLICE(tele->data[2],0,7)!=0x48      ) return aoresult_osp_tid;
-  if( aoosp_crc(tele->data,tele->size)!=0      ) return aoresult_osp_crc;
-
-  // Get fields
-  *temp = tele->data[3];
-
+  uint32_t res[1];
+  if( tele==0 || temp==0 ) return aoresult_outargnull;
+  aoresult_t result = aoosp_codec_decode(tele, AOOSP_IX_READTEMP, res, 0);
+  if( result!=aoresult_ok ) return result;
+  *temp= res[0];
   return aoresult_ok;
 }
 
@@ -2887,6 +2819,9 @@ static aoresult_t aoosp_des_readtemp(aoosp_tele_t * tele, uint8_t * temp) {
             When returning aoresult_ok, the output parameter is set.
     @note   Converting raw temperature to Celsius depends on the node type.
             See e.g. `aoosp_prt_temp_rgbi()` or `aoosp_prt_temp_said()`.
+    @note   Only unicast addresses are accepted; a broadcast or group
+            address gives aoresult_osp_addr (the response must come
+            from one node).
     @note   When logging enabled with aoosp_loglevel_set(), logs to Serial.
 */
 aoresult_t aoosp_send_readtemp(uint16_t addr, uint8_t * temp) {
@@ -2906,9 +2841,11 @@ aoresult_t aoosp_send_readtemp(uint16_t addr, uint8_t * temp) {
   if( spi_result!=aoresult_ok ) result= spi_result;
   if(     result==aoresult_ok ) des_result = aoosp_des_readtemp(&resp, temp);
   if( des_result!=aoresult_ok ) result=des_result;
+  if( des_result!=aoresult_ok ) aospi_stat_error(tele.data,tele.size,des_result);
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_READTEMP, addr, &tele, &resp, con_result, spi_result, des_result);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("readtemp(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -2937,42 +2874,16 @@ aoresult_t aoosp_send_readtemp(uint16_t addr, uint8_t * temp) {
 
 
 static aoresult_t aoosp_con_readsetup(aoosp_tele_t * tele, uint16_t addr, uint8_t * respsize) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 0;
-  const uint8_t tid = 0x4C; // READSETUP
-  if( respsize ) *respsize = 4+1; // flags
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_codec_encode(tele, AOOSP_IX_READSETUP, addr, 0, respsize);
 }
 
 
-static aoresult_t aoosp_des_readsetup(aoosp_tele_t * tele, uint8_t *flags ) {
-  // Set constants
-  const uint8_t payloadsize = 1; // flags
-  // Check telegram consistency
-  if( tele==0 || flags==0                      ) return aoresult_outargnull;
-  if( tele->size!=4+payloadsize                ) return aoresult_osp_size;
-  if( TELEPSI(tele)!=SIZE2PSI(payloadsize)     ) return aoresult_osp_psi;
-  if( BITS_SLICE(tele->data[0],4,8)!=0xA       ) return aoresult_osp_preamble;
-  if( BITS_SLICE(tele->data[2],0,7)!=0x4C      ) return aoresult_osp_tid;
-  if( aoosp_crc(tele->data,tele->size)!=0      ) return aoresult_osp_crc;
-
-  // Get fields
-  *flags= tele->data[3];
-
+static aoresult_t aoosp_des_readsetup(aoosp_tele_t * tele, uint8_t * flags) {
+  uint32_t res[1];
+  if( tele==0 || flags==0 ) return aoresult_outargnull;
+  aoresult_t result = aoosp_codec_decode(tele, AOOSP_IX_READSETUP, res, 0);
+  if( result!=aoresult_ok ) return result;
+  *flags= res[0];
   return aoresult_ok;
 }
 
@@ -2986,6 +2897,9 @@ static aoresult_t aoosp_des_readsetup(aoosp_tele_t * tele, uint8_t *flags ) {
             Output parameter returning the setup of the addressed node.
     @return aoresult_ok if all ok, otherwise an error code.
             When returning aoresult_ok, the output parameter is set.
+    @note   Only unicast addresses are accepted; a broadcast or group
+            address gives aoresult_osp_addr (the response must come
+            from one node).
     @note   When logging enabled with aoosp_loglevel_set(), logs to Serial.
 */
 aoresult_t aoosp_send_readsetup(uint16_t addr, uint8_t *flags ) {
@@ -3005,9 +2919,11 @@ aoresult_t aoosp_send_readsetup(uint16_t addr, uint8_t *flags ) {
   if( spi_result!=aoresult_ok ) result= spi_result;
   if(     result==aoresult_ok ) des_result = aoosp_des_readsetup(&resp, flags);
   if( des_result!=aoresult_ok ) result=des_result;
+  if( des_result!=aoresult_ok ) aospi_stat_error(tele.data,tele.size,des_result);
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_READSETUP, addr, &tele, &resp, con_result, spi_result, des_result);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("readsetup(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -3029,27 +2945,8 @@ aoresult_t aoosp_send_readsetup(uint16_t addr, uint8_t *flags ) {
 
 
 static aoresult_t aoosp_con_setsetup(aoosp_tele_t * tele, uint16_t addr, uint8_t flags) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 1; // flags
-  const uint8_t tid = 0x4D; // SETSETUP
-  //if( respsize ) *respsize = 4+0;
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = flags;
-
-  tele->data[4] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  const uint32_t args[] = { flags };
+  return aoosp_codec_encode(tele, AOOSP_IX_SETSETUP, addr, args, 0);
 }
 
 
@@ -3079,6 +2976,7 @@ aoresult_t aoosp_send_setsetup(uint16_t addr, uint8_t flags) {
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_SETSETUP, addr, &tele, 0, con_result, spi_result, aoresult_ok);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("setsetup(0x%03X,0x%02X)",addr,flags);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -3097,46 +2995,17 @@ aoresult_t aoosp_send_setsetup(uint16_t addr, uint8_t flags) {
 
 
 static aoresult_t aoosp_con_readpwm(aoosp_tele_t * tele, uint16_t addr, uint8_t * respsize) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 0;
-  const uint8_t tid = 0x4E; // READPWM
-  if( respsize ) *respsize = 4+6; // red, green, blue
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_codec_encode(tele, AOOSP_IX_READPWM, addr, 0, respsize);
 }
 
 
 // the three 1-bit daytimes flags are clubbed into one daytimes argument
-static aoresult_t aoosp_des_readpwm(aoosp_tele_t * tele, uint16_t *red, uint16_t *green, uint16_t *blue, uint8_t *daytimes) {
-  // Set constants
-  const uint8_t payloadsize = 6; // red hi, red lo, grn hi, grn lo, blu hi, blu lo
-  // Check telegram consistency
+static aoresult_t aoosp_des_readpwm(aoosp_tele_t * tele, uint16_t * red, uint16_t * green, uint16_t * blue, uint8_t * daytimes) {
+  uint32_t res[4];
   if( tele==0 || red==0 || green==0 || blue==0 || daytimes==0 ) return aoresult_outargnull;
-  if( tele->size!=4+payloadsize                               ) return aoresult_osp_size;
-  if( TELEPSI(tele)!=SIZE2PSI(payloadsize)                    ) return aoresult_osp_psi;
-  if( BITS_SLICE(tele->data[0],4,8)!=0xA                      ) return aoresult_osp_preamble;
-  if( BITS_SLICE(tele->data[2],0,7)!=0x4E                     ) return aoresult_osp_tid;
-  if( aoosp_crc(tele->data,tele->size)!=0                     ) return aoresult_osp_crc;
-
-  // Get fields
-  *red  = BITS_SLICE(tele->data[3],0,7)<<8 | tele->data[4] ;
-  *green= BITS_SLICE(tele->data[5],0,7)<<8 | tele->data[6] ;
-  *blue = BITS_SLICE(tele->data[7],0,7)<<8 | tele->data[8] ;
-  *daytimes = BITS_SLICE(tele->data[3],7,8)<<2 | BITS_SLICE(tele->data[5],7,8)<<1 |  BITS_SLICE(tele->data[7],7,8);
-
+  aoresult_t result = aoosp_codec_decode(tele, AOOSP_IX_READPWM, res, 0);
+  if( result!=aoresult_ok ) return result;
+  *red= res[0]; *green= res[1]; *blue= res[2]; *daytimes= res[3];
   return aoresult_ok;
 }
 
@@ -3161,6 +3030,9 @@ static aoresult_t aoosp_des_readpwm(aoosp_tele_t * tele, uint16_t *red, uint16_t
     @note   Although this telegram ID (4E) is the same as for READPWMCHN, the 
             payload is specific for single channel PWM devices like RGBi's. 
             For multi channel PWM devices, like SAID, use READPWMCHN.
+    @note   Only unicast addresses are accepted; a broadcast or group
+            address gives aoresult_osp_addr (the response must come
+            from one node).
     @note   When logging enabled with aoosp_loglevel_set(), logs to Serial.
 */
 aoresult_t aoosp_send_readpwm(uint16_t addr, uint16_t *red, uint16_t *green, uint16_t *blue, uint8_t *daytimes) {
@@ -3180,9 +3052,11 @@ aoresult_t aoosp_send_readpwm(uint16_t addr, uint16_t *red, uint16_t *green, uin
   if( spi_result!=aoresult_ok ) result= spi_result;
   if(     result==aoresult_ok ) des_result = aoosp_des_readpwm(&resp, red, green, blue, daytimes);
   if( des_result!=aoresult_ok ) result=des_result;
+  if( des_result!=aoresult_ok ) aospi_stat_error(tele.data,tele.size,des_result);
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_READPWM, addr, &tele, &resp, con_result, spi_result, des_result);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("readpwm(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -3204,48 +3078,20 @@ aoresult_t aoosp_send_readpwm(uint16_t addr, uint16_t *red, uint16_t *green, uin
 
 
 static aoresult_t aoosp_con_readpwmchn(aoosp_tele_t * tele, uint16_t addr, uint8_t chn, uint8_t * respsize) {
-  // Check input parameters
-  if( tele==0                    ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr)     ) return aoresult_osp_addr;
-  if( chn!=0 && chn!=1 && chn!=2 ) return aoresult_osp_arg;
-
-  // Set constants
-  const uint8_t payloadsize = 1; // chn
-  const uint8_t tid = 0x4E; // READPWMCHN
-  if( respsize ) *respsize = 4+6; // red, green, blue
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = chn;
-
-  tele->data[4] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  const uint32_t args[] = { chn };
+  aoresult_t result = aoosp_codec_encode(tele, AOOSP_IX_READPWMCHN, addr, args, respsize);
+  if( result==aoresult_ok && chn>2 ) result = aoresult_osp_arg; // chn must be 0, 1 or 2
+  return result;
 }
 
 
 // the meaning of the 16 color bits varies, not detailed here at telegram level
-static aoresult_t aoosp_des_readpwmchn(aoosp_tele_t * tele, uint16_t *red, uint16_t *green, uint16_t *blue ) {
-  // Set constants
-  const uint8_t payloadsize = 6; // red hi, red lo, grn hi, grn lo, blu hi, blu lo
-  // Check telegram consistency
+static aoresult_t aoosp_des_readpwmchn(aoosp_tele_t * tele, uint16_t * red, uint16_t * green, uint16_t * blue) {
+  uint32_t res[3];
   if( tele==0 || red==0 || green==0 || blue==0 ) return aoresult_outargnull;
-  if( tele->size!=4+payloadsize                ) return aoresult_osp_size;
-  if( TELEPSI(tele)!=SIZE2PSI(payloadsize)     ) return aoresult_osp_psi;
-  if( BITS_SLICE(tele->data[0],4,8)!=0xA       ) return aoresult_osp_preamble;
-  if( BITS_SLICE(tele->data[2],0,7)!=0x4E      ) return aoresult_osp_tid;
-  if( aoosp_crc(tele->data,tele->size)!=0      ) return aoresult_osp_crc;
-
-  // Get fields
-  *red  = tele->data[3]<<8 | tele->data[4] ;
-  *green= tele->data[5]<<8 | tele->data[6] ;
-  *blue = tele->data[7]<<8 | tele->data[8] ;
-
+  aoresult_t result = aoosp_codec_decode(tele, AOOSP_IX_READPWMCHN, res, 0);
+  if( result!=aoresult_ok ) return result;
+  *red= res[0]; *green= res[1]; *blue= res[2];
   return aoresult_ok;
 }
 
@@ -3271,6 +3117,9 @@ static aoresult_t aoosp_des_readpwmchn(aoosp_tele_t * tele, uint16_t *red, uint1
             For single channel PWM devices, like RGBi, use READPWM.
     @note   The meaning of the 16 bits varies, they are not detailed 
             here at telegram level.
+    @note   Only unicast addresses are accepted; a broadcast or group
+            address gives aoresult_osp_addr (the response must come
+            from one node).
     @note   When logging enabled with aoosp_loglevel_set(), logs to Serial.
 */
 aoresult_t aoosp_send_readpwmchn(uint16_t addr, uint8_t chn, uint16_t *red, uint16_t *green, uint16_t *blue ) {
@@ -3290,9 +3139,11 @@ aoresult_t aoosp_send_readpwmchn(uint16_t addr, uint8_t chn, uint16_t *red, uint
   if( spi_result!=aoresult_ok ) result= spi_result;
   if(     result==aoresult_ok ) des_result = aoosp_des_readpwmchn(&resp, red, green, blue);
   if( des_result!=aoresult_ok ) result=des_result;
+  if( des_result!=aoresult_ok ) aospi_stat_error(tele.data,tele.size,des_result);
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_READPWMCHN, addr, &tele, &resp, con_result, spi_result, des_result);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("readpwmchn(0x%03X,%X)",addr,chn);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -3314,36 +3165,8 @@ aoresult_t aoosp_send_readpwmchn(uint16_t addr, uint8_t chn, uint16_t *red, uint
 
 
 static aoresult_t aoosp_con_setpwm(aoosp_tele_t * tele, uint16_t addr, uint16_t red, uint16_t green, uint16_t blue, uint8_t daytimes) {
-  // Check input parameters
-  if( tele==0                   ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr)    ) return aoresult_osp_addr;
-  if( red      & ~BITS_MASK(15) ) return aoresult_osp_arg;
-  if( green    & ~BITS_MASK(15) ) return aoresult_osp_arg;
-  if( blue     & ~BITS_MASK(15) ) return aoresult_osp_arg;
-  if( daytimes & ~BITS_MASK(3)  ) return aoresult_osp_arg;
-
-  // Set constants
-  const uint8_t payloadsize = 6; // red hi, red lo, grn hi, grn lo, blu hi, blu lo
-  const uint8_t tid = 0x4F; // SETPWM
-  //if( respsize ) *respsize = 4+0;
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = BITS_SLICE(daytimes,2,3)<<7 | BITS_SLICE(red,8,15);
-  tele->data[4] = BITS_SLICE(red,0,8);
-  tele->data[5] = BITS_SLICE(daytimes,1,2)<<7 | BITS_SLICE(green,8,15);
-  tele->data[6] = BITS_SLICE(green,0,8);
-  tele->data[7] = BITS_SLICE(daytimes,0,1)<<7 | BITS_SLICE(blue,8,15);
-  tele->data[8] = BITS_SLICE(blue,0,8);
-
-  tele->data[9] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  const uint32_t args[] = { red, green, blue, daytimes };
+  return aoosp_codec_encode(tele, AOOSP_IX_SETPWM, addr, args, 0);
 }
 
 
@@ -3385,6 +3208,7 @@ aoresult_t aoosp_send_setpwm(uint16_t addr, uint16_t red, uint16_t green, uint16
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_SETPWM, addr, &tele, 0, con_result, spi_result, aoresult_ok);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("setpwm(0x%03X,0x%04X,0x%04X,0x%04X,%X)",addr,red,green,blue,daytimes);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -3403,47 +3227,234 @@ aoresult_t aoosp_send_setpwm(uint16_t addr, uint16_t red, uint16_t green, uint16
 
 
 static aoresult_t aoosp_con_setpwmchn(aoosp_tele_t * tele, uint16_t addr, uint8_t chn, uint16_t red, uint16_t green, uint16_t blue) {
+  const uint32_t args[] = { chn, 0xFF, red, green, blue };
+  aoresult_t result = aoosp_codec_encode(tele, AOOSP_IX_SETPWMCHN, addr, args, 0);
+  if( result==aoresult_ok && chn>2 ) result = aoresult_osp_arg; // chn must be 0, 1 or 2
+  return result;
+}
+
+
+/*!
+    @brief  Sends a SETPWMCHN telegram.
+            Configures the PWM settings of one channel of the addressed node.
+    @param  addr
+            The address to send the telegram to (unicast),
+            (use 0 for broadcast, or 3F0..3FE for group).
+    @param  chn
+            The channel of the node for which the PWM settings are configured.
+    @param  red
+            The PWM setting for red (16 bit).
+    @param  green
+            The PWM setting for green (16 bit).
+    @param  blue
+            The PWM setting for blue (16 bit).
+    @return aoresult_ok if all ok, otherwise an error code.
+    @note   A node must be active in order for the PWMs to switch on.
+    @note   Although this telegram ID (4F) is the same as for SETPWM, the 
+            payload is specific for multi channel PWM devices like SAIDs. 
+            For single channel PWM devices, like RGBi, use SETPWM.
+    @note   The meaning of the 16 bits varies, they are not detailed 
+            here at telegram level. For SAID the 15 MSB bits form the PWM
+            value, and the LSB bit en/disables dithering (this may be 
+            regarded as bit 16 of PWM value).
+    @note   When logging enabled with aoosp_loglevel_set(), logs to Serial.
+*/
+aoresult_t aoosp_send_setpwmchn(uint16_t addr, uint8_t chn, uint16_t red, uint16_t green, uint16_t blue) {
+  // Telegram and result vars
+  aoosp_tele_t tele;
+  aoresult_t   result    = aoresult_ok;
+  aoresult_t   con_result= aoresult_ok;
+  aoresult_t   spi_result= aoresult_ok;
+
+  // Construct, send and optionally destruct
+  if(     result==aoresult_ok ) con_result= aoosp_con_setpwmchn(&tele, addr, chn, red, green, blue);
+  if( con_result!=aoresult_ok ) result=con_result;
+  if(     result==aoresult_ok ) spi_result= aospi_tx(tele.data,tele.size);
+  if( spi_result!=aoresult_ok ) result= spi_result;
+
+  // Log
+  #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_SETPWMCHN, addr, &tele, 0, con_result, spi_result, aoresult_ok);
+  if( aoosp_loglevel >= aoosp_loglevel_args ) {
+    PRINTF("setpwmchn(0x%03X,%X,0x%04X,0x%04X,0x%04X)",addr,chn,red,green,blue);
+    if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
+    if( con_result!=aoresult_ok ) PRINTF(" [constructor ERROR %s]", aoresult_to_str(con_result,0) );
+      else if( spi_result!=aoresult_ok ) PRINTF(" [SPI ERROR %s]", aoresult_to_str((aoresult_t)spi_result,0) );
+    PRINTF("\n" );
+  }
+  #endif // AOOSP_LOG_ENABLED
+
+  return result;
+}
+
+
+// ==========================================================================
+// Telegram 4F SETPWM and SETPWMCHN with a prebuilt header
+
+
+// Per-frame PWM refresh is the bulk of the OSP traffic, and the first bytes of
+// those telegrams are constant per node (SETPWM: preamble, address, PSI, TID)
+// or per node and channel (SETPWMCHN: also chn and the dummy byte). An
+// aoosp_pwmhdr_t holds those bytes and the CRC state after them. It is built
+// once (aoosp_pwmhdr_setpwm/aoosp_pwmhdr_setpwmchn); each PWM update then
+// copies it, encodes only the payload and finishes the CRC with aoosp_crc_update().
+// The payload encoding below must match aoosp_layout_pwm and aoosp_layout_setpwmchn.
+
+
+/*!
+    @brief  Prebuilds the constant part of SETPWM telegrams to `addr`.
+    @param  hdr
+            Caller allocated; filled with the telegram header and its CRC state.
+    @param  addr
+            The address the telegrams will be sent to (unicast),
+            (use 0 for broadcast, or 3F0..3FE for group).
+    @return aoresult_ok if all ok, otherwise an error code.
+    @note   Use with aoosp_send_setpwm_hdr().
+    @note   The header must be rebuilt when the node gets another address
+            (e.g. aomw_topo rebuilds its headers on every scan).
+*/
+aoresult_t aoosp_pwmhdr_setpwm(aoosp_pwmhdr_t * hdr, uint16_t addr) {
+  aoosp_tele_t tele;
+  if( hdr==0 ) return aoresult_outargnull;
+  const uint32_t args[] = { 0, 0, 0, 0 };
+  aoresult_t result = aoosp_codec_encode(&tele, AOOSP_IX_SETPWM, addr, args, 0);
+  if( result!=aoresult_ok ) return result;
+  hdr->size = 3; // header
+  memcpy( hdr->data, tele.data, hdr->size );
+  hdr->crc  = aoosp_crc_update( 0, hdr->data, hdr->size );
+  return aoresult_ok;
+}
+
+
+/*!
+    @brief  Prebuilds the constant part of SETPWMCHN telegrams to `addr`, channel `chn`.
+    @param  hdr
+            Caller allocated; filled with the telegram header, chn and dummy 
+            byte, and their CRC state.
+    @param  addr
+            The address the telegrams will be sent to (unicast),
+            (use 0 for broadcast, or 3F0..3FE for group).
+    @param  chn
+            The channel of the node the telegrams will configure (0, 1 or 2).
+    @return aoresult_ok if all ok, otherwise an error code.
+    @note   Use with aoosp_send_setpwmchn_hdr().
+    @note   The header must be rebuilt when the node gets another address
+            (e.g. aomw_topo rebuilds its headers on every scan).
+*/
+aoresult_t aoosp_pwmhdr_setpwmchn(aoosp_pwmhdr_t * hdr, uint16_t addr, uint8_t chn) {
+  aoosp_tele_t tele;
+  if( hdr==0 ) return aoresult_outargnull;
+  aoresult_t result = aoosp_con_setpwmchn(&tele, addr, chn, 0, 0, 0);
+  if( result!=aoresult_ok ) return result;
+  hdr->size = 5; // header, chn, dummy
+  memcpy( hdr->data, tele.data, hdr->size );
+  hdr->crc  = aoosp_crc_update( 0, hdr->data, hdr->size );
+  return aoresult_ok;
+}
+
+
+// Returns the address in the header of the (prebuilt) telegram `data`
+#define AOOSP_PWMHDR_ADDR(data) ( BITS_SLICE((data)[0],0,4)<<6 | BITS_SLICE((data)[1],2,8) )
+
+
+static aoresult_t aoosp_con_setpwm_hdr(aoosp_tele_t * tele, const aoosp_pwmhdr_t * hdr, uint16_t red, uint16_t green, uint16_t blue, uint8_t daytimes) {
   // Check input parameters
   if( tele==0                    ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr)     ) return aoresult_osp_addr;
-  if( chn!=0 && chn!=1 && chn!=2 ) return aoresult_osp_arg;
+  tele->size    = 0; // an empty telegram for the log, in case of an error
+  if( hdr==0                     ) return aoresult_outargnull;
+  if( hdr->size!=3               ) return aoresult_osp_arg; // not a SETPWM header
+  if( red      & ~BITS_MASK(15)  ) return aoresult_osp_arg;
+  if( green    & ~BITS_MASK(15)  ) return aoresult_osp_arg;
+  if( blue     & ~BITS_MASK(15)  ) return aoresult_osp_arg;
+  if( daytimes & ~BITS_MASK(3)   ) return aoresult_osp_arg;
+  // Build telegram: copy header, encode payload (see aoosp_layout_pwm), continue CRC
+  tele->size    = 4+6;
+  memcpy( tele->data, hdr->data, 3 );
+  tele->data[3] = BITS_SLICE(daytimes,2,3)<<7 | BITS_SLICE(red,8,15);
+  tele->data[4] = BITS_SLICE(red,0,8);
+  tele->data[5] = BITS_SLICE(daytimes,1,2)<<7 | BITS_SLICE(green,8,15);
+  tele->data[6] = BITS_SLICE(green,0,8);
+  tele->data[7] = BITS_SLICE(daytimes,0,1)<<7 | BITS_SLICE(blue,8,15);
+  tele->data[8] = BITS_SLICE(blue,0,8);
+  tele->data[9] = aoosp_crc_update( hdr->crc, &tele->data[3], 6 );
+  return aoresult_ok;
+}
 
-  // Set constants
-  const uint8_t payloadsize = 8; // chn, dummy, red hi, red lo, grn hi, grn lo, blu hi, blu lo
-  const uint8_t tid = 0x4F; // SETPWMCHN (same SETPWM of OSP V1)
-  //if( respsize ) *respsize = 4+0;
 
-  // Build telegram
-  tele->size    = payloadsize+4;
+/*!
+    @brief  Sends a SETPWM telegram, using a prebuilt header.
+            Configures the PWM settings of the node the header was built for.
+    @param  hdr
+            The header, built by aoosp_pwmhdr_setpwm().
+    @param  red
+            The PWM setting for red (15 bit).
+    @param  green
+            The PWM setting for green (15 bit).
+    @param  blue
+            The PWM setting for blue (15 bit).
+    @param  daytimes
+            The daytime flags (3 bit):
+            bit 2 indicates daytime for red, bit 1 for green, 0 for blue.
+    @return aoresult_ok if all ok, otherwise an error code.
+    @note   Sends the same telegram as aoosp_send_setpwm(), but only encodes
+            the payload; the header and its CRC state come from `hdr`.
+    @note   When logging enabled with aoosp_loglevel_set(), logs to Serial.
+*/
+aoresult_t aoosp_send_setpwm_hdr(const aoosp_pwmhdr_t * hdr, uint16_t red, uint16_t green, uint16_t blue, uint8_t daytimes) {
+  // Telegram and result vars
+  aoosp_tele_t tele;
+  aoresult_t   result    = aoresult_ok;
+  aoresult_t   con_result= aoresult_ok;
+  aoresult_t   spi_result= aoresult_ok;
 
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
+  // Construct, send and optionally destruct
+  if(     result==aoresult_ok ) con_result= aoosp_con_setpwm_hdr(&tele, hdr, red, green, blue, daytimes);
+  if( con_result!=aoresult_ok ) result=con_result;
+  if(     result==aoresult_ok ) spi_result= aospi_tx(tele.data,tele.size);
+  if( spi_result!=aoresult_ok ) result= spi_result;
+
+  // Log
+  #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_SETPWM, (hdr ? AOOSP_PWMHDR_ADDR(hdr->data) : 0), &tele, 0, con_result, spi_result, aoresult_ok);
+  if( aoosp_loglevel >= aoosp_loglevel_args ) {
+    PRINTF("setpwm(0x%03X,0x%04X,0x%04X,0x%04X,%X)",hdr ? AOOSP_PWMHDR_ADDR(hdr->data) : 0,red,green,blue,daytimes);
+    if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
+    if( con_result!=aoresult_ok ) PRINTF(" [constructor ERROR %s]", aoresult_to_str(con_result,0) );
+      else if( spi_result!=aoresult_ok ) PRINTF(" [SPI ERROR %s]", aoresult_to_str((aoresult_t)spi_result,0) );
+    PRINTF("\n" );
+  }
+  #endif // AOOSP_LOG_ENABLED
+
+  return result;
+}
 
-  tele->data[3] = chn;
-  tele->data[4] = 0xFF; // dummy;
 
+static aoresult_t aoosp_con_setpwmchn_hdr(aoosp_tele_t * tele, const aoosp_pwmhdr_t * hdr, uint16_t red, uint16_t green, uint16_t blue) {
+  // Check input parameters
+  if( tele==0                    ) return aoresult_outargnull;
+  tele->size    = 0; // an empty telegram for the log, in case of an error
+  if( hdr==0                     ) return aoresult_outargnull;
+  if( hdr->size!=5               ) return aoresult_osp_arg; // not a SETPWMCHN header
+  // Build telegram: copy header/chn/dummy, encode payload (see aoosp_layout_setpwmchn), continue CRC
+  tele->size    = 4+8;
+  memcpy( tele->data, hdr->data, 5 );
   tele->data[5] = BITS_SLICE(red,8,16);
   tele->data[6] = BITS_SLICE(red,0,8);
   tele->data[7] = BITS_SLICE(green,8,16);
   tele->data[8] = BITS_SLICE(green,0,8);
   tele->data[9] = BITS_SLICE(blue,8,16);
   tele->data[10]= BITS_SLICE(blue,0,8);
-
-  tele->data[11] = aoosp_crc( tele->data , tele->size - 1 );
-
+  tele->data[11]= aoosp_crc_update( hdr->crc, &tele->data[5], 6 );
   return aoresult_ok;
 }
 
 
 /*!
-    @brief  Sends a SETPWMCHN telegram.
-            Configures the PWM settings of one channel of the addressed node.
-    @param  addr
-            The address to send the telegram to (unicast),
-            (use 0 for broadcast, or 3F0..3FE for group).
-    @param  chn
-            The channel of the node for which the PWM settings are configured.
+    @brief  Sends a SETPWMCHN telegram, using a prebuilt header.
+            Configures the PWM settings of the node and channel the header
+            was built for.
+    @param  hdr
+            The header, built by aoosp_pwmhdr_setpwmchn().
     @param  red
             The PWM setting for red (16 bit).
     @param  green
@@ -3451,17 +3462,11 @@ static aoresult_t aoosp_con_setpwmchn(aoosp_tele_t * tele, uint16_t addr, uint8_
     @param  blue
             The PWM setting for blue (16 bit).
     @return aoresult_ok if all ok, otherwise an error code.
-    @note   A node must be active in order for the PWMs to switch on.
-    @note   Although this telegram ID (4F) is the same as for SETPWM, the 
-            payload is specific for multi channel PWM devices like SAIDs. 
-            For single channel PWM devices, like RGBi, use SETPWM.
-    @note   The meaning of the 16 bits varies, they are not detailed 
-            here at telegram level. For SAID the 15 MSB bits form the PWM
-            value, and the LSB bit en/disables dithering (this may be 
-            regarded as bit 16 of PWM value).
+    @note   Sends the same telegram as aoosp_send_setpwmchn(), but only encodes
+            the payload; header, chn and their CRC state come from `hdr`.
     @note   When logging enabled with aoosp_loglevel_set(), logs to Serial.
 */
-aoresult_t aoosp_send_setpwmchn(uint16_t addr, uint8_t chn, uint16_t red, uint16_t green, uint16_t blue) {
+aoresult_t aoosp_send_setpwmchn_hdr(const aoosp_pwmhdr_t * hdr, uint16_t red, uint16_t green, uint16_t blue) {
   // Telegram and result vars
   aoosp_tele_t tele;
   aoresult_t   result    = aoresult_ok;
@@ -3469,15 +3474,16 @@ aoresult_t aoosp_send_setpwmchn(uint16_t addr, uint8_t chn, uint16_t red, uint16
   aoresult_t   spi_result= aoresult_ok;
 
   // Construct, send and optionally destruct
-  if(     result==aoresult_ok ) con_result= aoosp_con_setpwmchn(&tele, addr, chn, red, green, blue);
+  if(     result==aoresult_ok ) con_result= aoosp_con_setpwmchn_hdr(&tele, hdr, red, green, blue);
   if( con_result!=aoresult_ok ) result=con_result;
   if(     result==aoresult_ok ) spi_result= aospi_tx(tele.data,tele.size);
   if( spi_result!=aoresult_ok ) result= spi_result;
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_SETPWMCHN, (hdr ? AOOSP_PWMHDR_ADDR(hdr->data) : 0), &tele, 0, con_result, spi_result, aoresult_ok);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
-    PRINTF("setpwmchn(0x%03X,%X,0x%04X,0x%04X,0x%04X)",addr,chn,red,green,blue);
+    PRINTF("setpwmchn(0x%03X,%X,0x%04X,0x%04X,0x%04X)",hdr ? AOOSP_PWMHDR_ADDR(hdr->data) : 0,hdr ? hdr->data[3] : 0,red,green,blue);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
     if( con_result!=aoresult_ok ) PRINTF(" [constructor ERROR %s]", aoresult_to_str(con_result,0) );
       else if( spi_result!=aoresult_ok ) PRINTF(" [SPI ERROR %s]", aoresult_to_str((aoresult_t)spi_result,0) );
@@ -3494,48 +3500,19 @@ aoresult_t aoosp_send_setpwmchn(uint16_t addr, uint8_t chn, uint16_t red, uint16
 
 
 static aoresult_t aoosp_con_readcurchn(aoosp_tele_t * tele, uint16_t addr, uint8_t chn, uint8_t * respsize) {
-  // Check input parameters
-  if( tele==0                    ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr)     ) return aoresult_osp_addr;
-  if( chn!=0 && chn!=1 && chn!=2 ) return aoresult_osp_arg;
-
-  // Set constants
-  const uint8_t payloadsize = 1; // chn
-  const uint8_t tid = 0x50; // READCURCHN
-  if( respsize ) *respsize = 4+2; // 3*4 PWM bits, 4 flags
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = chn;
-
-  tele->data[4] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  const uint32_t args[] = { chn };
+  aoresult_t result = aoosp_codec_encode(tele, AOOSP_IX_READCURCHN, addr, args, respsize);
+  if( result==aoresult_ok && chn>2 ) result = aoresult_osp_arg; // chn must be 0, 1 or 2
+  return result;
 }
 
 
-static aoresult_t aoosp_des_readcurchn(aoosp_tele_t * tele, uint8_t *flags, uint8_t *rcur, uint8_t *gcur, uint8_t *bcur ) {
-  // Set constants
-  const uint8_t payloadsize = 2; // flags|rcur, gcur|bcur
-  // Check telegram consistency
+static aoresult_t aoosp_des_readcurchn(aoosp_tele_t * tele, uint8_t * flags, uint8_t * rcur, uint8_t * gcur, uint8_t * bcur) {
+  uint32_t res[4];
   if( tele==0 || flags==0 || rcur==0 || gcur==0 || bcur==0 ) return aoresult_outargnull;
-  if( tele->size!=4+payloadsize                            ) return aoresult_osp_size;
-  if( TELEPSI(tele)!=SIZE2PSI(payloadsize)                 ) return aoresult_osp_psi;
-  if( BITS_SLICE(tele->data[0],4,8)!=0xA                   ) return aoresult_osp_preamble;
-  if( BITS_SLICE(tele->data[2],0,7)!=0x50                  ) return aoresult_osp_tid;
-  if( aoosp_crc(tele->data,tele->size)!=0                  ) return aoresult_osp_crc;
-
-  // Get fields
-  *flags= BITS_SLICE(tele->data[3],4,8);
-  *rcur  = BITS_SLICE(tele->data[3],0,4);
-  *gcur= BITS_SLICE(tele->data[4],4,8);
-  *bcur = BITS_SLICE(tele->data[4],0,4);
-
+  aoresult_t result = aoosp_codec_decode(tele, AOOSP_IX_READCURCHN, res, 0);
+  if( result!=aoresult_ok ) return result;
+  *flags= res[0]; *rcur= res[1]; *gcur= res[2]; *bcur= res[3];
   return aoresult_ok;
 }
 
@@ -3558,6 +3535,9 @@ static aoresult_t aoosp_des_readcurchn(aoosp_tele_t * tele, uint8_t *flags, uint
             Output parameter returning the current level for blue of the addressed node and channel.
     @return aoresult_ok if all ok, otherwise an error code.
             When returning aoresult_ok, the output parameters are set.
+    @note   Only unicast addresses are accepted; a broadcast or group
+            address gives aoresult_osp_addr (the response must come
+            from one node).
     @note   When logging enabled with aoosp_loglevel_set(), logs to Serial.
 */
 aoresult_t aoosp_send_readcurchn(uint16_t addr, uint8_t chn, uint8_t *flags, uint8_t *rcur, uint8_t *gcur, uint8_t *bcur ) {
@@ -3577,9 +3557,11 @@ aoresult_t aoosp_send_readcurchn(uint16_t addr, uint8_t chn, uint8_t *flags, uin
   if( spi_result!=aoresult_ok ) result= spi_result;
   if(     result==aoresult_ok ) des_result = aoosp_des_readcurchn(&resp, flags, rcur, gcur, bcur);
   if( des_result!=aoresult_ok ) result=des_result;
+  if( des_result!=aoresult_ok ) aospi_stat_error(tele.data,tele.size,des_result);
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_READCURCHN, addr, &tele, &resp, con_result, spi_result, des_result);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("readcurchn(0x%03X,%X)",addr,chn);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -3604,35 +3586,13 @@ aoresult_t aoosp_send_readcurchn(uint16_t addr, uint8_t chn, uint8_t *flags, uin
 #define AOOSP_CUR_AGE_OK(v)  ( 0b1000<=(v) && (v)<=0b1011 )
 #define AOOSP_CUR_OK(v)      ( AOOSP_CUR_NORM_OK(v) || AOOSP_CUR_AGE_OK(v) )
 static aoresult_t aoosp_con_setcurchn(aoosp_tele_t * tele, uint16_t addr, uint8_t chn, uint8_t flags, uint8_t rcur, uint8_t gcur, uint8_t bcur ) {
-  // Check input parameters
-  if( tele==0                    ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr)     ) return aoresult_osp_addr;
-  if( flags  & ~0x07             ) return aoresult_osp_arg;
-  if( !AOOSP_CUR_OK(rcur)        ) return aoresult_osp_arg;
-  if( !AOOSP_CUR_OK(gcur)        ) return aoresult_osp_arg;
-  if( !AOOSP_CUR_OK(bcur)        ) return aoresult_osp_arg;
-  if( chn!=0 && chn!=1 && chn!=2 ) return aoresult_osp_arg;
-
-  // Set constants
-  const uint8_t payloadsize = 3; // chn, flags|rcur, gcur|bcur
-  const uint8_t tid = 0x51; // SETCURCHN
-  //if( respsize ) *respsize = 4+0;
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = chn;
-
-  tele->data[4] = flags<<4 | rcur;
-  tele->data[5] = gcur<<4 | bcur ;
-
-  tele->data[6] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  const uint32_t args[] = { chn, flags, rcur, gcur, bcur };
+  aoresult_t result = aoosp_codec_encode(tele, AOOSP_IX_SETCURCHN, addr, args, 0);
+  if( result==aoresult_ok && chn>2 ) result = aoresult_osp_arg; // chn must be 0, 1 or 2
+  if( result==aoresult_ok && !AOOSP_CUR_OK(rcur) ) result = aoresult_osp_arg; // not a valid (normal or aging) current setting
+  if( result==aoresult_ok && !AOOSP_CUR_OK(gcur) ) result = aoresult_osp_arg;
+  if( result==aoresult_ok && !AOOSP_CUR_OK(bcur) ) result = aoresult_osp_arg;
+  return result;
 }
 
 
@@ -3671,6 +3631,7 @@ aoresult_t aoosp_send_setcurchn(uint16_t addr, uint8_t chn, uint8_t flags, uint8
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_SETCURCHN, addr, &tele, 0, con_result, spi_result, aoresult_ok);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("setcurchn(0x%03X,%X,%s,%X,%X,%X)",addr,chn,aoosp_prt_curchn(flags),rcur,gcur,bcur);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -3694,42 +3655,16 @@ aoresult_t aoosp_send_setcurchn(uint16_t addr, uint8_t chn, uint8_t flags, uint8
 
 
 static aoresult_t aoosp_con_readadc(aoosp_tele_t * tele, uint16_t addr, uint8_t * respsize) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 0;
-  const uint8_t tid = 0x54; // READADC
-  if( respsize ) *respsize = 4+1; // flags
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_codec_encode(tele, AOOSP_IX_READADC, addr, 0, respsize);
 }
 
 
-static aoresult_t aoosp_des_readadc(aoosp_tele_t * tele, uint8_t *flags ) {
-  // Set constants
-  const uint8_t payloadsize = 1; // flags
-  // Check telegram consistency
-  if( tele==0 || flags==0                      ) return aoresult_outargnull;
-  if( tele->size!=4+payloadsize                ) return aoresult_osp_size;
-  if( TELEPSI(tele)!=SIZE2PSI(payloadsize)     ) return aoresult_osp_psi;
-  if( BITS_SLICE(tele->data[0],4,8)!=0xA       ) return aoresult_osp_preamble;
-  if( BITS_SLICE(tele->data[2],0,7)!=0x54      ) return aoresult_osp_tid;
-  if( aoosp_crc(tele->data,tele->size)!=0      ) return aoresult_osp_crc;
-
-  // Get fields
-  *flags= tele->data[3];
-
+static aoresult_t aoosp_des_readadc(aoosp_tele_t * tele, uint8_t * flags) {
+  uint32_t res[1];
+  if( tele==0 || flags==0 ) return aoresult_outargnull;
+  aoresult_t result = aoosp_codec_decode(tele, AOOSP_IX_READADC, res, 0);
+  if( result!=aoresult_ok ) return result;
+  *flags= res[0];
   return aoresult_ok;
 }
 
@@ -3744,6 +3679,9 @@ static aoresult_t aoosp_des_readadc(aoosp_tele_t * tele, uint8_t *flags ) {
             Output parameter returning the ADC configuration
     @return aoresult_ok if all ok, otherwise an error code.
             When returning aoresult_ok, the output parameter is set.
+    @note   Only unicast addresses are accepted; a broadcast or group
+            address gives aoresult_osp_addr (the response must come
+            from one node).
     @note   When logging enabled with aoosp_loglevel_set(), logs to Serial.
     @note   Use aoosp_send_readadcdat() to retrieve the ADC measurement data, 
             instead of the ADC measurement configuration.
@@ -3766,9 +3704,11 @@ aoresult_t aoosp_send_readadc(uint16_t addr, uint8_t *flags ) {
   if( spi_result!=aoresult_ok ) result= spi_result;
   if(     result==aoresult_ok ) des_result = aoosp_des_readadc(&resp, flags);
   if( des_result!=aoresult_ok ) result=des_result;
+  if( des_result!=aoresult_ok ) aospi_stat_error(tele.data,tele.size,des_result);
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_READADC, addr, &tele, &resp, con_result, spi_result, des_result);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("readadc(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -3790,27 +3730,8 @@ aoresult_t aoosp_send_readadc(uint16_t addr, uint8_t *flags ) {
 
 
 static aoresult_t aoosp_con_setadc(aoosp_tele_t * tele, uint16_t addr, uint8_t flags) {
- // Check input parameters
- if( tele==0                ) return aoresult_outargnull;
- if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
- // Set constants
- const uint8_t payloadsize = 1; // flags
- const uint8_t tid = 0x55; // SETADC
- //if( respsize ) *respsize = 4+0;
-
- // Build telegram
- tele->size    = payloadsize+4;
-
- tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
- tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
- tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
- tele->data[3] = flags;
-
- tele->data[4] = aoosp_crc( tele->data , tele->size - 1 );
-
- return aoresult_ok;
+  const uint32_t args[] = { flags };
+  return aoosp_codec_encode(tele, AOOSP_IX_SETADC, addr, args, 0);
 }
                      
                      
@@ -3914,6 +3835,7 @@ aoresult_t aoosp_send_setadc(uint16_t addr, uint8_t flags) {
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_SETADC, addr, &tele, 0, con_result, spi_result, aoresult_ok);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("setadc(0x%03X,0x%02X)",addr,flags);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -3932,43 +3854,16 @@ aoresult_t aoosp_send_setadc(uint16_t addr, uint8_t flags) {
 
 
 static aoresult_t aoosp_con_readi2ccfg(aoosp_tele_t * tele, uint16_t addr, uint8_t * respsize) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 0;
-  const uint8_t tid = 0x56; // READI2CCFG
-  if( respsize ) *respsize = 4+1; // flags:speed
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_codec_encode(tele, AOOSP_IX_READI2CCFG, addr, 0, respsize);
 }
 
 
-static aoresult_t aoosp_des_readi2ccfg(aoosp_tele_t * tele, uint8_t *flags, uint8_t * speed ) {
-  // Set constants
-  const uint8_t payloadsize = 1; // flags|speed
-  // Check telegram consistency
-  if( tele==0 || flags==0 || speed==0          ) return aoresult_outargnull;
-  if( tele->size!=4+payloadsize                ) return aoresult_osp_size;
-  if( TELEPSI(tele)!=SIZE2PSI(payloadsize)     ) return aoresult_osp_psi;
-  if( BITS_SLICE(tele->data[0],4,8)!=0xA       ) return aoresult_osp_preamble;
-  if( BITS_SLICE(tele->data[2],0,7)!=0x56      ) return aoresult_osp_tid;
-  if( aoosp_crc(tele->data,tele->size)!=0      ) return aoresult_osp_crc;
-
-  // Get fields
-  *flags = BITS_SLICE(tele->data[3],4,8);
-  *speed = BITS_SLICE(tele->data[3],0,4);
-
+static aoresult_t aoosp_des_readi2ccfg(aoosp_tele_t * tele, uint8_t * flags, uint8_t * speed) {
+  uint32_t res[2];
+  if( tele==0 || flags==0 || speed==0 ) return aoresult_outargnull;
+  aoresult_t result = aoosp_codec_decode(tele, AOOSP_IX_READI2CCFG, res, 0);
+  if( result!=aoresult_ok ) return result;
+  *flags= res[0]; *speed= res[1];
   return aoresult_ok;
 }
 
@@ -3987,6 +3882,9 @@ static aoresult_t aoosp_des_readi2ccfg(aoosp_tele_t * tele, uint8_t *flags, uint
     @note   The I2C configuration register also double as I2C status register.
             For example twelve bit addressing and speed are configuration settings,
             whereas interrupt, ack/nack, and busy are status flags.
+    @note   Only unicast addresses are accepted; a broadcast or group
+            address gives aoresult_osp_addr (the response must come
+            from one node).
     @note   When logging enabled with aoosp_loglevel_set(), logs to Serial.
 */
 aoresult_t aoosp_send_readi2ccfg(uint16_t addr, uint8_t *flags, uint8_t *speed ) {
@@ -4006,9 +3904,11 @@ aoresult_t aoosp_send_readi2ccfg(uint16_t addr, uint8_t *flags, uint8_t *speed )
   if( spi_result!=aoresult_ok ) result= spi_result;
   if(     result==aoresult_ok ) des_result = aoosp_des_readi2ccfg(&resp, flags, speed);
   if( des_result!=aoresult_ok ) result=des_result;
+  if( des_result!=aoresult_ok ) aospi_stat_error(tele.data,tele.size,des_result);
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_READI2CCFG, addr, &tele, &resp, con_result, spi_result, des_result);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("readi2ccfg(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -4030,30 +3930,10 @@ aoresult_t aoosp_send_readi2ccfg(uint16_t addr, uint8_t *flags, uint8_t *speed )
 
 
 static aoresult_t aoosp_con_seti2ccfg(aoosp_tele_t * tele, uint16_t addr, uint8_t flags, uint8_t speed ) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-  if( flags & ~0x0F          ) return aoresult_osp_arg;
-  if( speed & ~0x0F          ) return aoresult_osp_arg;
-  if( speed==0               ) return aoresult_osp_arg;
-
-  // Set constants
-  const uint8_t payloadsize = 1; // flags|speed
-  const uint8_t tid = 0x57; // SETI2CCFG
-  //if( respsize ) *respsize = 4+0;
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = flags << 4 | speed;
-
-  tele->data[4] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  const uint32_t args[] = { flags, speed };
+  aoresult_t result = aoosp_codec_encode(tele, AOOSP_IX_SETI2CCFG, addr, args, 0);
+  if( result==aoresult_ok && speed==0 ) result = aoresult_osp_arg; // speed 0 is not allowed
+  return result;
 }
 
 
@@ -4088,6 +3968,7 @@ aoresult_t aoosp_send_seti2ccfg(uint16_t addr, uint8_t flags, uint8_t speed ) {
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_SETI2CCFG, addr, &tele, 0, con_result, spi_result, aoresult_ok);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("seti2ccfg(0x%03X,0x%02X,0x%02X)",addr,flags,speed);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -4106,47 +3987,18 @@ aoresult_t aoosp_send_seti2ccfg(uint16_t addr, uint8_t flags, uint8_t speed ) {
 
 
 static aoresult_t aoosp_con_readotp(aoosp_tele_t * tele, uint16_t addr, uint8_t otpaddr, uint8_t * respsize) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-  if( otpaddr > 0x1F         ) return aoresult_osp_arg;
-
-  // Set constants
-  const uint8_t payloadsize = 1; // otpaddr
-  const uint8_t tid = 0x58; // READOTP
-  if( respsize ) *respsize = 4+8; // otp row
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = otpaddr;
-
-  tele->data[4] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  const uint32_t args[] = { otpaddr };
+  return aoosp_codec_encode(tele, AOOSP_IX_READOTP, addr, args, respsize);
 }
 
 
 static aoresult_t aoosp_des_readotp(aoosp_tele_t * tele, uint8_t * buf, int size) {
-  // Set constants
-  const uint8_t payloadsize = 8; // buf (8 bytes)
-  // Check telegram consistency
-  if( tele==0 || buf==0                        ) return aoresult_outargnull;
-  if( tele->size!=4+payloadsize                ) return aoresult_osp_size;
-  if( TELEPSI(tele)!=SIZE2PSI(payloadsize)     ) return aoresult_osp_psi;
-  if( BITS_SLICE(tele->data[0],4,8)!=0xA       ) return aoresult_osp_preamble;
-  if( BITS_SLICE(tele->data[2],0,7)!=0x58      ) return aoresult_osp_tid;
-  if( aoosp_crc(tele->data,tele->size)!=0      ) return aoresult_osp_crc;
-  if( size<1 || size>8                         ) return aoresult_osp_arg;
-
-  // Get fields
-  // OSP telegrams are big endian, C byte arrays are little endian, so reverse.
+  if( tele==0 || buf==0 ) return aoresult_outargnull;
+  aoresult_t result = aoosp_codec_validate(tele, AOOSP_IX_READOTP, 0);
+  if( result!=aoresult_ok ) return result;
+  if( size<1 || size>8    ) return aoresult_osp_arg;
+  // OSP telegrams are big endian, C byte arrays are little endian, so reverse
   for( int i=0; i<size; i++ ) buf[i] = tele->data[10-i];
-
   return aoresult_ok;
 }
 
@@ -4171,6 +4023,9 @@ static aoresult_t aoosp_des_readotp(aoosp_tele_t * tele, uint8_t * buf, int size
             The mirror is initialized with the OTP content on power on reset.
             However SETOTP writes to this RAM; then the mirror starts to differ from OTP.
     @note   The OTP access takes time, so wait 60us after sending this telegram.
+    @note   Only unicast addresses are accepted; a broadcast or group
+            address gives aoresult_osp_addr (the response must come
+            from one node).
     @note   When logging enabled with aoosp_loglevel_set(), logs to Serial.
 */
 aoresult_t aoosp_send_readotp(uint16_t addr, uint8_t otpaddr, uint8_t * buf, int size) {
@@ -4190,9 +4045,11 @@ aoresult_t aoosp_send_readotp(uint16_t addr, uint8_t otpaddr, uint8_t * buf, int
   if( spi_result!=aoresult_ok ) result= spi_result;
   if(     result==aoresult_ok ) des_result = aoosp_des_readotp(&resp, buf, size);
   if( des_result!=aoresult_ok ) result=des_result;
+  if( des_result!=aoresult_ok ) aospi_stat_error(tele.data,tele.size,des_result);
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_READOTP, addr, &tele, &resp, con_result, spi_result, des_result);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("readotp(0x%03X,0x%02X)",addr,otpaddr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -4226,30 +4083,19 @@ aoresult_t aoosp_send_readotp(uint16_t addr, uint8_t otpaddr, uint8_t * buf, int
 
 
 static aoresult_t aoosp_con_setotp(aoosp_tele_t * tele, uint16_t addr, uint8_t otpaddr, uint8_t * buf, int size) {
+  const aoosp_desc_t * desc = &aoosp_desc[AOOSP_IX_SETOTP];
+  const uint32_t       args[] = { otpaddr };
   // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-  if( otpaddr > 0x1F         ) return aoresult_osp_arg;
-  if( size   != 7            ) return aoresult_osp_arg;
-
-  // Set constants
-  const uint8_t payloadsize = 8; // 1 for otp target address, 7 for buf
-  const uint8_t tid = 0x59; // SETOTP
-  // if( respsize ) *respsize = 4+0; // nothing
-
+  if( tele==0                             ) return aoresult_outargnull;
+  if( !aoosp_codec_castok(desc,addr)      ) return aoresult_osp_addr;
+  if( !aoosp_codec_argsok(desc->cmd,args) ) return aoresult_osp_arg;
+  if( size!=7                             ) return aoresult_osp_arg;
   // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
+  aoosp_codec_begin(tele, desc->tid, addr, desc->cmd->payloadsize);
   // OSP telegrams are big endian, C byte arrays are little endian, so reverse
   for( int i=0; i<size; i++ ) tele->data[9-i] = buf[i];
-  tele->data[10] = otpaddr;
-
-  tele->data[11] = aoosp_crc( tele->data , tele->size - 1 );
-
+  aoosp_codec_pack(tele, desc->cmd, args);
+  aoosp_codec_end(tele);
   return aoresult_ok;
 }
 
@@ -4298,6 +4144,7 @@ aoresult_t aoosp_send_setotp(uint16_t addr, uint8_t otpaddr, uint8_t * buf, int
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_SETOTP, addr, &tele, 0, con_result, spi_result, aoresult_ok);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("setotp(0x%03X,0x%02X,%s)",addr,otpaddr,aoosp_prt_bytes(buf,size) );
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -4320,28 +4167,8 @@ aoresult_t aoosp_send_setotp(uint16_t addr, uint8_t otpaddr, uint8_t * buf, int
 
 
 static aoresult_t aoosp_con_settestdata(aoosp_tele_t * tele, uint16_t addr, uint16_t data ) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 2; // data hi, data lo
-  const uint8_t tid = 0x5B; // SETTESTDATA
-  //if( respsize ) *respsize = 4+0;
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = BITS_SLICE(data,8,16);
-  tele->data[4] = BITS_SLICE(data,0,8);
-
-  tele->data[5] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  const uint32_t args[] = { data };
+  return aoosp_codec_encode(tele, AOOSP_IX_SETTESTDATA, addr, args, 0);
 }
 
 
@@ -4374,6 +4201,7 @@ aoresult_t aoosp_send_settestdata(uint16_t addr, uint16_t data ) {
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_SETTESTDATA, addr, &tele, 0, con_result, spi_result, aoresult_ok);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("settestdata(0x%03X,0x%04X)",addr,data);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -4392,42 +4220,16 @@ aoresult_t aoosp_send_settestdata(uint16_t addr, uint16_t data ) {
 
 
 static aoresult_t aoosp_con_readadcdat(aoosp_tele_t * tele, uint16_t addr, uint8_t * respsize) {
-  // Check input parameters
-  if( tele==0                ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr) ) return aoresult_osp_addr;
-
-  // Set constants
-  const uint8_t payloadsize = 0;
-  const uint8_t tid = 0x5C; // READADCDAT
-  if( respsize ) *respsize = 4+2; // data
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  tele->data[3] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_codec_encode(tele, AOOSP_IX_READADCDAT, addr, 0, respsize);
 }
 
 
-static aoresult_t aoosp_des_readadcdat(aoosp_tele_t * tele, uint16_t *adcdat ) {
-  // Set constants
-  const uint8_t payloadsize = 2; // adcdat hi, adcdat lo
-  // Check telegram consistency
-  if( tele==0 || adcdat==0                     ) return aoresult_outargnull;
-  if( tele->size!=4+payloadsize                ) return aoresult_osp_size;
-  if( TELEPSI(tele)!=SIZE2PSI(payloadsize)     ) return aoresult_osp_psi;
-  if( BITS_SLICE(tele->data[0],4,8)!=0xA       ) return aoresult_osp_preamble;
-  if( BITS_SLICE(tele->data[2],0,7)!=0x5C      ) return aoresult_osp_tid;
-  if( aoosp_crc(tele->data,tele->size)!=0      ) return aoresult_osp_crc;
-
-  // Get fields
-  *adcdat= (tele->data[3] << 8) | (tele->data[4] << 0);
-
+static aoresult_t aoosp_des_readadcdat(aoosp_tele_t * tele, uint16_t * adcdat) {
+  uint32_t res[1];
+  if( tele==0 || adcdat==0 ) return aoresult_outargnull;
+  aoresult_t result = aoosp_codec_decode(tele, AOOSP_IX_READADCDAT, res, 0);
+  if( result!=aoresult_ok ) return result;
+  *adcdat= res[0];
   return aoresult_ok;
 }
 
@@ -4443,6 +4245,9 @@ static aoresult_t aoosp_des_readadcdat(aoosp_tele_t * tele, uint16_t *adcdat ) {
             of the addressed node.
     @return aoresult_ok if all ok, otherwise an error code.
             When returning aoresult_ok, the output parameter is set.
+    @note   Only unicast addresses are accepted; a broadcast or group
+            address gives aoresult_osp_addr (the response must come
+            from one node).
     @note   When logging enabled with aoosp_loglevel_set(), logs to Serial.
     @note   The ADC must first be configured; 
             see aoosp_send_setadc() for details.
@@ -4466,9 +4271,11 @@ aoresult_t aoosp_send_readadcdat(uint16_t addr, uint16_t *adcdat ) {
   if( spi_result!=aoresult_ok ) result= spi_result;
   if(     result==aoresult_ok ) des_result = aoosp_des_readadcdat(&resp, adcdat);
   if( des_result!=aoresult_ok ) result=des_result;
+  if( des_result!=aoresult_ok ) aospi_stat_error(tele.data,tele.size,des_result);
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_READADCDAT, addr, &tele, &resp, con_result, spi_result, des_result);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("readadcdat(0x%03X)",addr);
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -4494,30 +4301,25 @@ aoresult_t aoosp_send_readadcdat(uint16_t addr, uint16_t *adcdat ) {
 // Telegram 5F SETTESTPW
 
 
-static aoresult_t aoosp_con_settestpw(aoosp_tele_t * tele, uint16_t addr, uint64_t pw) {
+// Builds SETTESTPW or SETTESTPW_SR (`ix`) with password `pw` (the 48 bits are copied little endian)
+static aoresult_t aoosp_con_testpw(aoosp_tele_t * tele, aoosp_ix_t ix, uint16_t addr, uint64_t pw, uint8_t * respsize) {
+  const aoosp_desc_t * desc = &aoosp_desc[ix];
   // Check input parameters
   if( tele==0                         ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr)          ) return aoresult_osp_addr;
+  if( !aoosp_codec_castok(desc,addr)  ) return aoresult_osp_addr;
   if( pw & ~0x0000FFFFFFFFFFFFULL     ) return aoresult_osp_arg;
   if( pw == AOOSP_SAID_TESTPW_UNKNOWN ) PRINTF("WARNING: ask ams-OSRAM for TESTPW and see aoosp_said_testpw_get() for how to set it\n");
-
-  // Set constants
-  const uint8_t payloadsize = 6; // pw (6 bytes)
-  const uint8_t tid = 0x5F; // SETTESTPW
-  // if( respsize ) *respsize = 4+0; // nothing
-
   // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
+  aoosp_codec_begin(tele, desc->tid, addr, desc->cmd->payloadsize);
   memcpy( &(tele->data[3]), &pw, 6); // 3..8
+  aoosp_codec_end(tele);
+  if( respsize && desc->resp ) *respsize = 4+desc->resp->payloadsize;
+  return aoresult_ok;
+}
 
-  tele->data[9] = aoosp_crc( tele->data , tele->size - 1 );
 
-  return aoresult_ok;
+static aoresult_t aoosp_con_settestpw(aoosp_tele_t * tele, uint16_t addr, uint64_t pw) {
+  return aoosp_con_testpw(tele, AOOSP_IX_SETTESTPW, addr, pw, 0);
 }
 
 
@@ -4559,6 +4361,7 @@ aoresult_t aoosp_send_settestpw(uint16_t addr, uint64_t pw) {
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_SETTESTPW, addr, &tele, 0, con_result, spi_result, aoresult_ok);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("settestpw(0x%03X,%s)",addr,aoosp_prt_bytes(&pw,6) );
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -4601,47 +4404,17 @@ aoresult_t aoosp_send_settestpw(uint16_t addr, uint64_t pw) {
 
 
 static aoresult_t aoosp_con_settestpw_sr(aoosp_tele_t * tele, uint16_t addr, uint64_t pw, uint8_t * respsize ) {
-  // Check input parameters
-  if( tele==0                         ) return aoresult_outargnull;
-  if( !AOOSP_ADDR_ISOK(addr)          ) return aoresult_osp_addr;
-  if( pw & ~0x0000FFFFFFFFFFFFULL     ) return aoresult_osp_arg;
-  if( pw == AOOSP_SAID_TESTPW_UNKNOWN ) PRINTF("WARNING: ask ams-OSRAM for TESTPW and see aoosp_said_testpw_get() for how to set it\n");
-
-  // Set constants
-  const uint8_t payloadsize = 6; // pw (6 bytes)
-  const uint8_t tid = 0x7F; // SETTESTPW_SR
-  if( respsize ) *respsize = 4+2; // temp,stat
-
-  // Build telegram
-  tele->size    = payloadsize+4;
-
-  tele->data[0] = 0xA0 | BITS_SLICE(addr,6,10);
-  tele->data[1] = BITS_SLICE(addr,0,6)<<2 | BITS_SLICE(SIZE2PSI(payloadsize),1,3);
-  tele->data[2] = BITS_SLICE(SIZE2PSI(payloadsize),0,1)<<7 | tid;
-
-  memcpy( &(tele->data[3]), &pw, 6); // 3..8
-
-  tele->data[9] = aoosp_crc( tele->data , tele->size - 1 );
-
-  return aoresult_ok;
+  return aoosp_con_testpw(tele, AOOSP_IX_SETTESTPW_SR, addr, pw, respsize);
 }
 
 
 static aoresult_t aoosp_des_settestpw_sr(aoosp_tele_t * tele, uint8_t * temp, uint8_t * stat) {
-  // Set constants
-  const uint8_t payloadsize = 2; // temp, stat
-  // Check telegram consistency
-  if( tele==0 || stat==0                       ) return aoresult_outargnull;
-  if( tele->size!=4+payloadsize                ) return aoresult_osp_size;
-  if( TELEPSI(tele)!=SIZE2PSI(payloadsize)     ) return aoresult_osp_psi;
-  if( BITS_SLICE(tele->data[0],4,8)!=0xA       ) return aoresult_osp_preamble;
-  if( BITS_SLICE(tele->data[2],0,7)!=0x7F      ) return aoresult_osp_tid;
-  if( aoosp_crc(tele->data,tele->size)!=0      ) return aoresult_osp_crc;
-
-  // Get fields
-  *temp = tele->data[3];
-  *stat = tele->data[4];
-
+  uint32_t res[2];
+  if( tele==0 || stat==0 ) return aoresult_outargnull;
+  aoresult_t result = aoosp_codec_decode(tele, AOOSP_IX_SETTESTPW_SR, res, 0);
+  if( result!=aoresult_ok ) return result;
+  if( temp ) *temp= res[0];
+  *stat= res[1];
   return aoresult_ok;
 }
 
@@ -4650,8 +4423,7 @@ static aoresult_t aoosp_des_settestpw_sr(aoosp_tele_t * tele, uint8_t * temp, ui
     @brief  Sends a SETTESTPW_SR telegram and receives a status response.
             Sets the password of the addressed node.
     @param  addr
-            The address to send the telegram to (unicast),
-            (theoretically, use 0 for broadcast, or 3F0..3FE for group).
+            The address to send the telegram to (unicast only, as there is a response).
     @param  pw
             The 48 bit password.
     @param  temp
@@ -4669,6 +4441,9 @@ static aoresult_t aoosp_des_settestpw_sr(aoosp_tele_t * tele, uint8_t * temp, ui
     @note   The term "test password" is a misnomer, with the correct password
             the host is authenticated, but not in test mode. The latter is
             a next step via SETTESTDATA.
+    @note   Only unicast addresses are accepted; a broadcast or group
+            address gives aoresult_osp_addr (the response must come
+            from one node).
     @note   When logging enabled with aoosp_loglevel_set(), logs to Serial.
 */
 aoresult_t aoosp_send_settestpw_sr(uint16_t addr, uint64_t pw, uint8_t * temp, uint8_t * stat) {
@@ -4688,9 +4463,11 @@ aoresult_t aoosp_send_settestpw_sr(uint16_t addr, uint64_t pw, uint8_t * temp, u
   if( spi_result!=aoresult_ok ) result= spi_result;
   if(     result==aoresult_ok ) des_result = aoosp_des_settestpw_sr(&resp, temp, stat);
   if( des_result!=aoresult_ok ) result=des_result;
+  if( des_result!=aoresult_ok ) aospi_stat_error(tele.data,tele.size,des_result);
 
   // Log
   #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(AOOSP_IX_SETTESTPW_SR, addr, &tele, &resp, con_result, spi_result, des_result);
   if( aoosp_loglevel >= aoosp_loglevel_args ) {
     PRINTF("settestpw_sr(0x%03X,%s)",addr,aoosp_prt_bytes(&pw,6) );
     if( aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(tele.data,tele.size));
@@ -4707,3 +4484,280 @@ aoresult_t aoosp_send_settestpw_sr(uint16_t addr, uint64_t pw, uint8_t * temp, u
   return result;
 }
 
+
+
+// === BULK ===============================================
+
+
+// Bulk reads
+// ==========
+// A bulk read sends the same read telegram to a list of nodes (of the
+// selected chain) and collects the responses in arrays, one entry per node.
+// Instead of one blocking aospi_txrx() per node, up to AOOSP_SEND_MANY_INFLIGHT
+// requests are submitted with aospi_submit(), so the transport keeps several
+// round trips in flight (FlexCAN with sequence tags), or at least has the next
+// frame queued when the previous response arrives. Responses are collected in
+// order with aospi_wait(); each node gets its own result code.
+
+
+// The state of one request of a bulk read
+typedef struct aoosp_many_slot_s {
+  aospi_req_t  req;  // the asynchronous request
+  aoosp_tele_t tele; // the sent telegram
+  aoosp_tele_t resp; // the response telegram
+  int          node; // index in the address list
+} aoosp_many_slot_t;
+
+// The in-flight window of a bulk read (static to keep it off the task stack)
+static aoosp_many_slot_t aoosp_many_slots[AOOSP_SEND_MANY_INFLIGHT];
+
+// Constructs a read telegram for `addr` (see eg aoosp_con_readtempstat)
+typedef aoresult_t (*aoosp_many_con_t)(aoosp_tele_t * tele, uint16_t addr, uint8_t * respsize);
+// Destructs response `resp` into entry `node` of the output arrays `outs`
+typedef aoresult_t (*aoosp_many_des_t)(aoosp_tele_t * resp, int node, void * const outs[]);
+
+
+// Records the result of node `node` of a bulk read of telegram `ix`, and logs it (`slot` is 0 when nothing was sent).
+static void aoosp_many_done(aoosp_ix_t ix, const char * name, const uint16_t * addrs, int node, aoosp_many_slot_t * slot, aoresult_t con_result, aoresult_t spi_result, aoresult_t des_result, aoresult_t * results, aoresult_t * first) {
+  aoresult_t result= con_result!=aoresult_ok ? con_result : spi_result!=aoresult_ok ? spi_result : des_result;
+  if( results!=0 ) results[node]= result;
+  if( *first==aoresult_ok ) *first= result;
+  #if AOOSP_LOG_ENABLED
+  if( aoosp_loglevel == aoosp_loglevel_ring ) aoosp_logring_put(ix, addrs[node], slot ? &slot->tele : 0, slot ? &slot->resp : 0, con_result, spi_result, des_result);
+  if( aoosp_loglevel >= aoosp_loglevel_args ) {
+    PRINTF("%s_many[%d](0x%03X)",name,node,addrs[node]);
+    if( slot!=0 && aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" [tele %s]",aoosp_prt_bytes(slot->tele.data,slot->tele.size));
+    if( result!=aoresult_ok ) PRINTF(" [ERROR %s]", aoresult_to_str(result,0) );
+    if( slot!=0 && aoosp_loglevel >= aoosp_loglevel_tele ) PRINTF(" -> [resp %s]",aoosp_prt_bytes(slot->resp.data,slot->resp.size));
+    PRINTF("\n");
+  }
+  #else
+  (void)ix; (void)name; (void)addrs; (void)slot;
+  #endif // AOOSP_LOG_ENABLED
+}
+
+
+// Sends the telegram made by `con` to all `n` nodes in `addrs`, and destructs the responses with `des` into `outs`.
+static aoresult_t aoosp_send_many(aoosp_ix_t ix, const char * name, aoosp_many_con_t con, aoosp_many_des_t des, void * const outs[], const uint16_t * addrs, int n, aoresult_t * results) {
+  aoresult_t first= aoresult_ok;
+  int        head = 0; // oldest slot in flight
+  int        count= 0; // number of slots in flight
+  int        next = 0; // next node to submit
+  if( n<0 ) return aoresult_outargnull;
+  if( n>0 && addrs==0 ) return aoresult_outargnull;
+  while( next<n || count>0 ) {
+    if( next<n && count<AOOSP_SEND_MANY_INFLIGHT ) {
+      // Room in the window: construct and submit the telegram for the next node
+      aoosp_many_slot_t * slot= &aoosp_many_slots[(head+count)%AOOSP_SEND_MANY_INFLIGHT];
+      aoresult_t con_result= con(&slot->tele, addrs[next], &slot->resp.size);
+      aoresult_t spi_result= aoresult_ok;
+      if( con_result==aoresult_ok ) {
+        slot->req.done= 0;
+        slot->req.task= 0;
+        spi_result= aospi_submit(&slot->req, slot->tele.data, slot->tele.size, slot->resp.data, slot->resp.size);
+      }
+      if( con_result==aoresult_ok && spi_result==aoresult_ok ) {
+        slot->node= next;
+        count++;
+      } else {
+        aoosp_many_done(ix, name, addrs, next, 0, con_result, spi_result, aoresult_ok, results, &first);
+      }
+      next++;
+    } else {
+      // Window full (or all submitted): collect the oldest response
+      aoosp_many_slot_t * slot= &aoosp_many_slots[head];
+      head= (head+1)%AOOSP_SEND_MANY_INFLIGHT;
+      count--;
+      aoresult_t spi_result= aospi_wait(&slot->req);
+      aoresult_t des_result= aoresult_ok;
+      if( spi_result==aoresult_ok ) {
+        des_result= des(&slot->resp, slot->node, outs);
+        if( des_result!=aoresult_ok ) aospi_stat_error(slot->tele.data,slot->tele.size,des_result);
+      }
+      aoosp_many_done(ix, name, addrs, slot->node, slot, aoresult_ok, spi_result, des_result, results, &first);
+    }
+  }
+  return first;
+}
+
+
+// Destructs a READTEMPSTAT response into entry `node` of outs[0] (temps) and outs[1] (stats).
+static aoresult_t aoosp_many_des_readtempstat(aoosp_tele_t * resp, int node, void * const outs[]) {
+  return aoosp_des_readtempstat(resp, (uint8_t *)outs[0]+node, (uint8_t *)outs[1]+node);
+}
+
+
+/*!
+    @brief  Sends a READTEMPSTAT telegram to each node in a list and 
+            receives the responses, keeping several requests in flight.
+    @param  addrs
+            The addresses to send the telegram to (unicast, all on the 
+            selected chain, see aospi_chain_set()).
+    @param  n
+            The number of addresses in `addrs`.
+    @param  temps
+            Output array (n entries) returning the raw temperature of each node.
+    @param  stats
+            Output array (n entries) returning the (system) status of each node.
+    @param  results
+            Optional output array (n entries, may be NULL) returning the 
+            result of each node; only entries with aoresult_ok have their
+            temps[] and stats[] entries set.
+    @return aoresult_ok if all nodes responded ok, otherwise the first 
+            error code encountered (in address list order).
+    @note   One failing node does not stop the sweep; the other nodes are 
+            still read.
+    @note   Must not be called while posting (aospi_post_begin), since the
+            posted telegrams would be sent after the bulk read telegrams.
+    @note   Not reentrant (the in-flight window is static).
+    @note   When logging enabled with aoosp_loglevel_set(), logs to Serial.
+*/
+aoresult_t aoosp_send_readtempstat_many(const uint16_t * addrs, int n, uint8_t * temps, uint8_t * stats, aoresult_t * results) {
+  void * const outs[]= { temps, stats };
+  if( n>0 && (temps==0 || stats==0) ) return aoresult_outargnull;
+  return aoosp_send_many(AOOSP_IX_READTEMPSTAT, "readtempstat", aoosp_con_readtempstat, aoosp_many_des_readtempstat, outs, addrs, n, results);
+}
+
+
+// Destructs a READSTAT response into entry `node` of outs[0] (stats).
+static aoresult_t aoosp_many_des_readstat(aoosp_tele_t * resp, int node, void * const outs[]) {
+  return aoosp_des_readstat(resp, (uint8_t *)outs[0]+node);
+}
+
+
+/*!
+    @brief  Sends a READSTAT telegram to each node in a list and 
+            receives the responses, keeping several requests in flight.
+    @param  addrs
+            The addresses to send the telegram to (unicast, all on the 
+            selected chain, see aospi_chain_set()).
+    @param  n
+            The number of addresses in `addrs`.
+    @param  stats
+            Output array (n entries) returning the (system) status of each node.
+    @param  results
+            Optional output array (n entries, may be NULL) returning the 
+            result of each node; only entries with aoresult_ok have their
+            stats[] entry set.
+    @return aoresult_ok if all nodes responded ok, otherwise the first 
+            error code encountered (in address list order).
+    @note   See aoosp_send_readtempstat_many() for the other notes.
+*/
+aoresult_t aoosp_send_readstat_many(const uint16_t * addrs, int n, uint8_t * stats, aoresult_t * results) {
+  void * const outs[]= { stats };
+  if( n>0 && stats==0 ) return aoresult_outargnull;
+  return aoosp_send_many(AOOSP_IX_READSTAT, "readstat", aoosp_con_readstat, aoosp_many_des_readstat, outs, addrs, n, results);
+}
+
+
+// Destructs a READCOMST response into entry `node` of outs[0] (coms).
+static aoresult_t aoosp_many_des_readcomst(aoosp_tele_t * resp, int node, void * const outs[]) {
+  return aoosp_des_readcomst(resp, (uint8_t *)outs[0]+node);
+}
+
+
+/*!
+    @brief  Sends a READCOMST telegram to each node in a list and 
+            receives the responses, keeping several requests in flight.
+    @param  addrs
+            The addresses to send the telegram to (unicast, all on the 
+            selected chain, see aospi_chain_set()).
+    @param  n
+            The number of addresses in `addrs`.
+    @param  coms
+            Output array (n entries) returning the communication status of each node.
+    @param  results
+            Optional output array (n entries, may be NULL) returning the 
+            result of each node; only entries with aoresult_ok have their
+            coms[] entry set.
+    @return aoresult_ok if all nodes responded ok, otherwise the first 
+            error code encountered (in address list order).
+    @note   See aoosp_send_readtempstat_many() for the other notes.
+*/
+aoresult_t aoosp_send_readcomst_many(const uint16_t * addrs, int n, uint8_t * coms, aoresult_t * results) {
+  void * const outs[]= { coms };
+  if( n>0 && coms==0 ) return aoresult_outargnull;
+  return aoosp_send_many(AOOSP_IX_READCOMST, "readcomst", aoosp_con_readcomst, aoosp_many_des_readcomst, outs, addrs, n, results);
+}
+
+
+// Destructs an IDENTIFY response into entry `node` of outs[0] (ids).
+static aoresult_t aoosp_many_des_identify(aoosp_tele_t * resp, int node, void * const outs[]) {
+  return aoosp_des_identify(resp, (uint32_t *)outs[0]+node);
+}
+
+
+/*!
+    @brief  Sends an IDENTIFY telegram to each node in a list and 
+            receives the responses, keeping several requests in flight.
+    @param  addrs
+            The addresses to send the telegram to (unicast, all on the 
+            selected chain, see aospi_chain_set()).
+    @param  n
+            The number of addresses in `addrs`.
+    @param  ids
+            Output array (n entries) returning the identity of each node.
+    @param  results
+            Optional output array (n entries, may be NULL) returning the 
+            result of each node; only entries with aoresult_ok have their
+            ids[] entry set.
+    @return aoresult_ok if all nodes responded ok, otherwise the first 
+            error code encountered (in address list order).
+    @note   See aoosp_send_readtempstat_many() for the other notes.
+*/
+aoresult_t aoosp_send_identify_many(const uint16_t * addrs, int n, uint32_t * ids, aoresult_t * results) {
+  void * const outs[]= { ids };
+  if( n>0 && ids==0 ) return aoresult_outargnull;
+  return aoosp_send_many(AOOSP_IX_IDENTIFY, "identify", aoosp_con_identify, aoosp_many_des_identify, outs, addrs, n, results);
+}
+
+
+// The OTP address for aoosp_many_con_readotp() (a bulk read constructor only gets the node address)
+static uint8_t aoosp_many_otpaddr;
+
+
+// Constructs a READOTP telegram for `addr`, for OTP address aoosp_many_otpaddr.
+static aoresult_t aoosp_many_con_readotp(aoosp_tele_t * tele, uint16_t addr, uint8_t * respsize) {
+  return aoosp_con_readotp(tele, addr, aoosp_many_otpaddr, respsize);
+}
+
+
+// Destructs a READOTP response into entry `node` of outs[0] (bufs, *outs[1] bytes per node).
+static aoresult_t aoosp_many_des_readotp(aoosp_tele_t * resp, int node, void * const outs[]) {
+  int size= *(const int *)outs[1];
+  return aoosp_des_readotp(resp, (uint8_t *)outs[0]+node*size, size);
+}
+
+
+/*!
+    @brief  Sends a READOTP telegram to each node in a list and 
+            receives the responses, keeping several requests in flight.
+    @param  addrs
+            The addresses to send the telegram to (unicast, all on the 
+            selected chain, see aospi_chain_set()).
+    @param  n
+            The number of addresses in `addrs`.
+    @param  otpaddr
+            The address of the OTP memory (the same for all nodes).
+    @param  bufs
+            Output array (n*size bytes) returning for each node `size` 
+            bytes from its OTP: node i at bufs[i*size..i*size+size-1].
+    @param  size
+            The number of bytes per node (1..8).
+    @param  results
+            Optional output array (n entries, may be NULL) returning the 
+            result of each node; only entries with aoresult_ok have their
+            bytes in bufs[] set.
+    @return aoresult_ok if all nodes responded ok, otherwise the first 
+            error code encountered (in address list order).
+    @note   See aoosp_send_readotp() for notes on OTP reads, and 
+            aoosp_send_readtempstat_many() for the other notes.
+*/
+aoresult_t aoosp_send_readotp_many(const uint16_t * addrs, int n, uint8_t otpaddr, uint8_t * bufs, int size, aoresult_t * results) {
+  void * const outs[]= { bufs, &size };
+  if( n>0 && bufs==0 ) return aoresult_outargnull;
+  if( size<1 || size>8 ) return aoresult_osp_arg;
+  aoosp_many_otpaddr= otpaddr;
+  return aoosp_send_many(AOOSP_IX_READOTP, "readotp", aoosp_many_con_readotp, aoosp_many_des_readotp, outs, addrs, n, results);
+}
+
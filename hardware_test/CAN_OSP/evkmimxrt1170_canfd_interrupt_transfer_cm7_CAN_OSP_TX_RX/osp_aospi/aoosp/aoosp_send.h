@@ -31,6 +31,7 @@
 #include "fsl_common.h"
 #include "fsl_debug_console.h"
 #include <aoresult.h>
+#include <aoosp_crc.h>
 
 
 // === LOG ================================================
@@ -45,14 +46,56 @@
   // The level for logging aoosp telegrams to Serial
   typedef enum aoosp_loglevel_e {
     aoosp_loglevel_none, // Nothing is logged (default)
+    aoosp_loglevel_ring, // Binary records to the log ring, printed later by aoosp_logring_drain()
     aoosp_loglevel_args, // Logging of sent and received telegram arguments
     aoosp_loglevel_tele, // Also logs raw (sent and received) telegram bytes
   } aoosp_loglevel_t;
   void             aoosp_loglevel_set(aoosp_loglevel_t level);
   aoosp_loglevel_t aoosp_loglevel_get();
+
+  // Number of records in the log ring (must be a power of 2)
+  #define AOOSP_LOGRING_SIZE 64
+  // Maximum telegram size in a log record
+  #define AOOSP_LOGREC_TELESIZE 12
+  // One record in the log ring: a telegram sent by an aoosp_send_xxx(), its response, and the step results
+  typedef struct aoosp_logrec_s {
+    uint32_t time;       // time stamp in us (DWT cycle counter), or from the clock set with aoosp_logring_clock_set() (0 when there is none)
+    uint16_t seq;        // sequence number; a gap means records were lost (ring full)
+    uint16_t addr;       // address the telegram was sent to
+    uint8_t  ix;         // which telegram (index in the descriptor table in aoosp_send.c)
+    uint8_t  con_result; // aoresult_t of constructing the telegram
+    uint8_t  spi_result; // aoresult_t of sending it (and receiving the response)
+    uint8_t  des_result; // aoresult_t of destructing the response
+    uint8_t  telesize;   // size of tele[] (0 when construction failed)
+    uint8_t  respsize;   // size of resp[] (0 when there is no response)
+    uint8_t  tele[AOOSP_LOGREC_TELESIZE]; // the sent telegram
+    uint8_t  resp[AOOSP_LOGREC_TELESIZE]; // the received response telegram
+  } aoosp_logrec_t;
+  // Period (ms) of the background task that drains the log ring when it is empty
+  #define AOOSP_LOGRING_TASK_MS 10
+  // Stack (words) of the background task that drains the log ring
+  #define AOOSP_LOGRING_TASK_STACK 512
+  // Installs the us clock of the log ring and (with FreeRTOS) starts the task that drains it; called by aoosp_init().
+  void             aoosp_logring_init();
+  // Returns 1 iff the background task (FreeRTOS) drains the log ring.
+  int              aoosp_logring_background();
+  // Sets the clock that time stamps log records (0 for none), e.g. a cycle or us counter.
+  void             aoosp_logring_clock_set(uint32_t (*clock)(void));
+  // Takes the oldest record from the log ring; returns 0 (and leaves rec untouched) when the ring is empty.
+  int              aoosp_logring_get(aoosp_logrec_t * rec);
+  // Prints at most `max` records from the log ring, one "#osplog" line each; returns the number printed.
+  int              aoosp_logring_drain(int max);
+  // Returns the number of records lost since startup, because the log ring was full.
+  uint32_t         aoosp_logring_lost();
 #else
   #define aoosp_loglevel_set(level) /* empty */
   #define aoosp_loglevel_get()      /* empty */
+  #define aoosp_logring_init()      /* empty */
+  #define aoosp_logring_background() 0
+  #define aoosp_logring_clock_set(clock) /* empty */
+  #define aoosp_logring_get(rec)    0
+  #define aoosp_logring_drain(max)  0
+  #define aoosp_logring_lost()      0
 #endif // AOOSP_LOG_ENABLED
 
 
@@ -60,6 +103,9 @@
 
 
 // OSP addresses are 10 bits, some values have a special meaning.
+// Telegrams with a response (INIT, IDENTIFY, ASKTINFO, READxxx, xxx_SR) only accept
+// unicast addresses; with a broadcast or group address aoosp_send_xxx()
+// returns aoresult_osp_addr.
 #define AOOSP_ADDR_GLOBALMIN             ( 0x000 )
 #define AOOSP_ADDR_GLOBALMAX             ( 0x3FE )
 
@@ -92,6 +138,42 @@
 #define AOOSP_ADDR_ISOK(addr)            ( AOOSP_ADDR_ISBROADCAST(addr) || AOOSP_ADDR_ISUNICAST(addr) || OAOSP_ADDR_ISMULTICAST(addr) )
 
 
+// === CONST TELEGRAMS ====================================
+
+
+// Builders for telegrams whose address, TID and payload are compile time constants.
+// They expand to a brace initializer with all bytes of the telegram, including the
+// CRC (computed by the compiler, see AOOSP_CRC_CONSTn), so a static const array
+// lives in flash and can be passed to aospi_tx() as is, without runtime encoding.
+// Example: static const uint8_t reset[] = AOOSP_TELE_CONST0(AOOSP_ADDR_BROADCAST,0x00);
+// The suffix is the payload size; OSP only has payloads of 0..4, 6 and 8 bytes.
+
+// The three header bytes: preamble and address, address and PSI, PSI and TID.
+#define AOOSP_TELE_H0(addr)         ( 0xA0 | ((addr)>>6 & 0x0F) )
+#define AOOSP_TELE_H1(addr,psi)     ( ((addr)&0x3F)<<2 | ((psi)>>1 & 0x03) )
+#define AOOSP_TELE_H2(psi,tid)      ( ((psi)&0x01)<<7 | ((tid)&0x7F) )
+#define AOOSP_TELE_HDR(addr,psi,tid) AOOSP_TELE_H0(addr), AOOSP_TELE_H1(addr,psi), AOOSP_TELE_H2(psi,tid)
+
+// AOOSP_CRC_CONSTn of the bytes in __VA_ARGS__; the extra level splits AOOSP_TELE_HDR() into three arguments
+#define AOOSP_TELE_CRC(n,...)       AOOSP_TELE_CRC_(n,__VA_ARGS__)
+#define AOOSP_TELE_CRC_(n,...)      AOOSP_CRC_CONST##n(__VA_ARGS__)
+
+#define AOOSP_TELE_CONST0(addr,tid) \
+  { AOOSP_TELE_HDR(addr,0,tid), AOOSP_TELE_CRC(3,AOOSP_TELE_HDR(addr,0,tid)) }
+#define AOOSP_TELE_CONST1(addr,tid,p0) \
+  { AOOSP_TELE_HDR(addr,1,tid), p0, AOOSP_TELE_CRC(4,AOOSP_TELE_HDR(addr,1,tid),p0) }
+#define AOOSP_TELE_CONST2(addr,tid,p0,p1) \
+  { AOOSP_TELE_HDR(addr,2,tid), p0,p1, AOOSP_TELE_CRC(5,AOOSP_TELE_HDR(addr,2,tid),p0,p1) }
+#define AOOSP_TELE_CONST3(addr,tid,p0,p1,p2) \
+  { AOOSP_TELE_HDR(addr,3,tid), p0,p1,p2, AOOSP_TELE_CRC(6,AOOSP_TELE_HDR(addr,3,tid),p0,p1,p2) }
+#define AOOSP_TELE_CONST4(addr,tid,p0,p1,p2,p3) \
+  { AOOSP_TELE_HDR(addr,4,tid), p0,p1,p2,p3, AOOSP_TELE_CRC(7,AOOSP_TELE_HDR(addr,4,tid),p0,p1,p2,p3) }
+#define AOOSP_TELE_CONST6(addr,tid,p0,p1,p2,p3,p4,p5) \
+  { AOOSP_TELE_HDR(addr,6,tid), p0,p1,p2,p3,p4,p5, AOOSP_TELE_CRC(9,AOOSP_TELE_HDR(addr,6,tid),p0,p1,p2,p3,p4,p5) }
+#define AOOSP_TELE_CONST8(addr,tid,p0,p1,p2,p3,p4,p5,p6,p7) \
+  { AOOSP_TELE_HDR(addr,7,tid), p0,p1,p2,p3,p4,p5,p6,p7, AOOSP_TELE_CRC(11,AOOSP_TELE_HDR(addr,7,tid),p0,p1,p2,p3,p4,p5,p6,p7) }
+
+
 // === TELEGRAMS ==========================================
 
 
@@ -493,6 +575,21 @@ aoresult_t aoosp_send_setpwm(uint16_t addr, uint16_t red, uint16_t green, uint16
 // Telegram 4F (variant 1) SETPWMCHN - configures the PWM settings of one channel of the addressed node.
 aoresult_t aoosp_send_setpwmchn(uint16_t addr, uint8_t chn, uint16_t red, uint16_t green, uint16_t blue );
 
+// The constant first bytes of SETPWM (header) or SETPWMCHN (header, chn, dummy) telegrams for one node/channel, plus their CRC state.
+typedef struct aoosp_pwmhdr_s {
+  uint8_t data[5]; // the constant first bytes of the telegram
+  uint8_t size;    // number of used bytes in data: 3 for SETPWM, 5 for SETPWMCHN
+  uint8_t crc;     // CRC state after data[0..size-1] (see aoosp_crc_update)
+} aoosp_pwmhdr_t;
+// Prebuilds the header for SETPWM telegrams to `addr`; for aoosp_send_setpwm_hdr().
+aoresult_t aoosp_pwmhdr_setpwm(aoosp_pwmhdr_t * hdr, uint16_t addr);
+// Prebuilds the header for SETPWMCHN telegrams to `addr`, channel `chn`; for aoosp_send_setpwmchn_hdr().
+aoresult_t aoosp_pwmhdr_setpwmchn(aoosp_pwmhdr_t * hdr, uint16_t addr, uint8_t chn);
+// Telegram 4F (variant 0) SETPWM with prebuilt header - only encodes the payload and finishes the CRC.
+aoresult_t aoosp_send_setpwm_hdr(const aoosp_pwmhdr_t * hdr, uint16_t red, uint16_t green, uint16_t blue, uint8_t daytimes );
+// Telegram 4F (variant 1) SETPWMCHN with prebuilt header - only encodes the payload and finishes the CRC.
+aoresult_t aoosp_send_setpwmchn_hdr(const aoosp_pwmhdr_t * hdr, uint16_t red, uint16_t green, uint16_t blue );
+
 
 #define AOOSP_CURCHN_FLAGS_RESRVD  0x08
 #define AOOSP_CURCHN_FLAGS_SYNCEN  0x04
@@ -738,6 +835,23 @@ aoresult_t aoosp_send_settestpw(uint16_t addr, uint64_t pw);
 // Telegram 7F SETTESTPW with SR - sets the test password of the addressed node.
 aoresult_t aoosp_send_settestpw_sr(uint16_t addr, uint64_t pw, uint8_t * temp, uint8_t * stat);
 
+// === BULK ===============================================
+
+
+// Maximum number of requests a bulk read (aoosp_send_xxx_many) keeps in flight
+#define AOOSP_SEND_MANY_INFLIGHT 8
 
-#endif
 
+// Sends READTEMPSTAT to each node in `addrs`; fills temps[], stats[] and (optional) per-node results[].
+aoresult_t aoosp_send_readtempstat_many(const uint16_t * addrs, int n, uint8_t * temps, uint8_t * stats, aoresult_t * results);
+// Sends READSTAT to each node in `addrs`; fills stats[] and (optional) per-node results[].
+aoresult_t aoosp_send_readstat_many(const uint16_t * addrs, int n, uint8_t * stats, aoresult_t * results);
+// Sends READCOMST to each node in `addrs`; fills coms[] and (optional) per-node results[].
+aoresult_t aoosp_send_readcomst_many(const uint16_t * addrs, int n, uint8_t * coms, aoresult_t * results);
+// Sends IDENTIFY to each node in `addrs`; fills ids[] and (optional) per-node results[].
+aoresult_t aoosp_send_identify_many(const uint16_t * addrs, int n, uint32_t * ids, aoresult_t * results);
+// Sends READOTP (at `otpaddr`) to each node in `addrs`; fills bufs[] (`size` bytes per node) and (optional) per-node results[].
+aoresult_t aoosp_send_readotp_many(const uint16_t * addrs, int n, uint8_t otpaddr, uint8_t * bufs, int size, aoresult_t * results);
+
+
+#endif
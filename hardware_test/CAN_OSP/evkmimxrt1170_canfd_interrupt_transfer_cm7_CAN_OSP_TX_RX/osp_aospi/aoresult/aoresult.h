@@ -25,10 +25,14 @@
 #include "stdio.h"
 #include "stdlib.h"
 #include "stdint.h"
+#if defined(__linux__) // host build (e.g. tools/aoosp_logdec.c): no MCU SDK
+#define PRINTF printf
+#else
 #include "fsl_debug_console.h"
 //#include <Arduino.h>         // Serial in AORESULT_ASSERT()
 #include "fsl_lpuart.h"
 #include "fsl_common.h"
+#endif
 
 
 // Identifies lib version
@@ -22,13 +22,19 @@
 //#include "soc/gpio_struct.h" // GPIO.out_w1tc
 #include "aoresult.h"
 #include "aospi.h"
+#include "aospi_frame.h"
+#include "aospi_backend.h"
 #include "fsl_gpio.h"
-#include "slave_spi.h"
-#include "fsl_flexcan.h"
+#if defined(SDK_OS_FREE_RTOS)
+#include "FreeRTOS.h"
+#include "task.h"
+#endif
 
 
 // Phy selected in init()
 static aospi_phy_t aospi_phy= aospi_phy_undef;
+// Backend selected in init()
+static const aospi_backend_t * aospi_backend;
 
 
 /*!
@@ -104,240 +110,247 @@ int  aospi_rxcount_get() {
 }
 
 
-// === SPI OUT ==============================================================
-// The SPI OUT send command telegrams to the first OSP node (SPI master)
-
-
-// Use the standard Arduino API for SPIOUT
-//#include <SPI.h>
-
-
-// The pins of the ESP32 are fixed in this library.
-// OSP nodes receive using only SCLK and MOSI
-//#define AOSPI_OUT_SCLK  4
-//#define AOSPI_OUT_MOSI  5
-//#define AOSPI_OUT_SSEL -1
-//#define AOSPI_OUT_MISO -1
-// There is one extra pin in use, to en/disable the output of the level
-// shifter that is placed between SPIOUT and the first SAID.
-// Note: a uni-directional level shifter is used.
-// Note: The B-side (5V, SAID) is the one that is en/disabled
-#define AOSPI_OUT_OENA  8
+// For backends: the frame of `req` has been sent (counts its telegrams).
+void aospi_req_sent(aospi_req_t * req) {
+  aospi_txcount += req->txcount;
+}
 
 
-#define AOSPI_OUT_BUS   LPSPI1
-#define GPIO_USE_OENA_OUT	GPIO9
-#define GPIO_USE_OENA_IN	GPIO9
-#define GPIO_USE_CINT		GPIO9
-#define GPIO_USE_DIRL		GPIO9
-#define GPIO_USE_MSEL		GPIO9
+static int aospi_txrx_size_;
+// For backends: the response of `req`, `size` bytes, has been copied to req->rx.
+void aospi_req_received(aospi_req_t * req, int size) {
+  req->actsize= size;
+  aospi_rxcount++;
+  aospi_txrx_size_= req->txsize + size;
+}
 
-// digitalWrite(AOSPI_OUT_OENA,...) is too slow so we resort to register writes
-#define AOSPI_OUT_OENA_CLR()  do GPIO_USE_OENA_OUT->DR_CLEAR = 1UL << AOSPI_OUT_OENA; while(0)
-#define AOSPI_OUT_OENA_SET()  do GPIO_USE_OENA_OUT->DR_SET = 1UL << AOSPI_OUT_OENA; while(0)
 
+// === telemetry ============================================================
+// Next to the totals above, the library keeps counters per telegram ID 
+// (TID): telegrams and bytes out, responses and bytes in, failures, and the 
+// time the requests took, both as total and as log2 histogram. Frames that 
+// do not carry a single TID are counted in row AOSPI_STAT_TID_OTHER. 
+// Telegrams are counted when the backend accepted their frame, and the 
+// outcome of a request when it completes. 
+// Completion may run in an ISR; the counters are plain increments, so a 
+// reader may see a row that is being updated.
 
-// For OSP nodes, the SPI frequency has to be 2.4MHz +/- 50%
-// otherwise a timeout elapses inside the node, resulting in a com error.
-#define AOSPI_OUT_TYPEA_FREQ  (2 * 2400 * 1000) // MCU mode type A: 1-wire Manchester
-#define AOSPI_OUT_TYPEB_FREQ  (2400 * 1000)     // MCU mode type B: 2-wire SPI
-
-
-/************************************** Param FLEXCAN3 and some param global ********************************************/
-
-#define EXAMPLE_CAN3           			CAN3
-#define RX_CAN3_MESSAGE_BUFFER_NUM 		(9)
-#define TX_CAN3_MESSAGE_BUFFER_NUM 		(8)
-#define USE_CANFD             			(1)
-/* Select OSC24Mhz as master flexcan clock source */
-#define FLEXCAN3_CLOCK_SOURCE_SELECT (1U)
-/* Clock divider for master flexcan clock source */
-#define FLEXCAN3_CLOCK_SOURCE_DIVIDER (1U)
-/* Get frequency of flexcan clock */
-#define EXAMPLE_CAN_3_CLK_FREQ ((CLOCK_GetRootClockFreq(kCLOCK_Root_Can3) / 100000U) * 100000U)
-/* Set USE_IMPROVED_TIMING_CONFIG macro to use api to calculates the improved CAN / CAN FD timing values. */
-#define USE_IMPROVED_TIMING_CONFIG_FOR_CAN3 	(1U)
-#define DLC_FOR_CAN3         					(12)
-#define BYTES_IN_MB_FOR_CAN3 					kFLEXCAN_32BperMB
-
-flexcan_handle_t flexcan3Handle;
-volatile bool txcan3Complete = false;
-volatile bool rxcan3Complete = false;
-volatile bool wakenUpcan3    = false;
-flexcan_mb_transfer_t txXfercan3, rxXfercan3;
-#if (defined(USE_CANFD) && USE_CANFD)
-flexcan_fd_frame_t framecan3;
-#else
-flexcan_frame_t frame;
-#endif
-uint32_t txcan3Identifier;
-uint32_t rxcan3Identifier;
 
+static aospi_stat_tid_t aospi_stat_tids[AOSPI_STAT_TIDS];
+static uint32_t         aospi_stat_results[aoresult_numresultcodes];
 
-/************************************************************************************************/
 
+// Returns the TID of (not encoded) telegram `tele` of `size` bytes, or AOSPI_STAT_TID_OTHER when too short to have one.
+static int aospi_stat_tidof(const uint8_t * tele, int size) {
+  if( size<3 ) return AOSPI_STAT_TID_OTHER;
+  return tele[2] & 0x7F;
+}
 
 
-/************************************** Param FLEXCAN2 ********************************************/
+// Merges the TID of telegram `tele` (`size` bytes, not encoded), that is about to be added to `req`, into `req->tid`.
+static void aospi_stat_tag(aospi_req_t * req, const uint8_t * tele, int size) {
+  int tid= aospi_stat_tidof(tele,size);
+  if( req->txcount==0 ) req->tid= tid;
+  else if( req->tid!=tid ) req->tid= AOSPI_STAT_TID_OTHER;
+}
 
 
-#define EXAMPLE_CAN2           			CAN2
+// Counts telegram `tele` (`size` bytes, not encoded), whose frame the backend accepted.
+static void aospi_stat_tx(const uint8_t * tele, int size) {
+  int tid= aospi_stat_tidof(tele,size);
+  aospi_stat_tids[tid].txcount++;
+  aospi_stat_tids[tid].txbytes+= size;
+}
 
-/* Select OSC24Mhz as master flexcan clock source */
-#define FLEXCAN2_CLOCK_SOURCE_SELECT (1U)
-#define RX_CAN2_MESSAGE_BUFFER_NUM 		(9)
-#define TX_CAN2_MESSAGE_BUFFER_NUM 		(8)
-/* Clock divider for master flexcan clock source */
-#define FLEXCAN2_CLOCK_SOURCE_DIVIDER (1U)
-/* Get frequency of flexcan clock */
-#define EXAMPLE_CAN_2_CLK_FREQ ((CLOCK_GetRootClockFreq(kCLOCK_Root_Can2) / 100000U) * 100000U)
-/* Set USE_IMPROVED_TIMING_CONFIG macro to use api to calculates the improved CAN / CAN FD timing values. */
-#define USE_IMPROVED_TIMING_CONFIG_FOR_CAN2 	(1U)
-#define DLC_FOR_CAN2         					(15)
-#define BYTES_IN_MB_FOR_CAN2 					kFLEXCAN_32BperMB
 
-flexcan_handle_t flexcan2Handle;
-volatile bool txcan2Complete = false;
-volatile bool rxcan2Complete = false;
-volatile bool wakenUpcan2    = false;
-flexcan_mb_transfer_t txXfercan2, rxXfercan2;
-#if (defined(USE_CANFD) && USE_CANFD)
-flexcan_fd_frame_t framecan2;
-#else
-flexcan_frame_t frame;
-#endif
-uint32_t txcan2Identifier;
-uint32_t rxcan2Identifier;
+// Returns the histogram bucket for a time of `us`: 0 for 0, b for 2^(b-1)..2^b-1, capped at AOSPI_STAT_BUCKETS-1.
+static int aospi_stat_bucket(uint32_t us) {
+  int b= 0;
+  while( us!=0 && b<AOSPI_STAT_BUCKETS-1 ) { us>>= 1; b++; }
+  return b;
+}
 
 
-/************************************************************************************************/
+// Counts the outcome `result` of request `req` (may be called from an ISR).
+static void aospi_stat_complete(aospi_req_t * req, aoresult_t result) {
+  aospi_stat_tid_t * stat= &aospi_stat_tids[req->tid<AOSPI_STAT_TIDS ? req->tid : AOSPI_STAT_TID_OTHER];
+  if( result>=0 && result<aoresult_numresultcodes ) aospi_stat_results[result]++;
+  if( result!=aoresult_ok ) { stat->errcount++; return; }
+  if( req->rx ) { stat->rxcount++; stat->rxbytes+= req->actsize; }
+  stat->us+= req->us;
+  uint16_t * bucket= &stat->hist[aospi_stat_bucket(req->us)];
+  if( *bucket!=0xFFFF ) (*bucket)++;
+}
 
 
-static FLEXCAN_CALLBACK(flexcan_callback)
-{
-    switch (status)
-    {
-        case kStatus_FLEXCAN_RxIdle:
-            if (RX_CAN3_MESSAGE_BUFFER_NUM == result)
-            {
-            	rxcan3Complete = true;
-            }
-            else if(RX_CAN2_MESSAGE_BUFFER_NUM == result)
-            {
-            	rxcan2Complete = true;
-            }
-            break;
-
-        case kStatus_FLEXCAN_TxIdle:
-            if (TX_CAN3_MESSAGE_BUFFER_NUM == result)
-            {
-            	txcan3Complete = true;
-            }
-            else if (TX_CAN2_MESSAGE_BUFFER_NUM == result)
-			{
-				txcan2Complete = true;
-			}
-            break;
-
-        case kStatus_FLEXCAN_WakeUp:
-        	wakenUpcan3 = true;
-        	wakenUpcan2 = true;
-            break;
-
-        default:
-            break;
-    }
+/*!
+    @brief  Resets all telemetry counters (per TID and per result) to 0.
+    @note   Does not reset the totals, see aospi_txcount_reset() and
+            aospi_rxcount_reset().
+*/
+void aospi_stat_reset() {
+  memset(aospi_stat_tids,0,sizeof(aospi_stat_tids));
+  memset(aospi_stat_results,0,sizeof(aospi_stat_results));
 }
 
 
 /*!
-    @brief  Initializes the SPI OUT controller
-    @note   Assigns and sets up MOSI and SCLK pins.
-            Also assigns and sets up the OENA pin.
-            Drives all lines to default level.
+    @brief  Returns the telemetry counters of one telegram ID.
+    @param  tid
+            The telegram ID 0x00..0x7F, or AOSPI_STAT_TID_OTHER for frames 
+            that do not carry a single TID (batched frames with several 
+            TIDs, telegrams shorter than 3 bytes, and benchmark frames).
+    @return Pointer to the counters, or NULL when tid is out of range.
+    @note   Telegrams are counted when submitted (txcount, txbytes), 
+            requests when completed (rxcount, rxbytes, errcount, us, hist).
+            A batched frame of one TID completes as one request.
+    @note   Byte counts are those of the telegrams, not of their encoding 
+            on the link (eg Manchester for aospi_phy_mcua).
+    @note   The times are those of aospi_req_t.us: from handing the frame 
+            to the link until it is sent (no response) or until the 
+            response is received.
 */
-static void aospi_out_init()
-{
-	// Couple the pins
-	gpio_pin_config_t output_config = {kGPIO_DigitalOutput, 0, kGPIO_NoIntmode};
-	flexcan_config_t flexcanConfig;
-	flexcan_rx_mb_config_t mbConfig;
+const aospi_stat_tid_t * aospi_stat_tid(int tid) {
+  if( tid<0 || tid>=AOSPI_STAT_TIDS ) return 0;
+  return &aospi_stat_tids[tid];
+}
 
-	clock_root_config_t rootCfg = {0};
-	rootCfg.mux                 = FLEXCAN3_CLOCK_SOURCE_SELECT;
-	rootCfg.div                 = FLEXCAN3_CLOCK_SOURCE_DIVIDER;
-	CLOCK_SetRootClock(kCLOCK_Root_Can3, &rootCfg);
 
-	txcan3Identifier = 0x123;
-	rxcan3Identifier = 0x321;
+/*!
+    @brief  Returns how often `result` was the outcome of a request, or of
+            the validation of a response.
+    @param  result
+            The result code.
+    @return The count; 0 if result is out of range.
+    @note   aospi counts the result of every completed request (including
+            aoresult_ok), aoosp counts every response it rejects (eg 
+            aoresult_osp_crc), see aospi_stat_error().
+*/
+uint32_t aospi_stat_result(aoresult_t result) {
+  if( result<0 || result>=aoresult_numresultcodes ) return 0;
+  return aospi_stat_results[result];
+}
 
-	FLEXCAN_GetDefaultConfig(&flexcanConfig);
 
-	flexcanConfig.bitRate = 500000U;
+/*!
+    @brief  Records that the response to telegram `tele` was rejected.
+    @param  tele
+            The (not encoded) telegram that was sent.
+    @param  size
+            The size of `tele` in bytes.
+    @param  result
+            The reason the response was rejected, eg aoresult_osp_crc.
+    @note   The transport only sees frames; the destructors in aoosp check 
+            the content of responses and report failures with this function.
+*/
+void aospi_stat_error(const uint8_t * tele, int size, aoresult_t result) {
+  if( result>=0 && result<aoresult_numresultcodes ) aospi_stat_results[result]++;
+  aospi_stat_tids[aospi_stat_tidof(tele,size)].errcount++;
+}
 
-	flexcan_timing_config_t timing_config;
-	memset(&timing_config, 0, sizeof(flexcan_timing_config_t));
 
-#if (defined(USE_CANFD) && USE_CANFD)
-    if (FLEXCAN_FDCalculateImprovedTimingValues(EXAMPLE_CAN3, flexcanConfig.bitRate, flexcanConfig.bitRateFD,
-    		EXAMPLE_CAN_3_CLK_FREQ, &timing_config))
-    {
-        /* Update the improved timing configuration*/
-        memcpy(&(flexcanConfig.timingConfig), &timing_config, sizeof(flexcan_timing_config_t));
-    }
-    else
-    {
-    	PRINTF("No found Improved Timing Configuration. Just used default configuration\r\n\r\n");
-    }
-#else
-    if (FLEXCAN_CalculateImprovedTimingValues(EXAMPLE_CAN3, flexcanConfig.bitRate, EXAMPLE_CAN_3_CLK_FREQ, &timing_config))
-    {
-        /* Update the improved timing configuration*/
-        memcpy(&(flexcanConfig.timingConfig), &timing_config, sizeof(flexcan_timing_config_t));
-    }
-    else
-    {
-        LOG_INFO("No found Improved Timing Configuration. Just used default configuration\r\n\r\n");
-    }
-#endif
+// Appends `val` as LEB128 (7 bits per byte, low first, bit 7 set when more follow) to `buf` at `*pos`.
+static void aospi_stat_putvar(uint8_t * buf, int * pos, uint32_t val) {
+  while( val>=0x80 ) { buf[(*pos)++]= (uint8_t)(val | 0x80); val>>= 7; }
+  buf[(*pos)++]= (uint8_t)val;
+}
 
 
+/*!
+    @brief  Writes all telemetry counters in a compact binary format.
+    @param  buf
+            Caller allocated buffer for the dump.
+    @param  size
+            The size of `buf`; AOSPI_STAT_DUMP_MAXSIZE always suffices.
+    @param  len
+            Output parameter set to the number of bytes written.
+    @return aoresult_outargnull if buf or len is NULL
+            aoresult_spi_buf    if the dump does not fit in `size` bytes
+            aoresult_ok         otherwise
+    @note   Numbers marked "var" are LEB128 encoded: 7 bits per byte, 
+            least significant first, bit 7 set on all but the last byte.
+            The format is
+              0xA5, version (1), AOSPI_STAT_BUCKETS, aoresult_numresultcodes
+              per result code: count (var)
+              number of TIDs that follow (var)
+              per TID with a non-zero txcount or errcount: 
+                tid, txcount, txbytes, rxcount, rxbytes, errcount, us (var)
+                per bucket: hist (var)
+    @note   A typical dump (a dozen TIDs) is a few hundred bytes.
+*/
+aoresult_t aospi_stat_dump(uint8_t * buf, int size, int * len) {
+  if( buf==0 || len==0 ) return aoresult_outargnull;
+  // Worst case size of the dump, given the TIDs in use
+  int tids= 0;
+  for( int tid=0; tid<AOSPI_STAT_TIDS; tid++ ) {
+    if( aospi_stat_tids[tid].txcount!=0 || aospi_stat_tids[tid].errcount!=0 ) tids++;
+  }
+  if( size < 4 + 5*aoresult_numresultcodes + 2 + tids*(1+6*5+AOSPI_STAT_BUCKETS*3) ) return aoresult_spi_buf;
+  // Write
+  int pos= 0;
+  buf[pos++]= 0xA5;
+  buf[pos++]= 1;
+  buf[pos++]= AOSPI_STAT_BUCKETS;
+  buf[pos++]= aoresult_numresultcodes;
+  for( int r=0; r<aoresult_numresultcodes; r++ ) aospi_stat_putvar(buf,&pos,aospi_stat_results[r]);
+  aospi_stat_putvar(buf,&pos,tids);
+  for( int tid=0; tid<AOSPI_STAT_TIDS; tid++ ) {
+    const aospi_stat_tid_t * stat= &aospi_stat_tids[tid];
+    if( stat->txcount==0 && stat->errcount==0 ) continue;
+    buf[pos++]= tid;
+    aospi_stat_putvar(buf,&pos,stat->txcount);
+    aospi_stat_putvar(buf,&pos,stat->txbytes);
+    aospi_stat_putvar(buf,&pos,stat->rxcount);
+    aospi_stat_putvar(buf,&pos,stat->rxbytes);
+    aospi_stat_putvar(buf,&pos,stat->errcount);
+    aospi_stat_putvar(buf,&pos,stat->us);
+    for( int b=0; b<AOSPI_STAT_BUCKETS; b++ ) aospi_stat_putvar(buf,&pos,stat->hist[b]);
+  }
+  *len= pos;
+  return aoresult_ok;
+}
 
-#if (defined(USE_CANFD) && USE_CANFD)
-    FLEXCAN_FDInit(EXAMPLE_CAN3, &flexcanConfig, EXAMPLE_CAN_3_CLK_FREQ, BYTES_IN_MB_FOR_CAN3, true);
-#else
-    FLEXCAN_Init(EXAMPLE_CAN, &flexcanConfig, EXAMPLE_CAN_CLK_FREQ);
-#endif
 
+// === SPI OUT ==============================================================
+// The SPI OUT send command telegrams to the first OSP node (SPI master)
 
-	/* Create FlexCAN handle structure and set call back function. */
-	FLEXCAN_TransferCreateHandle(EXAMPLE_CAN3, &flexcan3Handle, flexcan_callback, NULL);
 
-	/* Set Rx Masking mechanism. */
-	FLEXCAN_SetRxMbGlobalMask(EXAMPLE_CAN3, FLEXCAN_RX_MB_STD_MASK(rxcan3Identifier, 0, 0));
+// Use the standard Arduino API for SPIOUT
+//#include <SPI.h>
 
 
-	/* Setup Rx Message Buffer. */
-	mbConfig.format = kFLEXCAN_FrameFormatStandard;
-	mbConfig.type   = kFLEXCAN_FrameTypeData;
-	mbConfig.id     = FLEXCAN_ID_STD(rxcan3Identifier);
-#if (defined(USE_CANFD) && USE_CANFD)
-	FLEXCAN_SetFDRxMbConfig(EXAMPLE_CAN3, RX_CAN3_MESSAGE_BUFFER_NUM, &mbConfig, true);
-#else
-	FLEXCAN_SetRxMbConfig(EXAMPLE_CAN3, RX_CAN3_MESSAGE_BUFFER_NUM, &mbConfig, true);
-#endif
+// The pins of the ESP32 are fixed in this library.
+// OSP nodes receive using only SCLK and MOSI
+//#define AOSPI_OUT_SCLK  4
+//#define AOSPI_OUT_MOSI  5
+//#define AOSPI_OUT_SSEL -1
+//#define AOSPI_OUT_MISO -1
+// There is one extra pin in use, to en/disable the output of the level
+// shifter that is placed between SPIOUT and the first SAID.
+// Note: a uni-directional level shifter is used.
+// Note: The B-side (5V, SAID) is the one that is en/disabled
+#define AOSPI_OUT_OENA  8
 
-/* Setup Tx Message Buffer. */
-#if (defined(USE_CANFD) && USE_CANFD)
-	FLEXCAN_SetFDTxMbConfig(EXAMPLE_CAN3, TX_CAN3_MESSAGE_BUFFER_NUM, true);
-#else
-	FLEXCAN_SetTxMbConfig(EXAMPLE_CAN3, TX_CAN3_MESSAGE_BUFFER_NUM, true);
-#endif
 
-	framecan3.dataByte0 = 0;
+#define GPIO_USE_OENA_OUT	GPIO9
+#define GPIO_USE_OENA_IN	GPIO9
+#define GPIO_USE_CINT		GPIO9
+#define GPIO_USE_DIRL		GPIO9
+#define GPIO_USE_MSEL		GPIO9
 
+// digitalWrite(AOSPI_OUT_OENA,...) is too slow so we resort to register writes
+#define AOSPI_OUT_OENA_CLR()  do GPIO_USE_OENA_OUT->DR_CLEAR = 1UL << AOSPI_OUT_OENA; while(0)
+#define AOSPI_OUT_OENA_SET()  do GPIO_USE_OENA_OUT->DR_SET = 1UL << AOSPI_OUT_OENA; while(0)
 
 
+/*!
+    @brief  Initializes the SPI OUT support pin
+    @note   Assigns and sets up the OENA pin, and drives it low.
+            The SPI OUT itself (SCLK, MOSI) is set up by the backend.
+*/
+static void aospi_out_init()
+{
+	gpio_pin_config_t output_config = {kGPIO_DigitalOutput, 0, kGPIO_NoIntmode};
 
 	// Configure the extra pin (level-shifter output-enable)
 	GPIO_PinInit(GPIO_USE_OENA_OUT, AOSPI_OUT_OENA, &output_config);
@@ -345,103 +358,9 @@ static void aospi_out_init()
 }
 
 
-/*!
-    @brief  Sends the `txsize` bytes in buffer `tx` to the first OSP node.
-    @param  freq
-            The frequency for the underlying SPI bus.
-    @param  tx
-            A pointer to a buffer of bytes to be sent.
-    @param  txsize
-            The number of bytes (of buffer tx) to be sent.
-    @return aoresult_ok (no error checking on send possible)
-    @note   While sending the OENA line is held high to enable the output
-            of the level shifter. This is especially important after a
-            RESET telegram because the first OSP node inspects the line
-            status to redetermine its comms mode (MCU, LVDS, CAN, EOL).
-*/
-static aoresult_t aospi_tx_internal(int freq, const uint8_t * tx, int txsize)
-{
-	uint32_t data_temp = 0;
-	AORESULT_ASSERT( aospi_phy!=aospi_phy_undef );
-
-	uint8_t temp_arr[50] = {0},Temp = 0, j = 0, i = 0;
-	memset(temp_arr, 0, sizeof(temp_arr));
-	memcpy(temp_arr, tx, txsize);
-
-
-	AOSPI_OUT_OENA_SET(); // digitalWrite(AOSPI_OUT_OENA, HIGH); // enable level shifter output
-
-
-
-	framecan3.id     = FLEXCAN_ID_STD(txcan3Identifier);
-	framecan3.format = (uint8_t)kFLEXCAN_FrameFormatStandard;
-	framecan3.type   = (uint8_t)kFLEXCAN_FrameTypeData;
-	framecan3.length = (uint8_t)DLC_FOR_CAN3;
-#if (defined(USE_CANFD) && USE_CANFD)
-	framecan3.brs = 1U;
-	framecan3.edl = 1U;
-#endif
-	txXfercan3.mbIdx = (uint8_t)TX_CAN3_MESSAGE_BUFFER_NUM;
-#if (defined(USE_CANFD) && USE_CANFD)
-
-//	for(uint8_t i = 0; i < txsize; i++)
-//	{
-//		data_temp = (temp_arr[i] << 24);
-//		i++;
-//		data_temp = (temp_arr[i] << 16);
-//		i++;
-//		data_temp = (temp_arr[i] << 8);
-//		i++;
-//		data_temp |= temp_arr[i];
-//		framecan3.dataWord[(i-3)] = data_temp;
-//	}
-
-
-	for(i = 0; i < (txsize / 4); i++)
-	{
-		for(j = Temp; j < (4 + Temp); j++)
-		{
-			data_temp = (temp_arr[j] << 24);
-			j++;
-			data_temp |= (temp_arr[j] << 16);
-			j++;
-			data_temp |= (temp_arr[j] << 8);
-			j++;
-			data_temp |= temp_arr[j];
-		}
-		Temp = j;
-		framecan3.dataWord[i] = data_temp;
-	}
-
-	data_temp = 0;
-	for(uint8_t k = 0; k < (txsize % 4); k++)
-	{
-		data_temp |= (temp_arr[Temp + k + 0] << (8 * (3 - k)));
-	}
-	framecan3.dataWord[i] = data_temp;
-
-
-	txXfercan3.framefd = &framecan3;
-	(void)FLEXCAN_TransferFDSendNonBlocking(EXAMPLE_CAN3, &flexcan3Handle, &txXfercan3);
-#else
-	txXfer.frame = &framecan3;
-	(void)FLEXCAN_TransferSendNonBlocking(EXAMPLE_CAN3, &flexcan3Handle, &txXfercan3);
-#endif
-
-	while (!txcan3Complete)
-	{
-	};
-	txcan3Complete = false;
-	PRINTF("Wait Node A to trigger the next transmission!\r\n\r\n");
-
-
-	// For the RESET telegram it is important to clear OENA immediately
-	AOSPI_OUT_OENA_CLR(); // digitalWrite(AOSPI_OUT_OENA, LOW); // disable level shifter output
-//	aospi_out.endTransaction();
-	// Update counters
-	aospi_txcount++;
-	// No checks possible on success
-	return aoresult_ok;
+// For backends: sets the output-enable of the outgoing level shifter.
+void aospi_backend_outoena(int val) {
+  if( val ) AOSPI_OUT_OENA_SET(); else AOSPI_OUT_OENA_CLR();
 }
 
 
@@ -497,8 +416,10 @@ static uint32_t aospi_txrx_us_;
     @note   Since `aoosp_tx()` does not send a response, the MCU can not
             measure the trip time of those send-only telegrams.
     @note   Trip time is available for BiDir and for Loop.
-    @note   The trip time is recorded starting with the first bit tx'ed by 
-            the MCU and ending with the last bit rx'ed by the MCU.
+    @note   The trip time is measured by the backend, starting when the 
+            frame is handed to the link (eg loaded in its CAN MB) and ending
+            when the response is received. So next to the times below, it 
+            includes the link (eg CAN-FD frames and the bridge).
     @note   The trip time (t_trip) includes sending the telegram sized txsize 
             (t_cmd) and receiving the response sized rxsize (t_resp), but 
             also includes the execution time of the command (t_exec) and the 
@@ -517,7 +438,6 @@ uint32_t aospi_txrx_us() {
 }
 
 
-static int aospi_txrx_size_;
 /*!
     @brief  Returns an estimate of the number of hops a command telegram and
             its response telegram need in a bidirectional round trip.
@@ -561,9 +481,9 @@ uint32_t aospi_txrx_hops(int t_extra) {
 
 
 /*!
-    @brief  Initializes the SPI IN controller
-    @note   Assigns and sets up MOSI, SCLK and SSEL pins.
-            Also assigns and sets up the extra pins (MSEL, CINT, OENA, DIRL).
+    @brief  Initializes the SPI IN support pins
+    @note   Assigns and sets up the extra pins (MSEL, CINT, OENA, DIRL).
+            The SPI IN itself (MOSI, SCLK, SSEL) is set up by the backend.
             Drives all lines to default level (DIRL low, so mux in BiDir).
 */
 
@@ -571,11 +491,6 @@ static void aospi_in_init()
 {
 	gpio_pin_config_t output_config = {kGPIO_DigitalOutput, 0, kGPIO_NoIntmode};
 	gpio_pin_config_t input_config = {kGPIO_DigitalInput, 0, kGPIO_NoIntmode};
-	flexcan_config_t flexcanConfig;
-	flexcan_rx_mb_config_t mbConfig;
-
-	clock_root_config_t rootCfg = {0};
-
 
 	GPIO_PinInit(GPIO_USE_MSEL, AOSPI_IN_MSEL, &output_config);
 	GPIO_PinWrite(GPIO_USE_MSEL, AOSPI_IN_MSEL, 1);
@@ -587,79 +502,6 @@ static void aospi_in_init()
 
 	GPIO_PinInit(GPIO_USE_DIRL, AOSPI_IN_DIRL, &output_config);
 	GPIO_PinWrite(GPIO_USE_DIRL, AOSPI_IN_DIRL, 0);
-
-	rootCfg.mux                 = FLEXCAN2_CLOCK_SOURCE_SELECT;
-	rootCfg.div                 = FLEXCAN2_CLOCK_SOURCE_DIVIDER;
-	CLOCK_SetRootClock(kCLOCK_Root_Can2, &rootCfg);
-
-	txcan2Identifier = 0x246;
-	rxcan2Identifier = 0x642;
-
-	FLEXCAN_GetDefaultConfig(&flexcanConfig);
-
-	flexcanConfig.bitRate = 500000U;
-
-	flexcan_timing_config_t timing_config;
-	memset(&timing_config, 0, sizeof(flexcan_timing_config_t));
-
-#if (defined(USE_CANFD) && USE_CANFD)
-	if (FLEXCAN_FDCalculateImprovedTimingValues(EXAMPLE_CAN2, flexcanConfig.bitRate, flexcanConfig.bitRateFD,
-			EXAMPLE_CAN_2_CLK_FREQ, &timing_config))
-	{
-		/* Update the improved timing configuration*/
-		memcpy(&(flexcanConfig.timingConfig), &timing_config, sizeof(flexcan_timing_config_t));
-	}
-	else
-	{
-		PRINTF("No found Improved Timing Configuration. Just used default configuration\r\n\r\n");
-	}
-#else
-	if (FLEXCAN_CalculateImprovedTimingValues(EXAMPLE_CAN2, flexcanConfig.bitRate, EXAMPLE_CAN_2_CLK_FREQ, &timing_config))
-	{
-		/* Update the improved timing configuration*/
-		memcpy(&(flexcanConfig.timingConfig), &timing_config, sizeof(flexcan_timing_config_t));
-	}
-	else
-	{
-		LOG_INFO("No found Improved Timing Configuration. Just used default configuration\r\n\r\n");
-	}
-#endif
-
-
-
-#if (defined(USE_CANFD) && USE_CANFD)
-	FLEXCAN_FDInit(EXAMPLE_CAN2, &flexcanConfig, EXAMPLE_CAN_2_CLK_FREQ, BYTES_IN_MB_FOR_CAN2, true);
-#else
-	FLEXCAN_Init(EXAMPLE_CAN2, &flexcanConfig, EXAMPLE_CAN_2_CLK_FREQ);
-#endif
-
-
-	/* Create FlexCAN handle structure and set call back function. */
-	FLEXCAN_TransferCreateHandle(EXAMPLE_CAN2, &flexcan2Handle, flexcan_callback, NULL);
-
-	/* Set Rx Masking mechanism. */
-	FLEXCAN_SetRxMbGlobalMask(EXAMPLE_CAN2, FLEXCAN_RX_MB_STD_MASK(rxcan2Identifier, 0, 0));
-
-
-	/* Setup Rx Message Buffer. */
-	mbConfig.format = kFLEXCAN_FrameFormatStandard;
-	mbConfig.type   = kFLEXCAN_FrameTypeData;
-	mbConfig.id     = FLEXCAN_ID_STD(rxcan2Identifier);
-#if (defined(USE_CANFD) && USE_CANFD)
-	FLEXCAN_SetFDRxMbConfig(EXAMPLE_CAN2, RX_CAN2_MESSAGE_BUFFER_NUM, &mbConfig, true);
-#else
-	FLEXCAN_SetRxMbConfig(EXAMPLE_CAN2, RX_CAN2_MESSAGE_BUFFER_NUM, &mbConfig, true);
-#endif
-
-/* Setup Tx Message Buffer. */
-#if (defined(USE_CANFD) && USE_CANFD)
-	FLEXCAN_SetFDTxMbConfig(EXAMPLE_CAN2, TX_CAN2_MESSAGE_BUFFER_NUM, true);
-#else
-	FLEXCAN_SetTxMbConfig(EXAMPLE_CAN2, TX_CAN2_MESSAGE_BUFFER_NUM, true);
-#endif
-
-	framecan2.dataByte0 = 0;
-
 }
 
 
@@ -693,299 +535,6 @@ static inline size_t min_size_t(size_t a, size_t b) {
     return a < b ? a : b;
 }
 
-static uint8_t convert_table_size(uint8_t data_size_row)
-{
-	uint8_t data = 0;
-	if(data_size_row <= 8)
-	{
-		return data_size_row;
-	}
-	switch(data_size_row)
-	{
-		case 9:
-		{
-			data = 12;
-			break;
-		}
-		case 10:
-		{
-			data = 16;
-			break;
-		}
-		case 11:
-		{
-			data = 20;
-			break;
-		}
-		case 12:
-		{
-			data = 24;
-			break;
-		}
-		case 13:
-		{
-			data = 32;
-			break;
-		}
-		case 14:
-		{
-			data = 48;
-			break;
-		}
-		case 15:
-		{
-			data = 64;
-			break;
-		}
-	}
-
-	return data;
-}
-
-/*!
-    @brief  Sends the `txsize` bytes in buffer `tx` to the first OSP node.
-            Waits for a response telegram and stores those bytes in
-            buffer `rx` with size `rxsize`.
-    @param  freq
-            The frequency for the underlying SPI bus.
-    @param  tx
-            A pointer to a buffer of bytes to be sent.
-    @param  txsize
-            The number of bytes (of buffer `tx`) to be sent.
-    @param  rx
-            A pointer to a caller allocated buffer of bytes to be received.
-    @param  rxsize
-            The size of the `rx` buffer.
-    @param  actsize
-            Output parameter set to the number of bytes actually received.
-            Might be NULL.
-    @return aoresult_spi_buf     if tx or rx is NULL
-            aoresult_spi_buf     if txsize or rxsize is out of bounds (0..12)
-            aoresult_assert      if the underlying driver behaves unexpectedly
-            aoresult_spi_noclock if no response (clock) is received
-            aoresult_spi_length  if the response had wrong number of bytes
-            aoresult_ok          otherwise
-    @note   Before sending, configure whether reception is from first (BiDir)
-            or last (Loop) node in the OSP chain using aospi_dirmux_set_xxx()
-    @note   While sending, this function enables the OUT level shifter.
-            After sending, switches to reception by enabling the IN level 
-            shifter (the one selected with aospi_dirmux_set_xxx), and then 
-            activates SSEL.
-            Reception terminates when a response is received (measured with
-            CINT pin), which is fast (one telegram length or ~40us). If there
-            is no response, reception terminates on timeout which is orders
-            slower (see ~14000us AOSPI_IN_TIMEOUT_US).
-    @note   Output parameter `actsize` might be set to NULL. In this case the 
-            function will not perform a size test, will thus not return
-            aoresult_spi_length. Instead the caller can inspect `*actsize`.
-    @note   If caller knows how many bytes will be received, set `rxsize` to
-            that amount and set `actsize` pointer to NULL. 
-    @note   If caller does not knows how many bytes will be received, set 
-            `rxsize` to largest possible telegram (ie AOSPI_TELE_MAXSIZE) 
-            and pass an `actsize`. 
-*/
-static aoresult_t aospi_txrx_internal(int freq, const uint8_t * tx, int txsize, uint32_t * rx, int rxsize, int *actsize)
-{
-  uint32_t data_temp = 0;
-  int leng_data = 0;
-  uint8_t temp_arr[50] = {0},Temp = 0, j = 0, i = 0;
-  lpspi_transfer_t masterXfer;
-
-
-  memset(temp_arr, 0, sizeof(temp_arr));
-  memcpy(temp_arr, tx, txsize);
-
-//  AORESULT_ASSERT( aospi_phy!=aospi_phy_undef );
-//  // Parameter check (skipping tx, done by caller because of possible Manchester encoding
-//  if( rxsize<0 || rxsize>AOSPI_TELE_MAXSIZE )
-//  {
-//	  return aoresult_spi_buf;
-//  }
-//  if( rx==0 )
-//  {
-//	  return aoresult_spi_buf;
-//  }
-//
-//  // Put a buffer in the (background) reception queue
-//  if(esp32_spi_slave_num_in_flight() != 0 && esp32_spi_slave_num_completed() != 0) return aoresult_assert; // should not happen (buffers pending in flight)
-//  esp32_spi_slave_queue(NULL, NULL, aospi_in_buf, AOSPI_TELE_MAXSIZE );
-//  esp32_spi_slave_trigger(NULL, 0);
-//
-//  // record start time
-//  aospi_txrx_us_ = xTaskGetTickCount();
-//
-//  // aospi_tx() inlined here for speed
-////  aospi_master_out_begin_transaction(freq, MSBFIRST, SPI_MODE0);
-//  AOSPI_OUT_OENA_SET(); // enable level shifter output - fast implementation of digitalWrite(AOSPI_OUT_OENA, HIGH)
-////  aospi_master_out_transfer_bytes( tx, NULL, txsize );
-//
-//
-////  masterXfer.txData   = tx;
-////  masterXfer.rxData   = NULL;
-////  masterXfer.dataSize = txsize;
-////  masterXfer.configFlags = EXAMPLE_LPSPI_1_MASTER_PCS_FOR_TRANSFER | kLPSPI_MasterPcsContinuous | kLPSPI_MasterByteSwap;
-////
-////  LPSPI_MasterTransferBlocking(EXAMPLE_LPSPI_1_MASTER_BASEADDR, &masterXfer);
-//
-//
-//
-	framecan3.id     = FLEXCAN_ID_STD(txcan3Identifier);
-	framecan3.format = (uint8_t)kFLEXCAN_FrameFormatStandard;
-	framecan3.type   = (uint8_t)kFLEXCAN_FrameTypeData;
-	framecan3.length = (uint8_t)DLC_FOR_CAN3;
-	#if (defined(USE_CANFD) && USE_CANFD)
-	framecan3.brs = 1U;
-	framecan3.edl = 1U;
-	#endif
-	txXfercan3.mbIdx = (uint8_t)TX_CAN3_MESSAGE_BUFFER_NUM;
-	#if (defined(USE_CANFD) && USE_CANFD)
-
-	//	for(uint8_t i = 0; i < txsize; i++)
-	//	{
-	//		data_temp = (temp_arr[i] << 24);
-	//		i++;
-	//		data_temp = (temp_arr[i] << 16);
-	//		i++;
-	//		data_temp = (temp_arr[i] << 8);
-	//		i++;
-	//		data_temp |= temp_arr[i];
-	//		framecan3.dataWord[(i-3)] = data_temp;
-	//	}
-
-
-	for(i = 0; i < (txsize / 4); i++)
-	{
-		for(j = Temp; j < (4 + Temp); j++)
-		{
-			data_temp = (temp_arr[j] << 24);
-			j++;
-			data_temp |= (temp_arr[j] << 16);
-			j++;
-			data_temp |= (temp_arr[j] << 8);
-			j++;
-			data_temp |= temp_arr[j];
-		}
-		Temp = j;
-		framecan3.dataWord[i] = data_temp;
-	}
-
-	data_temp = 0;
-	for(uint8_t k = 0; k < (txsize % 4); k++)
-	{
-		data_temp |= (temp_arr[Temp + k + 0] << (8 * (3 - k)));
-	}
-	framecan3.dataWord[i] = data_temp;
-
-
-	txXfercan3.framefd = &framecan3;
-	(void)FLEXCAN_TransferFDSendNonBlocking(EXAMPLE_CAN3, &flexcan3Handle, &txXfercan3);
-	#else
-	txXfer.frame = &framecan3;
-	(void)FLEXCAN_TransferSendNonBlocking(EXAMPLE_CAN3, &flexcan3Handle, &txXfercan3);
-	#endif
-
-	while (!txcan3Complete)
-	{
-	};
-	txcan3Complete = false;
-//
-//
-//
-//
-//
-//
-//  AOSPI_OUT_OENA_CLR(); // disable level shifter output - fast implementation of digitalWrite(AOSPI_OUT_OENA, LOW)
-//  // aospi_out.endTransaction(); // Postpone this 6 us call, so that we can quickly enable reception - OSP gives 5us
-//
-//  // Enable reception
-//  AOSPI_IN_OENA_SET();  // enable level shifter output - fast implementation of digitalWrite(AOSPI_IN_OENA, HIGH);
-//  SDK_DelayAtLeastUs(0, SDK_DEVICE_MAXIMUM_CPU_CLOCK_FREQUENCY);
-//  AOSPI_IN_MSEL_CLR();  // enable "chip select" the SPIIN - fast implementation of digitalWrite(AOSPI_IN_MSEL, LOW );
-//
-//	// WARNING: can not 'return' until MSEL is de-asserted
-//
-//	// Now the background reception is running; have time to end the inlined spi_tx()
-////  aospi_master_out_end_transaction(); // takes ~6 us
-//
-//	// Wait till data starts arriving (ie wait till first clock line flip)
-//	uint32_t start = xTaskGetTickCount(); // Capture start time for timeout
-//	uint32_t cint = AOSPI_IN_CINT_GET(); // Capture current state of clock line (via CINT tap)
-//	int      clkflip = 0; // Clock flip detected
-//	while( xTaskGetTickCount()-start<AOSPI_IN_TIMEOUT_US ) { // wait for first clock flip
-//	  if( cint!=AOSPI_IN_CINT_GET() ) { clkflip=1; break; }
-//	};
-//	// Wait till whole telegram should have been received (all bits/clocks)
-//	uint32_t tele_us = (rxsize*800)/230; // 8 clocks per byte at 2.4MHz (both *100) - we assumed a slightly slower clock to be save.
-////	delayMicroseconds(tele_us);
-//	SDK_DelayAtLeastUs(tele_us, SDK_DEVICE_MAXIMUM_CPU_CLOCK_FREQUENCY);
-//
-//	// record end time; sw overhead is 7+4
-//	aospi_txrx_us_= xTaskGetTickCount(); - aospi_txrx_us_ - 11;
-
-
-
-
-
-
-
-
-
-	rxXfercan3.mbIdx = (uint8_t)RX_CAN3_MESSAGE_BUFFER_NUM;
-#if (defined(USE_CANFD) && USE_CANFD)
-	rxXfercan3.framefd = &framecan3;
-	(void)FLEXCAN_TransferFDReceiveNonBlocking(EXAMPLE_CAN3, &flexcan3Handle, &rxXfercan3);
-#else
-			rxXfer.frame = &frame;
-			(void)FLEXCAN_TransferReceiveNonBlocking(EXAMPLE_CAN, &flexcanHandle, &rxXfer);
-#endif
-
-	/* Wait until Rx MB full. */
-	while (!rxcan3Complete)
-	{
-	};
-	rxcan3Complete = false;
-
-	leng_data = convert_table_size(framecan3.length);
-
-	memcpy(rx, framecan3.dataWord, convert_table_size(framecan3.length));
-	memcpy(actsize, &leng_data, sizeof(leng_data));
-
-	PRINTF("Rx MB ID: 0x%3x, Rx MB data: 0x%x 0x%x 0x%x 0x%x 0x%x 0x%x 0x%x 0x%x, leng: %d, Time stamp: %d\r\n", framecan3.id >> CAN_ID_STD_SHIFT,
-			rx[0],rx[1],rx[2],rx[3],rx[4],
-			rx[5],rx[6],rx[7], convert_table_size(framecan3.length), framecan3.timestamp);
-
-
-
-
-
-
-
-
-//  // Disable reception
-//  AOSPI_IN_MSEL_SET(); // stop chip select - fast implementation of digitalWrite(AOSPI_IN_MSEL, HIGH)
-//  AOSPI_IN_OENA_CLR(); // disable level shifter - fast implementation of digitalWrite(AOSPI_IN_OENA, LOW)
-//
-//  // Get the received data
-//  // Thay thế: aospi_in.numTransactionsInFlight()!=0 && aospi_in.numTransactionsCompleted()!=1
-//  if(esp32_spi_slave_num_in_flight() != 0 || esp32_spi_slave_num_completed() != 1) return aoresult_assert; // should not happen (buffers pending in flight)
-//  int rxact= esp32_spi_slave_num_bytes_received();
-//  memcpy(rx,aospi_in_buf,min_size_t(rxact, rxsize));
-//  // Debug feature: zap unreliable bytes in reception buffer to 00
-//  if( actsize==0 && rxact!=rxsize ) { memset(rx + min_size_t(rxact, rxsize), 0x00, rxsize - min_size_t(rxact, rxsize)); }
-//
-//  // Update stats counters
-//  aospi_txcount++;
-//  aospi_rxcount++;
-//  aospi_txrx_size_ = txsize + rxact;
-//
-//  // Return result
-//  if( clkflip==0 ) return aoresult_spi_noclock; // no clocks seen (the telegram might still have been received, but this still took too much time, so we flag that as an error)
-//  if( actsize==0 && rxact!=rxsize ) return aoresult_spi_length;  // wrong number of bytes received
-//  if( actsize!=0 ) *actsize=rxact;
-  return aoresult_ok; // rx successful
-}
-
-// todo: Multiple aospi_tx[rx]s in a row have a 10ms wait now and then. Is this caused by 'slave' lib using freeRTOS?
 
 
 // === Direction MUX ========================================================
@@ -1171,11 +720,6 @@ static const uint16_t aospi_manchester[] = {
 // Manchester standard, and writes the encoded stream to bufo.
 // Note bufo needs to be twice as big as bufi (not checked).
 static void aospi_manchester_encode(const uint8_t *bufi, int count, uint8_t *bufo ) {
-
-	uint8_t data_need_conv[50];
-	memset(data_need_conv, 0, sizeof(data_need_conv));
-	memcpy(data_need_conv,bufi,count);
-
   for( uint8_t i=0; i<count; i++ ) {
     uint16_t w= aospi_manchester[ bufi[i] ]; 
     *bufo++ = w >> 8; // transmission is big endian
@@ -1184,47 +728,492 @@ static void aospi_manchester_encode(const uint8_t *bufi, int count, uint8_t *buf
 }
 
 
-// === MAIN =================================================================
+// === Asynchronous requests ================================================
+// Requests are encoded by aospi_submit() and handed to the backend selected
+// in aospi_init() (see aospi_backend.h). The backend completes them, 
+// possibly from an interrupt, so the CPU is free while frames are on the 
+// link.
+
+
+// The time-out for responses (see aospi_timeout_set)
+static uint32_t aospi_timeout_us = AOSPI_IN_TIMEOUT_US;
+
+// The chain that new requests go to (see aospi_chain_set)
+static int aospi_chain = 0;
+
+// Posting is on (see aospi_post_begin); aospi_submit() first queues the posted telegrams
+static int  aospi_post_active;
+static void aospi_post_send(int chain);
+
+// Number of `done` callbacks running (nested, eg in ISRs of two links); they must not wait
+static volatile int aospi_done_nesting;
+
+
+// For backends: completes request `req` with `result` (may be called from an ISR).
+void aospi_req_complete(aospi_req_t * req, aoresult_t result)
+{
+	// Capture notification fields, the owner may reuse `req` once busy is cleared
+	aospi_done_t done = req->done;
+	void *       task = req->task;
+	aospi_stat_complete(req, result);
+	req->result = result;
+	req->busy   = 0;
+	if( done )
+	{
+		aospi_done_nesting++;
+		done(req);
+		aospi_done_nesting--;
+	}
+	#if defined(SDK_OS_FREE_RTOS)
+	if( task && xPortIsInsideInterrupt() )
+	{
+		BaseType_t woken = pdFALSE;
+		vTaskNotifyGiveFromISR((TaskHandle_t)task, &woken);
+		portYIELD_FROM_ISR(woken);
+	}
+	else if( task )
+	{
+		xTaskNotifyGive((TaskHandle_t)task);
+	}
+	#else
+	(void)task;
+	#endif
+}
+
+
+// For backends: puts a prepared request at the backend.
+aoresult_t aospi_req_enqueue(aospi_req_t * req)
+{
+	AORESULT_ASSERT( aospi_phy!=aospi_phy_undef );
+	if( req->busy ) return aoresult_spi_buf; // still queued or in flight
+	req->busy   = 1;
+	req->result = aoresult_ok;
+	req->actsize= 0;
+	req->us     = 0;
+	if( req->rx ) return aospi_backend->txrx(req);
+	return aospi_backend->tx(req);
+}
 
 
 /*!
-    @brief  Sends the `txsize` bytes in buffer `tx` to the first OSP node,
-	        using the selected physical layer.
+    @brief  Lets the backend make progress, and expires overdue requests, 
+            completing them with `aoresult_spi_noclock`.
+    @note   A response is overdue when it does not arrive within the time-out
+            (see aospi_timeout_set); a response that arrives after its 
+            request has expired is dropped. A frame that can not be sent
+            (eg no bridge acknowledges it) also expires.
+    @note   `aospi_wait()` and the blocking wrappers call this function while 
+            waiting. Users of `aospi_submit()` that do not wait (eg using the 
+            `done` callback) must call it regularly.
+*/
+void aospi_poll() {
+  aospi_backend->poll();
+}
+
+
+/*!
+    @brief  Sets the time-out for responses.
+    @param  us
+            The time-out in us; default is AOSPI_IN_TIMEOUT_US, the worst 
+            case response time of the longest chain.
+    @note   A shorter time-out detects a missing node faster on short chains.
+*/
+void aospi_timeout_set(uint32_t us) {
+  aospi_timeout_us= us;
+}
+
+
+/*!
+    @brief  Returns the time-out for responses.
+    @return The time-out in us.
+*/
+uint32_t aospi_timeout_get() {
+  return aospi_timeout_us;
+}
+
+
+/*!
+    @brief  Queues a request to send the `txsize` bytes in buffer `tx` to the 
+            first OSP node, and optionally to receive the response telegram
+            in buffer `rx`. Returns without waiting for completion.
+    @param  req
+            A caller allocated request; must stay allocated (and untouched)
+            until completed. The caller may set `req->done`, `req->arg` and 
+            `req->task` before the call; other fields are set by this function.
     @param  tx
-            A pointer to a buffer of bytes to be sent.
+            A pointer to a buffer of bytes to be sent (copied into `req`).
     @param  txsize
             The number of bytes (of buffer tx) to be sent.
+    @param  rx
+            A pointer to a caller allocated buffer for the response telegram,
+            or NULL for a telegram without response. Must stay allocated until 
+            the request is completed.
+    @param  rxsize
+            The size of the `rx` buffer.
     @return aoresult_spi_buf if tx is NULL
-            aoresult_spi_buf if txsize is out of bounds (0..12)
-	          aoresult_ok (no error checking on send possible)
-    @note   With `aospi_init()` the physical layer is selected.
-	          This function just dispatches to the actual implementation.
+            aoresult_spi_buf if txsize or rxsize is out of bounds (0..12)
+            aoresult_spi_buf if `req` is still busy (queued or in flight)
+            aoresult_ok      if the request is queued
+    @note   The telegram is encoded for the physical layer selected with
+            `aospi_init()` (eg Manchester for aospi_phy_mcua).
+    @note   Completion is signaled in three ways: `req->busy` drops to 0,
+            the callback `req->done` is called (if not NULL) and the FreeRTOS 
+            task `req->task` is notified (if not NULL), eg with 
+            `req.task= xTaskGetCurrentTaskHandle()` and `ulTaskNotifyTake()`.
+            After completion, `req->result`, `req->actsize` and `req->us` 
+            are valid.
+    @note   A request that times out completes with aoresult_spi_noclock,
+            see `aospi_poll()`.
+    @note   The callback and the notification may run in interrupt context
+            (depending on the backend). A callback may submit a new request 
+            (eg to chain telegrams), but must not call anything that waits
+            (aospi_wait, aospi_tx, aospi_txrx, aospi_tx_batch, aospi_post_end
+            and thus aoosp_send_xxx): the completion it waits for may need 
+            the interrupt the callback runs in. While posting, a submit from
+            a callback queues the posted frame without waiting for a free
+            request of the pool; the next aospi_tx() waits for it instead.
+    @note   The request goes to the chain selected with `aospi_chain_set()`.
+    @note   Frames are sent in order of submission. A request without 
+            response completes when its frame is sent, a request with 
+            response when its response arrives. With the FlexCAN backend 
+            and sequence tags (see aospi_rxtag_enable), many requests with 
+            response can be in flight; that pipelines reads.
+    @note   While posting (see aospi_post_begin), the telegrams posted for
+            the selected chain are queued first, so they keep their order.
 */
-aoresult_t aospi_tx(const uint8_t * tx, int txsize) {
-  uint8_t temp_arr[50] = {0};
-  memset(temp_arr, 0, sizeof(temp_arr));
-  memcpy(temp_arr, tx, txsize);
+aoresult_t aospi_submit(aospi_req_t * req, const uint8_t * tx, int txsize, uint8_t * rx, int rxsize) {
   // Parameter checks
   if( txsize<0 || txsize>AOSPI_TELE_MAXSIZE ) return aoresult_spi_buf;
   if( tx==0 )  return aoresult_spi_buf;
-  // Dispatch
+  if( rx!=0 && (rxsize<0 || rxsize>AOSPI_TELE_MAXSIZE) ) return aoresult_spi_buf;
+  if( req->busy ) return aoresult_spi_buf;
+  if( aospi_post_active ) aospi_post_send(aospi_chain); // posted telegrams go first
+  // Encode for the phy
   switch( aospi_phy ) {
     case aospi_phy_mcua  : {
-      uint8_t tx_man[AOSPI_TELE_MAXSIZE*2];
-      aospi_manchester_encode(temp_arr,txsize,tx_man);
-      return aospi_tx_internal(AOSPI_OUT_TYPEA_FREQ,tx_man,txsize*2);
+      aospi_manchester_encode(tx,txsize,req->tx);
+      req->txsize= txsize*2;
       break;
     }
     case aospi_phy_mcub  : {
-      return aospi_tx_internal(AOSPI_OUT_TYPEB_FREQ,tx,txsize);
+      memcpy(req->tx,tx,txsize);
+      req->txsize= txsize;
       break;
     }
     default : {
       AORESULT_ASSERT( false ); // others not yet supported
-      return aoresult_assert; 
+      return aoresult_assert;
       break;
     }
   }
+  req->txcount= 0;
+  aospi_stat_tag(req, tx, txsize);
+  req->chain  = aospi_chain;
+  req->txcount= 1;
+  req->batch  = 0;
+  req->rx     = rx;
+  req->rxsize = rxsize;
+  aoresult_t result= aospi_req_enqueue(req);
+  if( result==aoresult_ok ) aospi_stat_tx(tx, txsize);
+  return result;
+}
+
+
+/*!
+    @brief  Selects the OSP chain that subsequent telegrams go to.
+    @param  chain
+            The chain, 0..aospi_chain_count()-1.
+    @return aoresult_spi_buf if chain is out of bounds (selection unchanged)
+            aoresult_ok      otherwise
+    @note   A backend may drive several independent OSP chains, eg the 
+            FlexCAN backend has chain 0 on CAN3 and chain 1 on CAN2, each 
+            with its own CAN-to-OSP bridge. Requests on different chains 
+            are in flight at the same time; requests on one chain keep 
+            their order.
+    @note   All entry points (aospi_submit, aospi_tx, aospi_tx_batch and
+            aospi_txrx, and thus aoosp) use the selected chain. Addresses
+            are per chain: each chain has its own node 001.
+    @note   The default is chain 0.
+*/
+aoresult_t aospi_chain_set(int chain) {
+  if( chain<0 || chain>=aospi_chain_count() ) return aoresult_spi_buf;
+  aospi_chain= chain;
+  return aoresult_ok;
+}
+
+
+/*!
+    @brief  Returns the OSP chain selected with aospi_chain_set().
+    @return The selected chain, 0..aospi_chain_count()-1.
+*/
+int aospi_chain_get() {
+  return aospi_chain;
+}
+
+
+/*!
+    @brief  Returns the number of OSP chains the backend drives.
+    @return The number of chains; 1 for backends with a single link
+            (and before aospi_init()).
+*/
+int aospi_chain_count() {
+  if( aospi_backend==0 || aospi_backend->chains<1 ) return 1;
+  if( aospi_backend->chains>AOSPI_CHAIN_MAXCOUNT ) return AOSPI_CHAIN_MAXCOUNT;
+  return aospi_backend->chains;
+}
+
+
+/*!
+    @brief  Waits until request `req` is completed.
+    @param  req
+            A request previously passed to `aospi_submit()`.
+    @return The result of the request (`req->result`).
+    @note   This function spins on `req->busy`, expiring overdue requests
+            with `aospi_poll()`, so it always returns. Tasks that want to give
+            up the CPU should use `req->task` and `ulTaskNotifyTake()` with a 
+            time-out instead (and call `aospi_poll()` when it expires).
+*/
+aoresult_t aospi_wait(aospi_req_t * req) {
+  while( req->busy ) {
+    aospi_poll();
+  };
+  return req->result;
+}
+
+
+/*!
+    @brief  Reports whether there are requests queued or in flight.
+    @return 1 iff all submitted requests are completed.
+*/
+int aospi_idle() {
+  return aospi_backend->idle();
+}
+
+
+// === Posting ==============================================================
+// Between aospi_post_begin() and aospi_post_end(), aospi_tx() does not wait:
+// the telegram is packed in a batched frame (see aospi_frame.c) for the 
+// selected chain, and the frame is queued when full. Each chain has its own
+// small pool of requests, so while one frame is on the bus the next one is 
+// packed. Since the chains have independent links, posting telegrams for 
+// both chains alternately keeps both buses busy (see aomw_topo_settriplets).
+
+
+// Requests per chain: one being packed, the others queued or in flight
+#define AOSPI_POST_REQS 3
+
+
+static aospi_req_t aospi_post_reqs[AOSPI_CHAIN_MAXCOUNT][AOSPI_POST_REQS];    // the request pool of each chain
+static int         aospi_post_ix[AOSPI_CHAIN_MAXCOUNT];                       // per chain, the request being packed
+static volatile int aospi_post_stale[AOSPI_CHAIN_MAXCOUNT];                   // per chain, the request being packed is not yet reused (see aospi_post_send)
+static aoresult_t  aospi_post_result;                                         // first error of a posted frame
+
+
+// Waits for posted request `req` (recording its error), and prepares it for packing for `chain`.
+static void aospi_post_reuse(aospi_req_t * req, int chain) {
+  aoresult_t result= aospi_wait(req);
+  if( aospi_post_result==aoresult_ok ) aospi_post_result= result;
+  req->result= aoresult_ok;
+  req->chain= chain;
+  req->txsize= 0;
+  req->txcount= 0;
+  req->batch= 1;
+  req->rx= 0;
+  aospi_post_stale[chain]= 0;
+}
+
+
+// Queues the frame being packed for `chain` (if it has telegrams), and continues packing in the next request of the pool.
+// The next request is stale until reused, so a callback during the wait finds nothing to queue. A callback itself 
+// does not wait: it leaves the request stale, and aospi_post() reuses it.
+static void aospi_post_send(int chain) {
+  aospi_req_t * req= &aospi_post_reqs[chain][aospi_post_ix[chain]];
+  if( aospi_post_stale[chain] || req->txcount==0 ) return;
+  aoresult_t result= aospi_req_enqueue(req);
+  if( result!=aoresult_ok && aospi_post_result==aoresult_ok ) aospi_post_result= result;
+  aospi_post_ix[chain]= (aospi_post_ix[chain]+1) % AOSPI_POST_REQS;
+  aospi_post_stale[chain]= 1;
+  if( aospi_done_nesting==0 ) aospi_post_reuse(&aospi_post_reqs[chain][aospi_post_ix[chain]], chain);
+}
+
+
+// Packs telegram `tx` (`txsize` bytes) in the frame for the selected chain (aospi_tx while posting).
+static aoresult_t aospi_post(const uint8_t * tx, int txsize) {
+  if( tx==0 ) return aoresult_spi_buf;
+  if( txsize<1 || txsize>AOSPI_TELE_MAXSIZE ) return aoresult_spi_buf;
+  const uint8_t * tele= tx;
+  int telesize= txsize;
+  uint8_t tx_man[AOSPI_TELE_MAXSIZE*2];
+  if( aospi_phy==aospi_phy_mcua ) {
+    aospi_manchester_encode(tx,txsize,tx_man);
+    tx= tx_man;
+    txsize= txsize*2;
+  }
+  aospi_req_t * req= &aospi_post_reqs[aospi_chain][aospi_post_ix[aospi_chain]];
+  if( aospi_post_stale[aospi_chain] ) aospi_post_reuse(req, aospi_chain); // the frame was queued by a callback
+  if( !aospi_frame_add(req->tx,&req->txsize,tx,txsize) ) {
+    // Frame full: queue it, and continue packing in the next request
+    aospi_post_send(aospi_chain);
+    req= &aospi_post_reqs[aospi_chain][aospi_post_ix[aospi_chain]];
+    aospi_frame_add(req->tx,&req->txsize,tx,txsize);
+  }
+  // Counted now: the frame is queued later, on a request that was waited for, so it is accepted
+  aospi_stat_tag(req, tele, telesize);
+  aospi_stat_tx(tele, telesize);
+  req->txcount++;
+  return aoresult_ok;
+}
+
+
+/*!
+    @brief  Starts posting: until aospi_post_end(), aospi_tx() packs its
+            telegram in a batched frame for the selected chain, and returns 
+            without waiting.
+    @note   Frames are queued when full, and at the latest by aospi_post_end().
+            aospi_submit() (so also aospi_txrx) and aospi_tx_batch() first
+            queue the posted telegrams of their chain, so telegrams keep 
+            their order.
+    @note   Errors are reported by aospi_post_end(); aospi_tx() only checks 
+            its parameters while posting.
+    @note   Use this for telegrams without response (eg SETPWM) that go to
+            several chains: select the chain (aospi_chain_set) before each 
+            aospi_tx(), alternating chains, so that all links are busy.
+    @note   Like aospi_tx_batch(), the CAN-to-OSP bridge must support the 
+            batched frame format.
+*/
+void aospi_post_begin() {
+  AORESULT_ASSERT( aospi_phy==aospi_phy_mcua || aospi_phy==aospi_phy_mcub );
+  if( aospi_post_active ) return;
+  aospi_post_result= aoresult_ok;
+  for( int chain=0; chain<AOSPI_CHAIN_MAXCOUNT; chain++ ) {
+    aospi_post_ix[chain]= 0;
+    aospi_post_reuse(&aospi_post_reqs[chain][0], chain);
+  }
+  aospi_post_active= 1;
+}
+
+
+/*!
+    @brief  Ends posting: queues the remaining posted telegrams, and waits
+            until all posted frames are sent.
+    @return aoresult_ok          if all posted frames are sent
+            aoresult_spi_noclock if a frame was not acknowledged on the bus
+            other error code     of the first posted frame that failed
+    @note   See aospi_post_begin().
+*/
+aoresult_t aospi_post_end() {
+  if( !aospi_post_active ) return aoresult_ok;
+  for( int chain=0; chain<aospi_chain_count(); chain++ ) aospi_post_send(chain);
+  for( int chain=0; chain<AOSPI_CHAIN_MAXCOUNT; chain++ ) {
+    for( int i=0; i<AOSPI_POST_REQS; i++ ) aospi_post_reuse(&aospi_post_reqs[chain][i], chain);
+  }
+  aospi_post_active= 0;
+  return aospi_post_result;
+}
+
+
+// === MAIN =================================================================
+
+
+/*!
+    @brief  Sends the `txsize` bytes in buffer `tx` to the first OSP node,
+	        using the selected physical layer.
+    @param  tx
+            A pointer to a buffer of bytes to be sent.
+    @param  txsize
+            The number of bytes (of buffer tx) to be sent.
+    @return aoresult_spi_buf if tx is NULL
+            aoresult_spi_buf if txsize is out of bounds (0..12)
+            aoresult_spi_noclock if the frame is not acknowledged on the bus
+	          aoresult_ok      otherwise
+    @note   With `aospi_init()` the physical layer is selected.
+	          This function is a blocking wrapper around `aospi_submit()`.
+    @note   Between aospi_post_begin() and aospi_post_end() this function
+            does not wait, see aospi_post_begin().
+*/
+aoresult_t aospi_tx(const uint8_t * tx, int txsize) {
+  if( aospi_post_active ) return aospi_post(tx, txsize);
+  aospi_req_t req= {0};
+  aoresult_t result= aospi_submit(&req, tx, txsize, 0, 0);
+  if( result!=aoresult_ok ) return result;
+  return aospi_wait(&req);
+}
+
+
+/*!
+    @brief  Sends `count` telegrams to the first OSP node, using the selected
+            physical layer, packing as many telegrams as fit in one CAN-FD 
+            frame.
+    @param  teles
+            An array of `count` pointers to telegrams to be sent.
+    @param  sizes
+            An array of `count` sizes; `sizes[i]` is the number of bytes 
+            of telegram `teles[i]`.
+    @param  count
+            The number of telegrams to be sent.
+    @return aoresult_spi_buf if teles, sizes or one of the telegrams is NULL
+            aoresult_spi_buf if one of the sizes is out of bounds (1..12)
+	          aoresult_ok (no error checking on send possible)
+    @note   Uses the batched frame format (see aospi_frame.c): each telegram 
+            is preceded by a length byte and frames are filled up to 64 bytes 
+            (DLC 15). The last frame uses the smallest DLC that fits (but 
+            at least DLC_FOR_CAN3).
+    @note   Telegrams are sent in order. All parameters are checked before 
+            the first frame is sent, so on error nothing is sent.
+    @note   Like aospi_tx(), this is for telegrams without response. 
+            The CAN-to-OSP bridge must support the batched frame format.
+    @note   Two requests are used alternately, so that the next frame is 
+            packed while the previous one is on the bus.
+*/
+aoresult_t aospi_tx_batch(const uint8_t * const teles[], const int sizes[], int count) {
+  // Parameter checks
+  if( teles==0 || sizes==0 ) return aoresult_spi_buf;
+  for( int i=0; i<count; i++ ) {
+    if( teles[i]==0 ) return aoresult_spi_buf;
+    if( sizes[i]<1 || sizes[i]>AOSPI_TELE_MAXSIZE ) return aoresult_spi_buf;
+  }
+  AORESULT_ASSERT( aospi_phy==aospi_phy_mcua || aospi_phy==aospi_phy_mcub );
+  if( aospi_post_active ) aospi_post_send(aospi_chain); // posted telegrams go first
+  // Pack and send
+  aospi_req_t    reqs[2]= {0};
+  aospi_req_t  * req= &reqs[0];
+  int            first= 0; // the first telegram in req
+  aoresult_t     result= aoresult_ok;
+  reqs[0].batch= 1;
+  reqs[1].batch= 1;
+  reqs[0].chain= aospi_chain;
+  reqs[1].chain= aospi_chain;
+  for( int i=0; i<count; i++ ) {
+    uint8_t        tx_man[AOSPI_TELE_MAXSIZE*2];
+    const uint8_t *tx    = teles[i];
+    int            txsize= sizes[i];
+    if( aospi_phy==aospi_phy_mcua ) {
+      aospi_manchester_encode(teles[i],sizes[i],tx_man);
+      tx= tx_man;
+      txsize= sizes[i]*2;
+    }
+    if( !aospi_frame_add(req->tx,&req->txsize,tx,txsize) ) {
+      // Frame full: send it (its telegrams count once accepted), and continue packing in the other request
+      if( result==aoresult_ok ) result= aospi_req_enqueue(req);
+      if( result==aoresult_ok ) for( int j=first; j<i; j++ ) aospi_stat_tx(teles[j], sizes[j]);
+      first= i;
+      req= req==&reqs[0] ? &reqs[1] : &reqs[0];
+      aospi_wait(req);
+      req->txsize= 0;
+      req->txcount= 0;
+      req->batch= 1;
+      aospi_frame_add(req->tx,&req->txsize,tx,txsize);
+    }
+    aospi_stat_tag(req, teles[i], sizes[i]);
+    req->txcount++;
+  }
+  if( req->txsize>0 && result==aoresult_ok ) {
+    result= aospi_req_enqueue(req);
+    if( result==aoresult_ok ) for( int j=first; j<count; j++ ) aospi_stat_tx(teles[j], sizes[j]);
+  }
+  aospi_wait(&reqs[0]);
+  aospi_wait(&reqs[1]);
+  return result;
 }
 
 
@@ -1259,65 +1248,24 @@ aoresult_t aospi_tx(const uint8_t * tx, int txsize) {
     @note   If caller does not knows how many bytes will be received, set 
             `rxsize` to largest possible telegram (ie AOSPI_TELE_MAXSIZE) 
             and pass an `actsize`. 
+    @note   At most `rxsize` bytes are copied to `rx`, but `actsize` reports
+            the size of the received frame (which the bridge may pad).
     @note   With `aospi_init()` the physical layer is selected.
-	          This function just dispatches to the actual implementation.
+	          This function is a blocking wrapper around `aospi_submit()`.
             Recall that the physical layer is only different fro the transmit
             part, reception is always 2-wire SPI.
 */
-
-static void convert_to_big_endian_uint8(uint32_t source[], uint8_t destination[], size_t num_elements)
-{
-    for (size_t i = 0; i < num_elements; i++)
-    {
-        uint32_t value = source[i];
-        size_t dest_index = i * 4;
-
-        destination[dest_index + 0] = (uint8_t)(value >> 24);
-
-        destination[dest_index + 1] = (uint8_t)(value >> 16);
-
-        destination[dest_index + 2] = (uint8_t)(value >> 8);
-
-        destination[dest_index + 3] = (uint8_t)value;
-    }
-}
-
 aoresult_t aospi_txrx(const uint8_t * tx, int txsize, uint8_t * rx, int rxsize, int *actsize) {
-	uint32_t data_recive_row[16];
-	uint8_t data_recive_convert[50];
-	int acture_size = 0;
-	aoresult_t status;
-	memset(data_recive_row, 0, sizeof(data_recive_row));
-	memset(data_recive_convert, 0, sizeof(data_recive_convert));
-  // Parameter checks
-  if( txsize<0 || txsize>AOSPI_TELE_MAXSIZE ) return aoresult_spi_buf;
-  if( tx==0 )  return aoresult_spi_buf;
-  // Dispatch
-  switch( aospi_phy ) {
-    case aospi_phy_mcua  : {
-      uint8_t tx_man[AOSPI_TELE_MAXSIZE*2];
-      aospi_manchester_encode(tx,txsize,tx_man);
-      status = aospi_txrx_internal(AOSPI_OUT_TYPEA_FREQ, tx_man, txsize*2, data_recive_row, rxsize, &acture_size);
-      convert_to_big_endian_uint8(data_recive_row, data_recive_convert, acture_size);
-      memcpy(rx, data_recive_convert, acture_size);
-      memcpy(actsize, &acture_size, sizeof(int));
-      return status;
-      break;
-    }
-    case aospi_phy_mcub  : {
-    	status = aospi_txrx_internal(AOSPI_OUT_TYPEB_FREQ, tx, txsize, data_recive_row, rxsize, &acture_size);
-    	convert_to_big_endian_uint8(data_recive_row, data_recive_convert, acture_size);
-    	memcpy(rx, data_recive_convert, acture_size);
-    	memcpy(actsize, &acture_size, sizeof(int));
-      return status;
-      break;
-    }
-    default : {
-      AORESULT_ASSERT( false ); // others not yet supported
-      return aoresult_assert;
-      break;
-    }
-  }
+  if( rx==0 ) return aoresult_spi_buf;
+  aospi_req_t req= {0};
+  aoresult_t result= aospi_submit(&req, tx, txsize, rx, rxsize);
+  if( result!=aoresult_ok ) return result;
+  result= aospi_wait(&req);
+  aospi_txrx_us_= req.us;
+  if( result!=aoresult_ok ) return result;
+  if( actsize==0 && req.actsize!=rxsize ) return aoresult_spi_length; // wrong number of bytes received
+  if( actsize!=0 ) *actsize= req.actsize;
+  return aoresult_ok;
 }
 
 
@@ -1328,6 +1276,13 @@ aoresult_t aospi_txrx(const uint8_t * tx, int txsize, uint8_t * rx, int rxsize,
             for subsequent calls to aospi_tx() and aospi_txrx.
               aospi_phy_mcua: MCU uses type A (1-wire Manchester)
               aospi_phy_mcub: MCU uses type B (2-wire SPI)
+    @param  backend
+            The PHY backend that moves the telegrams, eg 
+            &aospi_backend_flexcan (to a CAN-to-OSP bridge), 
+            &aospi_backend_lpspi (native SPI), &aospi_backend_loopback or
+            &aospi_backend_sim (virtual chain, see aospi_sim_chain_set,
+            only with AOSPI_SIM_ENABLED).
+            NULL selects &aospi_backend_flexcan.
     @note   The OSP32 board's default is type B, so that is also the default
             value when calling this function. For type A physical layer some
             jumpers have to be set, see e.g. aospi/examples/aospi_mcua
@@ -1335,12 +1290,27 @@ aoresult_t aospi_txrx(const uint8_t * tx, int txsize, uint8_t * rx, int rxsize,
             The default direction is BiDir.
             Prints completion to Serial.
 */
-void aospi_init( aospi_phy_t phy ) {
+void aospi_init( aospi_phy_t phy, const aospi_backend_t * backend ) {
   AORESULT_ASSERT( aospi_phy==aospi_phy_undef ); // double init?
   AORESULT_ASSERT( phy==aospi_phy_mcua || phy==aospi_phy_mcub ); 
+  if( backend==0 ) backend= &aospi_backend_flexcan;
   aospi_out_init();
   aospi_in_init();
-  PRINTF("CAN: init(%s)\n", aospi_phy_str(phy) );
+  // The DWT cycle counter times the requests (round trip time, time-outs)
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
   aospi_phy = phy;
+  aospi_backend = backend;
+  backend->init(phy);
+  PRINTF("%s: init(%s)\n", backend->name, aospi_phy_str(phy) );
+}
+
+
+/*!
+    @brief  Returns the backend selected in aospi_init().
+    @return The backend, or NULL before aospi_init().
+*/
+const aospi_backend_t * aospi_backend_get() {
+  return aospi_backend;
 }
 
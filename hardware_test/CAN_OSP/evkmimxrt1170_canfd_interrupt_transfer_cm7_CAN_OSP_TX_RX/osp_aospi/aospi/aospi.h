@@ -27,6 +27,7 @@
 #include "stdlib.h"
 #include "stdint.h"
 #include "aoresult.h"
+#include "aospi_frame.h"
 
 
 // Identifies lib version
@@ -51,16 +52,152 @@ typedef enum aospi_phy_e {
 const char * aospi_phy_str( aospi_phy_t phy );
 
 
-// Initializes the SPI OUT and IN controllers and their support pins for the selected phy.
-void aospi_init( aospi_phy_t phy); // OSP32 board wired for mcub
+// The PHY backend (see aospi_backend_t)
+typedef struct aospi_backend_s aospi_backend_t;
+// Initializes the SPI OUT and IN support pins for the selected phy, and the selected backend (NULL for FlexCAN).
+void aospi_init( aospi_phy_t phy, const aospi_backend_t * backend ); // OSP32 board wired for mcub
+// Returns the backend selected in aospi_init().
+const aospi_backend_t * aospi_backend_get();
 
 
 // Sends the `txsize` bytes in buffer `tx` to the first OSP node.
 aoresult_t aospi_tx(const uint8_t * tx, int txsize);
+// Sends `count` telegrams to the first OSP node, packing as many as fit in one CAN-FD frame.
+aoresult_t aospi_tx_batch(const uint8_t * const teles[], const int sizes[], int count);
 // Sends the `txsize` bytes in buffer `tx` to the first OSP node. Waits for a response telegram and stores those bytes in buffer `rx` with size `rxsize`.
 aoresult_t aospi_txrx(const uint8_t * tx, int txsize, uint8_t * rx, int rxsize, int *actsize);
 
 
+// Maximum number of MBs in the TX ring (of each FlexCAN controller)
+#define AOSPI_TXRING_MAXDEPTH 6
+
+
+// An asynchronous request (one frame out, optionally one response in), see aospi_submit().
+typedef struct aospi_req_s aospi_req_t;
+// Completion callback of an asynchronous request (called in interrupt context; may submit, must not wait).
+typedef void (*aospi_done_t)( aospi_req_t * req );
+struct aospi_req_s {
+  // Optionally set by the caller before aospi_submit()
+  aospi_done_t        done;    // called on completion (may be NULL)
+  void              * arg;     // free for use by the caller (eg by `done`)
+  void              * task;    // FreeRTOS TaskHandle_t notified on completion (may be NULL)
+  // Set by aospi
+  int                 chain;   // the OSP chain (link) the frame goes to, see aospi_chain_set()
+  uint8_t             tx[AOSPI_FRAME_MAXSIZE]; // the frame as it goes on the bus
+  int                 txsize;  // number of bytes in tx
+  int                 txcount; // number of telegrams in tx
+  int                 batch;   // tx is a batched frame (see aospi_frame.c), otherwise one telegram
+  uint8_t           * rx;      // response buffer (NULL when no response is expected)
+  int                 rxsize;  // size of rx
+  int                 actsize; // size of the received response
+  volatile int        busy;    // 1 while queued or in flight
+  volatile aoresult_t result;  // result, valid once busy is 0
+  uint8_t             tag;     // sequence tag matching the response to this request
+  uint8_t             tid;     // TID of the telegram(s) in tx, or AOSPI_STAT_TID_OTHER (for telemetry)
+  volatile uint8_t    txdone;  // frame has been sent
+  volatile uint8_t    rxgot;   // response has been received
+  uint32_t            t0;      // time stamp (backend specific) when the frame was handed to the link
+  uint32_t            us;      // time from loading the frame to completion (send or response)
+  aospi_req_t       * next;    // queue link
+};
+
+
+// A PHY backend moves the (encoded) frames of requests to the OSP chain, and the responses back.
+struct aospi_backend_s {
+  const char * name;                              // human readable name
+  int          chains;                            // number of independent OSP chains (links), see aospi_chain_set()
+  void       (*init)( aospi_phy_t phy );          // sets up the link (controllers, pins)
+  aoresult_t (*tx)( aospi_req_t * req );          // starts sending req->tx; completes req once sent
+  aoresult_t (*txrx)( aospi_req_t * req );        // starts sending req->tx; completes req once the response is in req->rx
+  void       (*poll)( void );                     // makes progress outside interrupts; expires overdue requests
+  int        (*idle)( void );                     // returns 1 iff the backend holds no requests
+};
+
+
+// FlexCAN-FD to the CAN-to-OSP bridges (chain 0 on CAN3, chain 1 on CAN2), interrupt driven, pipelined (default)
+extern const aospi_backend_t aospi_backend_flexcan;
+// LPSPI master to the first node (SPI OUT), LPSPI slave from the first or last node (SPI IN), blocking;
+// experimental: not run on a board yet, and the application must mux its pins (see aospi_lpspi.c)
+extern const aospi_backend_t aospi_backend_lpspi;
+// In-process loop back: frames are sent nowhere, a response echoes the request
+extern const aospi_backend_t aospi_backend_loopback;
+
+// When 1, the sim backend (aospi_sim.c) is compiled in. Its virtual chain 
+// takes some 58 kB of RAM (AOSPI_SIM_MAXNODES nodes), so the firmware leaves
+// it out; host builds (see tools/) compile with -DAOSPI_SIM_ENABLED=1.
+#ifndef AOSPI_SIM_ENABLED
+#define AOSPI_SIM_ENABLED 0
+#endif
+#if AOSPI_SIM_ENABLED
+// Virtual OSP chain: telegrams are executed in-process by a model of the nodes, with modelled link time
+extern const aospi_backend_t aospi_backend_sim;
+#endif
+#if defined(__linux__)
+// Linux SocketCAN (eg vcan0) to a CAN-to-OSP bridge (or a bridge model), same frames as FlexCAN
+extern const aospi_backend_t aospi_backend_socketcan;
+#endif
+
+
+// Queues a request to send `tx` (and receive a response in `rx` if not NULL); returns without waiting.
+aoresult_t aospi_submit(aospi_req_t * req, const uint8_t * tx, int txsize, uint8_t * rx, int rxsize);
+// Waits until request `req` is completed, returns its result.
+aoresult_t aospi_wait(aospi_req_t * req);
+// Returns 1 iff all submitted requests are completed.
+int aospi_idle();
+// Expires requests whose frame is not sent, or whose response does not arrive in time (aoresult_spi_noclock).
+void aospi_poll();
+// Maximum number of OSP chains a backend drives
+#define AOSPI_CHAIN_MAXCOUNT 2
+// Selects the OSP chain (0..aospi_chain_count()-1) that subsequent telegrams go to (default 0).
+aoresult_t aospi_chain_set(int chain);
+// Returns the selected OSP chain.
+int aospi_chain_get();
+// Returns the number of OSP chains the backend drives (FlexCAN: 2, others: 1).
+int aospi_chain_count();
+// Starts posting: aospi_tx() packs its telegram in a batched frame for the selected chain and returns without waiting.
+void aospi_post_begin();
+// Ends posting: sends the remaining posted telegrams, waits until all are sent, returns the first error.
+aoresult_t aospi_post_end();
+// Sets the response timeout in us (default AOSPI_IN_TIMEOUT_US).
+void aospi_timeout_set(uint32_t us);
+// Returns the response timeout in us.
+uint32_t aospi_timeout_get();
+// FlexCAN backend: enables (default) or disables sequence tags, which allow several requests with response in flight.
+void aospi_rxtag_enable(int enable);
+// Returns 1 iff requests with response are sent with a sequence tag.
+int aospi_rxtag_isenabled();
+// FlexCAN backend: sets the number of MBs (per controller) used for outgoing frames (1..AOSPI_TXRING_MAXDEPTH).
+aoresult_t aospi_txring_setdepth(int depth);
+// FlexCAN backend: returns the number of MBs (per controller) used for outgoing frames.
+int aospi_txring_getdepth();
+// FlexCAN backend: benchmark, sends `frames` frames back-to-back with CAN3 in loop back, reports time taken in `us`.
+aoresult_t aospi_bench(int frames, uint32_t * us);
+
+
+#if AOSPI_SIM_ENABLED
+// Maximum number of nodes in the virtual chain of the sim backend
+#ifndef AOSPI_SIM_MAXNODES
+#define AOSPI_SIM_MAXNODES 1002
+#endif
+// Default forwarding time of a node (hop) in the sim backend, see aospi_txrx_hops()
+#define AOSPI_SIM_HOP_NS 7500
+// Chain of the sim backend when aospi_sim_chain_set() is not called
+#define AOSPI_SIM_CHAIN_DEFAULT "SRRI"
+// Sim backend: sets the virtual chain, one character per node ('R' RGBI, 'S' SAID, 'I' SAID with I2C bridge), wired as Loop iff `loop`.
+aoresult_t aospi_sim_chain_set(const char * nodes, int loop);
+// Sim backend: sets the forwarding time of one node (hop) in ns.
+void aospi_sim_hop_set(uint32_t ns);
+// Sim backend: makes the next `count` requests fail (not acknowledged, nodes do not get the telegrams).
+void aospi_sim_fail_set(int count);
+// Sim backend: returns the modelled link time (us) of all requests since aospi_sim_chain_set().
+uint64_t aospi_sim_time_us();
+// Sim backend: returns the number of telegrams the virtual chain dropped (not modelled, malformed).
+int aospi_sim_dropcount_get();
+// Sim backend: returns in rgb[0..2] the PWM setting node `addr` shows on channel `chn` (a synced SAID channel only changes on SYNC).
+aoresult_t aospi_sim_pwm_get(uint16_t addr, int chn, uint16_t * rgb);
+#endif
+
+
 //Returns the round trip time for the last `aospi_txrx()` call.
 uint32_t aospi_txrx_us();
 //Returns an estimate of the number of hops a command telegram and it response need in a bidirectional round trip.
@@ -87,6 +224,35 @@ int  aospi_txcount_get();
 int  aospi_rxcount_get();
 
 
+// Telemetry: one row per TID (0x00..0x7F), plus one for frames that do not have a single TID (batches of several TIDs, malformed, bench)
+#define AOSPI_STAT_TID_OTHER  0x80
+#define AOSPI_STAT_TIDS       (AOSPI_STAT_TID_OTHER+1)
+// Telemetry: number of log2 buckets in the latency histograms (bucket b counts times of 2^(b-1)..2^b-1 us, the last one also longer times)
+#define AOSPI_STAT_BUCKETS    16
+// Telemetry: worst case size of aospi_stat_dump() (every TID used, every counter at its maximum)
+#define AOSPI_STAT_DUMP_MAXSIZE ( 4 + 5*aoresult_numresultcodes + 2 + AOSPI_STAT_TIDS*(1+6*5+AOSPI_STAT_BUCKETS*3) )
+// Telemetry of one TID, see aospi_stat_tid()
+typedef struct aospi_stat_tid_s {
+  uint32_t txcount;                     // telegrams sent (their frame accepted by the backend)
+  uint32_t txbytes;                     // bytes of those telegrams (before phy encoding)
+  uint32_t rxcount;                     // responses received
+  uint32_t rxbytes;                     // bytes of those responses
+  uint32_t errcount;                    // requests that failed, and responses rejected by aoosp
+  uint32_t us;                          // total time of the successful requests (see aospi_req_t.us), a measure of bus time
+  uint16_t hist[AOSPI_STAT_BUCKETS];    // log2 histogram of the times of the successful requests (saturates at 0xFFFF)
+} aospi_stat_tid_t;
+// Telemetry: resets all per-TID and per-result counters.
+void aospi_stat_reset();
+// Telemetry: returns the counters of `tid` (0..AOSPI_STAT_TID_OTHER), or NULL when out of range.
+const aospi_stat_tid_t * aospi_stat_tid(int tid);
+// Telemetry: returns how often `result` was the outcome of a request (aospi) or a response validation (aoosp).
+uint32_t aospi_stat_result(aoresult_t result);
+// Telemetry: records that the response to telegram `tele` was rejected with `result` (called by aoosp).
+void aospi_stat_error(const uint8_t * tele, int size, aoresult_t result);
+// Telemetry: writes all counters in a compact binary format to `buf` (`size` bytes), sets `*len` to the number of bytes written.
+aoresult_t aospi_stat_dump(uint8_t * buf, int size, int * len);
+
+
 // For testing! Sets the output-enable of the outgoing level shifter to `val`.
 void aospi_outoena_set( int val );
 // For testing! Returns the state of the output-enable of the outgoing level shifter.
@@ -0,0 +1,58 @@
+// aospi_backend.h - interface between aospi and its PHY backends
+/*****************************************************************************
+ * Copyright 2024,2025 by ams OSRAM AG                                       *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#ifndef _AOSPI_BACKEND_H_
+#define _AOSPI_BACKEND_H_
+
+
+// This header is only for the implementations of aospi_backend_t;
+// applications use aospi.h.
+//
+// aospi_submit() (and the other entry points) encode the telegram, fill
+// out the request and hand it to the `tx` or `txrx` of the backend selected
+// in aospi_init(). The backend owns the request until it calls
+// aospi_req_complete(). Before that, it reports progress with
+// aospi_req_sent() (telegrams are on the link) and aospi_req_received()
+// (response copied to req->rx), so that aospi keeps its counters.
+// A backend may complete a request in `tx`/`txrx` itself (blocking
+// backends), in an ISR, or in `poll`.
+
+
+#include "aospi.h"
+
+
+// For backends: puts a prepared request (tx, txsize, txcount, rx, rxsize set) at the backend.
+aoresult_t aospi_req_enqueue(aospi_req_t * req);
+// For backends: the frame of `req` has been sent (counts its telegrams).
+void aospi_req_sent(aospi_req_t * req);
+// For backends: the response of `req`, `size` bytes, has been copied to req->rx (sets actsize, counts it).
+void aospi_req_received(aospi_req_t * req, int size);
+// For backends: completes `req` with `result`; notifies the owner. May be called from an ISR.
+void aospi_req_complete(aospi_req_t * req, aoresult_t result);
+// For backends: sets the output-enable of the outgoing level shifter (held high while sending).
+void aospi_backend_outoena(int val);
+
+
+// For backends on the MCU: conversion between DWT cycles (enabled by aospi_init) and us
+#define AOSPI_US2CYCLES(us)      ((uint32_t)(us) * (SystemCoreClock/1000000))
+#define AOSPI_CYCLES2US(cycles)  ((uint32_t)(cycles) / (SystemCoreClock/1000000))
+
+
+#endif
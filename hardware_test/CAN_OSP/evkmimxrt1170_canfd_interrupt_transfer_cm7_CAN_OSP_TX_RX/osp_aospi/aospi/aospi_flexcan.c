@@ -0,0 +1,894 @@
+// aospi_flexcan.c - PHY backend: CAN-FD (FlexCAN CAN3 and CAN2) to CAN-to-OSP bridges
+/*****************************************************************************
+ * Copyright 2024,2025 by ams OSRAM AG                                       *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#include "aoresult.h"
+#include "aospi.h"
+#include "aospi_frame.h"
+#include "aospi_backend.h"
+#include "fsl_flexcan.h"
+
+
+// The OSP telegrams travel in CAN-FD frames to a bridge, which forwards
+// them to the first OSP node, and which sends the responses back in CAN-FD
+// frames. The frame formats are described in aospi_frame.c.
+//
+// There are two such links, each with its own bridge and its own OSP chain:
+// chain 0 on CAN3 and chain 1 on CAN2 (see aospi_chain_set). The two
+// controllers run independently, so frames go out on both buses at the
+// same time.
+
+
+// A frame that is not sent within this time is not acknowledged by the
+// bridge (eg it is not on the bus); a 64 byte CAN-FD frame takes well below 1ms.
+#define AOSPI_OUT_TIMEOUT_US     (10000UL)
+
+
+// Number of OSP chains: one on CAN3, one on CAN2
+#define AOSPI_FLEXCAN_CHAINS     2
+
+
+// === FlexCAN controllers ==================================================
+
+
+/************************************** Param FLEXCAN3 and some param global ********************************************/
+
+#define EXAMPLE_CAN3           			CAN3
+// First MB of the RX ring; the ring uses MBs 0..6
+#define RX_CAN3_MESSAGE_BUFFER_NUM 		(0)
+#define AOSPI_RXRING_DEPTH 				(7)
+// First MB of the TX ring; the ring uses MBs 8..13 (with 64 byte MBs the RAM holds 14 MBs)
+#define TX_CAN3_MESSAGE_BUFFER_NUM 		(8)
+#define USE_CANFD             			(1)
+/* Select OSC24Mhz as master flexcan clock source */
+#define FLEXCAN3_CLOCK_SOURCE_SELECT (1U)
+/* Clock divider for master flexcan clock source */
+#define FLEXCAN3_CLOCK_SOURCE_DIVIDER (1U)
+/* Get frequency of flexcan clock */
+#define EXAMPLE_CAN_3_CLK_FREQ ((CLOCK_GetRootClockFreq(kCLOCK_Root_Can3) / 100000U) * 100000U)
+/* Set USE_IMPROVED_TIMING_CONFIG macro to use api to calculates the improved CAN / CAN FD timing values. */
+#define USE_IMPROVED_TIMING_CONFIG_FOR_CAN3 	(1U)
+#define DLC_FOR_CAN3         					(12)
+// MBs are sized for a full CAN-FD frame, needed for batched frames (see aospi_tx_batch)
+#define BYTES_IN_MB_FOR_CAN3 					kFLEXCAN_64BperMB
+
+flexcan_handle_t flexcan3Handle;
+volatile bool wakenUpcan3    = false;
+uint32_t txcan3Identifier;
+uint32_t rxcan3Identifier;
+
+
+/************************************************************************************************/
+
+
+
+/************************************** Param FLEXCAN2 ********************************************/
+
+
+#define EXAMPLE_CAN2           			CAN2
+
+/* Select OSC24Mhz as master flexcan clock source */
+#define FLEXCAN2_CLOCK_SOURCE_SELECT (1U)
+// CAN2 carries the second chain; its MBs are laid out like those of CAN3 (RX ring 0..6, TX ring 8..13)
+#define RX_CAN2_MESSAGE_BUFFER_NUM 		(0)
+#define TX_CAN2_MESSAGE_BUFFER_NUM 		(8)
+/* Clock divider for master flexcan clock source */
+#define FLEXCAN2_CLOCK_SOURCE_DIVIDER (1U)
+/* Get frequency of flexcan clock */
+#define EXAMPLE_CAN_2_CLK_FREQ ((CLOCK_GetRootClockFreq(kCLOCK_Root_Can2) / 100000U) * 100000U)
+/* Set USE_IMPROVED_TIMING_CONFIG macro to use api to calculates the improved CAN / CAN FD timing values. */
+#define USE_IMPROVED_TIMING_CONFIG_FOR_CAN2 	(1U)
+#define DLC_FOR_CAN2         					(12)
+#define BYTES_IN_MB_FOR_CAN2 					kFLEXCAN_64BperMB
+
+flexcan_handle_t flexcan2Handle;
+volatile bool wakenUpcan2    = false;
+uint32_t txcan2Identifier;
+uint32_t rxcan2Identifier;
+
+
+/************************************************************************************************/
+
+
+// === Links ================================================================
+// Each link (a FlexCAN controller with its bridge and OSP chain) has its own
+// queue of requests, TX ring, RX ring and tag table (see "Asynchronous
+// requests" below). The FlexCAN interrupt of a controller only touches the
+// state of its own link.
+
+
+// TX ring and RX ring use the same MB numbers on both controllers
+#define AOSPI_TXRING_MB0         TX_CAN3_MESSAGE_BUFFER_NUM
+#define AOSPI_RXRING_MB0         RX_CAN3_MESSAGE_BUFFER_NUM
+
+
+typedef struct aospi_link_s {
+	// The controller
+	CAN_Type         * base;
+	flexcan_handle_t * handle;
+	uint32_t           txid;    // CAN ID of frames to the bridge
+	uint8_t            dlcmin;  // smallest DLC sent, what the bridge always got
+	// Queue of submitted requests that are not yet loaded in a TX MB
+	aospi_req_t * volatile req_head;
+	aospi_req_t * volatile req_tail;
+	// The TX ring: requests loaded in the MBs, and whether their MB has sent the frame
+	aospi_req_t      * txring_req[AOSPI_TXRING_MAXDEPTH];
+	volatile uint8_t   txring_sent[AOSPI_TXRING_MAXDEPTH];
+	flexcan_fd_frame_t txring_frame[AOSPI_TXRING_MAXDEPTH];
+	volatile int       txring_head;    // next slot to load
+	volatile int       txring_tail;    // oldest pending slot
+	volatile int       txring_pending; // number of loaded, not yet completed slots
+	volatile uint32_t  txring_prio;    // PRIO of the frames loaded in the current lap of the ring
+	// The RX ring: frames the RX MBs receive in
+	flexcan_fd_frame_t rxring_frame[AOSPI_RXRING_DEPTH];
+	// Requests awaiting a response, indexed by tag; tags are handed out round robin
+	aospi_req_t      * rxtag_req[AOSPI_FRAME_TAGCOUNT];
+	volatile int       rxtag_next;        // tag for the next request with response
+	volatile int       rxtag_oldest;      // tag of the oldest outstanding request
+	volatile int       rxtag_outstanding; // number of requests awaiting a response
+	// Time-outs: a response must arrive within aospi_timeout_get() after its frame
+	// is sent or after the previous response (responses come in order).
+	volatile uint32_t  rxtag_lastrx;      // DWT cycle count of the last response
+} aospi_link_t;
+
+
+// The links, indexed by chain (see aospi_chain_set): chain 0 on CAN3, chain 1 on CAN2
+static aospi_link_t aospi_link[AOSPI_FLEXCAN_CHAINS];
+
+// TX ring depth and tagging apply to both links
+static int aospi_txring_depth = AOSPI_TXRING_MAXDEPTH;
+static int aospi_rxtag_enabled = 1;
+
+
+// The FlexCAN interrupts drive the queues of asynchronous requests (see aospi_submit)
+static void aospi_req_txdone(aospi_link_t * link, uint32_t mb);
+static void aospi_req_rxdone(aospi_link_t * link, uint32_t mb);
+static void aospi_rxring_arm(aospi_link_t * link, int slot);
+
+
+// Both controllers share this callback; `userData` is the link of the controller.
+// MB ranges are checked with unsigned arithmetic (result is unsigned, below the base wraps to large).
+static FLEXCAN_CALLBACK(flexcan_callback)
+{
+    aospi_link_t * link = (aospi_link_t *)userData;
+    switch (status)
+    {
+        case kStatus_FLEXCAN_RxOverflow: // an older frame was overwritten, but this one is valid
+        case kStatus_FLEXCAN_RxIdle:
+            if ((result - AOSPI_RXRING_MB0) < AOSPI_RXRING_DEPTH)
+            {
+            	aospi_req_rxdone(link, (uint32_t)result);
+            }
+            break;
+
+        case kStatus_FLEXCAN_TxIdle:
+            if ((result - AOSPI_TXRING_MB0) < AOSPI_TXRING_MAXDEPTH)
+            {
+            	aospi_req_txdone(link, (uint32_t)result);
+            }
+            break;
+
+        case kStatus_FLEXCAN_WakeUp:
+            if (EXAMPLE_CAN3 == base) wakenUpcan3 = true;
+            if (EXAMPLE_CAN2 == base) wakenUpcan2 = true;
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+// Sets up the rings of `link`, whose controller is initialized: handle, RX ring (all MBs armed) and TX ring.
+static void aospi_link_init(aospi_link_t * link, CAN_Type * base, flexcan_handle_t * handle, uint32_t txid, uint32_t rxid, uint8_t dlcmin)
+{
+	flexcan_rx_mb_config_t mbConfig;
+
+	memset(link, 0, sizeof(aospi_link_t));
+	link->base   = base;
+	link->handle = handle;
+	link->txid   = txid;
+	link->dlcmin = dlcmin;
+
+	/* Create FlexCAN handle structure and set call back function. */
+	FLEXCAN_TransferCreateHandle(base, handle, flexcan_callback, link);
+
+	/* Set Rx Masking mechanism. */
+	FLEXCAN_SetRxMbGlobalMask(base, FLEXCAN_RX_MB_STD_MASK(rxid, 0, 0));
+
+	/* Setup Rx Message Buffers (the RX ring). */
+	mbConfig.format = kFLEXCAN_FrameFormatStandard;
+	mbConfig.type   = kFLEXCAN_FrameTypeData;
+	mbConfig.id     = FLEXCAN_ID_STD(rxid);
+	for (int mb = 0; mb < AOSPI_RXRING_DEPTH; mb++)
+	{
+		FLEXCAN_SetFDRxMbConfig(base, AOSPI_RXRING_MB0 + mb, &mbConfig, true);
+		aospi_rxring_arm(link, mb);
+	}
+
+	/* Setup Tx Message Buffers (the TX ring). */
+	for (int mb = 0; mb < AOSPI_TXRING_MAXDEPTH; mb++)
+	{
+		FLEXCAN_SetFDTxMbConfig(base, AOSPI_TXRING_MB0 + mb, true);
+	}
+
+	/* Local priority: the PRIO field of a TX MB orders frames before the MB number does (see aospi_req_pump). */
+	FLEXCAN_EnterFreezeMode(base);
+	base->MCR |= CAN_MCR_LPRIOEN_MASK;
+	FLEXCAN_ExitFreezeMode(base);
+}
+
+
+// Initializes CAN3, the link to the CAN-to-OSP bridge of chain 0.
+static void aospi_flexcan_can3_init()
+{
+	flexcan_config_t flexcanConfig;
+
+	clock_root_config_t rootCfg = {0};
+	rootCfg.mux                 = FLEXCAN3_CLOCK_SOURCE_SELECT;
+	rootCfg.div                 = FLEXCAN3_CLOCK_SOURCE_DIVIDER;
+	CLOCK_SetRootClock(kCLOCK_Root_Can3, &rootCfg);
+
+	txcan3Identifier = 0x123;
+	rxcan3Identifier = 0x321;
+
+	FLEXCAN_GetDefaultConfig(&flexcanConfig);
+
+	flexcanConfig.bitRate = 500000U;
+
+	flexcan_timing_config_t timing_config;
+	memset(&timing_config, 0, sizeof(flexcan_timing_config_t));
+
+#if (defined(USE_CANFD) && USE_CANFD)
+    if (FLEXCAN_FDCalculateImprovedTimingValues(EXAMPLE_CAN3, flexcanConfig.bitRate, flexcanConfig.bitRateFD,
+    		EXAMPLE_CAN_3_CLK_FREQ, &timing_config))
+    {
+        /* Update the improved timing configuration*/
+        memcpy(&(flexcanConfig.timingConfig), &timing_config, sizeof(flexcan_timing_config_t));
+    }
+    else
+    {
+    	PRINTF("No found Improved Timing Configuration. Just used default configuration\r\n\r\n");
+    }
+#else
+    if (FLEXCAN_CalculateImprovedTimingValues(EXAMPLE_CAN3, flexcanConfig.bitRate, EXAMPLE_CAN_3_CLK_FREQ, &timing_config))
+    {
+        /* Update the improved timing configuration*/
+        memcpy(&(flexcanConfig.timingConfig), &timing_config, sizeof(flexcan_timing_config_t));
+    }
+    else
+    {
+        LOG_INFO("No found Improved Timing Configuration. Just used default configuration\r\n\r\n");
+    }
+#endif
+
+
+
+#if (defined(USE_CANFD) && USE_CANFD)
+    FLEXCAN_FDInit(EXAMPLE_CAN3, &flexcanConfig, EXAMPLE_CAN_3_CLK_FREQ, BYTES_IN_MB_FOR_CAN3, true);
+#else
+    FLEXCAN_Init(EXAMPLE_CAN, &flexcanConfig, EXAMPLE_CAN_CLK_FREQ);
+#endif
+
+	aospi_link_init(&aospi_link[0], EXAMPLE_CAN3, &flexcan3Handle, txcan3Identifier, rxcan3Identifier, DLC_FOR_CAN3);
+}
+
+
+
+// Initializes CAN2, the link to the CAN-to-OSP bridge of chain 1.
+static void aospi_flexcan_can2_init()
+{
+	flexcan_config_t flexcanConfig;
+
+	clock_root_config_t rootCfg = {0};
+
+
+	rootCfg.mux                 = FLEXCAN2_CLOCK_SOURCE_SELECT;
+	rootCfg.div                 = FLEXCAN2_CLOCK_SOURCE_DIVIDER;
+	CLOCK_SetRootClock(kCLOCK_Root_Can2, &rootCfg);
+
+	// The bridge of chain 1 uses its own IDs, so that both bridges may also share one bus
+	txcan2Identifier = 0x246;
+	rxcan2Identifier = 0x642;
+
+	FLEXCAN_GetDefaultConfig(&flexcanConfig);
+
+	flexcanConfig.bitRate = 500000U;
+
+	flexcan_timing_config_t timing_config;
+	memset(&timing_config, 0, sizeof(flexcan_timing_config_t));
+
+#if (defined(USE_CANFD) && USE_CANFD)
+	if (FLEXCAN_FDCalculateImprovedTimingValues(EXAMPLE_CAN2, flexcanConfig.bitRate, flexcanConfig.bitRateFD,
+			EXAMPLE_CAN_2_CLK_FREQ, &timing_config))
+	{
+		/* Update the improved timing configuration*/
+		memcpy(&(flexcanConfig.timingConfig), &timing_config, sizeof(flexcan_timing_config_t));
+	}
+	else
+	{
+		PRINTF("No found Improved Timing Configuration. Just used default configuration\r\n\r\n");
+	}
+#else
+	if (FLEXCAN_CalculateImprovedTimingValues(EXAMPLE_CAN2, flexcanConfig.bitRate, EXAMPLE_CAN_2_CLK_FREQ, &timing_config))
+	{
+		/* Update the improved timing configuration*/
+		memcpy(&(flexcanConfig.timingConfig), &timing_config, sizeof(flexcan_timing_config_t));
+	}
+	else
+	{
+		LOG_INFO("No found Improved Timing Configuration. Just used default configuration\r\n\r\n");
+	}
+#endif
+
+
+
+#if (defined(USE_CANFD) && USE_CANFD)
+	FLEXCAN_FDInit(EXAMPLE_CAN2, &flexcanConfig, EXAMPLE_CAN_2_CLK_FREQ, BYTES_IN_MB_FOR_CAN2, true);
+#else
+	FLEXCAN_Init(EXAMPLE_CAN2, &flexcanConfig, EXAMPLE_CAN_2_CLK_FREQ);
+#endif
+
+	aospi_link_init(&aospi_link[1], EXAMPLE_CAN2, &flexcan2Handle, txcan2Identifier, rxcan2Identifier, DLC_FOR_CAN2);
+}
+
+
+// === Asynchronous requests ================================================
+// Requests are queued by aospi_submit() (via aospi_backend_flexcan.tx/txrx)
+// on the link of their chain (req->chain). The FlexCAN interrupt completes
+// requests and loads the next ones, so the CPU is free while frames are on
+// the bus.
+//
+// Outgoing frames are spread over a ring of TX MBs (AOSPI_TXRING_MB0 and up,
+// aospi_txring_depth of them), so that the next frame is already waiting
+// in an MB when the current one finishes: frames go out back-to-back.
+// FlexCAN sends frames with equal ID from the lowest MB first, so loading a
+// freed low MB while higher ones are pending would reorder the frames.
+// Local priority (MCR[LPRIOEN]) puts the 3 bit PRIO field of the MB in front
+// of the ID for arbitration: each lap of the ring gets the next PRIO, so the
+// frames of a lap go after those of the previous lap, whatever their MBs.
+// The ring is thus circular: a freed MB is refilled right away. PRIO starts
+// at 0 when the ring is drained; when a lap would need a PRIO above
+// AOSPI_TXRING_PRIOMAX the ring waits until it has drained (once per 8 laps
+// under continuous load). Completion is tracked in ring order.
+//
+// Responses are received in a ring of RX MBs (AOSPI_RXRING_MB0 and up,
+// AOSPI_RXRING_DEPTH of them), all permanently armed; this acts as a
+// receive FIFO. A request that expects a response is sent in a tagged frame
+// (see aospi_frame.c); the bridge echoes the tag in the response frame. The
+// tag identifies the outstanding request, so several requests with response
+// can be in flight (pipelined), and a late response can not be attributed
+// to the wrong request. A response without tag is attributed to the oldest
+// outstanding request. With tagging disabled (aospi_rxtag_enable) requests
+// are sent untagged, and only one request with response is in flight.
+
+
+// FlexCAN payload words are big endian: the first byte is in the most
+// significant bits. The CM7 is little endian, so bytes are moved a word at
+// a time with a byte reverse (REV). memcpy() of 4 bytes compiles to a single
+// (unaligned) load or store, so the byte buffers need no alignment.
+
+// Stores the `size` bytes of `src` in `words` (zero padded up to `wordcount` words).
+static inline void aospi_words_pack(uint32_t * words, int wordcount, const uint8_t * src, int size)
+{
+	int i = 0;
+	for( ; 4*i+4 <= size; i++ )
+	{
+		uint32_t w;
+		memcpy(&w, src + 4*i, 4);
+		words[i] = __REV(w);
+	}
+	if( 4*i < size )
+	{
+		uint32_t w = 0;
+		for( int j = 4*i; j < size; j++ ) w |= (uint32_t)src[j] << (24 - 8*(j - 4*i));
+		words[i++] = w;
+	}
+	for( ; i < wordcount; i++ ) words[i] = 0;
+}
+
+
+// Copies bytes `pos`..`pos+size-1` of the payload in `words` to `dst`.
+static inline void aospi_words_unpack(uint8_t * dst, const uint32_t * words, int pos, int size)
+{
+	while( size>0 && pos%4!=0 )
+	{
+		*dst++ = (uint8_t)(words[pos/4] >> (24 - 8*(pos%4)));
+		pos++; size--;
+	}
+	while( size>=4 )
+	{
+		uint32_t w = __REV(words[pos/4]);
+		memcpy(dst, &w, 4);
+		dst += 4; pos += 4; size -= 4;
+	}
+	while( size>0 )
+	{
+		*dst++ = (uint8_t)(words[pos/4] >> (24 - 8*(pos%4)));
+		pos++; size--;
+	}
+}
+
+
+// Returns 1 iff the TX rings of all links are drained.
+static int aospi_txring_drained(void)
+{
+	for( int chain = 0; chain < AOSPI_FLEXCAN_CHAINS; chain++ )
+		if( aospi_link[chain].txring_pending>0 ) return 0;
+	return 1;
+}
+
+
+// Highest value of the PRIO field of an MB (3 bits)
+#define AOSPI_TXRING_PRIOMAX     7U
+
+
+// MB codes and transfer state of the FlexCAN driver (private to fsl_flexcan.c)
+#define AOSPI_MB_CODE_TXINACTIVE 0x8U // kFLEXCAN_TxMbInactive
+#define AOSPI_MB_CODE_TXDATA     0xCU // kFLEXCAN_TxMbDataOrRemote
+#define AOSPI_MB_STATE_TXDATA    0x3U // kFLEXCAN_StateTxData
+
+
+// Loads the first `wordcount` words of `frame` in TX MB `mbIdx` of `link` with local priority `prio`, and activates it.
+// This is FLEXCAN_TransferFDSendNonBlocking(), except for the PRIO field: the ID of the SDK's frame has 29 bits.
+static void aospi_txmb_send(aospi_link_t * link, uint8_t mbIdx, const flexcan_fd_frame_t * frame, int wordcount, uint32_t prio)
+{
+	// 64 byte MBs: 18 words each (CS, ID, 16 data words), 7 per 512 byte RAM block
+	volatile uint32_t * mb = &link->base->MB[0].CS + (mbIdx / 7U) * 128U + (mbIdx % 7U) * 18U;
+	link->handle->mbState[mbIdx] = (uint8_t)AOSPI_MB_STATE_TXDATA;
+	mb[0] = CAN_CS_CODE(AOSPI_MB_CODE_TXINACTIVE);
+	mb[1] = CAN_ID_PRIO(prio) | frame->id;
+	for( int i = 0; i < wordcount; i++ ) mb[2 + i] = frame->dataWord[i];
+	mb[0] = CAN_CS_CODE(AOSPI_MB_CODE_TXDATA) | CAN_CS_DLC(frame->length) | CAN_CS_EDL(frame->edl) | CAN_CS_BRS(frame->brs);
+	FLEXCAN_EnableMbInterrupts(link->base, (uint64_t)1U << mbIdx);
+}
+
+
+// Loads the frame of `req` in TX ring slot `slot` of `link`, with the PRIO of the current lap.
+static void aospi_req_start(aospi_link_t * link, aospi_req_t * req, int slot)
+{
+	flexcan_fd_frame_t * frame = &link->txring_frame[slot];
+	int tagged = req->rx && aospi_rxtag_enabled;
+	int size = tagged ? 2 + req->txsize : req->txsize; // tagged: tag and length byte precede the telegram
+	// Frames are at least link->dlcmin (24 bytes), what the bridge always got
+	uint8_t dlc = aospi_frame_size2dlc(size);
+	if( dlc < link->dlcmin ) dlc = link->dlcmin;
+	int wordcount = (aospi_frame_dlc2size(dlc) + 3) / 4;
+
+	frame->id     = FLEXCAN_ID_STD(link->txid);
+	frame->format = (uint8_t)kFLEXCAN_FrameFormatStandard;
+	frame->type   = (uint8_t)kFLEXCAN_FrameTypeData;
+	frame->length = dlc;
+	frame->brs = 1U;
+	frame->edl = 1U;
+	// Telegram bytes go straight from the request into the frame (see aospi_frame.c for the tagged format)
+	if( tagged )
+	{
+		uint32_t w = (uint32_t)(AOSPI_FRAME_TAGBASE + req->tag) << 24 | (uint32_t)req->txsize << 16;
+		if( req->txsize>0 ) w |= (uint32_t)req->tx[0] << 8;
+		if( req->txsize>1 ) w |= (uint32_t)req->tx[1];
+		frame->dataWord[0] = w;
+		aospi_words_pack(&frame->dataWord[1], wordcount-1, req->tx+2, req->txsize-2);
+	}
+	else
+	{
+		aospi_words_pack(frame->dataWord, wordcount, req->tx, req->txsize);
+	}
+
+	// While sending the OENA line is held high to enable the output of the
+	// level shifter. This is especially important after a RESET telegram
+	// because the first OSP node inspects the line status to redetermine its
+	// comms mode (MCU, LVDS, CAN, EOL).
+	aospi_backend_outoena(1); // enable level shifter output
+	req->t0 = DWT->CYCCNT;
+	link->txring_req[slot]  = req;
+	link->txring_sent[slot] = 0;
+	aospi_txmb_send(link, (uint8_t)(AOSPI_TXRING_MB0 + slot), frame, wordcount, link->txring_prio);
+}
+
+
+// Loads as many queued requests of `link` as its TX ring allows (called with interrupts disabled or from the ISR).
+static void aospi_req_pump(aospi_link_t * link)
+{
+	while( link->req_head!=0 )
+	{
+		aospi_req_t * req = link->req_head;
+		if( req->rx!=0 )
+		{
+			// Without tags, a request with response runs alone
+			if( !aospi_rxtag_enabled && (link->txring_pending>0 || link->rxtag_outstanding>0) ) break;
+			// Need a free tag
+			if( link->rxtag_req[link->rxtag_next]!=0 ) break;
+		}
+		// Without tags, nothing goes out while a response is awaited
+		if( !aospi_rxtag_enabled && link->rxtag_outstanding>0 ) break;
+		// A drained ring starts over at the first MB with PRIO 0; a full ring, or a wrap
+		// without a PRIO left for the next lap, waits
+		if( link->txring_pending==0 )
+		{
+			link->txring_head = 0;
+			link->txring_tail = 0;
+			link->txring_prio = 0;
+		}
+		else if( link->txring_pending==aospi_txring_depth )
+		{
+			break;
+		}
+		else if( link->txring_head==0 && link->txring_prio==AOSPI_TXRING_PRIOMAX )
+		{
+			break;
+		}
+		link->req_head = req->next;
+		if( link->req_head==0 ) link->req_tail = 0;
+		if( req->rx!=0 )
+		{
+			req->tag = (uint8_t)link->rxtag_next;
+			link->rxtag_req[req->tag] = req;
+			if( link->rxtag_outstanding==0 ) link->rxtag_oldest = req->tag;
+			link->rxtag_outstanding++;
+			link->rxtag_next = (link->rxtag_next + 1) % AOSPI_FRAME_TAGCOUNT;
+		}
+		// A wrap (back at the first MB with frames pending) starts the next lap
+		if( link->txring_head==0 && link->txring_pending>0 ) link->txring_prio++;
+		link->txring_pending++;
+		aospi_req_start(link, req, link->txring_head);
+		link->txring_head = (link->txring_head + 1) % aospi_txring_depth;
+	}
+}
+
+
+// Completes the request of `link` with tag `tag`, that awaited a response (ISR context).
+static void aospi_req_rxfinish(aospi_link_t * link, int tag, aoresult_t result)
+{
+	aospi_req_t * req = link->rxtag_req[tag];
+	link->rxtag_req[tag] = 0;
+	link->rxtag_outstanding--;
+	// Advance oldest over the tags that are no longer outstanding
+	while( link->rxtag_outstanding>0 && link->rxtag_req[link->rxtag_oldest]==0 )
+		link->rxtag_oldest = (link->rxtag_oldest + 1) % AOSPI_FRAME_TAGCOUNT;
+	aospi_req_complete(req, result);
+}
+
+
+// Called from the FlexCAN interrupt when TX MB `mb` of the controller of `link` has sent its frame.
+static void aospi_req_txdone(aospi_link_t * link, uint32_t mb)
+{
+	int slot = (int)mb - AOSPI_TXRING_MB0;
+	link->txring_sent[slot] = 1;
+	// Retire the sent slots in ring order
+	while( link->txring_pending>0 && link->txring_sent[link->txring_tail] )
+	{
+		aospi_req_t * req = link->txring_req[link->txring_tail];
+		link->txring_sent[link->txring_tail] = 0;
+		link->txring_tail = (link->txring_tail + 1) % aospi_txring_depth;
+		link->txring_pending--;
+		aospi_req_sent(req);
+		if( req->rx==0 )
+		{
+			req->us = AOSPI_CYCLES2US(DWT->CYCCNT - req->t0);
+			aospi_req_complete(req, aoresult_ok);
+		}
+		else if( req->rxgot ) aospi_req_rxfinish(link, req->tag, aoresult_ok); // response overtook the tx-done interrupt
+		else req->txdone = 1;
+		// Otherwise the request completes when the response arrives
+	}
+	// For the RESET telegram it is important to clear OENA immediately
+	if( aospi_txring_drained() ) aospi_backend_outoena(0); // disable level shifter output
+	aospi_req_pump(link);
+}
+
+
+// (Re)arms RX ring slot `slot` of `link`.
+static void aospi_rxring_arm(aospi_link_t * link, int slot)
+{
+	flexcan_mb_transfer_t xfer;
+	xfer.mbIdx   = (uint8_t)(AOSPI_RXRING_MB0 + slot);
+	xfer.framefd = &link->rxring_frame[slot];
+	(void)FLEXCAN_TransferFDReceiveNonBlocking(link->base, link->handle, &xfer);
+}
+
+
+// Called from the FlexCAN interrupt when RX MB `mb` of the controller of `link` has received a frame.
+static void aospi_req_rxdone(aospi_link_t * link, uint32_t mb)
+{
+	int slot = (int)mb - AOSPI_RXRING_MB0;
+	const uint32_t * words = link->rxring_frame[slot].dataWord;
+	int framesize = aospi_frame_dlc2size(link->rxring_frame[slot].length);
+
+	// Find the telegram and the request it belongs to; the header is in the first word
+	uint8_t head0 = (uint8_t)(words[0] >> 24);
+	int     telepos = 0;
+	int     telesize = framesize;
+	int     tag;
+	if( head0>=AOSPI_FRAME_TAGBASE )
+	{
+		tag = head0 - AOSPI_FRAME_TAGBASE;
+		telepos = 2;
+		telesize = (uint8_t)(words[0] >> 16);
+		if( telesize<1 || telesize>AOSPI_FRAME_ENTRY_MAXSIZE || 2+telesize>framesize ) // malformed
+		{
+			aospi_rxring_arm(link, slot);
+			return;
+		}
+	}
+	else
+	{
+		tag = link->rxtag_oldest; // untagged: oldest outstanding request
+	}
+	aospi_req_t * req = link->rxtag_req[tag];
+	if( link->rxtag_outstanding==0 || req==0 || req->rxgot ) // not expected (eg response after timeout)
+	{
+		aospi_rxring_arm(link, slot);
+		return;
+	}
+
+	// The response goes straight from the MB's frame into the caller's buffer
+	aospi_words_unpack(req->rx, words, telepos, telesize < req->rxsize ? telesize : req->rxsize);
+	// Frame copied, so the MB can receive again
+	aospi_rxring_arm(link, slot);
+	link->rxtag_lastrx = DWT->CYCCNT;
+	req->us = AOSPI_CYCLES2US(link->rxtag_lastrx - req->t0);
+	aospi_req_received(req, telesize);
+	req->rxgot = 1;
+	// The response may overtake the tx-done interrupt; then that one completes the request
+	if( req->txdone ) aospi_req_rxfinish(link, tag, aoresult_ok);
+	aospi_req_pump(link);
+}
+
+
+// Puts a request in the queue of the link of its chain, loading it when the TX ring has room (aospi_backend_flexcan.tx and .txrx).
+static aoresult_t aospi_flexcan_submit(aospi_req_t * req)
+{
+	if( req->chain<0 || req->chain>=AOSPI_FLEXCAN_CHAINS ) return aoresult_spi_buf;
+	aospi_link_t * link = &aospi_link[req->chain];
+	req->txdone = 0;
+	req->rxgot  = 0;
+	req->next   = 0;
+	uint32_t primask = DisableGlobalIRQ();
+	if( link->req_tail ) link->req_tail->next = req; else link->req_head = req;
+	link->req_tail = req;
+	aospi_req_pump(link);
+	EnableGlobalIRQ(primask);
+	return aoresult_ok;
+}
+
+
+// Aborts all frames in the TX ring of `link`, completing their requests with `result` (interrupts disabled).
+static void aospi_txring_abort(aospi_link_t * link, aoresult_t result)
+{
+	while( link->txring_pending>0 )
+	{
+		aospi_req_t * req = link->txring_req[link->txring_tail];
+		FLEXCAN_TransferFDAbortSend(link->base, link->handle, (uint8_t)(AOSPI_TXRING_MB0 + link->txring_tail));
+		link->txring_sent[link->txring_tail] = 0;
+		link->txring_tail = (link->txring_tail + 1) % aospi_txring_depth;
+		link->txring_pending--;
+		if( req->rx==0 ) aospi_req_complete(req, result);
+		else aospi_req_rxfinish(link, req->tag, result);
+	}
+	if( aospi_txring_drained() ) aospi_backend_outoena(0); // disable level shifter output
+}
+
+
+// Expires overdue requests of `link` (interrupts disabled), see aospi_flexcan_poll().
+static void aospi_link_poll(aospi_link_t * link, uint32_t now) {
+  // Oldest frame in the TX ring stuck?
+  if( link->txring_pending>0 ) {
+    aospi_req_t * req= link->txring_req[link->txring_tail];
+    if( now - req->t0 > AOSPI_US2CYCLES(AOSPI_OUT_TIMEOUT_US) ) aospi_txring_abort(link, aoresult_spi_noclock);
+  }
+  // Response of the oldest outstanding request overdue?
+  if( link->rxtag_outstanding>0 ) {
+    aospi_req_t * req= link->rxtag_req[link->rxtag_oldest];
+    if( req->txdone ) {
+      // Clock starts at the later of loading the frame and the last response
+      uint32_t since= req->t0;
+      if( (int32_t)(link->rxtag_lastrx - since) > 0 ) since= link->rxtag_lastrx;
+      if( now - since > AOSPI_US2CYCLES(aospi_timeout_get()) ) {
+        link->rxtag_lastrx= now; // next one gets a full time-out
+        aospi_req_rxfinish(link, req->tag, aoresult_spi_noclock);
+      }
+    }
+  }
+  aospi_req_pump(link);
+}
+
+
+// Expires overdue requests with aoresult_spi_noclock (aospi_backend_flexcan.poll).
+// A frame that is not sent within AOSPI_OUT_TIMEOUT_US (eg because no bridge
+// acknowledges it) is aborted, as are the frames behind it in the TX ring.
+// A response is overdue when it does not arrive within the time-out after
+// the frame is sent, or after the previous response (the bridge handles
+// requests one by one). A response that arrives after its request has
+// expired is dropped. Both links are checked independently.
+static void aospi_flexcan_poll() {
+  uint32_t primask= DisableGlobalIRQ();
+  uint32_t now= DWT->CYCCNT;
+  for( int chain=0; chain<AOSPI_FLEXCAN_CHAINS; chain++ ) aospi_link_poll(&aospi_link[chain], now);
+  EnableGlobalIRQ(primask);
+}
+
+
+// Returns 1 iff no requests are queued or in flight on any link (aospi_backend_flexcan.idle).
+static int aospi_flexcan_idle() {
+  for( int chain=0; chain<AOSPI_FLEXCAN_CHAINS; chain++ ) {
+    aospi_link_t * link= &aospi_link[chain];
+    if( link->req_head!=0 || link->txring_pending!=0 || link->rxtag_outstanding!=0 ) return 0;
+  }
+  return 1;
+}
+
+
+/*!
+    @brief  Enables or disables sequence tags on requests with a response.
+    @param  enable
+            1 to send requests with response in tagged frames (default),
+            0 to send them as plain telegrams.
+    @note   With tags, several requests with response can be in flight, and
+            the bridge's responses are matched on tag. Without tags (for a
+            bridge that does not support them) a request with response is
+            the only frame in flight until its response arrives.
+    @note   First waits until all submitted requests are completed.
+    @note   Applies to the links of both chains.
+*/
+void aospi_rxtag_enable(int enable) {
+  while( !aospi_idle() ) {
+    aospi_poll();
+  };
+  aospi_rxtag_enabled= enable!=0;
+}
+
+
+/*!
+    @brief  Reports whether sequence tags are enabled.
+    @return 1 iff requests with response are sent in tagged frames.
+*/
+int aospi_rxtag_isenabled() {
+  return aospi_rxtag_enabled;
+}
+
+
+/*!
+    @brief  Sets the depth of the TX ring: the number of MBs used for
+            outgoing frames.
+    @param  depth
+            The number of MBs (1..AOSPI_TXRING_MAXDEPTH).
+    @return aoresult_spi_buf if depth is out of bounds
+            aoresult_ok      otherwise
+    @note   First waits until all submitted requests are completed.
+    @note   A depth of 1 sends one frame at a time (with a gap on the bus
+            while the MB is reloaded); a larger depth lets frames go out
+            back-to-back, as long as the interrupt reloads a freed MB before
+            the other MBs have been sent. Default is AOSPI_TXRING_MAXDEPTH.
+    @note   Applies to the links of both chains (CAN3 and CAN2).
+*/
+aoresult_t aospi_txring_setdepth(int depth) {
+  if( depth<1 || depth>AOSPI_TXRING_MAXDEPTH ) return aoresult_spi_buf;
+  while( !aospi_idle() ) {
+    aospi_poll();
+  };
+  aospi_txring_depth= depth;
+  for( int chain=0; chain<AOSPI_FLEXCAN_CHAINS; chain++ ) {
+    aospi_link[chain].txring_head= 0;
+    aospi_link[chain].txring_tail= 0;
+    aospi_link[chain].txring_prio= 0;
+  }
+  return aoresult_ok;
+}
+
+
+/*!
+    @brief  Returns the depth of the TX ring.
+    @return The number of MBs used for outgoing frames.
+*/
+int aospi_txring_getdepth() {
+  return aospi_txring_depth;
+}
+
+
+// Adds the cycles elapsed since *last to *cycles (the DWT cycle counter wraps every few seconds)
+static void aospi_bench_tick(uint32_t * last, uint64_t * cycles) {
+  uint32_t now= DWT->CYCCNT;
+  *cycles += now - *last;
+  *last= now;
+}
+
+
+/*!
+    @brief  Benchmark for the TX path: sends `frames` frames of 64 bytes
+            as fast as possible, with CAN3 in loop back mode.
+    @param  frames
+            The number of frames to send.
+    @param  us
+            Output parameter set to the time it took to send all frames.
+    @return aoresult_spi_buf if frames<1 or us is NULL
+            aoresult_assert  if the FlexCAN backend is not selected
+            aoresult_ok      otherwise
+    @note   Uses the TX ring with its current depth (see aospi_txring_setdepth), 
+            so frames/s for different depths can be compared.
+    @note   During the benchmark the FlexCAN is in internal loop back mode: 
+            frames do not appear on the bus, so the bridge and the OSP chain
+            are not affected. The frames are empty batched frames.
+    @note   The telegram counters are not changed.
+    @note   Time is measured with the DWT cycle counter.
+    @note   Only uses CAN3 (the link of chain 0).
+*/
+aoresult_t aospi_bench(int frames, uint32_t * us) {
+  if( frames<1 || us==0 ) return aoresult_spi_buf;
+  if( aospi_backend_get()!=&aospi_backend_flexcan ) return aoresult_assert;
+  while( !aospi_idle() ) {
+    aospi_poll();
+  };
+
+  // Switch to loop back (transceiver delay compensation must be off in loop back)
+  FLEXCAN_EnterFreezeMode(EXAMPLE_CAN3);
+  uint32_t fdctrl= EXAMPLE_CAN3->FDCTRL;
+  EXAMPLE_CAN3->FDCTRL &= ~CAN_FDCTRL_TDCEN_MASK;
+  EXAMPLE_CAN3->CTRL1 |= CAN_CTRL1_LPB_MASK;
+  FLEXCAN_ExitFreezeMode(EXAMPLE_CAN3);
+
+  // Keep the ring full: cycle through more requests than MBs
+  static aospi_req_t reqs[AOSPI_TXRING_MAXDEPTH+1];
+  uint64_t cycles= 0;
+  uint32_t last= DWT->CYCCNT;
+  for( int i=0; i<frames; i++ ) {
+    aospi_req_t * req= &reqs[i%(AOSPI_TXRING_MAXDEPTH+1)];
+    while( req->busy ) { aospi_poll(); aospi_bench_tick(&last,&cycles); }
+    memset(req->tx,0,AOSPI_FRAME_MAXSIZE);
+    req->txsize= AOSPI_FRAME_MAXSIZE;
+    req->txcount= 0;
+    req->rx= 0;
+    req->chain= 0;
+    req->tid= AOSPI_STAT_TID_OTHER;
+    aospi_req_enqueue(req);
+  }
+  while( !aospi_idle() ) { aospi_poll(); aospi_bench_tick(&last,&cycles); }
+  aospi_bench_tick(&last,&cycles);
+  *us= (uint32_t)(cycles / (SystemCoreClock/1000000));
+
+  // Back to normal
+  FLEXCAN_EnterFreezeMode(EXAMPLE_CAN3);
+  EXAMPLE_CAN3->CTRL1 &= ~CAN_CTRL1_LPB_MASK;
+  EXAMPLE_CAN3->FDCTRL = fdctrl;
+  FLEXCAN_ExitFreezeMode(EXAMPLE_CAN3);
+  return aoresult_ok;
+}
+
+
+// === Backend ==============================================================
+
+
+// Sets up CAN3 (chain 0) and CAN2 (chain 1) (aospi_backend_flexcan.init).
+static void aospi_flexcan_init(aospi_phy_t phy) {
+  (void)phy; // the bridge does the bit timing of the OSP link
+  aospi_flexcan_can3_init();
+  aospi_flexcan_can2_init();
+}
+
+
+// The FlexCAN-FD backend, see aospi_backend_t.
+const aospi_backend_t aospi_backend_flexcan = {
+  .name = "flexcan",
+  .chains = AOSPI_FLEXCAN_CHAINS,
+  .init = aospi_flexcan_init,
+  .tx   = aospi_flexcan_submit,
+  .txrx = aospi_flexcan_submit,
+  .poll = aospi_flexcan_poll,
+  .idle = aospi_flexcan_idle,
+};
@@ -0,0 +1,195 @@
+// aospi_frame.c - packs several OSP telegrams into one CAN-FD frame (and unpacks them again)
+/*****************************************************************************
+ * Copyright 2024,2025 by ams OSRAM AG                                       *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#include "string.h"
+#include "aospi_frame.h"
+
+
+// The original CAN-to-OSP bridge protocol puts exactly one telegram in a
+// CAN-FD frame; the frame starts with the telegram itself. An OSP telegram
+// always starts with preamble 0xA (so the first byte is 0xA0..0xAF), and 
+// when it is Manchester encoded (phy type A) the first byte is 0x66.
+//
+// A batched frame packs several telegrams in one CAN-FD frame, each one
+// preceded by a length byte:
+//
+//   frame = entry entry ... entry [00 00 ... 00]
+//   entry = len byte1 byte2 ... byte<len>       with len in 1..24
+//
+// The first byte of a batched frame is a length (1..24), which never
+// collides with the first byte of a plain telegram (0xAx or 0x66). That is
+// how the receiver tells the two formats apart. A length byte of 00 (or the 
+// end of the frame) terminates the list; the unused tail of the frame (up 
+// to the next CAN-FD size) is padded with 00.
+//
+// A tagged frame is used for a telegram that expects a response. It starts
+// with a sequence tag, followed by the telegram as one entry:
+//
+//   frame = tag entry [00 00 ... 00]
+//   tag   = C0+seq                             with seq in 0..63
+//
+// The bridge copies the tag into the frame that carries the response (also 
+// as one entry). This way the MCU matches responses to outstanding requests,
+// even when several requests are in flight. The tag byte (C0..FF) again does
+// not collide with the other formats.
+//
+// Example: five SETPWM telegrams (10 bytes each) fit in one 64 byte frame
+// (5x11=55 bytes), where the single telegram format needs five frames.
+
+
+// Payload size for each of the 16 CAN-FD DLC codes
+static const uint8_t aospi_frame_dlcsize[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64 };
+
+
+/*!
+    @brief  Converts a CAN-FD DLC code to the number of payload bytes.
+    @param  dlc
+            The data length code of a CAN-FD frame (0..15).
+    @return The payload size in bytes (0..8, 12, 16, 20, 24, 32, 48, 64).
+    @note   Codes above 15 are clipped to 15 (64 bytes).
+*/
+int aospi_frame_dlc2size(uint8_t dlc) {
+  if( dlc>15 ) dlc= 15;
+  return aospi_frame_dlcsize[dlc];
+}
+
+
+/*!
+    @brief  Converts a payload size to a CAN-FD DLC code.
+    @param  size
+            The number of payload bytes (0..64).
+    @return The smallest DLC code whose payload size is at least `size`.
+    @note   Sizes above 64 are clipped to DLC 15 (64 bytes).
+*/
+uint8_t aospi_frame_size2dlc(int size) {
+  uint8_t dlc= 0;
+  while( dlc<15 && aospi_frame_dlcsize[dlc]<size ) dlc++;
+  return dlc;
+}
+
+
+/*!
+    @brief  Appends one telegram, with its length prefix, to a batched frame.
+    @param  frame
+            The frame under construction, must have AOSPI_FRAME_MAXSIZE bytes.
+    @param  framesize
+            In/out parameter: the number of bytes already used in `frame`; 
+            set to 0 to start a new frame. Is incremented when `tele` is added.
+    @param  tele
+            The telegram (bytes as they must appear on the OSP wire, so 
+            possibly Manchester encoded).
+    @param  telesize
+            The number of bytes in `tele` (1..AOSPI_FRAME_ENTRY_MAXSIZE).
+    @return 1 if the telegram was appended; 0 if it does not fit (anymore) 
+            or when `telesize` is out of range. 
+    @note   When 0 is returned, the caller typically sends the frame, 
+            resets `*framesize` to 0 and retries.
+*/
+int aospi_frame_add(uint8_t * frame, int * framesize, const uint8_t * tele, int telesize) {
+  if( telesize<1 || telesize>AOSPI_FRAME_ENTRY_MAXSIZE ) return 0;
+  if( *framesize + 1 + telesize > AOSPI_FRAME_MAXSIZE ) return 0;
+  frame[*framesize]= (uint8_t)telesize;
+  memcpy( frame + *framesize + 1, tele, telesize );
+  *framesize += 1 + telesize;
+  return 1;
+}
+
+
+/*!
+    @brief  Determines the format of a received frame.
+    @param  frame
+            The payload of a CAN-FD frame.
+    @param  framesize
+            The number of bytes in `frame`.
+    @return 1 iff `frame` is a batched frame (length prefixed telegrams);
+            0 if it is a frame containing one plain telegram.
+*/
+int aospi_frame_isbatch(const uint8_t * frame, int framesize) {
+  if( framesize<1 ) return 0;
+  return frame[0]>=1 && frame[0]<=AOSPI_FRAME_ENTRY_MAXSIZE;
+}
+
+
+/*!
+    @brief  Starts a tagged frame.
+    @param  frame
+            The frame under construction, must have AOSPI_FRAME_MAXSIZE bytes.
+    @param  framesize
+            Output parameter: set to the number of bytes used in `frame` (1).
+    @param  tag
+            The sequence tag (0..AOSPI_FRAME_TAGCOUNT-1, higher bits are ignored).
+    @note   Next, append the telegram with aospi_frame_add().
+*/
+void aospi_frame_settag(uint8_t * frame, int * framesize, int tag) {
+  frame[0]= (uint8_t)(AOSPI_FRAME_TAGBASE + (tag % AOSPI_FRAME_TAGCOUNT));
+  *framesize= 1;
+}
+
+
+/*!
+    @brief  Gets the sequence tag of a tagged frame.
+    @param  frame
+            The payload of a CAN-FD frame.
+    @param  framesize
+            The number of bytes in `frame`.
+    @return The sequence tag (0..AOSPI_FRAME_TAGCOUNT-1), or -1 if `frame` 
+            is not tagged.
+    @note   The entry of a tagged frame starts at position 1, so extract it 
+            with aospi_frame_next() with `*pos` set to 1.
+*/
+int aospi_frame_gettag(const uint8_t * frame, int framesize) {
+  if( framesize<1 || frame[0]<AOSPI_FRAME_TAGBASE ) return -1;
+  return frame[0] - AOSPI_FRAME_TAGBASE;
+}
+
+
+/*!
+    @brief  Extracts the next telegram from a batched frame.
+    @param  frame
+            The payload of a batched CAN-FD frame.
+    @param  framesize
+            The number of bytes in `frame` (typically the size belonging 
+            to the DLC, so including padding).
+    @param  pos
+            In/out parameter: the read position in `frame`; set to 0 
+            before the first call.
+    @param  tele
+            Output parameter: set to point to the telegram inside `frame`
+            (no copy is made).
+    @param  telesize
+            Output parameter: set to the number of bytes of `*tele`.
+    @return 1 if a telegram was extracted; 0 at the end of the frame 
+            (terminator, padding or end of payload), or when the frame is
+            malformed (an entry exceeds the frame).
+    @note   This is the reference unpacker for the receiving side of the
+            CAN-to-OSP bridge; typical use:
+              int pos=0; const uint8_t * tele; int size;
+              while( aospi_frame_next(frame,framesize,&pos,&tele,&size) ) { ... }
+*/
+int aospi_frame_next(const uint8_t * frame, int framesize, int * pos, const uint8_t ** tele, int * telesize) {
+  if( *pos>=framesize ) return 0;
+  int len= frame[*pos];
+  if( len<1 || len>AOSPI_FRAME_ENTRY_MAXSIZE ) return 0; // terminator (or junk)
+  if( *pos + 1 + len > framesize ) return 0; // malformed
+  *tele= frame + *pos + 1;
+  *telesize= len;
+  *pos += 1 + len;
+  return 1;
+}
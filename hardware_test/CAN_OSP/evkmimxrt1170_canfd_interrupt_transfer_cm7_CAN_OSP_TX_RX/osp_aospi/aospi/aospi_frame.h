@@ -0,0 +1,59 @@
+// aospi_frame.h - packs several OSP telegrams into one CAN-FD frame (and unpacks them again)
+/*****************************************************************************
+ * Copyright 2024,2025 by ams OSRAM AG                                       *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#ifndef _AOSPI_FRAME_H_
+#define _AOSPI_FRAME_H_
+
+
+#include "stdint.h"
+
+
+// Note: this module has no dependencies on the MCU SDK, so that it also 
+// compiles on a host (eg the PC side of a CAN-to-OSP bridge or a test tool).
+
+
+// A CAN-FD frame carries at most 64 bytes (DLC 15)
+#define AOSPI_FRAME_MAXSIZE       64
+// Largest entry in a batched frame: a Manchester encoded telegram (2x12 bytes)
+#define AOSPI_FRAME_ENTRY_MAXSIZE 24
+// A tagged frame starts with AOSPI_FRAME_TAGBASE+tag, tag in 0..AOSPI_FRAME_TAGCOUNT-1
+#define AOSPI_FRAME_TAGBASE       0xC0
+#define AOSPI_FRAME_TAGCOUNT      64
+
+
+// Converts a CAN-FD DLC code (0..15) to the number of payload bytes (0..64).
+int     aospi_frame_dlc2size(uint8_t dlc);
+// Converts a payload size (0..64) to the smallest CAN-FD DLC code that fits it.
+uint8_t aospi_frame_size2dlc(int size);
+
+
+// Appends telegram `tele` (sized `telesize`) with length prefix to the batched frame under construction.
+int aospi_frame_add(uint8_t * frame, int * framesize, const uint8_t * tele, int telesize);
+// Returns 1 iff `frame` is a batched frame (as opposed to a frame with one plain telegram).
+int aospi_frame_isbatch(const uint8_t * frame, int framesize);
+// Starts a tagged frame (a request that expects a response, or that response) with sequence tag `tag`.
+void aospi_frame_settag(uint8_t * frame, int * framesize, int tag);
+// Returns the sequence tag of `frame`, or -1 if `frame` is not tagged.
+int aospi_frame_gettag(const uint8_t * frame, int framesize);
+// Extracts the next telegram from batched `frame`; reference unpacker for the receiving side.
+int aospi_frame_next(const uint8_t * frame, int framesize, int * pos, const uint8_t ** tele, int * telesize);
+
+
+#endif
@@ -0,0 +1,204 @@
+// aospi_lpspi.c - PHY backend: native SPI (LPSPI) towards and from OSP nodes
+/*****************************************************************************
+ * Copyright 2024,2025 by ams OSRAM AG                                       *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#include "aoresult.h"
+#include "aospi.h"
+#include "aospi_frame.h"
+#include "aospi_backend.h"
+#include "fsl_lpspi.h"
+
+
+// The native OSP link: the MCU is SPI master towards the first OSP node 
+// (SPI OUT) and SPI slave for the response telegram, mastered by the first
+// (BiDir) or last (Loop) node (SPI IN); see the note on SPI MODE in aospi.c.
+//
+// EXPERIMENTAL: this backend has only run on the host model (see
+// tools/aospi_lpspi_test.c), not on a board. The pins of LPSPI1 and LPSPI4
+// are not muxed by this project: BOARD_InitPins() (pin_mux.c) only routes
+// the CAN, UART and OENA pins, and the default LPSPI1 pads GPIO_AD_30/31
+// carry FLEXCAN2. The application must route both buses (IOMUXC) and
+// enable their clock roots before selecting this backend in aospi_init().
+//
+// This backend is blocking: `tx` and `txrx` complete the request before 
+// they return.
+
+
+// SPI OUT (master) and SPI IN (slave) controllers
+#define AOSPI_LPSPI_OUT_BUS       LPSPI1
+#define AOSPI_LPSPI_OUT_CLK_FREQ  CLOCK_GetRootClockFreq(kCLOCK_Root_Lpspi1)
+#define AOSPI_LPSPI_IN_BUS        LPSPI4
+
+
+// For OSP nodes, the SPI frequency has to be 2.4MHz +/- 50%
+// otherwise a timeout elapses inside the node, resulting in a com error.
+#define AOSPI_OUT_TYPEA_FREQ  (2 * 2400 * 1000) // MCU mode type A: 1-wire Manchester
+#define AOSPI_OUT_TYPEB_FREQ  (2400 * 1000)     // MCU mode type B: 2-wire SPI
+
+
+static lpspi_slave_handle_t aospi_lpspi_in_handle;
+static volatile int         aospi_lpspi_in_done;
+
+
+// Called (in interrupt context) when the SPI IN received all bytes of a response.
+static void aospi_lpspi_in_callback(LPSPI_Type *base, lpspi_slave_handle_t *handle, status_t status, void *userData)
+{
+	aospi_lpspi_in_done = 1;
+}
+
+
+// Sets up SPI OUT as master and SPI IN as slave (aospi_backend_lpspi.init).
+static void aospi_lpspi_init(aospi_phy_t phy)
+{
+	lpspi_master_config_t masterConfig;
+	LPSPI_MasterGetDefaultConfig(&masterConfig);
+	masterConfig.baudRate           = phy==aospi_phy_mcua ? AOSPI_OUT_TYPEA_FREQ : AOSPI_OUT_TYPEB_FREQ;
+	masterConfig.bitsPerFrame       = 8;
+	masterConfig.cpol               = kLPSPI_ClockPolarityActiveHigh;
+	masterConfig.cpha               = kLPSPI_ClockPhaseFirstEdge;
+	masterConfig.direction          = kLPSPI_MsbFirst;
+	masterConfig.whichPcs           = kLPSPI_Pcs0;
+	masterConfig.pcsActiveHighOrLow = kLPSPI_PcsActiveLow;
+	LPSPI_MasterInit(AOSPI_LPSPI_OUT_BUS, &masterConfig, AOSPI_LPSPI_OUT_CLK_FREQ);
+
+	lpspi_slave_config_t slaveConfig;
+	LPSPI_SlaveGetDefaultConfig(&slaveConfig);
+	slaveConfig.bitsPerFrame       = 8;
+	slaveConfig.whichPcs           = kLPSPI_Pcs0;
+	slaveConfig.pcsActiveHighOrLow = kLPSPI_PcsActiveLow;
+	slaveConfig.pinCfg             = kLPSPI_SdiInSdoOut;
+	LPSPI_SlaveInit(AOSPI_LPSPI_IN_BUS, &slaveConfig);
+	LPSPI_SlaveTransferCreateHandle(AOSPI_LPSPI_IN_BUS, &aospi_lpspi_in_handle, aospi_lpspi_in_callback, NULL);
+}
+
+
+// Sends one telegram on SPI OUT.
+static status_t aospi_lpspi_out(const uint8_t * tele, int size)
+{
+	lpspi_transfer_t xfer;
+	xfer.txData      = tele;
+	xfer.rxData      = NULL;
+	xfer.dataSize    = (size_t)size;
+	xfer.configFlags = kLPSPI_MasterPcs0 | kLPSPI_MasterPcsContinuous;
+	return LPSPI_MasterTransferBlocking(AOSPI_LPSPI_OUT_BUS, &xfer);
+}
+
+
+// Sends the telegram of `req`, or each telegram when req->tx is a batched frame.
+static aoresult_t aospi_lpspi_send(aospi_req_t * req)
+{
+	status_t status = kStatus_Success;
+	aospi_backend_outoena(1); // enable level shifter output
+	if( req->batch )
+	{
+		int pos = 0;
+		const uint8_t * tele;
+		int size;
+		while( status==kStatus_Success && aospi_frame_next(req->tx, req->txsize, &pos, &tele, &size) )
+			status = aospi_lpspi_out(tele, size);
+	}
+	else
+	{
+		status = aospi_lpspi_out(req->tx, req->txsize);
+	}
+	// For the RESET telegram it is important to clear OENA immediately
+	aospi_backend_outoena(0); // disable level shifter output
+	if( status!=kStatus_Success ) return aoresult_assert;
+	aospi_req_sent(req);
+	return aoresult_ok;
+}
+
+
+// Sends a request without response (aospi_backend_lpspi.tx).
+static aoresult_t aospi_lpspi_tx(aospi_req_t * req)
+{
+	req->t0 = DWT->CYCCNT;
+	aoresult_t result = aospi_lpspi_send(req);
+	req->us = AOSPI_CYCLES2US(DWT->CYCCNT - req->t0);
+	aospi_req_complete(req, result);
+	return aoresult_ok;
+}
+
+
+// Sends a request and waits for its response, at most aospi_timeout_get() us (aospi_backend_lpspi.txrx).
+static aoresult_t aospi_lpspi_txrx(aospi_req_t * req)
+{
+	req->t0 = DWT->CYCCNT;
+	if( req->rxsize==0 ) return aospi_lpspi_tx(req);
+
+	// Arm SPI IN before sending, a response follows the command closely
+	lpspi_transfer_t xfer;
+	xfer.txData      = NULL;
+	xfer.rxData      = req->rx;
+	xfer.dataSize    = (size_t)req->rxsize;
+	xfer.configFlags = kLPSPI_SlavePcs0;
+	aospi_lpspi_in_done = 0;
+	if( LPSPI_SlaveTransferNonBlocking(AOSPI_LPSPI_IN_BUS, &aospi_lpspi_in_handle, &xfer)!=kStatus_Success )
+	{
+		aospi_req_complete(req, aoresult_assert);
+		return aoresult_ok;
+	}
+	aospi_inoena_set(1);
+
+	aoresult_t result = aospi_lpspi_send(req);
+	// Wait for the response, checking once per us
+	uint32_t timeout = AOSPI_US2CYCLES(aospi_timeout_get());
+	while( result==aoresult_ok && !aospi_lpspi_in_done && DWT->CYCCNT - req->t0 < timeout ) {
+		SDK_DelayAtLeastUs(1, SystemCoreClock);
+	};
+	req->us = AOSPI_CYCLES2US(DWT->CYCCNT - req->t0);
+
+	// A short response times out; report what was received, so the caller sees the size mismatch
+	size_t count = (size_t)req->rxsize;
+	if( !aospi_lpspi_in_done )
+	{
+		if( LPSPI_SlaveTransferGetCount(AOSPI_LPSPI_IN_BUS, &aospi_lpspi_in_handle, &count)!=kStatus_Success ) count = 0;
+		LPSPI_SlaveTransferAbort(AOSPI_LPSPI_IN_BUS, &aospi_lpspi_in_handle);
+	}
+	aospi_inoena_set(0);
+	if( result==aoresult_ok && count==0 ) result = aoresult_spi_noclock;
+	if( result==aoresult_ok ) aospi_req_received(req, (int)count);
+	aospi_req_complete(req, result);
+	return aoresult_ok;
+}
+
+
+// Nothing to do, requests complete in tx and txrx (aospi_backend_lpspi.poll).
+static void aospi_lpspi_poll(void)
+{
+}
+
+
+// Always idle, requests complete in tx and txrx (aospi_backend_lpspi.idle).
+static int aospi_lpspi_idle(void)
+{
+	return 1;
+}
+
+
+// The LPSPI backend, see aospi_backend_t.
+const aospi_backend_t aospi_backend_lpspi = {
+  .name = "lpspi",
+  .chains = 1,
+  .init = aospi_lpspi_init,
+  .tx   = aospi_lpspi_tx,
+  .txrx = aospi_lpspi_txrx,
+  .poll = aospi_lpspi_poll,
+  .idle = aospi_lpspi_idle,
+};
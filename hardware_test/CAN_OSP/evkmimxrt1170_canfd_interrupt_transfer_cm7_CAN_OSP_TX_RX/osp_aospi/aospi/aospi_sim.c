@@ -0,0 +1,616 @@
+// aospi_sim.c - PHY backend: virtual OSP chain, for running the stack without hardware
+/*****************************************************************************
+ * Copyright 2024,2025 by ams OSRAM AG                                       *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#include "aoresult.h"
+#include "aospi.h"
+#include "aospi_frame.h"
+#include "aospi_backend.h"
+#if AOSPI_SIM_ENABLED // compiled in on request only, see aospi.h
+
+
+// A model of an OSP chain, in-process. The telegrams of a request are
+// executed by a model of each addressed node (SAID or RGBI), and the
+// response is built like a node would. So aoosp, aomw and the apps run
+// unchanged, eg to benchmark a topology build of 1000 nodes.
+//
+// The chain is set with aospi_sim_chain_set(): one character per node,
+// and Loop or BiDir wiring. Each node models its state and status flags,
+// SETUP (CRC enable), PWM and current settings, I2C config and the READLAST
+// buffer. A SAID channel with sync enabled (SETCURCHN flag SYNCEN) keeps a
+// new PWM setting pending until a SYNC telegram; aospi_sim_pwm_get() returns
+// the setting a node shows. Its OTP is all zero, except I2C_BRIDGE_EN for an I2C bridge.
+// All I2C bridges share one I2C device (256 registers at AOSPI_SIM_I2C_DADDR7).
+//
+// Executed telegrams: RESET, CLRERROR, INITBIDIR, INITLOOP, GOSLEEP,
+// GOACTIVE, IDENTIFY, SETMULT, SYNC, I2CREAD8, I2CWRITE8, READLAST, READSTAT,
+// READTEMPSTAT, SETSETUP, SETPWM, SETPWMCHN, SETCURCHN, READI2CCFG and
+// READOTP. Other telegrams, and telegrams with a bad preamble or size are
+// dropped (see aospi_sim_dropcount_get). A node with CRC checking enabled
+// (SETSETUP) drops a telegram with a bad CRC and flags a communication
+// error; the CRC of RESET and INIT telegrams is not checked. Nodes do not
+// respond to broadcast or to a group address; a group address reaches the
+// nodes that SETMULT made member of the group.
+//
+// Timing follows the trip time model of aospi_txrx_us(): a telegram byte
+// takes 8 bits at 2.4MHz, a hop takes aospi_sim_hop_set() ns, and a SAID
+// in BiDir adds a 5us delay. A request completes immediately (in `tx` or
+// `txrx`) with the modelled time in req->us; a response that would take
+// longer than the time-out completes with aoresult_spi_noclock.
+// The modelled time of all requests adds up in aospi_sim_time_us().
+// aospi_sim_fail_set() makes requests fail as if not acknowledged.
+//
+// This file has no dependencies on the MCU SDK beyond aospi itself. It is
+// only compiled in with AOSPI_SIM_ENABLED (the host tools in tools/ do so).
+
+
+// Node kinds (characters in the string passed to aospi_sim_chain_set)
+#define AOSPI_SIM_RGBI            'R'
+#define AOSPI_SIM_SAID            'S'
+#define AOSPI_SIM_SAIDI2C         'I' // SAID with I2C_BRIDGE_EN (channel 2 is I2C bridge)
+
+
+// Telegram IDs executed by the nodes
+#define AOSPI_SIM_TID_RESET        0x00
+#define AOSPI_SIM_TID_CLRERROR     0x01
+#define AOSPI_SIM_TID_INITBIDIR    0x02
+#define AOSPI_SIM_TID_INITLOOP     0x03
+#define AOSPI_SIM_TID_GOSLEEP      0x04
+#define AOSPI_SIM_TID_GOACTIVE     0x05
+#define AOSPI_SIM_TID_IDENTIFY     0x07
+#define AOSPI_SIM_TID_SETMULT      0x0D
+#define AOSPI_SIM_TID_SYNC         0x0F
+#define AOSPI_SIM_TID_I2CREAD      0x18
+#define AOSPI_SIM_TID_I2CWRITE     0x19
+#define AOSPI_SIM_TID_READLAST     0x1E
+#define AOSPI_SIM_TID_READSTAT     0x40
+#define AOSPI_SIM_TID_READTEMPSTAT 0x42
+#define AOSPI_SIM_TID_SETSETUP     0x4D
+#define AOSPI_SIM_TID_SETPWM       0x4F // SETPWM (RGBI) and SETPWMCHN (SAID)
+#define AOSPI_SIM_TID_SETCURCHN    0x51
+#define AOSPI_SIM_TID_READI2CCFG   0x56
+#define AOSPI_SIM_TID_READOTP      0x58
+
+
+// Status byte: state in bits 7:6, flags below
+#define AOSPI_SIM_STAT_STATE       0xC0
+#define AOSPI_SIM_STAT_SLEEP       0x40
+#define AOSPI_SIM_STAT_ACTIVE      0x80
+#define AOSPI_SIM_STAT_OV          0x10 // SAID: over voltage, flagged after RESET until CLRERROR
+#define AOSPI_SIM_STAT_DIRLOOP     0x10 // RGBI: initialized with INITLOOP
+#define AOSPI_SIM_STAT_CE          0x08 // communication error (eg CRC)
+#define AOSPI_SIM_STAT_SAID_ERRORS 0x3F
+#define AOSPI_SIM_STAT_RGBI_ERRORS 0x2F
+// SETUP flag enabling CRC checking
+#define AOSPI_SIM_SETUP_CRCEN      0x20
+// SETCURCHN flag (payload byte 1) enabling synchronized PWM activation
+#define AOSPI_SIM_CURCHN_SYNCEN    0x40
+// I2CCFG: flags in bits 7:4, speed in bits 3:0
+#define AOSPI_SIM_I2CCFG_NACK      0x20
+#define AOSPI_SIM_I2CCFG_DEFAULT   0x0C
+// IDENTIFY results and raw temperatures (25C)
+#define AOSPI_SIM_ID_RGBI          0x00000000
+#define AOSPI_SIM_ID_SAID          0x00000040
+#define AOSPI_SIM_TEMP_RGBI        0x8C
+#define AOSPI_SIM_TEMP_SAID        0x74
+// The I2C device address behind every I2C bridge
+#define AOSPI_SIM_I2C_DADDR7       0x50
+
+
+// Link timing: a byte is 8 bits at 2.4MHz, a SAID in BiDir delays its response
+#define AOSPI_SIM_BYTES2NS(n)      ((uint32_t)(n)*10000/3)
+#define AOSPI_SIM_SAIDDELAY_NS     5000
+
+
+// The state of one node
+typedef struct aospi_sim_node_s {
+  char     kind;      // AOSPI_SIM_RGBI, AOSPI_SIM_SAID or AOSPI_SIM_SAIDI2C
+  uint8_t  stat;      // state (bits 7:6) and flags
+  uint8_t  setup;     // as set with SETSETUP
+  uint16_t groups;    // as set with SETMULT (bit n for group n)
+  uint8_t  i2ccfg;    // I2C flags (bits 7:4) and speed (bits 3:0)
+  uint8_t  i2cpower;  // channel 2 powered (SETCURCHN), needed for I2C
+  uint8_t  cur[3][2]; // SETCURCHN payload per channel (flags|rcur, gcur|bcur)
+  uint16_t pwm[3][3]; // SETPWM/SETPWMCHN per channel (red, green, blue), as shown
+  uint16_t pend[3][3];// SETPWMCHN per channel, pending until SYNC (channels with SYNCEN)
+  uint8_t  last[8];   // READLAST buffer (bytes of the last I2C read, right aligned)
+} aospi_sim_node_t;
+
+
+static aospi_sim_node_t aospi_sim_nodes[AOSPI_SIM_MAXNODES];
+static int              aospi_sim_count= -1;     // number of nodes, -1 until aospi_sim_chain_set()
+static int              aospi_sim_loop;          // 1 iff the chain is wired as Loop (otherwise BiDir)
+static uint16_t         aospi_sim_base;          // address of the first node (INIT), 0 when not initialized
+static uint32_t         aospi_sim_hop_ns= AOSPI_SIM_HOP_NS;
+static uint64_t         aospi_sim_ns;            // modelled link time of all requests
+static int              aospi_sim_drops;         // telegrams dropped by the nodes
+static int              aospi_sim_fails;         // number of next requests that fail (not acknowledged), see aospi_sim_fail_set
+static aospi_phy_t      aospi_sim_phy;
+static uint8_t          aospi_sim_i2cmem[256];   // registers of the I2C device
+
+
+// === Model ================================================================
+
+
+// OSP CRC (polynomial 0x2F), computed bitwise; independent of the table driven aoosp_crc().
+static uint8_t aospi_sim_crc(const uint8_t * buf, int size) {
+  uint8_t crc= 0;
+  for( int i=0; i<size; i++ ) {
+    crc ^= buf[i];
+    for( int bit=0; bit<8; bit++ ) crc= crc&0x80 ? (uint8_t)(crc<<1)^0x2F : (uint8_t)(crc<<1);
+  }
+  return crc;
+}
+
+
+// Decodes the `size` Manchester bytes in `bufi` (see aospi_manchester_encode) to size/2 bytes in `bufo`; returns 0 on a code violation.
+static int aospi_sim_manchester_decode(const uint8_t * bufi, int size, uint8_t * bufo) {
+  if( size%2!=0 ) return 0;
+  for( int i=0; i<size/2; i++ ) {
+    uint16_t w= (uint16_t)(bufi[2*i]<<8 | bufi[2*i+1]); // transmission is big endian
+    uint8_t  b= 0;
+    for( int bit=7; bit>=0; bit-- ) {
+      int pair= (w>>(2*bit)) & 0b11;
+      if( pair==0b01 ) b= (uint8_t)(b<<1 | 1); // IEEE 802.4: rising edge is 1
+      else if( pair==0b10 ) b= (uint8_t)(b<<1); // falling edge is 0
+      else return 0;
+    }
+    bufo[i]= b;
+  }
+  return 1;
+}
+
+
+// Puts `node` in its state after RESET (the OTP, given by the kind, is kept).
+static void aospi_sim_node_reset(aospi_sim_node_t * node) {
+  char kind= node->kind;
+  memset(node,0,sizeof(*node));
+  node->kind= kind;
+  node->stat= kind==AOSPI_SIM_RGBI ? 0 : AOSPI_SIM_STAT_OV;
+  node->i2ccfg= AOSPI_SIM_I2CCFG_DEFAULT;
+}
+
+
+// Returns byte `otpaddr` of the OTP of `node`: all zero except I2C_BRIDGE_EN (0x0D bit 0) for an I2C bridge.
+static uint8_t aospi_sim_otp(const aospi_sim_node_t * node, int otpaddr) {
+  return otpaddr==0x0D && node->kind==AOSPI_SIM_SAIDI2C ? 0x01 : 0x00;
+}
+
+
+// Executes telegram `tid` with `payload` (`psize` bytes) on `node`; returns the size of the response payload written to `resp`, or -1 for no response.
+static int aospi_sim_node_exec(aospi_sim_node_t * node, uint8_t tid, const uint8_t * payload, int psize, uint8_t * resp) {
+  int said= node->kind!=AOSPI_SIM_RGBI;
+  switch( tid ) {
+
+    case AOSPI_SIM_TID_CLRERROR:
+      node->stat &= said ? AOSPI_SIM_STAT_STATE : AOSPI_SIM_STAT_STATE|AOSPI_SIM_STAT_DIRLOOP;
+      return -1;
+
+    case AOSPI_SIM_TID_GOSLEEP:
+      node->stat= (node->stat & ~AOSPI_SIM_STAT_STATE) | AOSPI_SIM_STAT_SLEEP;
+      return -1;
+
+    case AOSPI_SIM_TID_GOACTIVE:
+      // A node with error flags does not go active (eg a SAID before CLRERROR)
+      if( node->stat & (said ? AOSPI_SIM_STAT_SAID_ERRORS : AOSPI_SIM_STAT_RGBI_ERRORS) ) return -1;
+      node->stat= (node->stat & ~AOSPI_SIM_STAT_STATE) | AOSPI_SIM_STAT_ACTIVE;
+      return -1;
+
+    case AOSPI_SIM_TID_IDENTIFY: {
+      uint32_t id= said ? AOSPI_SIM_ID_SAID : AOSPI_SIM_ID_RGBI;
+      resp[0]= (uint8_t)(id>>24);
+      resp[1]= (uint8_t)(id>>16);
+      resp[2]= (uint8_t)(id>>8);
+      resp[3]= (uint8_t)(id>>0);
+      return 4;
+    }
+
+    case AOSPI_SIM_TID_SETMULT:
+      if( psize==2 ) node->groups= (uint16_t)((payload[0]&0x7F)<<8 | payload[1]);
+      return -1;
+
+    case AOSPI_SIM_TID_SYNC:
+      // Channels with sync enabled show their pending PWM setting
+      for( int chn=0; chn<3; chn++ ) {
+        if( node->cur[chn][0] & AOSPI_SIM_CURCHN_SYNCEN ) memcpy(node->pwm[chn],node->pend[chn],sizeof(node->pwm[chn]));
+      }
+      return -1;
+
+    case AOSPI_SIM_TID_I2CREAD: {
+      if( node->kind!=AOSPI_SIM_SAIDI2C || psize!=3 ) return -1;
+      int daddr7= payload[0]>>1;
+      int raddr = payload[1];
+      int count = payload[2];
+      if( count<1 || count>8 ) return -1;
+      if( !node->i2cpower || daddr7!=AOSPI_SIM_I2C_DADDR7 ) { node->i2ccfg |= AOSPI_SIM_I2CCFG_NACK; return -1; }
+      node->i2ccfg &= ~AOSPI_SIM_I2CCFG_NACK;
+      memset(node->last,0,sizeof(node->last));
+      for( int i=0; i<count; i++ ) node->last[8-count+i]= aospi_sim_i2cmem[(raddr+i)&0xFF];
+      return -1;
+    }
+
+    case AOSPI_SIM_TID_I2CWRITE: {
+      if( node->kind!=AOSPI_SIM_SAIDI2C || psize<3 ) return -1;
+      int daddr7= payload[0]>>1;
+      int raddr = payload[1];
+      if( !node->i2cpower || daddr7!=AOSPI_SIM_I2C_DADDR7 ) { node->i2ccfg |= AOSPI_SIM_I2CCFG_NACK; return -1; }
+      node->i2ccfg &= ~AOSPI_SIM_I2CCFG_NACK;
+      for( int i=0; i<psize-2; i++ ) aospi_sim_i2cmem[(raddr+i)&0xFF]= payload[2+i];
+      return -1;
+    }
+
+    case AOSPI_SIM_TID_READLAST:
+      if( !said ) return -1;
+      memcpy(resp,node->last,8);
+      return 8;
+
+    case AOSPI_SIM_TID_READSTAT:
+      resp[0]= node->stat;
+      return 1;
+
+    case AOSPI_SIM_TID_READTEMPSTAT:
+      resp[0]= said ? AOSPI_SIM_TEMP_SAID : AOSPI_SIM_TEMP_RGBI;
+      resp[1]= node->stat;
+      return 2;
+
+    case AOSPI_SIM_TID_SETSETUP:
+      if( psize==1 ) node->setup= payload[0];
+      return -1;
+
+    case AOSPI_SIM_TID_SETPWM:
+      if( !said && psize==6 ) { // SETPWM: 15 bits per color, daytimes in the msb's
+        for( int c=0; c<3; c++ ) node->pwm[0][c]= (uint16_t)((payload[2*c]&0x7F)<<8 | payload[2*c+1]);
+      } else if( said && psize==8 && payload[0]<3 ) { // SETPWMCHN: channel, dummy, 16 bits per color
+        int chn= payload[0];
+        for( int c=0; c<3; c++ ) node->pend[chn][c]= (uint16_t)(payload[2+2*c]<<8 | payload[3+2*c]);
+        if( !(node->cur[chn][0] & AOSPI_SIM_CURCHN_SYNCEN) ) memcpy(node->pwm[chn],node->pend[chn],sizeof(node->pwm[chn]));
+      }
+      return -1;
+
+    case AOSPI_SIM_TID_SETCURCHN:
+      if( !said || psize!=3 || payload[0]>2 ) return -1;
+      node->cur[payload[0]][0]= payload[1];
+      node->cur[payload[0]][1]= payload[2];
+      if( payload[0]==2 ) node->i2cpower= 1;
+      return -1;
+
+    case AOSPI_SIM_TID_READI2CCFG:
+      if( !said ) return -1;
+      resp[0]= node->i2ccfg;
+      return 1;
+
+    case AOSPI_SIM_TID_READOTP:
+      if( psize!=1 ) return -1;
+      for( int i=0; i<8; i++ ) resp[7-i]= aospi_sim_otp(node,payload[0]+i); // telegram is big endian
+      return 8;
+
+  }
+  aospi_sim_drops++; // not modelled
+  return -1;
+}
+
+
+// Completes the response telegram in `resp` (payload of `psize` bytes at resp+3) with header and CRC; returns its size.
+static int aospi_sim_resp(uint8_t * resp, uint16_t addr, uint8_t tid, int psize) {
+  int psi= psize<8 ? psize : 7;
+  resp[0]= (uint8_t)(0xA0 | addr>>6);
+  resp[1]= (uint8_t)((addr&0x3F)<<2 | psi>>1);
+  resp[2]= (uint8_t)((psi&1)<<7 | tid);
+  resp[3+psize]= aospi_sim_crc(resp,3+psize);
+  return 4+psize;
+}
+
+
+// Executes `tele` (`size` bytes, plain) on the chain; returns the size of the response telegram in `resp` (0 for none), adds the link time to *ns.
+static int aospi_sim_exec(const uint8_t * tele, int size, uint8_t * resp, uint32_t * ns) {
+  *ns+= AOSPI_SIM_BYTES2NS(size); // t_cmd
+
+  // Parse the telegram
+  if( size<4 || size>AOSPI_TELE_MAXSIZE || (tele[0]>>4)!=0xA ) { aospi_sim_drops++; return 0; }
+  uint16_t addr = (uint16_t)((tele[0]&0x0F)<<6 | tele[1]>>2);
+  int      psi  = (tele[1]&0x03)<<1 | tele[2]>>7;
+  int      psize= psi<7 ? psi : 8;
+  uint8_t  tid  = tele[2]&0x7F;
+  if( size!=4+psize ) { aospi_sim_drops++; return 0; }
+  int      crcok= aospi_sim_crc(tele,size)==0;
+
+  // RESET and INIT address the chain (all nodes)
+  if( tid==AOSPI_SIM_TID_RESET ) {
+    for( int nix=0; nix<aospi_sim_count; nix++ ) aospi_sim_node_reset(&aospi_sim_nodes[nix]);
+    aospi_sim_base= 0;
+    return 0;
+  }
+  if( tid==AOSPI_SIM_TID_INITBIDIR || tid==AOSPI_SIM_TID_INITLOOP ) {
+    int loop= tid==AOSPI_SIM_TID_INITLOOP;
+    if( aospi_sim_count==0 || addr==0 || addr+aospi_sim_count-1>0x3EF ) return 0;
+    aospi_sim_base= addr; // serialcast: each node takes the address of its predecessor plus one
+    for( int nix=0; nix<aospi_sim_count; nix++ ) {
+      aospi_sim_node_t * node= &aospi_sim_nodes[nix];
+      node->stat= (node->stat & ~AOSPI_SIM_STAT_STATE) | AOSPI_SIM_STAT_SLEEP;
+      if( node->kind==AOSPI_SIM_RGBI ) node->stat= loop ? node->stat|AOSPI_SIM_STAT_DIRLOOP : node->stat&~AOSPI_SIM_STAT_DIRLOOP;
+    }
+    // The last node responds, but that only reaches the MCU when the wiring matches
+    if( loop!=aospi_sim_loop ) return 0;
+    aospi_sim_node_t * last= &aospi_sim_nodes[aospi_sim_count-1];
+    resp[3]= last->kind==AOSPI_SIM_RGBI ? AOSPI_SIM_TEMP_RGBI : AOSPI_SIM_TEMP_SAID;
+    resp[4]= last->stat;
+    *ns+= (uint32_t)(loop ? 1 : 2) * (uint32_t)(aospi_sim_count-1) * aospi_sim_hop_ns;
+    if( !loop && last->kind!=AOSPI_SIM_RGBI ) *ns+= AOSPI_SIM_SAIDDELAY_NS;
+    *ns+= AOSPI_SIM_BYTES2NS(4+2);
+    return aospi_sim_resp(resp, (uint16_t)(addr+aospi_sim_count-1), tid, 2);
+  }
+
+  // Other telegrams need initialized nodes
+  if( aospi_sim_base==0 ) return 0;
+  if( addr==0 ) { // broadcast: all nodes execute, none responds
+    for( int nix=0; nix<aospi_sim_count; nix++ ) {
+      aospi_sim_node_t * node= &aospi_sim_nodes[nix];
+      if( !crcok && (node->setup & AOSPI_SIM_SETUP_CRCEN) ) { node->stat |= AOSPI_SIM_STAT_CE; continue; }
+      uint8_t dummy[8];
+      aospi_sim_node_exec(node, tid, tele+3, psize, dummy);
+    }
+    return 0;
+  }
+  if( addr>=0x3F0 && addr<=0x3FE ) { // group: the member nodes execute, none responds
+    for( int nix=0; nix<aospi_sim_count; nix++ ) {
+      aospi_sim_node_t * node= &aospi_sim_nodes[nix];
+      if( !(node->groups & 1<<(addr-0x3F0)) ) continue;
+      if( !crcok && (node->setup & AOSPI_SIM_SETUP_CRCEN) ) { node->stat |= AOSPI_SIM_STAT_CE; continue; }
+      uint8_t dummy[8];
+      aospi_sim_node_exec(node, tid, tele+3, psize, dummy);
+    }
+    return 0;
+  }
+  int nix= (int)addr - (int)aospi_sim_base;
+  if( nix<0 || nix>=aospi_sim_count ) return 0; // no such node
+  aospi_sim_node_t * node= &aospi_sim_nodes[nix];
+  if( !crcok && (node->setup & AOSPI_SIM_SETUP_CRCEN) ) { node->stat |= AOSPI_SIM_STAT_CE; return 0; }
+  int rsize= aospi_sim_node_exec(node, tid, tele+3, psize, resp+3);
+  if( rsize<0 ) return 0;
+
+  // Response: BiDir goes back through the upstream nodes, Loop forward through the downstream nodes
+  *ns+= (uint32_t)(aospi_sim_loop ? aospi_sim_count-1 : 2*nix) * aospi_sim_hop_ns;
+  if( !aospi_sim_loop && node->kind!=AOSPI_SIM_RGBI ) *ns+= AOSPI_SIM_SAIDDELAY_NS;
+  *ns+= AOSPI_SIM_BYTES2NS(4+rsize);
+  return aospi_sim_resp(resp, addr, tid, rsize);
+}
+
+
+// Executes one telegram as encoded for the phy; see aospi_sim_exec.
+static int aospi_sim_exec_phy(const uint8_t * tele, int size, uint8_t * resp, uint32_t * ns) {
+  if( aospi_sim_phy!=aospi_phy_mcua ) return aospi_sim_exec(tele, size, resp, ns);
+  uint8_t plain[AOSPI_TELE_MAXSIZE];
+  if( size>2*AOSPI_TELE_MAXSIZE || !aospi_sim_manchester_decode(tele, size, plain) ) { aospi_sim_drops++; return 0; }
+  return aospi_sim_exec(plain, size/2, resp, ns);
+}
+
+
+// Executes the telegram, or all telegrams of a batched frame, of `req`; returns the size of the (last) response in `resp`.
+static int aospi_sim_run(aospi_req_t * req, uint8_t * resp, uint32_t * ns) {
+  if( !req->batch ) return aospi_sim_exec_phy(req->tx, req->txsize, resp, ns);
+  int rsize= 0;
+  int pos= 0;
+  const uint8_t * tele;
+  int size;
+  while( aospi_frame_next(req->tx, req->txsize, &pos, &tele, &size) ) {
+    int n= aospi_sim_exec_phy(tele, size, resp, ns);
+    if( n>0 ) rsize= n;
+  }
+  return rsize;
+}
+
+
+// === Backend ==============================================================
+
+
+// Records the phy, sets up the default chain when none is set (aospi_backend_sim.init).
+static void aospi_sim_init(aospi_phy_t phy)
+{
+	aospi_sim_phy= phy;
+	if( aospi_sim_count<0 ) aospi_sim_chain_set(AOSPI_SIM_CHAIN_DEFAULT, 0);
+}
+
+
+// Executes the telegrams of the request (aospi_backend_sim.tx).
+static aoresult_t aospi_sim_tx(aospi_req_t * req)
+{
+	uint8_t  resp[AOSPI_TELE_MAXSIZE];
+	uint32_t ns= 0;
+	if( aospi_sim_fails>0 ) { aospi_sim_fails--; aospi_req_complete(req, aoresult_spi_noclock); return aoresult_ok; }
+	aospi_sim_run(req, resp, &ns);
+	aospi_sim_ns+= ns;
+	req->us= (ns+999)/1000;
+	aospi_req_sent(req);
+	aospi_req_complete(req, aoresult_ok);
+	return aoresult_ok;
+}
+
+
+// Executes the telegrams of the request and returns the response of the addressed node (aospi_backend_sim.txrx).
+static aoresult_t aospi_sim_txrx(aospi_req_t * req)
+{
+	uint8_t  resp[AOSPI_TELE_MAXSIZE];
+	uint32_t ns= 0;
+	if( aospi_sim_fails>0 ) { aospi_sim_fails--; aospi_req_complete(req, aoresult_spi_noclock); return aoresult_ok; }
+	int rsize= aospi_sim_run(req, resp, &ns);
+	aospi_req_sent(req);
+	// No response, or one that arrives too late, costs the time-out
+	if( rsize==0 || ns>(uint64_t)aospi_timeout_get()*1000 )
+	{
+		aospi_sim_ns+= (uint64_t)aospi_timeout_get()*1000;
+		req->us= aospi_timeout_get();
+		aospi_req_complete(req, aoresult_spi_noclock);
+		return aoresult_ok;
+	}
+	aospi_sim_ns+= ns;
+	req->us= (ns+999)/1000;
+	memcpy(req->rx, resp, rsize<req->rxsize ? rsize : req->rxsize);
+	aospi_req_received(req, rsize);
+	aospi_req_complete(req, aoresult_ok);
+	return aoresult_ok;
+}
+
+
+// Nothing to do, requests complete in tx and txrx (aospi_backend_sim.poll).
+static void aospi_sim_poll(void)
+{
+}
+
+
+// Always idle, requests complete in tx and txrx (aospi_backend_sim.idle).
+static int aospi_sim_idle(void)
+{
+	return 1;
+}
+
+
+// The virtual chain backend, see aospi_backend_t.
+const aospi_backend_t aospi_backend_sim = {
+  .name = "sim",
+  .chains = 1,
+  .init = aospi_sim_init,
+  .tx   = aospi_sim_tx,
+  .txrx = aospi_sim_txrx,
+  .poll = aospi_sim_poll,
+  .idle = aospi_sim_idle,
+};
+
+
+// === Configuration ========================================================
+
+
+/*!
+    @brief  Sets the virtual OSP chain of the sim backend.
+    @param  nodes
+            One character per node, starting with the node closest to the
+            MCU: 'R' for an RGBI, 'S' for a SAID, 'I' for a SAID with I2C
+            bridge (channel 2). For example "SRRRI".
+    @param  loop
+            1 when the chain is wired as Loop (the last node connects back
+            to the MCU), 0 for BiDir.
+    @return aoresult_spi_buf    if nodes is NULL
+            aoresult_outofmem   if there are more than AOSPI_SIM_MAXNODES nodes
+            aoresult_sys_id     if a character is not R, S or I
+            aoresult_ok         otherwise
+    @note   The nodes start in their state after power on: not initialized
+            (use RESET and INITBIDIR/INITLOOP, eg aoosp_exec_resetinit).
+    @note   Also resets the modelled time and the drop counter, and clears
+            the I2C device.
+    @note   Without a call, aospi_init() sets up AOSPI_SIM_CHAIN_DEFAULT (BiDir).
+*/
+aoresult_t aospi_sim_chain_set(const char * nodes, int loop) {
+  if( nodes==0 ) return aoresult_spi_buf;
+  int count= (int)strlen(nodes);
+  if( count>AOSPI_SIM_MAXNODES ) return aoresult_outofmem;
+  for( int nix=0; nix<count; nix++ ) {
+    if( nodes[nix]!=AOSPI_SIM_RGBI && nodes[nix]!=AOSPI_SIM_SAID && nodes[nix]!=AOSPI_SIM_SAIDI2C ) return aoresult_sys_id;
+  }
+  for( int nix=0; nix<count; nix++ ) {
+    aospi_sim_nodes[nix].kind= nodes[nix];
+    aospi_sim_node_reset(&aospi_sim_nodes[nix]);
+  }
+  aospi_sim_count= count;
+  aospi_sim_loop = loop!=0;
+  aospi_sim_base = 0;
+  aospi_sim_ns   = 0;
+  aospi_sim_drops= 0;
+  memset(aospi_sim_i2cmem,0,sizeof(aospi_sim_i2cmem));
+  return aoresult_ok;
+}
+
+
+/*!
+    @brief  Sets the forwarding time of one node (a hop) in the sim backend.
+    @param  ns
+            The time in ns (default AOSPI_SIM_HOP_NS).
+    @note   The round trip of a response to node k (BiDir) includes 2(k-1)
+            hops, in Loop it includes n-1 hops (for a chain of n nodes).
+*/
+void aospi_sim_hop_set(uint32_t ns) {
+  aospi_sim_hop_ns= ns;
+}
+
+
+/*!
+    @brief  Makes the next `count` requests to the sim backend fail, as if
+            their frames were not acknowledged: the nodes do not get the
+            telegrams, and the requests end with aoresult_spi_noclock.
+    @param  count
+            The number of requests to fail (0 ends a pending failure).
+    @note   For testing the error paths of callers (eg a framebuffer flush).
+*/
+void aospi_sim_fail_set(int count) {
+  aospi_sim_fails= count;
+}
+
+
+/*!
+    @brief  Returns the modelled link time of the sim backend: the sum of the
+            times of all requests since aospi_sim_chain_set().
+    @return Time in us (micro seconds).
+    @note   Compare with the (host) time taken by the same calls, to see
+            how much of a (eg topology build) is spent in the stack.
+*/
+uint64_t aospi_sim_time_us() {
+  return aospi_sim_ns/1000;
+}
+
+
+/*!
+    @brief  Returns the number of telegrams dropped by the virtual chain since
+            aospi_sim_chain_set(): bad preamble, bad size (PSI), bad Manchester
+            code or not modelled telegram ID.
+    @return Number of dropped telegrams.
+    @note   Telegrams with a bad CRC are not counted; they flag a
+            communication error in the status of the addressed node(s),
+            when those have CRC checking enabled.
+*/
+int aospi_sim_dropcount_get() {
+  return aospi_sim_drops;
+}
+
+
+/*!
+    @brief  Returns the PWM setting node `addr` of the virtual chain shows on
+            channel `chn`: the last SETPWM (RGBI) or SETPWMCHN, or for a SAID
+            channel with sync enabled, the setting at the last SYNC.
+    @param  addr
+            The address of the node (as assigned by INIT).
+    @param  chn
+            The channel, 0..2 (an RGBI only has channel 0).
+    @param  rgb
+            Output array of three: the red, green and blue PWM setting.
+    @return aoresult_outargnull if rgb is NULL
+            aoresult_osp_addr   if no node has address addr
+            aoresult_osp_arg    if chn is out of range
+            aoresult_ok         otherwise
+    @note   For checking eg that a chain never shows a mix of two frames.
+*/
+aoresult_t aospi_sim_pwm_get(uint16_t addr, int chn, uint16_t * rgb) {
+  if( rgb==0 ) return aoresult_outargnull;
+  int nix= (int)addr - (int)aospi_sim_base;
+  if( aospi_sim_base==0 || nix<0 || nix>=aospi_sim_count ) return aoresult_osp_addr;
+  aospi_sim_node_t * node= &aospi_sim_nodes[nix];
+  if( chn<0 || chn>2 || (node->kind==AOSPI_SIM_RGBI && chn>0) ) return aoresult_osp_arg;
+  for( int c=0; c<3; c++ ) rgb[c]= node->pwm[chn][c];
+  return aoresult_ok;
+}
+
+
+#endif // AOSPI_SIM_ENABLED
@@ -0,0 +1,232 @@
+// aospi_socketcan.c - PHY backend: Linux SocketCAN, to run the stack on a host
+/*****************************************************************************
+ * Copyright 2024,2025 by ams OSRAM AG                                       *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#if defined(__linux__)
+#include <errno.h>
+#include <fcntl.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include "aoresult.h"
+#include "aospi.h"
+#include "aospi_frame.h"
+#include "aospi_backend.h"
+
+
+// Runs the stack on a Linux host: frames go over a SocketCAN interface, 
+// with the same IDs and frame formats (aospi_frame.c) as the FlexCAN 
+// backend, so a CAN-to-OSP bridge on a USB-CAN adapter, or a bridge model 
+// on a virtual CAN (ip link add dev vcan0 type vcan), answers them. 
+// Requests with response are always tagged, so they are pipelined; they 
+// complete in `poll` (so in aospi_wait), not in an ISR.
+
+
+// Interface used, unless the environment variable AOSPI_SOCKETCAN_IF names another
+#define AOSPI_SOCKETCAN_IFNAME   "vcan0"
+// CAN IDs of the frames to and from the bridge
+#define AOSPI_SOCKETCAN_TXID     0x123
+#define AOSPI_SOCKETCAN_RXID     0x321
+// Frames have at least 24 bytes (DLC 12), what the bridge always got
+#define AOSPI_SOCKETCAN_MINSIZE  24
+
+
+static int aospi_socketcan_fd = -1;
+
+// Requests awaiting a response, indexed by tag; tags are handed out round robin
+static aospi_req_t * aospi_socketcan_req[AOSPI_FRAME_TAGCOUNT];
+static int      aospi_socketcan_next;        // tag for the next request with response
+static int      aospi_socketcan_oldest;      // tag of the oldest outstanding request
+static int      aospi_socketcan_outstanding; // number of requests awaiting a response
+static uint32_t aospi_socketcan_lastrx;      // time (us) of the last response
+
+
+// Returns a monotonic time stamp in us.
+static uint32_t aospi_socketcan_now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)(ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000);
+}
+
+
+// Opens and binds the CAN_RAW socket, with CAN-FD frames (aospi_backend_socketcan.init).
+static void aospi_socketcan_init(aospi_phy_t phy)
+{
+	(void)phy; // the bridge does the bit timing of the OSP link
+	const char * ifname = getenv("AOSPI_SOCKETCAN_IF");
+	if( ifname==0 ) ifname = AOSPI_SOCKETCAN_IFNAME;
+
+	int fd = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+	if( fd<0 ) { PRINTF("socketcan: socket: %s\n", strerror(errno)); return; }
+	int enable = 1;
+	struct ifreq ifr;
+	memset(&ifr, 0, sizeof(ifr));
+	strncpy(ifr.ifr_name, ifname, IFNAMSIZ-1);
+	struct can_filter filter = { .can_id = AOSPI_SOCKETCAN_RXID, .can_mask = CAN_SFF_MASK };
+	struct sockaddr_can addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.can_family = AF_CAN;
+	if( setsockopt(fd, SOL_CAN_RAW, CAN_RAW_FD_FRAMES, &enable, sizeof(enable))<0
+	 || setsockopt(fd, SOL_CAN_RAW, CAN_RAW_FILTER, &filter, sizeof(filter))<0
+	 || ioctl(fd, SIOCGIFINDEX, &ifr)<0
+	 || (addr.can_ifindex = ifr.ifr_ifindex, bind(fd, (struct sockaddr *)&addr, sizeof(addr)))<0
+	 || fcntl(fd, F_SETFL, O_NONBLOCK)<0 )
+	{
+		PRINTF("socketcan: %s: %s\n", ifname, strerror(errno));
+		close(fd);
+		return;
+	}
+	aospi_socketcan_fd = fd;
+}
+
+
+// Writes a CAN-FD frame with payload `data` of `size` bytes (zero padded).
+static aoresult_t aospi_socketcan_write(const uint8_t * data, int size)
+{
+	struct canfd_frame frame;
+	memset(&frame, 0, sizeof(frame));
+	frame.can_id = AOSPI_SOCKETCAN_TXID;
+	frame.flags  = CANFD_BRS;
+	frame.len    = (uint8_t)aospi_frame_dlc2size(aospi_frame_size2dlc(size < AOSPI_SOCKETCAN_MINSIZE ? AOSPI_SOCKETCAN_MINSIZE : size));
+	memcpy(frame.data, data, size);
+	if( aospi_socketcan_fd<0 ) return aoresult_spi_noclock;
+	if( write(aospi_socketcan_fd, &frame, CANFD_MTU)!=CANFD_MTU ) return aoresult_spi_noclock;
+	return aoresult_ok;
+}
+
+
+// Completes the request with tag `tag`, that awaited a response.
+static void aospi_socketcan_finish(int tag, aoresult_t result)
+{
+	aospi_req_t * req = aospi_socketcan_req[tag];
+	aospi_socketcan_req[tag] = 0;
+	aospi_socketcan_outstanding--;
+	// Advance oldest over the tags that are no longer outstanding
+	while( aospi_socketcan_outstanding>0 && aospi_socketcan_req[aospi_socketcan_oldest]==0 )
+		aospi_socketcan_oldest = (aospi_socketcan_oldest + 1) % AOSPI_FRAME_TAGCOUNT;
+	aospi_req_complete(req, result);
+}
+
+
+// Sends a request without response (aospi_backend_socketcan.tx).
+static aoresult_t aospi_socketcan_tx(aospi_req_t * req)
+{
+	req->t0 = aospi_socketcan_now();
+	aoresult_t result = aospi_socketcan_write(req->tx, req->txsize);
+	if( result==aoresult_ok ) aospi_req_sent(req);
+	req->us = aospi_socketcan_now() - req->t0;
+	aospi_req_complete(req, result);
+	return aoresult_ok;
+}
+
+
+static void aospi_socketcan_poll(void);
+
+
+// Sends a request in a tagged frame; poll completes it (aospi_backend_socketcan.txrx).
+static aoresult_t aospi_socketcan_txrx(aospi_req_t * req)
+{
+	// All tags in use: wait for the oldest (poll expires it if need be)
+	while( aospi_socketcan_req[aospi_socketcan_next]!=0 ) aospi_socketcan_poll();
+	int tag = aospi_socketcan_next;
+	req->tag = (uint8_t)tag;
+	aospi_socketcan_req[tag] = req;
+	if( aospi_socketcan_outstanding==0 ) aospi_socketcan_oldest = tag;
+	aospi_socketcan_outstanding++;
+	aospi_socketcan_next = (aospi_socketcan_next + 1) % AOSPI_FRAME_TAGCOUNT;
+
+	uint8_t frame[AOSPI_FRAME_MAXSIZE];
+	int     size;
+	aospi_frame_settag(frame, &size, tag);
+	aospi_frame_add(frame, &size, req->tx, req->txsize);
+	req->t0 = aospi_socketcan_now();
+	aoresult_t result = aospi_socketcan_write(frame, size);
+	if( result!=aoresult_ok ) aospi_socketcan_finish(tag, result);
+	else aospi_req_sent(req);
+	return aoresult_ok;
+}
+
+
+// Reads the received frames, completing their requests; expires overdue requests (aospi_backend_socketcan.poll).
+static void aospi_socketcan_poll(void)
+{
+	struct canfd_frame frame;
+	while( aospi_socketcan_fd>=0 && read(aospi_socketcan_fd, &frame, sizeof(frame))>0 )
+	{
+		const uint8_t * tele = frame.data;
+		int             telesize = frame.len;
+		int             tag = aospi_frame_gettag(frame.data, frame.len);
+		if( tag>=0 )
+		{
+			int pos = 1;
+			if( !aospi_frame_next(frame.data, frame.len, &pos, &tele, &telesize) ) continue; // malformed
+		}
+		else
+		{
+			tag = aospi_socketcan_oldest; // untagged: oldest outstanding request
+		}
+		aospi_req_t * req = aospi_socketcan_req[tag];
+		if( aospi_socketcan_outstanding==0 || req==0 ) continue; // not expected (eg response after timeout)
+		memcpy(req->rx, tele, telesize < req->rxsize ? telesize : req->rxsize);
+		aospi_socketcan_lastrx = aospi_socketcan_now();
+		req->us = aospi_socketcan_lastrx - req->t0;
+		aospi_req_received(req, telesize);
+		aospi_socketcan_finish(tag, aoresult_ok);
+	}
+	// Response of the oldest outstanding request overdue?
+	if( aospi_socketcan_outstanding>0 )
+	{
+		aospi_req_t * req = aospi_socketcan_req[aospi_socketcan_oldest];
+		uint32_t now = aospi_socketcan_now();
+		uint32_t since = req->t0;
+		if( (int32_t)(aospi_socketcan_lastrx - since) > 0 ) since = aospi_socketcan_lastrx;
+		if( now - since > aospi_timeout_get() )
+		{
+			aospi_socketcan_lastrx = now; // next one gets a full time-out
+			aospi_socketcan_finish(aospi_socketcan_oldest, aoresult_spi_noclock);
+		}
+	}
+}
+
+
+// Returns 1 iff no request awaits a response (aospi_backend_socketcan.idle).
+static int aospi_socketcan_idle(void)
+{
+	return aospi_socketcan_outstanding==0;
+}
+
+
+// The SocketCAN backend, see aospi_backend_t.
+const aospi_backend_t aospi_backend_socketcan = {
+  .name = "socketcan",
+  .chains = 1,
+  .init = aospi_socketcan_init,
+  .tx   = aospi_socketcan_tx,
+  .txrx = aospi_socketcan_txrx,
+  .poll = aospi_socketcan_poll,
+  .idle = aospi_socketcan_idle,
+};
+
+
+#endif
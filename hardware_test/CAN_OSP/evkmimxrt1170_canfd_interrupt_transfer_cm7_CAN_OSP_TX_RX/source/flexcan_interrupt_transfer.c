@@ -7,6 +7,7 @@
 #include "fsl_gpio.h"
 #include "fsl_common.h"
 #include "aospi.h"
+#include "aoosp_send.h"
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
@@ -26,49 +27,49 @@ void delay_micro(uint32_t us)
 }
 
 void tele_reset() {
-	const uint8_t reset[] = {0xA0, 0x00, 0x00, 0x22};
+	static const uint8_t reset[] = AOOSP_TELE_CONST0(0x000, 0x00); // RESET, CRC by the compiler
 	aoresult_t result = aospi_tx( reset, sizeof reset );
 	PRINTF("reset(0x000) %s\n", aoresult_to_str(result,1) );
 }
 
 
 void tele_initbidir() {
-  const uint8_t initbidir[] = {0xA0, 0x04, 0x02, 0xA9};
+  static const uint8_t initbidir[] = AOOSP_TELE_CONST0(0x001, 0x02); // INITBIDIR
   aoresult_t result = aospi_tx( initbidir, sizeof initbidir);
   PRINTF("initbidir(0x001) %s\n", aoresult_to_str(result,1) );
 }
 
 
 void tele_initloop() {
-  const uint8_t initloop[] = {0xA0, 0x04, 0x03, 0x86};
+  static const uint8_t initloop[] = AOOSP_TELE_CONST0(0x001, 0x03); // INITLOOP
   aoresult_t result = aospi_tx( initloop, sizeof initloop);
   PRINTF("initloop(0x001) %s\n", aoresult_to_str(result,1) );
 }
 
 
 void tele_clrerror() {
-  const uint8_t clrerror[] = {0xA0, 0x00, 0x01, 0x0D};
+  static const uint8_t clrerror[] = AOOSP_TELE_CONST0(0x000, 0x01); // CLRERROR
   aoresult_t result = aospi_tx( clrerror, sizeof clrerror);
   PRINTF("clrerror(0x000) %s\n", aoresult_to_str(result,1) );
 }
 
 
 void tele_goactive() {
-  const uint8_t goactive[] = {0xA0, 0x00, 0x05, 0xB1};
+  static const uint8_t goactive[] = AOOSP_TELE_CONST0(0x000, 0x05); // GOACTIVE
   aoresult_t result = aospi_tx( goactive, sizeof goactive);
   PRINTF("goactive(0x000) %s\n", aoresult_to_str(result,1) );
 }
 
 
 void tele_setpwmchn_hi() {
-  const uint8_t setpwmchn[] = {0xA0, 0x07, 0xCF, 0x00, 0xFF, 0x08, 0x88, 0x00, 0x11, 0x08, 0x88, 0x94};
+  static const uint8_t setpwmchn[] = AOOSP_TELE_CONST8(0x001, 0x4F, 0x00, 0xFF, 0x08, 0x88, 0x00, 0x11, 0x08, 0x88); // SETPWMCHN
   aoresult_t result = aospi_tx( setpwmchn, sizeof setpwmchn);
   PRINTF("setpwmchn(0x001,0,0x0888,0x0011,0x0888) %s\n", aoresult_to_str(result,1) );
 }
 
 
 void tele_setpwmchn_lo() {
-  const uint8_t setpwmchn[] = {0xA0, 0x07, 0xCF, 0x00, 0xFF, 0x00, 0x11, 0x08, 0x88, 0x00, 0x11, 0x17};
+  static const uint8_t setpwmchn[] = AOOSP_TELE_CONST8(0x001, 0x4F, 0x00, 0xFF, 0x00, 0x11, 0x08, 0x88, 0x00, 0x11); // SETPWMCHN
   aoresult_t result = aospi_tx( setpwmchn, sizeof setpwmchn);
   PRINTF("setpwmchn(0x001,0,0x0011,0x0888,0x0011) %s\n", aoresult_to_str(result,1) );
 }
@@ -80,7 +81,7 @@ int main(void)
     BOARD_BootClockRUN();
     BOARD_InitDebugConsole();
 
-    aospi_init(aospi_phy_mcua);
+    aospi_init(aospi_phy_mcua, &aospi_backend_flexcan);
 
 	tele_reset();
 	delay_micro(150000);
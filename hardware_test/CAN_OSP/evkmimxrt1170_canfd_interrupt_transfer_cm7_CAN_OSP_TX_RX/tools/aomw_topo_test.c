@@ -0,0 +1,517 @@
+// aomw_topo_test.c - host test: aomw_topo on the virtual OSP chain of aospi (aospi_backend_sim)
+/*****************************************************************************
+ * Copyright 2024,2025 by ams OSRAM AG                                       *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <aoresult.h>     // aoresult_to_str
+#include <aospi.h>        // aospi_backend_sim, aospi_sim_xxx
+#include <aoosp.h>        // aoosp_send_readtempstat
+#include <aomw_topo.h>    // aomw_topo_build, aomw_topo_frame_begin
+#include <aocmd_cint.h>   // aocmd_cint_addstr
+
+
+// Runs aomw_topo.c (with the real aoosp code) against aospi_sim.c. The sim
+// nodes execute the telegrams, so the test inspects what each node shows.
+//
+// Build (on a PC, from this directory)
+//   make build/aomw_topo_test
+// Run
+//   build/aomw_topo_test
+//
+// Checks
+//   - frames: between aomw_topo_frame_begin() and _commit() the SAID
+//     triplets keep showing the old colors, after the commit they all show
+//     the new ones (no mixed frame); outside a frame, sync mode still
+//     shows a settriplet at once, and without sync mode nothing is held
+//   - grouping: every node shows its color after aomw_topo_setframe() and
+//     after a framebuffer flush (also via 'topo fb'), for flags, a running
+//     light and random frames; a flag takes 11 group and 5 unicast
+//     telegrams on a 141-node chain, and a steady picture no SETMULTs
+//   - build: on chains of 1000 SAIDs, 1000 RGBIs and a mix with I2C
+//     bridges, the map matches the chain (ids, triplets, bridges, all nodes
+//     active) and the build stays within its telegram budget per node; the
+//     telegrams and modelled link time per node are reported
+//   - cache: a warm build of an unchanged chain restores it from the cache,
+//     with the same map as a scan and all nodes active (1000 SAIDs: 20
+//     instead of 3012 telegrams); a changed chain, a cleared cache, or the
+//     cache off, scans again
+//   - framebuffer: every triplet shows the framebuffer after each flush; a
+//     flush sends only dirty triplets (none for an unchanged picture), in
+//     sync mode with one SYNC per chain; a failed flush or frame commit
+//     keeps the triplets dirty, so the next flush resends them; a new dim
+//     level, curve or white balance makes the next flush resend all
+//     triplets, even when the same colors are painted; a build clears the
+//     framebuffer
+
+
+static int test_fails;
+
+
+// Records a failed check
+static void test_check( int ok, const char * what ) {
+  if( !ok ) { printf("  FAIL %s\n", what); test_fails++; }
+}
+
+
+// Sets the sim chain to `nodes` (BiDir) and builds the topology map
+static void test_build( const char * nodes ) {
+  aoresult_t result = aospi_sim_chain_set(nodes, 0);
+  if( result==aoresult_ok ) result = aomw_topo_build();
+  printf("  chain of %d nodes, %d triplets: build %s\n", (int)strlen(nodes), aomw_topo_numtriplets(), aoresult_to_str(result,0));
+  test_check( result==aoresult_ok, "build" );
+}
+
+
+// === node state ===========================================================
+
+
+#define TEST_MAXTRIPLETS 3000
+
+
+// PWM settings shown by the triplets (SAID channels only; RGBIs have no sync mode)
+typedef struct test_pwms_s { uint16_t rgb[TEST_MAXTRIPLETS][3]; } test_pwms_t;
+
+
+// Reads from the sim what each SAID triplet shows into `pwms`
+static void test_pwms_get( test_pwms_t * pwms ) {
+  memset(pwms, 0, sizeof *pwms);
+  for( int tix=0; tix<aomw_topo_numtriplets(); tix++ ) {
+    if( !aomw_topo_triplet_onchan(tix) ) continue;
+    aospi_sim_pwm_get(aomw_topo_triplet_addr(tix), aomw_topo_triplet_chan(tix), pwms->rgb[tix]);
+  }
+}
+
+
+// Returns the number of SAID triplets that do not show what they show in `pwms`
+static int test_pwms_diff( const test_pwms_t * pwms ) {
+  static test_pwms_t now;
+  test_pwms_get(&now);
+  int diff = 0;
+  for( int tix=0; tix<aomw_topo_numtriplets(); tix++ ) diff += memcmp(now.rgb[tix], pwms->rgb[tix], sizeof now.rgb[tix])!=0;
+  return diff;
+}
+
+
+// Returns the number of triplets that do not show `rgbs` (linear curve, so gamma off, within 2 PWM steps)
+static int test_shows( const aomw_topo_rgb_t * rgbs ) {
+  int bad = 0;
+  int dim = aomw_topo_dim_get();
+  for( int tix=0; tix<aomw_topo_numtriplets(); tix++ ) {
+    int      onchan = aomw_topo_triplet_onchan(tix);
+    uint16_t rgb[3];
+    aospi_sim_pwm_get(aomw_topo_triplet_addr(tix), onchan ? aomw_topo_triplet_chan(tix) : 0, rgb);
+    int want[3] = { rgbs[tix].r*dim/1024, rgbs[tix].g*dim/1024, rgbs[tix].b*dim/1024 };
+    int wrong = 0;
+    for( int c=0; c<3; c++ ) wrong |= abs(rgb[c] - (onchan ? want[c]<<1 : want[c])) > 2; // a SAID has 16 bit PWM
+    bad += wrong;
+  }
+  return bad;
+}
+
+
+// === frames ===============================================================
+
+
+// Checks that a frame shows all its triplet updates at once
+static void test_frames( void ) {
+  static aomw_topo_rgb_t colsA[TEST_MAXTRIPLETS], colsB[TEST_MAXTRIPLETS];
+  static test_pwms_t     pwmsA, pwmsB;
+  printf("frames\n");
+  test_build("SRRISSSRSRSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSSS");
+  int n = aomw_topo_numtriplets();
+  for( int tix=0; tix<n; tix++ ) {
+    colsA[tix] = (aomw_topo_rgb_t){ 0x1000, 0x1000, (uint16_t)(0x100*(tix%16)), 0 };
+    colsB[tix] = (aomw_topo_rgb_t){ 0x2000, (uint16_t)(0x200*(tix%16)), 0x2000, 0 };
+  }
+
+  // What A and B look like on the nodes, set without sync mode
+  test_check( aomw_topo_sync_get()==0, "build ends sync mode" );
+  aomw_topo_settriplets(0, n, colsB);
+  test_pwms_get(&pwmsB);
+  aomw_topo_settriplets(0, n, colsA);
+  test_pwms_get(&pwmsA);
+  int diffAB = test_pwms_diff(&pwmsB);
+  printf("  without sync: A and B differ on %d triplets\n", diffAB);
+  test_check( diffAB>0, "A and B differ" );
+
+  // In a frame, the updates (in chunks, and one single) stay pending
+  aoresult_t result = aomw_topo_frame_begin();
+  test_check( result==aoresult_ok && aomw_topo_sync_get(), "begin switches sync mode on" );
+  int mixed = 0;
+  for( int tix=0; tix<n; tix+=7 ) {
+    result |= aomw_topo_settriplets(tix, tix+7<=n ? 7 : n-tix, &colsB[tix]);
+    mixed += test_pwms_diff(&pwmsA);
+  }
+  result |= aomw_topo_settriplet(1, &colsB[1]);
+  mixed += test_pwms_diff(&pwmsA);
+  printf("  in frame: %d triplets showed B early\n", mixed);
+  test_check( result==aoresult_ok && mixed==0, "in frame" );
+  result = aomw_topo_frame_commit();
+  int notB = test_pwms_diff(&pwmsB);
+  printf("  commit %s: %d triplets not on B\n", aoresult_to_str(result,0), notB);
+  test_check( result==aoresult_ok && notB==0, "commit" );
+
+  // Sync mode outside a frame: settriplet(s) sync themselves
+  aomw_topo_settriplets(0, n, colsA);
+  test_check( test_pwms_diff(&pwmsA)==0, "sync mode, settriplets" );
+  aomw_topo_settriplet(2, &colsB[2]);
+  uint16_t rgb[3];
+  aospi_sim_pwm_get(aomw_topo_triplet_addr(2), aomw_topo_triplet_chan(2), rgb);
+  test_check( memcmp(rgb, pwmsB.rgb[2], sizeof rgb)==0, "sync mode, settriplet" );
+  test_check( aomw_topo_frame_commit()!=aoresult_ok, "commit without begin" );
+
+  // Sync mode off: nothing is held
+  aomw_topo_sync_set(0);
+  aomw_topo_settriplets(0, n, colsB);
+  test_check( test_pwms_diff(&pwmsB)==0, "sync off" );
+  printf("  %d telegrams dropped by the nodes\n", aospi_sim_dropcount_get());
+  test_check( aospi_sim_dropcount_get()==0, "no drops" );
+}
+
+
+// === grouping =============================================================
+
+
+static aomw_topo_rgb_t test_cols[TEST_MAXTRIPLETS];
+
+
+// Fills test_cols with three vertical bands in colors `c0`, `c1` and `c2`
+static void test_bands( aomw_topo_rgb_t c0, aomw_topo_rgb_t c1, aomw_topo_rgb_t c2 ) {
+  int n = aomw_topo_numtriplets();
+  for( int tix=0; tix<n; tix++ ) test_cols[tix] = tix*3/n==0 ? c0 : tix*3/n==1 ? c1 : c2;
+}
+
+
+// Reports the telegrams of the last frame; returns 1 iff all triplets show test_cols and the telegram counts are as given (-1 for don't care)
+static int test_frame_is( const char * what, int groupcasts, int unicasts, int setmults ) {
+  int g, u, m;
+  aomw_topo_setframe_stats(&g, &u, &m);
+  int bad = test_shows(test_cols);
+  printf("  %-14s %3d wrong, %2d group, %3d unicast, %3d setmult\n", what, bad, g, u, m);
+  return bad==0 && (groupcasts<0 || g==groupcasts) && (unicasts<0 || u==unicasts) && (setmults<0 || m==setmults);
+}
+
+
+// Checks the multicast group planner, via aomw_topo_setframe() and the framebuffer
+static void test_grouping( void ) {
+  printf("grouping\n");
+  // 60 SAIDs, an I2C bridge, 60 RGBIs, and 20 alternating: 141 nodes, 282 triplets
+  char nodes[142];
+  int  k = 0;
+  for( int i=0; i<60; i++ ) nodes[k++] = 'S';
+  nodes[k++] = 'I';
+  for( int i=0; i<60; i++ ) nodes[k++] = 'R';
+  for( int i=0; i<20; i++ ) nodes[k++] = i&1 ? 'S' : 'R';
+  nodes[k] = 0;
+  test_build(nodes);
+  int n = aomw_topo_numtriplets();
+
+  test_bands(aomw_topo_blue, aomw_topo_white, aomw_topo_red);
+  aomw_topo_setframe(test_cols);
+  test_check( test_frame_is("france", 11, 5, -1), "france" );
+  aomw_topo_setframe(test_cols);
+  test_check( test_frame_is("france again", 11, 5, 0), "france again" );
+  test_bands(aomw_topo_off, aomw_topo_red, aomw_topo_yellow);
+  aomw_topo_setframe(test_cols);
+  test_check( test_frame_is("germany", 11, 5, 0), "germany" );
+  for( int i=0; i<5; i++ ) {
+    for( int tix=0; tix<n; tix++ ) test_cols[tix] = aomw_topo_off;
+    test_cols[(i*37)%n] = aomw_topo_white;
+    aomw_topo_setframe(test_cols);
+    test_check( test_frame_is("running light", -1, -1, 0), "running light" );
+  }
+  srand(1);
+  for( int i=0; i<3; i++ ) {
+    for( int tix=0; tix<n; tix++ ) test_cols[tix] = (aomw_topo_rgb_t){ rand()&0x7FFF, rand()&0x7FFF, rand()&0x7FFF, 0 };
+    aomw_topo_setframe(test_cols);
+    test_check( test_frame_is("random", 0, n, -1), "random" );
+  }
+  aomw_topo_frame_begin();
+  test_bands(aomw_topo_off, aomw_topo_red, aomw_topo_yellow);
+  aomw_topo_setframe(test_cols);
+  aomw_topo_frame_commit();
+  test_check( test_frame_is("in a frame", 11, 5, -1), "in a frame" );
+
+  // The framebuffer runs the planner for the dirty triplets only
+  int saved;
+  test_bands(aomw_topo_blue, aomw_topo_white, aomw_topo_red);
+  for( int tix=0; tix<n; tix++ ) aomw_topo_fb_set(tix, &test_cols[tix]);
+  aomw_topo_fb_flush(&saved);
+  test_check( test_frame_is("fb france", 11, 5, -1), "fb france" );
+  for( int tix=0; tix<n; tix+=9 ) { test_cols[tix] = aomw_topo_green; aomw_topo_fb_set(tix, &test_cols[tix]); }
+  aomw_topo_fb_flush(&saved);
+  test_check( test_frame_is("fb every 9th", -1, -1, -1), "fb every 9th" );
+  for( int tix=10; tix<n/3; tix++ ) { test_cols[tix] = aomw_topo_magenta; aomw_topo_fb_set(tix, &test_cols[tix]); }
+  aomw_topo_fb_flush(&saved);
+  test_check( test_frame_is("fb magenta run", -1, -1, -1), "fb magenta run" );
+
+  // Same via the command interpreter: 'topo fb <tix1> <tix2> <r> <g> <b>', then 'topo fb' flushes
+  char cmd[80];
+  for( int tix=0; tix<n; tix++ ) test_cols[tix] = tix<n/2 ? aomw_topo_cyan : aomw_topo_magenta;
+  snprintf(cmd, sizeof cmd, "@topo fb 0 %d %04X %04X %04X\n", n/2-1, aomw_topo_cyan.r, aomw_topo_cyan.g, aomw_topo_cyan.b);
+  aocmd_cint_addstr(cmd);
+  snprintf(cmd, sizeof cmd, "@topo fb %d %d %04X %04X %04X\n", n/2, n-1, aomw_topo_magenta.r, aomw_topo_magenta.g, aomw_topo_magenta.b);
+  aocmd_cint_addstr(cmd);
+  aocmd_cint_addstr("topo fb\n");
+  printf("\n"); // after the prompt
+  test_check( test_frame_is("'topo fb'", -1, -1, -1), "topo fb" );
+
+  printf("  %d telegrams dropped by the nodes\n", aospi_sim_dropcount_get());
+  test_check( aospi_sim_dropcount_get()==0, "no drops" );
+}
+
+
+// === build ================================================================
+
+
+// Returns the number of nodes whose map entry or state does not match `nodes` (as given to aospi_sim_chain_set)
+static int test_map( const char * nodes ) {
+  int n = (int)strlen(nodes);
+  int bad = aomw_topo_numnodes()!=n;
+  int bridges = 0;
+  for( int addr=1; addr<=n && !bad; addr++ ) {
+    char    kind = nodes[addr-1];
+    uint8_t temp, stat;
+    int     ok = aomw_topo_node_id(addr)==(kind=='R' ? 0x00000000 : 0x00000040);
+    ok = ok && aomw_topo_node_numtriplets(addr)==(kind=='R' ? 1 : kind=='S' ? 3 : 2); // a bridge takes channel 2
+    ok = ok && aoosp_send_readtempstat(addr, &temp, &stat)==aoresult_ok && (stat>>6)==2; // active
+    if( kind=='I' ) ok = ok && bridges<aomw_topo_numi2cbridges() && aomw_topo_i2cbridge_addr(bridges++)==addr;
+    bad += !ok;
+  }
+  return bad + (aomw_topo_numi2cbridges()!=bridges);
+}
+
+
+// Scans chain `nodes` (cache off); checks the map and that the build takes at most `maxpernode` telegrams per node
+static void test_bench( const char * what, const char * nodes, double maxpernode ) {
+  int n = (int)strlen(nodes);
+  aomw_topo_store_set(0);
+  aoresult_t result = aospi_sim_chain_set(nodes, 0);
+  aospi_txcount_reset();
+  uint64_t t0 = aospi_sim_time_us();
+  if( result==aoresult_ok ) result = aomw_topo_build();
+  int      tx = aospi_txcount_get();
+  uint64_t us = aospi_sim_time_us() - t0;
+  aomw_topo_store_set(&aomw_topo_store_ram);
+  int bad = test_map(nodes);
+  printf("  %-10s %s, %d wrong, %5d telegrams (%.2f per node), modelled %.1f ms per node\n", what, aoresult_to_str(result,0), bad, tx, (double)tx/n, us/1000.0/n);
+  test_check( result==aoresult_ok && bad==0, what );
+  test_check( tx<=maxpernode*n, "telegrams per node" );
+}
+
+
+// Checks the topology build on large chains, and reports its cost
+static void test_build_bench( void ) {
+  static char nodes[1001];
+  printf("build\n");
+  memset(nodes, 'S', 1000); nodes[1000] = 0;
+  test_bench("SAIDs", nodes, 3.1);
+  memset(nodes, 'R', 1000);
+  test_bench("RGBIs", nodes, 1.1);
+  for( int i=0; i<1000; i++ ) nodes[i] = i%50==7 ? 'I' : i%3==0 ? 'R' : 'S';
+  test_bench("mixed", nodes, 4.5);
+  printf("  %d telegrams dropped by the nodes\n", aospi_sim_dropcount_get());
+  test_check( aospi_sim_dropcount_get()==0, "no drops" );
+}
+
+
+// === cache ================================================================
+
+
+// Returns a hash of the map (nodes, triplets and bridges)
+static uint32_t test_maphash( void ) {
+  uint32_t h = aomw_topo_numnodes();
+  for( int addr=1; addr<=aomw_topo_numnodes(); addr++ ) h = h*31 + aomw_topo_node_id(addr), h = h*31 + aomw_topo_node_numtriplets(addr), h = h*31 + aomw_topo_node_triplet1(addr);
+  for( int tix=0; tix<aomw_topo_numtriplets(); tix++ ) h = h*31 + aomw_topo_triplet_addr(tix), h = h*31 + (aomw_topo_triplet_onchan(tix) ? aomw_topo_triplet_chan(tix) : 9);
+  for( int bix=0; bix<aomw_topo_numi2cbridges(); bix++ ) h = h*31 + aomw_topo_i2cbridge_addr(bix);
+  return h;
+}
+
+
+// Builds chain `nodes` (cache as set); returns the map hash, and in `tx` and `us` the telegrams and modelled link time
+static uint32_t test_cached( const char * what, const char * nodes, int hits, int * tx, uint64_t * us ) {
+  aoresult_t result = aospi_sim_chain_set(nodes, 0);
+  aospi_txcount_reset();
+  uint64_t t0 = aospi_sim_time_us();
+  if( result==aoresult_ok ) result = aomw_topo_build();
+  *tx = aospi_txcount_get();
+  *us = aospi_sim_time_us() - t0;
+  int bad = test_map(nodes);
+  printf("  %-12s %s, %d wrong, %d hits, %5d telegrams, modelled %7.3f s\n", what, aoresult_to_str(result,0), bad, aomw_topo_cache_hits(), *tx, *us/1e6);
+  test_check( result==aoresult_ok && bad==0 && aomw_topo_cache_hits()==hits, what );
+  return test_maphash();
+}
+
+
+// Checks that the topology cache restores unchanged chains, and only those
+static void test_cache( void ) {
+  static char nodes[1001];
+  int         txcold, txwarm, tx;
+  uint64_t    uscold, uswarm, us;
+  printf("cache\n");
+  aomw_topo_cache_clear();
+  memset(nodes, 'S', 1000); nodes[1000] = 0;
+  uint32_t cold = test_cached("SAIDs cold", nodes, 0, &txcold, &uscold);
+  uint32_t warm = test_cached("SAIDs warm", nodes, 1, &txwarm, &uswarm);
+  test_check( warm==cold, "warm map equals scanned map" );
+  test_check( txwarm*10<txcold && uswarm*10<uscold, "warm build sends few telegrams" );
+  for( int i=0; i<1000; i++ ) nodes[i] = i%50==7 ? 'I' : i%3==0 ? 'R' : 'S';
+  cold = test_cached("mixed cold", nodes, 0, &tx, &us);
+  warm = test_cached("mixed warm", nodes, 1, &tx, &us);
+  test_check( warm==cold, "warm mixed map equals scanned map" );
+  nodes[999] = nodes[999]=='S' ? 'R' : 'S'; // the last node is always sampled
+  test_cached("mixed change", nodes, 0, &tx, &us);
+  nodes[999] = 0;
+  test_cached("shorter", nodes, 0, &tx, &us);
+  aomw_topo_cache_clear();
+  test_cached("cleared", nodes, 0, &tx, &us);
+  aomw_topo_store_set(0);
+  test_cached("off", nodes, 0, &tx, &us);
+  aomw_topo_store_set(&aomw_topo_store_ram); // the image saved by the scan after the clear
+  test_cached("on", nodes, 1, &tx, &us);
+  printf("  %d telegrams dropped by the nodes\n", aospi_sim_dropcount_get());
+  test_check( aospi_sim_dropcount_get()==0, "no drops" );
+}
+
+
+// === framebuffer ==========================================================
+
+
+// Flushes the framebuffer; returns 1 iff the flush ends with `want`, sends at most `maxpwm` PWM telegrams (none at all for 0), and all triplets show test_cols
+static int test_flush( const char * what, aoresult_t want, int maxpwm ) {
+  int saved, g, u, m;
+  aospi_txcount_reset();
+  aoresult_t result = aomw_topo_fb_flush(&saved);
+  int tx = aospi_txcount_get();
+  aomw_topo_setframe_stats(&g, &u, &m);
+  int bad = test_shows(test_cols);
+  printf("  %-14s %s, %3d wrong, %3d telegrams (%2d group, %3d unicast, %2d setmult), %3d saved\n", what, aoresult_to_str(result,0), bad, tx, g, u, m, saved);
+  return result==want && (maxpwm==0 ? tx==0 : g+u<=maxpwm) && (want!=aoresult_ok || bad==0);
+}
+
+
+// Sets triplet `tix` in the framebuffer and in test_cols to `rgb`
+static void test_fb_set( int tix, const aomw_topo_rgb_t * rgb ) {
+  test_cols[tix] = *rgb;
+  aomw_topo_fb_set(tix, rgb);
+}
+
+
+// Checks the dirty tracking of the framebuffer, also when a flush fails
+static void test_fb( void ) {
+  static char nodes[201];
+  printf("framebuffer\n");
+  for( int i=0; i<200; i++ ) nodes[i] = i%50==7 ? 'I' : i%3==0 ? 'R' : 'S';
+  nodes[200] = 0;
+  test_build(nodes);
+  int n = aomw_topo_numtriplets();
+  for( int tix=0; tix<n; tix++ ) test_cols[tix] = aomw_topo_off;
+
+  test_check( test_flush("empty", aoresult_ok, 0), "empty" );
+  for( int tix=0; tix<n; tix++ ) test_fb_set(tix, &aomw_topo_red);
+  test_check( test_flush("all red", aoresult_ok, n), "all red" );
+  for( int tix=0; tix<n; tix++ ) test_fb_set(tix, &aomw_topo_red);
+  test_check( test_flush("all red again", aoresult_ok, 0), "all red again" );
+  for( int tix=0; tix<n; tix+=10 ) test_fb_set(tix, &aomw_topo_blue);
+  test_check( test_flush("every 10th", aoresult_ok, (n+9)/10), "every 10th" );
+  aomw_topo_sync_set(1);
+  for( int tix=0; tix<n; tix+=7 ) test_fb_set(tix, &aomw_topo_green);
+  test_check( test_flush("sync every 7th", aoresult_ok, (n+6)/7+1), "sync every 7th" );
+  test_check( test_flush("sync unchanged", aoresult_ok, 0), "sync unchanged" );
+  aomw_topo_sync_set(0);
+  aomw_topo_fb_invalidate();
+  test_check( test_flush("invalidate", aoresult_ok, n), "invalidate" );
+
+  // A failed flush leaves its triplets dirty
+  for( int tix=0; tix<n; tix+=3 ) test_fb_set(tix, &aomw_topo_white);
+  aospi_sim_fail_set(1);
+  test_check( test_flush("failing", aoresult_spi_noclock, n), "failing flush" );
+  aospi_sim_fail_set(0);
+  test_check( test_flush("after failing", aoresult_ok, n), "flush after failing" );
+
+  // In a frame the commit checks the posted telegrams; a failed commit makes the whole framebuffer dirty
+  aomw_topo_frame_begin();
+  for( int tix=1; tix<n; tix+=3 ) test_fb_set(tix, &aomw_topo_cyan);
+  aomw_topo_fb_flush(0);
+  aoresult_t result = aomw_topo_frame_commit();
+  test_check( result==aoresult_ok && test_shows(test_cols)==0, "frame" );
+  aomw_topo_frame_begin();
+  for( int tix=2; tix<n; tix+=3 ) test_fb_set(tix, &aomw_topo_magenta);
+  aomw_topo_fb_flush(0);
+  aospi_sim_fail_set(1000);
+  result = aomw_topo_frame_commit();
+  aospi_sim_fail_set(0);
+  printf("  failing commit %s\n", aoresult_to_str(result,0));
+  test_check( result!=aoresult_ok, "failing commit" );
+  aomw_topo_sync_set(0);
+  test_check( test_flush("after commit", aoresult_ok, n), "flush after failing commit" );
+
+  // A new dim level (curve, white balance) changes the PWM values: repainting the same colors sends all triplets again
+  int dim = aomw_topo_dim_get();
+  for( int tix=0; tix<n; tix++ ) test_fb_set(tix, &test_cols[tix]);
+  test_check( test_flush("same colors", aoresult_ok, 0), "same colors" );
+  aomw_topo_dim_set(dim/2);
+  for( int tix=0; tix<n; tix++ ) test_fb_set(tix, &test_cols[tix]);
+  int g, u;
+  test_check( test_flush("dim halved", aoresult_ok, n), "dim halved" );
+  aomw_topo_setframe_stats(&g, &u, 0);
+  test_check( g+u>0, "dim change sends telegrams" );
+  aomw_topo_dim_set(dim);
+  test_check( test_flush("dim back", aoresult_ok, n), "dim back" );
+  aomw_topo_wb_set(1024, 1024, 512);
+  aospi_txcount_reset();
+  aomw_topo_fb_flush(0);
+  test_check( aospi_txcount_get()>0, "white balance change sends telegrams" );
+  aomw_topo_wb_set(1024, 1024, 1024);
+  aomw_topo_gamma_set(1);
+  aospi_txcount_reset();
+  aomw_topo_fb_flush(0);
+  test_check( aospi_txcount_get()>0, "curve change sends telegrams" );
+  aomw_topo_gamma_set(0);
+  test_check( test_flush("linear again", aoresult_ok, n), "linear again" );
+
+  // A build switches all triplets off, and clears the framebuffer
+  test_build(nodes);
+  aomw_topo_rgb_t rgb;
+  int lit = 0;
+  for( int tix=0; tix<n; tix++ ) { aomw_topo_fb_get(tix, &rgb); lit += rgb.r || rgb.g || rgb.b; test_cols[tix] = aomw_topo_off; }
+  test_check( lit==0 && test_flush("after build", aoresult_ok, 0), "build clears" );
+  printf("  %d telegrams dropped by the nodes\n", aospi_sim_dropcount_get());
+  test_check( aospi_sim_dropcount_get()==0, "no drops" );
+}
+
+
+int main( void ) {
+  aospi_init(aospi_phy_mcub, &aospi_backend_sim);
+  aocmd_cint_init();
+  aomw_topo_cmd_register();
+  // test_shows() expects the linear curve, which is the default
+  test_check( aomw_topo_gamma_get()==0, "linear curve by default" );
+
+  test_frames();
+  test_grouping();
+  test_build_bench();
+  test_cache();
+  test_fb();
+
+  printf("%s\n", test_fails ? "FAIL" : "PASS");
+  return test_fails ? 1 : 0;
+}
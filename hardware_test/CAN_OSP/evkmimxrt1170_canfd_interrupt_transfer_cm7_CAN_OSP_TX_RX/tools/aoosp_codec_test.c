@@ -0,0 +1,196 @@
+// aoosp_codec_test.c - host test: the response validator of aoosp_send.c against a reference checker
+/*****************************************************************************
+ * Copyright 2024,2025 by ams OSRAM AG                                       *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+// The codec is internal to aoosp_send.c (static), so the test includes it
+#include "../osp_aospi/aoosp/aoosp_send.c"
+
+
+// Fuzzes aoosp_codec_validate() and aoosp_codec_decode() against a
+// reference: the checks one at a time (in the order of the error codes),
+// and the fields extracted bit by bit, as aoosp did before the fused
+// validator.
+//
+// Build (on a PC, from this directory)
+//   make build/aoosp_codec_test
+// Run
+//   build/aoosp_codec_test
+//
+// Checks, for every telegram with a response, on random responses that are
+// correct or have a flipped bit, a random size, a damaged header with a
+// good CRC, or random bytes
+//   - the validator accepts and rejects exactly like the reference, with
+//     the same error code
+//   - on accepted responses, the decoded fields and header (address, TID)
+//     equal the reference
+// and reports ns per accepted READTEMPSTAT response for both (host timing).
+
+
+static int test_fails;
+
+
+// Records a failed check
+static void test_check( int ok, const char * what ) {
+  if( !ok ) { printf("  FAIL %s\n", what); test_fails++; }
+}
+
+
+// Returns a pseudo random number (xorshift64), the same sequence on every run
+static uint32_t test_rand( void ) {
+  static uint64_t x = 88172645463325252ULL;
+  x ^= x<<13; x ^= x>>7; x ^= x<<17;
+  return (uint32_t)x;
+}
+
+
+// === reference ============================================================
+
+
+// Checks response `tele` of telegram `ix` one property at a time
+static aoresult_t test_ref_check( const aoosp_tele_t * tele, aoosp_ix_t ix ) {
+  const aoosp_desc_t * desc = &aoosp_desc[ix];
+  uint8_t payloadsize = desc->resp->payloadsize;
+  if( tele->size!=4+payloadsize                ) return aoresult_osp_size;
+  if( TELEPSI(tele)!=SIZE2PSI(payloadsize)     ) return aoresult_osp_psi;
+  if( BITS_SLICE(tele->data[0],4,8)!=0xA       ) return aoresult_osp_preamble;
+  if( BITS_SLICE(tele->data[2],0,7)!=desc->tid ) return aoresult_osp_tid;
+  if( aoosp_crc(tele->data,tele->size)!=0      ) return aoresult_osp_crc;
+  return aoresult_ok;
+}
+
+
+// Extracts the fields of `layout` from `tele` into `res`, bit by bit
+static void test_ref_fields( const aoosp_tele_t * tele, const aoosp_layout_t * layout, uint32_t * res ) {
+  for( int i=0; i<layout->numfields; i++ ) res[layout->fields[i].arg] = 0;
+  for( int i=0; i<layout->numfields; i++ ) {
+    const aoosp_field_t * f = &layout->fields[i];
+    uint32_t val = 0;
+    for( int bit=0; bit<f->width; bit++ ) {
+      int pos = f->pos + bit;
+      val = val<<1 | ((tele->data[pos/8] >> (7-pos%8)) & 1);
+    }
+    res[f->arg] |= val << f->lo;
+  }
+}
+
+
+// === fuzz =================================================================
+
+
+#define TEST_RUNS 100000 // per telegram
+
+
+// Returns a response of telegram `ix`, correct or damaged as per `mode` (0..7)
+static void test_response( aoosp_ix_t ix, int mode, aoosp_tele_t * tele ) {
+  const aoosp_desc_t * desc = &aoosp_desc[ix];
+  uint8_t payloadsize = desc->resp->payloadsize;
+  memset(tele, 0, sizeof *tele);
+  aoosp_codec_begin(tele, desc->tid, test_rand()&0x3FF, payloadsize);
+  for( int i=0; i<payloadsize; i++ ) tele->data[3+i] = (uint8_t)test_rand();
+  aoosp_codec_end(tele);
+  if( mode==1 ) { // a flipped bit
+    tele->data[test_rand()%tele->size] ^= 1<<(test_rand()%8);
+  } else if( mode==2 ) { // random bytes, random size
+    tele->size = test_rand()%13;
+    for( int i=0; i<12; i++ ) tele->data[i] = (uint8_t)test_rand();
+  } else if( mode==3 ) { // a damaged header, with a good CRC
+    tele->data[test_rand()%3] ^= 1<<(test_rand()%8);
+    tele->data[tele->size-1] = aoosp_crc(tele->data, tele->size-1);
+  } else if( mode==4 ) { // another size
+    tele->size = 4 + test_rand()%9;
+  } // else correct
+}
+
+
+// Compares validator and decoder with the reference on random responses
+static void test_fuzz( void ) {
+  long count = 0, accepted = 0, decisions = 0, fields = 0;
+  for( int ix=0; ix<(int)(sizeof aoosp_desc/sizeof aoosp_desc[0]); ix++ ) {
+    const aoosp_desc_t * desc = &aoosp_desc[ix];
+    if( desc->resp==0 ) continue;
+    for( int run=0; run<TEST_RUNS; run++ ) {
+      aoosp_tele_t tele;
+      aoosp_hdr_t  hdr;
+      test_response(ix, test_rand()%8, &tele);
+      aoresult_t want = test_ref_check(&tele, ix);
+      aoresult_t got = aoosp_codec_validate(&tele, ix, &hdr);
+      count++;
+      if( got!=want ) { if( decisions++<5 ) printf("  telegram %02X: %s, reference %s\n", desc->tid, aoresult_to_str(got,0), aoresult_to_str(want,0)); continue; }
+      if( want!=aoresult_ok ) continue;
+      accepted++;
+      // The fields; 'last' of INIT is the header address
+      uint32_t res1[8] = {0}, res2[8] = {0};
+      test_ref_fields(&tele, desc->resp, res1);
+      if( ix==AOOSP_IX_INITBIDIR || ix==AOOSP_IX_INITLOOP ) res1[0] = BITS_SLICE(AOOSP_HDR_WORD(&tele),10,20);
+      aoresult_t result = aoosp_codec_decode(&tele, ix, res2, &hdr);
+      if( ix==AOOSP_IX_INITBIDIR || ix==AOOSP_IX_INITLOOP ) res2[0] = hdr.addr;
+      if( result!=aoresult_ok || memcmp(res1,res2,sizeof res1)!=0 || hdr.addr!=BITS_SLICE(AOOSP_HDR_WORD(&tele),10,20) || hdr.tid!=desc->tid ) {
+        if( fields++<5 ) printf("  telegram %02X: fields differ\n", desc->tid);
+      }
+    }
+  }
+  printf("  %ld responses, %ld accepted: %ld decisions and %ld field sets differ\n", count, accepted, decisions, fields);
+  test_check( decisions==0, "decisions" );
+  test_check( fields==0, "fields" );
+  test_check( accepted>0 && accepted<count, "both accepted and rejected responses" );
+}
+
+
+// === benchmark ============================================================
+
+
+// Returns the time in ns
+static double test_ns( void ) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+
+// Reports ns per accepted READTEMPSTAT response, for the reference and the validator
+static void test_bench( void ) {
+  aoosp_tele_t tele;
+  aoosp_codec_begin(&tele, aoosp_desc[AOOSP_IX_READTEMPSTAT].tid, 5, 2);
+  tele.data[3] = 0x74;
+  tele.data[4] = 0x80;
+  aoosp_codec_end(&tele);
+  volatile int sink = 0;
+  const int    runs = 10000000;
+  double t0 = test_ns();
+  for( int i=0; i<runs; i++ ) { sink += test_ref_check(&tele, AOOSP_IX_READTEMPSTAT); __asm__ volatile("" :: "r"(&tele) : "memory"); }
+  double t1 = test_ns();
+  for( int i=0; i<runs; i++ ) { sink += aoosp_codec_validate(&tele, AOOSP_IX_READTEMPSTAT, 0); __asm__ volatile("" :: "r"(&tele) : "memory"); }
+  double t2 = test_ns();
+  printf("  READTEMPSTAT response: reference %.1f ns, validator %.1f ns\n", (t1-t0)/runs, (t2-t1)/runs);
+  test_check( sink==0, "benchmark responses accepted" );
+}
+
+
+int main( void ) {
+  printf("fuzz (reference checker)\n");
+  test_fuzz();
+  printf("benchmark (host)\n");
+  test_bench();
+
+  printf("%s\n", test_fails ? "FAIL" : "PASS");
+  return test_fails ? 1 : 0;
+}
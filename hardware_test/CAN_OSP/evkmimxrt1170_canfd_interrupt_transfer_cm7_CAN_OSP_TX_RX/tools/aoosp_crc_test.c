@@ -0,0 +1,222 @@
+// aoosp_crc_test.c - host test: aoosp_crc (slice-by-4) against a bitwise reference, plus a benchmark
+/*****************************************************************************
+ * Copyright 2024,2025 by ams OSRAM AG                                       *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <aoosp_crc.h>    // aoosp_crc, aoosp_crc_update, aoosp_crc_check_batch
+
+
+// Checks aoosp_crc.c against a bitwise reference of the OSP CRC (polynomial
+// 0x2F, initial value 0, no reflection, no final xor).
+//
+// Build (on a PC, from this directory)
+//   make build/aoosp_crc_test
+// Run
+//   build/aoosp_crc_test
+//
+// Checks
+//   - aoosp_crc_update from every CRC state, with every 2-byte input
+//   - aoosp_crc_update from every CRC state, with 4-byte inputs (the
+//     slice-by-4 step) whose first two bytes run over all values
+//   - aoosp_crc of random buffers of 0..64 bytes, and aoosp_crc_update
+//     continuing it from every split point
+//   - aoosp_crc_check_batch on good batches, one bad CRC at every
+//     position, and too short telegrams
+// and reports ns per telegram and MB/s, compared to the classic one table
+// lookup per byte (the aoosp_crc of before the slice-by-4 change). The
+// timings are of the host, not of the MCU.
+
+
+static int test_fails;
+
+
+// Records a failed check
+static void test_check( int ok, const char * what ) {
+  if( !ok ) { printf("  FAIL %s\n", what); test_fails++; }
+}
+
+
+// Returns a pseudo random number (xorshift32), the same sequence on every run
+static uint32_t test_rand( void ) {
+  static uint32_t x = 2463534242u;
+  x ^= x<<13; x ^= x>>17; x ^= x<<5;
+  return x;
+}
+
+
+// === references ===========================================================
+
+
+// Returns the OSP CRC of `size` bytes in `buf`, continuing from `crc`, bit by bit
+static uint8_t test_crc_bitwise( uint8_t crc, const uint8_t * buf, int size ) {
+  for( int i=0; i<size; i++ ) {
+    crc ^= buf[i];
+    for( int bit=0; bit<8; bit++ ) crc = crc&0x80 ? (uint8_t)(crc<<1)^0x2F : (uint8_t)(crc<<1);
+  }
+  return crc;
+}
+
+
+static uint8_t test_crc_table[256];
+
+
+// Fills the table of the classic byte-at-a-time CRC
+static void test_crc_table_init( void ) {
+  for( int b=0; b<256; b++ ) {
+    uint8_t byte = (uint8_t)b;
+    test_crc_table[b] = test_crc_bitwise(0, &byte, 1);
+  }
+}
+
+
+// Returns the OSP CRC of `size` bytes in `buf` with one table lookup per byte
+static uint8_t test_crc_bytewise( const uint8_t * buf, int size ) {
+  uint8_t crc = 0;
+  while( size-->0 ) crc = test_crc_table[crc ^ *buf++];
+  return crc;
+}
+
+
+// === equivalence ==========================================================
+
+
+// Checks aoosp_crc_update for every state with every 2-byte input, and with 4-byte inputs
+static void test_states( void ) {
+  long checks = 0, bad = 0;
+  for( int crc=0; crc<256; crc++ ) {
+    for( int w=0; w<0x10000; w++ ) {
+      uint8_t buf[4] = { (uint8_t)(w>>8), (uint8_t)w, (uint8_t)test_rand(), (uint8_t)test_rand() };
+      bad += aoosp_crc_update((uint8_t)crc, buf, 2) != test_crc_bitwise((uint8_t)crc, buf, 2);
+      bad += aoosp_crc_update((uint8_t)crc, buf, 4) != test_crc_bitwise((uint8_t)crc, buf, 4);
+      checks += 2;
+    }
+  }
+  printf("  every state, 2 and 4 byte inputs: %ld checks, %ld bad\n", checks, bad);
+  test_check( bad==0, "states" );
+}
+
+
+// Checks aoosp_crc on random buffers, and aoosp_crc_update continuing from every split point
+static void test_buffers( void ) {
+  long checks = 0, bad = 0;
+  for( int run=0; run<20000; run++ ) {
+    uint8_t buf[64];
+    int     size = run % 65;
+    for( int i=0; i<size; i++ ) buf[i] = (uint8_t)test_rand();
+    uint8_t crc = test_crc_bitwise(0, buf, size);
+    bad += aoosp_crc(buf, size) != crc;
+    checks++;
+    for( int split=0; split<=size; split++ ) {
+      bad += aoosp_crc_update(aoosp_crc_update(0, buf, split), buf+split, size-split) != crc;
+      checks++;
+    }
+  }
+  printf("  random buffers of 0..64 bytes, split at every point: %ld checks, %ld bad\n", checks, bad);
+  test_check( bad==0, "buffers" );
+}
+
+
+#define TEST_BATCH 16
+
+
+// Checks aoosp_crc_check_batch on good and bad batches of telegrams
+static void test_batch( void ) {
+  static uint8_t  teles[TEST_BATCH][12];
+  const uint8_t * ptrs[TEST_BATCH];
+  int             sizes[TEST_BATCH];
+  int             bad = 0;
+  for( int run=0; run<1000; run++ ) {
+    // A batch of telegrams of 4..12 bytes with correct CRC
+    for( int t=0; t<TEST_BATCH; t++ ) {
+      sizes[t] = 4 + test_rand()%9;
+      for( int i=0; i<sizes[t]-1; i++ ) teles[t][i] = (uint8_t)test_rand();
+      teles[t][sizes[t]-1] = test_crc_bitwise(0, teles[t], sizes[t]-1);
+      ptrs[t] = teles[t];
+    }
+    bad += aoosp_crc_check_batch(ptrs, sizes, TEST_BATCH) != TEST_BATCH;
+    // One flipped bit in telegram `pos`
+    int pos = run % TEST_BATCH;
+    int byte = test_rand() % sizes[pos];
+    uint8_t mask = (uint8_t)(1 << test_rand()%8);
+    teles[pos][byte] ^= mask;
+    bad += aoosp_crc_check_batch(ptrs, sizes, TEST_BATCH) != pos;
+    teles[pos][byte] ^= mask;
+    // A telegram too short to hold a header and CRC
+    int size = sizes[pos];
+    sizes[pos] = 3;
+    bad += aoosp_crc_check_batch(ptrs, sizes, TEST_BATCH) != pos;
+    sizes[pos] = size;
+  }
+  printf("  batches of %d telegrams, good, one bad CRC, one short: %d bad\n", TEST_BATCH, bad);
+  test_check( bad==0, "batch" );
+}
+
+
+// === benchmark ============================================================
+
+
+// Returns the time in ns
+static double test_ns( void ) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+
+static volatile uint8_t test_sink; // keeps the compiler from dropping the loops
+
+
+// Reports ns per telegram of `size` bytes, and MB/s for 64 byte blocks, for aoosp_crc and the bytewise reference
+static void test_bench( int size ) {
+  static uint8_t buf[4096];
+  for( int i=0; i<(int)sizeof buf; i++ ) buf[i] = (uint8_t)test_rand();
+  int    runs = 2000000;
+  int    slots = (int)sizeof buf / 64;
+  uint8_t acc = 0;
+  double t0 = test_ns();
+  for( int r=0; r<runs; r++ ) acc ^= test_crc_bytewise(buf + (r%slots)*64, size);
+  double t1 = test_ns();
+  for( int r=0; r<runs; r++ ) acc ^= aoosp_crc(buf + (r%slots)*64, size);
+  double t2 = test_ns();
+  test_sink = acc;
+  printf("  %2d bytes: bytewise %5.1f ns, aoosp_crc %5.1f ns, %4.0f vs %4.0f MB/s\n", size,
+    (t1-t0)/runs, (t2-t1)/runs, size*runs/(t1-t0)*1000, size*runs/(t2-t1)*1000);
+}
+
+
+int main( void ) {
+  test_crc_table_init();
+
+  printf("equivalence (bitwise reference)\n");
+  test_states();
+  test_buffers();
+  test_batch();
+
+  printf("benchmark (host, per call)\n");
+  test_bench(4);
+  test_bench(6);
+  test_bench(12);
+  test_bench(64);
+
+  printf("%s\n", test_fails ? "FAIL" : "PASS");
+  return test_fails ? 1 : 0;
+}
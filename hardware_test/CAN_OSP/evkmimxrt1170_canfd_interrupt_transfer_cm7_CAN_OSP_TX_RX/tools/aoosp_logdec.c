@@ -0,0 +1,363 @@
+// aoosp_logdec.c - host tool: decodes "#osplog" lines (aoosp log ring) into the aoosp log format
+/*****************************************************************************
+ * Copyright 2024,2025 by ams OSRAM AG                                       *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <aoresult.h>  // aoresult_to_str
+#include <aoosp_prt.h> // aoosp_prt_xxx, the same formatters as the on-target log
+
+
+// With log level aoosp_loglevel_ring, the firmware records telegrams in a
+// binary ring, and aoosp_logring_drain() (or "osp log drain") prints them as
+//   #osplog seq time addr ix con spi des tele resp
+// This tool reads a capture of the serial output, skips everything that is
+// not an "#osplog" line, and prints each record the way the firmware prints
+// with log level aoosp_loglevel_tele (or aoosp_loglevel_args, option -a).
+//
+// Build (on a PC, from this directory)
+//   gcc -std=gnu99 -O2 -I../osp_aospi/aoosp -I../osp_aospi/aoresult -o aoosp_logdec
+//     aoosp_logdec.c ../osp_aospi/aoosp/aoosp_prt.c ../osp_aospi/aoresult/aoresult.c
+// Run
+//   aoosp_logdec [-a] [-t] [capture.txt]    (reads stdin without file)
+//   -a  arguments only, no raw telegram bytes
+//   -t  prefix each line with the record time stamp (see aoosp_logring_clock_set)
+//
+// Differences with the on-target log: response fields are only printed when
+// the response was received and accepted, READLAST and READOTP show all 8
+// bytes (the size is an argument of the send function, not in the telegram),
+// and bulk reads (aoosp_send_xxx_many) show as their single node telegram.
+
+
+// A log record, as printed by aoosp_logring_drain()
+typedef struct logdec_rec_s {
+  unsigned long time;
+  unsigned      seq, addr, ix, con, spi, des;
+  uint8_t       tele[12]; int telesize;
+  uint8_t       resp[12]; int respsize;
+} logdec_rec_t;
+
+
+// Returns field of `width` bits, with its msb at bit `msb` of payload byte `byte`, of telegram `data` (see AOOSP_FIELD)
+static uint32_t logdec_field(const uint8_t * data, int byte, int msb, int width) {
+  int      pos = 24+8*byte+7-msb; // position of the msb, position 0 is the msb of data[0]
+  uint32_t val = 0;
+  for( int i=pos; i<pos+width; i++ ) val = val<<1 | ( (data[i/8]>>(7-i%8)) & 1 );
+  return val;
+}
+
+
+// Prints the (command) arguments of a record
+typedef void (*logdec_args_t)(const logdec_rec_t * rec);
+// Prints the (decoded) response of a record
+typedef void (*logdec_resp_t)(const logdec_rec_t * rec);
+
+
+static void logdec_args_none(const logdec_rec_t * rec) {
+  printf("(0x%03X)",rec->addr);
+}
+
+static void logdec_args_setmult(const logdec_rec_t * rec) {
+  printf("(0x%03X,0x%02X)",rec->addr,logdec_field(rec->tele,0,6,15));
+}
+
+static void logdec_args_i2cread8(const logdec_rec_t * rec) {
+  printf("(0x%03X,0x%02X,0x%02X,%d)",rec->addr,logdec_field(rec->tele,0,7,7),logdec_field(rec->tele,1,7,8),logdec_field(rec->tele,2,7,8));
+}
+
+static void logdec_args_i2cread12(const logdec_rec_t * rec) {
+  printf("(0x%03X,0x%03X,0x%02X,%d)",rec->addr,logdec_field(rec->tele,0,7,7),logdec_field(rec->tele,1,7,12),logdec_field(rec->tele,2,3,4));
+}
+
+static void logdec_args_i2cwrite8(const logdec_rec_t * rec) {
+  printf("(0x%03X,0x%02X,0x%02X,0x[%s])",rec->addr,logdec_field(rec->tele,0,7,7),logdec_field(rec->tele,1,7,8),aoosp_prt_bytes(&rec->tele[5],rec->telesize-6));
+}
+
+static void logdec_args_i2cwrite12(const logdec_rec_t * rec) {
+  printf("(0x%03X,0x%02X,0x%03X,0x[%s])",rec->addr,logdec_field(rec->tele,0,7,7),logdec_field(rec->tele,1,3,12),aoosp_prt_bytes(&rec->tele[6],rec->telesize-7));
+}
+
+static void logdec_args_byte(const logdec_rec_t * rec) {
+  printf("(0x%03X,0x%02X)",rec->addr,logdec_field(rec->tele,0,7,8));
+}
+
+static void logdec_args_chn(const logdec_rec_t * rec) {
+  printf("(0x%03X,%X)",rec->addr,logdec_field(rec->tele,0,7,8));
+}
+
+static void logdec_args_setpwm(const logdec_rec_t * rec) {
+  uint32_t daytimes = logdec_field(rec->tele,0,7,1)<<2 | logdec_field(rec->tele,2,7,1)<<1 | logdec_field(rec->tele,4,7,1);
+  printf("(0x%03X,0x%04X,0x%04X,0x%04X,%X)",rec->addr,logdec_field(rec->tele,0,6,15),logdec_field(rec->tele,2,6,15),logdec_field(rec->tele,4,6,15),daytimes);
+}
+
+static void logdec_args_setpwmchn(const logdec_rec_t * rec) {
+  printf("(0x%03X,%X,0x%04X,0x%04X,0x%04X)",rec->addr,logdec_field(rec->tele,0,7,8),logdec_field(rec->tele,2,7,16),logdec_field(rec->tele,4,7,16),logdec_field(rec->tele,6,7,16));
+}
+
+static void logdec_args_setcurchn(const logdec_rec_t * rec) {
+  printf("(0x%03X,%X,%s",rec->addr,logdec_field(rec->tele,0,7,8),aoosp_prt_curchn(logdec_field(rec->tele,1,6,3)));
+  printf(",%X,%X,%X)",logdec_field(rec->tele,1,3,4),logdec_field(rec->tele,2,7,4),logdec_field(rec->tele,2,3,4));
+}
+
+static void logdec_args_seti2ccfg(const logdec_rec_t * rec) {
+  printf("(0x%03X,0x%02X,0x%02X)",rec->addr,logdec_field(rec->tele,0,7,4),logdec_field(rec->tele,0,3,4));
+}
+
+static void logdec_args_readotp(const logdec_rec_t * rec) {
+  printf("(0x%03X,0x%02X)",rec->addr,logdec_field(rec->tele,0,4,5));
+}
+
+static void logdec_args_setotp(const logdec_rec_t * rec) {
+  uint8_t buf[7];
+  for( int i=0; i<7; i++ ) buf[i] = rec->tele[9-i]; // telegram is big endian
+  printf("(0x%03X,0x%02X,%s)",rec->addr,logdec_field(rec->tele,7,4,5),aoosp_prt_bytes(buf,7));
+}
+
+static void logdec_args_settestdata(const logdec_rec_t * rec) {
+  printf("(0x%03X,0x%04X)",rec->addr,logdec_field(rec->tele,0,7,16));
+}
+
+static void logdec_args_testpw(const logdec_rec_t * rec) {
+  printf("(0x%03X,%s)",rec->addr,aoosp_prt_bytes(&rec->tele[3],6));
+}
+
+
+static void logdec_resp_init(const logdec_rec_t * rec) {
+  uint32_t last = ( (rec->resp[0]&0x0F)<<6 ) | ( rec->resp[1]>>2 ); // the address field of the header
+  uint8_t  temp = rec->resp[3];
+  uint8_t  stat = rec->resp[4];
+  printf(" last=0x%03X=%d temp=0x%02X=%d stat=0x%02X=%s", last, last, temp, aoosp_prt_temp_said(temp), stat, aoosp_prt_stat_said(stat) );
+  printf(" (%d, %s)", aoosp_prt_temp_rgbi(temp), aoosp_prt_stat_rgbi(stat) );
+}
+
+static void logdec_resp_identify(const logdec_rec_t * rec) {
+  printf(" id=0x%08lX", (unsigned long)(logdec_field(rec->resp,0,7,16)<<16 | logdec_field(rec->resp,2,7,16)) );
+}
+
+static void logdec_resp_tinfo(const logdec_rec_t * rec) {
+  uint8_t tmin = rec->resp[4];
+  uint8_t tmax = rec->resp[3];
+  printf(" tmin=0x%02X=%d tmax=0x%02X=%d", tmin, aoosp_prt_temp_said(tmin), tmax, aoosp_prt_temp_said(tmax) );
+  printf(" (%d, %d)", aoosp_prt_temp_rgbi(tmin), aoosp_prt_temp_rgbi(tmax) );
+}
+
+static void logdec_resp_readmult(const logdec_rec_t * rec) {
+  printf(" groups=0x%04X", logdec_field(rec->resp,0,7,16) );
+}
+
+static void logdec_resp_readlast(const logdec_rec_t * rec) {
+  printf(" i2c %s", aoosp_prt_bytes(&rec->resp[3],8) );
+}
+
+static void logdec_resp_tempstat(const logdec_rec_t * rec) {
+  uint8_t temp = rec->resp[3];
+  uint8_t stat = rec->resp[4];
+  printf(" temp=0x%02X=%d stat=0x%02X=%s", temp, aoosp_prt_temp_said(temp), stat, aoosp_prt_stat_said(stat) );
+  printf(" (%d, %s)", aoosp_prt_temp_rgbi(temp), aoosp_prt_stat_rgbi(stat) );
+}
+
+static void logdec_resp_stat(const logdec_rec_t * rec) {
+  printf(" stat=0x%02X=%s", rec->resp[3], aoosp_prt_stat_said(rec->resp[3]) );
+  printf(" (%s)", aoosp_prt_stat_rgbi(rec->resp[3]) );
+}
+
+static void logdec_resp_comst(const logdec_rec_t * rec) {
+  printf(" com=0x%02X=%s", rec->resp[3], aoosp_prt_com_said(rec->resp[3]) );
+  printf(" (%s)", aoosp_prt_com_rgbi(rec->resp[3]) );
+}
+
+static void logdec_resp_ledst(const logdec_rec_t * rec) {
+  printf(" ledst=0x%02X=%s", rec->resp[3], aoosp_prt_ledst(rec->resp[3]) );
+}
+
+static void logdec_resp_temp(const logdec_rec_t * rec) {
+  printf(" temp=0x%02X=%d", rec->resp[3], aoosp_prt_temp_said(rec->resp[3]) );
+  printf(" (%d)", aoosp_prt_temp_rgbi(rec->resp[3]) );
+}
+
+static void logdec_resp_setup(const logdec_rec_t * rec) {
+  printf(" flags=0x%02X=%s", rec->resp[3], aoosp_prt_setup(rec->resp[3]) );
+}
+
+static void logdec_resp_pwm(const logdec_rec_t * rec) {
+  uint32_t daytimes = logdec_field(rec->resp,0,7,1)<<2 | logdec_field(rec->resp,2,7,1)<<1 | logdec_field(rec->resp,4,7,1);
+  printf(" rgb=%s", aoosp_prt_pwm_rgbi(logdec_field(rec->resp,0,6,15),logdec_field(rec->resp,2,6,15),logdec_field(rec->resp,4,6,15),daytimes) );
+}
+
+static void logdec_resp_pwmchn(const logdec_rec_t * rec) {
+  printf(" rgb=%s", aoosp_prt_pwm_said(logdec_field(rec->resp,0,7,16),logdec_field(rec->resp,2,7,16),logdec_field(rec->resp,4,7,16)) );
+}
+
+static void logdec_resp_curchn(const logdec_rec_t * rec) {
+  printf(" flags=%s", aoosp_prt_curchn(logdec_field(rec->resp,0,7,4)) );
+  printf(" rcur=%X gcur=%X bcur=%X", logdec_field(rec->resp,0,3,4), logdec_field(rec->resp,1,7,4), logdec_field(rec->resp,1,3,4) );
+}
+
+static void logdec_resp_adc(const logdec_rec_t * rec) {
+  printf(" flags=0x%02X", rec->resp[3] );
+}
+
+static void logdec_resp_i2ccfg(const logdec_rec_t * rec) {
+  uint8_t flags = logdec_field(rec->resp,0,7,4);
+  uint8_t speed = logdec_field(rec->resp,0,3,4);
+  printf(" flags=0x%02X=%s speed=0x%02X=%d", flags, aoosp_prt_i2ccfg(flags), speed, aoosp_prt_i2ccfg_speed(speed) );
+}
+
+static void logdec_resp_otp(const logdec_rec_t * rec) {
+  uint8_t buf[8];
+  for( int i=0; i<8; i++ ) buf[i] = rec->resp[10-i]; // telegram is big endian
+  printf(" otp 0x%02X: %s", logdec_field(rec->tele,0,4,5), aoosp_prt_bytes(buf,8) );
+}
+
+static void logdec_resp_adcdat(const logdec_rec_t * rec) {
+  uint16_t adcdat = logdec_field(rec->resp,0,7,16);
+  printf(" adcdat=0x%04X=%dmV", adcdat, aoosp_prt_adc(adcdat) );
+}
+
+
+// Per telegram (in the order of aoosp_ix_t in aoosp_send.c): the name, how to print the arguments, and the response (0 if none)
+typedef struct logdec_desc_s { const char * name; logdec_args_t args; logdec_resp_t resp; } logdec_desc_t;
+static const logdec_desc_t logdec_desc[] = {
+  { "reset"       , logdec_args_none       , 0                     }, // AOOSP_IX_RESET
+  { "clrerror"    , logdec_args_none       , 0                     }, // AOOSP_IX_CLRERROR
+  { "initbidir"   , logdec_args_none       , logdec_resp_init      }, // AOOSP_IX_INITBIDIR
+  { "initloop"    , logdec_args_none       , logdec_resp_init      }, // AOOSP_IX_INITLOOP
+  { "gosleep"     , logdec_args_none       , 0                     }, // AOOSP_IX_GOSLEEP
+  { "goactive"    , logdec_args_none       , 0                     }, // AOOSP_IX_GOACTIVE
+  { "godeepsleep" , logdec_args_none       , 0                     }, // AOOSP_IX_GODEEPSLEEP
+  { "identify"    , logdec_args_none       , logdec_resp_identify  }, // AOOSP_IX_IDENTIFY
+  { "asktinfo"    , logdec_args_none       , logdec_resp_tinfo     }, // AOOSP_IX_ASKTINFO
+  { "asktinfo_ex" , logdec_args_none       , logdec_resp_tinfo     }, // AOOSP_IX_ASKTINFO_INIT
+  { "readmult"    , logdec_args_none       , logdec_resp_readmult  }, // AOOSP_IX_READMULT
+  { "setmult"     , logdec_args_setmult    , 0                     }, // AOOSP_IX_SETMULT
+  { "sync"        , logdec_args_none       , 0                     }, // AOOSP_IX_SYNC
+  { "idle"        , logdec_args_none       , 0                     }, // AOOSP_IX_IDLE
+  { "foundry"     , logdec_args_none       , 0                     }, // AOOSP_IX_FOUNDRY
+  { "cust"        , logdec_args_none       , 0                     }, // AOOSP_IX_CUST
+  { "burn"        , logdec_args_none       , 0                     }, // AOOSP_IX_BURN
+  { "aread"       , logdec_args_none       , 0                     }, // AOOSP_IX_AREAD
+  { "load"        , logdec_args_none       , 0                     }, // AOOSP_IX_LOAD
+  { "gload"       , logdec_args_none       , 0                     }, // AOOSP_IX_GLOAD
+  { "i2cread8"    , logdec_args_i2cread8   , 0                     }, // AOOSP_IX_I2CREAD8
+  { "i2cread12"   , logdec_args_i2cread12  , 0                     }, // AOOSP_IX_I2CREAD12
+  { "i2cwrite"    , logdec_args_i2cwrite8  , 0                     }, // AOOSP_IX_I2CWRITE8
+  { "i2cwrite12"  , logdec_args_i2cwrite12 , 0                     }, // AOOSP_IX_I2CWRITE12
+  { "readlast"    , logdec_args_none       , logdec_resp_readlast  }, // AOOSP_IX_READLAST
+  { "goactive_sr" , logdec_args_none       , logdec_resp_tempstat  }, // AOOSP_IX_GOACTIVE_SR
+  { "readstat"    , logdec_args_none       , logdec_resp_stat      }, // AOOSP_IX_READSTAT
+  { "readtempstat", logdec_args_none       , logdec_resp_tempstat  }, // AOOSP_IX_READTEMPSTAT
+  { "readcomst"   , logdec_args_none       , logdec_resp_comst     }, // AOOSP_IX_READCOMST
+  { "readledst"   , logdec_args_none       , logdec_resp_ledst     }, // AOOSP_IX_READLEDST
+  { "readledstchn", logdec_args_none       , logdec_resp_ledst     }, // AOOSP_IX_READLEDSTCHN
+  { "readtemp"    , logdec_args_none       , logdec_resp_temp      }, // AOOSP_IX_READTEMP
+  { "readsetup"   , logdec_args_none       , logdec_resp_setup     }, // AOOSP_IX_READSETUP
+  { "setsetup"    , logdec_args_byte       , 0                     }, // AOOSP_IX_SETSETUP
+  { "readpwm"     , logdec_args_none       , logdec_resp_pwm       }, // AOOSP_IX_READPWM
+  { "readpwmchn"  , logdec_args_chn        , logdec_resp_pwmchn    }, // AOOSP_IX_READPWMCHN
+  { "setpwm"      , logdec_args_setpwm     , 0                     }, // AOOSP_IX_SETPWM
+  { "setpwmchn"   , logdec_args_setpwmchn  , 0                     }, // AOOSP_IX_SETPWMCHN
+  { "readcurchn"  , logdec_args_chn        , logdec_resp_curchn    }, // AOOSP_IX_READCURCHN
+  { "setcurchn"   , logdec_args_setcurchn  , 0                     }, // AOOSP_IX_SETCURCHN
+  { "readadc"     , logdec_args_none       , logdec_resp_adc       }, // AOOSP_IX_READADC
+  { "setadc"      , logdec_args_byte       , 0                     }, // AOOSP_IX_SETADC
+  { "readi2ccfg"  , logdec_args_none       , logdec_resp_i2ccfg    }, // AOOSP_IX_READI2CCFG
+  { "seti2ccfg"   , logdec_args_seti2ccfg  , 0                     }, // AOOSP_IX_SETI2CCFG
+  { "readotp"     , logdec_args_readotp    , logdec_resp_otp       }, // AOOSP_IX_READOTP
+  { "setotp"      , logdec_args_setotp     , 0                     }, // AOOSP_IX_SETOTP
+  { "settestdata" , logdec_args_settestdata, 0                     }, // AOOSP_IX_SETTESTDATA
+  { "readadcdat"  , logdec_args_none       , logdec_resp_adcdat    }, // AOOSP_IX_READADCDAT
+  { "settestpw"   , logdec_args_testpw     , 0                     }, // AOOSP_IX_SETTESTPW
+  { "settestpw_sr", logdec_args_testpw     , logdec_resp_tempstat  }, // AOOSP_IX_SETTESTPW_SR
+};
+#define LOGDEC_NUMDESC ( (unsigned)(sizeof(logdec_desc)/sizeof(logdec_desc[0])) )
+
+
+// Parses hex string `str` ("-" is empty) into `buf` (at most `max` bytes); returns the number of bytes, or -1 on error
+static int logdec_hex(const char * str, uint8_t * buf, int max) {
+  if( strcmp(str,"-")==0 ) return 0;
+  int size = strlen(str)/2;
+  if( strlen(str)%2!=0 || size>max ) return -1;
+  for( int i=0; i<size; i++ ) {
+    unsigned b;
+    if( sscanf(str+2*i,"%2x",&b)!=1 ) return -1;
+    buf[i] = b;
+  }
+  return size;
+}
+
+
+// Parses the "#osplog" line `line` into `rec`; returns 0 on success
+static int logdec_parse(const char * line, logdec_rec_t * rec) {
+  char tele[32], resp[32];
+  int  n = sscanf(line, "#osplog %x %lx %x %x %x %x %x %31s %31s", &rec->seq, &rec->time, &rec->addr, &rec->ix, &rec->con, &rec->spi, &rec->des, tele, resp);
+  if( n!=9 ) return -1;
+  rec->telesize = logdec_hex(tele,rec->tele,sizeof rec->tele);
+  rec->respsize = logdec_hex(resp,rec->resp,sizeof rec->resp);
+  if( rec->telesize<0 || rec->respsize<0 ) return -1;
+  return 0;
+}
+
+
+// Prints record `rec` like the aoosp_send_xxx() functions log it
+static void logdec_print(const logdec_rec_t * rec, int tele, int time) {
+  if( time ) printf("%10lu ", rec->time);
+  if( rec->ix>=LOGDEC_NUMDESC ) { printf("ix%02X(0x%03X) [unknown telegram]\n", rec->ix, rec->addr); return; }
+  const logdec_desc_t * desc = &logdec_desc[rec->ix];
+  printf("%s", desc->name);
+  if( rec->telesize>0 ) desc->args(rec); else printf("(0x%03X)", rec->addr);
+  if( tele && rec->telesize>0 ) printf(" [tele %s]", aoosp_prt_bytes(rec->tele,rec->telesize));
+  if( rec->con!=aoresult_ok ) printf(" [constructor ERROR %s]", aoresult_to_str((aoresult_t)rec->con,0) );
+    else if( rec->spi!=aoresult_ok ) printf(" [SPI ERROR %s]", aoresult_to_str((aoresult_t)rec->spi,0) );
+    else if( rec->des!=aoresult_ok ) printf(" [destructor ERROR %s]", aoresult_to_str((aoresult_t)rec->des,0) );
+  if( desc->resp ) {
+    printf(" ->");
+    if( tele && rec->respsize>0 ) printf(" [resp %s]", aoosp_prt_bytes(rec->resp,rec->respsize));
+    if( rec->respsize>0 && rec->des==aoresult_ok ) desc->resp(rec);
+  }
+  printf("\n");
+}
+
+
+int main(int argc, char * argv[]) {
+  int    tele = 1;
+  int    time = 0;
+  FILE * in   = stdin;
+  for( int i=1; i<argc; i++ ) {
+    if( strcmp(argv[i],"-a")==0 ) tele = 0;
+    else if( strcmp(argv[i],"-t")==0 ) time = 1;
+    else if( argv[i][0]=='-' ) { fprintf(stderr,"usage: %s [-a] [-t] [capture]\n",argv[0]); return 2; }
+    else if( (in=fopen(argv[i],"r"))==0 ) { fprintf(stderr,"ERROR: can not open '%s'\n",argv[i]); return 1; }
+  }
+
+  char     line[256];
+  int      first = 1;
+  unsigned next  = 0; // expected sequence number
+  while( fgets(line,sizeof line,in) ) {
+    const char * s = strstr(line,"#osplog ");
+    if( s==0 ) continue;
+    logdec_rec_t rec;
+    if( logdec_parse(s,&rec)!=0 ) { fprintf(stderr,"WARNING: skipped malformed line: %s",s); continue; }
+    if( !first && rec.seq!=next ) printf("(%u records lost)\n", (rec.seq-next) & 0xFFFF );
+    first = 0;
+    next  = (rec.seq+1) & 0xFFFF;
+    logdec_print(&rec,tele,time);
+  }
+  return 0;
+}
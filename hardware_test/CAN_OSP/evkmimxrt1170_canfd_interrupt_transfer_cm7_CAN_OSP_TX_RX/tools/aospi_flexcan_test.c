@@ -0,0 +1,511 @@
+// aospi_flexcan_test.c - host test: the FlexCAN backend of aospi against a model of the controllers and the bridge
+/*****************************************************************************
+ * Copyright 2024,2025 by ams OSRAM AG                                       *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <aoresult.h>     // aoresult_to_str
+#include <aospi.h>        // aospi_submit, aospi_txring_setdepth, aospi_bench
+#include <aospi_frame.h>  // AOSPI_FRAME_TAGBASE
+#include "fsl_flexcan.h"  // host_flexcan_xxx (host/host_flexcan.c)
+
+
+// Runs aospi_flexcan.c on the host, with host/host_flexcan.c in place of
+// the FlexCAN driver. The model sends frames the way FlexCAN does (lowest
+// pending TX MB first, back-to-back when the next MB is already loaded) and
+// runs the "interrupts" when aospi enables interrupts.
+//
+// Build (on a PC, from this directory)
+//   make build/aospi_flexcan_test
+// Run
+//   build/aospi_flexcan_test        (MCU-B, all checks)
+//   build/aospi_flexcan_test mcua   (MCU-A, the packing checks only)
+//
+// Checks, per TX ring depth (1..AOSPI_TXRING_MAXDEPTH)
+//   - frames appear on the bus in the order they were submitted, also
+//     when the ring wraps with frames pending (and that they would not
+//     without local priority)
+//   - no more MBs are loaded than the ring depth
+//   - frames go out back-to-back, except when the ring runs out of PRIO
+//     values and drains (once every 8 laps); depth 1 has a gap per frame
+// and runs 'osp bench' (aospi_bench) on the model, also with a late TX
+// interrupt (a busy CPU), where frames/s must grow with the depth until
+// the bus is saturated. For the packing of
+// telegrams in frame words and back it checks, byte for byte
+//   - plain and tagged frames, for every telegram size (Manchester
+//     encoded, against a bitwise encoder, for MCU-A)
+//   - batched frames (aospi_tx_batch), against aospi_frame_next()
+//   - responses of every size, into larger, equal and smaller rx buffers
+// For the RX ring and
+// the sequence tags it checks that each response lands in its own request
+//   - with pipelined requests, answered in order or in reverse order
+//   - with untagged responses (they go to the oldest outstanding request)
+//   - when a response is lost (time-out), and when it then arrives late
+//   - with tags disabled (one request with response in flight)
+// and that a `done` callback can submit while the application is posting:
+// it does not wait in the ISR for a free request, and the telegrams keep
+// their order.
+
+
+static int test_fails;
+
+
+// Records a failed check
+static void test_check( int ok, const char * what ) {
+  if( !ok ) { printf("  FAIL %s\n", what); test_fails++; }
+}
+
+
+// === bridge model =========================================================
+
+
+#define TEST_LOGSIZE 256
+static struct { CAN_Type * base; uint32_t id; int size; uint8_t data[64]; } test_log[TEST_LOGSIZE];
+static int test_logcount;
+
+
+// How the bridge model answers
+#define TEST_ANSWER_NONE    0 // no responses
+#define TEST_ANSWER_INORDER 1 // each request after 50us
+#define TEST_ANSWER_REVERSE 2 // requests of a batch in reverse order
+#define TEST_ANSWER_PLAIN   3 // each request after 50us, without tag
+static int test_answer;
+static int test_batch;   // number of requests in the batch (TEST_ANSWER_REVERSE)
+static int test_drop;    // request that gets no response (-1 for none)
+static int test_late;    // request whose response comes after the time-out (-1 for none)
+static int test_respsize= 8; // size of the response telegrams
+
+// Requests with response of a test; telegram byte 1 holds the index
+#define TEST_RXREQS 24
+static aospi_req_t test_rxreqs[TEST_RXREQS];
+static uint8_t     test_rx[TEST_RXREQS][8];
+static int         test_inflight; // max number of requests with response in flight (sent, not answered), seen by the bridge
+
+
+// Returns the response byte `j` for request `i` (an OSP telegram starts with preamble A, below the tags)
+static uint8_t test_respbyte( int i, int j ) {
+  return j==0 ? 0xA0 : (uint8_t)(i*8 + j);
+}
+
+
+// Logs the frames sent to the bridge, and answers them as set in test_answer
+static void test_bridge( CAN_Type * base, uint32_t id, const uint8_t * data, int size ) {
+  if( test_logcount<TEST_LOGSIZE ) {
+    test_log[test_logcount].base = base;
+    test_log[test_logcount].id   = id;
+    test_log[test_logcount].size = size;
+    memcpy(test_log[test_logcount].data, data, size);
+    test_logcount++;
+  }
+  if( test_answer==TEST_ANSWER_NONE ) return;
+
+  // Find the telegram (tagged frames: tag, length, telegram)
+  int tagged = data[0]>=AOSPI_FRAME_TAGBASE;
+  const uint8_t * tele = tagged ? data+2 : data;
+  int i = tele[1];
+  int inflight = 1; // this one
+  for( int k=0; k<TEST_RXREQS; k++ ) inflight += test_rxreqs[k].busy && test_rxreqs[k].txdone;
+  if( inflight>test_inflight ) test_inflight = inflight;
+  if( i==test_drop ) return;
+
+  uint8_t resp[2+AOSPI_TELE_MAXSIZE];
+  int     pos = 0;
+  if( tagged && test_answer!=TEST_ANSWER_PLAIN ) { resp[pos++] = data[0]; resp[pos++] = (uint8_t)test_respsize; }
+  for( int j=0; j<test_respsize; j++ ) resp[pos++] = test_respbyte(i,j);
+  uint32_t delay = 50;
+  if( test_answer==TEST_ANSWER_REVERSE ) delay = 50 + 400*(test_batch-1-i);
+  if( i==test_late ) delay = aospi_timeout_get() + 2000;
+  host_flexcan_respond(base, FLEXCAN_ID_STD(0x321), resp, pos, delay);
+}
+
+
+// === TX ring ==============================================================
+
+
+#define TEST_RINGREQS 120 // more than 8 laps of the deepest ring
+
+
+// Submits TEST_RINGREQS telegrams without response; returns 1 iff their frames are on the bus in submit order
+static int test_txring_send( void ) {
+  static aospi_req_t reqs[TEST_RINGREQS];
+  test_logcount = 0;
+  for( int i=0; i<TEST_RINGREQS; i++ ) {
+    uint8_t tele[4] = { 0xA0, (uint8_t)i, 0x5A, (uint8_t)(i*7) };
+    aoresult_t result = aospi_submit(&reqs[i], tele, sizeof tele, 0, 0);
+    test_check( result==aoresult_ok, "submit" );
+  }
+  int errors = 0;
+  for( int i=0; i<TEST_RINGREQS; i++ ) if( aospi_wait(&reqs[i])!=aoresult_ok ) errors++;
+  test_check( errors==0, "all requests complete ok" );
+  int inorder = test_logcount==TEST_RINGREQS;
+  for( int i=0; i<test_logcount && inorder; i++ )
+    inorder = test_log[i].base==CAN3 && test_log[i].data[0]==0xA0 && test_log[i].data[1]==i && test_log[i].data[3]==(uint8_t)(i*7);
+  return inorder;
+}
+
+
+// Submits TEST_RINGREQS telegrams without response, and checks their frames on the bus
+static void test_txring( int depth ) {
+  host_flexcan_stats_t stats;
+  aospi_txring_setdepth(depth);
+  host_flexcan_stats(CAN3, &stats);
+  int inorder = test_txring_send();
+  host_flexcan_stats(CAN3, &stats);
+
+  test_check( inorder, "frames on the bus in submit order" );
+  test_check( stats.maxpending==(uint32_t)depth, "ring filled up to its depth" );
+  uint32_t maxgaps = depth==1 ? TEST_RINGREQS-1 : (TEST_RINGREQS-1)/(8*depth);
+  test_check( stats.gaps<=maxgaps, "frames back-to-back, except when out of PRIO values" );
+
+  uint64_t span = stats.lastus - stats.firstus;
+  printf("  depth %d: %lu frames, max %lu MBs loaded, %lu gaps, bus busy %lu%%\n", depth,
+    (unsigned long)stats.frames, (unsigned long)stats.maxpending, (unsigned long)stats.gaps,
+    (unsigned long)(span ? 100*stats.busus/span : 0) );
+}
+
+
+// Checks that the circular ring relies on local priority: without it, a refilled low MB overtakes the pending higher ones
+static void test_txring_noprio( void ) {
+  aospi_txring_setdepth(AOSPI_TXRING_MAXDEPTH);
+  CAN3->MCR &= ~CAN_MCR_LPRIOEN_MASK;
+  int inorder = test_txring_send();
+  CAN3->MCR |= CAN_MCR_LPRIOEN_MASK;
+  printf("  depth %d without local priority: frames %s\n", AOSPI_TXRING_MAXDEPTH, inorder ? "in order" : "out of order");
+  test_check( !inorder, "without local priority the ring reorders (the check has teeth)" );
+}
+
+
+// === packing ==============================================================
+
+
+// Reference Manchester encoder (IEEE 802.4: 1 is 01, 0 is 10), bit by bit
+static void test_manchester( const uint8_t * in, int size, uint8_t * out ) {
+  for( int i=0; i<size; i++ ) {
+    uint16_t w = 0;
+    for( int b=7; b>=0; b-- ) w = (uint16_t)(w<<2 | ((in[i]>>b)&1 ? 1 : 2));
+    out[2*i] = (uint8_t)(w>>8);
+    out[2*i+1] = (uint8_t)w;
+  }
+}
+
+
+// Returns 1 iff the last logged frame holds `expect[0..size-1]`, zero padded to at least 24 bytes
+static int test_frame_is( const uint8_t * expect, int size ) {
+  if( test_logcount==0 ) return 0;
+  int framesize = aospi_frame_dlc2size(aospi_frame_size2dlc(size));
+  if( framesize<24 ) framesize = 24;
+  if( test_log[test_logcount-1].size!=framesize ) return 0;
+  for( int i=0; i<framesize; i++ )
+    if( test_log[test_logcount-1].data[i] != (i<size ? expect[i] : 0) ) return 0;
+  return 1;
+}
+
+
+// Checks plain and tagged frames of every telegram size with phy `phy` (as passed to aospi_init); returns the number of mismatching frames
+static int test_pack_single( aospi_phy_t phy ) {
+  int bad = 0;
+  for( int size=1; size<=AOSPI_TELE_MAXSIZE; size++ ) {
+    for( int withrx=0; withrx<=1; withrx++ ) {
+      uint8_t tele[AOSPI_TELE_MAXSIZE], rx[AOSPI_TELE_MAXSIZE], expect[2+2*AOSPI_TELE_MAXSIZE];
+      for( int i=0; i<size; i++ ) tele[i] = (uint8_t)(0xA0 + 37*size + 11*i);
+      test_logcount = 0;
+      aospi_timeout_set(500); // no bridge answers
+      aospi_submit(&test_rxreqs[0], tele, size, withrx ? rx : 0, sizeof rx);
+      aospi_wait(&test_rxreqs[0]);
+      int pos = 0;
+      int encsize = phy==aospi_phy_mcua ? 2*size : size;
+      if( withrx ) { expect[pos++] = (uint8_t)(AOSPI_FRAME_TAGBASE + test_rxreqs[0].tag); expect[pos++] = (uint8_t)encsize; }
+      if( phy==aospi_phy_mcua ) test_manchester(tele, size, expect+pos); else memcpy(expect+pos, tele, size);
+      bad += !test_frame_is(expect, pos+encsize);
+    }
+  }
+  return bad;
+}
+
+
+// Checks batched frames of `count` telegrams; returns the number of mismatching telegrams
+static int test_pack_batch( int count ) {
+  static uint8_t teles[64][AOSPI_TELE_MAXSIZE];
+  const uint8_t * ptrs[64];
+  int sizes[64];
+  for( int t=0; t<count; t++ ) {
+    sizes[t] = 1 + (t*5+count)%AOSPI_TELE_MAXSIZE;
+    for( int i=0; i<sizes[t]; i++ ) teles[t][i] = (uint8_t)(t*31 + i*7 + count);
+    ptrs[t] = teles[t];
+  }
+  test_logcount = 0;
+  aospi_tx_batch(ptrs, sizes, count);
+  // Unpack the frames on the bus with the reference unpacker
+  int t = 0, bad = 0;
+  for( int f=0; f<test_logcount; f++ ) {
+    int pos = 0, telesize;
+    const uint8_t * tele;
+    while( aospi_frame_next(test_log[f].data, test_log[f].size, &pos, &tele, &telesize) ) {
+      if( t>=count || telesize!=sizes[t] || memcmp(tele, teles[t], telesize)!=0 ) bad++;
+      t++;
+    }
+  }
+  return bad + (t!=count);
+}
+
+
+// Checks the unpacking of tagged responses of every size into rx buffers of every size; returns the number of mismatches
+static int test_unpack( void ) {
+  int bad = 0;
+  test_drop = -1;
+  test_late = -1;
+  test_answer = TEST_ANSWER_INORDER;
+  for( int respsize=1; respsize<=AOSPI_TELE_MAXSIZE; respsize++ ) {
+    for( int rxsize=1; rxsize<=AOSPI_TELE_MAXSIZE; rxsize++ ) {
+      uint8_t tele[4] = { 0xA0, (uint8_t)(respsize+rxsize), 0x07, 0x00 };
+      uint8_t rx[AOSPI_TELE_MAXSIZE+1];
+      int i = tele[1];
+      memset(rx, 0xEE, sizeof rx);
+      test_respsize = respsize;
+      aospi_submit(&test_rxreqs[0], tele, sizeof tele, rx, rxsize);
+      int ok = aospi_wait(&test_rxreqs[0])==aoresult_ok && test_rxreqs[0].actsize==respsize;
+      for( int j=0; j<=AOSPI_TELE_MAXSIZE; j++ )
+        ok = ok && rx[j]==( j<respsize && j<rxsize ? test_respbyte(i,j) : 0xEE );
+      bad += !ok;
+    }
+  }
+  test_respsize = 8;
+  test_answer = TEST_ANSWER_NONE;
+  return bad;
+}
+
+
+// Checks the packing and unpacking of frame words, with phy `phy` (as passed to aospi_init)
+static void test_pack( aospi_phy_t phy ) {
+  uint32_t timeout = aospi_timeout_get();
+  int bad;
+  bad = test_pack_single(phy);
+  printf("  %s plain and tagged, sizes 1..%d: %d bad\n", aospi_phy_str(phy), AOSPI_TELE_MAXSIZE, bad);
+  test_check( bad==0, "frames" );
+  aospi_timeout_set(timeout);
+  if( phy==aospi_phy_mcua ) return; // batches and the bridge's responses are not Manchester encoded
+  bad = 0;
+  for( int count=1; count<=64; count++ ) bad += test_pack_batch(count);
+  printf("  batches of 1..64 telegrams: %d bad\n", bad);
+  test_check( bad==0, "batched frames" );
+  bad = test_unpack();
+  printf("  responses 1..%d into rx buffers 1..%d: %d bad\n", AOSPI_TELE_MAXSIZE, AOSPI_TELE_MAXSIZE, bad);
+  test_check( bad==0, "responses" );
+}
+
+
+// === RX ring and tags =====================================================
+
+
+// Submits `count` requests with response, answered as `answer`; returns the number of requests that got their own response
+static int test_rxtags( int count, int answer ) {
+  host_flexcan_stats_t stats;
+  host_flexcan_stats(CAN3, &stats);
+  memset(test_rx, 0, sizeof test_rx);
+  test_answer   = answer;
+  test_batch    = count;
+  test_inflight = 0;
+  for( int i=0; i<count; i++ ) {
+    uint8_t tele[4] = { 0xA0, (uint8_t)i, 0x07, 0x00 };
+    aoresult_t result = aospi_submit(&test_rxreqs[i], tele, sizeof tele, test_rx[i], sizeof test_rx[i]);
+    test_check( result==aoresult_ok, "submit" );
+  }
+  int good = 0;
+  for( int i=0; i<count; i++ ) {
+    aoresult_t result = aospi_wait(&test_rxreqs[i]);
+    int match = result==aoresult_ok && test_rxreqs[i].actsize==8;
+    for( int j=0; j<8; j++ ) match = match && test_rx[i][j]==test_respbyte(i,j);
+    good += match;
+  }
+  test_answer = TEST_ANSWER_NONE;
+  host_flexcan_stats(CAN3, &stats);
+  test_check( stats.rxlost==0, "no frames lost in the RX ring" );
+  return good;
+}
+
+
+// Checks that responses land in their own request
+static void test_rxring( void ) {
+  int good;
+  test_drop = -1;
+  test_late = -1;
+
+  good = test_rxtags(TEST_RXREQS, TEST_ANSWER_INORDER);
+  printf("  in order: %d/%d matched, max %d in flight\n", good, TEST_RXREQS, test_inflight);
+  test_check( good==TEST_RXREQS, "in order: all matched" );
+  test_check( test_inflight>1, "in order: requests pipelined" );
+
+  good = test_rxtags(TEST_RXREQS, TEST_ANSWER_REVERSE);
+  printf("  reverse : %d/%d matched, max %d in flight\n", good, TEST_RXREQS, test_inflight);
+  test_check( good==TEST_RXREQS, "reverse: all matched" );
+
+  good = test_rxtags(TEST_RXREQS, TEST_ANSWER_PLAIN);
+  printf("  untagged: %d/%d matched\n", good, TEST_RXREQS);
+  test_check( good==TEST_RXREQS, "untagged: all matched (oldest first)" );
+
+  uint32_t timeout = aospi_timeout_get();
+  aospi_timeout_set(2000);
+  test_drop = 5;
+  good = test_rxtags(12, TEST_ANSWER_INORDER);
+  printf("  lost    : %d/12 matched, request 5 %s\n", good, aoresult_to_str(test_rxreqs[5].result,0));
+  test_check( good==11 && test_rxreqs[5].result==aoresult_spi_noclock, "lost: only that request times out" );
+  test_drop = -1;
+  test_late = 3;
+  good = test_rxtags(12, TEST_ANSWER_INORDER);
+  SDK_DelayAtLeastUs(10000, 0); // let the late response arrive
+  test_late = -1;
+  printf("  late    : %d/12 matched, request 3 %s\n", good, aoresult_to_str(test_rxreqs[3].result,0));
+  test_check( good==11 && test_rxreqs[3].result==aoresult_spi_noclock, "late: only that request times out" );
+  good = test_rxtags(12, TEST_ANSWER_INORDER);
+  test_check( good==12, "late: the late response is not taken by a next request" );
+  aospi_timeout_set(timeout);
+
+  aospi_rxtag_enable(0);
+  good = test_rxtags(12, TEST_ANSWER_INORDER);
+  printf("  no tags : %d/12 matched, max %d in flight\n", good, test_inflight);
+  test_check( good==12, "no tags: all matched" );
+  test_check( test_inflight==1, "no tags: one request in flight" );
+  aospi_rxtag_enable(1);
+}
+
+
+// === callbacks ============================================================
+
+
+#define TEST_POSTED 11 // posted telegrams: more than two full frames, so the pool has no free request
+
+
+static aospi_req_t test_cbreqs[2];
+static aoresult_t  test_cbresult;
+
+
+// Completion callback of the first request: submits the second one (in the "ISR")
+static void test_cb( aospi_req_t * req ) {
+  (void)req;
+  uint8_t tele[4] = { 0xA0, 0xC2, 0x5A, 0x00 };
+  test_cbresult = aospi_submit(&test_cbreqs[1], tele, sizeof tele, 0, 0);
+}
+
+
+// Posts telegrams while a `done` callback submits; checks that all go out once, in order
+static void test_callback( void ) {
+  aospi_txring_setdepth(2);
+  test_logcount = 0;
+  test_cbresult = aoresult_assert;
+  aospi_post_begin();
+  uint8_t tele[AOSPI_TELE_MAXSIZE] = { 0xA0, 0xC1, 0x5A };
+  test_cbreqs[0].done = test_cb;
+  test_check( aospi_submit(&test_cbreqs[0], tele, 4, 0, 0)==aoresult_ok, "submit" );
+  for( int i=0; i<TEST_POSTED; i++ ) {
+    tele[1] = (uint8_t)i;
+    if( i==TEST_POSTED-1 ) while( test_cbresult==aoresult_assert ) aospi_poll(); // the last one after the callback
+    aospi_tx(tele, sizeof tele);
+  }
+  test_check( aospi_post_end()==aoresult_ok, "posted frames sent" );
+  test_check( test_cbresult==aoresult_ok && aospi_wait(&test_cbreqs[1])==aoresult_ok, "callback submits" );
+  test_cbreqs[0].done = 0;
+
+  // The telegrams on the bus: the first request, the posted ones up to the
+  // callback, the request of the callback, the rest
+  int seq[TEST_POSTED+2], n = 0;
+  for( int f=0; f<test_logcount; f++ ) {
+    int pos = 0, telesize;
+    const uint8_t * t;
+    if( test_log[f].data[0]==0xA0 ) { if( n<TEST_POSTED+2 ) seq[n++] = test_log[f].data[1]; continue; } // plain frame
+    while( aospi_frame_next(test_log[f].data, test_log[f].size, &pos, &t, &telesize) ) if( n<TEST_POSTED+2 ) seq[n++] = t[1];
+  }
+  int ok = n==TEST_POSTED+2 && seq[0]==0xC1, k = 0;
+  for( int i=1; i<n && ok; i++ ) {
+    if( seq[i]==0xC2 ) continue;
+    ok = seq[i]==k++;
+  }
+  int cbpos = 0;
+  for( int i=0; i<n; i++ ) if( seq[i]==0xC2 ) cbpos = i;
+  printf("  %d frames, the callback's telegram after %d posted ones\n", test_logcount, cbpos-1);
+  test_check( ok && cbpos>1 && cbpos<n-1, "telegrams once and in order, the callback's among the posted ones" );
+}
+
+
+// === bench ================================================================
+
+
+// Runs 'osp bench' (aospi_bench) with ring depth `depth`; returns the frames/s
+static uint32_t test_bench( int depth ) {
+  uint32_t us;
+  aospi_txring_setdepth(depth);
+  test_logcount = 0;
+  aoresult_t result = aospi_bench(1000, &us);
+  test_check( result==aoresult_ok, "bench runs" );
+  test_check( test_logcount==0, "bench frames stay in loop back" );
+  uint32_t fps = us ? (uint32_t)(1000000ULL*1000/us) : 0;
+  printf("  depth %d: 1000 frames in %lu us, %lu frames/s\n", depth, (unsigned long)us, (unsigned long)fps);
+  return fps;
+}
+
+
+#define TEST_BUSYUS 400 // TX interrupt latency of a busy CPU: more than a 64 byte frame (331us)
+
+
+// Checks that frames/s grow with the depth when the TX interrupt is late, up to what the bus can take
+static void test_bench_scaling( void ) {
+  // With a prompt interrupt the bus is the limit, whatever the depth
+  test_bench(1);
+  uint32_t busfps = test_bench(AOSPI_TXRING_MAXDEPTH);
+  printf("bench with a busy CPU (TX interrupt %dus after the frame)\n", TEST_BUSYUS);
+  host_flexcan_isrus_set(TEST_BUSYUS);
+  uint32_t fps[AOSPI_TXRING_MAXDEPTH+1];
+  for( int depth=1; depth<=AOSPI_TXRING_MAXDEPTH; depth++ ) fps[depth] = test_bench(depth);
+  host_flexcan_isrus_set(2); // the default
+  // The ring drains once every 8 laps (out of PRIO values), which costs depth 2 the most
+  test_check( fps[2] >= 18*fps[1]/10, "busy CPU: depth 2 nearly doubles frames/s" );
+  int grows = 1;
+  for( int depth=2; depth<=AOSPI_TXRING_MAXDEPTH; depth++ ) grows = grows && fps[depth] >= fps[depth-1];
+  test_check( grows, "busy CPU: frames/s grow with the depth" );
+  test_check( fps[AOSPI_TXRING_MAXDEPTH] >= 95*busfps/100, "busy CPU: the deepest ring (nearly) saturates the bus" );
+}
+
+
+int main( int argc, char * argv[] ) {
+  // aospi_init() runs once per program, so MCU-A has its own run
+  aospi_phy_t phy = argc>1 && strcmp(argv[1],"mcua")==0 ? aospi_phy_mcua : aospi_phy_mcub;
+  aospi_init(phy, 0); // FlexCAN backend
+  host_flexcan_bridge_set(test_bridge);
+
+  if( phy==aospi_phy_mcua ) {
+    printf("packing\n");
+    test_pack(phy);
+    printf("%s\n", test_fails ? "FAIL" : "PASS");
+    return test_fails ? 1 : 0;
+  }
+
+  printf("txring\n");
+  for( int depth=1; depth<=AOSPI_TXRING_MAXDEPTH; depth++ ) test_txring(depth);
+  test_txring_noprio();
+  printf("packing\n");
+  test_pack(phy);
+  printf("rx ring and tags\n");
+  test_rxring();
+  printf("callbacks\n");
+  test_callback();
+  printf("bench (modelled bus time, 64 byte frames)\n");
+  test_bench_scaling();
+
+  printf("%s\n", test_fails ? "FAIL" : "PASS");
+  return test_fails ? 1 : 0;
+}
@@ -0,0 +1,190 @@
+// aospi_lpspi_test.c - host test: the LPSPI and the loop back backends of aospi on a model of LPSPI
+/*****************************************************************************
+ * Copyright 2024,2025 by ams OSRAM AG                                       *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <aoresult.h>     // aoresult_to_str
+#include <aospi.h>        // aospi_init, aospi_backend_lpspi, aospi_backend_loopback
+#include "fsl_lpspi.h"    // host_lpspi_xxx (host/host_lpspi.c)
+
+
+// Runs aospi_lpspi.c on the host, with host/host_lpspi.c in place of the
+// LPSPI driver: SPI OUT clocks telegrams out to a chain model that answers
+// on SPI IN. Also runs aospi_loopback.c (aospi_init runs once per program,
+// so the loop back backend has its own run).
+//
+// Build (on a PC, from this directory)
+//   make build/aospi_lpspi_test
+// Run
+//   build/aospi_lpspi_test           (LPSPI backend)
+//   build/aospi_lpspi_test loopback  (loop back backend)
+//
+// Checks, for the LPSPI backend
+//   - a telegram goes out on SPI OUT as is, in the bus time of its bytes
+//   - a batch goes out as one SPI OUT transfer per telegram
+//   - a response lands in the request; a missing response times out; a
+//     short response is reported with its actual size
+// and, for the loop back backend
+//   - a request completes as sent, a request with response gets its own
+//     telegram back
+
+
+static int test_fails;
+
+
+// Records a failed check
+static void test_check( int ok, const char * what ) {
+  if( !ok ) { printf("  FAIL %s\n", what); test_fails++; }
+}
+
+
+// === chain model ==========================================================
+
+
+#define TEST_LOGSIZE 64
+static struct { int size; uint8_t data[AOSPI_TELE_MAXSIZE]; } test_log[TEST_LOGSIZE];
+static int test_logcount;
+static int test_respsize; // size of the response to a telegram (0 for none)
+
+
+// Returns the response byte `j` to telegram `tele`
+static uint8_t test_respbyte( const uint8_t * tele, int j ) {
+  return j==0 ? 0xA0 : (uint8_t)(tele[1] + j);
+}
+
+
+// Logs the telegrams on SPI OUT, and answers them with test_respsize bytes after 20us
+static void test_chain( const uint8_t * data, int size ) {
+  if( test_logcount<TEST_LOGSIZE && size<=AOSPI_TELE_MAXSIZE ) {
+    test_log[test_logcount].size = size;
+    memcpy(test_log[test_logcount].data, data, size);
+    test_logcount++;
+  }
+  if( test_respsize==0 ) return;
+  uint8_t resp[AOSPI_TELE_MAXSIZE];
+  for( int j=0; j<test_respsize; j++ ) resp[j] = test_respbyte(data,j);
+  host_lpspi_respond(resp, test_respsize, 20);
+}
+
+
+// === LPSPI ================================================================
+
+
+// Checks a telegram without response, and a batch
+static void test_lpspi_tx( void ) {
+  static aospi_req_t req;
+  uint8_t tele[4] = { 0xA0, 0x04, 0x02, 0x5C };
+  test_logcount = 0;
+  test_respsize = 0;
+  aoresult_t result = aospi_submit(&req, tele, sizeof tele, 0, 0);
+  if( result==aoresult_ok ) result = aospi_wait(&req);
+  printf("  tx: %s, %d telegram(s) on SPI OUT, %lu us at %lu Hz\n", aoresult_to_str(result,0), test_logcount, (unsigned long)req.us, (unsigned long)host_lpspi_baudrate());
+  test_check( result==aoresult_ok, "tx: ok" );
+  test_check( test_logcount==1 && test_log[0].size==4 && memcmp(test_log[0].data,tele,4)==0, "tx: the telegram on SPI OUT" );
+  test_check( req.us>=8*4*1000000/host_lpspi_baudrate(), "tx: takes the bus time of the telegram" );
+
+  uint8_t teles[5][AOSPI_TELE_MAXSIZE];
+  const uint8_t * ptrs[5];
+  int sizes[5];
+  for( int t=0; t<5; t++ ) {
+    sizes[t] = 3 + t*2;
+    for( int i=0; i<sizes[t]; i++ ) teles[t][i] = (uint8_t)(0xA0 + t*16 + i);
+    ptrs[t] = teles[t];
+  }
+  test_logcount = 0;
+  result = aospi_tx_batch(ptrs, sizes, 5);
+  int match = test_logcount==5;
+  for( int t=0; t<5 && match; t++ ) match = test_log[t].size==sizes[t] && memcmp(test_log[t].data,teles[t],sizes[t])==0;
+  printf("  batch: %s, %d telegram(s) on SPI OUT\n", aoresult_to_str(result,0), test_logcount);
+  test_check( result==aoresult_ok && match, "batch: one SPI OUT transfer per telegram" );
+}
+
+
+// Checks requests with response: answered, not answered and answered short
+static void test_lpspi_txrx( void ) {
+  static aospi_req_t req;
+  uint8_t tele[4] = { 0xA0, 0x05, 0x0E, 0x00 };
+  uint8_t rx[8];
+  aoresult_t result;
+
+  test_respsize = 8;
+  memset(rx, 0, sizeof rx);
+  result = aospi_submit(&req, tele, sizeof tele, rx, sizeof rx);
+  if( result==aoresult_ok ) result = aospi_wait(&req);
+  int match = req.actsize==8;
+  for( int j=0; j<8 && match; j++ ) match = rx[j]==test_respbyte(tele,j);
+  printf("  response: %s, %d bytes in %lu us\n", aoresult_to_str(result,0), req.actsize, (unsigned long)req.us);
+  test_check( result==aoresult_ok && match, "response: lands in the request" );
+
+  uint32_t timeout = aospi_timeout_get();
+  aospi_timeout_set(1000);
+  test_respsize = 0;
+  result = aospi_submit(&req, tele, sizeof tele, rx, sizeof rx);
+  if( result==aoresult_ok ) result = aospi_wait(&req);
+  printf("  no response: %s after %lu us\n", aoresult_to_str(result,0), (unsigned long)req.us);
+  test_check( result==aoresult_spi_noclock && req.us>=1000, "no response: times out" );
+
+  test_respsize = 3;
+  result = aospi_submit(&req, tele, sizeof tele, rx, sizeof rx);
+  if( result==aoresult_ok ) result = aospi_wait(&req);
+  printf("  short response: %s, %d bytes\n", aoresult_to_str(result,0), req.actsize);
+  test_check( result==aoresult_ok && req.actsize==3, "short response: reported with its size" );
+  aospi_timeout_set(timeout);
+  test_respsize = 0;
+}
+
+
+// === loop back ============================================================
+
+
+// Checks that requests complete, and that a response echoes the telegram
+static void test_loopback( void ) {
+  static aospi_req_t req;
+  uint8_t tele[6] = { 0xA0, 0x07, 0x4F, 0x11, 0x22, 0x00 };
+  uint8_t rx[8];
+  aospi_txcount_reset();
+  aoresult_t result = aospi_submit(&req, tele, sizeof tele, 0, 0);
+  if( result==aoresult_ok ) result = aospi_wait(&req);
+  test_check( result==aoresult_ok && aospi_txcount_get()==1, "tx: completes as sent" );
+  memset(rx, 0, sizeof rx);
+  result = aospi_submit(&req, tele, sizeof tele, rx, sizeof rx);
+  if( result==aoresult_ok ) result = aospi_wait(&req);
+  printf("  txrx: %s, %d bytes back\n", aoresult_to_str(result,0), req.actsize);
+  test_check( result==aoresult_ok && req.actsize==6 && memcmp(rx,tele,6)==0, "txrx: the telegram comes back" );
+}
+
+
+int main( int argc, char * argv[] ) {
+  if( argc>1 && strcmp(argv[1],"loopback")==0 ) {
+    aospi_init(aospi_phy_mcub, &aospi_backend_loopback);
+    printf("loop back\n");
+    test_loopback();
+  } else {
+    aospi_init(aospi_phy_mcub, &aospi_backend_lpspi);
+    host_lpspi_chain_set(test_chain);
+    printf("tx\n");
+    test_lpspi_tx();
+    printf("txrx\n");
+    test_lpspi_txrx();
+  }
+
+  printf("%s\n", test_fails ? "FAIL" : "PASS");
+  return test_fails ? 1 : 0;
+}
@@ -0,0 +1,191 @@
+// aospi_pack_test.c - host test: the word packer of aospi_flexcan.c against the byte loops it replaced
+/*****************************************************************************
+ * Copyright 2024,2025 by ams OSRAM AG                                       *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+// The packer is internal to aospi_flexcan.c (static), so the test includes it
+#include "../osp_aospi/aospi/aospi_flexcan.c"
+
+
+// Compares aospi_words_pack() and aospi_words_unpack() with the code they
+// replaced: the TX path that staged the telegram in temp_arr[] and built
+// the frame words byte by byte, and the RX path that converted the frame
+// words with convert_to_big_endian_uint8() into a staging array before
+// copying the telegram out. Both are kept below, as they were, as the
+// reference.
+//
+// Build (on a PC, from this directory)
+//   make build/aospi_pack_test
+// Run
+//   build/aospi_pack_test
+//
+// Checks, for every telegram size (0..AOSPI_TELE_MAXSIZE, and the doubled
+// size of a Manchester encoded telegram), on random bytes
+//   - the packer gives the same frame words as the reference
+//   - the unpacker gives the same bytes as the reference
+// and reports ns per packed and per unpacked telegram for both (host timing).
+
+
+static int test_fails;
+
+
+// Records a failed check
+static void test_check( int ok, const char * what ) {
+  if( !ok ) { printf("  FAIL %s\n", what); test_fails++; }
+}
+
+
+// Returns a pseudo random number (xorshift64), the same sequence on every run
+static uint32_t test_rand( void ) {
+  static uint64_t x = 88172645463325252ULL;
+  x ^= x<<13; x ^= x>>7; x ^= x<<17;
+  return (uint32_t)x;
+}
+
+
+// === reference ============================================================
+
+
+// Packs `tx` in `words` as the old aospi_tx_internal() did (via temp_arr)
+static void test_ref_pack( uint32_t * words, const uint8_t * tx, int txsize ) {
+  uint32_t data_temp = 0;
+  uint8_t temp_arr[50] = {0},Temp = 0, j = 0, i = 0;
+  memset(temp_arr, 0, sizeof(temp_arr));
+  memcpy(temp_arr, tx, txsize);
+  for(i = 0; i < (txsize / 4); i++) {
+    for(j = Temp; j < (4 + Temp); j++) {
+      data_temp = (temp_arr[j] << 24);
+      j++;
+      data_temp |= (temp_arr[j] << 16);
+      j++;
+      data_temp |= (temp_arr[j] << 8);
+      j++;
+      data_temp |= temp_arr[j];
+    }
+    Temp = j;
+    words[i] = data_temp;
+  }
+  data_temp = 0;
+  for(uint8_t k = 0; k < (txsize % 4); k++) {
+    data_temp |= (temp_arr[Temp + k + 0] << (8 * (3 - k)));
+  }
+  words[i] = data_temp;
+}
+
+
+// The old RX conversion of frame words to bytes
+static void convert_to_big_endian_uint8(uint32_t source[], uint8_t destination[], size_t num_elements) {
+  for (size_t i = 0; i < num_elements; i++) {
+    uint32_t value = source[i];
+    size_t dest_index = i * 4;
+    destination[dest_index + 0] = (uint8_t)(value >> 24);
+    destination[dest_index + 1] = (uint8_t)(value >> 16);
+    destination[dest_index + 2] = (uint8_t)(value >> 8);
+    destination[dest_index + 3] = (uint8_t)value;
+  }
+}
+
+
+// Unpacks `size` bytes of `words` to `rx` as the old aospi_txrx() did (via data_recive_convert)
+static void test_ref_unpack( uint8_t * rx, uint32_t * words, int size ) {
+  uint8_t data_recive_convert[50];
+  memset(data_recive_convert, 0, sizeof(data_recive_convert));
+  // The old code passed the byte count as the word count; that overruns
+  // these buffers for the larger sizes here, so convert just the words needed
+  convert_to_big_endian_uint8(words, data_recive_convert, (size+3)/4);
+  memcpy(rx, data_recive_convert, size);
+}
+
+
+// === compare ==============================================================
+
+
+#define TEST_MAXSIZE (2*AOSPI_TELE_MAXSIZE) // a Manchester encoded telegram
+#define TEST_RUNS    10000 // per size
+
+
+// Compares packer and unpacker with the reference on random telegrams of every size
+static void test_compare( void ) {
+  long count = 0, packs = 0, unpacks = 0;
+  for( int size=0; size<=TEST_MAXSIZE; size++ ) {
+    int wordcount = (size+3)/4;
+    for( int run=0; run<TEST_RUNS; run++ ) {
+      uint8_t  tele[TEST_MAXSIZE], rx1[TEST_MAXSIZE], rx2[TEST_MAXSIZE];
+      uint32_t words1[16], words2[16];
+      for( int i=0; i<size; i++ ) tele[i] = (uint8_t)test_rand();
+      test_ref_pack(words1, tele, size);
+      aospi_words_pack(words2, wordcount, tele, size);
+      count++;
+      if( memcmp(words1,words2,wordcount*4)!=0 ) { if( packs++<5 ) printf("  size %d: words differ\n", size); continue; }
+      test_ref_unpack(rx1, words1, size);
+      aospi_words_unpack(rx2, words2, 0, size);
+      if( memcmp(rx1,tele,size)!=0 || memcmp(rx2,tele,size)!=0 ) { if( unpacks++<5 ) printf("  size %d: bytes differ\n", size); }
+    }
+  }
+  printf("  %ld telegrams: %ld packs and %ld unpacks differ\n", count, packs, unpacks);
+  test_check( packs==0, "packs" );
+  test_check( unpacks==0, "unpacks" );
+}
+
+
+// === benchmark ============================================================
+
+
+// Returns the time in ns
+static double test_ns( void ) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+
+// Reports ns per packed and per unpacked telegram of `size` bytes, for the reference and the word packer
+static void test_bench( int size ) {
+  uint8_t  tele[TEST_MAXSIZE], rx[TEST_MAXSIZE];
+  uint32_t words[16];
+  int      wordcount = (size+3)/4;
+  for( int i=0; i<size; i++ ) tele[i] = (uint8_t)test_rand();
+  const int runs = 10000000;
+  double t0 = test_ns();
+  for( int i=0; i<runs; i++ ) { test_ref_pack(words, tele, size); __asm__ volatile("" :: "r"(words), "r"(tele) : "memory"); }
+  double t1 = test_ns();
+  for( int i=0; i<runs; i++ ) { aospi_words_pack(words, wordcount, tele, size); __asm__ volatile("" :: "r"(words), "r"(tele) : "memory"); }
+  double t2 = test_ns();
+  for( int i=0; i<runs; i++ ) { test_ref_unpack(rx, words, size); __asm__ volatile("" :: "r"(words), "r"(rx) : "memory"); }
+  double t3 = test_ns();
+  for( int i=0; i<runs; i++ ) { aospi_words_unpack(rx, words, 0, size); __asm__ volatile("" :: "r"(words), "r"(rx) : "memory"); }
+  double t4 = test_ns();
+  printf("  %2d bytes: pack reference %.1f ns, words %.1f ns; unpack reference %.1f ns, words %.1f ns\n",
+    size, (t1-t0)/runs, (t2-t1)/runs, (t3-t2)/runs, (t4-t3)/runs);
+  test_check( memcmp(rx,tele,size)==0, "benchmark telegram unpacked" );
+}
+
+
+int main( void ) {
+  printf("compare (reference byte loops)\n");
+  test_compare();
+  printf("benchmark (host)\n");
+  test_bench(AOSPI_TELE_MAXSIZE);
+  test_bench(TEST_MAXSIZE);
+
+  printf("%s\n", test_fails ? "FAIL" : "PASS");
+  return test_fails ? 1 : 0;
+}
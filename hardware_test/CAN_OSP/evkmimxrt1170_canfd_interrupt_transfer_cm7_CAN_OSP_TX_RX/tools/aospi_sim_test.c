@@ -0,0 +1,145 @@
+// aospi_sim_test.c - host test: aoosp against the virtual OSP chain of aospi (aospi_backend_sim)
+/*****************************************************************************
+ * Copyright 2024,2025 by ams OSRAM AG                                       *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <aoresult.h>     // aoresult_to_str
+#include <aospi.h>        // aospi_backend_sim, aospi_sim_xxx
+#include <aoosp.h>        // aoosp_exec_resetinit, aoosp_send_identify
+
+
+// Runs the real aoosp code against aospi_sim.c, on a chain of 1000 nodes:
+// every tenth node a SAID, node 4 a SAID with I2C bridge, the others RGBIs.
+//
+// Build (on a PC, from this directory)
+//   make build/aospi_sim_test
+// Run
+//   build/aospi_sim_test        (MCU-B, BiDir)
+//   build/aospi_sim_test mcua   (MCU-A, so Manchester coded, Loop)
+//
+// Checks
+//   - RESET and INIT find all nodes, in the wired direction
+//   - IDENTIFY of the first and last node; the round trip time gives the
+//     number of hops (BiDir) or is the same for all nodes (Loop)
+//   - state changes (GOACTIVE) show in READTEMPSTAT
+//   - I2C write and read back via the bridge, and a NACK from a missing device
+//   - SETPWMCHN reaches the node, and no telegram is dropped
+//   - a response that takes longer than the time-out is a time-out
+// and reports the host time and the modelled link time of 1000 IDENTIFYs.
+
+
+#define TEST_NODES 1000
+
+
+static int test_fails;
+
+
+// Records a failed check
+static void test_check( int ok, const char * what ) {
+  if( !ok ) { printf("  FAIL %s\n", what); test_fails++; }
+}
+
+
+int main( int argc, char * argv[] ) {
+  // aospi_init() runs once per program, so MCU-A has its own run
+  int mcua = argc>1 && strcmp(argv[1],"mcua")==0;
+  aospi_init(mcua ? aospi_phy_mcua : aospi_phy_mcub, &aospi_backend_sim);
+
+  static char chain[TEST_NODES+1];
+  for( int i=0; i<TEST_NODES; i++ ) chain[i] = i%10==0 ? 'S' : 'R';
+  chain[3] = 'I';
+  chain[TEST_NODES] = 0;
+  aoresult_t result = aospi_sim_chain_set(chain, mcua);
+  test_check( result==aoresult_ok, "chain set" );
+
+  printf("reset and init\n");
+  uint16_t last;
+  int      loop;
+  result = aoosp_exec_resetinit(&last, &loop);
+  printf("  %s, last %u, %s, modelled %llu us\n", aoresult_to_str(result,0), last, loop ? "loop" : "bidir", (unsigned long long)aospi_sim_time_us());
+  test_check( result==aoresult_ok && last==TEST_NODES && loop==mcua, "resetinit" );
+
+  printf("identify\n");
+  uint32_t id1, idn, us1, usn, hopsn;
+  result = aoosp_send_identify(1, &id1);
+  us1 = aospi_txrx_us();
+  test_check( result==aoresult_ok && id1==0x00000040, "identify first (SAID)" );
+  result = aoosp_send_identify(TEST_NODES, &idn);
+  usn = aospi_txrx_us();
+  hopsn = aospi_txrx_hops(0);
+  test_check( result==aoresult_ok && idn==0x00000000, "identify last (RGBI)" );
+  printf("  node 1: %08lX %lu us, node %d: %08lX %lu us, %lu hops\n", (unsigned long)id1, (unsigned long)us1, TEST_NODES, (unsigned long)idn, (unsigned long)usn, (unsigned long)hopsn);
+  if( mcua ) test_check( us1==usn, "loop: same round trip for all nodes" );
+  else test_check( hopsn==2*(TEST_NODES-1), "bidir: hops to the last node and back" );
+
+  printf("state\n");
+  uint8_t temp, stat1, stat2;
+  result = aoosp_send_readtempstat(1, &temp, &stat1);
+  test_check( result==aoresult_ok, "readtempstat" );
+  aoosp_send_clrerror(0);
+  aoosp_send_goactive(0);
+  result = aoosp_send_readtempstat(1, &temp, &stat2);
+  printf("  %s", aoosp_prt_stat_state(stat1));
+  printf(" then %s\n", aoosp_prt_stat_state(stat2));
+  test_check( result==aoresult_ok && (stat1>>6)==1 && (stat2>>6)==2, "sleep then active" );
+
+  printf("i2c\n");
+  uint8_t wbuf[2] = { 0x12, 0x34 };
+  uint8_t rbuf[2] = { 0 };
+  int     enable4, enable1;
+  test_check( aoosp_exec_i2cpower(4)==aoresult_ok, "i2cpower" );
+  test_check( aoosp_exec_i2cenable_get(4,&enable4)==aoresult_ok && enable4==1, "i2c bridge on node 4" );
+  test_check( aoosp_exec_i2cenable_get(1,&enable1)==aoresult_ok && enable1==0, "no i2c bridge on node 1" );
+  test_check( aoosp_exec_i2cwrite8(4, 0x50, 0x10, wbuf, 2)==aoresult_ok, "i2c write" );
+  result = aoosp_exec_i2cread8(4, 0x50, 0x10, rbuf, 2);
+  printf("  read back %s %02X %02X\n", aoresult_to_str(result,0), rbuf[0], rbuf[1]);
+  test_check( result==aoresult_ok && rbuf[0]==0x12 && rbuf[1]==0x34, "i2c read back" );
+  result = aoosp_exec_i2cread8(4, 0x51, 0x10, rbuf, 2);
+  printf("  missing device %s\n", aoresult_to_str(result,0));
+  test_check( result==aoresult_dev_i2cnack, "i2c nack" );
+
+  printf("pwm\n");
+  uint16_t rgb[3];
+  result = aoosp_send_setpwmchn(1, 0, 100, 200, 300);
+  test_check( result==aoresult_ok && aospi_sim_pwm_get(1, 0, rgb)==aoresult_ok && rgb[0]==100 && rgb[1]==200 && rgb[2]==300, "setpwmchn" );
+  printf("  %s, %d dropped\n", aoresult_to_str(result,0), aospi_sim_dropcount_get());
+  test_check( aospi_sim_dropcount_get()==0, "no drops" );
+
+  printf("time-out\n");
+  uint32_t timeout = aospi_timeout_get();
+  aospi_timeout_set(usn/2);
+  result = aoosp_send_identify(TEST_NODES, &idn);
+  aospi_timeout_set(timeout);
+  printf("  time-out %lu us: %s\n", (unsigned long)(usn/2), aoresult_to_str(result,0));
+  test_check( result==aoresult_spi_noclock, "time-out" );
+
+  printf("identify all\n");
+  uint64_t t0 = aospi_sim_time_us();
+  clock_t  c0 = clock();
+  int      fails = 0;
+  for( int addr=1; addr<=TEST_NODES; addr++ ) fails += aoosp_send_identify(addr, &idn)!=aoresult_ok;
+  double ms = (double)(clock()-c0) * 1000 / CLOCKS_PER_SEC;
+  printf("  %d nodes: host %.3f ms, modelled %llu us\n", TEST_NODES, ms, (unsigned long long)(aospi_sim_time_us()-t0));
+  test_check( fails==0, "identify all" );
+
+  printf("%s\n", test_fails ? "FAIL" : "PASS");
+  return test_fails ? 1 : 0;
+}
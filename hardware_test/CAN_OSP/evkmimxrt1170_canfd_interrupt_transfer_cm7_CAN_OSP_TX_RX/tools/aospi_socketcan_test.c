@@ -0,0 +1,245 @@
+// aospi_socketcan_test.c - host test: the SocketCAN backend of aospi against a bridge model on a (virtual) CAN interface
+/*****************************************************************************
+ * Copyright 2024,2025 by ams OSRAM AG                                       *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <aoresult.h>     // aoresult_to_str
+#include <aospi.h>        // aospi_init, aospi_backend_socketcan
+#include <aospi_frame.h>  // AOSPI_FRAME_TAGBASE
+
+
+// Runs aospi_socketcan.c on a Linux host. The test plays the CAN-to-OSP
+// bridge itself, on a second socket on the same interface: it reads the
+// frames aospi sends (ID 0x123) and answers them (ID 0x321).
+//
+// Build (on a PC, from this directory)
+//   make build/aospi_socketcan_test
+// Run (needs a CAN-FD interface, eg a virtual one)
+//   sudo ip link add dev vcan0 type vcan && sudo ip link set vcan0 mtu 72 up
+//   build/aospi_socketcan_test
+// The interface is vcan0, unless AOSPI_SOCKETCAN_IF names another. Without
+// the interface the test prints SKIP (and passes).
+//
+// Checks
+//   - a telegram without response goes out untagged, zero padded to 24 bytes
+//   - pipelined requests go out tagged, and each response (answered in
+//     reverse order) lands in its own request
+//   - an untagged response goes to the oldest outstanding request
+//   - a lost response ends the request with a time-out
+
+
+static int test_fails;
+
+
+// Records a failed check
+static void test_check( int ok, const char * what ) {
+  if( !ok ) { printf("  FAIL %s\n", what); test_fails++; }
+}
+
+
+// === bridge model =========================================================
+
+
+static int test_fd = -1;
+
+
+// Opens the bridge socket on interface `ifname`; returns 0 when there is no such interface
+static int test_bridge_open( const char * ifname ) {
+  int fd = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+  if( fd<0 ) return 0;
+  int enable = 1;
+  struct ifreq ifr;
+  memset(&ifr, 0, sizeof(ifr));
+  strncpy(ifr.ifr_name, ifname, IFNAMSIZ-1);
+  struct can_filter filter = { .can_id = 0x123, .can_mask = CAN_SFF_MASK };
+  struct sockaddr_can addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.can_family = AF_CAN;
+  if( setsockopt(fd, SOL_CAN_RAW, CAN_RAW_FD_FRAMES, &enable, sizeof(enable))<0
+   || setsockopt(fd, SOL_CAN_RAW, CAN_RAW_FILTER, &filter, sizeof(filter))<0
+   || ioctl(fd, SIOCGIFINDEX, &ifr)<0
+   || (addr.can_ifindex = ifr.ifr_ifindex, bind(fd, (struct sockaddr *)&addr, sizeof(addr)))<0
+   || fcntl(fd, F_SETFL, O_NONBLOCK)<0 ) {
+    close(fd);
+    return 0;
+  }
+  test_fd = fd;
+  return 1;
+}
+
+
+// Returns a monotonic time stamp in ms
+static uint64_t test_ms( void ) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000ULL + ts.tv_nsec / 1000000;
+}
+
+
+// Reads the next frame aospi sent into `frame` (polling aospi meanwhile); returns 0 when none comes within 500 ms
+static int test_bridge_read( struct canfd_frame * frame ) {
+  uint64_t t0 = test_ms();
+  while( test_ms() - t0 < 500 ) {
+    if( read(test_fd, frame, sizeof(*frame))>0 ) return 1;
+    aospi_poll();
+  }
+  return 0;
+}
+
+
+// Sends a response frame with payload `data` of `size` bytes to aospi
+static void test_bridge_write( const uint8_t * data, int size ) {
+  struct canfd_frame frame;
+  memset(&frame, 0, sizeof(frame));
+  frame.can_id = 0x321;
+  frame.flags  = CANFD_BRS;
+  frame.len    = (uint8_t)aospi_frame_dlc2size(aospi_frame_size2dlc(size < 24 ? 24 : size));
+  memcpy(frame.data, data, size);
+  if( write(test_fd, &frame, CANFD_MTU)!=CANFD_MTU ) test_check( 0, "bridge write" );
+}
+
+
+// Returns the response byte `j` for request `i` (an OSP telegram starts with preamble A, below the tags)
+static uint8_t test_respbyte( int i, int j ) {
+  return j==0 ? 0xA0 : (uint8_t)(i*8 + j);
+}
+
+
+// === tests ================================================================
+
+
+#define TEST_RXREQS 8
+static aospi_req_t test_rxreqs[TEST_RXREQS];
+static uint8_t     test_rx[TEST_RXREQS][8];
+
+
+// Submits TEST_RXREQS requests with response; telegram byte 1 holds the index
+static void test_submit( void ) {
+  for( int i=0; i<TEST_RXREQS; i++ ) {
+    uint8_t tele[4] = { 0xA0, (uint8_t)i, 0x07, 0x00 };
+    memset(test_rx[i], 0, sizeof test_rx[i]);
+    aospi_submit(&test_rxreqs[i], tele, sizeof tele, test_rx[i], sizeof test_rx[i]);
+  }
+}
+
+
+// Returns the number of requests that got their own response
+static int test_matched( void ) {
+  int matched = 0;
+  for( int i=0; i<TEST_RXREQS; i++ ) {
+    int ok = aospi_wait(&test_rxreqs[i])==aoresult_ok && test_rxreqs[i].actsize==8;
+    for( int j=0; j<8; j++ ) ok = ok && test_rx[i][j]==test_respbyte(i,j);
+    matched += ok;
+  }
+  return matched;
+}
+
+
+// Checks that a telegram without response goes out untagged and padded
+static void test_tx( void ) {
+  const uint8_t tele[4] = { 0xA0, 0x04, 0x02, 0x5A };
+  struct canfd_frame frame;
+  aoresult_t result = aospi_tx(tele, sizeof tele);
+  int ok = result==aoresult_ok && test_bridge_read(&frame) && frame.len==24 && memcmp(frame.data, tele, sizeof tele)==0;
+  for( int j=sizeof tele; ok && j<24; j++ ) ok = frame.data[j]==0;
+  printf("  tx      : %s\n", ok ? "untagged, 24 bytes" : "mismatch");
+  test_check( ok, "tx" );
+}
+
+
+// Checks pipelined requests, answered in reverse order
+static void test_reverse( void ) {
+  struct canfd_frame frames[TEST_RXREQS];
+  test_submit();
+  int got = 0;
+  while( got<TEST_RXREQS && test_bridge_read(&frames[got]) ) got++;
+  int tagged = 0;
+  for( int k=0; k<got; k++ ) tagged += frames[k].data[0]>=AOSPI_FRAME_TAGBASE;
+  for( int k=got-1; k>=0; k-- ) {
+    uint8_t resp[2+8];
+    int     i = frames[k].data[3]; // tag, length, telegram
+    resp[0] = frames[k].data[0];
+    resp[1] = 8;
+    for( int j=0; j<8; j++ ) resp[2+j] = test_respbyte(i,j);
+    test_bridge_write(resp, sizeof resp);
+  }
+  int matched = test_matched();
+  printf("  reverse : %d/%d tagged, %d/%d matched\n", tagged, TEST_RXREQS, matched, TEST_RXREQS);
+  test_check( got==TEST_RXREQS && tagged==TEST_RXREQS && matched==TEST_RXREQS, "reverse" );
+}
+
+
+// Checks untagged responses (the bridge answers in order, without tags)
+static void test_untagged( void ) {
+  struct canfd_frame frame;
+  test_submit();
+  for( int k=0; k<TEST_RXREQS && test_bridge_read(&frame); k++ ) {
+    uint8_t resp[8];
+    for( int j=0; j<8; j++ ) resp[j] = test_respbyte(frame.data[3],j);
+    test_bridge_write(resp, sizeof resp);
+  }
+  int matched = test_matched();
+  printf("  untagged: %d/%d matched\n", matched, TEST_RXREQS);
+  test_check( matched==TEST_RXREQS, "untagged" );
+}
+
+
+// Checks that a request without an answer times out
+static void test_lost( void ) {
+  struct canfd_frame frame;
+  uint32_t timeout = aospi_timeout_get();
+  aospi_timeout_set(20000);
+  uint8_t tele[4] = { 0xA0, 0x00, 0x07, 0x00 };
+  aospi_submit(&test_rxreqs[0], tele, sizeof tele, test_rx[0], sizeof test_rx[0]);
+  int sent = test_bridge_read(&frame);
+  aoresult_t result = aospi_wait(&test_rxreqs[0]);
+  aospi_timeout_set(timeout);
+  printf("  lost    : %s\n", aoresult_to_str(result,0));
+  test_check( sent && result==aoresult_spi_noclock, "lost" );
+}
+
+
+int main( void ) {
+  const char * ifname = getenv("AOSPI_SOCKETCAN_IF");
+  if( ifname==0 ) ifname = "vcan0";
+  if( !test_bridge_open(ifname) ) {
+    printf("no CAN interface %s\nSKIP\n", ifname);
+    return 0;
+  }
+  aospi_init(aospi_phy_mcub, &aospi_backend_socketcan);
+
+  printf("socketcan on %s\n", ifname);
+  test_tx();
+  test_reverse();
+  test_untagged();
+  test_lost();
+
+  printf("%s\n", test_fails ? "FAIL" : "PASS");
+  return test_fails ? 1 : 0;
+}
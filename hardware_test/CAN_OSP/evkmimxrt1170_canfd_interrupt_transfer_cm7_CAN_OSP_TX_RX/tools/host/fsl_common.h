@@ -0,0 +1,72 @@
+// fsl_common.h - host stand-in for the MCUXpresso SDK header of the same name (tools/ builds only)
+/*****************************************************************************
+ * Copyright 2024,2025 by ams OSRAM AG                                       *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#ifndef _HOST_FSL_COMMON_H_
+#define _HOST_FSL_COMMON_H_
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+
+// Only what the osp_aospi sources use is declared here; host.c implements
+// the functions. The host has no interrupts and no clock: time is a counter
+// that only advances when the firmware waits (SDK_DelayAtLeastUs) or polls
+// (each EnableGlobalIRQ takes 1 us). Enabling interrupts runs the events of
+// the FlexCAN and LPSPI models that are due (see host_flexcan_irq and
+// host_lpspi_irq).
+
+
+typedef int32_t status_t;
+enum { kStatus_Success= 0, kStatus_Fail= 1, kStatus_InvalidArgument= 4, kStatus_Timeout= 5 };
+#define MAKE_STATUS(group,code) ((status_t)((group)*100+(code)))
+
+
+#define SDK_DEVICE_MAXIMUM_CPU_CLOCK_FREQUENCY 996000000UL
+extern uint32_t SystemCoreClock;
+void     SDK_DelayAtLeastUs( uint32_t delayTime_us, uint32_t coreClock_Hz );
+uint32_t DisableGlobalIRQ( void );
+void     EnableGlobalIRQ( uint32_t primask );
+
+
+typedef struct { volatile uint32_t CTRL; volatile uint32_t CYCCNT; } DWT_Type;
+typedef struct { volatile uint32_t DEMCR; } CoreDebug_Type;
+extern DWT_Type       * DWT;
+extern CoreDebug_Type * CoreDebug;
+#define DWT_CTRL_CYCCNTENA_Msk      (1UL<<0)
+#define CoreDebug_DEMCR_TRCENA_Msk  (1UL<<24)
+// Returns the time in us since start; DWT->CYCCNT counts the same time in cycles of SystemCoreClock
+uint64_t host_us( void );
+// Advances the time by `us` microseconds
+void host_us_step( uint32_t us );
+
+
+#define __REV(x) __builtin_bswap32(x)
+
+
+typedef enum { kCLOCK_Root_Can1, kCLOCK_Root_Can2, kCLOCK_Root_Can3, kCLOCK_Root_Lpspi1, kCLOCK_Root_Lpspi4 } clock_root_t;
+typedef struct { uint8_t clockOff; uint8_t mux; uint8_t div; } clock_root_config_t;
+void     CLOCK_SetRootClock( clock_root_t root, const clock_root_config_t * config );
+uint32_t CLOCK_GetRootClockFreq( clock_root_t root );
+
+
+#endif
@@ -0,0 +1,183 @@
+// fsl_flexcan.h - host stand-in for the MCUXpresso SDK header of the same name (tools/ builds only)
+/*****************************************************************************
+ * Copyright 2024,2025 by ams OSRAM AG                                       *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#ifndef _HOST_FSL_FLEXCAN_H_
+#define _HOST_FSL_FLEXCAN_H_
+
+
+#include "fsl_common.h"
+
+
+// The types and functions aospi_flexcan.c uses, with the SDK's layout.
+// host_flexcan.c implements them as a model of the two controllers (CAN2
+// and CAN3) and their buses; see the host_flexcan_xxx functions at the end.
+
+
+typedef struct {
+  volatile uint32_t MCR;
+  volatile uint32_t CTRL1;
+  volatile uint32_t FDCTRL;
+  volatile uint32_t IMASK1;
+  volatile uint32_t IMASK2;
+  struct { volatile uint32_t CS; volatile uint32_t ID; volatile uint32_t WORD0; volatile uint32_t WORD1; } MB[64]; // the MB RAM (8 byte view)
+} CAN_Type;
+extern CAN_Type * CAN2;
+extern CAN_Type * CAN3;
+#define CAN_MCR_LPRIOEN_MASK     (1UL<<13)
+#define CAN_CTRL1_LPB_MASK       (1UL<<12)
+#define CAN_FDCTRL_TDCEN_MASK    (1UL<<15)
+#define CAN_WORD1_COUNT          64
+#define CAN_CS_CODE_SHIFT        24
+#define CAN_CS_CODE_MASK         (0xFUL<<CAN_CS_CODE_SHIFT)
+#define CAN_CS_CODE(x)           ((((uint32_t)(x))<<CAN_CS_CODE_SHIFT) & CAN_CS_CODE_MASK)
+#define CAN_CS_DLC_SHIFT         16
+#define CAN_CS_DLC_MASK          (0xFUL<<CAN_CS_DLC_SHIFT)
+#define CAN_CS_DLC(x)            ((((uint32_t)(x))<<CAN_CS_DLC_SHIFT) & CAN_CS_DLC_MASK)
+#define CAN_CS_BRS_MASK          (1UL<<30)
+#define CAN_CS_BRS(x)            ((((uint32_t)(x))<<30) & CAN_CS_BRS_MASK)
+#define CAN_CS_EDL_MASK          (1UL<<31)
+#define CAN_CS_EDL(x)            ((((uint32_t)(x))<<31) & CAN_CS_EDL_MASK)
+#define CAN_ID_PRIO_SHIFT        29
+#define CAN_ID_PRIO_MASK         (0x7UL<<CAN_ID_PRIO_SHIFT)
+#define CAN_ID_PRIO(x)           ((((uint32_t)(x))<<CAN_ID_PRIO_SHIFT) & CAN_ID_PRIO_MASK)
+#define CAN_ID_STD_SHIFT         18
+#define CAN_ID_STD_MASK          (0x7FFUL<<CAN_ID_STD_SHIFT)
+#define FLEXCAN_ID_STD(id)       ((((uint32_t)(id))<<CAN_ID_STD_SHIFT) & CAN_ID_STD_MASK)
+#define FLEXCAN_RX_MB_STD_MASK(id,rtr,ide) ((((uint32_t)(rtr))<<31) | (((uint32_t)(ide))<<30) | FLEXCAN_ID_STD(id))
+
+
+#define kStatusGroup_FLEXCAN     53
+enum {
+  kStatus_FLEXCAN_TxBusy       = MAKE_STATUS(kStatusGroup_FLEXCAN, 0),
+  kStatus_FLEXCAN_TxIdle       = MAKE_STATUS(kStatusGroup_FLEXCAN, 1),
+  kStatus_FLEXCAN_TxSwitchToRx = MAKE_STATUS(kStatusGroup_FLEXCAN, 2),
+  kStatus_FLEXCAN_RxBusy       = MAKE_STATUS(kStatusGroup_FLEXCAN, 3),
+  kStatus_FLEXCAN_RxIdle       = MAKE_STATUS(kStatusGroup_FLEXCAN, 4),
+  kStatus_FLEXCAN_RxOverflow   = MAKE_STATUS(kStatusGroup_FLEXCAN, 5),
+  kStatus_FLEXCAN_WakeUp       = MAKE_STATUS(kStatusGroup_FLEXCAN, 13),
+};
+
+
+typedef enum { kFLEXCAN_FrameFormatStandard= 0, kFLEXCAN_FrameFormatExtend= 1 } flexcan_frame_format_t;
+typedef enum { kFLEXCAN_FrameTypeData= 0, kFLEXCAN_FrameTypeRemote= 1 } flexcan_frame_type_t;
+typedef enum { kFLEXCAN_8BperMB, kFLEXCAN_16BperMB, kFLEXCAN_32BperMB, kFLEXCAN_64BperMB } flexcan_mb_size_t;
+
+
+typedef struct _flexcan_fd_frame {
+  struct {
+    uint32_t timestamp : 16;
+    uint32_t length : 4;
+    uint32_t type : 1;
+    uint32_t format : 1;
+    uint32_t srr : 1;
+    uint32_t : 6;
+    uint32_t esi : 1;
+    uint32_t brs : 1;
+    uint32_t edl : 1;
+  };
+  struct {
+    uint32_t id : 29;
+    uint32_t : 3;
+  };
+  uint32_t dataWord[16];
+} flexcan_fd_frame_t;
+typedef struct _flexcan_frame flexcan_frame_t;
+
+
+typedef struct _flexcan_timing_config {
+  uint16_t preDivider, fpreDivider;
+  uint8_t  rJumpwidth, phaseSeg1, phaseSeg2, propSeg;
+  uint8_t  frJumpwidth, fphaseSeg1, fphaseSeg2, fpropSeg;
+} flexcan_timing_config_t;
+typedef struct _flexcan_config {
+  uint32_t bitRate;
+  uint32_t bitRateFD;
+  uint8_t  maxMbNum;
+  bool     enableLoopBack;
+  flexcan_timing_config_t timingConfig;
+} flexcan_config_t;
+typedef struct _flexcan_rx_mb_config {
+  uint32_t               id;
+  flexcan_frame_format_t format;
+  flexcan_frame_type_t   type;
+} flexcan_rx_mb_config_t;
+typedef struct _flexcan_mb_transfer {
+  flexcan_fd_frame_t * framefd;
+  flexcan_frame_t    * frame;
+  uint8_t              mbIdx;
+} flexcan_mb_transfer_t;
+
+
+typedef struct _flexcan_handle flexcan_handle_t;
+#define FLEXCAN_CALLBACK(x) \
+    void(x)(CAN_Type * base, flexcan_handle_t * handle, status_t status, uint64_t result, void *userData)
+typedef void (*flexcan_transfer_callback_t)( CAN_Type * base, flexcan_handle_t * handle, status_t status, uint64_t result, void * userData );
+struct _flexcan_handle {
+  flexcan_transfer_callback_t callback;
+  void                      * userData;
+  volatile uint8_t            mbState[CAN_WORD1_COUNT];
+};
+
+
+void     FLEXCAN_GetDefaultConfig( flexcan_config_t * config );
+bool     FLEXCAN_FDCalculateImprovedTimingValues( CAN_Type * base, uint32_t bitRate, uint32_t bitRateFD, uint32_t sourceClock_Hz, flexcan_timing_config_t * config );
+void     FLEXCAN_FDInit( CAN_Type * base, const flexcan_config_t * config, uint32_t sourceClock_Hz, flexcan_mb_size_t dataSize, bool brs );
+void     FLEXCAN_EnterFreezeMode( CAN_Type * base );
+void     FLEXCAN_ExitFreezeMode( CAN_Type * base );
+void     FLEXCAN_TransferCreateHandle( CAN_Type * base, flexcan_handle_t * handle, flexcan_transfer_callback_t callback, void * userData );
+void     FLEXCAN_SetRxMbGlobalMask( CAN_Type * base, uint32_t mask );
+void     FLEXCAN_SetFDRxMbConfig( CAN_Type * base, uint8_t mbIdx, const flexcan_rx_mb_config_t * config, bool enable );
+void     FLEXCAN_SetFDTxMbConfig( CAN_Type * base, uint8_t mbIdx, bool enable );
+status_t FLEXCAN_TransferFDSendNonBlocking( CAN_Type * base, flexcan_handle_t * handle, flexcan_mb_transfer_t * pMbXfer );
+status_t FLEXCAN_TransferFDReceiveNonBlocking( CAN_Type * base, flexcan_handle_t * handle, flexcan_mb_transfer_t * pMbXfer );
+void     FLEXCAN_TransferFDAbortSend( CAN_Type * base, flexcan_handle_t * handle, uint8_t mbIdx );
+// An inline in the SDK; in the model, enabling the interrupt of an activated TX MB hands its frame to the bus
+void     FLEXCAN_EnableMbInterrupts( CAN_Type * base, uint64_t mask );
+
+
+// === host model ===========================================================
+
+
+// The bridge model: called when `base` has put a frame with CAN ID `id` and payload `data[0..size-1]` on its bus.
+typedef void (*host_flexcan_bridge_t)( CAN_Type * base, uint32_t id, const uint8_t * data, int size );
+// Installs the bridge model (0: frames go nowhere, no responses)
+void host_flexcan_bridge_set( host_flexcan_bridge_t bridge );
+// Lets the bridge of `base` send a frame (CAN ID `id`, payload `data[0..size-1]`) that arrives `delay_us` after the current frame ended
+void host_flexcan_respond( CAN_Type * base, uint32_t id, const uint8_t * data, int size, uint32_t delay_us );
+// Runs the bus events (frames sent, frames received) that are due, calling the FlexCAN callback for each; host.c calls this when interrupts get enabled
+void host_flexcan_irq( void );
+// Sets the latency from the end of a frame to its TX interrupt handler (default 2us), e.g. to model a busy CPU
+void host_flexcan_isrus_set( uint32_t us );
+// Statistics per controller
+typedef struct host_flexcan_stats_s {
+  uint32_t frames;     // frames sent
+  uint32_t maxpending; // max number of TX MBs loaded at the same time
+  uint32_t gaps;       // frames that did not follow the previous frame back-to-back
+  uint64_t busus;      // time the bus was busy sending frames
+  uint64_t firstus;    // start of the first frame
+  uint64_t lastus;     // end of the last frame
+  uint32_t rxframes;   // frames received in an RX MB
+  uint32_t rxlost;     // frames received while no RX MB was armed
+} host_flexcan_stats_t;
+// Returns the statistics of `base` in `stats`, and clears them
+void host_flexcan_stats( CAN_Type * base, host_flexcan_stats_t * stats );
+
+
+#endif
@@ -0,0 +1,39 @@
+// fsl_gpio.h - host stand-in for the MCUXpresso SDK header of the same name (tools/ builds only)
+/*****************************************************************************
+ * Copyright 2024,2025 by ams OSRAM AG                                       *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#ifndef _HOST_FSL_GPIO_H_
+#define _HOST_FSL_GPIO_H_
+
+
+#include "fsl_common.h"
+
+
+// Pins are latched in DR; writes to DR_SET/DR_CLEAR (OENA) are not reflected in DR
+typedef struct { volatile uint32_t DR; volatile uint32_t GDIR; volatile uint32_t DR_SET; volatile uint32_t DR_CLEAR; } GPIO_Type;
+extern GPIO_Type * GPIO9;
+typedef enum { kGPIO_DigitalInput= 0, kGPIO_DigitalOutput= 1 } gpio_pin_direction_t;
+typedef enum { kGPIO_NoIntmode= 0 } gpio_interrupt_mode_t;
+typedef struct { gpio_pin_direction_t direction; uint8_t outputLogic; gpio_interrupt_mode_t interruptMode; } gpio_pin_config_t;
+void     GPIO_PinInit( GPIO_Type * base, uint32_t pin, const gpio_pin_config_t * config );
+void     GPIO_PinWrite( GPIO_Type * base, uint32_t pin, uint8_t output );
+uint32_t GPIO_PinRead( GPIO_Type * base, uint32_t pin );
+
+
+#endif
@@ -0,0 +1,106 @@
+// fsl_lpspi.h - host stand-in for the MCUXpresso SDK header of the same name (tools/ builds only)
+/*****************************************************************************
+ * Copyright 2024,2025 by ams OSRAM AG                                       *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#ifndef _HOST_FSL_LPSPI_H_
+#define _HOST_FSL_LPSPI_H_
+
+
+#include "fsl_common.h"
+
+
+// The types and functions aospi_lpspi.c uses, with the SDK's names.
+// host_lpspi.c implements them as a model of SPI OUT (master, LPSPI1) and
+// SPI IN (slave, LPSPI4) with a pluggable OSP chain; see the host_lpspi_xxx
+// functions at the end.
+
+
+typedef struct { volatile uint32_t CR; } LPSPI_Type;
+extern LPSPI_Type * LPSPI1;
+extern LPSPI_Type * LPSPI4;
+
+
+typedef enum { kLPSPI_ClockPolarityActiveHigh= 0, kLPSPI_ClockPolarityActiveLow= 1 } lpspi_clock_polarity_t;
+typedef enum { kLPSPI_ClockPhaseFirstEdge= 0, kLPSPI_ClockPhaseSecondEdge= 1 } lpspi_clock_phase_t;
+typedef enum { kLPSPI_MsbFirst= 0, kLPSPI_LsbFirst= 1 } lpspi_shift_direction_t;
+typedef enum { kLPSPI_Pcs0= 0, kLPSPI_Pcs1= 1, kLPSPI_Pcs2= 2, kLPSPI_Pcs3= 3 } lpspi_which_pcs_t;
+typedef enum { kLPSPI_PcsActiveHigh= 1, kLPSPI_PcsActiveLow= 0 } lpspi_pcs_polarity_config_t;
+typedef enum { kLPSPI_SdiInSdoOut= 0, kLPSPI_SdiInSdiOut= 1, kLPSPI_SdoInSdoOut= 2, kLPSPI_SdoInSdiOut= 3 } lpspi_pin_config_t;
+enum { kLPSPI_MasterPcs0= 0U<<24, kLPSPI_MasterPcsContinuous= 1U<<20 };
+enum { kLPSPI_SlavePcs0= 0U<<24 };
+
+
+typedef struct _lpspi_master_config {
+  uint32_t                    baudRate;
+  uint32_t                    bitsPerFrame;
+  lpspi_clock_polarity_t      cpol;
+  lpspi_clock_phase_t         cpha;
+  lpspi_shift_direction_t     direction;
+  lpspi_which_pcs_t           whichPcs;
+  lpspi_pcs_polarity_config_t pcsActiveHighOrLow;
+} lpspi_master_config_t;
+typedef struct _lpspi_slave_config {
+  uint32_t                    bitsPerFrame;
+  lpspi_which_pcs_t           whichPcs;
+  lpspi_pcs_polarity_config_t pcsActiveHighOrLow;
+  lpspi_pin_config_t          pinCfg;
+} lpspi_slave_config_t;
+typedef struct _lpspi_transfer {
+  const uint8_t * txData;
+  uint8_t       * rxData;
+  volatile size_t dataSize;
+  uint32_t        configFlags;
+} lpspi_transfer_t;
+
+
+typedef struct _lpspi_slave_handle lpspi_slave_handle_t;
+typedef void (*lpspi_slave_transfer_callback_t)( LPSPI_Type * base, lpspi_slave_handle_t * handle, status_t status, void * userData );
+struct _lpspi_slave_handle {
+  lpspi_slave_transfer_callback_t callback;
+  void                          * userData;
+};
+
+
+void     LPSPI_MasterGetDefaultConfig( lpspi_master_config_t * masterConfig );
+void     LPSPI_MasterInit( LPSPI_Type * base, const lpspi_master_config_t * masterConfig, uint32_t srcClock_Hz );
+void     LPSPI_SlaveGetDefaultConfig( lpspi_slave_config_t * slaveConfig );
+void     LPSPI_SlaveInit( LPSPI_Type * base, const lpspi_slave_config_t * slaveConfig );
+void     LPSPI_SlaveTransferCreateHandle( LPSPI_Type * base, lpspi_slave_handle_t * handle, lpspi_slave_transfer_callback_t callback, void * userData );
+status_t LPSPI_MasterTransferBlocking( LPSPI_Type * base, lpspi_transfer_t * transfer );
+status_t LPSPI_SlaveTransferNonBlocking( LPSPI_Type * base, lpspi_slave_handle_t * handle, lpspi_transfer_t * transfer );
+status_t LPSPI_SlaveTransferGetCount( LPSPI_Type * base, lpspi_slave_handle_t * handle, size_t * count );
+void     LPSPI_SlaveTransferAbort( LPSPI_Type * base, lpspi_slave_handle_t * handle );
+
+
+// === host model ===========================================================
+
+
+// The chain model: called when the master has clocked out telegram `data[0..size-1]` on SPI OUT.
+typedef void (*host_lpspi_chain_t)( const uint8_t * data, int size );
+// Installs the chain model (0: telegrams go nowhere, no responses)
+void host_lpspi_chain_set( host_lpspi_chain_t chain );
+// Lets the chain clock `data[0..size-1]` into SPI IN, starting `delay_us` after the telegram on SPI OUT ended
+void host_lpspi_respond( const uint8_t * data, int size, uint32_t delay_us );
+// Runs the SPI IN events that are due, calling the slave callback when a transfer completes; host.c calls this when interrupts get enabled
+void host_lpspi_irq( void );
+// Returns the baud rate of SPI OUT set by LPSPI_MasterInit()
+uint32_t host_lpspi_baudrate( void );
+
+
+#endif
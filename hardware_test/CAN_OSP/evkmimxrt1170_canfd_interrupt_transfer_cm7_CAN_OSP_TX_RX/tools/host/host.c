@@ -0,0 +1,174 @@
+// host.c - host stand-ins for the MCU SDK and FreeRTOS functions the osp_aospi sources use (tools/ builds only)
+/*****************************************************************************
+ * Copyright 2024,2025 by ams OSRAM AG                                       *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#include <stdio.h>
+#include "fsl_common.h"
+#include "fsl_gpio.h"
+#include "fsl_lpuart.h"
+#include "fsl_flexcan.h" // host_flexcan_irq()
+#include "fsl_lpspi.h"   // host_lpspi_irq()
+#include "FreeRTOS.h"
+#include "task.h"
+
+
+// === time =================================================================
+
+
+uint32_t SystemCoreClock = 996000000UL;
+
+static DWT_Type       host_dwt;
+static CoreDebug_Type host_coredebug;
+DWT_Type       * DWT       = &host_dwt;
+CoreDebug_Type * CoreDebug = &host_coredebug;
+
+static uint64_t host_now_us;
+
+
+// Returns the time in us since start
+uint64_t host_us( void ) {
+  return host_now_us;
+}
+
+
+// Advances the time by `us` microseconds; the DWT cycle counter follows (and wraps like the real one)
+void host_us_step( uint32_t us ) {
+  host_now_us += us;
+  DWT->CYCCNT += us * (SystemCoreClock/1000000);
+}
+
+
+// === interrupts ===========================================================
+
+
+static uint32_t host_primask;     // 1 while interrupts are disabled
+static int      host_irq_running; // 1 while the models run their callbacks ("ISR")
+
+
+// Runs the due FlexCAN and LPSPI events, as interrupt handlers would
+static void host_irq( void ) {
+  if( host_irq_running ) return;
+  host_irq_running = 1;
+  host_primask = 1;
+  host_flexcan_irq();
+  host_lpspi_irq();
+  host_primask = 0;
+  host_irq_running = 0;
+}
+
+
+uint32_t DisableGlobalIRQ( void ) {
+  uint32_t primask = host_primask;
+  host_primask = 1;
+  return primask;
+}
+
+
+// Enabling interrupts is where the firmware polls; each time costs 1 us and runs the due events
+void EnableGlobalIRQ( uint32_t primask ) {
+  host_primask = primask;
+  if( host_primask==0 && !host_irq_running ) {
+    host_us_step(1);
+    host_irq();
+  }
+}
+
+
+void SDK_DelayAtLeastUs( uint32_t delayTime_us, uint32_t coreClock_Hz ) {
+  (void)coreClock_Hz;
+  host_us_step(delayTime_us);
+  if( host_primask==0 ) host_irq();
+}
+
+
+// === clocks, pins, uart ===================================================
+
+
+void CLOCK_SetRootClock( clock_root_t root, const clock_root_config_t * config ) {
+  (void)root; (void)config;
+}
+
+
+// All roots run from the 24 MHz oscillator
+uint32_t CLOCK_GetRootClockFreq( clock_root_t root ) {
+  (void)root;
+  return 24000000UL;
+}
+
+
+static GPIO_Type host_gpio9;
+GPIO_Type * GPIO9 = &host_gpio9;
+
+
+void GPIO_PinInit( GPIO_Type * base, uint32_t pin, const gpio_pin_config_t * config ) {
+  if( config->direction==kGPIO_DigitalOutput ) base->GDIR |= 1UL<<pin; else base->GDIR &= ~(1UL<<pin);
+  GPIO_PinWrite(base, pin, config->outputLogic);
+}
+
+
+void GPIO_PinWrite( GPIO_Type * base, uint32_t pin, uint8_t output ) {
+  if( output ) base->DR |= 1UL<<pin; else base->DR &= ~(1UL<<pin);
+}
+
+
+uint32_t GPIO_PinRead( GPIO_Type * base, uint32_t pin ) {
+  return (base->DR >> pin) & 1;
+}
+
+
+static LPUART_Type host_lpuart1;
+LPUART_Type * LPUART1 = &host_lpuart1;
+
+
+// The console UART is stdin
+status_t LPUART_ReadBlocking( LPUART_Type * base, uint8_t * data, size_t length ) {
+  (void)base;
+  for( size_t i=0; i<length; i++ ) {
+    int ch = getchar();
+    if( ch==EOF ) return kStatus_Fail;
+    data[i] = (uint8_t)ch;
+  }
+  return kStatus_Success;
+}
+
+
+// === FreeRTOS =============================================================
+
+
+// There is one task, it polls (aospi_wait) instead of waiting for a notification
+TaskHandle_t xTaskGetCurrentTaskHandle( void ) {
+  return 0;
+}
+
+
+BaseType_t xTaskNotifyGive( TaskHandle_t task ) {
+  (void)task;
+  return pdTRUE;
+}
+
+
+void vTaskNotifyGiveFromISR( TaskHandle_t task, BaseType_t * woken ) {
+  (void)task; (void)woken;
+}
+
+
+// The tick is 1 ms
+TickType_t xTaskGetTickCount( void ) {
+  return (TickType_t)(host_now_us/1000);
+}
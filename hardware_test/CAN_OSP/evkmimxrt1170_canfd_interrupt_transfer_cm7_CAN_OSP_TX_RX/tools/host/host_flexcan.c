@@ -0,0 +1,476 @@
+// host_flexcan.c - host model of the FlexCAN driver: two controllers, their buses and a pluggable bridge (tools/ builds only)
+/*****************************************************************************
+ * Copyright 2024,2025 by ams OSRAM AG                                       *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#include <string.h>
+#include "fsl_common.h"
+#include "fsl_flexcan.h"
+
+
+// The model keeps, per controller, the state of each MB and a bus that
+// sends one frame at a time. Like FlexCAN, the bus picks the pending TX MB
+// with the lowest arbitration value (PRIO field with MCR[LPRIOEN], then the
+// ID) when it gets free, and of equal ones the lowest MB; so a frame that is
+// loaded before the previous one ends follows back-to-back. The firmware
+// loads a TX MB in the MB RAM; the model takes the frame over when the MB
+// interrupt is enabled, which the SDK's send function does last. A sent
+// frame is handed to the bridge model, and its TX interrupt runs
+// host_flexcan_isrus later. Frames from the bridge
+// land in the lowest armed RX MB. Bus time is modelled for CAN-FD at
+// 500 kbit/s (arbitration) and 2 Mbit/s (data), without stuff bits. Frames
+// from the bridge do not contend with frames to the bridge.
+
+
+// Latency from the end of a frame to the start of its interrupt handler (default)
+#define HOST_FLEXCAN_ISRUS     2
+// Maximum number of frames from the bridge not yet received
+#define HOST_FLEXCAN_RXQUEUE   64
+// Maximum number of TX interrupts not yet handled
+#define HOST_FLEXCAN_ISRQUEUE  64
+
+
+// MB codes and transfer states of the FlexCAN driver (private to fsl_flexcan.c)
+#define HOST_CODE_TXINACTIVE 0x8
+#define HOST_CODE_TXDATA     0xC
+#define HOST_STATE_IDLE      0x0
+#define HOST_STATE_TXDATA    0x3
+
+
+// MB states
+#define HOST_MB_IDLE    0
+#define HOST_MB_TXLOAD  1 // loaded, waiting for the bus
+#define HOST_MB_TXBUS   2 // frame on the bus
+#define HOST_MB_TXSENT  3 // frame sent, interrupt pending
+#define HOST_MB_RXARMED 4 // waiting for a frame
+
+
+typedef struct host_can_s {
+  CAN_Type           regs;
+  flexcan_handle_t * handle;
+  int                mbsize;   // MB payload size (flexcan_mb_size_t), for the layout of the MB RAM
+  struct { uint8_t state; flexcan_fd_frame_t * frame; uint64_t loadus; uint32_t arb; flexcan_fd_frame_t txframe; } mb[CAN_WORD1_COUNT];
+  // The bus
+  int                active;   // MB whose frame is on the bus, or -1
+  uint64_t           txend;    // end of the frame on the bus
+  uint64_t           busfree;  // end of the last frame
+  // Pending TX interrupts
+  struct { uint64_t at; int mb; } isr[HOST_FLEXCAN_ISRQUEUE];
+  int                isrcount;
+  // Frames from the bridge, in order of arrival
+  struct { uint64_t at; uint32_t id; int size; uint8_t data[64]; } rx[HOST_FLEXCAN_RXQUEUE];
+  int                rxcount;
+  host_flexcan_stats_t stats;
+} host_can_t;
+
+
+static host_can_t host_can[2];
+CAN_Type * CAN2 = &host_can[0].regs;
+CAN_Type * CAN3 = &host_can[1].regs;
+
+static host_flexcan_bridge_t host_flexcan_bridge;
+static uint32_t host_flexcan_isrus = HOST_FLEXCAN_ISRUS;
+static int      host_flexcan_inevent; // 1 while an event is processed, its time is host_flexcan_eventus
+static uint64_t host_flexcan_eventus;
+
+
+// Returns the model of controller `base`
+static host_can_t * host_can_get( CAN_Type * base ) {
+  return base==CAN2 ? &host_can[0] : &host_can[1];
+}
+
+
+// Returns the current time of the model: the time of the event being processed, or the host time
+static uint64_t host_flexcan_now( void ) {
+  return host_flexcan_inevent ? host_flexcan_eventus : host_us();
+}
+
+
+// Returns the words of MB `mb` of `can` in its MB RAM (CS, ID, payload), like the SDK's FLEXCAN_GetFDMailboxOffset
+static volatile uint32_t * host_can_mbram( host_can_t * can, int mb ) {
+  static const int words[4] = { 4, 6, 10, 18 }; // per MB, for 8, 16, 32 and 64 byte payloads
+  int perblock = 128/words[can->mbsize];      // MBs per 512 byte block
+  return &can->regs.MB[0].CS + (mb/perblock)*128 + (mb%perblock)*words[can->mbsize];
+}
+
+
+// Maps a payload size to the (smallest) DLC that holds it
+static uint8_t host_flexcan_size2dlc( int size ) {
+  static const uint8_t sizes[16] = { 0,1,2,3,4,5,6,7,8,12,16,20,24,32,48,64 };
+  uint8_t dlc = 0;
+  while( dlc<15 && sizes[dlc]<size ) dlc++;
+  return dlc;
+}
+
+
+// Maps a DLC to a payload size
+static int host_flexcan_dlc2size( uint8_t dlc ) {
+  static const uint8_t sizes[16] = { 0,1,2,3,4,5,6,7,8,12,16,20,24,32,48,64 };
+  return sizes[dlc & 15];
+}
+
+
+// Returns the time on the bus of a frame with `size` payload bytes
+static uint32_t host_flexcan_frameus( int size ) {
+  return 60 + (8*size + 30)/2; // 30 bits at 2us, then DLC, data and CRC at 0.5us
+}
+
+
+// === SDK functions ========================================================
+
+
+void FLEXCAN_GetDefaultConfig( flexcan_config_t * config ) {
+  memset(config, 0, sizeof(*config));
+  config->bitRate   = 1000000U;
+  config->bitRateFD = 2000000U;
+  config->maxMbNum  = 16;
+}
+
+
+bool FLEXCAN_FDCalculateImprovedTimingValues( CAN_Type * base, uint32_t bitRate, uint32_t bitRateFD, uint32_t sourceClock_Hz, flexcan_timing_config_t * config ) {
+  (void)base; (void)bitRate; (void)bitRateFD; (void)sourceClock_Hz;
+  memset(config, 0, sizeof(*config));
+  return true;
+}
+
+
+// (Re)initializes the model of `base`: all MBs idle, bus idle
+void FLEXCAN_FDInit( CAN_Type * base, const flexcan_config_t * config, uint32_t sourceClock_Hz, flexcan_mb_size_t dataSize, bool brs ) {
+  (void)config; (void)sourceClock_Hz; (void)brs;
+  host_can_t * can = host_can_get(base);
+  memset(can, 0, sizeof(*can));
+  can->active = -1;
+  can->mbsize = dataSize;
+}
+
+
+void FLEXCAN_EnterFreezeMode( CAN_Type * base ) {
+  (void)base;
+}
+
+
+void FLEXCAN_ExitFreezeMode( CAN_Type * base ) {
+  (void)base;
+}
+
+
+void FLEXCAN_TransferCreateHandle( CAN_Type * base, flexcan_handle_t * handle, flexcan_transfer_callback_t callback, void * userData ) {
+  handle->callback = callback;
+  handle->userData = userData;
+  host_can_get(base)->handle = handle;
+}
+
+
+void FLEXCAN_SetRxMbGlobalMask( CAN_Type * base, uint32_t mask ) {
+  (void)base; (void)mask;
+}
+
+
+void FLEXCAN_SetFDRxMbConfig( CAN_Type * base, uint8_t mbIdx, const flexcan_rx_mb_config_t * config, bool enable ) {
+  (void)config; (void)enable;
+  host_can_get(base)->mb[mbIdx].state = HOST_MB_IDLE;
+}
+
+
+void FLEXCAN_SetFDTxMbConfig( CAN_Type * base, uint8_t mbIdx, bool enable ) {
+  (void)enable;
+  host_can_get(base)->mb[mbIdx].state = HOST_MB_IDLE;
+}
+
+
+// Writes the frame in the MB RAM and activates it, like the SDK (PRIO is 0: the frame's id has 29 bits)
+status_t FLEXCAN_TransferFDSendNonBlocking( CAN_Type * base, flexcan_handle_t * handle, flexcan_mb_transfer_t * pMbXfer ) {
+  host_can_t * can = host_can_get(base);
+  const flexcan_fd_frame_t * frame = pMbXfer->framefd;
+  if( handle->mbState[pMbXfer->mbIdx]!=HOST_STATE_IDLE ) return kStatus_FLEXCAN_TxBusy;
+  handle->mbState[pMbXfer->mbIdx] = HOST_STATE_TXDATA;
+  volatile uint32_t * ram = host_can_mbram(can, pMbXfer->mbIdx);
+  ram[0] = CAN_CS_CODE(HOST_CODE_TXINACTIVE);
+  ram[1] = frame->id;
+  for( int i=0; i<2<<can->mbsize; i++ ) ram[2+i] = frame->dataWord[i]; // 2, 4, 8 or 16 payload words
+  ram[0] = CAN_CS_CODE(HOST_CODE_TXDATA) | CAN_CS_DLC(frame->length) | CAN_CS_EDL(frame->edl) | CAN_CS_BRS(frame->brs);
+  FLEXCAN_EnableMbInterrupts(base, (uint64_t)1 << pMbXfer->mbIdx);
+  return kStatus_Success;
+}
+
+
+// Takes over the frames of the TX MBs in `mask` that are activated in the MB RAM
+void FLEXCAN_EnableMbInterrupts( CAN_Type * base, uint64_t mask ) {
+  host_can_t * can = host_can_get(base);
+  base->IMASK1 |= (uint32_t)mask;
+  base->IMASK2 |= (uint32_t)(mask>>32);
+  for( int mb=0; mb<CAN_WORD1_COUNT; mb++ ) {
+    if( !(mask>>mb & 1) || can->mb[mb].state!=HOST_MB_IDLE ) continue;
+    volatile uint32_t * ram = host_can_mbram(can, mb);
+    if( (ram[0] & CAN_CS_CODE_MASK)!=CAN_CS_CODE(HOST_CODE_TXDATA) ) continue;
+    flexcan_fd_frame_t * frame = &can->mb[mb].txframe;
+    memset(frame, 0, sizeof(*frame));
+    frame->id     = ram[1] & 0x1FFFFFFFUL;
+    frame->length = (ram[0] & CAN_CS_DLC_MASK) >> CAN_CS_DLC_SHIFT;
+    frame->edl    = (ram[0] & CAN_CS_EDL_MASK) != 0;
+    frame->brs    = (ram[0] & CAN_CS_BRS_MASK) != 0;
+    for( int i=0; i<(host_flexcan_dlc2size(frame->length)+3)/4; i++ ) frame->dataWord[i] = ram[2+i];
+    can->mb[mb].state  = HOST_MB_TXLOAD;
+    can->mb[mb].frame  = frame;
+    can->mb[mb].loadus = host_flexcan_now();
+    can->mb[mb].arb    = base->MCR & CAN_MCR_LPRIOEN_MASK ? ram[1] : ram[1] & ~CAN_ID_PRIO_MASK;
+    uint32_t pending = 0;
+    for( int i=0; i<CAN_WORD1_COUNT; i++ )
+      if( can->mb[i].state>=HOST_MB_TXLOAD && can->mb[i].state<=HOST_MB_TXSENT ) pending++;
+    if( pending>can->stats.maxpending ) can->stats.maxpending = pending;
+  }
+}
+
+
+status_t FLEXCAN_TransferFDReceiveNonBlocking( CAN_Type * base, flexcan_handle_t * handle, flexcan_mb_transfer_t * pMbXfer ) {
+  (void)handle;
+  host_can_t * can = host_can_get(base);
+  if( can->mb[pMbXfer->mbIdx].state!=HOST_MB_IDLE ) return kStatus_FLEXCAN_RxBusy;
+  can->mb[pMbXfer->mbIdx].state = HOST_MB_RXARMED;
+  can->mb[pMbXfer->mbIdx].frame = pMbXfer->framefd;
+  return kStatus_Success;
+}
+
+
+// An aborted frame that is on the bus still completes, but raises no interrupt
+void FLEXCAN_TransferFDAbortSend( CAN_Type * base, flexcan_handle_t * handle, uint8_t mbIdx ) {
+  host_can_t * can = host_can_get(base);
+  if( mbIdx<32 ) base->IMASK1 &= ~(1UL<<mbIdx); else base->IMASK2 &= ~(1UL<<(mbIdx-32));
+  host_can_mbram(can, mbIdx)[0] = CAN_CS_CODE(HOST_CODE_TXINACTIVE);
+  handle->mbState[mbIdx] = HOST_STATE_IDLE;
+  can->mb[mbIdx].state = HOST_MB_IDLE;
+}
+
+
+// === bus events ===========================================================
+
+
+// Event kinds, in order of precedence at equal times
+#define HOST_EV_NONE    0
+#define HOST_EV_TXEND   1 // the frame on the bus ends
+#define HOST_EV_TXSTART 2 // a loaded frame gets the bus
+#define HOST_EV_TXISR   3 // the TX interrupt of a sent frame
+#define HOST_EV_RX      4 // a frame from the bridge arrives
+
+
+// Returns the TX MB of `can` loaded at or before `t` that wins arbitration (lowest PRIO and ID, then lowest MB), or -1
+static int host_can_arbitrate( host_can_t * can, uint64_t t ) {
+  int win = -1;
+  for( int mb=0; mb<CAN_WORD1_COUNT; mb++ )
+    if( can->mb[mb].state==HOST_MB_TXLOAD && can->mb[mb].loadus<=t && (win<0 || can->mb[mb].arb<can->mb[win].arb) ) win = mb;
+  return win;
+}
+
+
+// Finds the first event of `can`; returns its kind and sets *at
+static int host_can_next( host_can_t * can, uint64_t * at ) {
+  int kind = HOST_EV_NONE;
+  if( can->active>=0 ) {
+    *at = can->txend; kind = HOST_EV_TXEND;
+  } else {
+    // The bus gets free at busfree; the first frame loaded after that starts when it is loaded
+    uint64_t start = UINT64_MAX;
+    for( int mb=0; mb<CAN_WORD1_COUNT; mb++ )
+      if( can->mb[mb].state==HOST_MB_TXLOAD ) {
+        uint64_t t = can->mb[mb].loadus > can->busfree ? can->mb[mb].loadus : can->busfree;
+        if( t<start ) start = t;
+      }
+    if( start!=UINT64_MAX ) { *at = start; kind = HOST_EV_TXSTART; }
+  }
+  if( can->isrcount>0 && (kind==HOST_EV_NONE || can->isr[0].at<*at) ) { *at = can->isr[0].at; kind = HOST_EV_TXISR; }
+  if( can->rxcount>0 && (kind==HOST_EV_NONE || can->rx[0].at<*at) ) { *at = can->rx[0].at; kind = HOST_EV_RX; }
+  return kind;
+}
+
+
+// Copies `size` payload bytes from `data` into the words of `frame` (big endian, like the MB RAM)
+static void host_frame_pack( flexcan_fd_frame_t * frame, const uint8_t * data, int size ) {
+  memset(frame->dataWord, 0, sizeof(frame->dataWord));
+  for( int i=0; i<size; i++ ) frame->dataWord[i/4] |= (uint32_t)data[i] << (24 - 8*(i%4));
+}
+
+
+// Copies the payload of `frame` to `data`; returns its size
+static int host_frame_unpack( const flexcan_fd_frame_t * frame, uint8_t * data ) {
+  int size = host_flexcan_dlc2size(frame->length);
+  for( int i=0; i<size; i++ ) data[i] = (uint8_t)(frame->dataWord[i/4] >> (24 - 8*(i%4)));
+  return size;
+}
+
+
+// Processes event `kind` of `can` at time `at`
+static void host_can_event( host_can_t * can, int kind, uint64_t at ) {
+  CAN_Type * base = &can->regs;
+  if( kind==HOST_EV_TXSTART ) {
+    int mb = host_can_arbitrate(can, at);
+    int size = host_flexcan_dlc2size(can->mb[mb].frame->length);
+    can->mb[mb].state = HOST_MB_TXBUS;
+    can->active = mb;
+    can->txend = at + host_flexcan_frameus(size);
+    if( can->stats.frames==0 ) can->stats.firstus = at;
+    else if( at>can->busfree ) can->stats.gaps++;
+    can->stats.busus += can->txend - at;
+  } else if( kind==HOST_EV_TXEND ) {
+    int mb = can->active;
+    can->active = -1;
+    can->busfree = at;
+    can->stats.frames++;
+    can->stats.lastus = at;
+    if( can->mb[mb].state!=HOST_MB_TXBUS ) return; // aborted
+    can->mb[mb].state = HOST_MB_TXSENT;
+    if( can->isrcount<HOST_FLEXCAN_ISRQUEUE ) {
+      can->isr[can->isrcount].at = at + host_flexcan_isrus;
+      can->isr[can->isrcount].mb = mb;
+      can->isrcount++;
+    }
+    if( host_flexcan_bridge && !(base->CTRL1 & CAN_CTRL1_LPB_MASK) ) {
+      uint8_t data[64];
+      int size = host_frame_unpack(can->mb[mb].frame, data);
+      host_flexcan_bridge(base, can->mb[mb].frame->id, data, size);
+    }
+  } else if( kind==HOST_EV_TXISR ) {
+    int mb = can->isr[0].mb;
+    can->isrcount--;
+    memmove(&can->isr[0], &can->isr[1], can->isrcount*sizeof(can->isr[0]));
+    if( can->mb[mb].state!=HOST_MB_TXSENT ) return; // aborted
+    FLEXCAN_TransferFDAbortSend(base, can->handle, (uint8_t)mb); // the SDK's handler cleans the MB
+    can->handle->callback(base, can->handle, kStatus_FLEXCAN_TxIdle, (uint64_t)mb, can->handle->userData);
+  } else if( kind==HOST_EV_RX ) {
+    int rxmb = -1;
+    for( int mb=0; mb<CAN_WORD1_COUNT && rxmb<0; mb++ )
+      if( can->mb[mb].state==HOST_MB_RXARMED ) rxmb = mb;
+    if( rxmb<0 ) {
+      can->stats.rxlost++;
+    } else {
+      flexcan_fd_frame_t * frame = can->mb[rxmb].frame;
+      frame->id     = can->rx[0].id;
+      frame->length = host_flexcan_size2dlc(can->rx[0].size);
+      frame->format = kFLEXCAN_FrameFormatStandard;
+      frame->type   = kFLEXCAN_FrameTypeData;
+      frame->edl    = 1;
+      frame->brs    = 1;
+      host_frame_pack(frame, can->rx[0].data, can->rx[0].size);
+      can->stats.rxframes++;
+    }
+    can->rxcount--;
+    memmove(&can->rx[0], &can->rx[1], can->rxcount*sizeof(can->rx[0]));
+    if( rxmb>=0 ) {
+      can->mb[rxmb].state = HOST_MB_IDLE; // the driver re-arms it
+      can->handle->callback(base, can->handle, kStatus_FLEXCAN_RxIdle, (uint64_t)rxmb, can->handle->userData);
+    }
+  }
+}
+
+
+// === host model ===========================================================
+
+
+/*!
+    @brief  Installs the bridge model.
+    @param  bridge
+            Called for every frame a controller sends (not in loop back
+            mode); it may answer with host_flexcan_respond(). 0 drops all
+            frames.
+*/
+void host_flexcan_bridge_set( host_flexcan_bridge_t bridge ) {
+  host_flexcan_bridge = bridge;
+}
+
+
+/*!
+    @brief  Lets the bridge on the bus of `base` send a frame.
+    @param  base
+            The controller that receives the frame.
+    @param  id
+            The CAN ID of the frame (as FLEXCAN_ID_STD).
+    @param  data
+            The payload.
+    @param  size
+            The number of bytes in `data` (up to 64, padded to a DLC size).
+    @param  delay_us
+            Time between the end of the frame being sent (or now, outside
+            the bridge model) and the start of this frame.
+    @note   Frames arrive in the order of their arrival time; with equal
+            times, in the order they were sent.
+*/
+void host_flexcan_respond( CAN_Type * base, uint32_t id, const uint8_t * data, int size, uint32_t delay_us ) {
+  host_can_t * can = host_can_get(base);
+  if( can->rxcount==HOST_FLEXCAN_RXQUEUE || size>64 ) { can->stats.rxlost++; return; }
+  uint64_t at = host_flexcan_now() + delay_us + host_flexcan_frameus(host_flexcan_dlc2size(host_flexcan_size2dlc(size)));
+  int ix = can->rxcount;
+  while( ix>0 && can->rx[ix-1].at>at ) ix--;
+  memmove(&can->rx[ix+1], &can->rx[ix], (can->rxcount-ix)*sizeof(can->rx[0]));
+  can->rx[ix].at   = at;
+  can->rx[ix].id   = id;
+  can->rx[ix].size = size;
+  memcpy(can->rx[ix].data, data, size);
+  can->rxcount++;
+}
+
+
+/*!
+    @brief  Runs all bus events that are due (up to host_us()), in time
+            order, over both controllers.
+    @note   Calls the FlexCAN callbacks, like the interrupt handlers on the
+            target. host.c calls this when the firmware enables interrupts.
+*/
+void host_flexcan_irq( void ) {
+  uint64_t now = host_us();
+  while( 1 ) {
+    host_can_t * first = 0;
+    int          kind  = HOST_EV_NONE;
+    uint64_t     at    = 0;
+    for( int ix=0; ix<2; ix++ ) {
+      if( host_can[ix].handle==0 ) continue;
+      uint64_t t;
+      int k = host_can_next(&host_can[ix], &t);
+      if( k!=HOST_EV_NONE && (kind==HOST_EV_NONE || t<at) ) { first = &host_can[ix]; kind = k; at = t; }
+    }
+    if( kind==HOST_EV_NONE || at>now ) break;
+    host_flexcan_inevent = 1;
+    host_flexcan_eventus = at;
+    host_can_event(first, kind, at);
+    host_flexcan_inevent = 0;
+  }
+}
+
+
+/*!
+    @brief  Sets the latency from the end of a frame to the start of its
+            TX interrupt handler.
+    @param  us
+            The latency; HOST_FLEXCAN_ISRUS by default. A long latency
+            models a CPU that is busy (other interrupts, critical sections).
+*/
+void host_flexcan_isrus_set( uint32_t us ) {
+  host_flexcan_isrus = us;
+}
+
+
+/*!
+    @brief  Returns the statistics of controller `base`, and clears them.
+    @param  base
+            CAN2 or CAN3.
+    @param  stats
+            Output parameter.
+*/
+void host_flexcan_stats( CAN_Type * base, host_flexcan_stats_t * stats ) {
+  host_can_t * can = host_can_get(base);
+  *stats = can->stats;
+  memset(&can->stats, 0, sizeof(can->stats));
+}
@@ -0,0 +1,197 @@
+// host_lpspi.c - host model of the LPSPI driver: SPI OUT (master), SPI IN (slave) and a pluggable OSP chain (tools/ builds only)
+/*****************************************************************************
+ * Copyright 2024,2025 by ams OSRAM AG                                       *
+ * All rights are reserved.                                                  *
+ *                                                                           *
+ * IMPORTANT - PLEASE READ CAREFULLY BEFORE COPYING, INSTALLING OR USING     *
+ * THE SOFTWARE.                                                             *
+ *                                                                           *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS       *
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT         *
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS         *
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT  *
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,     *
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT          *
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,     *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY     *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE     *
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.      *
+ *****************************************************************************/
+#include <string.h>
+#include "fsl_common.h"
+#include "fsl_lpspi.h"
+
+
+// SPI OUT clocks a telegram out in LPSPI_MasterTransferBlocking(), which
+// takes the bus time of its bytes, and hands it to the chain model. The
+// chain may answer with host_lpspi_respond(): its bytes are clocked into
+// the armed SPI IN transfer one by one (at the SPI OUT baud rate), when the
+// firmware enables interrupts. The slave callback runs when the transfer
+// has all its bytes; a shorter response leaves it pending (time-out).
+
+
+// Maximum size of a response
+#define HOST_LPSPI_RESPMAX 64
+
+
+static LPSPI_Type host_lpspi1;
+static LPSPI_Type host_lpspi4;
+LPSPI_Type * LPSPI1 = &host_lpspi1;
+LPSPI_Type * LPSPI4 = &host_lpspi4;
+
+static host_lpspi_chain_t host_lpspi_chain;
+static uint32_t           host_lpspi_baud = 2400000;
+
+// The SPI IN transfer
+static lpspi_slave_handle_t * host_lpspi_in_handle;
+static uint8_t *              host_lpspi_in_data;  // 0 when not armed
+static size_t                 host_lpspi_in_size;
+static size_t                 host_lpspi_in_count; // bytes received
+
+// The response of the chain
+static uint8_t  host_lpspi_resp[HOST_LPSPI_RESPMAX];
+static int      host_lpspi_resp_size;
+static int      host_lpspi_resp_pos;   // next byte to clock in
+static uint64_t host_lpspi_resp_start; // time the first byte starts
+
+
+// Returns the time to clock `bytes` bytes at the baud rate, in us (rounded up)
+static uint32_t host_lpspi_us( int bytes ) {
+  return (uint32_t)((8ULL*bytes*1000000 + host_lpspi_baud - 1) / host_lpspi_baud);
+}
+
+
+// === SDK functions ========================================================
+
+
+void LPSPI_MasterGetDefaultConfig( lpspi_master_config_t * masterConfig ) {
+  memset(masterConfig, 0, sizeof(*masterConfig));
+  masterConfig->baudRate     = 500000;
+  masterConfig->bitsPerFrame = 8;
+}
+
+
+void LPSPI_MasterInit( LPSPI_Type * base, const lpspi_master_config_t * masterConfig, uint32_t srcClock_Hz ) {
+  (void)base; (void)srcClock_Hz;
+  host_lpspi_baud = masterConfig->baudRate;
+}
+
+
+void LPSPI_SlaveGetDefaultConfig( lpspi_slave_config_t * slaveConfig ) {
+  memset(slaveConfig, 0, sizeof(*slaveConfig));
+  slaveConfig->bitsPerFrame = 8;
+}
+
+
+void LPSPI_SlaveInit( LPSPI_Type * base, const lpspi_slave_config_t * slaveConfig ) {
+  (void)base; (void)slaveConfig;
+}
+
+
+void LPSPI_SlaveTransferCreateHandle( LPSPI_Type * base, lpspi_slave_handle_t * handle, lpspi_slave_transfer_callback_t callback, void * userData ) {
+  (void)base;
+  handle->callback = callback;
+  handle->userData = userData;
+  host_lpspi_in_handle = handle;
+}
+
+
+// Takes the bus time of the bytes (interrupts run meanwhile), then hands them to the chain model
+status_t LPSPI_MasterTransferBlocking( LPSPI_Type * base, lpspi_transfer_t * transfer ) {
+  (void)base;
+  if( transfer->txData==0 || transfer->dataSize==0 ) return kStatus_InvalidArgument;
+  SDK_DelayAtLeastUs(host_lpspi_us((int)transfer->dataSize), SystemCoreClock);
+  if( host_lpspi_chain ) host_lpspi_chain(transfer->txData, (int)transfer->dataSize);
+  return kStatus_Success;
+}
+
+
+// Arms SPI IN; a response that is already being clocked in is lost
+status_t LPSPI_SlaveTransferNonBlocking( LPSPI_Type * base, lpspi_slave_handle_t * handle, lpspi_transfer_t * transfer ) {
+  (void)base; (void)handle;
+  if( host_lpspi_in_data ) return kStatus_Fail; // busy
+  if( transfer->rxData==0 || transfer->dataSize==0 ) return kStatus_InvalidArgument;
+  host_lpspi_in_data  = transfer->rxData;
+  host_lpspi_in_size  = transfer->dataSize;
+  host_lpspi_in_count = 0;
+  host_lpspi_resp_size = 0;
+  return kStatus_Success;
+}
+
+
+status_t LPSPI_SlaveTransferGetCount( LPSPI_Type * base, lpspi_slave_handle_t * handle, size_t * count ) {
+  (void)base; (void)handle;
+  if( host_lpspi_in_data==0 ) return kStatus_Fail; // no transfer in progress
+  *count = host_lpspi_in_count;
+  return kStatus_Success;
+}
+
+
+void LPSPI_SlaveTransferAbort( LPSPI_Type * base, lpspi_slave_handle_t * handle ) {
+  (void)base; (void)handle;
+  host_lpspi_in_data   = 0;
+  host_lpspi_resp_size = 0;
+}
+
+
+// === host model ===========================================================
+
+
+/*!
+    @brief  Installs the chain model.
+    @param  chain
+            Called for every telegram SPI OUT sends; it may answer with
+            host_lpspi_respond(). 0 drops all telegrams.
+*/
+void host_lpspi_chain_set( host_lpspi_chain_t chain ) {
+  host_lpspi_chain = chain;
+}
+
+
+/*!
+    @brief  Lets the chain clock a response into SPI IN.
+    @param  data
+            The response bytes.
+    @param  size
+            The number of bytes in `data` (up to 64).
+    @param  delay_us
+            Time between now (the end of the telegram, in the chain model)
+            and the first byte.
+    @note   A response replaces one that is still being clocked in.
+*/
+void host_lpspi_respond( const uint8_t * data, int size, uint32_t delay_us ) {
+  if( size>HOST_LPSPI_RESPMAX ) size = HOST_LPSPI_RESPMAX;
+  memcpy(host_lpspi_resp, data, size);
+  host_lpspi_resp_size  = size;
+  host_lpspi_resp_pos   = 0;
+  host_lpspi_resp_start = host_us() + delay_us;
+}
+
+
+/*!
+    @brief  Clocks the due bytes of the response into the armed SPI IN
+            transfer, and calls its callback when it is complete.
+    @note   host.c calls this when the firmware enables interrupts.
+*/
+void host_lpspi_irq( void ) {
+  uint64_t now = host_us();
+  while( host_lpspi_resp_pos<host_lpspi_resp_size && host_lpspi_resp_start + host_lpspi_us(host_lpspi_resp_pos+1) <= now ) {
+    uint8_t byte = host_lpspi_resp[host_lpspi_resp_pos++];
+    if( host_lpspi_in_data==0 ) continue; // not armed: lost
+    host_lpspi_in_data[host_lpspi_in_count++] = byte;
+    if( host_lpspi_in_count==host_lpspi_in_size ) {
+      host_lpspi_in_data = 0;
+      host_lpspi_in_handle->callback(LPSPI4, host_lpspi_in_handle, kStatus_Success, host_lpspi_in_handle->userData);
+    }
+  }
+}
+
+
+/*!
+    @brief  Returns the baud rate of SPI OUT.
+    @return The baud rate set by LPSPI_MasterInit().
+*/
+uint32_t host_lpspi_baudrate( void ) {
+  return host_lpspi_baud;
+}